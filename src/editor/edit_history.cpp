@@ -0,0 +1,384 @@
+/**
+ * Pixel Editor Undo History Implementation
+ *
+ * See edit_history.h for usage documentation.
+ */
+
+#include "edit_history.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace EditHistory {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+constexpr int TILE_PIXELS = TILE_SIZE * TILE_SIZE;
+
+// Delta encoding: a header byte holds the op in its top two bits and the
+// word count minus one in the rest (a tile is 64 words, so one op can
+// cover a whole tile)
+enum Op : uint8_t {
+    OP_ZERO = 0,      // count unchanged pixels
+    OP_REPEAT = 1,    // count copies of the one word that follows
+    OP_LITERAL = 2    // count words follow
+};
+
+constexpr int OP_SHIFT = 6;
+constexpr int COUNT_MASK = (1 << OP_SHIFT) - 1;
+
+struct Step {
+    std::vector<uint8_t> data;   // Per tile: 4-byte tile index, then ops
+    PixelRect bounds;
+    size_t cost;
+};
+
+constexpr size_t STEP_OVERHEAD_BYTES = sizeof(Step);
+
+uint32_t* sPixels = nullptr;
+int sWidth = 0;
+int sHeight = 0;
+int sTilesX = 0;
+int sTilesY = 0;
+size_t sBudgetBytes = DEFAULT_BUDGET_BYTES;
+
+// Steps before sUndoCount can be undone, the rest redone
+std::deque<Step> sSteps;
+int sUndoCount = 0;
+size_t sUsedBytes = 0;
+
+// The open stroke: which tiles it has copied, and their pixels before it
+bool sIsStrokeOpen = false;
+std::vector<uint8_t> sIsTileCaptured;
+std::vector<int> sCapturedTiles;
+std::vector<uint32_t> sBefore;
+
+PixelRect getTileRect(int tileIndex)
+{
+    int left = (tileIndex % sTilesX) * TILE_SIZE;
+    int top = (tileIndex / sTilesX) * TILE_SIZE;
+    return {left, top, std::min(left + TILE_SIZE, sWidth) - 1, std::min(top + TILE_SIZE, sHeight) - 1};
+}
+
+// A tile's pixels, zero past the canvas edge
+void copyTile(int tileIndex, uint32_t* out)
+{
+    PixelRect rect = getTileRect(tileIndex);
+    memset(out, 0, TILE_PIXELS * sizeof(uint32_t));
+    for (int y = rect.top; y <= rect.bottom; y++) {
+        memcpy(out + (y - rect.top) * TILE_SIZE, sPixels + y * sWidth + rect.left,
+               (rect.right - rect.left + 1) * sizeof(uint32_t));
+    }
+}
+
+void xorTile(int tileIndex, const uint32_t* delta)
+{
+    PixelRect rect = getTileRect(tileIndex);
+    for (int y = rect.top; y <= rect.bottom; y++) {
+        uint32_t* row = sPixels + y * sWidth;
+        const uint32_t* deltaRow = delta + (y - rect.top) * TILE_SIZE;
+        for (int x = rect.left; x <= rect.right; x++) {
+            row[x] ^= deltaRow[x - rect.left];
+        }
+    }
+}
+
+void appendWord(std::vector<uint8_t>& data, uint32_t word)
+{
+    uint8_t bytes[sizeof(word)];
+    memcpy(bytes, &word, sizeof(word));
+    data.insert(data.end(), bytes, bytes + sizeof(word));
+}
+
+uint32_t readWord(const uint8_t* bytes)
+{
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+void appendOp(std::vector<uint8_t>& data, Op op, int count)
+{
+    data.push_back(static_cast<uint8_t>((op << OP_SHIFT) | (count - 1)));
+}
+
+// Length of the run of words equal to delta[start]
+int getRunLength(const uint32_t* delta, int start)
+{
+    int end = start + 1;
+    while (end < TILE_PIXELS && delta[end] == delta[start]) end++;
+    return end - start;
+}
+
+void encodeTile(std::vector<uint8_t>& data, int tileIndex, const uint32_t* delta)
+{
+    appendWord(data, static_cast<uint32_t>(tileIndex));
+
+    int index = 0;
+    while (index < TILE_PIXELS) {
+        int runLength = getRunLength(delta, index);
+        if (delta[index] == 0) {
+            appendOp(data, OP_ZERO, runLength);
+            index += runLength;
+        } else if (runLength >= 2) {
+            appendOp(data, OP_REPEAT, runLength);
+            appendWord(data, delta[index]);
+            index += runLength;
+        } else {
+            // Up to the next unchanged pixel or run worth its own op
+            int end = index + 1;
+            while (end < TILE_PIXELS && delta[end] != 0 && getRunLength(delta, end) < 2) end++;
+            appendOp(data, OP_LITERAL, end - index);
+            for (; index < end; index++) {
+                appendWord(data, delta[index]);
+            }
+        }
+    }
+}
+
+// Decode one tile's delta; returns where the next tile starts
+const uint8_t* decodeTile(const uint8_t* bytes, int* outTileIndex, uint32_t* outDelta)
+{
+    *outTileIndex = static_cast<int>(readWord(bytes));
+    bytes += sizeof(uint32_t);
+
+    int index = 0;
+    while (index < TILE_PIXELS) {
+        uint8_t header = *bytes++;
+        int count = (header & COUNT_MASK) + 1;
+        switch (header >> OP_SHIFT) {
+            case OP_ZERO:
+                std::fill_n(outDelta + index, count, 0u);
+                break;
+            case OP_REPEAT:
+                std::fill_n(outDelta + index, count, readWord(bytes));
+                bytes += sizeof(uint32_t);
+                break;
+            default:
+                for (int word = 0; word < count; word++) {
+                    outDelta[index + word] = readWord(bytes);
+                    bytes += sizeof(uint32_t);
+                }
+                break;
+        }
+        index += count;
+    }
+    return bytes;
+}
+
+void applyStep(const Step& step)
+{
+    uint32_t delta[TILE_PIXELS];
+    const uint8_t* bytes = step.data.data();
+    const uint8_t* end = bytes + step.data.size();
+    while (bytes < end) {
+        int tileIndex;
+        bytes = decodeTile(bytes, &tileIndex, delta);
+        xorTile(tileIndex, delta);
+    }
+}
+
+void captureTile(int tileIndex)
+{
+    if (sIsTileCaptured[tileIndex]) return;
+
+    sIsTileCaptured[tileIndex] = 1;
+    sCapturedTiles.push_back(tileIndex);
+    sBefore.resize(sBefore.size() + TILE_PIXELS);
+    copyTile(tileIndex, sBefore.data() + sBefore.size() - TILE_PIXELS);
+}
+
+void dropRedoSteps()
+{
+    while (static_cast<int>(sSteps.size()) > sUndoCount) {
+        sUsedBytes -= sSteps.back().cost;
+        sSteps.pop_back();
+    }
+}
+
+void releaseStroke()
+{
+    for (int tileIndex : sCapturedTiles) {
+        sIsTileCaptured[tileIndex] = 0;
+    }
+    sCapturedTiles.clear();
+
+    // A big fill's copies can be far larger than what is kept of it
+    if (sBefore.capacity() * sizeof(uint32_t) > sBudgetBytes) {
+        std::vector<uint32_t>().swap(sBefore);
+    } else {
+        sBefore.clear();
+    }
+}
+
+}
+
+// =============================================================================
+// Lifecycle
+// =============================================================================
+
+void Init(uint32_t* pixels, int width, int height, size_t budgetBytes)
+{
+    Clear();
+    sPixels = pixels;
+    sWidth = width;
+    sHeight = height;
+    sTilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    sTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    sBudgetBytes = budgetBytes;
+    sIsTileCaptured.assign(sTilesX * sTilesY, 0);
+}
+
+void Clear()
+{
+    sPixels = nullptr;
+    sWidth = sHeight = 0;
+    sTilesX = sTilesY = 0;
+    sSteps.clear();
+    sUndoCount = 0;
+    sUsedBytes = 0;
+    sIsStrokeOpen = false;
+    std::vector<uint8_t>().swap(sIsTileCaptured);
+    std::vector<int>().swap(sCapturedTiles);
+    std::vector<uint32_t>().swap(sBefore);
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void BeginStroke()
+{
+    if (sPixels) {
+        sIsStrokeOpen = true;
+    }
+}
+
+void EndStroke()
+{
+    if (!sIsStrokeOpen) return;
+    sIsStrokeOpen = false;
+
+    Step step;
+    step.bounds = {sWidth, sHeight, -1, -1};
+
+    uint32_t after[TILE_PIXELS];
+    uint32_t delta[TILE_PIXELS];
+    for (size_t captured = 0; captured < sCapturedTiles.size(); captured++) {
+        int tileIndex = sCapturedTiles[captured];
+        const uint32_t* before = sBefore.data() + captured * TILE_PIXELS;
+        copyTile(tileIndex, after);
+
+        bool isChanged = false;
+        for (int index = 0; index < TILE_PIXELS; index++) {
+            delta[index] = before[index] ^ after[index];
+            isChanged = isChanged || delta[index] != 0;
+        }
+        if (!isChanged) continue;
+
+        encodeTile(step.data, tileIndex, delta);
+        PixelRect rect = getTileRect(tileIndex);
+        step.bounds.left = std::min(step.bounds.left, rect.left);
+        step.bounds.top = std::min(step.bounds.top, rect.top);
+        step.bounds.right = std::max(step.bounds.right, rect.right);
+        step.bounds.bottom = std::max(step.bounds.bottom, rect.bottom);
+    }
+    releaseStroke();
+
+    if (step.data.empty()) return;
+
+    step.data.shrink_to_fit();
+    step.cost = step.data.size() + STEP_OVERHEAD_BYTES;
+
+    dropRedoSteps();
+    sUsedBytes += step.cost;
+    sSteps.push_back(std::move(step));
+    sUndoCount++;
+
+    while (sUsedBytes > sBudgetBytes && !sSteps.empty()) {
+        sUsedBytes -= sSteps.front().cost;
+        sSteps.pop_front();
+        sUndoCount--;
+    }
+}
+
+bool IsStrokeOpen()
+{
+    return sIsStrokeOpen;
+}
+
+void Record(int x, int y)
+{
+    if (!sIsStrokeOpen || x < 0 || x >= sWidth || y < 0 || y >= sHeight) return;
+
+    captureTile((y / TILE_SIZE) * sTilesX + x / TILE_SIZE);
+}
+
+void RecordSpan(int left, int right, int y)
+{
+    if (!sIsStrokeOpen || y < 0 || y >= sHeight) return;
+
+    left = std::max(left, 0);
+    right = std::min(right, sWidth - 1);
+    int rowStart = (y / TILE_SIZE) * sTilesX;
+    for (int tileX = left / TILE_SIZE; tileX <= right / TILE_SIZE && left <= right; tileX++) {
+        captureTile(rowStart + tileX);
+    }
+}
+
+// =============================================================================
+// Undo / Redo
+// =============================================================================
+
+bool Undo(PixelRect* outChanged)
+{
+    if (!CanUndo()) return false;
+
+    const Step& step = sSteps[--sUndoCount];
+    applyStep(step);
+    *outChanged = step.bounds;
+    return true;
+}
+
+bool Redo(PixelRect* outChanged)
+{
+    if (!CanRedo()) return false;
+
+    const Step& step = sSteps[sUndoCount++];
+    applyStep(step);
+    *outChanged = step.bounds;
+    return true;
+}
+
+bool CanUndo()
+{
+    return !sIsStrokeOpen && sUndoCount > 0;
+}
+
+bool CanRedo()
+{
+    return !sIsStrokeOpen && sUndoCount < static_cast<int>(sSteps.size());
+}
+
+int GetUndoCount()
+{
+    return sUndoCount;
+}
+
+int GetRedoCount()
+{
+    return static_cast<int>(sSteps.size()) - sUndoCount;
+}
+
+size_t GetUsedBytes()
+{
+    return sUsedBytes;
+}
+
+}
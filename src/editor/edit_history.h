@@ -0,0 +1,88 @@
+/**
+ * Pixel Editor Undo History
+ *
+ * Undo and redo for the pixel editor's canvas, kept small enough that a
+ * long session doesn't eat into plugin memory.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The canvas is split into 8x8 tiles. While a stroke is open, the first
+ * write to a tile copies its 64 pixels aside. EndStroke() XORs each copy
+ * with the tile as it is now and run-length encodes the result: pixels the
+ * stroke didn't change are zero, and a fill over a plain area XORs to one
+ * repeated word, so both encode to a couple of bytes. Tiles the stroke
+ * ended up not changing are dropped, and so is a stroke that changed
+ * nothing. Every stroke, fill included, is one undo step.
+ *
+ * XOR works both ways: applying the same delta again swaps the tile
+ * between its before and after pixels, so one delta serves undo and redo.
+ *
+ * Steps are kept within a fixed byte budget, counting the encoded deltas
+ * and a small overhead per tile and step. The oldest steps are dropped to
+ * make room; a single step larger than the whole budget can't be undone.
+ * Recording a new step drops everything that could have been redone.
+ *
+ * USAGE:
+ * ------
+ *   EditHistory::Init(pixels, width, height);
+ *
+ *   EditHistory::BeginStroke();
+ *   EditHistory::Record(x, y);       // Before every pixel write
+ *   pixels[y * width + x] = color;
+ *   EditHistory::EndStroke();
+ *
+ *   EditHistory::PixelRect changed;
+ *   if (EditHistory::Undo(&changed)) {
+ *       redraw(changed);
+ *   }
+ *
+ *   EditHistory::Clear();            // Editor closed
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace EditHistory {
+
+constexpr int TILE_SIZE = 8;
+constexpr size_t DEFAULT_BUDGET_BYTES = 256 * 1024;
+
+// Canvas pixels, inclusive
+struct PixelRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+// Start an empty history for a canvas. The pixels must stay in place
+// until Clear()
+void Init(uint32_t* pixels, int width, int height, size_t budgetBytes = DEFAULT_BUDGET_BYTES);
+void Clear();
+
+// Group the writes that follow into one step. Nested calls are ignored
+void BeginStroke();
+void EndStroke();
+bool IsStrokeOpen();
+
+// Call before writing a pixel, or a row of pixels from left to right,
+// while a stroke is open
+void Record(int x, int y);
+void RecordSpan(int left, int right, int y);
+
+// Swap the canvas back or forward one step; outChanged gets the bounds of
+// the tiles it rewrote. False if there was no step (or a stroke is open)
+bool Undo(PixelRect* outChanged);
+bool Redo(PixelRect* outChanged);
+
+bool CanUndo();
+bool CanRedo();
+int GetUndoCount();
+int GetRedoCount();
+
+// Bytes the kept steps count against the budget
+size_t GetUsedBytes();
+
+}
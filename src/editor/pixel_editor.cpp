@@ -1,12 +1,26 @@
 /**
  * Pixel Editor Implementation
  *
- * Uses libgd for canvas operations, OSScreen for display.
+ * The canvas is a plain RGBA buffer; libgd only loads and saves PNGs.
+ *
+ * Drawing runs in the renderer's retained mode. Each frame invalidates
+ * the zoomed cells that changed since the last one, plus the old and new
+ * cursor cells, and the canvas only builds draws for cells the renderer
+ * will actually redraw (Renderer::NeedsDraw). Moving the view, zooming or
+ * toggling the grid invalidates the whole canvas.
+ *
+ * The minimap is a scaled copy of the canvas kept as one image. Only the
+ * minimap pixels sampled from changed canvas pixels are resampled, and it
+ * is drawn as a single image draw.
  */
 
 #include "pixel_editor.h"
+#include "edit_history.h"
 #include "../render/renderer.h"
 #include "../input/buttons.h"
+#include "../render/image_loader.h"
+#include "../storage/file_storage.h"
+#include "../storage/image_store.h"
 
 #include <gd.h>
 #include <vpad/input.h>
@@ -15,6 +29,8 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
+#include <vector>
 
 // Helper to ensure directory exists
 static void ensureDirectoryExists(const char* path)
@@ -93,7 +109,7 @@ namespace {
 
 // Editor state
 bool sIsOpen = false;
-gdImagePtr sCanvas = nullptr;
+std::vector<uint32_t> sPixels;  // Canvas, 0xRRGGBBAA, row by row
 Config sConfig;
 
 // View state
@@ -123,33 +139,104 @@ constexpr int MINIMAP_X = 600;
 constexpr int MINIMAP_Y = 250;
 constexpr int MINIMAP_SIZE = 128;
 
+constexpr uint32_t ERASER_COLOR = 0xFFFFFFFF;
+constexpr uint32_t GRID_COLOR = 0x404040FF;
+constexpr uint32_t CURSOR_COLOR = 0xFF0000FF;
+constexpr uint32_t HIGHLIGHT_COLOR = 0xFFFFFFFF;
+
+// Canvas pixels changed since the last frame, inclusive; empty when
+// right < left
+struct CanvasRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+CanvasRect sDirtyPixels = {0, 0, -1, -1};
+
+// The canvas scaled down to fit the minimap, kept between frames and
+// updated where the canvas changes. The source maps give the canvas
+// column and row each minimap pixel samples; both only ever increase
+std::vector<uint32_t> sMinimapPixels;
+Renderer::ImageData sMinimap = {};
+std::vector<int> sMinimapSourceX;
+std::vector<int> sMinimapSourceY;
+float sMinimapScale = 1.0f;
+
+// What the screen showed as of the last frame, to tell what changed
+struct DrawnState {
+    int viewX;
+    int viewY;
+    int zoom;
+    bool showGrid;
+    int cursorX;
+    int cursorY;
+    int color;
+    char toolbar[96];
+};
+
+DrawnState sDrawn;
+
 // =============================================================================
 // Helper Functions
 // =============================================================================
 
 /**
- * Convert palette color (0xRRGGBBAA) to gd color index.
+ * Get RGBA from gd pixel.
  */
-int gdColorFromRGBA(gdImagePtr img, uint32_t rgba)
+uint32_t rgbaFromGdPixel(gdImagePtr img, int x, int y)
+{
+    int pixel = gdImageGetPixel(img, x, y);
+    int r = gdImageRed(img, pixel);
+    int g = gdImageGreen(img, pixel);
+    int b = gdImageBlue(img, pixel);
+    int a = 255 - (gdImageAlpha(img, pixel) * 2);
+    return (r << 24) | (g << 16) | (b << 8) | a;
+}
+
+/**
+ * Convert RGBA to a gd truecolor pixel.
+ */
+int gdPixelFromRGBA(uint32_t rgba)
 {
     int r = (rgba >> 24) & 0xFF;
     int g = (rgba >> 16) & 0xFF;
     int b = (rgba >> 8) & 0xFF;
     int a = 127 - ((rgba & 0xFF) >> 1);  // gd alpha: 0=opaque, 127=transparent
-    return gdImageColorAllocateAlpha(img, r, g, b, a);
+    return gdTrueColorAlpha(r, g, b, a);
+}
+
+uint32_t* getRow(int y)
+{
+    return sPixels.data() + y * sConfig.width;
 }
 
 /**
- * Get RGBA from gd pixel.
+ * Add canvas pixels to what the next frame redraws.
  */
-uint32_t rgbaFromGdPixel(gdImagePtr img, int x, int y)
+void markDirty(int left, int top, int right, int bottom)
 {
-    int pixel = gdImageGetPixel(img, x, y);
-    int r = gdImageRed(img, pixel);
-    int g = gdImageGreen(img, pixel);
-    int b = gdImageBlue(img, pixel);
-    int a = 255 - (gdImageAlpha(img, pixel) * 2);
-    return (r << 24) | (g << 16) | (b << 8) | a;
+    if (sDirtyPixels.right < sDirtyPixels.left) {
+        sDirtyPixels = {left, top, right, bottom};
+        return;
+    }
+    sDirtyPixels.left = std::min(sDirtyPixels.left, left);
+    sDirtyPixels.top = std::min(sDirtyPixels.top, top);
+    sDirtyPixels.right = std::max(sDirtyPixels.right, right);
+    sDirtyPixels.bottom = std::max(sDirtyPixels.bottom, bottom);
+}
+
+void setPixel(int x, int y, uint32_t color)
+{
+    if (x < 0 || x >= sConfig.width || y < 0 || y >= sConfig.height) return;
+
+    uint32_t& pixel = getRow(y)[x];
+    if (pixel != color) {
+        EditHistory::Record(x, y);
+        pixel = color;
+        markDirty(x, y, x, y);
+    }
 }
 
 /**
@@ -195,24 +282,71 @@ void updateView()
     if (sViewY < 0) sViewY = 0;
 }
 
+struct FillSeed {
+    int x;
+    int y;
+};
+
+/**
+ * Queue the start of every run of targetColor in row y between left and
+ * right, the span just filled in the row next to it.
+ */
+void queueFillRuns(std::vector<FillSeed>& seeds, int y, int left, int right, uint32_t targetColor)
+{
+    if (y < 0 || y >= sConfig.height) return;
+
+    const uint32_t* row = getRow(y);
+    bool isInRun = false;
+    for (int x = left; x <= right; x++) {
+        bool isTarget = row[x] == targetColor;
+        if (isTarget && !isInRun) {
+            seeds.push_back({x, y});
+        }
+        isInRun = isTarget;
+    }
+}
+
 /**
- * Flood fill algorithm.
+ * Scanline flood fill on the canvas rows.
+ *
+ * Each seed fills the whole horizontal span of the target color around it,
+ * then queues one seed per run of the target color in the rows above and
+ * below. The work stack is a vector rather than recursion, and only run
+ * starts go on it, so a seed is pushed at most twice per pixel (once from
+ * each neighbouring row) however large the canvas is.
  */
-void floodFill(int x, int y, int targetColor, int fillColor)
+void floodFill(int x, int y, uint32_t fillColor)
 {
     if (x < 0 || x >= sConfig.width || y < 0 || y >= sConfig.height) return;
+
+    uint32_t targetColor = getRow(y)[x];
     if (targetColor == fillColor) return;
 
-    int current = gdImageGetPixel(sCanvas, x, y);
-    if (current != targetColor) return;
+    std::vector<FillSeed> seeds;
+    seeds.reserve(64);
+    seeds.push_back({x, y});
+
+    while (!seeds.empty()) {
+        FillSeed seed = seeds.back();
+        seeds.pop_back();
+
+        uint32_t* row = getRow(seed.y);
+        if (row[seed.x] != targetColor) continue;  // Filled since it was queued
+
+        int left = seed.x;
+        while (left > 0 && row[left - 1] == targetColor) left--;
+        int right = seed.x;
+        while (right < sConfig.width - 1 && row[right + 1] == targetColor) right++;
 
-    gdImageSetPixel(sCanvas, x, y, fillColor);
+        EditHistory::RecordSpan(left, right, seed.y);
+        for (int spanX = left; spanX <= right; spanX++) {
+            row[spanX] = fillColor;
+        }
+        markDirty(left, seed.y, right, seed.y);
 
-    // Recursive fill (could use stack for large canvases)
-    floodFill(x + 1, y, targetColor, fillColor);
-    floodFill(x - 1, y, targetColor, fillColor);
-    floodFill(x, y + 1, targetColor, fillColor);
-    floodFill(x, y - 1, targetColor, fillColor);
+        queueFillRuns(seeds, seed.y - 1, left, right, targetColor);
+        queueFillRuns(seeds, seed.y + 1, left, right, targetColor);
+    }
 }
 
 // =============================================================================
@@ -220,70 +354,193 @@ void floodFill(int x, int y, int targetColor, int fillColor)
 // =============================================================================
 
 /**
- * Draw the canvas to screen.
+ * Invalidate the screen area of canvas cells, with the grid lines around
+ * them. Cells outside the view are skipped.
  */
-void drawCanvas()
+void invalidateCells(int left, int top, int right, int bottom)
 {
     int viewW = CANVAS_SCREEN_W / sZoom;
     int viewH = CANVAS_SCREEN_H / sZoom;
+    left = std::max(left, sViewX);
+    top = std::max(top, sViewY);
+    right = std::min(right, sViewX + viewW - 1);
+    bottom = std::min(bottom, sViewY + viewH - 1);
+    if (right < left || bottom < top) return;
+
+    Renderer::Invalidate(CANVAS_SCREEN_X + (left - sViewX) * sZoom,
+                         CANVAS_SCREEN_Y + (top - sViewY) * sZoom,
+                         (right - left + 1) * sZoom + 1,
+                         (bottom - top + 1) * sZoom + 1);
+}
 
-    // Draw each visible pixel
-    for (int cy = 0; cy < viewH && (sViewY + cy) < sConfig.height; cy++) {
-        for (int cx = 0; cx < viewW && (sViewX + cx) < sConfig.width; cx++) {
-            int canvasX = sViewX + cx;
-            int canvasY = sViewY + cy;
+/**
+ * Size the minimap for the canvas and sample all of it.
+ */
+void buildMinimap()
+{
+    // Scale canvas to minimap size
+    float scaleX = (float)MINIMAP_SIZE / sConfig.width;
+    float scaleY = (float)MINIMAP_SIZE / sConfig.height;
+    sMinimapScale = (scaleX < scaleY) ? scaleX : scaleY;
 
-            uint32_t color = rgbaFromGdPixel(sCanvas, canvasX, canvasY);
+    int drawW = std::max((int)(sConfig.width * sMinimapScale), 1);
+    int drawH = std::max((int)(sConfig.height * sMinimapScale), 1);
 
-            int screenX = CANVAS_SCREEN_X + cx * sZoom;
-            int screenY = CANVAS_SCREEN_Y + cy * sZoom;
-
-            // Draw zoomed pixel
-            for (int py = 0; py < sZoom; py++) {
-                for (int px = 0; px < sZoom; px++) {
-                    uint32_t rgbx = color & 0xFFFFFF00;
-                    OSScreenPutPixelEx(SCREEN_TV, screenX + px, screenY + py, rgbx);
-                    OSScreenPutPixelEx(SCREEN_DRC, screenX + px, screenY + py, rgbx);
-                }
-            }
+    sMinimapSourceX.resize(drawW);
+    for (int mx = 0; mx < drawW; mx++) {
+        sMinimapSourceX[mx] = std::min((int)(mx / sMinimapScale), sConfig.width - 1);
+    }
+    sMinimapSourceY.resize(drawH);
+    for (int my = 0; my < drawH; my++) {
+        sMinimapSourceY[my] = std::min((int)(my / sMinimapScale), sConfig.height - 1);
+    }
+
+    sMinimapPixels.assign(drawW * drawH, 0);
+    sMinimap.pixels = sMinimapPixels.data();
+    sMinimap.width = drawW;
+    sMinimap.height = drawH;
+    sMinimap.format = Renderer::PixelFormat::RGBA8888;
+}
+
+/**
+ * Resample the minimap pixels whose source lies in a canvas rectangle and
+ * invalidate them. Returns false if none do (a pixel skipped when zooming
+ * out).
+ */
+bool updateMinimap(const CanvasRect& changed)
+{
+    auto firstX = std::lower_bound(sMinimapSourceX.begin(), sMinimapSourceX.end(), changed.left);
+    auto lastX = std::upper_bound(firstX, sMinimapSourceX.end(), changed.right);
+    auto firstY = std::lower_bound(sMinimapSourceY.begin(), sMinimapSourceY.end(), changed.top);
+    auto lastY = std::upper_bound(firstY, sMinimapSourceY.end(), changed.bottom);
+    if (firstX == lastX || firstY == lastY) return false;
+
+    int left = static_cast<int>(firstX - sMinimapSourceX.begin());
+    int right = static_cast<int>(lastX - sMinimapSourceX.begin());
+    int top = static_cast<int>(firstY - sMinimapSourceY.begin());
+    int bottom = static_cast<int>(lastY - sMinimapSourceY.begin());
+
+    for (int my = top; my < bottom; my++) {
+        const uint32_t* source = getRow(sMinimapSourceY[my]);
+        uint32_t* row = sMinimapPixels.data() + my * sMinimap.width;
+        for (int mx = left; mx < right; mx++) {
+            // Drawn opaque, as the canvas cells are
+            row[mx] = source[sMinimapSourceX[mx]] | 0xFF;
         }
     }
 
-    // Draw grid if enabled
-    if (sShowGrid && sZoom >= 4) {
-        uint32_t gridColor = 0x40404000;
-        for (int cy = 0; cy <= viewH; cy++) {
-            int screenY = CANVAS_SCREEN_Y + cy * sZoom;
-            for (int sx = CANVAS_SCREEN_X; sx < CANVAS_SCREEN_X + viewW * sZoom; sx++) {
-                OSScreenPutPixelEx(SCREEN_TV, sx, screenY, gridColor);
-                OSScreenPutPixelEx(SCREEN_DRC, sx, screenY, gridColor);
-            }
+    // The GX2 backend keeps its own copy of an image
+    Renderer::ReleaseImage(&sMinimap);
+    Renderer::Invalidate(MINIMAP_X + left, MINIMAP_Y + top, right - left, bottom - top);
+    return true;
+}
+
+void formatToolbar(char* buffer, size_t size)
+{
+    const char* toolName = "Pencil";
+    switch (sCurrentTool) {
+        case Tool::PENCIL: toolName = "Pencil"; break;
+        case Tool::ERASER: toolName = "Eraser"; break;
+        case Tool::FILL: toolName = "Fill"; break;
+        case Tool::COLOR_PICKER: toolName = "Picker"; break;
+    }
+
+    snprintf(buffer, size, "Tool: %s  Zoom: %dx  Grid: %s  Pos: %d,%d",
+        toolName, sZoom, sShowGrid ? "ON" : "OFF", sCursorX, sCursorY);
+}
+
+/**
+ * Invalidate whatever changed since the last frame. Must run before
+ * Renderer::BeginFrame(), which takes the frame's region from it.
+ */
+void invalidateChanges()
+{
+    bool isViewChanged = sDrawn.viewX != sViewX || sDrawn.viewY != sViewY ||
+                         sDrawn.zoom != sZoom || sDrawn.showGrid != sShowGrid;
+    bool isCanvasChanged = sDirtyPixels.right >= sDirtyPixels.left;
+
+    if (isViewChanged) {
+        Renderer::Invalidate(CANVAS_SCREEN_X, CANVAS_SCREEN_Y, CANVAS_SCREEN_W + 1, CANVAS_SCREEN_H + 1);
+    } else {
+        if (isCanvasChanged) {
+            invalidateCells(sDirtyPixels.left, sDirtyPixels.top, sDirtyPixels.right, sDirtyPixels.bottom);
         }
-        for (int cx = 0; cx <= viewW; cx++) {
+        if (sDrawn.cursorX != sCursorX || sDrawn.cursorY != sCursorY) {
+            invalidateCells(sDrawn.cursorX, sDrawn.cursorY, sDrawn.cursorX, sDrawn.cursorY);
+            invalidateCells(sCursorX, sCursorY, sCursorX, sCursorY);
+        }
+    }
+
+    // Only the pixels sampled from what changed are redone; the view
+    // rectangle moving redraws the whole minimap
+    if (isCanvasChanged) {
+        updateMinimap(sDirtyPixels);
+    }
+    if (isViewChanged) {
+        Renderer::Invalidate(MINIMAP_X, MINIMAP_Y, MINIMAP_SIZE + 1, MINIMAP_SIZE + 1);
+    }
+
+    if (sDrawn.color != sCurrentColor) {
+        Renderer::Invalidate(PALETTE_X, PALETTE_Y, 4 * (PALETTE_CELL + 2), 4 * (PALETTE_CELL + 2));
+    }
+
+    char toolbar[sizeof(sDrawn.toolbar)];
+    formatToolbar(toolbar, sizeof(toolbar));
+    if (strcmp(toolbar, sDrawn.toolbar) != 0) {
+        Renderer::InvalidateRows(0, 1);
+        memcpy(sDrawn.toolbar, toolbar, sizeof(toolbar));
+    }
+
+    sDrawn.viewX = sViewX;
+    sDrawn.viewY = sViewY;
+    sDrawn.zoom = sZoom;
+    sDrawn.showGrid = sShowGrid;
+    sDrawn.cursorX = sCursorX;
+    sDrawn.cursorY = sCursorY;
+    sDrawn.color = sCurrentColor;
+    sDirtyPixels = {0, 0, -1, -1};
+}
+
+/**
+ * Draw the canvas cells the renderer is redrawing this frame.
+ */
+void drawCanvas()
+{
+    int viewW = CANVAS_SCREEN_W / sZoom;
+    int viewH = CANVAS_SCREEN_H / sZoom;
+    int cols = std::min(viewW, sConfig.width - sViewX);
+    int rows = std::min(viewH, sConfig.height - sViewY);
+
+    // The grid is the background showing through a 1px gap at each
+    // cell's top and left, and past the last row and column
+    bool isGridShown = sShowGrid && sZoom >= 4;
+    int inset = isGridShown ? 1 : 0;
+    if (isGridShown) {
+        Renderer::DrawPlaceholder(CANVAS_SCREEN_X, CANVAS_SCREEN_Y,
+                                  viewW * sZoom + 1, viewH * sZoom + 1, GRID_COLOR);
+    }
+
+    for (int cy = 0; cy < rows; cy++) {
+        int screenY = CANVAS_SCREEN_Y + cy * sZoom;
+        if (!Renderer::NeedsDraw(CANVAS_SCREEN_X, screenY, cols * sZoom, sZoom)) continue;
+
+        const uint32_t* row = getRow(sViewY + cy) + sViewX;
+        for (int cx = 0; cx < cols; cx++) {
             int screenX = CANVAS_SCREEN_X + cx * sZoom;
-            for (int sy = CANVAS_SCREEN_Y; sy < CANVAS_SCREEN_Y + viewH * sZoom; sy++) {
-                OSScreenPutPixelEx(SCREEN_TV, screenX, sy, gridColor);
-                OSScreenPutPixelEx(SCREEN_DRC, screenX, sy, gridColor);
-            }
+            if (!Renderer::NeedsDraw(screenX, screenY, sZoom, sZoom)) continue;
+
+            Renderer::DrawPlaceholder(screenX + inset, screenY + inset,
+                                      sZoom - inset, sZoom - inset, row[cx]);
         }
     }
 
-    // Draw cursor
+    // Draw cursor outline
     int cursorScreenX = CANVAS_SCREEN_X + (sCursorX - sViewX) * sZoom;
     int cursorScreenY = CANVAS_SCREEN_Y + (sCursorY - sViewY) * sZoom;
-    uint32_t cursorColor = 0xFF000000;  // Red outline
-
-    // Draw cursor outline
-    for (int i = 0; i < sZoom; i++) {
-        OSScreenPutPixelEx(SCREEN_TV, cursorScreenX + i, cursorScreenY, cursorColor);
-        OSScreenPutPixelEx(SCREEN_DRC, cursorScreenX + i, cursorScreenY, cursorColor);
-        OSScreenPutPixelEx(SCREEN_TV, cursorScreenX + i, cursorScreenY + sZoom - 1, cursorColor);
-        OSScreenPutPixelEx(SCREEN_DRC, cursorScreenX + i, cursorScreenY + sZoom - 1, cursorColor);
-        OSScreenPutPixelEx(SCREEN_TV, cursorScreenX, cursorScreenY + i, cursorColor);
-        OSScreenPutPixelEx(SCREEN_DRC, cursorScreenX, cursorScreenY + i, cursorColor);
-        OSScreenPutPixelEx(SCREEN_TV, cursorScreenX + sZoom - 1, cursorScreenY + i, cursorColor);
-        OSScreenPutPixelEx(SCREEN_DRC, cursorScreenX + sZoom - 1, cursorScreenY + i, cursorColor);
-    }
+    Renderer::DrawHLine(cursorScreenX, cursorScreenY, sZoom, CURSOR_COLOR);
+    Renderer::DrawHLine(cursorScreenX, cursorScreenY + sZoom - 1, sZoom, CURSOR_COLOR);
+    Renderer::DrawVLine(cursorScreenX, cursorScreenY, sZoom, CURSOR_COLOR);
+    Renderer::DrawVLine(cursorScreenX + sZoom - 1, cursorScreenY, sZoom, CURSOR_COLOR);
 }
 
 /**
@@ -299,30 +556,14 @@ void drawPalette()
         int x = PALETTE_X + col * (PALETTE_CELL + 2);
         int y = PALETTE_Y + row * (PALETTE_CELL + 2);
 
-        uint32_t color = sPalette->colors[i];
-        uint32_t rgbx = color & 0xFFFFFF00;
-
-        // Draw color cell
-        for (int py = 0; py < PALETTE_CELL; py++) {
-            for (int px = 0; px < PALETTE_CELL; px++) {
-                OSScreenPutPixelEx(SCREEN_TV, x + px, y + py, rgbx);
-                OSScreenPutPixelEx(SCREEN_DRC, x + px, y + py, rgbx);
-            }
-        }
+        Renderer::DrawPlaceholder(x, y, PALETTE_CELL, PALETTE_CELL, sPalette->colors[i]);
 
         // Highlight selected color
         if (i == sCurrentColor) {
-            uint32_t highlight = 0xFFFFFF00;
-            for (int j = 0; j < PALETTE_CELL; j++) {
-                OSScreenPutPixelEx(SCREEN_TV, x + j, y, highlight);
-                OSScreenPutPixelEx(SCREEN_DRC, x + j, y, highlight);
-                OSScreenPutPixelEx(SCREEN_TV, x + j, y + PALETTE_CELL - 1, highlight);
-                OSScreenPutPixelEx(SCREEN_DRC, x + j, y + PALETTE_CELL - 1, highlight);
-                OSScreenPutPixelEx(SCREEN_TV, x, y + j, highlight);
-                OSScreenPutPixelEx(SCREEN_DRC, x, y + j, highlight);
-                OSScreenPutPixelEx(SCREEN_TV, x + PALETTE_CELL - 1, y + j, highlight);
-                OSScreenPutPixelEx(SCREEN_DRC, x + PALETTE_CELL - 1, y + j, highlight);
-            }
+            Renderer::DrawHLine(x, y, PALETTE_CELL, HIGHLIGHT_COLOR);
+            Renderer::DrawHLine(x, y + PALETTE_CELL - 1, PALETTE_CELL, HIGHLIGHT_COLOR);
+            Renderer::DrawVLine(x, y, PALETTE_CELL, HIGHLIGHT_COLOR);
+            Renderer::DrawVLine(x + PALETTE_CELL - 1, y, PALETTE_CELL, HIGHLIGHT_COLOR);
         }
     }
 }
@@ -334,51 +575,24 @@ void drawMinimap()
 {
     Renderer::DrawText(MINIMAP_X / 8, MINIMAP_Y / 24 - 1, "Preview:");
 
-    // Scale canvas to minimap size
-    float scaleX = (float)MINIMAP_SIZE / sConfig.width;
-    float scaleY = (float)MINIMAP_SIZE / sConfig.height;
-    float scale = (scaleX < scaleY) ? scaleX : scaleY;
-
-    int drawW = (int)(sConfig.width * scale);
-    int drawH = (int)(sConfig.height * scale);
-
-    for (int my = 0; my < drawH; my++) {
-        for (int mx = 0; mx < drawW; mx++) {
-            int canvasX = (int)(mx / scale);
-            int canvasY = (int)(my / scale);
-
-            if (canvasX >= sConfig.width) canvasX = sConfig.width - 1;
-            if (canvasY >= sConfig.height) canvasY = sConfig.height - 1;
-
-            uint32_t color = rgbaFromGdPixel(sCanvas, canvasX, canvasY);
-            uint32_t rgbx = color & 0xFFFFFF00;
-
-            OSScreenPutPixelEx(SCREEN_TV, MINIMAP_X + mx, MINIMAP_Y + my, rgbx);
-            OSScreenPutPixelEx(SCREEN_DRC, MINIMAP_X + mx, MINIMAP_Y + my, rgbx);
-        }
+    if (!Renderer::NeedsDraw(MINIMAP_X, MINIMAP_Y, MINIMAP_SIZE + 1, MINIMAP_SIZE + 1)) {
+        return;
     }
 
+    Renderer::DrawImage(MINIMAP_X, MINIMAP_Y, &sMinimap);
+
     // Draw viewport rectangle
     int viewW = CANVAS_SCREEN_W / sZoom;
     int viewH = CANVAS_SCREEN_H / sZoom;
-    int rectX = MINIMAP_X + (int)(sViewX * scale);
-    int rectY = MINIMAP_Y + (int)(sViewY * scale);
-    int rectW = (int)(viewW * scale);
-    int rectH = (int)(viewH * scale);
-
-    uint32_t rectColor = 0xFF000000;
-    for (int i = 0; i < rectW; i++) {
-        OSScreenPutPixelEx(SCREEN_TV, rectX + i, rectY, rectColor);
-        OSScreenPutPixelEx(SCREEN_DRC, rectX + i, rectY, rectColor);
-        OSScreenPutPixelEx(SCREEN_TV, rectX + i, rectY + rectH, rectColor);
-        OSScreenPutPixelEx(SCREEN_DRC, rectX + i, rectY + rectH, rectColor);
-    }
-    for (int i = 0; i < rectH; i++) {
-        OSScreenPutPixelEx(SCREEN_TV, rectX, rectY + i, rectColor);
-        OSScreenPutPixelEx(SCREEN_DRC, rectX, rectY + i, rectColor);
-        OSScreenPutPixelEx(SCREEN_TV, rectX + rectW, rectY + i, rectColor);
-        OSScreenPutPixelEx(SCREEN_DRC, rectX + rectW, rectY + i, rectColor);
-    }
+    int rectX = MINIMAP_X + (int)(sViewX * sMinimapScale);
+    int rectY = MINIMAP_Y + (int)(sViewY * sMinimapScale);
+    int rectW = (int)(viewW * sMinimapScale);
+    int rectH = (int)(viewH * sMinimapScale);
+
+    Renderer::DrawHLine(rectX, rectY, rectW, CURSOR_COLOR);
+    Renderer::DrawHLine(rectX, rectY + rectH, rectW, CURSOR_COLOR);
+    Renderer::DrawVLine(rectX, rectY, rectH, CURSOR_COLOR);
+    Renderer::DrawVLine(rectX + rectW, rectY, rectH, CURSOR_COLOR);
 }
 
 /**
@@ -386,19 +600,9 @@ void drawMinimap()
  */
 void drawToolbar()
 {
-    // Tool indicator
-    const char* toolName = "Pencil";
-    switch (sCurrentTool) {
-        case Tool::PENCIL: toolName = "Pencil"; break;
-        case Tool::ERASER: toolName = "Eraser"; break;
-        case Tool::FILL: toolName = "Fill"; break;
-        case Tool::COLOR_PICKER: toolName = "Picker"; break;
-    }
-
-    Renderer::DrawTextF(0, 0, "Tool: %s  Zoom: %dx  Grid: %s  Pos: %d,%d",
-        toolName, sZoom, sShowGrid ? "ON" : "OFF", sCursorX, sCursorY);
+    Renderer::DrawText(0, 0, sDrawn.toolbar);
 
-    Renderer::DrawText(0, 17, "A:Draw  X:Eraser  Y:Fill  L/R:Zoom  +/-:Grid  B:Save&Exit");
+    Renderer::DrawText(0, 17, "A:Draw  X:Eraser  Y:Fill  L/R:Zoom  +:Grid  ZL/ZR:Undo/Redo  B:Save&Exit");
 }
 
 /**
@@ -462,15 +666,12 @@ bool handleTouch(const VPADStatus& vpad)
             sCursorY = canvasY;
 
             // Draw at touch position
-            int gdColor = gdColorFromRGBA(sCanvas, sPalette->colors[sCurrentColor]);
-
             switch (sCurrentTool) {
                 case Tool::PENCIL:
-                    gdImageSetPixel(sCanvas, canvasX, canvasY, gdColor);
+                    setPixel(canvasX, canvasY, sPalette->colors[sCurrentColor]);
                     break;
                 case Tool::ERASER:
-                    gdColor = gdColorFromRGBA(sCanvas, 0xFFFFFFFF);
-                    gdImageSetPixel(sCanvas, canvasX, canvasY, gdColor);
+                    setPixel(canvasX, canvasY, ERASER_COLOR);
                     break;
                 case Tool::FILL:
                     // Fill only on initial touch (handled separately)
@@ -513,14 +714,20 @@ bool handleInput(const VPADStatus& vpad)
     VPADGetTPCalibratedPoint(VPAD_CHAN_0, &calibrated, &vpad.tpNormal);
     bool isTouching = calibrated.touched != 0;
 
+    // Everything drawn while A or the touch screen is held is one undo step
+    bool isDrawing = isTouching || (held & VPAD_BUTTON_A);
+    if (isDrawing) {
+        EditHistory::BeginStroke();
+    } else {
+        EditHistory::EndStroke();
+    }
+
     if (isTouching) {
         handleTouch(vpad);
 
         // Fill on initial touch
         if (!wasTouching && sCurrentTool == Tool::FILL) {
-            int gdColor = gdColorFromRGBA(sCanvas, sPalette->colors[sCurrentColor]);
-            int target = gdImageGetPixel(sCanvas, sCursorX, sCursorY);
-            floodFill(sCursorX, sCursorY, target, gdColor);
+            floodFill(sCursorX, sCursorY, sPalette->colors[sCurrentColor]);
         }
     }
     wasTouching = isTouching;
@@ -568,20 +775,18 @@ bool handleInput(const VPADStatus& vpad)
 
     // Draw with A (or held)
     if ((pressed & VPAD_BUTTON_A) || (held & VPAD_BUTTON_A)) {
-        int gdColor = gdColorFromRGBA(sCanvas, sPalette->colors[sCurrentColor]);
+        uint32_t color = sPalette->colors[sCurrentColor];
 
         switch (sCurrentTool) {
             case Tool::PENCIL:
-                gdImageSetPixel(sCanvas, sCursorX, sCursorY, gdColor);
+                setPixel(sCursorX, sCursorY, color);
                 break;
             case Tool::ERASER:
-                gdColor = gdColorFromRGBA(sCanvas, 0xFFFFFFFF);
-                gdImageSetPixel(sCanvas, sCursorX, sCursorY, gdColor);
+                setPixel(sCursorX, sCursorY, ERASER_COLOR);
                 break;
             case Tool::FILL:
                 if (pressed & VPAD_BUTTON_A) {
-                    int target = gdImageGetPixel(sCanvas, sCursorX, sCursorY);
-                    floodFill(sCursorX, sCursorY, target, gdColor);
+                    floodFill(sCursorX, sCursorY, color);
                 }
                 break;
             case Tool::COLOR_PICKER:
@@ -608,6 +813,15 @@ bool handleInput(const VPADStatus& vpad)
         updateView();
     }
 
+    // Undo / redo, between strokes
+    EditHistory::PixelRect changed;
+    if ((pressed & VPAD_BUTTON_ZL) && EditHistory::Undo(&changed)) {
+        markDirty(changed.left, changed.top, changed.right, changed.bottom);
+    }
+    if ((pressed & VPAD_BUTTON_ZR) && EditHistory::Redo(&changed)) {
+        markDirty(changed.left, changed.top, changed.right, changed.bottom);
+    }
+
     // Grid toggle
     if (pressed & VPAD_BUTTON_PLUS) {
         sShowGrid = !sShowGrid;
@@ -633,14 +847,67 @@ bool handleInput(const VPADStatus& vpad)
 // Save/Load
 // =============================================================================
 
+/**
+ * Copy the canvas into a new gd image for PNG encoding.
+ */
+gdImagePtr createGdImage()
+{
+    gdImagePtr image = gdImageCreateTrueColor(sConfig.width, sConfig.height);
+    if (!image) return nullptr;
+
+    for (int y = 0; y < sConfig.height; y++) {
+        const uint32_t* row = getRow(y);
+        for (int x = 0; x < sConfig.width; x++) {
+            image->tpixels[y][x] = gdPixelFromRGBA(row[x]);
+        }
+    }
+    return image;
+}
+
 bool saveCanvas(const char* path)
 {
+    gdImagePtr image = createGdImage();
+    if (!image) return false;
+
     FILE* out = fopen(path, "wb");
-    if (!out) return false;
+    if (out) {
+        gdImagePng(image, out);
+        fclose(out);
+    }
+    gdImageDestroy(image);
+    return out != nullptr;
+}
 
-    gdImagePng(sCanvas, out);
-    fclose(out);
-    return true;
+/**
+ * Show the canvas as a title's icon straight away and write it to the SD
+ * icon folder in the background. The PNG is encoded here (an icon-sized
+ * canvas takes very little time); the write runs on the I/O thread, so
+ * closing the editor doesn't wait for the SD card.
+ */
+bool saveIcon(uint64_t titleId)
+{
+    ImageLoader::Replace(titleId, sPixels.data(), sConfig.width, sConfig.height);
+
+    gdImagePtr image = createGdImage();
+    if (!image) return false;
+
+    int pngSize = 0;
+    void* png = gdImagePngPtr(image, &pngSize);
+    gdImageDestroy(image);
+    if (!png) return false;
+
+    // WriteAsync takes a malloc'd buffer
+    uint8_t* data = static_cast<uint8_t*>(malloc(pngSize));
+    if (data) {
+        memcpy(data, png, pngSize);
+    }
+    gdFree(png);
+    if (!data) return false;
+
+    char path[160];
+    ImageStore::GetIconPath(titleId, path, sizeof(path));
+    FileStorage::CreateDir(ImageStore::GetIconsDirectory());
+    return FileStorage::WriteAsync(path, data, pngSize);
 }
 
 bool loadCanvas(const char* path)
@@ -658,9 +925,9 @@ bool loadCanvas(const char* path)
     int h = gdImageSY(loaded);
 
     for (int y = 0; y < h && y < sConfig.height; y++) {
+        uint32_t* row = getRow(y);
         for (int x = 0; x < w && x < sConfig.width; x++) {
-            int pixel = gdImageGetPixel(loaded, x, y);
-            gdImageSetPixel(sCanvas, x, y, pixel);
+            row[x] = rgbaFromGdPixel(loaded, x, y);
         }
     }
 
@@ -681,30 +948,23 @@ bool Open(const Config& config)
     sConfig = config;
     sIsOpen = true;
 
-    // Create canvas
-    sCanvas = gdImageCreateTrueColor(config.width, config.height);
-    if (!sCanvas) {
-        sIsOpen = false;
-        return false;
-    }
+    // Create canvas, white where nothing gets loaded
+    sPixels.assign(config.width * config.height, ERASER_COLOR);
 
     // Try to load previous drawing first
     char autoLoadPath[256];
-    snprintf(autoLoadPath, sizeof(autoLoadPath), "%sdrawing.png", config.savePath);
+    if (config.iconTitleId != 0) {
+        ImageStore::GetIconPath(config.iconTitleId, autoLoadPath, sizeof(autoLoadPath));
+    } else {
+        snprintf(autoLoadPath, sizeof(autoLoadPath), "%sdrawing.png", config.savePath);
+    }
 
-    bool loaded = false;
     if (config.loadFile) {
         // Load specified file
-        loaded = loadCanvas(config.loadFile);
+        loadCanvas(config.loadFile);
     } else {
         // Try to load auto-saved drawing
-        loaded = loadCanvas(autoLoadPath);
-    }
-
-    // Fill with white only if no image was loaded
-    if (!loaded) {
-        int white = gdImageColorAllocate(sCanvas, 255, 255, 255);
-        gdImageFilledRectangle(sCanvas, 0, 0, config.width - 1, config.height - 1, white);
+        loadCanvas(autoLoadPath);
     }
 
     // Reset state
@@ -720,6 +980,25 @@ bool Open(const Config& config)
 
     updateView();
 
+    buildMinimap();
+    updateMinimap({0, 0, config.width - 1, config.height - 1});
+
+    // History starts at the loaded drawing
+    EditHistory::Init(sPixels.data(), config.width, config.height);
+
+    // The first frame draws everything
+    sDrawn = {};
+    sDrawn.viewX = sViewX;
+    sDrawn.viewY = sViewY;
+    sDrawn.zoom = sZoom;
+    sDrawn.showGrid = sShowGrid;
+    sDrawn.cursorX = sCursorX;
+    sDrawn.cursorY = sCursorY;
+    sDrawn.color = sCurrentColor;
+    sDirtyPixels = {0, 0, -1, -1};
+    Renderer::SetRetainedMode(true);
+    Renderer::InvalidateAll();
+
     // Main loop
     VPADStatus vpadStatus;
     VPADReadError vpadError;
@@ -727,6 +1006,7 @@ bool Open(const Config& config)
     bool saved = false;
 
     while (running) {
+        invalidateChanges();
         Renderer::BeginFrame(0x202020FF);
 
         render();
@@ -740,16 +1020,25 @@ bool Open(const Config& config)
         }
     }
 
-    // Save on exit - ensure directory exists first
-    ensureDirectoryExists(config.savePath);
+    if (config.iconTitleId != 0) {
+        saved = saveIcon(config.iconTitleId);
+    } else {
+        // Save on exit - ensure directory exists first
+        ensureDirectoryExists(config.savePath);
 
-    char savePath[256];
-    snprintf(savePath, sizeof(savePath), "%sdrawing.png", config.savePath);
-    saved = saveCanvas(savePath);
+        char savePath[256];
+        snprintf(savePath, sizeof(savePath), "%sdrawing.png", config.savePath);
+        saved = saveCanvas(savePath);
+    }
 
     // Cleanup
-    gdImageDestroy(sCanvas);
-    sCanvas = nullptr;
+    EditHistory::Clear();
+    Renderer::ReleaseImage(&sMinimap);
+    sMinimap = {};
+    std::vector<uint32_t>().swap(sMinimapPixels);
+    Renderer::SetRetainedMode(false);
+    sPixels.clear();
+    sPixels.shrink_to_fit();
     sIsOpen = false;
 
     return saved;
@@ -766,8 +1055,7 @@ bool Edit(const char* filePath)
 
 uint32_t* GetPixels()
 {
-    // Would need to convert gdImage to raw pixels
-    return nullptr;
+    return sIsOpen ? sPixels.data() : nullptr;
 }
 
 int GetWidth()
@@ -1,7 +1,8 @@
 /**
  * Pixel Editor
  *
- * A simple pixel art editor using libgd for canvas operations.
+ * A simple pixel art editor. The canvas is a plain RGBA buffer; libgd
+ * only loads and saves PNG files.
  * Inspired by draw.js canvas implementation.
  *
  * FEATURES:
@@ -10,6 +11,7 @@
  * - Grid overlay matching zoom
  * - Color palette selection
  * - Tools: Pencil, Eraser, Fill
+ * - Undo/redo per stroke (see edit_history.h)
  * - Minimap preview
  * - Save/Load PNG to SD card
  *
@@ -21,7 +23,8 @@
  * - X: Eraser toggle
  * - Y: Fill tool
  * - L/R: Zoom out/in
- * - +/-: Grid size
+ * - +: Grid toggle
+ * - ZL/ZR: Undo/Redo
  * - Touch: Direct drawing
  *
  * USAGE:
@@ -50,6 +53,11 @@ struct Config {
     int height = 64;             // Canvas height in pixels
     const char* savePath = Paths::USER_DATA_DIR;  // Defined in utils/paths.h
     const char* loadFile = nullptr;  // Optional: load existing file
+
+    // Optional: edit this title's custom icon instead of drawing.png. On
+    // close the icon shows in the menu at once, and its PNG is written to
+    // the SD icon folder in the background
+    uint64_t iconTitleId = 0;
 };
 
 // =============================================================================
@@ -58,6 +58,9 @@ constexpr Button CANCEL        = { VPAD_BUTTON_B,     "B" };
 constexpr Button FAVORITE      = { VPAD_BUTTON_Y,     "Y" };
 constexpr Button EDIT          = { VPAD_BUTTON_X,     "X" };
 constexpr Button SETTINGS      = { VPAD_BUTTON_PLUS,  "+" };
+constexpr Button SORT          = { VPAD_BUTTON_MINUS, "-" };
+constexpr Button SEARCH        = { VPAD_BUTTON_STICK_L, "L3" };
+constexpr Button FACET         = { VPAD_BUTTON_STICK_R, "R3" };
 
 constexpr Button CATEGORY_PREV = { VPAD_BUTTON_ZL,    "ZL" };
 constexpr Button CATEGORY_NEXT = { VPAD_BUTTON_ZR,    "ZR" };
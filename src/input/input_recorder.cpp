@@ -0,0 +1,289 @@
+/**
+ * Input Recorder Implementation
+ *
+ * See input_recorder.h for usage documentation.
+ */
+
+#include "input_recorder.h"
+
+#ifdef ENABLE_INPUT_RECORDING
+#include "../storage/file_storage.h"
+#include "../utils/paths.h"
+#endif
+
+#include <cstdlib>
+
+namespace InputRecorder {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+constexpr uint32_t FILE_MAGIC = 0x52495354;    // "TSIR" as little-endian bytes
+constexpr uint16_t FILE_VERSION = 1;
+
+// A run's frame count is 31 bits; the top bit marks frames where nothing
+// could be read, which skip input handling on replay too
+constexpr uint32_t NO_READ_FLAG = 0x80000000u;
+constexpr uint32_t FRAME_COUNT_MASK = ~NO_READ_FLAG;
+
+struct Run {
+    uint32_t trigger;
+    uint32_t hold;
+    uint32_t frames;    // Count, plus NO_READ_FLAG
+};
+
+Mode sMode = Mode::IDLE;
+
+// MAX_RUNS, allocated on the first start
+Run* sRuns = nullptr;
+uint32_t sRunCount = 0;
+uint32_t sFrameCount = 0;
+
+// Whether the runs were loaded to replay rather than recorded
+bool sIsReplay = false;
+
+// Replay position
+uint32_t sReplayRun = 0;
+uint32_t sReplayFrame = 0;      // Within the run
+uint32_t sReplayedFrames = 0;
+
+bool ensureRuns()
+{
+    if (!sRuns) {
+        sRuns = static_cast<Run*>(malloc(MAX_RUNS * sizeof(Run)));
+    }
+    return sRuns != nullptr;
+}
+
+void putU32(uint8_t* out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint32_t getU32(const uint8_t* in)
+{
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+void record(bool hasRead, uint32_t pressed, uint32_t held)
+{
+    uint32_t trigger = hasRead ? pressed : 0;
+    uint32_t hold = hasRead ? held : 0;
+    uint32_t flag = hasRead ? 0 : NO_READ_FLAG;
+
+    if (sRunCount > 0) {
+        Run& last = sRuns[sRunCount - 1];
+        if (last.trigger == trigger && last.hold == hold && (last.frames & NO_READ_FLAG) == flag &&
+            (last.frames & FRAME_COUNT_MASK) < FRAME_COUNT_MASK) {
+            last.frames++;
+            sFrameCount++;
+            return;
+        }
+    }
+
+    // Full: keep what fits rather than a recording with a gap
+    if (sRunCount == MAX_RUNS) {
+        sMode = Mode::IDLE;
+        return;
+    }
+
+    sRuns[sRunCount++] = {trigger, hold, 1 | flag};
+    sFrameCount++;
+}
+
+bool replay(uint32_t* pressed, uint32_t* held)
+{
+    const Run& run = sRuns[sReplayRun];
+    *pressed = run.trigger;
+    *held = run.hold;
+
+    sReplayedFrames++;
+    if (++sReplayFrame >= (run.frames & FRAME_COUNT_MASK)) {
+        sReplayFrame = 0;
+        sReplayRun++;
+    }
+    if (sReplayRun >= sRunCount) {
+        sMode = Mode::IDLE;
+    }
+    return (run.frames & NO_READ_FLAG) == 0;
+}
+
+}
+
+// =============================================================================
+// Recording and Replay
+// =============================================================================
+
+bool StartRecording()
+{
+    if (!ensureRuns()) {
+        return false;
+    }
+    sRunCount = 0;
+    sFrameCount = 0;
+    sIsReplay = false;
+    sMode = Mode::RECORDING;
+    return true;
+}
+
+bool StartReplay(const uint8_t* data, size_t size)
+{
+    if (!data || size < HEADER_SIZE || getU32(data) != FILE_MAGIC ||
+        (static_cast<uint32_t>(data[4]) | (static_cast<uint32_t>(data[5]) << 8)) != FILE_VERSION) {
+        return false;
+    }
+
+    uint32_t runCount = getU32(data + 8);
+    if (runCount == 0 || runCount > MAX_RUNS || size < HEADER_SIZE + runCount * RUN_SIZE || !ensureRuns()) {
+        return false;
+    }
+
+    // Counted from the runs; the header's total is for tools reading the file
+    uint32_t frameCount = 0;
+    const uint8_t* in = data + HEADER_SIZE;
+    for (uint32_t runIndex = 0; runIndex < runCount; runIndex++, in += RUN_SIZE) {
+        Run& run = sRuns[runIndex];
+        run.trigger = getU32(in);
+        run.hold = getU32(in + 4);
+        run.frames = getU32(in + 8);
+        if ((run.frames & FRAME_COUNT_MASK) == 0) {
+            sRunCount = 0;
+            return false;
+        }
+        frameCount += run.frames & FRAME_COUNT_MASK;
+    }
+
+    sRunCount = runCount;
+    sFrameCount = frameCount;
+    sReplayRun = 0;
+    sReplayFrame = 0;
+    sReplayedFrames = 0;
+    sIsReplay = true;
+    sMode = Mode::REPLAYING;
+    return true;
+}
+
+void Stop()
+{
+    sMode = Mode::IDLE;
+}
+
+void Release()
+{
+    free(sRuns);
+    sRuns = nullptr;
+    sRunCount = 0;
+    sFrameCount = 0;
+    sIsReplay = false;
+    sMode = Mode::IDLE;
+}
+
+Mode GetMode()
+{
+    return sMode;
+}
+
+bool Apply(bool hasRead, uint32_t* pressed, uint32_t* held)
+{
+    switch (sMode) {
+        case Mode::IDLE:
+            break;
+        case Mode::RECORDING:
+            record(hasRead, *pressed, *held);
+            break;
+        case Mode::REPLAYING:
+            return replay(pressed, held);
+    }
+    return hasRead;
+}
+
+uint32_t GetFrameCount()
+{
+    return sIsReplay ? sFrameCount - sReplayedFrames : sFrameCount;
+}
+
+// =============================================================================
+// File Format
+// =============================================================================
+
+size_t GetEncodedSize()
+{
+    return HEADER_SIZE + sRunCount * RUN_SIZE;
+}
+
+size_t Encode(uint8_t* out, size_t capacity)
+{
+    size_t size = GetEncodedSize();
+    if (!out || capacity < size) {
+        return 0;
+    }
+
+    putU32(out, FILE_MAGIC);
+    out[4] = static_cast<uint8_t>(FILE_VERSION);
+    out[5] = static_cast<uint8_t>(FILE_VERSION >> 8);
+    out[6] = 0;
+    out[7] = 0;
+    putU32(out + 8, sRunCount);
+    putU32(out + 12, sFrameCount);
+
+    uint8_t* runOut = out + HEADER_SIZE;
+    for (uint32_t runIndex = 0; runIndex < sRunCount; runIndex++, runOut += RUN_SIZE) {
+        putU32(runOut, sRuns[runIndex].trigger);
+        putU32(runOut + 4, sRuns[runIndex].hold);
+        putU32(runOut + 8, sRuns[runIndex].frames);
+    }
+    return size;
+}
+
+// =============================================================================
+// Menu Sessions
+// =============================================================================
+
+#ifdef ENABLE_INPUT_RECORDING
+
+void BeginSession()
+{
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    if (FileStorage::Exists(Paths::INPUT_REPLAY_FILE) &&
+        FileStorage::ReadFile(Paths::INPUT_REPLAY_FILE, &data, &size)) {
+        bool isReplaying = StartReplay(data, size);
+        free(data);
+        if (isReplaying) {
+            return;
+        }
+    }
+
+    StartRecording();
+}
+
+void EndSession()
+{
+    Stop();
+    if (!sIsReplay && sRunCount > 0) {
+        size_t size = GetEncodedSize();
+        uint8_t* data = static_cast<uint8_t*>(malloc(size));
+        if (data) {
+            Encode(data, size);
+            // Takes ownership of data
+            FileStorage::WriteAsync(Paths::INPUT_RECORDING_FILE, data, size);
+        }
+    }
+    Release();
+}
+
+#else
+
+void BeginSession() {}
+void EndSession() {}
+
+#endif
+
+}
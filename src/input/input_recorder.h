@@ -0,0 +1,97 @@
+/**
+ * Input Recorder
+ *
+ * Records the buttons the menu sees each frame and plays them back, so a
+ * session can be repeated exactly to compare a change before and after,
+ * on hardware or in the web preview.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Apply() sits between reading VPAD and handling the input. Recording, it
+ * appends the frame's trigger and hold bits; replaying, it replaces them
+ * with the next recorded frame, until the recording runs out and live
+ * input takes over again.
+ *
+ * Frames are stored as runs of identical input, so a frame of the same
+ * buttons as the last costs a count, and idle stretches or a held D-pad
+ * take one run. The file is little-endian whatever the host, so a
+ * recording from the console replays in the preview:
+ *
+ *   Header  magic "TSIR", version, run count, frame count
+ *   Run     trigger, hold, frames          (uint32 each, run count times)
+ *
+ * Frames are counted, not timed: the list view's held-button repeat runs
+ * on the clock, so a replay matches when it runs at the recorded frame
+ * rate, as the menu loop does.
+ *
+ * Builds with ENABLE_INPUT_RECORDING (make RECORD=1) record every menu
+ * session to Paths::INPUT_RECORDING_FILE, or replay
+ * Paths::INPUT_REPLAY_FILE instead when there is one. Otherwise
+ * BeginSession() and EndSession() do nothing and Apply() is a branch.
+ *
+ * USAGE:
+ * ------
+ *   InputRecorder::BeginSession();                  // On menu open
+ *
+ *   bool hasRead = readInput(&pressed, &held);
+ *   hasRead = InputRecorder::Apply(hasRead, &pressed, &held);
+ *
+ *   InputRecorder::EndSession();                    // On menu close
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace InputRecorder {
+
+// Runs one recording holds; about a quarter of an hour of steady tapping
+constexpr uint32_t MAX_RUNS = 8192;
+
+// Bytes of the file header and of each run
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t RUN_SIZE = 12;
+
+enum class Mode {
+    IDLE,
+    RECORDING,
+    REPLAYING
+};
+
+// Start a new recording, dropping any previous one. False if out of memory
+bool StartRecording();
+
+// Start replaying an encoded recording (copied, so data can go at once).
+// False if it isn't one
+bool StartReplay(const uint8_t* data, size_t size);
+
+// Stop recording or replaying. A recording stays until the next start or
+// Release(), for Encode()
+void Stop();
+
+// Free the recording
+void Release();
+
+Mode GetMode();
+
+// The input to handle this frame. Recording appends it as given; replaying
+// replaces it with the next recorded frame and returns true. hasRead is
+// whether anything was read, and is passed through otherwise
+bool Apply(bool hasRead, uint32_t* pressed, uint32_t* held);
+
+// Frames recorded, or left to replay
+uint32_t GetFrameCount();
+
+// Bytes Encode() writes
+size_t GetEncodedSize();
+
+// Write the recording in the file format. Returns the bytes written, or 0
+// if capacity is too small
+size_t Encode(uint8_t* out, size_t capacity);
+
+// Record or replay one menu session (ENABLE_INPUT_RECORDING builds only)
+void BeginSession();
+void EndSession();
+
+}
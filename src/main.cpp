@@ -6,14 +6,25 @@
 #include <wups.h>
 #include <wups/config_api.h>
 #include <vpad/input.h>
+#include <coreinit/time.h>
 #include <notifications/notifications.h>
 
+#include <cstdio>
+
 #include "menu/menu.h"
+#include "menu/warmup.h"
 #include "input/buttons.h"
 #include "titles/titles.h"
 #include "storage/settings.h"
+#include "storage/settings_writer.h"
+#include "storage/file_storage.h"
 #include "presets/title_presets.h"
 #include "render/image_loader.h"
+#include "render/renderer.h"
+#include "storage/image_store.h"
+#include "utils/hook_stats.h"
+#include "utils/memory_budget.h"
+#include "utils/startup_profile.h"
 
 WUPS_PLUGIN_NAME("Title Switcher");
 WUPS_PLUGIN_DESCRIPTION("Game launcher menu via L+R+Minus");
@@ -29,33 +40,112 @@ static void notify(const char* message)
     NotificationModule_AddInfoNotification(message);
 }
 
+// What each subsystem holds between menu opens, and what it gives back;
+// see MemoryBudget for when these run
+static void registerMemoryPools()
+{
+    using MemoryBudget::Pool;
+    using MemoryBudget::Pressure;
+
+    MemoryBudget::Register(Pool::STANDBY_FRAMEBUFFERS, Renderer::GetStandbyBytes, [](Pressure pressure) {
+        if (pressure == Pressure::CRITICAL) {
+            Renderer::ReleaseStandby();
+        } else {
+            Renderer::RelieveMemoryPressure();
+        }
+    });
+    MemoryBudget::Register(Pool::ICONS, [] {
+        return ImageStore::GetMemoryCacheBytes() + ImageStore::GetWarmCacheBytes();
+    }, [](Pressure pressure) {
+        if (pressure == Pressure::CRITICAL) {
+            ImageLoader::ClearCache();
+        } else {
+            ImageLoader::Demote();
+        }
+    });
+    // Rebuilt by the next open, which then pays for rasterizing
+    MemoryBudget::Register(Pool::FONT, Renderer::GetResourceBytes, [](Pressure pressure) {
+        if (pressure == Pressure::CRITICAL) {
+            Renderer::ReleaseResources();
+        }
+    });
+    // Read from SD again when the menu next has an idle frame
+    MemoryBudget::Register(Pool::PRESETS, TitlePresets::GetMemoryUsage, [](Pressure pressure) {
+        if (pressure == Pressure::CRITICAL) {
+            TitlePresets::Unload();
+        }
+    });
+    // The hooks and the next open need the list
+    MemoryBudget::Register(Pool::TITLES, Titles::GetMemoryUsage);
+}
+
 INITIALIZE_PLUGIN()
 {
+    using StartupProfile::Phase;
+    StartupProfile::Scope initializeScope(Phase::INITIALIZE);
+
     NotificationModule_InitLibrary();
-    Settings::Init();
-    Settings::Load();
-    Menu::Init();
-    ImageLoader::Init();
-    Titles::Load();
-    TitlePresets::Load();
+    {
+        StartupProfile::Scope scope(Phase::FILE_STORAGE);
+        FileStorage::Init();
+    }
+    {
+        StartupProfile::Scope scope(Phase::SETTINGS);
+        Settings::Init();
+        Settings::Load();
+        SettingsWriter::Init();
+    }
+    {
+        StartupProfile::Scope scope(Phase::MENU);
+        Menu::Init();
+    }
+    {
+        StartupProfile::Scope scope(Phase::IMAGE_LOADER);
+        ImageLoader::Init(static_cast<size_t>(Settings::Get().iconCacheKB) * 1024);
+    }
+    registerMemoryPools();
+    // Title enumeration, font and icons wait for the first application's
+    // grace period (see Menu::UpdateClosed)
+    Warmup::Init();
+    TitlePresets::SetRetentionMode(TitlePresets::RetentionMode::INSTALLED_ONLY);
+    TitlePresets::DeferLoad();
+
+#ifdef DEBUG
+    char message[64];
+    snprintf(message, sizeof(message), "Title Switcher ready (%u ms)",
+             static_cast<unsigned>(OSTicksToMilliseconds(OSGetSystemTime() - initializeScope.GetStart())));
+    notify(message);
+#else
     notify("Title Switcher ready");
+#endif
 }
 
 DEINITIALIZE_PLUGIN()
 {
+    Titles::WaitForLoad();
+    SettingsWriter::Shutdown();
     ImageLoader::Shutdown();
     Menu::Shutdown();
+    FileStorage::Shutdown();
     NotificationModule_DeInitLibrary();
 }
 
 ON_APPLICATION_START()
 {
     Menu::OnApplicationStart();
+    Titles::RefreshIfChanged();
 }
 
 ON_APPLICATION_ENDS()
 {
     Menu::OnApplicationEnd();
+
+    // The worker threads belong to the ending application; stop them or
+    // finish their work
+    Titles::CancelLoad();
+    ImageLoader::OnApplicationEnd();
+    Settings::Flush();
+    FileStorage::WaitForAsync();
 }
 
 ON_ACQUIRED_FOREGROUND()
@@ -72,25 +162,49 @@ namespace {
 
 bool comboWasHeldPreviously = false;
 
+void clearInput(VPADStatus* inputBuffer, uint32_t sampleCount)
+{
+    for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++) {
+        inputBuffer[sampleIndex].trigger = 0;
+        inputBuffer[sampleIndex].hold = 0;
+        inputBuffer[sampleIndex].release = 0;
+    }
+}
+
+// Runs inside every game VPADRead, often several times a frame: the
+// common path (menu closed, no new combo) is a few flag checks, with no
+// notification, allocation or lock
 void handleInput(VPADStatus* inputBuffer, uint32_t sampleCount)
 {
+    OSTime start = OSGetSystemTime();
     uint32_t heldButtons = inputBuffer[0].hold;
     bool comboIsHeld = Buttons::IsComboPressed(heldButtons, Buttons::Actions::MENU_OPEN_COMBO);
+    bool isNewCombo = comboIsHeld && !comboWasHeldPreviously;
+    comboWasHeldPreviously = comboIsHeld;
+
+    // The game keeps running under the overlay, but its buttons drive the menu
+    if (Menu::IsOverlayOpen()) {
+        Menu::QueueOverlayInput(inputBuffer[0].trigger, heldButtons);
+        clearInput(inputBuffer, sampleCount);
+        HookStats::Record(OSGetSystemTime() - start);
+        return;
+    }
 
-    if (comboIsHeld && !comboWasHeldPreviously) {
-        notify("Combo detected");
+    Menu::UpdateClosed();
+
+    if (isNewCombo) {
         if (Menu::IsSafeToOpen()) {
+            // Returns once a full-screen menu closes, so it isn't timed
             Menu::Open();
-
-            for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++) {
-                inputBuffer[sampleIndex].trigger = 0;
-                inputBuffer[sampleIndex].hold = 0;
-                inputBuffer[sampleIndex].release = 0;
-            }
+            clearInput(inputBuffer, sampleCount);
+            return;
         }
+#ifdef DEBUG
+        notify("Combo ignored: menu not ready");
+#endif
     }
 
-    comboWasHeldPreviously = comboIsHeld;
+    HookStats::Record(OSGetSystemTime() - start);
 }
 
 }
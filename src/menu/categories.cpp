@@ -5,9 +5,16 @@
  */
 
 #include "categories.h"
+#include "search_index.h"
+#include "facets.h"
 #include "../titles/titles.h"
 #include "../storage/settings.h"
 
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
 namespace Categories {
 
 // =============================================================================
@@ -19,60 +26,197 @@ namespace {
 // Current category selection
 int sCurrentCategory = CATEGORY_ALL;
 
-// Filtered title indices
+// Filtered title indices, memoized per category
 // These are indices into the main Titles list, not the filtered list
 // This allows us to maintain the connection to the original title data
-int sFilteredIndices[Titles::MAX_TITLES];
-int sFilteredCount = 0;
+// A view is reused while both generations it was built from still match
+struct FilterView {
+    std::vector<uint16_t> indices;
+    uint32_t membershipGeneration = 0;
+    uint32_t listGeneration = 0;
+    bool isValid = false;
+};
+
+std::vector<FilterView> sFilterViews;
+
+// The active category's indices, narrowed by sFacetView and sSearchView
+// when those are in use
+const std::vector<uint16_t>* sActiveIndices = nullptr;
+
+// Facet constraints combined with the current category
+Facets::Filter sFacetFilter;
+std::vector<uint16_t> sFacetView;
+
+// Search state; the index is rebuilt when the title list generation moves
+char sSearchQuery[MAX_SEARCH_LENGTH + 1] = "";
+std::vector<uint16_t> sSearchView;
+uint32_t sSearchIndexGeneration = 0;
+bool isSearchIndexBuilt = false;
 
 // Built-in category names
 constexpr const char* NAME_ALL = "All";
 constexpr const char* NAME_FAVORITES = "Favorites";
+constexpr const char* NAME_RECENT = "Recent";
 
 /**
- * Apply the current category filter to rebuild the filtered list.
+ * Get the membership bit a category requires (0 for All and Recent,
+ * which isn't a mask bit).
+ *
+ * @return false if the category index doesn't exist
  */
-void applyFilter()
+bool getRequiredMask(int category, uint32_t& requiredMask)
+{
+    // Membership is a per-title bitmask, so each category is one AND
+    // per title; a zero mask (All) includes everything
+    requiredMask = 0;
+
+    switch (category) {
+        case CATEGORY_ALL:
+        case CATEGORY_RECENT:
+            return true;
+
+        case CATEGORY_FAVORITES:
+            requiredMask = Settings::FAVORITE_MASK_BIT;
+            return true;
+
+        default:
+            {
+                int userCatIndex = category - FIRST_USER_CATEGORY;
+                if (userCatIndex >= 0 && userCatIndex < Settings::GetCategoryCount() &&
+                    userCatIndex < Settings::MAX_CATEGORIES) {
+                    requiredMask = 1u << userCatIndex;
+                    return true;
+                }
+            }
+            return false;
+    }
+}
+
+/**
+ * The installed titles in the launch history, ascending like every view.
+ */
+void buildRecentView(FilterView& view)
+{
+    for (uint64_t titleId : Settings::Get().recentLaunches) {
+        int titleIndex = Titles::FindIndexById(titleId);
+        if (titleIndex >= 0) {
+            view.indices.push_back(static_cast<uint16_t>(titleIndex));
+        }
+    }
+    std::sort(view.indices.begin(), view.indices.end());
+}
+
+/**
+ * Rebuild one category's view from the title masks.
+ */
+void buildFilterView(FilterView& view)
 {
-    sFilteredCount = 0;
+    view.indices.clear();
+    view.isValid = true;
     int totalTitles = Titles::GetCount();
 
+    if (sCurrentCategory == CATEGORY_RECENT) {
+        buildRecentView(view);
+        return;
+    }
+
+    uint32_t requiredMask = 0;
+    if (!getRequiredMask(sCurrentCategory, requiredMask)) {
+        return;
+    }
+
+    view.indices.reserve(totalTitles);
     for (int i = 0; i < totalTitles; i++) {
-        const Titles::TitleInfo* title = Titles::GetTitle(i);
-        if (!title) continue;
-
-        bool include = false;
-
-        switch (sCurrentCategory) {
-            case CATEGORY_ALL:
-                // All category includes everything
-                include = true;
-                break;
-
-            case CATEGORY_FAVORITES:
-                // Favorites category: only include favorited titles
-                include = Settings::IsFavorite(title->titleId);
-                break;
-
-            default:
-                // User-defined category: check if title is assigned
-                {
-                    // Get the category ID for this index
-                    int userCatIndex = sCurrentCategory - FIRST_USER_CATEGORY;
-                    if (userCatIndex >= 0 && userCatIndex < Settings::GetCategoryCount()) {
-                        const auto& categories = Settings::Get().categories;
-                        if (userCatIndex < static_cast<int>(categories.size())) {
-                            uint16_t catId = categories[userCatIndex].id;
-                            include = Settings::TitleHasCategory(title->titleId, catId);
-                        }
-                    }
-                }
-                break;
+        if (requiredMask == 0 || (Titles::GetCategoryMask(i) & requiredMask)) {
+            view.indices.push_back(static_cast<uint16_t>(i));
         }
+    }
+}
 
-        if (include) {
-            sFilteredIndices[sFilteredCount++] = i;
+/**
+ * Narrow the current category by the facet filter (see facets.h).
+ */
+void applyFacets(const FilterView& view)
+{
+    Facets::Filter filter = sFacetFilter;
+    uint32_t requiredMask = 0;
+    getRequiredMask(sCurrentCategory, requiredMask);
+    filter.categoryMask |= requiredMask;
+
+    Facets::Evaluate(filter, sFacetView);
+
+    // Recent has no mask bit for the facets to check
+    if (sCurrentCategory == CATEGORY_RECENT) {
+        sFacetView.erase(std::remove_if(sFacetView.begin(), sFacetView.end(), [&view](uint16_t titleIndex) {
+            return !std::binary_search(view.indices.begin(), view.indices.end(), titleIndex);
+        }), sFacetView.end());
+    }
+    sActiveIndices = &sFacetView;
+}
+
+/**
+ * Narrow the active indices to the titles matching the search query.
+ */
+void applySearch()
+{
+    uint32_t listGeneration = Titles::GetListGeneration();
+    if (!isSearchIndexBuilt || sSearchIndexGeneration != listGeneration) {
+        int totalTitles = Titles::GetCount();
+        std::vector<const char*> names(totalTitles);
+        for (int i = 0; i < totalTitles; i++) {
+            const Titles::TitleInfo* title = Titles::GetTitle(i);
+            names[i] = title ? title->name : nullptr;
         }
+        SearchIndex::Build(names.data(), totalTitles);
+        sSearchIndexGeneration = Titles::GetListGeneration();
+        isSearchIndexBuilt = true;
+    }
+
+    // Both lists are ascending title indices
+    const std::vector<uint16_t>& matches = SearchIndex::Query(sSearchQuery);
+    sSearchView.clear();
+    std::set_intersection(sActiveIndices->begin(), sActiveIndices->end(),
+                          matches.begin(), matches.end(),
+                          std::back_inserter(sSearchView));
+    sActiveIndices = &sSearchView;
+}
+
+/**
+ * Point the active view at the current category, rebuilding it only if
+ * membership or the title list changed since it was built.
+ */
+void applyFilter()
+{
+    int totalCategories = GetTotalCategoryCount();
+    if (static_cast<int>(sFilterViews.size()) != totalCategories) {
+        sFilterViews.resize(totalCategories);
+    }
+
+    if (sCurrentCategory < 0 || sCurrentCategory >= totalCategories) {
+        sActiveIndices = nullptr;
+        return;
+    }
+
+    FilterView& view = sFilterViews[sCurrentCategory];
+    uint32_t membershipGeneration = Settings::GetMembershipGeneration();
+    uint32_t listGeneration = Titles::GetListGeneration();
+    if (!view.isValid || view.membershipGeneration != membershipGeneration ||
+        view.listGeneration != listGeneration) {
+        buildFilterView(view);
+
+        // Read again: building may lazily rebuild sort orders or masks
+        view.membershipGeneration = Settings::GetMembershipGeneration();
+        view.listGeneration = Titles::GetListGeneration();
+    }
+    sActiveIndices = &view.indices;
+
+    bool hasFacetFilter = Facets::HasFacets(sFacetFilter) || sFacetFilter.categoryMask != 0;
+    if (hasFacetFilter && !view.indices.empty()) {
+        applyFacets(view);
+    }
+
+    if (sSearchQuery[0] != '\0') {
+        applySearch();
     }
 }
 
@@ -102,20 +246,30 @@ void Init()
 
 int GetTotalCategoryCount()
 {
-    // Built-in (All, Favorites) + user-defined
+    // Built-in (All, Favorites, Recent) + user-defined
     return FIRST_USER_CATEGORY + Settings::GetCategoryCount();
 }
 
 int GetVisibleCategoryCount()
 {
-    int count = FIRST_USER_CATEGORY;  // Built-in categories are always visible
-    const auto& categories = Settings::Get().categories;
-    for (const auto& cat : categories) {
-        if (!cat.hidden) {
-            count++;
-        }
+    int visibleUserCount = 0;
+    Settings::GetCategoryOrder(false, &visibleUserCount);
+    return FIRST_USER_CATEGORY + visibleUserCount;  // Built-in categories are always visible
+}
+
+int GetVisibleCategory(int position)
+{
+    if (position < 0) {
+        return -1;
+    }
+    if (position < FIRST_USER_CATEGORY) {
+        return position;
     }
-    return count;
+
+    int visibleUserCount = 0;
+    const int* order = Settings::GetCategoryOrder(false, &visibleUserCount);
+    int userPosition = position - FIRST_USER_CATEGORY;
+    return userPosition < visibleUserCount ? FIRST_USER_CATEGORY + order[userPosition] : -1;
 }
 
 bool IsCategoryVisible(int index)
@@ -152,6 +306,9 @@ const char* GetCategoryName(int index)
     if (index == CATEGORY_FAVORITES) {
         return NAME_FAVORITES;
     }
+    if (index == CATEGORY_RECENT) {
+        return NAME_RECENT;
+    }
 
     // User-defined categories
     int userIndex = index - FIRST_USER_CATEGORY;
@@ -208,23 +365,82 @@ bool SelectCategory(int index)
 
 int GetFilteredCount()
 {
-    return sFilteredCount;
+    return sActiveIndices ? static_cast<int>(sActiveIndices->size()) : 0;
 }
 
 const Titles::TitleInfo* GetFilteredTitle(int index)
 {
-    if (index < 0 || index >= sFilteredCount) {
+    if (index < 0 || index >= GetFilteredCount()) {
         return nullptr;
     }
 
     // Get the original index and return that title
-    int originalIndex = sFilteredIndices[index];
+    int originalIndex = (*sActiveIndices)[index];
     return Titles::GetTitle(originalIndex);
 }
 
+bool GetFilteredRecord(int index, Titles::TitleRecord* outRecord)
+{
+    if (index < 0 || index >= GetFilteredCount()) {
+        return false;
+    }
+    return Titles::GetRecord((*sActiveIndices)[index], outRecord);
+}
+
+int GetFilteredTitleIndex(int index)
+{
+    if (index < 0 || index >= GetFilteredCount()) {
+        return -1;
+    }
+    return (*sActiveIndices)[index];
+}
+
 void RefreshFilter()
 {
     applyFilter();
 }
 
+void SetSearchQuery(const char* query)
+{
+    strncpy(sSearchQuery, query ? query : "", MAX_SEARCH_LENGTH);
+    sSearchQuery[MAX_SEARCH_LENGTH] = '\0';
+    applyFilter();
+}
+
+void ClearSearch()
+{
+    SetSearchQuery("");
+}
+
+const char* GetSearchQuery()
+{
+    return sSearchQuery;
+}
+
+bool IsSearchActive()
+{
+    return sSearchQuery[0] != '\0';
+}
+
+void SetFacetFilter(const Facets::Filter& filter)
+{
+    sFacetFilter = filter;
+    applyFilter();
+}
+
+void ClearFacetFilter()
+{
+    SetFacetFilter(Facets::Filter());
+}
+
+const Facets::Filter& GetFacetFilter()
+{
+    return sFacetFilter;
+}
+
+bool IsFacetFilterActive()
+{
+    return Facets::HasFacets(sFacetFilter) || sFacetFilter.categoryMask != 0;
+}
+
 } // namespace Categories
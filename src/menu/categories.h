@@ -10,6 +10,8 @@
  *
  * - "All" (index 0): Shows all titles, no filtering
  * - "Favorites" (index 1): Shows only favorited titles
+ * - "Recent" (index 2): Shows titles in the launch history
+ *   (Settings::RecordLaunch), in the list's sort order like the others
  *
  * USER CATEGORIES:
  * ----------------
@@ -34,11 +36,33 @@
  *
  *   // After changing favorites or assignments, refresh the filter
  *   Categories::RefreshFilter();
+ *
+ * SEARCH:
+ * -------
+ * A search query narrows the current category further to titles whose
+ * name contains the query (see search_index.h). The index is built from
+ * the title list on first use and rebuilt only when the list changes:
+ *
+ *   Categories::SetSearchQuery("zel");
+ *   Categories::SetSearchQuery("zelda");  // Only re-checks "zel" matches
+ *   Categories::ClearSearch();
+ *
+ * FACETS:
+ * -------
+ * A facet filter (see facets.h) adds preset constraints and extra category
+ * bits on top of the current category, e.g. Favorites + genre "RPG" +
+ * released 2015 or later. It applies before the search query:
+ *
+ *   Facets::Filter filter;
+ *   Facets::SetValue(filter, Facets::Field::GENRE, "RPG");
+ *   filter.minYear = 2015;
+ *   Categories::SetFacetFilter(filter);
  */
 
 #pragma once
 
 #include "../titles/titles.h"
+#include "facets.h"
 
 namespace Categories {
 
@@ -49,7 +73,11 @@ namespace Categories {
 // Built-in category indices (these are always present)
 constexpr int CATEGORY_ALL = 0;
 constexpr int CATEGORY_FAVORITES = 1;
-constexpr int FIRST_USER_CATEGORY = 2;  // User categories start here
+constexpr int CATEGORY_RECENT = 2;
+constexpr int FIRST_USER_CATEGORY = 3;  // User categories start here
+
+// Longest search query kept (matches the text input field)
+constexpr int MAX_SEARCH_LENGTH = 32;
 
 // =============================================================================
 // Initialization
@@ -81,6 +109,16 @@ int GetTotalCategoryCount();
  */
 int GetVisibleCategoryCount();
 
+/**
+ * Get the category index shown at a position in the category bar.
+ * Built-in categories come first, then visible user categories in display
+ * order, so the bar is a walk from 0 to GetVisibleCategoryCount().
+ *
+ * @param position Position among visible categories
+ * @return Category index, or -1 if position is out of range
+ */
+int GetVisibleCategory(int position);
+
 /**
  * Check if a category is visible (not hidden).
  *
@@ -147,12 +185,90 @@ int GetFilteredCount();
  */
 const Titles::TitleInfo* GetFilteredTitle(int index);
 
+/**
+ * Get a filtered title's record (see Titles::GetRecord()).
+ *
+ * @param index Index in the filtered list (0 to GetFilteredCount()-1)
+ * @return false if index is out of range
+ */
+bool GetFilteredRecord(int index, Titles::TitleRecord* outRecord);
+
+/**
+ * Get the Titles index behind a filtered title.
+ *
+ * @param index Index in the filtered list (0 to GetFilteredCount()-1)
+ * @return Index for Titles::GetTitle() and friends, or -1 if out of range
+ */
+int GetFilteredTitleIndex(int index);
+
 /**
  * Refresh the filtered title list.
  *
  * Call this after modifying favorites or category assignments
  * while staying in the same category. The filter will be reapplied.
+ *
+ * Filtered views are memoized per category and keyed by the settings
+ * membership and title list generations, so this (and switching
+ * categories) is just a lookup unless something actually changed.
  */
 void RefreshFilter();
 
+// =============================================================================
+// Search
+// =============================================================================
+
+/**
+ * Filter the current category by a name search.
+ *
+ * Matching is case-insensitive and ignores punctuation. The search stays
+ * applied across category changes until cleared.
+ *
+ * @param query Search text (truncated to MAX_SEARCH_LENGTH); "" clears
+ */
+void SetSearchQuery(const char* query);
+
+/**
+ * Remove the search filter.
+ */
+void ClearSearch();
+
+/**
+ * Get the active search query ("" when no search is applied).
+ */
+const char* GetSearchQuery();
+
+/**
+ * Check if a search query is currently narrowing the list.
+ */
+bool IsSearchActive();
+
+// =============================================================================
+// Facet Filter
+// =============================================================================
+
+/**
+ * Combine a facet filter with the current category and re-filter.
+ *
+ * The filter's categoryMask is added to the current category's own bit,
+ * so membership in several categories can be required at once.
+ *
+ * @param filter Constraints to apply (copied)
+ */
+void SetFacetFilter(const Facets::Filter& filter);
+
+/**
+ * Remove the facet filter.
+ */
+void ClearFacetFilter();
+
+/**
+ * Get the active facet filter (empty when none is applied).
+ */
+const Facets::Filter& GetFacetFilter();
+
+/**
+ * Check if a facet filter is currently narrowing the list.
+ */
+bool IsFacetFilterActive();
+
 } // namespace Categories
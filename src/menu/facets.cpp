@@ -0,0 +1,327 @@
+/**
+ * Title Facet Engine Implementation
+ *
+ * See facets.h for usage documentation.
+ */
+
+#include "facets.h"
+#include "../titles/titles.h"
+#include "../storage/settings.h"
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+namespace Facets {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+constexpr int CATEGORY_BIT_COUNT = 32;
+
+struct ValuePosting {
+    // Points into the preset data, which outlives the lists
+    const char* value;
+    std::vector<uint16_t> indices;
+};
+
+struct YearPosting {
+    uint16_t year;
+    std::vector<uint16_t> indices;
+};
+
+// Preset per title index (nullptr if the title has none)
+std::vector<const TitlePresets::TitlePreset*> sTitlePresets;
+
+// Posting lists, each in ascending title index order
+std::vector<uint16_t> sCategoryPostings[CATEGORY_BIT_COUNT];
+std::vector<ValuePosting> sValuePostings[FIELD_COUNT];
+std::vector<YearPosting> sYearPostings;
+
+// Generations the lists were built from
+uint32_t sListGeneration = 0;
+uint32_t sMembershipGeneration = 0;
+uint32_t sPresetGeneration = 0;
+bool isBuilt = false;
+
+// Reused by Evaluate() for year unions and intersections
+std::vector<uint16_t> sYearUnion;
+std::vector<uint16_t> sScratch;
+
+int compareIgnoreCase(const char* first, const char* second)
+{
+    while (*first && tolower(static_cast<unsigned char>(*first)) ==
+                     tolower(static_cast<unsigned char>(*second))) {
+        first++;
+        second++;
+    }
+    return tolower(static_cast<unsigned char>(*first)) -
+           tolower(static_cast<unsigned char>(*second));
+}
+
+const char* getPresetValue(const TitlePresets::TitlePreset* preset, Field field)
+{
+    if (!preset) return "";
+
+    switch (field) {
+        case Field::GENRE:     return preset->genre;
+        case Field::PUBLISHER: return preset->publisher;
+        case Field::DEVELOPER: return preset->developer;
+        case Field::REGION:    return preset->region;
+    }
+    return "";
+}
+
+/**
+ * Group (value, title) pairs into one posting list per distinct value.
+ * Pairs arrive in title order and the sort is stable, so every list
+ * stays ascending.
+ */
+void buildValuePostings(Field field)
+{
+    struct Entry {
+        const char* value;
+        uint16_t titleIndex;
+    };
+
+    std::vector<Entry> entries;
+    for (size_t titleIndex = 0; titleIndex < sTitlePresets.size(); titleIndex++) {
+        const char* value = getPresetValue(sTitlePresets[titleIndex], field);
+        if (value[0] != '\0') {
+            entries.push_back({ value, static_cast<uint16_t>(titleIndex) });
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& first, const Entry& second) {
+        return compareIgnoreCase(first.value, second.value) < 0;
+    });
+
+    std::vector<ValuePosting>& postings = sValuePostings[static_cast<int>(field)];
+    postings.clear();
+    for (const Entry& entry : entries) {
+        if (postings.empty() || compareIgnoreCase(postings.back().value, entry.value) != 0) {
+            postings.push_back({ entry.value, {} });
+        }
+        postings.back().indices.push_back(entry.titleIndex);
+    }
+}
+
+void buildYearPostings()
+{
+    sYearPostings.clear();
+    for (size_t titleIndex = 0; titleIndex < sTitlePresets.size(); titleIndex++) {
+        const TitlePresets::TitlePreset* preset = sTitlePresets[titleIndex];
+        if (!preset || preset->releaseYear == 0) {
+            continue;
+        }
+
+        auto position = std::lower_bound(sYearPostings.begin(), sYearPostings.end(), preset->releaseYear,
+                                         [](const YearPosting& posting, uint16_t year) {
+                                             return posting.year < year;
+                                         });
+        if (position == sYearPostings.end() || position->year != preset->releaseYear) {
+            position = sYearPostings.insert(position, { preset->releaseYear, {} });
+        }
+        position->indices.push_back(static_cast<uint16_t>(titleIndex));
+    }
+}
+
+void buildPostings()
+{
+    int totalTitles = Titles::GetCount();
+
+    // Titles keeps the preset join; copy it once here rather than per filter
+    sTitlePresets.assign(totalTitles, nullptr);
+    for (int titleIndex = 0; titleIndex < totalTitles; titleIndex++) {
+        sTitlePresets[titleIndex] = Titles::GetPreset(titleIndex);
+    }
+
+    for (int bit = 0; bit < CATEGORY_BIT_COUNT; bit++) {
+        sCategoryPostings[bit].clear();
+    }
+    for (int titleIndex = 0; titleIndex < totalTitles; titleIndex++) {
+        uint32_t mask = Titles::GetCategoryMask(titleIndex);
+        for (int bit = 0; mask != 0; bit++, mask >>= 1) {
+            if (mask & 1u) {
+                sCategoryPostings[bit].push_back(static_cast<uint16_t>(titleIndex));
+            }
+        }
+    }
+
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        buildValuePostings(static_cast<Field>(field));
+    }
+    buildYearPostings();
+}
+
+void ensureBuilt()
+{
+    uint32_t listGeneration = Titles::GetListGeneration();
+    uint32_t membershipGeneration = Settings::GetMembershipGeneration();
+    uint32_t presetGeneration = TitlePresets::GetGeneration();
+    if (isBuilt && sListGeneration == listGeneration &&
+        sMembershipGeneration == membershipGeneration &&
+        sPresetGeneration == presetGeneration) {
+        return;
+    }
+
+    buildPostings();
+    sListGeneration = listGeneration;
+    sMembershipGeneration = membershipGeneration;
+    sPresetGeneration = presetGeneration;
+    isBuilt = true;
+}
+
+const std::vector<uint16_t>* findValuePosting(Field field, const char* value)
+{
+    const std::vector<ValuePosting>& postings = sValuePostings[static_cast<int>(field)];
+    auto position = std::lower_bound(postings.begin(), postings.end(), value,
+                                     [](const ValuePosting& posting, const char* searchValue) {
+                                         return compareIgnoreCase(posting.value, searchValue) < 0;
+                                     });
+    if (position == postings.end() || compareIgnoreCase(position->value, value) != 0) {
+        return nullptr;
+    }
+    return &position->indices;
+}
+
+void collectYearRange(uint16_t minYear, uint16_t maxYear)
+{
+    sYearUnion.clear();
+    for (const YearPosting& posting : sYearPostings) {
+        if (posting.year < minYear) continue;
+        if (maxYear != 0 && posting.year > maxYear) break;
+        sYearUnion.insert(sYearUnion.end(), posting.indices.begin(), posting.indices.end());
+    }
+    std::sort(sYearUnion.begin(), sYearUnion.end());
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Public Implementation
+// =============================================================================
+
+void SetValue(Filter& filter, Field field, const char* value)
+{
+    char* target = filter.values[static_cast<int>(field)];
+    strncpy(target, value ? value : "", MAX_VALUE_LENGTH - 1);
+    target[MAX_VALUE_LENGTH - 1] = '\0';
+}
+
+bool HasFacets(const Filter& filter)
+{
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (filter.values[field][0] != '\0') {
+            return true;
+        }
+    }
+    return filter.minYear != 0 || filter.maxYear != 0;
+}
+
+int Evaluate(const Filter& filter, std::vector<uint16_t>& outIndices)
+{
+    ensureBuilt();
+    outIndices.clear();
+
+    const std::vector<uint16_t>* lists[CATEGORY_BIT_COUNT + FIELD_COUNT + 1];
+    int listCount = 0;
+
+    for (int bit = 0; bit < CATEGORY_BIT_COUNT; bit++) {
+        if (filter.categoryMask & (1u << bit)) {
+            lists[listCount++] = &sCategoryPostings[bit];
+        }
+    }
+
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        if (filter.values[field][0] == '\0') {
+            continue;
+        }
+        const std::vector<uint16_t>* posting = findValuePosting(static_cast<Field>(field),
+                                                                filter.values[field]);
+        if (!posting) {
+            return 0;
+        }
+        lists[listCount++] = posting;
+    }
+
+    if (filter.minYear != 0 || filter.maxYear != 0) {
+        collectYearRange(filter.minYear, filter.maxYear);
+        lists[listCount++] = &sYearUnion;
+    }
+
+    if (listCount == 0) {
+        int totalTitles = static_cast<int>(sTitlePresets.size());
+        outIndices.resize(totalTitles);
+        for (int titleIndex = 0; titleIndex < totalTitles; titleIndex++) {
+            outIndices[titleIndex] = static_cast<uint16_t>(titleIndex);
+        }
+        return totalTitles;
+    }
+
+    // Smallest list first keeps every intermediate result small
+    std::sort(lists, lists + listCount, [](const std::vector<uint16_t>* first,
+                                           const std::vector<uint16_t>* second) {
+        return first->size() < second->size();
+    });
+
+    outIndices = *lists[0];
+    for (int listIndex = 1; listIndex < listCount && !outIndices.empty(); listIndex++) {
+        sScratch.clear();
+        std::set_intersection(outIndices.begin(), outIndices.end(),
+                              lists[listIndex]->begin(), lists[listIndex]->end(),
+                              std::back_inserter(sScratch));
+        outIndices.swap(sScratch);
+    }
+
+    return static_cast<int>(outIndices.size());
+}
+
+const char* GetTitleValue(int titleIndex, Field field)
+{
+    ensureBuilt();
+    if (titleIndex < 0 || titleIndex >= static_cast<int>(sTitlePresets.size())) {
+        return "";
+    }
+    return getPresetValue(sTitlePresets[titleIndex], field);
+}
+
+uint16_t GetTitleYear(int titleIndex)
+{
+    ensureBuilt();
+    if (titleIndex < 0 || titleIndex >= static_cast<int>(sTitlePresets.size())) {
+        return 0;
+    }
+    const TitlePresets::TitlePreset* preset = sTitlePresets[titleIndex];
+    return preset ? preset->releaseYear : 0;
+}
+
+const char* GetFieldName(Field field)
+{
+    switch (field) {
+        case Field::GENRE:     return "Genre";
+        case Field::PUBLISHER: return "Pub";
+        case Field::DEVELOPER: return "Dev";
+        case Field::REGION:    return "Region";
+    }
+    return "";
+}
+
+void Invalidate()
+{
+    isBuilt = false;
+    sTitlePresets.clear();
+    for (int bit = 0; bit < CATEGORY_BIT_COUNT; bit++) {
+        sCategoryPostings[bit].clear();
+    }
+    for (int field = 0; field < FIELD_COUNT; field++) {
+        sValuePostings[field].clear();
+    }
+    sYearPostings.clear();
+}
+
+} // namespace Facets
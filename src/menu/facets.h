@@ -0,0 +1,140 @@
+/**
+ * Title Facet Engine
+ *
+ * Compound filters over the title list, combining category membership with
+ * TitlePresets metadata (genre, publisher, developer, region, release year).
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The engine keeps one sorted list of title indices (a posting list) per
+ * category bit and per distinct facet value. Each installed title's preset
+ * is looked up once, at build time, so a filter never touches game IDs or
+ * preset strings.
+ *
+ * A filter picks one posting list per constraint and merge-intersects them,
+ * smallest first, so the cost follows the most selective constraint rather
+ * than the size of the library. A year range is the union of the per-year
+ * lists it covers.
+ *
+ * The lists are rebuilt lazily when the title list, category membership or
+ * presets change (see Titles::GetListGeneration,
+ * Settings::GetMembershipGeneration, TitlePresets::GetGeneration).
+ *
+ * USAGE:
+ * ------
+ *   // Favorites that are RPGs released in 2015 or later
+ *   Facets::Filter filter;
+ *   filter.categoryMask = Settings::FAVORITE_MASK_BIT;
+ *   Facets::SetValue(filter, Facets::Field::GENRE, "RPG");
+ *   filter.minYear = 2015;
+ *
+ *   std::vector<uint16_t> indices;
+ *   Facets::Evaluate(filter, indices);  // Ascending Titles indices
+ */
+
+#pragma once
+
+#include "../presets/title_presets.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Facets {
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+/**
+ * String facets taken from a title's preset.
+ */
+enum class Field {
+    GENRE,
+    PUBLISHER,
+    DEVELOPER,
+    REGION
+};
+
+constexpr int FIELD_COUNT = 4;
+
+// Longest facet value kept in a filter (the longest preset string field)
+constexpr int MAX_VALUE_LENGTH = TitlePresets::MAX_PUBLISHER_NAME;
+
+// =============================================================================
+// Data Structures
+// =============================================================================
+
+/**
+ * A compound filter; every set constraint must match.
+ */
+struct Filter {
+    // Category bits from Titles::GetCategoryMask(); all must be set
+    uint32_t categoryMask;
+
+    // Required value per Field (case-insensitive), "" for any
+    char values[FIELD_COUNT][MAX_VALUE_LENGTH];
+
+    // Inclusive release year range, 0 for unbounded
+    uint16_t minYear;
+    uint16_t maxYear;
+
+    Filter() : categoryMask(0), minYear(0), maxYear(0) {
+        for (int field = 0; field < FIELD_COUNT; field++) {
+            values[field][0] = '\0';
+        }
+    }
+};
+
+// =============================================================================
+// Functions
+// =============================================================================
+
+/**
+ * Set (or clear, with nullptr or "") one string constraint of a filter.
+ */
+void SetValue(Filter& filter, Field field, const char* value);
+
+/**
+ * Check if a filter constrains anything beyond its category mask.
+ */
+bool HasFacets(const Filter& filter);
+
+/**
+ * Evaluate a filter against the current title list.
+ *
+ * Rebuilds the posting lists first if the title list, category
+ * membership or presets changed since they were built.
+ *
+ * @param filter     Constraints to apply
+ * @param outIndices Receives matching Titles indices in ascending order
+ * @return Number of matching titles
+ */
+int Evaluate(const Filter& filter, std::vector<uint16_t>& outIndices);
+
+/**
+ * Get a facet's value for one title.
+ *
+ * @param titleIndex Index into Titles
+ * @param field      Facet to read
+ * @return The preset's value, or "" if the title has no preset or value
+ */
+const char* GetTitleValue(int titleIndex, Field field);
+
+/**
+ * Get a title's release year from its preset (0 if unknown).
+ */
+uint16_t GetTitleYear(int titleIndex);
+
+/**
+ * Get a short display name for a field (e.g. "Genre").
+ */
+const char* GetFieldName(Field field);
+
+/**
+ * Drop all posting lists; the next Evaluate() rebuilds them.
+ *
+ * Frees their memory early; a TitlePresets::Load() is noticed without it.
+ */
+void Invalidate();
+
+} // namespace Facets
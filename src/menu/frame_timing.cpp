@@ -0,0 +1,121 @@
+/**
+ * Menu Frame Timing Implementation
+ *
+ * See frame_timing.h for usage documentation.
+ */
+
+#include "frame_timing.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace FrameTiming {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "Begin",
+    "Render",
+    "Images",
+    "End",
+    "VPAD",
+    "Frame"
+};
+
+// sHistory[phase][frame], so one phase's samples can be sorted in one copy
+uint32_t sHistory[PHASE_COUNT][HISTORY_FRAMES];
+int sNextFrame = 0;
+int sFrameCount = 0;
+
+uint32_t sPending[PHASE_COUNT];
+OSTime sPendingStart = 0;
+
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+const char* GetPhaseName(Phase phase)
+{
+    int phaseIndex = static_cast<int>(phase);
+    return phaseIndex >= 0 && phaseIndex < PHASE_COUNT ? PHASE_NAMES[phaseIndex] : "?";
+}
+
+void BeginFrame()
+{
+    memset(sPending, 0, sizeof(sPending));
+    sPendingStart = OSGetSystemTime();
+}
+
+void Record(Phase phase, uint32_t micros)
+{
+    int phaseIndex = static_cast<int>(phase);
+    if (phaseIndex >= 0 && phaseIndex < PHASE_COUNT) {
+        sPending[phaseIndex] += micros;
+    }
+}
+
+void CommitFrame()
+{
+    OSTime now = OSGetSystemTime();
+    sPending[static_cast<int>(Phase::FRAME)] = static_cast<uint32_t>(OSTicksToMicroseconds(now - sPendingStart));
+#ifdef ENABLE_TRACING
+    Trace::Complete(GetPhaseName(Phase::FRAME), sPendingStart, now);
+#endif
+
+    for (int phaseIndex = 0; phaseIndex < PHASE_COUNT; phaseIndex++) {
+        sHistory[phaseIndex][sNextFrame] = sPending[phaseIndex];
+    }
+    sNextFrame = (sNextFrame + 1) % HISTORY_FRAMES;
+    sFrameCount = std::min(sFrameCount + 1, HISTORY_FRAMES);
+}
+
+void Reset()
+{
+    sNextFrame = 0;
+    sFrameCount = 0;
+}
+
+// =============================================================================
+// Statistics
+// =============================================================================
+
+int GetFrameCount()
+{
+    return sFrameCount;
+}
+
+bool GetStats(Phase phase, Stats* outStats)
+{
+    *outStats = {};
+    int phaseIndex = static_cast<int>(phase);
+    if (sFrameCount == 0 || phaseIndex < 0 || phaseIndex >= PHASE_COUNT) {
+        return false;
+    }
+
+    // Order doesn't matter for any of these, so the ring is read as is
+    uint32_t sorted[HISTORY_FRAMES];
+    memcpy(sorted, sHistory[phaseIndex], sFrameCount * sizeof(uint32_t));
+    std::sort(sorted, sorted + sFrameCount);
+
+    uint64_t total = 0;
+    for (int frameIndex = 0; frameIndex < sFrameCount; frameIndex++) {
+        total += sorted[frameIndex];
+    }
+
+    // Nearest rank: the sample 99% of frames are at or under
+    int p99Index = (sFrameCount * 99 + 99) / 100 - 1;
+
+    outStats->minUs = sorted[0];
+    outStats->avgUs = static_cast<uint32_t>(total / sFrameCount);
+    outStats->maxUs = sorted[sFrameCount - 1];
+    outStats->p99Us = sorted[p99Index];
+    return true;
+}
+
+}
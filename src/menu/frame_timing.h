@@ -0,0 +1,107 @@
+/**
+ * Menu Frame Timing
+ *
+ * Where a menu frame's time goes, phase by phase, over the last
+ * HISTORY_FRAMES drawn frames. Shown on the debug panel so a slow hot path
+ * can be seen on hardware.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * A frame starts with BeginFrame(). Each phase is timed by a Scope, which
+ * adds its elapsed microseconds to that phase in the pending frame.
+ * CommitFrame() copies the pending frame into a ring buffer; frames that
+ * are never committed (idle frames, which skip drawing) are dropped, so
+ * they don't pull the averages down.
+ *
+ * Recording is a couple of OSGetSystemTime() calls and adds per phase;
+ * the statistics are only worked out when GetStats() is called. Tracing
+ * builds also put each phase and committed frame on the trace timeline.
+ *
+ * USAGE:
+ * ------
+ *   FrameTiming::BeginFrame();
+ *   {
+ *       FrameTiming::Scope scope(FrameTiming::Phase::RENDER);
+ *       renderCurrentMode();
+ *   }
+ *   FrameTiming::CommitFrame();
+ *
+ *   FrameTiming::Stats stats;
+ *   FrameTiming::GetStats(FrameTiming::Phase::RENDER, &stats);
+ */
+
+#pragma once
+
+#include "../utils/trace.h"
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+namespace FrameTiming {
+
+enum class Phase {
+    BEGIN_FRAME,    // Vsync wait and Renderer::BeginFrame, including the clear
+    RENDER,         // The current panel's Render()
+    IMAGE_LOADER,   // ImageLoader::Update
+    END_FRAME,      // Renderer::EndFrame: flush, flip and vsync wait
+    VPAD_READ,      // VPADRead
+    FRAME,          // The whole frame, start to end
+    COUNT
+};
+
+constexpr int PHASE_COUNT = static_cast<int>(Phase::COUNT);
+
+// Frames kept; p99 is the second slowest once the ring is full
+constexpr int HISTORY_FRAMES = 128;
+
+struct Stats {
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t p99Us;
+};
+
+const char* GetPhaseName(Phase phase);
+
+// Start a new pending frame; anything not committed is discarded
+void BeginFrame();
+
+// Add to a phase of the pending frame
+void Record(Phase phase, uint32_t micros);
+
+// Keep the pending frame (FRAME is the time since BeginFrame)
+void CommitFrame();
+
+// Forget all recorded frames
+void Reset();
+
+// Frames in the ring, up to HISTORY_FRAMES
+int GetFrameCount();
+
+// Returns false (and zeroes outStats) if no frames are recorded
+bool GetStats(Phase phase, Stats* outStats);
+
+/**
+ * Times the enclosing block into one phase of the pending frame.
+ */
+class Scope {
+public:
+    explicit Scope(Phase phase) : mPhase(phase), mStart(OSGetSystemTime())
+    {
+        TRACE_BEGIN(GetPhaseName(phase));
+    }
+    ~Scope()
+    {
+        Record(mPhase, static_cast<uint32_t>(OSTicksToMicroseconds(OSGetSystemTime() - mStart)));
+        TRACE_END(GetPhaseName(mPhase));
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Phase mPhase;
+    OSTime mStart;
+};
+
+}
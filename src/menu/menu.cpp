@@ -6,6 +6,8 @@
 #include "menu.h"
 #include "menu_state.h"
 #include "categories.h"
+#include "frame_timing.h"
+#include "warmup.h"
 #include "panels/browse_panel.h"
 #include "panels/settings_panel.h"
 #include "panels/edit_panel.h"
@@ -14,18 +16,28 @@
 #include "../render/image_loader.h"
 #include "../render/measurements.h"
 #include "../input/buttons.h"
+#include "../input/input_recorder.h"
 #include "../titles/titles.h"
 #include "../storage/settings.h"
+#include "../presets/title_presets.h"
 #include "../ui/list_view.h"
+#include "../utils/memory_budget.h"
+#include "../utils/trace.h"
+#include "../utils/worker_threads.h"
 
 #include <vpad/input.h>
 #include <sysapp/launch.h>
 #include <sysapp/title.h>
+#include <coreinit/core.h>
+#include <coreinit/thread.h>
 #include <coreinit/time.h>
 #include <notifications/notifications.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 namespace Menu {
 
@@ -52,12 +64,20 @@ TextInput::Field sInputField;
 OSTime sApplicationStartTime = 0;
 bool sInForeground = false;
 bool sOpeningInProgress = false;
+bool sIsStandbyChecked = false;
+
+// The grace period has passed for this application, so IsSafeToOpen(),
+// which the VPADRead hook calls on every read, stops reading the clock
+bool sIsPastGrace = false;
 const uint32_t STARTUP_GRACE_MS = 3000;
 
 const SettingItem sSettingItems[] = {
     ACTION_SETTING("System Apps",       "Launch system applications",   "(Browser, Settings, etc.)", ACTION_SYSTEM_APPS),
     TOGGLE_SETTING("Show Numbers",      "Show line numbers before",     "each title in the list.",   showNumbers),
     TOGGLE_SETTING("Show Favorites",    "Show favorite marker (*)",     "in the title list.",        showFavorites),
+    TOGGLE_SETTING("Icon Grid",         "Browse titles as a grid",      "of icons, not a list.",     showIconGrid),
+    ICON_CACHE_SETTING("Icon Cache",    "Memory kept for loaded icons", "while the menu is closed.", iconCacheKB),
+    TV_REFRESH_SETTING("TV Refresh",    "How often the TV is redrawn;", "the GamePad always is.",    tvRefresh),
     ACTION_SETTING("Customize Colors",  "Change menu colors:",          "background, text, etc.",    ACTION_COLORS),
     ACTION_SETTING("Manage Categories", "Create, rename, or delete",    "custom categories.",        ACTION_MANAGE_CATEGORIES),
     ACTION_SETTING("Debug Grid",        "Show grid overlay with",       "dimensions and positions.", ACTION_DEBUG_GRID),
@@ -95,6 +115,11 @@ uint32_t* getColorPtr(int offset)
     return (uint32_t*)((char*)&Settings::Get() + offset);
 }
 
+int32_t* getIntPtr(int offset)
+{
+    return (int32_t*)((char*)&Settings::Get() + offset);
+}
+
 void clampSelection()
 {
     int count = Categories::GetFilteredCount();
@@ -114,6 +139,20 @@ void drawDetailsPanelSectionHeader(const char* title, bool shortUnderline)
                       shortUnderline ? Measurements::SECTION_UNDERLINE_SHORT : Measurements::SECTION_UNDERLINE);
 }
 
+void applyTVRefresh()
+{
+    int32_t refresh = Settings::Get().tvRefresh;
+    if (refresh == Settings::TV_REFRESH_OFF) {
+        Renderer::SetTVPacing(Renderer::TVPacing::OFF);
+    } else if (refresh == Settings::TV_REFRESH_ON_CHANGE) {
+        Renderer::SetTVPacing(Renderer::TVPacing::ON_CHANGE);
+    } else if (refresh > 1) {
+        Renderer::SetTVPacing(Renderer::TVPacing::DIVIDED, refresh);
+    } else {
+        Renderer::SetTVPacing(Renderer::TVPacing::EVERY_FRAME);
+    }
+}
+
 const char* getSettingActionHint(SettingType type)
 {
     switch (type) {
@@ -123,6 +162,10 @@ const char* getSettingActionHint(SettingType type)
             return "A: Edit color";
         case SettingType::BRIGHTNESS:
             return "A: Cycle brightness";
+        case SettingType::ICON_CACHE:
+            return "A: Cycle size";
+        case SettingType::TV_REFRESH:
+            return "A: Cycle rate";
         case SettingType::ACTION:
             return "A: Select";
         default:
@@ -136,17 +179,138 @@ using namespace Internal;
 
 namespace {
 
-FrameResult processFrameInternal()
+// One 60 Hz frame, and what EndFrame() needs of it
+constexpr uint32_t FRAME_TIME_US = 16667;
+constexpr uint32_t FRAME_RESERVE_US = 3000;
+
+Scheduling sScheduling = Scheduling::COOPERATIVE;
+
+// Cooperative: the sleep after a frame that used more than its share.
+// OSYieldThread() only lets threads of the same priority run; a sleep
+// lets the lower ones in too
+constexpr uint32_t COOPERATIVE_REST_US = 1000;
+
+// Time a frame may work for, counted from the end of the vsync wait
+uint32_t getFrameBudgetMicros()
 {
-    FrameResult result = {true, 0};
+    if (sScheduling == Scheduling::COOPERATIVE) {
+        return FRAME_TIME_US * COOPERATIVE_DUTY_PERCENT / 100;
+    }
+    return FRAME_TIME_US - FRAME_RESERVE_US;
+}
 
-    if (!sIsOpen) {
-        result.shouldContinue = false;
-        return result;
+uint32_t getElapsedMicros(OSTime frameStart)
+{
+    return static_cast<uint32_t>(OSTicksToMicroseconds(OSGetSystemTime() - frameStart));
+}
+
+// Frame time left for icon work before the flip has to start
+uint32_t getRemainingFrameMicros(OSTime frameStart)
+{
+    uint32_t budgetMicros = getFrameBudgetMicros();
+    uint32_t elapsedMicros = getElapsedMicros(frameStart);
+    return elapsedMicros >= budgetMicros ? 0 : budgetMicros - elapsedMicros;
+}
+
+// Cooperative: let other threads on this core run between frame phases
+void yieldPhase()
+{
+    if (sScheduling == Scheduling::COOPERATIVE) {
+        OSYieldThread();
     }
+}
 
-    Renderer::BeginFrame(Settings::Get().bgColor);
+// Cooperative: a frame that went past its share gives some back before
+// the next vsync wait
+void restAfterFrame(OSTime frameStart)
+{
+    if (sScheduling == Scheduling::COOPERATIVE && getElapsedMicros(frameStart) >= getFrameBudgetMicros()) {
+        OSSleepTicks(OSMicrosecondsToTicks(COOPERATIVE_REST_US));
+    }
+}
+
+// Frames in a row with no input and no background work before the menu
+// stops drawing. Two refresh both buffers; the rest is margin
+constexpr int IDLE_FRAME_THRESHOLD = 8;
+
+int sQuietFrames = 0;
+
+// VPAD keeps 16 samples, about four frames at its 4ms rate
+constexpr int32_t VPAD_SAMPLE_COUNT = 16;
 
+// Icon work an overlay frame may add to the game's frame
+constexpr uint32_t OVERLAY_UPDATE_BUDGET_US = 1000;
+
+// Overlay mode: open over a running game, and whether the first overlay
+// frame has set the menu up yet
+bool sIsOverlay = false;
+bool sIsOverlayStarted = false;
+
+// Buttons the game's VPADRead passed on, for the next overlay frame
+std::atomic<uint32_t> sOverlayPressed{0};
+std::atomic<uint32_t> sOverlayHeld{0};
+
+// Work that changes the screen without any input
+bool hasBackgroundWork()
+{
+    int pending, ready, failed, total;
+    ImageLoader::GetLoadingStats(&pending, &ready, &failed, &total);
+
+    Titles::LoadPhase phase = Titles::GetLoadState().phase;
+    bool isLoadingTitles = phase == Titles::LoadPhase::ENUMERATING ||
+                           phase == Titles::LoadPhase::RESOLVING;
+
+    // The debug grid shows live loader counters; a paced TV catches up on
+    // frames of its own
+    return pending > 0 || isLoadingTitles || TitlePresets::IsLoadPending() ||
+           sCurrentMode == Mode::DEBUG_GRID || Renderer::IsTVBehind();
+}
+
+// Unpack or queue the icons the first frame shows before anything else:
+// the selection (drawn in the details panel), then the rows on screen.
+// The icon grid scrolls on its own, so it gets the selection's row and
+// a page of cells from there
+void promoteVisibleIcons()
+{
+    int count = Categories::GetFilteredCount();
+    int firstRow = sTitleListState.scrollOffset;
+    int visibleCount = Renderer::GetVisibleRows();
+    if (Settings::Get().showIconGrid) {
+        const Layout::PixelLayout::Grid& grid = Renderer::GetLayout().grid;
+        firstRow = std::max(sTitleListState.selectedIndex, 0) / grid.columns * grid.columns;
+        visibleCount = grid.GetCellCount();
+    }
+    int lastRow = std::min(firstRow + visibleCount, count);
+    std::vector<uint64_t> titleIds;
+
+    const Titles::TitleInfo* selected = Categories::GetFilteredTitle(sTitleListState.selectedIndex);
+    if (selected) {
+        titleIds.push_back(selected->titleId);
+    }
+    for (int filteredIndex = firstRow; filteredIndex < lastRow; filteredIndex++) {
+        const Titles::TitleInfo* title = Categories::GetFilteredTitle(filteredIndex);
+        if (title && title != selected) {
+            titleIds.push_back(title->titleId);
+        }
+    }
+    ImageLoader::Promote(titleIds.data(), static_cast<int>(titleIds.size()));
+}
+
+// A deferred preset load runs on a frame with no input and no loading
+// work, unless a panel has asked for it
+void updateDeferredPresets(bool hadInput)
+{
+    bool isIdle = !hadInput && Titles::IsLoaded() && !ImageLoader::HasHighPriorityPending();
+    if (TitlePresets::LoadIfPending(isIdle)) {
+        // The year sort and facet filters read presets
+        Titles::RefreshSortOrders();
+        Categories::RefreshFilter();
+        clampSelection();
+    }
+}
+
+void renderCurrentMode()
+{
     switch (sCurrentMode) {
         case Mode::BROWSE:
             BrowsePanel::Render();
@@ -161,43 +325,139 @@ FrameResult processFrameInternal()
             DebugPanel::Render();
             break;
     }
+}
+
+// Every sample VPAD buffered since the last read: a press and release
+// between two frames still counts, and hold is the newest state. False
+// if nothing could be read
+bool readInput(uint32_t* outPressed, uint32_t* outHeld)
+{
+    VPADStatus samples[VPAD_SAMPLE_COUNT];
+    VPADReadError vpadError;
+    int32_t sampleCount = VPADRead(VPAD_CHAN_0, samples, VPAD_SAMPLE_COUNT, &vpadError);
+    if (sampleCount <= 0 || vpadError != VPAD_READ_SUCCESS) {
+        return false;
+    }
+
+    // Newest first
+    uint32_t pressed = 0;
+    for (int32_t sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++) {
+        pressed |= samples[sampleIndex].trigger;
+    }
+    *outPressed = pressed;
+    *outHeld = samples[0].hold;
+    return true;
+}
+
+// Returns a title to launch, or 0
+uint64_t handleModeInput(uint32_t pressed, uint32_t held)
+{
+    uint64_t titleToLaunch = 0;
+    switch (sCurrentMode) {
+        case Mode::BROWSE:
+            titleToLaunch = BrowsePanel::HandleInput(pressed, held);
+            break;
+        case Mode::EDIT:
+            EditPanel::HandleInput(pressed, held);
+            break;
+        case Mode::SETTINGS:
+            SettingsPanel::HandleInput(pressed, held);
+            break;
+        case Mode::DEBUG_GRID:
+            DebugPanel::HandleInput(pressed);
+            break;
+    }
+    return titleToLaunch;
+}
+
+FrameResult processFrameInternal()
+{
+    FrameResult result = {true, 0};
 
-    static uint32_t frameCounter = 0;
-    frameCounter++;
-    if (ImageLoader::HasHighPriorityPending() || frameCounter % 10 == 0) {
-        ImageLoader::Update();
+    if (!sIsOpen) {
+        result.shouldContinue = false;
+        return result;
     }
 
-    Renderer::EndFrame();
+    // Idle: the screen is already up to date, so skip drawing and the
+    // vsync wait, and only poll input about once a frame
+    bool isIdle = sQuietFrames >= IDLE_FRAME_THRESHOLD;
+    FrameTiming::BeginFrame();
 
-    VPADStatus vpadStatus;
-    VPADReadError vpadError;
-    int32_t readResult = VPADRead(VPAD_CHAN_0, &vpadStatus, 1, &vpadError);
-
-    if (readResult > 0 && vpadError == VPAD_READ_SUCCESS) {
-        uint32_t pressed = vpadStatus.trigger;
-        uint32_t held = vpadStatus.hold;
-
-        switch (sCurrentMode) {
-            case Mode::BROWSE:
-                result.titleToLaunch = BrowsePanel::HandleInput(pressed);
-                break;
-            case Mode::EDIT:
-                EditPanel::HandleInput(pressed);
-                break;
-            case Mode::SETTINGS:
-                SettingsPanel::HandleInput(pressed, held);
-                break;
-            case Mode::DEBUG_GRID:
-                DebugPanel::HandleInput(pressed);
-                break;
-        }
+    if (isIdle) {
+        OSSleepTicks(OSMicrosecondsToTicks(FRAME_TIME_US));
+    } else {
+        FrameTiming::Scope scope(FrameTiming::Phase::BEGIN_FRAME);
+        Renderer::WaitForVsync();
+    }
+    OSTime frameStart = OSGetSystemTime();
+
+    // Input before drawing, so this frame already shows what it did
+    uint32_t pressed = 0;
+    uint32_t held = 0;
+    bool hasRead;
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::VPAD_READ);
+        hasRead = readInput(&pressed, &held);
+        hasRead = InputRecorder::Apply(hasRead, &pressed, &held);
+    }
+    bool hadInput = pressed != 0 || held != 0;
+    if (hasRead) {
+        result.titleToLaunch = handleModeInput(pressed, held);
     }
 
     if (!sIsOpen) {
         result.shouldContinue = false;
+        return result;
+    }
+    yieldPhase();
+
+    updateDeferredPresets(hadInput);
+
+    bool listChanged = Titles::Update();
+    if (listChanged) {
+        Categories::RefreshFilter();
+        clampSelection();
+    }
+
+    // Anything that changed the screen ends idling this frame
+    isIdle = isIdle && !hadInput && !listChanged;
+    yieldPhase();
+
+    if (!isIdle) {
+        // Browse invalidates only what changed; the other modes redraw in full
+        Renderer::SetRetainedMode(sCurrentMode == Mode::BROWSE);
+        {
+            FrameTiming::Scope scope(FrameTiming::Phase::BEGIN_FRAME);
+            Renderer::BeginFrame(Settings::Get().bgColor);
+        }
+        {
+            FrameTiming::Scope scope(FrameTiming::Phase::RENDER);
+            renderCurrentMode();
+        }
+        yieldPhase();
+    }
+
+    // Collects decoded icons in whatever time is left of the frame's budget
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::IMAGE_LOADER);
+        ImageLoader::Update(isIdle ? 0 : getRemainingFrameMicros(frameStart));
+    }
+
+    if (!isIdle) {
+        FrameTiming::Scope scope(FrameTiming::Phase::END_FRAME);
+        Renderer::EndFrame();
     }
 
+    // Idle frames only sleep; keeping them would hide the drawn frames' cost
+    if (!isIdle) {
+        FrameTiming::CommitFrame();
+        restAfterFrame(frameStart);
+    }
+
+    bool isQuiet = !hadInput && !listChanged && !hasBackgroundWork();
+    sQuietFrames = isQuiet ? sQuietFrames + 1 : 0;
+
     return result;
 }
 
@@ -212,6 +472,127 @@ uint64_t runMenuLoop()
     return 0;
 }
 
+// Bring up the renderer and the menu's state for a new session
+bool startMenu()
+{
+    // The game may have taken what the framebuffers need; whatever can be
+    // rebuilt later goes before giving up
+    if (!Renderer::Init() &&
+        (MemoryBudget::Relieve(MemoryBudget::Pressure::CRITICAL) == 0 || !Renderer::Init())) {
+        NotificationModule_AddErrorNotification("Menu unavailable - not enough memory");
+        return false;
+    }
+
+    // Before StartLoadAsync() creates the loader thread
+    WorkerThreads::AvoidCore(OSGetCoreId());
+
+    Titles::StartLoadAsync();
+    Titles::RefreshIfChanged();
+    Titles::Update();
+    Titles::SetSortOrder(static_cast<Titles::SortOrder>(Settings::Get().sortOrder));
+    Categories::Init();
+    ImageLoader::RetryFailed();
+
+    sTitleListState = UI::ListView::State();
+    sTitleListState.selectedIndex = Settings::Get().lastIndex;
+    clampSelection();
+    promoteVisibleIcons();
+    applyTVRefresh();
+
+    sIsOpen = true;
+    sCurrentMode = Mode::BROWSE;
+    sQuietFrames = 0;
+    FrameTiming::Reset();
+    InputRecorder::BeginSession();
+    return true;
+}
+
+void finishMenu(uint64_t titleToLaunch)
+{
+    Settings::Get().lastIndex = sTitleListState.selectedIndex;
+    if (titleToLaunch != 0) {
+        Settings::RecordLaunch(titleToLaunch);
+        Titles::RefreshSortOrders();
+    }
+    Settings::Save();
+
+    sIsOpen = false;
+    Renderer::Shutdown();
+    Trace::Flush();
+    InputRecorder::EndSession();
+
+    if (titleToLaunch != 0) {
+        SYSLaunchTitle(titleToLaunch);
+    }
+}
+
+void stopOverlay(uint64_t titleToLaunch)
+{
+    Renderer::SetOverlayFrameCallback(nullptr);
+    sIsOverlay = false;
+    if (sIsOverlayStarted) {
+        sIsOverlayStarted = false;
+        finishMenu(titleToLaunch);
+    } else {
+        sIsOpen = false;
+    }
+}
+
+// One menu frame inside the game's frame, on the game's thread: the input
+// the game's VPADRead passed on, then the panels record what the overlay
+// draws. Nothing here sleeps or waits on vsync
+void processOverlayFrame()
+{
+    if (!sIsOverlayStarted) {
+        Renderer::SetBackend(Renderer::Backend::GX2);
+        if (!startMenu()) {
+            stopOverlay(0);
+            return;
+        }
+        sIsOverlayStarted = true;
+    }
+
+    FrameTiming::BeginFrame();
+
+    if (Titles::Update()) {
+        Categories::RefreshFilter();
+        clampSelection();
+    }
+
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::IMAGE_LOADER);
+        ImageLoader::Update(OVERLAY_UPDATE_BUDGET_US);
+    }
+
+    uint32_t pressed = sOverlayPressed.exchange(0);
+    uint32_t held = sOverlayHeld.load();
+    uint64_t titleToLaunch = 0;
+    if (InputRecorder::Apply(true, &pressed, &held)) {
+        titleToLaunch = handleModeInput(pressed, held);
+    }
+    updateDeferredPresets(pressed != 0 || held != 0);
+
+    if (!sIsOpen || titleToLaunch != 0) {
+        stopOverlay(titleToLaunch);
+        return;
+    }
+
+    // The game's VPADRead handed the input over, so VPAD stays at zero
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::BEGIN_FRAME);
+        Renderer::BeginFrame(Settings::Get().bgColor);
+    }
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::RENDER);
+        renderCurrentMode();
+    }
+    {
+        FrameTiming::Scope scope(FrameTiming::Phase::END_FRAME);
+        Renderer::EndFrame();
+    }
+    FrameTiming::CommitFrame();
+}
+
 }
 
 void Init()
@@ -223,9 +604,13 @@ void Init()
 
 void Shutdown()
 {
+    if (sIsOverlay) {
+        stopOverlay(0);
+    }
     if (sIsOpen) {
         Close();
     }
+    Renderer::ReleaseResources();
     sInitialized = false;
 }
 
@@ -234,13 +619,24 @@ bool IsOpen()
     return sIsOpen;
 }
 
+bool IsOverlayOpen()
+{
+    return sIsOpen && sIsOverlay;
+}
+
+void QueueOverlayInput(uint32_t pressed, uint32_t held)
+{
+    sOverlayPressed |= pressed;
+    sOverlayHeld = held;
+}
+
 bool IsSafeToOpen()
 {
     if (sIsOpen) {
         return false;
     }
 
-    if (sApplicationStartTime != 0) {
+    if (sApplicationStartTime != 0 && !sIsPastGrace) {
         OSTime now = OSGetTime();
         OSTime elapsed = now - sApplicationStartTime;
         uint32_t elapsedMs = static_cast<uint32_t>(OSTicksToMilliseconds(elapsed));
@@ -248,6 +644,7 @@ bool IsSafeToOpen()
         if (elapsedMs < STARTUP_GRACE_MS) {
             return false;
         }
+        sIsPastGrace = true;
     }
 
     if (!sInForeground) {
@@ -257,6 +654,33 @@ bool IsSafeToOpen()
     return true;
 }
 
+void UpdateClosed()
+{
+    if (sIsOpen || !IsSafeToOpen()) {
+        return;
+    }
+
+    Warmup::Update(Warmup::SLICE_BUDGET_US);
+
+    // Reserved once per application, as soon as the menu could open, and
+    // only where opening takes over the screen rather than overlaying it
+    if (sIsStandbyChecked || Renderer::IsOverlayAvailable()) {
+        return;
+    }
+    sIsStandbyChecked = true;
+    Renderer::ReserveStandby();
+}
+
+void SetScheduling(Scheduling scheduling)
+{
+    sScheduling = scheduling;
+}
+
+Scheduling GetScheduling()
+{
+    return sScheduling;
+}
+
 Mode GetMode()
 {
     return sCurrentMode;
@@ -266,37 +690,27 @@ void Open()
 {
     if (sIsOpen) return;
 
-    sOpeningInProgress = true;
-
-    if (!Renderer::Init()) {
-        NotificationModule_AddErrorNotification("Menu unavailable - not enough memory");
-        sOpeningInProgress = false;
+    // In a game the menu draws over its frames, so the game keeps running;
+    // the overlay starts on the game's next frame
+    if (Renderer::IsOverlayAvailable()) {
+        sIsOverlay = true;
+        sIsOverlayStarted = false;
+        sOverlayPressed = 0;
+        sOverlayHeld = 0;
+        sIsOpen = true;
+        Renderer::SetOverlayFrameCallback(processOverlayFrame);
         return;
     }
 
-    Titles::Load();
-    Categories::Init();
-    ImageLoader::RetryFailed();
-
-    sTitleListState = UI::ListView::State();
-    sTitleListState.selectedIndex = Settings::Get().lastIndex;
-    clampSelection();
-
-    sIsOpen = true;
+    Renderer::SetBackend(Renderer::Backend::OS_SCREEN);
+    sOpeningInProgress = true;
+    bool isStarted = startMenu();
     sOpeningInProgress = false;
-    sCurrentMode = Mode::BROWSE;
-
-    uint64_t titleToLaunch = runMenuLoop();
-
-    Settings::Get().lastIndex = sTitleListState.selectedIndex;
-    Settings::Save();
-
-    sIsOpen = false;
-    Renderer::Shutdown();
-
-    if (titleToLaunch != 0) {
-        SYSLaunchTitle(titleToLaunch);
+    if (!isStarted) {
+        return;
     }
+
+    finishMenu(runMenuLoop());
 }
 
 void Close()
@@ -313,22 +727,9 @@ void RenderFrame()
 {
     if (!sIsOpen) return;
 
+    Renderer::SetRetainedMode(sCurrentMode == Mode::BROWSE);
     Renderer::BeginFrame(Settings::Get().bgColor);
-
-    switch (sCurrentMode) {
-        case Mode::BROWSE:
-            BrowsePanel::Render();
-            break;
-        case Mode::EDIT:
-            EditPanel::Render();
-            break;
-        case Mode::SETTINGS:
-            SettingsPanel::Render();
-            break;
-        case Mode::DEBUG_GRID:
-            DebugPanel::Render();
-            break;
-    }
+    renderCurrentMode();
 }
 
 FrameResult HandleInputFrame()
@@ -340,36 +741,25 @@ FrameResult HandleInputFrame()
         return result;
     }
 
-    static uint32_t frameCounter = 0;
-    frameCounter++;
-    if (ImageLoader::HasHighPriorityPending() || frameCounter % 10 == 0) {
-        ImageLoader::Update();
+    if (Titles::Update()) {
+        Categories::RefreshFilter();
+        clampSelection();
     }
 
-    VPADStatus vpadStatus;
-    VPADReadError vpadError;
-    int32_t readResult = VPADRead(VPAD_CHAN_0, &vpadStatus, 1, &vpadError);
-
-    if (readResult > 0 && vpadError == VPAD_READ_SUCCESS) {
-        uint32_t pressed = vpadStatus.trigger;
-        uint32_t held = vpadStatus.hold;
-
-        switch (sCurrentMode) {
-            case Mode::BROWSE:
-                result.titleToLaunch = BrowsePanel::HandleInput(pressed);
-                break;
-            case Mode::EDIT:
-                EditPanel::HandleInput(pressed);
-                break;
-            case Mode::SETTINGS:
-                SettingsPanel::HandleInput(pressed, held);
-                break;
-            case Mode::DEBUG_GRID:
-                DebugPanel::HandleInput(pressed);
-                break;
-        }
+    // Only collects decoded icons; the worker thread does the loading
+    ImageLoader::Update();
+
+    uint32_t pressed = 0;
+    uint32_t held = 0;
+    bool hadInput = false;
+    bool hasRead = readInput(&pressed, &held);
+    if (InputRecorder::Apply(hasRead, &pressed, &held)) {
+        hadInput = pressed != 0 || held != 0;
+        result.titleToLaunch = handleModeInput(pressed, held);
     }
 
+    updateDeferredPresets(hadInput);
+
     if (!sIsOpen) {
         result.shouldContinue = false;
     }
@@ -391,19 +781,31 @@ void InitForWebPreview()
     sInForeground = true;
     sTitleListState = UI::ListView::State();
     clampSelection();
+    applyTVRefresh();
 }
 
 void OnApplicationStart()
 {
     sApplicationStartTime = OSGetTime();
+    sIsPastGrace = false;
     sInForeground = true;
+    sIsStandbyChecked = false;
+
+    // The game needs the memory more than closed-menu icons do, and more
+    // than the standby framebuffers until UpdateClosed() takes them back
+    MemoryBudget::Relieve(MemoryBudget::Pressure::MODERATE);
 }
 
 void OnApplicationEnd()
 {
     sApplicationStartTime = 0;
+    sIsPastGrace = false;
     sInForeground = false;
 
+    // The game's frames, which run the overlay, have stopped
+    if (sIsOverlay) {
+        stopOverlay(0);
+    }
     if (sIsOpen) {
         Close();
     }
@@ -412,6 +814,10 @@ void OnApplicationEnd()
 void OnForegroundAcquired()
 {
     sInForeground = true;
+
+    if (!sIsOpen) {
+        ImageLoader::Demote();
+    }
 }
 
 void OnForegroundReleased()
@@ -422,6 +828,9 @@ void OnForegroundReleased()
 
     sInForeground = false;
 
+    if (sIsOverlay) {
+        stopOverlay(0);
+    }
     if (sIsOpen) {
         Close();
     }
@@ -36,11 +36,53 @@ void Shutdown();
 
 bool IsOpen();
 bool IsSafeToOpen();
+
+/**
+ * Background work for a closed menu, once the startup grace period is
+ * over: a slice of the warm-up jobs (see Warmup), then the renderer's
+ * standby framebuffers, reserved once per application so Open() doesn't
+ * allocate them. Call every frame while closed.
+ */
+void UpdateClosed();
 Mode GetMode();
 
+/**
+ * How the full-screen menu shares the game's thread. The menu loop runs
+ * on the thread that called VPADRead(), so while it is open nothing else
+ * at that thread's priority runs on its core.
+ *
+ * EXCLUSIVE: spend up to the whole frame, as before.
+ * COOPERATIVE (default): keep each frame's work to COOPERATIVE_DUTY_PERCENT
+ * of the frame, yield between phases, and sleep briefly after a frame that
+ * overran, so audio and system threads still get their slices. Background
+ * workers move off the menu's core either way (see WorkerThreads).
+ */
+enum class Scheduling {
+    EXCLUSIVE,
+    COOPERATIVE
+};
+
+constexpr uint32_t COOPERATIVE_DUTY_PERCENT = 50;
+
+void SetScheduling(Scheduling scheduling);
+Scheduling GetScheduling();
+
 void Open();
 void Close();
 
+/**
+ * Check if the menu is open as an overlay over a running game. The game
+ * keeps rendering, and its input should go to QueueOverlayInput().
+ */
+bool IsOverlayOpen();
+
+/**
+ * Pass the game's buttons to the overlay's next frame.
+ * @param pressed Buttons newly pressed (VPADStatus::trigger)
+ * @param held Buttons held (VPADStatus::hold)
+ */
+void QueueOverlayInput(uint32_t pressed, uint32_t held);
+
 /**
  * Process a single frame (render + input).
  * Non-blocking - returns immediately after one frame.
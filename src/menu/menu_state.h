@@ -34,6 +34,8 @@ enum class SettingType {
     TOGGLE,
     COLOR,
     BRIGHTNESS,
+    ICON_CACHE,
+    TV_REFRESH,
     ACTION
 };
 
@@ -63,6 +65,10 @@ struct SettingItem {
     {n, d1, d2, SettingType::COLOR, (int)offsetof(Settings::PluginSettings, member)}
 #define ACTION_SETTING(n, d1, d2, actionId) \
     {n, d1, d2, SettingType::ACTION, actionId}
+#define ICON_CACHE_SETTING(n, d1, d2, member) \
+    {n, d1, d2, SettingType::ICON_CACHE, (int)offsetof(Settings::PluginSettings, member)}
+#define TV_REFRESH_SETTING(n, d1, d2, member) \
+    {n, d1, d2, SettingType::TV_REFRESH, (int)offsetof(Settings::PluginSettings, member)}
 
 #define COLOR_OPTION(n, member) \
     {n, (int)offsetof(Settings::PluginSettings, member)}
@@ -124,10 +130,12 @@ extern const int COLOR_OPTION_COUNT;
 
 bool* getTogglePtr(int offset);
 uint32_t* getColorPtr(int offset);
+int32_t* getIntPtr(int offset);
 void clampSelection();
 void drawHeaderDivider();
 void drawDetailsPanelSectionHeader(const char* title, bool shortUnderline = false);
 const char* getSettingActionHint(SettingType type);
+void applyTVRefresh();
 inline bool isValidSelection(int index, int count) { return index >= 0 && index < count; }
 
 }
@@ -7,6 +7,7 @@
 #include "../menu_state.h"
 #include "../menu.h"
 #include "../categories.h"
+#include "../facets.h"
 #include "../../render/renderer.h"
 #include "../../render/image_loader.h"
 #include "../../render/measurements.h"
@@ -15,9 +16,14 @@
 #include "../../storage/settings.h"
 #include "../../presets/title_presets.h"
 #include "../../ui/list_view.h"
+#include "../../input/text_input.h"
 
+#include <algorithm>
+#include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <vector>
 
 namespace Menu {
 namespace BrowsePanel {
@@ -26,6 +32,97 @@ using namespace Internal;
 
 namespace {
 
+// True while the search field has input focus; the filter stays applied
+// after the field is confirmed
+bool isSearchInputActive = false;
+
+// "More like this": each FACET press narrows the list by the next facet
+// of the anchor title (genre, publisher, developer, region, then year)
+constexpr int FACET_STEP_YEAR = Facets::FIELD_COUNT;
+constexpr int FACET_STEP_COUNT = Facets::FIELD_COUNT + 1;
+int sFacetStep = -1;
+uint64_t sFacetAnchorTitleId = 0;
+
+void resetTitleList()
+{
+    sTitleListState = UI::ListView::State();
+    clampSelection();
+}
+
+/**
+ * Build a filter for one facet step of a title.
+ *
+ * @return false if the title has no value for that facet
+ */
+bool buildFacetStep(int titleIndex, int step, Facets::Filter& filter)
+{
+    filter = Facets::Filter();
+
+    if (step == FACET_STEP_YEAR) {
+        uint16_t year = Facets::GetTitleYear(titleIndex);
+        filter.minYear = year;
+        filter.maxYear = year;
+        return year != 0;
+    }
+
+    const char* value = Facets::GetTitleValue(titleIndex, static_cast<Facets::Field>(step));
+    Facets::SetValue(filter, static_cast<Facets::Field>(step), value);
+    return value[0] != '\0';
+}
+
+void cycleFacetFilter(int selectedIdx, int count)
+{
+    if (!Categories::IsFacetFilterActive()) {
+        if (!isValidSelection(selectedIdx, count)) return;
+        const Titles::TitleInfo* title = Categories::GetFilteredTitle(selectedIdx);
+        if (!title) return;
+        sFacetAnchorTitleId = title->titleId;
+        sFacetStep = -1;
+    }
+
+    int anchorIndex = Titles::FindIndexById(sFacetAnchorTitleId);
+    Facets::Filter filter;
+    for (int step = sFacetStep + 1; anchorIndex >= 0 && step < FACET_STEP_COUNT; step++) {
+        if (buildFacetStep(anchorIndex, step, filter)) {
+            sFacetStep = step;
+            Categories::SetFacetFilter(filter);
+            resetTitleList();
+            return;
+        }
+    }
+
+    // Past the last facet: back to the plain category
+    sFacetStep = -1;
+    Categories::ClearFacetFilter();
+    resetTitleList();
+}
+
+void formatFacetFilter(char* buffer, size_t bufferSize)
+{
+    const Facets::Filter& filter = Categories::GetFacetFilter();
+    buffer[0] = '\0';
+
+    if (filter.minYear != 0) {
+        snprintf(buffer, bufferSize, "Year: %d", filter.minYear);
+        return;
+    }
+
+    for (int field = 0; field < Facets::FIELD_COUNT; field++) {
+        if (filter.values[field][0] != '\0') {
+            snprintf(buffer, bufferSize, "%s: %s",
+                     Facets::GetFieldName(static_cast<Facets::Field>(field)), filter.values[field]);
+            return;
+        }
+    }
+}
+
+void drawSearchBar()
+{
+    const Settings::PluginSettings& settings = Settings::Get();
+    Renderer::DrawText(1, CATEGORY_ROW, "Find:", settings.highlightedTitleColor);
+    sInputField.Render(7, CATEGORY_ROW);
+}
+
 void drawCategoryBar()
 {
     char line[80];
@@ -33,14 +130,11 @@ void drawCategoryBar()
 
     const Settings::PluginSettings& settings = Settings::Get();
 
-    int catCount = Categories::GetTotalCategoryCount();
+    int visibleCount = Categories::GetVisibleCategoryCount();
     int currentCat = Categories::GetCurrentCategoryIndex();
 
-    for (int i = 0; i < catCount && col < Measurements::CATEGORY_BAR_MAX_WIDTH; i++) {
-        if (!Categories::IsCategoryVisible(i)) {
-            continue;
-        }
-
+    for (int position = 0; position < visibleCount && col < Measurements::CATEGORY_BAR_MAX_WIDTH; position++) {
+        int i = Categories::GetVisibleCategory(position);
         const char* name = Categories::GetCategoryName(i);
         uint32_t color;
 
@@ -55,6 +149,19 @@ void drawCategoryBar()
         Renderer::DrawText(col, CATEGORY_ROW, line, color);
         col += strlen(line);
     }
+
+    if (Categories::IsFacetFilterActive() && col < Measurements::CATEGORY_BAR_MAX_WIDTH) {
+        // Leave room for the two spaces after it
+        formatFacetFilter(line, sizeof(line) - 2);
+        strcat(line, "  ");
+        Renderer::DrawText(col, CATEGORY_ROW, line, settings.highlightedTitleColor);
+        col += strlen(line);
+    }
+
+    if (Categories::IsSearchActive() && col < Measurements::CATEGORY_BAR_MAX_WIDTH) {
+        snprintf(line, sizeof(line), "Find: %s", Categories::GetSearchQuery());
+        Renderer::DrawText(col, CATEGORY_ROW, line, settings.highlightedTitleColor);
+    }
 }
 
 void drawDivider()
@@ -64,29 +171,40 @@ void drawDivider()
     }
 }
 
+// The list is drawn every frame; most rows are the same as last time
+UI::ListView::RowCache sTitleRowCache;
+
 void drawTitleList()
 {
     int count = Categories::GetFilteredCount();
     sTitleListState.itemCount = count;
 
+    if (count == 0 && !Titles::IsLoaded()) {
+        Renderer::DrawText(2, LIST_START_ROW, "Loading titles...");
+        return;
+    }
+
+    const Settings::PluginSettings& settings = Settings::Get();
     UI::ListView::Config listConfig = UI::ListView::LeftPanelConfig(Renderer::GetVisibleRows());
     listConfig.width = Renderer::GetListWidth();
-    listConfig.showLineNumbers = Settings::Get().showNumbers;
+    listConfig.showLineNumbers = settings.showNumbers;
 
-    UI::ListView::Render(sTitleListState, listConfig, [](int index, bool isSelected) {
+    UI::ListView::Render(sTitleListState, listConfig, [&settings](int index, bool isSelected) {
         UI::ListView::ItemView view;
-        const Titles::TitleInfo* title = Categories::GetFilteredTitle(index);
+        Titles::TitleRecord record;
 
-        if (!title) {
+        if (!Categories::GetFilteredRecord(index, &record)) {
             view.text = "(error)";
             return view;
         }
 
-        view.text = title->name;
+        if (!record.isNameResolved) {
+            Titles::PrioritizeName(record.info->titleId);
+        }
+        view.text = record.info->name;
         view.prefix = isSelected ? "> " : "  ";
 
-        const Settings::PluginSettings& settings = Settings::Get();
-        bool isFavorite = Settings::IsFavorite(title->titleId);
+        bool isFavorite = (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0;
 
         if (isSelected) {
             view.textColor = settings.highlightedTitleColor;
@@ -102,138 +220,350 @@ void drawTitleList()
         }
 
         return view;
-    });
+    }, &sTitleRowCache);
 }
 
-void drawDetailsPanelHeader(const Titles::TitleInfo* title)
+// =============================================================================
+// Icon Prefetch
+// =============================================================================
+// Queues the icons the selection is about to reach, so scrolling shows
+// icons rather than placeholders: the next page in the direction of the
+// last move, the rows the next skips would land on, and a couple of rows
+// behind. Titles that drop out of that window fall to LOW priority; ones
+// more than two large skips away are cancelled.
+
+constexpr int PREFETCH_ROWS_BEHIND = 2;
+constexpr int PREFETCH_SKIP_LANDINGS = 2;
+
+struct PrefetchEntry {
+    uint64_t titleId;
+    int filteredIndex;
+};
+
+// What the last pass requested, and scratch for the current one
+std::vector<PrefetchEntry> sPrefetched;
+std::vector<PrefetchEntry> sPrefetchWindow;
+
+// Selection the last pass ran for
+int sPrefetchSelection = -1;
+int sPrefetchCount = -1;
+uint64_t sPrefetchTitleId = 0;
+
+bool isInPrefetchWindow(uint64_t titleId)
 {
-    Renderer::DrawText(Renderer::GetDetailsPanelCol(), LIST_START_ROW, title->name);
+    return std::any_of(sPrefetchWindow.begin(), sPrefetchWindow.end(),
+                       [titleId](const PrefetchEntry& entry) { return entry.titleId == titleId; });
+}
 
-    ImageLoader::Request(title->titleId, ImageLoader::Priority::HIGH);
+void addPrefetch(int filteredIndex, int count, ImageLoader::Priority priority)
+{
+    if (!isValidSelection(filteredIndex, count)) return;
 
-    const Layout::PixelLayout& layout = Renderer::GetLayout();
-    int iconX = layout.details.icon.x;
-    int iconY = layout.details.icon.y;
-    int iconSize = layout.iconSize;
+    const Titles::TitleInfo* title = Categories::GetFilteredTitle(filteredIndex);
+    if (!title || isInPrefetchWindow(title->titleId)) return;
 
-    if (ImageLoader::IsReady(title->titleId)) {
-        Renderer::ImageHandle icon = ImageLoader::Get(title->titleId);
-        Renderer::DrawImage(iconX, iconY, icon, iconSize, iconSize);
-    } else {
-        Renderer::DrawPlaceholder(iconX, iconY, iconSize, iconSize, 0x333333FF);
+    // Also demotes a title requested higher earlier, like the last selection
+    ImageLoader::Request(title->titleId, priority);
+    ImageLoader::SetPriority(title->titleId, priority);
+    sPrefetchWindow.push_back({ title->titleId, filteredIndex });
+}
+
+void prefetchIcons(const UI::ListView::Config& config)
+{
+    int count = Categories::GetFilteredCount();
+    int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
+    const Titles::TitleInfo* selected = isValidSelection(selectedIdx, count)
+                                      ? Categories::GetFilteredTitle(selectedIdx) : nullptr;
+    uint64_t selectedTitleId = selected ? selected->titleId : 0;
+
+    if (selectedIdx == sPrefetchSelection && count == sPrefetchCount &&
+        selectedTitleId == sPrefetchTitleId) {
+        return;
+    }
+    sPrefetchSelection = selectedIdx;
+    sPrefetchCount = count;
+    sPrefetchTitleId = selectedTitleId;
+
+    // The details panel requests the selection itself at HIGH; tracking
+    // it here demotes it once the selection moves on
+    sPrefetchWindow.clear();
+    if (selected) {
+        sPrefetchWindow.push_back({ selectedTitleId, selectedIdx });
+
+        int delta = sTitleListState.lastMoveDelta;
+        int direction = delta < 0 ? -1 : 1;
+        for (int step = 1; step <= config.visibleRows; step++) {
+            addPrefetch(selectedIdx + direction * step, count, ImageLoader::Priority::NORMAL);
+        }
+        if (delta > 1 || delta < -1) {
+            for (int landing = 1; landing <= PREFETCH_SKIP_LANDINGS; landing++) {
+                int landingIdx = std::clamp(selectedIdx + delta * landing, 0, count - 1);
+                addPrefetch(landingIdx, count, ImageLoader::Priority::NORMAL);
+            }
+        }
+        for (int step = 1; step <= PREFETCH_ROWS_BEHIND; step++) {
+            addPrefetch(selectedIdx - direction * step, count, ImageLoader::Priority::LOW);
+        }
     }
+
+    int keepDistance = config.largeSkip * 2;
+    for (const PrefetchEntry& entry : sPrefetched) {
+        if (isInPrefetchWindow(entry.titleId)) continue;
+
+        // An index from a list that has since been refiltered is meaningless
+        const Titles::TitleInfo* title = Categories::GetFilteredTitle(entry.filteredIndex);
+        bool isNearby = selected && title && title->titleId == entry.titleId &&
+                        std::abs(entry.filteredIndex - selectedIdx) <= keepDistance;
+        if (isNearby) {
+            ImageLoader::SetPriority(entry.titleId, ImageLoader::Priority::LOW);
+        } else {
+            ImageLoader::Cancel(entry.titleId);
+        }
+    }
+    sPrefetched.swap(sPrefetchWindow);
 }
 
-void drawDetailsPanelBasicInfo(const Titles::TitleInfo* title, int& currentRow)
+// =============================================================================
+// Details Panel Model
+// =============================================================================
+// Everything the details panel shows for the selection, formatted once.
+// It is rebuilt only when its key changes: another title, or a generation
+// bump in the title list (renames), favorites or categories, or presets.
+// Other frames just draw the stored lines.
+
+constexpr int MAX_DETAILS_LINES = 24;
+constexpr int MAX_DETAILS_LINE = 80;
+
+struct DetailsLine {
+    int row;
+    int col;
+    char text[MAX_DETAILS_LINE];
+};
+
+struct DetailsKey {
+    uint64_t titleId;
+    int titleIndex;
+    uint32_t listGeneration;
+    uint32_t membershipGeneration;
+    uint32_t presetGeneration;
+    bool isPresetLoadPending;
+    int detailsCol;
+    int footerRow;
+
+    bool operator==(const DetailsKey& other) const
+    {
+        return titleId == other.titleId && titleIndex == other.titleIndex &&
+               listGeneration == other.listGeneration &&
+               membershipGeneration == other.membershipGeneration &&
+               presetGeneration == other.presetGeneration &&
+               isPresetLoadPending == other.isPresetLoadPending &&
+               detailsCol == other.detailsCol && footerRow == other.footerRow;
+    }
+};
+
+struct DetailsModel {
+    bool isValid = false;
+    DetailsKey key = {};
+
+    // Bumped on every rebuild; the details region's fingerprint
+    uint32_t version = 0;
+
+    uint64_t titleId = 0;
+    DetailsLine lines[MAX_DETAILS_LINES];
+    int lineCount = 0;
+};
+
+DetailsModel sDetailsModel;
+
+void addDetailsLine(DetailsModel& model, int col, int row, const char* format, ...)
 {
-    int col = Renderer::GetDetailsPanelCol();
+    if (model.lineCount >= MAX_DETAILS_LINES) {
+        return;
+    }
+
+    DetailsLine& line = model.lines[model.lineCount++];
+    line.row = row;
+    line.col = col;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line.text, sizeof(line.text), format, args);
+    va_end(args);
+}
 
-    char idStr[32];
-    snprintf(idStr, sizeof(idStr), "ID: %016llX",
-             static_cast<unsigned long long>(title->titleId));
-    Renderer::DrawText(col, currentRow++, idStr);
+void buildDetailsBasicInfo(DetailsModel& model, const Titles::TitleRecord& record, int& currentRow)
+{
+    int col = model.key.detailsCol;
+    const Titles::TitleInfo* title = record.info;
 
-    const char* favStatus = Settings::IsFavorite(title->titleId) ? "Yes" : "No";
-    Renderer::DrawTextF(col, currentRow++, "Favorite: %s", favStatus);
+    addDetailsLine(model, col, currentRow++, "ID: %016llX", static_cast<unsigned long long>(title->titleId));
+    addDetailsLine(model, col, currentRow++, "Favorite: %s",
+                   (record.categoryMask & Settings::FAVORITE_MASK_BIT) ? "Yes" : "No");
 
     if (title->productCode[0] != '\0') {
-        Renderer::DrawTextF(col, currentRow++, "Game ID: %s", title->productCode);
+        addDetailsLine(model, col, currentRow++, "Game ID: %s", title->productCode);
     } else {
-        Renderer::DrawText(col, currentRow++, "Game ID: (none)");
+        addDetailsLine(model, col, currentRow++, "Game ID: (none)");
     }
 }
 
-void drawDetailsPanelPreset(const TitlePresets::TitlePreset* preset, int& currentRow)
+void buildDetailsPreset(DetailsModel& model, const TitlePresets::TitlePreset* preset, int& currentRow)
 {
     if (!preset) return;
 
-    int col = Renderer::GetDetailsPanelCol();
-    int maxRow = Renderer::GetFooterRow() - 3;
+    int col = model.key.detailsCol;
+    int maxRow = model.key.footerRow - 3;
 
     currentRow++;
 
     if (preset->publisher[0] != '\0') {
-        Renderer::DrawTextF(col, currentRow++, "Pub: %s", preset->publisher);
+        addDetailsLine(model, col, currentRow++, "Pub: %s", preset->publisher);
     }
 
     if (preset->developer[0] != '\0' && currentRow < maxRow) {
-        Renderer::DrawTextF(col, currentRow++, "Dev: %s", preset->developer);
+        addDetailsLine(model, col, currentRow++, "Dev: %s", preset->developer);
     }
 
     if (preset->releaseYear > 0 && currentRow < maxRow) {
         if (preset->releaseMonth > 0 && preset->releaseDay > 0) {
-            Renderer::DrawTextF(col, currentRow++, "Released: %04d-%02d-%02d",
-                               preset->releaseYear, preset->releaseMonth, preset->releaseDay);
+            addDetailsLine(model, col, currentRow++, "Released: %04d-%02d-%02d",
+                           preset->releaseYear, preset->releaseMonth, preset->releaseDay);
         } else if (preset->releaseMonth > 0) {
-            Renderer::DrawTextF(col, currentRow++, "Released: %04d-%02d",
-                               preset->releaseYear, preset->releaseMonth);
+            addDetailsLine(model, col, currentRow++, "Released: %04d-%02d",
+                           preset->releaseYear, preset->releaseMonth);
         } else {
-            Renderer::DrawTextF(col, currentRow++, "Released: %04d", preset->releaseYear);
+            addDetailsLine(model, col, currentRow++, "Released: %04d", preset->releaseYear);
         }
     }
 
     if (currentRow < maxRow) {
         if (preset->genre[0] != '\0' && preset->region[0] != '\0') {
-            Renderer::DrawTextF(col, currentRow++, "%s / %s", preset->genre, preset->region);
+            addDetailsLine(model, col, currentRow++, "%s / %s", preset->genre, preset->region);
         } else if (preset->genre[0] != '\0') {
-            Renderer::DrawTextF(col, currentRow++, "Genre: %s", preset->genre);
+            addDetailsLine(model, col, currentRow++, "Genre: %s", preset->genre);
         } else if (preset->region[0] != '\0') {
-            Renderer::DrawTextF(col, currentRow++, "Region: %s", preset->region);
+            addDetailsLine(model, col, currentRow++, "Region: %s", preset->region);
         }
     }
 }
 
-void drawDetailsPanelCategories(uint64_t titleId, int& currentRow)
+void buildDetailsCategories(DetailsModel& model, uint32_t categoryMask, int& currentRow)
 {
-    if (currentRow >= Renderer::GetFooterRow() - 2) return;
+    int footerRow = model.key.footerRow;
+    if (currentRow >= footerRow - 2) return;
 
-    int col = Renderer::GetDetailsPanelCol();
+    int col = model.key.detailsCol;
 
     currentRow++;
-    Renderer::DrawText(col, currentRow++, "Categories:");
+    addDetailsLine(model, col, currentRow++, "Categories:");
 
-    uint16_t catIds[Settings::MAX_CATEGORIES];
-    int catCount = Settings::GetCategoriesForTitle(titleId, catIds, Settings::MAX_CATEGORIES);
+    // Bit N of the mask is the category at position N
+    const std::vector<Settings::Category>& categories = Settings::Get().categories;
+    uint32_t userMask = categoryMask & ~Settings::FAVORITE_MASK_BIT;
 
-    if (catCount == 0) {
-        Renderer::DrawText(col + Measurements::INDENT_SUB_ITEM, currentRow, "(none)");
+    if (userMask == 0) {
+        addDetailsLine(model, col + Measurements::INDENT_SUB_ITEM, currentRow, "(none)");
     } else {
-        for (int i = 0; i < catCount && currentRow < Renderer::GetFooterRow() - 1; i++) {
-            const Settings::Category* cat = Settings::GetCategory(catIds[i]);
-            if (cat) {
-                Renderer::DrawTextF(col + Measurements::INDENT_SUB_ITEM, currentRow++, "- %s", cat->name);
+        for (int position = 0; position < static_cast<int>(categories.size()) &&
+                               position < Settings::MAX_CATEGORIES && currentRow < footerRow - 1; position++) {
+            if (userMask & (1u << position)) {
+                addDetailsLine(model, col + Measurements::INDENT_SUB_ITEM, currentRow++, "- %s",
+                               categories[position].name);
             }
         }
     }
 }
 
-void drawDetailsPanel()
+void buildDetailsModel(DetailsModel& model, const Titles::TitleRecord& record)
+{
+    const Titles::TitleInfo* title = record.info;
+    model.titleId = title->titleId;
+    model.lineCount = 0;
+    model.version++;
+
+    int col = model.key.detailsCol;
+    addDetailsLine(model, col, LIST_START_ROW, "%s", title->name);
+
+    int currentRow = Measurements::GetInfoStartRow(LIST_START_ROW);
+    buildDetailsBasicInfo(model, record, currentRow);
+
+    if (model.key.isPresetLoadPending) {
+        currentRow++;
+        addDetailsLine(model, col, currentRow++, "Loading metadata...");
+    } else {
+        buildDetailsPreset(model, record.preset, currentRow);
+    }
+
+    buildDetailsCategories(model, record.categoryMask, currentRow);
+}
+
+// The model for the current selection, rebuilt if its key changed; null
+// with nothing selected
+const DetailsModel* getDetailsModel()
 {
-    int count = Categories::GetFilteredCount();
     int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
-    if (count == 0 || selectedIdx < 0 || selectedIdx >= count) {
-        return;
+    Titles::TitleRecord record;
+    if (!Categories::GetFilteredRecord(selectedIdx, &record)) {
+        if (sDetailsModel.isValid) {
+            sDetailsModel.isValid = false;
+            sDetailsModel.version++;
+        }
+        return nullptr;
     }
 
-    const Titles::TitleInfo* title = Categories::GetFilteredTitle(selectedIdx);
-    if (!title) return;
+    DetailsKey key;
+    key.titleId = record.info->titleId;
+    key.titleIndex = Categories::GetFilteredTitleIndex(selectedIdx);
+    key.listGeneration = Titles::GetListGeneration();
+    key.membershipGeneration = Settings::GetMembershipGeneration();
+    key.presetGeneration = TitlePresets::GetGeneration();
+    key.isPresetLoadPending = TitlePresets::IsLoadPending();
+    key.detailsCol = Renderer::GetDetailsPanelCol();
+    key.footerRow = Renderer::GetFooterRow();
+
+    if (!sDetailsModel.isValid || !(sDetailsModel.key == key)) {
+        sDetailsModel.key = key;
+        sDetailsModel.isValid = true;
+        buildDetailsModel(sDetailsModel, record);
+    }
+    return &sDetailsModel;
+}
 
-    drawDetailsPanelHeader(title);
+void drawDetailsIcon(uint64_t titleId)
+{
+    const Layout::PixelLayout& layout = Renderer::GetLayout();
+    int iconX = layout.details.icon.x;
+    int iconY = layout.details.icon.y;
+    int iconSize = layout.iconSize;
 
-    int currentRow = Measurements::GetInfoStartRow(LIST_START_ROW);
+    // The handle is looked up each frame: the cache may evict it at any time
+    if (ImageLoader::IsReady(titleId)) {
+        Renderer::DrawImage(iconX, iconY, ImageLoader::Get(titleId), iconSize, iconSize);
+    } else {
+        ImageLoader::Request(titleId, ImageLoader::Priority::HIGH);
+        Renderer::DrawPlaceholder(iconX, iconY, iconSize, iconSize, 0x333333FF);
+    }
+}
 
-    drawDetailsPanelBasicInfo(title, currentRow);
+void drawDetailsPanel()
+{
+    const DetailsModel* model = getDetailsModel();
+    if (!model) return;
 
-    const TitlePresets::TitlePreset* preset = nullptr;
-    if (title->productCode[0] != '\0') {
-        preset = TitlePresets::GetPresetByGameId(title->productCode);
+    drawDetailsIcon(model->titleId);
+
+    for (int lineIndex = 0; lineIndex < model->lineCount; lineIndex++) {
+        const DetailsLine& line = model->lines[lineIndex];
+        Renderer::DrawText(line.col, line.row, line.text);
     }
-    drawDetailsPanelPreset(preset, currentRow);
 
-    drawDetailsPanelCategories(title->titleId, currentRow);
+    if (model->key.isPresetLoadPending) {
+        // Loaded by the menu loop on the next frame
+        TitlePresets::RequestLoad();
+    }
 }
 
-void drawFooter()
+void formatFooter(char* footer, size_t footerSize)
 {
     int count = Categories::GetFilteredCount();
     int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
@@ -241,51 +571,564 @@ void drawFooter()
     int pending, ready, failed, total;
     ImageLoader::GetLoadingStats(&pending, &ready, &failed, &total);
 
-    char footer[120];
-    snprintf(footer, sizeof(footer),
-             "%s:Go %s:Close %s:Fav %s:Edit %s:Settings ZL/ZR:Cat [%d/%d] %d/%d",
+    // While titles stream in, show enumeration progress instead of icon stats
+    Titles::LoadState loadState = Titles::GetLoadState();
+    if (loadState.phase == Titles::LoadPhase::ENUMERATING ||
+        loadState.phase == Titles::LoadPhase::RESOLVING) {
+        ready = loadState.resolvedCount;
+        total = loadState.totalCount;
+    }
+
+    snprintf(footer, footerSize,
+             "%s:Go %s:Close %s:Fav %s:Edit %s:Settings %s:%s %s:Find %s:Like ZL/ZR:Cat [%d/%d] %d/%d",
              Buttons::Actions::CONFIRM.label,
              Buttons::Actions::CANCEL.label,
              Buttons::Actions::FAVORITE.label,
              Buttons::Actions::EDIT.label,
              Buttons::Actions::SETTINGS.label,
+             Buttons::Actions::SORT.label,
+             Titles::GetSortOrderName(Titles::GetSortOrder()),
+             Buttons::Actions::SEARCH.label,
+             Buttons::Actions::FACET.label,
              selectedIdx + 1,
              count,
              ready,
              total);
+}
 
+void drawFooter(const char* footer)
+{
     Renderer::DrawText(1, Renderer::GetFooterRow(), footer);
 }
 
+void handleSearchInput(uint32_t pressed)
+{
+    TextInput::Result result = sInputField.HandleInput(pressed);
+
+    if (result == TextInput::Result::CANCELLED) {
+        isSearchInputActive = false;
+        Categories::ClearSearch();
+        resetTitleList();
+        return;
+    }
+
+    if (result == TextInput::Result::CONFIRMED) {
+        isSearchInputActive = false;
+    }
+
+    // Re-filter on every edit so the list narrows while typing
+    char query[Categories::MAX_SEARCH_LENGTH + 1];
+    sInputField.GetValue(query, sizeof(query));
+    if (strcmp(query, Categories::GetSearchQuery()) != 0) {
+        Categories::SetSearchQuery(query);
+        resetTitleList();
+    }
+}
+
+// =============================================================================
+// Icon Grid
+// =============================================================================
+// The grid view (Settings::showIconGrid) shows the filtered titles as
+// icons, row by row, with the list's selection. Only the cells on screen
+// are drawn and requested, plus one row past them in the direction the
+// grid last scrolled; everything further away is cancelled. Icons are
+// decoded at the grid's smaller size (ImageLoader::SetIconSize) and cells
+// still loading show a placeholder. The caption row above the footer
+// names the selection in place of the details panel.
+
+constexpr uint32_t GRID_PLACEHOLDER_COLOR = 0x333333FF;
+
+// Frame around the selected icon, in the gap between cells
+constexpr int GRID_FRAME_OFFSET = 3;
+constexpr int GRID_FRAME_THICKNESS = 2;
+
+// Corner mark on favorites' icons
+constexpr int GRID_FAVORITE_MARK_SIZE = 8;
+
+// First visible row, and which way the grid last scrolled
+int sGridTopRow = 0;
+int sGridScrollDirection = 1;
+
+// Visible cells the last prefetch pass ran for
+int sGridPrefetchTopRow = -1;
+int sGridPrefetchCount = -1;
+uint64_t sGridPrefetchTitleId = 0;
+
+bool isGridView()
+{
+    return Settings::Get().showIconGrid;
+}
+
+int getGridCaptionRow()
+{
+    return Renderer::GetFooterRow() - 1;
+}
+
+// Scroll as little as keeps the selected cell's row on screen
+void scrollGridToSelection(const Layout::PixelLayout::Grid& grid)
+{
+    int count = Categories::GetFilteredCount();
+    int selectedRow = std::max(UI::ListView::GetSelectedIndex(sTitleListState), 0) / grid.columns;
+    int totalRows = (count + grid.columns - 1) / grid.columns;
+
+    int topRow = sGridTopRow;
+    if (selectedRow < topRow) {
+        topRow = selectedRow;
+    } else if (selectedRow >= topRow + grid.rows) {
+        topRow = selectedRow - grid.rows + 1;
+    }
+    topRow = std::clamp(topRow, 0, std::max(totalRows - grid.rows, 0));
+
+    if (topRow != sGridTopRow) {
+        sGridScrollDirection = topRow > sGridTopRow ? 1 : -1;
+        sGridTopRow = topRow;
+    }
+}
+
+// The visible cells at NORMAL and the next row at LOW, cancelling the
+// rest of the last pass; runs again only once the grid scrolls or the
+// list changes
+void prefetchGridIcons(const Layout::PixelLayout::Grid& grid)
+{
+    int count = Categories::GetFilteredCount();
+    int firstIdx = sGridTopRow * grid.columns;
+    const Titles::TitleInfo* first = isValidSelection(firstIdx, count) ? Categories::GetFilteredTitle(firstIdx)
+                                                                       : nullptr;
+    uint64_t firstTitleId = first ? first->titleId : 0;
+
+    if (sGridTopRow == sGridPrefetchTopRow && count == sGridPrefetchCount &&
+        firstTitleId == sGridPrefetchTitleId) {
+        return;
+    }
+    sGridPrefetchTopRow = sGridTopRow;
+    sGridPrefetchCount = count;
+    sGridPrefetchTitleId = firstTitleId;
+
+    sPrefetchWindow.clear();
+    for (int cell = 0; cell < grid.GetCellCount(); cell++) {
+        addPrefetch(firstIdx + cell, count, ImageLoader::Priority::NORMAL);
+    }
+    int prefetchRow = sGridScrollDirection > 0 ? sGridTopRow + grid.rows : sGridTopRow - 1;
+    for (int column = 0; column < grid.columns; column++) {
+        addPrefetch(prefetchRow * grid.columns + column, count, ImageLoader::Priority::LOW);
+    }
+
+    for (const PrefetchEntry& entry : sPrefetched) {
+        if (!isInPrefetchWindow(entry.titleId)) {
+            ImageLoader::Cancel(entry.titleId);
+        }
+    }
+    sPrefetched.swap(sPrefetchWindow);
+}
+
+// Either view's pass runs again on the next frame it draws, and a fresh
+// grid prefetches downward
+void resetPrefetch()
+{
+    sPrefetchSelection = -1;
+    sGridPrefetchTopRow = -1;
+    sGridScrollDirection = 1;
+}
+
+void drawGridCell(const Layout::PixelLayout::Grid& grid, int cell, int itemIndex, int selectedIdx)
+{
+    Titles::TitleRecord record;
+    if (!Categories::GetFilteredRecord(itemIndex, &record)) {
+        return;
+    }
+
+    const Settings::PluginSettings& settings = Settings::Get();
+    Layout::Rect icon = grid.GetIconRect(cell % grid.columns, cell / grid.columns);
+    uint64_t titleId = record.info->titleId;
+    bool isSelected = itemIndex == selectedIdx;
+
+    // The handle is looked up each frame: the cache may evict it at any time
+    Renderer::ImageHandle image = ImageLoader::IsReady(titleId) ? ImageLoader::Get(titleId)
+                                                                : Renderer::INVALID_IMAGE;
+    if (image != Renderer::INVALID_IMAGE) {
+        Renderer::DrawImage(icon.x, icon.y, image, icon.width, icon.height);
+    } else {
+        ImageLoader::Request(titleId, isSelected ? ImageLoader::Priority::HIGH : ImageLoader::Priority::NORMAL);
+        Renderer::DrawPlaceholder(icon.x, icon.y, icon.width, icon.height, GRID_PLACEHOLDER_COLOR);
+    }
+
+    if (settings.showFavorites && (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0) {
+        Renderer::DrawPlaceholder(icon.Right() - GRID_FAVORITE_MARK_SIZE, icon.y, GRID_FAVORITE_MARK_SIZE,
+                                  GRID_FAVORITE_MARK_SIZE, settings.favoriteColor);
+    }
+
+    if (isSelected) {
+        int frameX = icon.x - GRID_FRAME_OFFSET;
+        int frameY = icon.y - GRID_FRAME_OFFSET;
+        int frameSize = icon.width + GRID_FRAME_OFFSET * 2;
+        for (int line = 0; line < GRID_FRAME_THICKNESS; line++) {
+            int length = frameSize - line * 2;
+            Renderer::DrawHLine(frameX + line, frameY + line, length, settings.highlightedTitleColor);
+            Renderer::DrawHLine(frameX + line, frameY + frameSize - 1 - line, length, settings.highlightedTitleColor);
+            Renderer::DrawVLine(frameX + line, frameY + line, length, settings.highlightedTitleColor);
+            Renderer::DrawVLine(frameX + frameSize - 1 - line, frameY + line, length, settings.highlightedTitleColor);
+        }
+    }
+}
+
+void drawGridCaption(int selectedIdx)
+{
+    Titles::TitleRecord record;
+    if (!Categories::GetFilteredRecord(selectedIdx, &record)) {
+        return;
+    }
+
+    const Settings::PluginSettings& settings = Settings::Get();
+    bool isFavorite = (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0;
+    if (!record.isNameResolved) {
+        Titles::PrioritizeName(record.info->titleId);
+    }
+
+    char caption[Titles::MAX_NAME_LENGTH + 8];
+    snprintf(caption, sizeof(caption), "> %.*s%s", Renderer::GetGridWidth() - 6, record.info->name,
+             settings.showFavorites && isFavorite ? " *" : "");
+    Renderer::DrawText(1, getGridCaptionRow(), caption, settings.highlightedTitleColor);
+}
+
+void drawIconGrid(const Layout::PixelLayout::Grid& grid)
+{
+    int count = Categories::GetFilteredCount();
+    sTitleListState.itemCount = count;
+
+    if (count == 0) {
+        Renderer::DrawText(2, LIST_START_ROW, Titles::IsLoaded() ? "(empty)" : "Loading titles...");
+        return;
+    }
+
+    int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
+    int firstIdx = sGridTopRow * grid.columns;
+    for (int cell = 0; cell < grid.GetCellCount() && firstIdx + cell < count; cell++) {
+        drawGridCell(grid, cell, firstIdx + cell, selectedIdx);
+    }
+    drawGridCaption(selectedIdx);
+}
+
+// =============================================================================
+// Dirty Regions
+// =============================================================================
+// The browse screen is drawn in retained mode. Before drawing, Render()
+// fingerprints what each region is about to show and invalidates the
+// regions whose fingerprint changed since the last frame: the list one
+// row at a time, so moving the selection redraws two rows, and the grid
+// one cell at a time. Everything is still drawn; the renderer clips it to
+// the invalidated regions.
+
+constexpr uint32_t FINGERPRINT_SEED = 2166136261u;
+
+// FNV-1a
+uint32_t fingerprintBytes(uint32_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t fingerprintString(uint32_t hash, const char* text)
+{
+    return fingerprintBytes(hash, text, strlen(text) + 1);
+}
+
+template <typename T>
+uint32_t fingerprintValue(uint32_t hash, T value)
+{
+    return fingerprintBytes(hash, &value, sizeof(value));
+}
+
+// What each region showed last frame
+uint32_t sHeaderFingerprint = 0;
+std::vector<uint32_t> sListRowFingerprints;
+uint32_t sDetailsFingerprint = 0;
+uint32_t sIconFingerprint = 0;
+uint32_t sFooterFingerprint = 0;
+uint32_t sGridEmptyFingerprint = 0;
+std::vector<uint32_t> sGridCellFingerprints;
+uint32_t sGridCaptionFingerprint = 0;
+
+// Which view the screen shows; a switch redraws it all
+bool sIsGridDrawn = false;
+
+// Bumped every frame the search field is open, so its cursor redraws
+uint32_t sSearchFrameCounter = 0;
+
+void updateRegion(uint32_t& drawnFingerprint, uint32_t fingerprint, int pixelX, int pixelY,
+                  int width, int height)
+{
+    if (drawnFingerprint != fingerprint) {
+        Renderer::Invalidate(pixelX, pixelY, width, height);
+        drawnFingerprint = fingerprint;
+    }
+}
+
+uint32_t fingerprintHeader()
+{
+    uint32_t hash = fingerprintValue(FINGERPRINT_SEED, isSearchInputActive);
+    if (isSearchInputActive) {
+        return fingerprintValue(hash, sSearchFrameCounter++);
+    }
+
+    int visibleCount = Categories::GetVisibleCategoryCount();
+    hash = fingerprintValue(hash, Categories::GetCurrentCategoryIndex());
+    for (int position = 0; position < visibleCount; position++) {
+        hash = fingerprintString(hash, Categories::GetCategoryName(Categories::GetVisibleCategory(position)));
+    }
+
+    char facet[80];
+    formatFacetFilter(facet, sizeof(facet));
+    hash = fingerprintString(hash, Categories::IsFacetFilterActive() ? facet : "");
+    return fingerprintString(hash, Categories::IsSearchActive() ? Categories::GetSearchQuery() : "");
+}
+
+// What every list row depends on
+uint32_t fingerprintList(const UI::ListView::Config& listConfig)
+{
+    const Settings::PluginSettings& settings = Settings::Get();
+    int count = Categories::GetFilteredCount();
+
+    uint32_t hash = fingerprintValue(FINGERPRINT_SEED, count);
+    hash = fingerprintValue(hash, Titles::IsLoaded());
+    hash = fingerprintValue(hash, sTitleListState.scrollOffset);
+    hash = fingerprintValue(hash, sTitleListState.scrollOffset + listConfig.visibleRows < count);
+    hash = fingerprintValue(hash, settings.showNumbers);
+    hash = fingerprintValue(hash, settings.showFavorites);
+    hash = fingerprintValue(hash, settings.titleColor);
+    hash = fingerprintValue(hash, settings.highlightedTitleColor);
+    return fingerprintValue(hash, settings.favoriteColor);
+}
+
+uint32_t fingerprintListRow(uint32_t listFingerprint, int itemIndex)
+{
+    uint32_t hash = fingerprintValue(listFingerprint, itemIndex);
+    Titles::TitleRecord record;
+    if (!Categories::GetFilteredRecord(itemIndex, &record)) {
+        return hash;
+    }
+
+    hash = fingerprintValue(hash, itemIndex == sTitleListState.selectedIndex);
+    hash = fingerprintValue(hash, (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0);
+    return fingerprintString(hash, record.info->name);
+}
+
+uint32_t fingerprintDetails()
+{
+    const DetailsModel* model = getDetailsModel();
+    uint32_t hash = fingerprintValue(FINGERPRINT_SEED, model != nullptr);
+    return fingerprintValue(hash, sDetailsModel.version);
+}
+
+uint32_t fingerprintIcon(uint32_t hash, const Titles::TitleInfo* title)
+{
+    hash = fingerprintValue(hash, title ? title->titleId : 0);
+    if (!title || !ImageLoader::IsReady(title->titleId)) {
+        return hash;
+    }
+    return fingerprintValue(hash, ImageLoader::Get(title->titleId));
+}
+
+// What every grid cell depends on
+uint32_t fingerprintGrid(const Layout::PixelLayout::Grid& grid)
+{
+    const Settings::PluginSettings& settings = Settings::Get();
+    uint32_t hash = fingerprintValue(FINGERPRINT_SEED, Categories::GetFilteredCount());
+    hash = fingerprintValue(hash, sGridTopRow);
+    hash = fingerprintValue(hash, grid.iconSize);
+    hash = fingerprintValue(hash, grid.columns);
+    hash = fingerprintValue(hash, settings.showFavorites);
+    hash = fingerprintValue(hash, settings.highlightedTitleColor);
+    return fingerprintValue(hash, settings.favoriteColor);
+}
+
+uint32_t fingerprintGridCell(uint32_t gridFingerprint, int itemIndex)
+{
+    uint32_t hash = fingerprintValue(gridFingerprint, itemIndex);
+    Titles::TitleRecord record;
+    if (!Categories::GetFilteredRecord(itemIndex, &record)) {
+        return hash;
+    }
+
+    hash = fingerprintValue(hash, itemIndex == sTitleListState.selectedIndex);
+    hash = fingerprintValue(hash, (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0);
+    return fingerprintIcon(hash, record.info);
+}
+
+uint32_t fingerprintGridCaption()
+{
+    Titles::TitleRecord record;
+    int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
+    if (!Categories::GetFilteredRecord(selectedIdx, &record)) {
+        return FINGERPRINT_SEED;
+    }
+
+    const Settings::PluginSettings& settings = Settings::Get();
+    uint32_t hash = fingerprintValue(FINGERPRINT_SEED, (record.categoryMask & Settings::FAVORITE_MASK_BIT) != 0);
+    hash = fingerprintValue(hash, settings.showFavorites);
+    hash = fingerprintValue(hash, settings.highlightedTitleColor);
+    return fingerprintString(hash, record.info->name);
+}
+
+// The list one row at a time, then the details panel and its icon
+void invalidateChangedList()
+{
+    int screenWidth = Renderer::GetScreenWidth();
+    int rowHeight = Renderer::RowToPixelY(1);
+
+    UI::ListView::Config listConfig = UI::ListView::LeftPanelConfig(Renderer::GetVisibleRows());
+    uint32_t listFingerprint = fingerprintList(listConfig);
+    int listWidth = Renderer::ColToPixelX(Renderer::GetDividerCol());
+    sListRowFingerprints.resize(listConfig.visibleRows);
+    for (int row = 0; row < listConfig.visibleRows; row++) {
+        uint32_t fingerprint = fingerprintListRow(listFingerprint, sTitleListState.scrollOffset + row);
+        updateRegion(sListRowFingerprints[row], fingerprint, 0, Renderer::RowToPixelY(LIST_START_ROW + row),
+                     listWidth, rowHeight);
+    }
+
+    int count = Categories::GetFilteredCount();
+    int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
+    const Titles::TitleInfo* selected = isValidSelection(selectedIdx, count)
+                                      ? Categories::GetFilteredTitle(selectedIdx) : nullptr;
+
+    int detailsX = Renderer::ColToPixelX(Renderer::GetDividerCol() + 1);
+    int detailsY = Renderer::RowToPixelY(LIST_START_ROW);
+    updateRegion(sDetailsFingerprint, fingerprintDetails(), detailsX, detailsY,
+                 screenWidth - detailsX, Renderer::RowToPixelY(Renderer::GetFooterRow()) - detailsY);
+
+    const Layout::PixelLayout& layout = Renderer::GetLayout();
+    updateRegion(sIconFingerprint, fingerprintIcon(FINGERPRINT_SEED, selected), layout.details.icon.x,
+                 layout.details.icon.y, layout.iconSize, layout.iconSize);
+}
+
+// The grid one cell at a time, frame included, then the caption row
+void invalidateChangedGrid(const Layout::PixelLayout::Grid& grid)
+{
+    int rowHeight = Renderer::RowToPixelY(1);
+    int count = Categories::GetFilteredCount();
+
+    // The empty list's message sits above the first row of cells
+    uint32_t emptyFingerprint = fingerprintValue(FINGERPRINT_SEED, count == 0 ? 1 + Titles::IsLoaded() : 0);
+    updateRegion(sGridEmptyFingerprint, emptyFingerprint, 0, Renderer::RowToPixelY(LIST_START_ROW),
+                 Renderer::GetScreenWidth(), rowHeight);
+
+    uint32_t gridFingerprint = fingerprintGrid(grid);
+    int gap = (grid.cellSize - grid.iconSize) / 2;
+    int firstIdx = sGridTopRow * grid.columns;
+    sGridCellFingerprints.resize(grid.GetCellCount());
+    for (int cell = 0; cell < grid.GetCellCount(); cell++) {
+        Layout::Rect icon = grid.GetIconRect(cell % grid.columns, cell / grid.columns);
+        updateRegion(sGridCellFingerprints[cell], fingerprintGridCell(gridFingerprint, firstIdx + cell),
+                     icon.x - gap, icon.y - gap, grid.cellSize, grid.cellSize);
+    }
+
+    updateRegion(sGridCaptionFingerprint, fingerprintGridCaption(), 0, Renderer::RowToPixelY(getGridCaptionRow()),
+                 Renderer::GetScreenWidth(), rowHeight);
+}
+
+void invalidateChangedRegions(const Layout::PixelLayout::Grid& grid, bool isGrid, const char* footer)
+{
+    int screenWidth = Renderer::GetScreenWidth();
+    int rowHeight = Renderer::RowToPixelY(1);
+
+    updateRegion(sHeaderFingerprint, fingerprintHeader(), 0, Renderer::RowToPixelY(CATEGORY_ROW),
+                 screenWidth, Renderer::RowToPixelY(HEADER_ROW + 1) - Renderer::RowToPixelY(CATEGORY_ROW));
+
+    if (isGrid) {
+        invalidateChangedGrid(grid);
+    } else {
+        invalidateChangedList();
+    }
+
+    updateRegion(sFooterFingerprint, fingerprintString(FINGERPRINT_SEED, footer), 0,
+                 Renderer::RowToPixelY(Renderer::GetFooterRow()), screenWidth, rowHeight);
+}
+
 }
 
 void Render()
 {
-    drawCategoryBar();
-    drawHeaderDivider();
-    drawDivider();
-    drawTitleList();
-    drawDetailsPanel();
-    drawFooter();
+    const Layout::PixelLayout::Grid& grid = Renderer::GetLayout().grid;
+    bool isGrid = isGridView();
+    if (isGrid != sIsGridDrawn) {
+        sIsGridDrawn = isGrid;
+        Renderer::InvalidateAll();
+        resetPrefetch();
+    }
+
+    // The grid's icons are decoded small; the list draws the details size
+    ImageLoader::SetIconSize(isGrid ? grid.iconSize : 0);
+    if (isGrid) {
+        scrollGridToSelection(grid);
+    }
+
+    char footer[120];
+    formatFooter(footer, sizeof(footer));
+    invalidateChangedRegions(grid, isGrid, footer);
+
+    if (isSearchInputActive) {
+        // The field's cursor line takes the divider row
+        drawSearchBar();
+    } else {
+        drawCategoryBar();
+        drawHeaderDivider();
+    }
+
+    if (isGrid) {
+        prefetchGridIcons(grid);
+        drawIconGrid(grid);
+    } else {
+        drawDivider();
+        drawTitleList();
+        prefetchIcons(UI::ListView::BrowseModeConfig(Renderer::GetVisibleRows()));
+        drawDetailsPanel();
+    }
+    drawFooter(footer);
 }
 
-uint64_t HandleInput(uint32_t pressed)
+uint64_t HandleInput(uint32_t pressed, uint32_t held)
 {
+    if (isSearchInputActive) {
+        handleSearchInput(pressed);
+        return 0;
+    }
+
+    if (Buttons::Actions::SEARCH.Pressed(pressed)) {
+        sInputField.Init(Categories::MAX_SEARCH_LENGTH, TextInput::Library::ALPHA_NUMERIC);
+        sInputField.SetValue(Categories::GetSearchQuery());
+        isSearchInputActive = true;
+        return 0;
+    }
+
     int count = Categories::GetFilteredCount();
     sTitleListState.itemCount = count;
 
-    UI::ListView::Config listConfig = UI::ListView::BrowseModeConfig(Renderer::GetVisibleRows());
+    const Layout::PixelLayout::Grid& grid = Renderer::GetLayout().grid;
+    UI::ListView::Config listConfig = isGridView() ? UI::ListView::BrowseGridConfig(grid.columns, grid.rows)
+                                                   : UI::ListView::BrowseModeConfig(Renderer::GetVisibleRows());
 
-    UI::ListView::HandleInput(sTitleListState, pressed, listConfig);
+    UI::ListView::HandleInput(sTitleListState, pressed, held, listConfig);
     int selectedIdx = UI::ListView::GetSelectedIndex(sTitleListState);
 
     if (Buttons::Actions::CATEGORY_PREV.Pressed(pressed)) {
         Categories::PreviousCategory();
-        sTitleListState = UI::ListView::State();
-        clampSelection();
+        resetTitleList();
     }
     if (Buttons::Actions::CATEGORY_NEXT.Pressed(pressed)) {
         Categories::NextCategory();
+        resetTitleList();
+    }
+    if (Buttons::Actions::FACET.Pressed(pressed)) {
+        cycleFacetFilter(selectedIdx, count);
+    }
+    if (Buttons::Actions::SORT.Pressed(pressed)) {
+        int nextOrder = (static_cast<int>(Titles::GetSortOrder()) + 1) % Titles::SORT_ORDER_COUNT;
+        Titles::SetSortOrder(static_cast<Titles::SortOrder>(nextOrder));
+        Settings::Get().sortOrder = nextOrder;
+        Categories::RefreshFilter();
         sTitleListState = UI::ListView::State();
         clampSelection();
     }
@@ -304,6 +1147,18 @@ uint64_t HandleInput(uint32_t pressed)
             break;
 
         case UI::ListView::Action::CANCEL:
+            // B drops an active search, then a facet filter, then closes
+            if (Categories::IsSearchActive()) {
+                Categories::ClearSearch();
+                resetTitleList();
+                break;
+            }
+            if (Categories::IsFacetFilterActive()) {
+                sFacetStep = -1;
+                Categories::ClearFacetFilter();
+                resetTitleList();
+                break;
+            }
             sIsOpen = false;
             return 0;
 
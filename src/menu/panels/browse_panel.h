@@ -11,7 +11,7 @@ namespace Menu {
 namespace BrowsePanel {
 
 void Render();
-uint64_t HandleInput(uint32_t pressed);
+uint64_t HandleInput(uint32_t pressed, uint32_t held);
 
 }
 }
@@ -1,12 +1,18 @@
 /**
  * Debug Panel Implementation
- * Debug grid overlay for development.
+ * Debug grid overlay, frame timing, startup profile and memory pools for
+ * development.
  */
 
 #include "debug_panel.h"
 #include "../menu_state.h"
 #include "../menu.h"
+#include "../frame_timing.h"
+#include "../../utils/hook_stats.h"
+#include "../../utils/memory_budget.h"
+#include "../../utils/startup_profile.h"
 #include "../../render/renderer.h"
+#include "../../render/image_loader.h"
 #include "../../input/buttons.h"
 
 #include <cstdio>
@@ -16,8 +22,119 @@ namespace DebugPanel {
 
 using namespace Internal;
 
+namespace {
+
+// CONFIRM steps through the pages, which don't fit on one screen together
+enum class Page {
+    GRID,
+    PROFILE,
+    MEMORY,
+    COUNT
+};
+
+Page sPage = Page::GRID;
+
+// Startup figures go right of the frame timing table
+constexpr int STARTUP_COL = 40;
+
+void renderFrameTiming(int col, int row)
+{
+    Renderer::DrawTextF(col, row, 0xA6E3A1FF, "FRAME TIME (us, last %d)", FrameTiming::GetFrameCount());
+    Renderer::DrawText(col, row + 1, "Phase    min   avg   max   p99", 0x888888FF);
+
+    for (int phaseIndex = 0; phaseIndex < FrameTiming::PHASE_COUNT; phaseIndex++) {
+        FrameTiming::Phase phase = static_cast<FrameTiming::Phase>(phaseIndex);
+        FrameTiming::Stats stats;
+        FrameTiming::GetStats(phase, &stats);
+        Renderer::DrawTextF(col, row + 2 + phaseIndex, 0xCDD6F4FF, "%-6s %5u %5u %5u %5u",
+                            FrameTiming::GetPhaseName(phase),
+                            static_cast<unsigned>(stats.minUs), static_cast<unsigned>(stats.avgUs),
+                            static_cast<unsigned>(stats.maxUs), static_cast<unsigned>(stats.p99Us));
+    }
+}
+
+void renderStartupProfile(int col, int row)
+{
+    Renderer::DrawText(col, row, StartupProfile::IsFinished() ? "STARTUP (ms)" : "STARTUP (ms, running)",
+                       0xA6E3A1FF);
+
+    for (int phaseIndex = 0; phaseIndex < StartupProfile::PHASE_COUNT; phaseIndex++) {
+        StartupProfile::Phase phase = static_cast<StartupProfile::Phase>(phaseIndex);
+        if (StartupProfile::IsPhaseRecorded(phase)) {
+            Renderer::DrawTextF(col, row + 1 + phaseIndex, 0xCDD6F4FF, "%-12s %8.1f",
+                                StartupProfile::GetPhaseName(phase),
+                                StartupProfile::GetPhaseMicros(phase) / 1000.0);
+        } else {
+            Renderer::DrawTextF(col, row + 1 + phaseIndex, 0x888888FF, "%-12s %8s",
+                                StartupProfile::GetPhaseName(phase), "-");
+        }
+    }
+
+    int counterRow = row + 2 + StartupProfile::PHASE_COUNT;
+    for (int counterIndex = 0; counterIndex < StartupProfile::COUNTER_COUNT; counterIndex++) {
+        StartupProfile::Counter counter = static_cast<StartupProfile::Counter>(counterIndex);
+        Renderer::DrawTextF(col, counterRow + counterIndex, 0xCDD6F4FF, "%-12s %8u",
+                            StartupProfile::GetCounterName(counter),
+                            static_cast<unsigned>(StartupProfile::GetCounter(counter)));
+    }
+}
+
+void renderProfilePage()
+{
+    renderFrameTiming(1, 3);
+    renderStartupProfile(STARTUP_COL, 3);
+
+    if (GetScheduling() == Scheduling::COOPERATIVE) {
+        Renderer::DrawTextF(1, 12, 0xCDD6F4FF, "SCHEDULING: cooperative (%u%% duty)",
+                            static_cast<unsigned>(COOPERATIVE_DUTY_PERCENT));
+    } else {
+        Renderer::DrawText(1, 12, "SCHEDULING: exclusive", 0xCDD6F4FF);
+    }
+
+    HookStats::Stats hook = HookStats::Get();
+    Renderer::DrawTextF(1, 13, 0xCDD6F4FF, "VPAD HOOK: %u calls, avg %u ns, max %u ns",
+                        static_cast<unsigned>(hook.calls), static_cast<unsigned>(hook.avgNanos),
+                        static_cast<unsigned>(hook.maxNanos));
+}
+
+void renderMemoryPage()
+{
+    Renderer::DrawText(1, 3, "MEMORY POOLS (KB, shrunk top first)", 0xA6E3A1FF);
+
+    for (int poolIndex = 0; poolIndex < MemoryBudget::POOL_COUNT; poolIndex++) {
+        MemoryBudget::Pool pool = static_cast<MemoryBudget::Pool>(poolIndex);
+        if (MemoryBudget::IsRegistered(pool)) {
+            Renderer::DrawTextF(1, 4 + poolIndex, 0xCDD6F4FF, "%-12s %8u", MemoryBudget::GetPoolName(pool),
+                                static_cast<unsigned>(MemoryBudget::GetUsage(pool) / 1024));
+        } else {
+            Renderer::DrawTextF(1, 4 + poolIndex, 0x888888FF, "%-12s %8s", MemoryBudget::GetPoolName(pool), "-");
+        }
+    }
+
+    int totalRow = 5 + MemoryBudget::POOL_COUNT;
+    Renderer::DrawTextF(1, totalRow, 0xCDD6F4FF, "%-12s %8u", "Total",
+                        static_cast<unsigned>(MemoryBudget::GetTotalUsage() / 1024));
+    Renderer::DrawTextF(1, totalRow + 2, 0xCDD6F4FF, "RELIEVED: %u moderate, %u critical, last freed %u KB",
+                        static_cast<unsigned>(MemoryBudget::GetReliefCount(MemoryBudget::Pressure::MODERATE)),
+                        static_cast<unsigned>(MemoryBudget::GetReliefCount(MemoryBudget::Pressure::CRITICAL)),
+                        static_cast<unsigned>(MemoryBudget::GetLastFreedBytes() / 1024));
+}
+
+}
+
 void Render()
 {
+    if (sPage == Page::PROFILE) {
+        renderProfilePage();
+        Renderer::DrawText(1, Renderer::GetGridHeight() - 1, "[A:Memory] [X:Scheduling] [B:Back]", 0x888888FF);
+        return;
+    }
+    if (sPage == Page::MEMORY) {
+        renderMemoryPage();
+        Renderer::DrawText(1, Renderer::GetGridHeight() - 1, "[A:Grid] [X:Relieve] [B:Back]", 0x888888FF);
+        return;
+    }
+
     int w = Renderer::GetScreenWidth();
     int h = Renderer::GetScreenHeight();
 
@@ -69,12 +186,25 @@ void Render()
     Renderer::DrawTextF(1, 14, 0xCDD6F4FF, "                  T=%d B=%d (total %d unaccounted)",
                         (h - 432) / 2, (h - 432) / 2, h - 432);
 
-    Renderer::DrawText(1, Renderer::GetGridHeight() - 1, "[B:Back]", 0x888888FF);
+    Renderer::DrawTextF(1, 16, 0xCDD6F4FF, "ICON CACHE: %d icons, %d / %d KB",
+                        ImageLoader::GetCacheCount(),
+                        static_cast<int>(ImageLoader::GetCacheBytes() / 1024),
+                        static_cast<int>(ImageLoader::GetCacheBudget() / 1024));
+
+    Renderer::DrawText(1, Renderer::GetGridHeight() - 1, "[A:Timing] [B:Back]", 0x888888FF);
 }
 
 void HandleInput(uint32_t pressed)
 {
-    if (Buttons::Actions::CANCEL.Pressed(pressed)) {
+    if (Buttons::Actions::CONFIRM.Pressed(pressed)) {
+        sPage = static_cast<Page>((static_cast<int>(sPage) + 1) % static_cast<int>(Page::COUNT));
+    } else if (sPage == Page::PROFILE && Buttons::Actions::EDIT.Pressed(pressed)) {
+        SetScheduling(GetScheduling() == Scheduling::COOPERATIVE ? Scheduling::EXCLUSIVE
+                                                                 : Scheduling::COOPERATIVE);
+    } else if (sPage == Page::MEMORY && Buttons::Actions::EDIT.Pressed(pressed)) {
+        // What a game start would give back, to watch the pools refill
+        MemoryBudget::Relieve(MemoryBudget::Pressure::MODERATE);
+    } else if (Buttons::Actions::CANCEL.Pressed(pressed)) {
         sCurrentMode = Mode::SETTINGS;
     }
 }
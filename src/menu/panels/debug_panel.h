@@ -1,6 +1,7 @@
 /**
  * Debug Panel
- * Debug grid overlay for development.
+ * Debug grid overlay, frame timing, startup profile and memory pools for
+ * development.
  */
 
 #pragma once
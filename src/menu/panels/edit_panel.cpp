@@ -100,7 +100,7 @@ void Render()
     Renderer::DrawText(0, Renderer::GetFooterRow(), footer);
 }
 
-void HandleInput(uint32_t pressed)
+void HandleInput(uint32_t pressed, uint32_t held)
 {
     int titleIdx = UI::ListView::GetSelectedIndex(sTitleListState);
     const Titles::TitleInfo* title = Categories::GetFilteredTitle(titleIdx);
@@ -115,7 +115,7 @@ void HandleInput(uint32_t pressed)
 
     sEditCatsListState.itemCount = catCount;
 
-    UI::ListView::HandleInput(sEditCatsListState, pressed, listConfig);
+    UI::ListView::HandleInput(sEditCatsListState, pressed, held, listConfig);
     int selectedIdx = UI::ListView::GetSelectedIndex(sEditCatsListState);
 
     UI::ListView::Action action = UI::ListView::GetAction(pressed, listConfig);
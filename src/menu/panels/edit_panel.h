@@ -11,7 +11,7 @@ namespace Menu {
 namespace EditPanel {
 
 void Render();
-void HandleInput(uint32_t pressed);
+void HandleInput(uint32_t pressed, uint32_t held);
 
 }
 }
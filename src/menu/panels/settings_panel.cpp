@@ -9,6 +9,7 @@
 #include "../categories.h"
 #include "../../render/renderer.h"
 #include "../../render/measurements.h"
+#include "../../render/image_loader.h"
 #include "../../input/buttons.h"
 #include "../../storage/settings.h"
 #include "../../ui/list_view.h"
@@ -85,6 +86,24 @@ void renderSettingsMain()
                 snprintf(textBuf, sizeof(textBuf), "%s: [%s] %d", item.name, bar, brightness);
                 break;
             }
+            case SettingType::ICON_CACHE: {
+                int32_t valueKB = *getIntPtr(item.dataOffset);
+                snprintf(textBuf, sizeof(textBuf), "%s: %d MB", item.name, valueKB / 1024);
+                break;
+            }
+            case SettingType::TV_REFRESH: {
+                int32_t refresh = *getIntPtr(item.dataOffset);
+                if (refresh == Settings::TV_REFRESH_OFF) {
+                    snprintf(textBuf, sizeof(textBuf), "%s: Off", item.name);
+                } else if (refresh == Settings::TV_REFRESH_ON_CHANGE) {
+                    snprintf(textBuf, sizeof(textBuf), "%s: On change", item.name);
+                } else if (refresh > 1) {
+                    snprintf(textBuf, sizeof(textBuf), "%s: 1/%d", item.name, refresh);
+                } else {
+                    snprintf(textBuf, sizeof(textBuf), "%s: Full", item.name);
+                }
+                break;
+            }
             case SettingType::ACTION: {
                 if (item.dataOffset == ACTION_MANAGE_CATEGORIES) {
                     snprintf(textBuf, sizeof(textBuf), "%s (%d)", item.name, Settings::GetCategoryCount());
@@ -304,7 +323,7 @@ void renderSystemApps()
                       selectedIdx + 1, SYSTEM_APP_COUNT);
 }
 
-void handleSettingsMainInput(uint32_t pressed)
+void handleSettingsMainInput(uint32_t pressed, uint32_t held)
 {
     UI::ListView::Config listConfig = UI::ListView::InputOnlyConfig(
         Renderer::GetFooterRow() - LIST_START_ROW - 1);
@@ -314,7 +333,7 @@ void handleSettingsMainInput(uint32_t pressed)
 
     sSettingsListState.itemCount = SETTINGS_ITEM_COUNT;
 
-    UI::ListView::HandleInput(sSettingsListState, pressed, listConfig);
+    UI::ListView::HandleInput(sSettingsListState, pressed, held, listConfig);
     int selectedIdx = UI::ListView::GetSelectedIndex(sSettingsListState);
 
     UI::ListView::Action action = UI::ListView::GetAction(pressed, listConfig);
@@ -332,6 +351,34 @@ void handleSettingsMainInput(uint32_t pressed)
                 setBrightness((brightness % 5) + 1);
                 break;
             }
+            case SettingType::ICON_CACHE: {
+                // Double up to the maximum, then wrap to the minimum
+                int32_t* valueKB = getIntPtr(item.dataOffset);
+                if (*valueKB >= Settings::MAX_ICON_CACHE_KB) {
+                    *valueKB = Settings::MIN_ICON_CACHE_KB;
+                } else if (*valueKB * 2 > Settings::MAX_ICON_CACHE_KB) {
+                    *valueKB = Settings::MAX_ICON_CACHE_KB;
+                } else {
+                    *valueKB *= 2;
+                }
+                ImageLoader::SetCacheBudget(static_cast<size_t>(*valueKB) * 1024);
+                break;
+            }
+            case SettingType::TV_REFRESH: {
+                // Full, each slower rate, on change, off, and around again
+                int32_t* refresh = getIntPtr(item.dataOffset);
+                if (*refresh == Settings::TV_REFRESH_OFF) {
+                    *refresh = 1;
+                } else if (*refresh == Settings::TV_REFRESH_ON_CHANGE) {
+                    *refresh = Settings::TV_REFRESH_OFF;
+                } else if (*refresh >= Settings::MAX_TV_FRAME_DIVISOR) {
+                    *refresh = Settings::TV_REFRESH_ON_CHANGE;
+                } else {
+                    (*refresh)++;
+                }
+                applyTVRefresh();
+                break;
+            }
             case SettingType::COLOR:
                 break;
             case SettingType::ACTION: {
@@ -358,7 +405,7 @@ void handleSettingsMainInput(uint32_t pressed)
     }
 }
 
-void handleManageCategoriesInput(uint32_t pressed)
+void handleManageCategoriesInput(uint32_t pressed, uint32_t held)
 {
     int catCount = Settings::GetCategoryCount();
     const auto& categories = Settings::Get().categories;
@@ -372,7 +419,7 @@ void handleManageCategoriesInput(uint32_t pressed)
 
     sManageCatsListState.itemCount = catCount;
 
-    UI::ListView::HandleInput(sManageCatsListState, pressed, listConfig);
+    UI::ListView::HandleInput(sManageCatsListState, pressed, held, listConfig);
     int selectedIdx = UI::ListView::GetSelectedIndex(sManageCatsListState);
 
     if (Buttons::Actions::SETTINGS.Pressed(pressed)) {
@@ -531,7 +578,7 @@ void launchSystemApp(int appId)
     }
 }
 
-void handleColorsInput(uint32_t pressed)
+void handleColorsInput(uint32_t pressed, uint32_t held)
 {
     UI::ListView::Config listConfig = UI::ListView::InputOnlyConfig(
         Renderer::GetFooterRow() - LIST_START_ROW - 1);
@@ -540,7 +587,7 @@ void handleColorsInput(uint32_t pressed)
 
     sColorsListState.itemCount = COLOR_OPTION_COUNT;
 
-    UI::ListView::HandleInput(sColorsListState, pressed, listConfig);
+    UI::ListView::HandleInput(sColorsListState, pressed, held, listConfig);
     int selectedIdx = UI::ListView::GetSelectedIndex(sColorsListState);
 
     UI::ListView::Action action = UI::ListView::GetAction(pressed, listConfig);
@@ -560,7 +607,7 @@ void handleColorsInput(uint32_t pressed)
     }
 }
 
-void handleSystemAppsInput(uint32_t pressed)
+void handleSystemAppsInput(uint32_t pressed, uint32_t held)
 {
     UI::ListView::Config listConfig = UI::ListView::InputOnlyConfig(
         Renderer::GetFooterRow() - LIST_START_ROW - 1);
@@ -569,7 +616,7 @@ void handleSystemAppsInput(uint32_t pressed)
 
     sSystemAppsListState.itemCount = SYSTEM_APP_COUNT;
 
-    UI::ListView::HandleInput(sSystemAppsListState, pressed, listConfig);
+    UI::ListView::HandleInput(sSystemAppsListState, pressed, held, listConfig);
 
     UI::ListView::Action action = UI::ListView::GetAction(pressed, listConfig);
     switch (action) {
@@ -618,16 +665,16 @@ void HandleInput(uint32_t pressed, uint32_t held)
 {
     switch (sSettingsSubMode) {
         case SettingsSubMode::MAIN:
-            handleSettingsMainInput(pressed);
+            handleSettingsMainInput(pressed, held);
             break;
         case SettingsSubMode::MANAGE_CATS:
-            handleManageCategoriesInput(pressed);
+            handleManageCategoriesInput(pressed, held);
             break;
         case SettingsSubMode::SYSTEM_APPS:
-            handleSystemAppsInput(pressed);
+            handleSystemAppsInput(pressed, held);
             break;
         case SettingsSubMode::COLORS:
-            handleColorsInput(pressed);
+            handleColorsInput(pressed, held);
             break;
         case SettingsSubMode::COLOR_INPUT:
             handleColorInputInput(pressed, held);
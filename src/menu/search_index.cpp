@@ -0,0 +1,258 @@
+/**
+ * Title Search Index Implementation
+ *
+ * See search_index.h for usage documentation.
+ */
+
+#include "search_index.h"
+
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+namespace SearchIndex {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+constexpr int MAX_QUERY_LENGTH = 64;
+
+// Normalized names are cut at this length, which bounds their trigram count
+constexpr int MAX_INDEXED_NAME = 128;
+
+// Normalized names, back to back; nameOffsets[i]..nameOffsets[i + 1] - 1
+// is name i without its terminator
+std::vector<char> sNamePool;
+std::vector<uint32_t> sNameOffsets;
+
+// Posting lists in one array: bucket b owns
+// sPostings[sBucketStarts[b] .. sBucketStarts[b + 1])
+std::vector<uint32_t> sBucketStarts;
+std::vector<uint16_t> sPostings;
+
+// The previous query and its matches, for incremental narrowing
+char sLastQuery[MAX_QUERY_LENGTH];
+bool hasLastQuery = false;
+std::vector<uint16_t> sMatches;
+std::vector<uint16_t> sScratch;
+
+int hashTrigram(const char* trigram)
+{
+    uint32_t hash = static_cast<uint8_t>(trigram[0]);
+    hash = hash * 31 + static_cast<uint8_t>(trigram[1]);
+    hash = hash * 31 + static_cast<uint8_t>(trigram[2]);
+    hash *= 0x9E3779B1u;
+    return static_cast<int>(hash >> 22) & (TRIGRAM_BUCKETS - 1);
+}
+
+const char* getName(int nameIndex)
+{
+    return &sNamePool[sNameOffsets[nameIndex]];
+}
+
+int getNameLength(int nameIndex)
+{
+    return static_cast<int>(sNameOffsets[nameIndex + 1] - sNameOffsets[nameIndex]) - 1;
+}
+
+bool nameContains(int nameIndex, const char* normalizedQuery, int queryLength)
+{
+    if (getNameLength(nameIndex) < queryLength) {
+        return false;
+    }
+    return strstr(getName(nameIndex), normalizedQuery) != nullptr;
+}
+
+// Calls visit(bucket) once per distinct bucket among a text's trigrams
+template <typename Visitor>
+void forEachBucket(const char* text, int length, Visitor visit)
+{
+    int visitedBuckets[MAX_INDEXED_NAME];
+    int visitedCount = 0;
+
+    for (int start = 0; start + MIN_INDEXED_QUERY <= length; start++) {
+        int bucket = hashTrigram(text + start);
+
+        bool isVisited = false;
+        for (int visitedIndex = 0; visitedIndex < visitedCount; visitedIndex++) {
+            if (visitedBuckets[visitedIndex] == bucket) {
+                isVisited = true;
+                break;
+            }
+        }
+        if (isVisited) {
+            continue;
+        }
+
+        visitedBuckets[visitedCount++] = bucket;
+        visit(bucket);
+    }
+}
+
+// Intersect the posting lists of every trigram in the query, shortest
+// list first so the running candidate set stays small
+void collectIndexedCandidates(const char* normalizedQuery, int queryLength)
+{
+    int buckets[MAX_QUERY_LENGTH];
+    int bucketCount = 0;
+    forEachBucket(normalizedQuery, queryLength, [&](int bucket) {
+        buckets[bucketCount++] = bucket;
+    });
+
+    std::sort(buckets, buckets + bucketCount, [](int firstBucket, int secondBucket) {
+        return sBucketStarts[firstBucket + 1] - sBucketStarts[firstBucket] <
+               sBucketStarts[secondBucket + 1] - sBucketStarts[secondBucket];
+    });
+
+    const uint16_t* firstList = sPostings.data() + sBucketStarts[buckets[0]];
+    const uint16_t* firstEnd = sPostings.data() + sBucketStarts[buckets[0] + 1];
+    sMatches.assign(firstList, firstEnd);
+
+    for (int bucketIndex = 1; bucketIndex < bucketCount && !sMatches.empty(); bucketIndex++) {
+        const uint16_t* list = sPostings.data() + sBucketStarts[buckets[bucketIndex]];
+        const uint16_t* listEnd = sPostings.data() + sBucketStarts[buckets[bucketIndex] + 1];
+
+        sScratch.clear();
+        std::set_intersection(sMatches.begin(), sMatches.end(), list, listEnd,
+                              std::back_inserter(sScratch));
+        sMatches.swap(sScratch);
+    }
+}
+
+void keepMatching(const char* normalizedQuery, int queryLength)
+{
+    size_t keptCount = 0;
+    for (size_t matchIndex = 0; matchIndex < sMatches.size(); matchIndex++) {
+        if (nameContains(sMatches[matchIndex], normalizedQuery, queryLength)) {
+            sMatches[keptCount++] = sMatches[matchIndex];
+        }
+    }
+    sMatches.resize(keptCount);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Public Implementation
+// =============================================================================
+
+int Normalize(const char* text, char* output, int maxLength)
+{
+    int length = 0;
+    bool isPendingSpace = false;
+
+    for (const char* current = text; *current != '\0' && length < maxLength - 1; current++) {
+        char character = *current;
+        if (character >= 'A' && character <= 'Z') {
+            character = static_cast<char>(character - 'A' + 'a');
+        }
+
+        bool isWordCharacter = (character >= 'a' && character <= 'z') ||
+                               (character >= '0' && character <= '9');
+        if (!isWordCharacter) {
+            // Collapse runs of separators and drop leading ones
+            isPendingSpace = length > 0;
+            continue;
+        }
+
+        if (isPendingSpace && length < maxLength - 2) {
+            output[length++] = ' ';
+        }
+        isPendingSpace = false;
+        output[length++] = character;
+    }
+
+    output[length] = '\0';
+    return length;
+}
+
+void Build(const char* const* names, int count)
+{
+    Clear();
+    count = std::min(std::max(count, 0), 0xFFFF);
+
+    // Pass 1: normalize every name into the pool
+    sNameOffsets.resize(count + 1);
+    char normalizedName[MAX_INDEXED_NAME];
+    for (int nameIndex = 0; nameIndex < count; nameIndex++) {
+        sNameOffsets[nameIndex] = static_cast<uint32_t>(sNamePool.size());
+        const char* name = names[nameIndex] ? names[nameIndex] : "";
+        int length = Normalize(name, normalizedName, sizeof(normalizedName));
+        sNamePool.insert(sNamePool.end(), normalizedName, normalizedName + length + 1);
+    }
+    sNameOffsets[count] = static_cast<uint32_t>(sNamePool.size());
+
+    // Pass 2: count postings per bucket, then turn counts into starts
+    sBucketStarts.assign(TRIGRAM_BUCKETS + 1, 0);
+    for (int nameIndex = 0; nameIndex < count; nameIndex++) {
+        forEachBucket(getName(nameIndex), getNameLength(nameIndex), [](int bucket) {
+            sBucketStarts[bucket + 1]++;
+        });
+    }
+    for (int bucket = 0; bucket < TRIGRAM_BUCKETS; bucket++) {
+        sBucketStarts[bucket + 1] += sBucketStarts[bucket];
+    }
+
+    // Pass 3: fill; names are visited in order, so every list is sorted
+    sPostings.resize(sBucketStarts[TRIGRAM_BUCKETS]);
+    std::vector<uint32_t> fillPositions(sBucketStarts.begin(), sBucketStarts.end() - 1);
+    for (int nameIndex = 0; nameIndex < count; nameIndex++) {
+        forEachBucket(getName(nameIndex), getNameLength(nameIndex), [&](int bucket) {
+            sPostings[fillPositions[bucket]++] = static_cast<uint16_t>(nameIndex);
+        });
+    }
+}
+
+void Clear()
+{
+    sNamePool.clear();
+    sNameOffsets.clear();
+    sBucketStarts.clear();
+    sPostings.clear();
+    sMatches.clear();
+    hasLastQuery = false;
+}
+
+int GetCount()
+{
+    return sNameOffsets.empty() ? 0 : static_cast<int>(sNameOffsets.size()) - 1;
+}
+
+const std::vector<uint16_t>& Query(const char* query)
+{
+    char normalizedQuery[MAX_QUERY_LENGTH];
+    int queryLength = Normalize(query ? query : "", normalizedQuery, sizeof(normalizedQuery));
+    int count = GetCount();
+
+    bool isNarrowing = hasLastQuery &&
+                       strncmp(normalizedQuery, sLastQuery, strlen(sLastQuery)) == 0;
+
+    if (isNarrowing) {
+        // Every match of the longer query also matched the shorter one
+        keepMatching(normalizedQuery, queryLength);
+    } else if (queryLength == 0) {
+        sMatches.resize(count);
+        for (int nameIndex = 0; nameIndex < count; nameIndex++) {
+            sMatches[nameIndex] = static_cast<uint16_t>(nameIndex);
+        }
+    } else if (queryLength >= MIN_INDEXED_QUERY && count > 0) {
+        collectIndexedCandidates(normalizedQuery, queryLength);
+        keepMatching(normalizedQuery, queryLength);
+    } else {
+        sMatches.clear();
+        for (int nameIndex = 0; nameIndex < count; nameIndex++) {
+            if (nameContains(nameIndex, normalizedQuery, queryLength)) {
+                sMatches.push_back(static_cast<uint16_t>(nameIndex));
+            }
+        }
+    }
+
+    memcpy(sLastQuery, normalizedQuery, queryLength + 1);
+    hasLastQuery = true;
+    return sMatches;
+}
+
+} // namespace SearchIndex
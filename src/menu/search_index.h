@@ -0,0 +1,94 @@
+/**
+ * Title Search Index
+ *
+ * Type-ahead substring search over title names, used by Categories to
+ * narrow the browse list while the user types.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Names are normalized once (ASCII lowercase, anything that isn't a letter
+ * or digit becomes a space) into one contiguous pool. Every 3-character
+ * window of each normalized name is hashed into a bucket, and each bucket
+ * keeps a sorted list of the titles that contain one of its trigrams.
+ *
+ * A query of 3+ characters intersects the posting lists of its trigrams,
+ * then confirms each candidate with a substring check (buckets are shared,
+ * so lists can hold false positives). Shorter queries scan the pool.
+ *
+ * When a query extends the previous one (the user typed another letter),
+ * only the previous matches are re-checked, so each keystroke narrows the
+ * last result instead of searching from scratch.
+ *
+ * USAGE:
+ * ------
+ *   std::vector<const char*> names = ...;  // one per title index
+ *   SearchIndex::Build(names.data(), static_cast<int>(names.size()));
+ *
+ *   const std::vector<uint16_t>& matches = SearchIndex::Query("mario");
+ *   for (uint16_t titleIndex : matches) {
+ *       // titleIndex is an index into the names passed to Build()
+ *   }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace SearchIndex {
+
+// =============================================================================
+// Constants
+// =============================================================================
+
+// Number of trigram buckets (power of two)
+constexpr int TRIGRAM_BUCKETS = 1024;
+
+// Queries at least this long use the trigram index
+constexpr int MIN_INDEXED_QUERY = 3;
+
+// =============================================================================
+// Functions
+// =============================================================================
+
+/**
+ * Build the index over a list of names.
+ *
+ * Replaces any previous index and forgets the previous query.
+ *
+ * @param names Array of null-terminated names (nullptr entries never match)
+ * @param count Number of names (clamped to 65535)
+ */
+void Build(const char* const* names, int count);
+
+/**
+ * Free the index.
+ */
+void Clear();
+
+/**
+ * Get the number of names in the index.
+ */
+int GetCount();
+
+/**
+ * Find every name containing the query (case-insensitive, punctuation is
+ * treated as a space).
+ *
+ * @param query Search text; an empty query matches every name
+ * @return Matching name indices in ascending order, valid until the next
+ *         Query(), Build() or Clear()
+ */
+const std::vector<uint16_t>& Query(const char* query);
+
+/**
+ * Normalize text the way names and queries are matched.
+ *
+ * @param text      Input text
+ * @param output    Buffer for the normalized text
+ * @param maxLength Size of the output buffer
+ * @return Length of the normalized text
+ */
+int Normalize(const char* text, char* output, int maxLength);
+
+} // namespace SearchIndex
@@ -0,0 +1,229 @@
+/**
+ * Warm-up Scheduler Implementation
+ *
+ * See warmup.h for usage documentation.
+ */
+
+#include "warmup.h"
+#include "../render/renderer.h"
+#include "../render/image_loader.h"
+#include "../titles/titles.h"
+#include "../storage/settings.h"
+#include "../utils/startup_profile.h"
+
+#include <coreinit/time.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Warmup {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+// A step does a bounded piece of its job; returns true once the job is done
+using StepFunction = bool (*)(uint32_t budgetMicros);
+
+struct JobSpec {
+    const char* name;
+    uint32_t dependencies;   // Bits of jobs that must be done first
+    StepFunction step;
+};
+
+constexpr uint32_t jobBit(Job job)
+{
+    return 1u << static_cast<int>(job);
+}
+
+// Icons decoded ahead of the first open: about one screen of rows
+constexpr int ICON_WINDOW_ROWS = 12;
+
+// Most recently launched titles, the likeliest picks, warmed ahead of the
+// rest. Titles keeps as many name hints, and a demoted cache about as
+// many decoded icons
+constexpr int RECENT_WARM_COUNT = 8;
+
+// Glyphs rasterized per font step
+constexpr uint32_t FONT_GLYPHS_PER_STEP = 4;
+
+bool isInitialized = false;
+uint32_t doneJobs = 0;
+
+// When Update() last stepped the jobs, 0 before the first time
+OSTime lastUpdateTime = 0;
+
+bool isTitleLoadStarted = false;
+bool isChangeCheckStarted = false;
+bool isIconWindowQueued = false;
+
+// Newest first; returns how many
+int getRecentTitleIds(uint64_t* outTitleIds)
+{
+    const std::vector<uint64_t>& recent = Settings::Get().recentLaunches;
+    int count = std::min(static_cast<int>(recent.size()), RECENT_WARM_COUNT);
+    std::copy_n(recent.begin(), count, outTitleIds);
+    return count;
+}
+
+bool stepFont(uint32_t)
+{
+    return Renderer::Prewarm(FONT_GLYPHS_PER_STEP);
+}
+
+bool stepTitles(uint32_t)
+{
+    if (!isTitleLoadStarted) {
+        StartupProfile::Scope scope(StartupProfile::Phase::TITLES_START);
+        Titles::StartLoadAsync();
+        isTitleLoadStarted = true;
+    }
+
+    // Publishes what the loader thread has finished
+    Titles::Update();
+
+    // Names may still be resolving in the background; recent ones first
+    uint64_t recentIds[RECENT_WARM_COUNT];
+    int recentCount = getRecentTitleIds(recentIds);
+    for (int recentIndex = 0; recentIndex < recentCount; recentIndex++) {
+        Titles::PrioritizeName(recentIds[recentIndex]);
+    }
+    return Titles::IsLoaded();
+}
+
+// MCP is queried on the loader thread; this only starts the check and
+// publishes its outcome
+bool stepSnapshot(uint32_t)
+{
+    if (!isChangeCheckStarted) {
+        isChangeCheckStarted = true;
+        return !Titles::StartChangeCheck();
+    }
+
+    Titles::Update();
+    return Titles::GetLoadState().phase == Titles::LoadPhase::READY;
+}
+
+// The recently launched titles, then the rows around the last selection
+// in the full list, which is what the menu shows first when it reopens on
+// the All category
+void queueIconWindow()
+{
+    uint64_t recentIds[RECENT_WARM_COUNT];
+    ImageLoader::Prefetch(recentIds, getRecentTitleIds(recentIds));
+
+    int count = Titles::GetCount();
+    int firstIndex = std::max(0, std::min(Settings::Get().lastIndex - ICON_WINDOW_ROWS / 2,
+                                          count - ICON_WINDOW_ROWS));
+    int lastIndex = std::min(count, firstIndex + ICON_WINDOW_ROWS);
+
+    std::vector<uint64_t> titleIds;
+    titleIds.reserve(ICON_WINDOW_ROWS);
+    for (int titleIndex = firstIndex; titleIndex < lastIndex; titleIndex++) {
+        titleIds.push_back(Titles::GetTitleId(titleIndex));
+    }
+    ImageLoader::Prefetch(titleIds.data(), static_cast<int>(titleIds.size()));
+}
+
+bool stepIcons(uint32_t budgetMicros)
+{
+    if (!isIconWindowQueued) {
+        queueIconWindow();
+        isIconWindowQueued = true;
+        return false;
+    }
+
+    ImageLoader::Update(budgetMicros);
+
+    int pending, ready, failed, total;
+    ImageLoader::GetLoadingStats(&pending, &ready, &failed, &total);
+    if (pending > 0) {
+        return false;
+    }
+
+    // Demote() keeps the most recently used icons decoded: make those the
+    // recent titles', newest used last
+    uint64_t recentIds[RECENT_WARM_COUNT];
+    for (int recentIndex = getRecentTitleIds(recentIds) - 1; recentIndex >= 0; recentIndex--) {
+        ImageLoader::Get(recentIds[recentIndex]);
+    }
+
+    // Keep no more than a closed menu normally does while a game runs
+    ImageLoader::Demote();
+    return true;
+}
+
+const JobSpec JOBS[JOB_COUNT] = {
+    {"Font", 0, stepFont},
+    {"Titles", 0, stepTitles},
+    {"Snapshot", jobBit(Job::TITLES), stepSnapshot},
+    {"Icons", jobBit(Job::TITLES), stepIcons},
+};
+
+}
+
+// =============================================================================
+// Scheduling
+// =============================================================================
+
+void Init()
+{
+    isInitialized = true;
+    doneJobs = 0;
+    lastUpdateTime = 0;
+    isTitleLoadStarted = false;
+    isChangeCheckStarted = false;
+    isIconWindowQueued = false;
+}
+
+bool Update(uint32_t budgetMicros)
+{
+    if (!isInitialized || IsAllDone()) {
+        return false;
+    }
+
+    // The other VPADRead calls of the same frame get nothing
+    OSTime start = OSGetSystemTime();
+    if (lastUpdateTime != 0 &&
+        OSTicksToMicroseconds(start - lastUpdateTime) < MIN_UPDATE_INTERVAL_US) {
+        return true;
+    }
+    lastUpdateTime = start;
+
+    for (int jobIndex = 0; jobIndex < JOB_COUNT; jobIndex++) {
+        uint32_t bit = 1u << jobIndex;
+        const JobSpec& job = JOBS[jobIndex];
+        if ((doneJobs & bit) || (doneJobs & job.dependencies) != job.dependencies) {
+            continue;
+        }
+
+        uint32_t elapsedMicros = static_cast<uint32_t>(OSTicksToMicroseconds(OSGetSystemTime() - start));
+        if (elapsedMicros >= budgetMicros) {
+            break;
+        }
+        if (job.step(budgetMicros - elapsedMicros)) {
+            doneJobs |= bit;
+        }
+    }
+    return !IsAllDone();
+}
+
+bool IsDone(Job job)
+{
+    return (doneJobs & jobBit(job)) != 0;
+}
+
+bool IsAllDone()
+{
+    return doneJobs == (1u << JOB_COUNT) - 1;
+}
+
+const char* GetJobName(Job job)
+{
+    int jobIndex = static_cast<int>(job);
+    return jobIndex >= 0 && jobIndex < JOB_COUNT ? JOBS[jobIndex].name : "?";
+}
+
+}
@@ -0,0 +1,71 @@
+/**
+ * Warm-up Scheduler
+ *
+ * Work the menu wants done before it is first opened, moved out of
+ * INITIALIZE_PLUGIN() so the plugin adds next to nothing to console boot.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Init() queues a fixed set of jobs; nothing runs yet. Once the running
+ * application is past the menu's startup grace period, the VPADRead hook
+ * calls Update() with a small time budget. The hook runs several times a
+ * frame in many games, so Update() steps the jobs at most once per
+ * MIN_UPDATE_INTERVAL_US. Each time it gives every job whose dependencies
+ * are done one step, in the order below, until the budget is spent. A
+ * step does a bounded piece of work (a few glyphs, one icon batch) and
+ * returns whether the job is finished, so the game only ever loses a
+ * slice of a frame. Jobs that wait on a thread (title enumeration, the
+ * MCP change check) just poll.
+ *
+ * The menu doesn't rely on any job having run: opening it early does the
+ * same work itself, and a job that finds its work done finishes at once.
+ *
+ * The preset load is not a job. Parsing the JSON can't be cut into short
+ * steps, so it stays deferred to idle menu frames (see
+ * TitlePresets::DeferLoad).
+ *
+ * USAGE:
+ * ------
+ *   Warmup::Init();                        // INITIALIZE_PLUGIN
+ *   Warmup::Update(Warmup::SLICE_BUDGET_US);  // Per frame, after the grace period
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Warmup {
+
+enum class Job {
+    FONT,       // Rasterize the menu font, a few glyphs per step
+                // (Renderer::Prewarm)
+    TITLES,     // Enumerate installed titles on the loader thread,
+                // resolving recent titles' names first
+    SNAPSHOT,   // Check the loaded list against MCP on the loader
+                // thread (needs TITLES)
+    ICONS,      // Decode recent titles' icons and those around the last
+                // selection (needs TITLES)
+    COUNT
+};
+
+constexpr int JOB_COUNT = static_cast<int>(Job::COUNT);
+
+// Time given to warm-up per game frame
+constexpr uint32_t SLICE_BUDGET_US = 1000;
+
+// Shortest gap between two Update() calls that step the jobs: a 60 Hz
+// frame, less some jitter
+constexpr uint32_t MIN_UPDATE_INTERVAL_US = 15000;
+
+// Queue every job (cheap; call from INITIALIZE_PLUGIN)
+void Init();
+
+// Step the ready jobs until budgetMicros have passed. Returns true while
+// jobs remain
+bool Update(uint32_t budgetMicros);
+
+bool IsDone(Job job);
+bool IsAllDone();
+const char* GetJobName(Job job);
+
+}
@@ -3,21 +3,26 @@
  *
  * See title_presets.h for usage documentation.
  *
- * This file implements a simple JSON parser for loading title preset data
- * from the SD card. The parser is minimal and handles the specific JSON
- * schema used by the presets file.
+ * Presets come from the binary file when possible: it is read in one go
+ * and the presets point into its string pool. Otherwise this file's simple
+ * JSON parser builds the same records and pool from the JSON file, reading
+ * it through a fixed 32 KB window rather than all at once. The parser is
+ * minimal and handles the specific JSON schema used by the presets file.
  */
 
 #include "title_presets.h"
+#include "../storage/file_storage.h"
 #include "../utils/paths.h"
+#include "../utils/startup_profile.h"
+#include "../utils/trace.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cctype>
+#include <strings.h>
 #include <algorithm>
-#include <set>
-#include <string>
+#include <array>
 
 namespace TitlePresets {
 
@@ -28,12 +33,505 @@ namespace TitlePresets {
 namespace {
 
 // Array of loaded presets
-TitlePreset gPresets[MAX_PRESETS];
+std::vector<TitlePreset> gPresets;
 int gPresetCount = 0;
 bool gIsLoaded = false;
 
+// See GetGeneration()
+uint32_t gGeneration = 0;
+
+// See DeferLoad()
+bool gIsLoadPending = false;
+bool gIsLoadRequested = false;
+
+// Backing storage for the preset strings: the binary file's contents, or
+// the pool the JSON parser built
+uint8_t* gBinaryFileData = nullptr;
+size_t gBinaryFileSize = 0;
+std::vector<char> gParsedPool;
+
+// See RetainInstalled(). While a subset is retained, gParsedPool holds its
+// strings and gCoveredGameIds the IDs it was built for, sorted
+// case-insensitively
+RetentionMode gRetentionMode = RetentionMode::ALL;
+bool gIsRetainedSubset = false;
+std::vector<const char*> gCoveredGameIds;
+
 // Path to the presets file on SD card (defined in utils/paths.h)
 constexpr const char* PRESETS_FILE_PATH = Paths::PRESETS_FILE;
+constexpr const char* PRESETS_BINARY_FILE_PATH = Paths::PRESETS_BINARY_FILE;
+
+constexpr uint32_t PRESET_BINARY_MAGIC = 0x54535052;
+
+struct PresetFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t recordCount;
+    uint32_t poolSize;
+};
+
+/**
+ * A title as parsed from JSON, before its strings move into the pool.
+ */
+struct ParsedPreset {
+    char gameId[MAX_GAME_ID];
+    char name[MAX_PRESET_NAME];
+    char publisher[MAX_PUBLISHER_NAME];
+    char developer[MAX_DEVELOPER_NAME];
+    char region[MAX_REGION_NAME];
+    char genre[MAX_GENRE_NAME];
+    uint16_t releaseYear;
+    uint8_t releaseMonth;
+    uint8_t releaseDay;
+
+    ParsedPreset() : releaseYear(0), releaseMonth(0), releaseDay(0) {
+        gameId[0] = '\0';
+        name[0] = '\0';
+        publisher[0] = '\0';
+        developer[0] = '\0';
+        region[0] = '\0';
+        genre[0] = '\0';
+    }
+};
+
+// =============================================================================
+// Game ID Index
+// =============================================================================
+// Open-addressed table keyed by case-folded strings, where each slot holds
+// preset index + 1 (0 for none) of the first preset whose ID equals the
+// key, ends with it, or starts with it (4-character keys only). Every
+// suffix of every ID is a key, plus each ID's 4-character prefix, so the
+// matching rules in GetPresetByGameId() become a handful of lookups.
+
+constexpr int GAME_ID_PREFIX_LENGTH = 4;
+constexpr uint16_t NO_PRESET = 0;
+
+struct GameIdSlot {
+    // Key text (inside a preset's gameId) and length; null when empty
+    const char* key;
+    uint32_t hash;
+    uint8_t length;
+    uint16_t exactPreset;
+    uint16_t endingPreset;
+    uint16_t prefixPreset;
+};
+
+std::vector<GameIdSlot> gGameIdSlots;
+
+// =============================================================================
+// Value Dictionaries
+// =============================================================================
+// Each string facet is interned at load: one sorted list of its distinct
+// values, and per preset a value ID (index + 1, 0 for ""). Presets point at
+// the dictionary's copy, so equal values share one pointer, and the unique
+// value and stats queries just read the lists.
+
+enum ValueField {
+    PUBLISHER_FIELD,
+    DEVELOPER_FIELD,
+    GENRE_FIELD,
+    REGION_FIELD,
+    VALUE_FIELD_COUNT
+};
+
+const char* TitlePreset::* const VALUE_FIELD_MEMBERS[VALUE_FIELD_COUNT] = {
+    &TitlePreset::publisher, &TitlePreset::developer, &TitlePreset::genre, &TitlePreset::region
+};
+
+std::vector<const char*> gFieldValues[VALUE_FIELD_COUNT];
+std::vector<std::array<uint16_t, VALUE_FIELD_COUNT>> gPresetValueIds;
+
+// Distinct release years, ascending, and how many presets have one
+std::vector<uint16_t> gReleaseYears;
+int gTitlesWithReleaseDate = 0;
+
+// =============================================================================
+// Inverted Indexes
+// =============================================================================
+// Preset indices grouped by value, so a query is a binary search that
+// returns a span. String groups merge values that differ only in case,
+// matching the case-insensitive queries; "" is a group of its own.
+
+struct ValueIndex {
+    // Every preset index, grouped; ascending within a group
+    std::vector<uint16_t> presetIndices;
+
+    // Per group, in strcasecmp() order: one of its values and its start in
+    // presetIndices, plus a final end entry
+    std::vector<const char*> groupValues;
+    std::vector<uint32_t> groupStarts;
+};
+
+ValueIndex gValueIndexes[VALUE_FIELD_COUNT];
+
+// Every preset index by year (0 first, for undated ones), then index.
+// gYearStarts[i] is where gYearKeys[i] begins, plus a final end entry
+std::vector<uint16_t> gYearKeys;
+std::vector<uint16_t> gYearPresetIndices;
+std::vector<uint32_t> gYearStarts;
+
+// FNV-1a over the case-folded key, matching strncasecmp()
+uint32_t HashGameIdKey(const char* key, int length) {
+    uint32_t hash = 0x811C9DC5u;
+    for (int i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(toupper(static_cast<unsigned char>(key[i])));
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+/**
+ * Find a key's slot, or the empty slot where it would go.
+ */
+GameIdSlot* FindGameIdSlot(const char* key, int length, uint32_t hash) {
+    int slotMask = static_cast<int>(gGameIdSlots.size()) - 1;
+    int slot = hash & slotMask;
+    while (gGameIdSlots[slot].key) {
+        const GameIdSlot& candidate = gGameIdSlots[slot];
+        if (candidate.hash == hash && candidate.length == length &&
+            strncasecmp(candidate.key, key, length) == 0) {
+            break;
+        }
+        slot = (slot + 1) & slotMask;
+    }
+    return &gGameIdSlots[slot];
+}
+
+GameIdSlot* ClaimGameIdSlot(const char* key, int length) {
+    uint32_t hash = HashGameIdKey(key, length);
+    GameIdSlot* slot = FindGameIdSlot(key, length, hash);
+    if (!slot->key) {
+        slot->key = key;
+        slot->hash = hash;
+        slot->length = static_cast<uint8_t>(length);
+    }
+    return slot;
+}
+
+/**
+ * Index every preset; slots keep the first (lowest) preset for each rule,
+ * matching the order of the old linear scan.
+ */
+void BuildGameIdIndex() {
+    int keyCount = 0;
+    for (const TitlePreset& preset : gPresets) {
+        keyCount += static_cast<int>(strlen(preset.gameId)) + 1;
+    }
+
+    int slotCount = 16;
+    while (slotCount < keyCount * 2) {
+        slotCount *= 2;
+    }
+    gGameIdSlots.assign(slotCount, GameIdSlot());
+
+    for (int i = 0; i < gPresetCount; i++) {
+        const char* gameId = gPresets[i].gameId;
+        int idLength = static_cast<int>(strlen(gameId));
+        uint16_t presetNumber = static_cast<uint16_t>(i + 1);
+
+        if (idLength == 0) {
+            continue;
+        }
+
+        GameIdSlot* exactSlot = ClaimGameIdSlot(gameId, idLength);
+        if (exactSlot->exactPreset == NO_PRESET) {
+            exactSlot->exactPreset = presetNumber;
+        }
+
+        for (int start = 0; start < idLength; start++) {
+            GameIdSlot* endingSlot = ClaimGameIdSlot(gameId + start, idLength - start);
+            if (endingSlot->endingPreset == NO_PRESET) {
+                endingSlot->endingPreset = presetNumber;
+            }
+        }
+
+        if (idLength > GAME_ID_PREFIX_LENGTH) {
+            GameIdSlot* prefixSlot = ClaimGameIdSlot(gameId, GAME_ID_PREFIX_LENGTH);
+            if (prefixSlot->prefixPreset == NO_PRESET) {
+                prefixSlot->prefixPreset = presetNumber;
+            }
+        }
+    }
+}
+
+void BuildValueDictionaries() {
+    gPresetValueIds.assign(gPresetCount, {});
+
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        const char* TitlePreset::* member = VALUE_FIELD_MEMBERS[field];
+        std::vector<const char*>& values = gFieldValues[field];
+
+        values.clear();
+        for (const TitlePreset& preset : gPresets) {
+            if ((preset.*member)[0] != '\0') {
+                values.push_back(preset.*member);
+            }
+        }
+
+        auto isLess = [](const char* a, const char* b) { return strcmp(a, b) < 0; };
+        std::sort(values.begin(), values.end(), isLess);
+        values.erase(std::unique(values.begin(), values.end(),
+                                 [](const char* a, const char* b) { return strcmp(a, b) == 0; }),
+                     values.end());
+
+        for (int i = 0; i < gPresetCount; i++) {
+            TitlePreset& preset = gPresets[i];
+            if ((preset.*member)[0] == '\0') {
+                continue;
+            }
+            auto position = std::lower_bound(values.begin(), values.end(), preset.*member, isLess);
+            preset.*member = *position;
+            gPresetValueIds[i][field] = static_cast<uint16_t>(position - values.begin() + 1);
+        }
+    }
+
+    gReleaseYears.clear();
+    gTitlesWithReleaseDate = 0;
+    for (const TitlePreset& preset : gPresets) {
+        if (preset.releaseYear > 0) {
+            gReleaseYears.push_back(preset.releaseYear);
+            gTitlesWithReleaseDate++;
+        }
+    }
+    std::sort(gReleaseYears.begin(), gReleaseYears.end());
+    gReleaseYears.erase(std::unique(gReleaseYears.begin(), gReleaseYears.end()), gReleaseYears.end());
+}
+
+/**
+ * Group one field's presets by case-folded value. A counting sort over
+ * the groups keeps each group in preset order.
+ */
+void BuildValueIndex(ValueField field) {
+    const std::vector<const char*>& values = gFieldValues[field];
+    ValueIndex& index = gValueIndexes[field];
+
+    auto valueOf = [&values](uint16_t valueId) { return valueId == 0 ? "" : values[valueId - 1]; };
+
+    std::vector<uint16_t> idOrder(values.size() + 1);
+    for (size_t valueId = 0; valueId < idOrder.size(); valueId++) {
+        idOrder[valueId] = static_cast<uint16_t>(valueId);
+    }
+    std::stable_sort(idOrder.begin(), idOrder.end(), [&valueOf](uint16_t a, uint16_t b) {
+        return strcasecmp(valueOf(a), valueOf(b)) < 0;
+    });
+
+    std::vector<uint16_t> groupOfId(idOrder.size());
+    index.groupValues.clear();
+    for (uint16_t valueId : idOrder) {
+        if (index.groupValues.empty() || strcasecmp(index.groupValues.back(), valueOf(valueId)) != 0) {
+            index.groupValues.push_back(valueOf(valueId));
+        }
+        groupOfId[valueId] = static_cast<uint16_t>(index.groupValues.size() - 1);
+    }
+
+    index.groupStarts.assign(index.groupValues.size() + 1, 0);
+    for (int i = 0; i < gPresetCount; i++) {
+        index.groupStarts[groupOfId[gPresetValueIds[i][field]] + 1]++;
+    }
+    for (size_t group = 1; group < index.groupStarts.size(); group++) {
+        index.groupStarts[group] += index.groupStarts[group - 1];
+    }
+
+    std::vector<uint32_t> nextSlot(index.groupStarts.begin(), index.groupStarts.end() - 1);
+    index.presetIndices.resize(gPresetCount);
+    for (int i = 0; i < gPresetCount; i++) {
+        index.presetIndices[nextSlot[groupOfId[gPresetValueIds[i][field]]]++] = static_cast<uint16_t>(i);
+    }
+}
+
+void BuildYearIndex() {
+    gYearKeys.clear();
+    for (const TitlePreset& preset : gPresets) {
+        gYearKeys.push_back(preset.releaseYear);
+    }
+    std::sort(gYearKeys.begin(), gYearKeys.end());
+    gYearKeys.erase(std::unique(gYearKeys.begin(), gYearKeys.end()), gYearKeys.end());
+
+    auto keyOf = [](uint16_t year) {
+        return std::lower_bound(gYearKeys.begin(), gYearKeys.end(), year) - gYearKeys.begin();
+    };
+
+    gYearStarts.assign(gYearKeys.size() + 1, 0);
+    for (const TitlePreset& preset : gPresets) {
+        gYearStarts[keyOf(preset.releaseYear) + 1]++;
+    }
+    for (size_t key = 1; key < gYearStarts.size(); key++) {
+        gYearStarts[key] += gYearStarts[key - 1];
+    }
+
+    std::vector<uint32_t> nextSlot(gYearStarts.begin(), gYearStarts.end() - 1);
+    gYearPresetIndices.resize(gPresetCount);
+    for (int i = 0; i < gPresetCount; i++) {
+        gYearPresetIndices[nextSlot[keyOf(gPresets[i].releaseYear)]++] = static_cast<uint16_t>(i);
+    }
+}
+
+PresetSpan FindValueSpan(ValueField field, const char* value) {
+    const ValueIndex& index = gValueIndexes[field];
+    auto position = std::lower_bound(index.groupValues.begin(), index.groupValues.end(), value,
+                                     [](const char* a, const char* b) { return strcasecmp(a, b) < 0; });
+    if (position == index.groupValues.end() || strcasecmp(*position, value) != 0) {
+        return PresetSpan();
+    }
+
+    size_t group = position - index.groupValues.begin();
+    PresetSpan span;
+    span.indices = index.presetIndices.data() + index.groupStarts[group];
+    span.count = static_cast<int>(index.groupStarts[group + 1] - index.groupStarts[group]);
+    return span;
+}
+
+int CopyGameIds(PresetSpan span, std::vector<const char*>& outGameIds) {
+    outGameIds.resize(span.count);
+    for (int i = 0; i < span.count; i++) {
+        outGameIds[i] = gPresets[span.indices[i]].gameId;
+    }
+    return span.count;
+}
+
+const GameIdSlot* LookupGameId(const char* key, int length) {
+    if (gGameIdSlots.empty() || length <= 0 || length >= MAX_GAME_ID) {
+        return nullptr;
+    }
+    const GameIdSlot* slot = FindGameIdSlot(key, length, HashGameIdKey(key, length));
+    return slot->key ? slot : nullptr;
+}
+
+void ReleasePresets() {
+    gIsRetainedSubset = false;
+    gCoveredGameIds.clear();
+    gGameIdSlots.clear();
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        gFieldValues[field].clear();
+    }
+    gPresetValueIds.clear();
+    gReleaseYears.clear();
+    gTitlesWithReleaseDate = 0;
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        gValueIndexes[field] = ValueIndex();
+    }
+    gYearKeys.clear();
+    gYearPresetIndices.clear();
+    gYearStarts.clear();
+    gPresets.clear();
+    gPresetCount = 0;
+    gParsedPool.clear();
+    free(gBinaryFileData);
+    gBinaryFileData = nullptr;
+    gBinaryFileSize = 0;
+}
+
+template <typename T>
+void FreeVector(std::vector<T>& vector) {
+    std::vector<T>().swap(vector);
+}
+
+/**
+ * ReleasePresets() keeps the vectors' capacity for the next load; this
+ * gives it back too.
+ */
+void FreePresets() {
+    ReleasePresets();
+    FreeVector(gCoveredGameIds);
+    FreeVector(gGameIdSlots);
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        FreeVector(gFieldValues[field]);
+    }
+    FreeVector(gPresetValueIds);
+    FreeVector(gReleaseYears);
+    FreeVector(gYearKeys);
+    FreeVector(gYearPresetIndices);
+    FreeVector(gYearStarts);
+    FreeVector(gPresets);
+    FreeVector(gParsedPool);
+}
+
+/**
+ * Point gPresets at the strings in a pool. The pool must end with a NUL
+ * so every in-range offset is a terminated string.
+ *
+ * @return false if any offset lies outside the pool
+ */
+bool InstallPresets(const PresetRecord* records, int count, const char* pool, size_t poolSize) {
+    if (count > MAX_PRESETS || poolSize == 0 || pool[poolSize - 1] != '\0') {
+        return false;
+    }
+
+    gPresets.resize(count);
+    for (int i = 0; i < count; i++) {
+        const PresetRecord& record = records[i];
+        uint32_t offsets[] = { record.gameIdOffset, record.nameOffset, record.publisherOffset,
+                               record.developerOffset, record.regionOffset, record.genreOffset };
+        for (uint32_t offset : offsets) {
+            if (offset >= poolSize) {
+                gPresets.clear();
+                return false;
+            }
+        }
+
+        TitlePreset& preset = gPresets[i];
+        preset.gameId = pool + record.gameIdOffset;
+        preset.name = pool + record.nameOffset;
+        preset.publisher = pool + record.publisherOffset;
+        preset.developer = pool + record.developerOffset;
+        preset.region = pool + record.regionOffset;
+        preset.genre = pool + record.genreOffset;
+        preset.releaseYear = record.releaseYear;
+        preset.releaseMonth = record.releaseMonth;
+        preset.releaseDay = record.releaseDay;
+    }
+
+    gPresetCount = count;
+    BuildGameIdIndex();
+    BuildValueDictionaries();
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        BuildValueIndex(static_cast<ValueField>(field));
+    }
+    BuildYearIndex();
+    return true;
+}
+
+/**
+ * Load the binary preset file.
+ *
+ * @return false if it is missing or invalid
+ */
+bool LoadBinary() {
+    uint8_t* fileData = nullptr;
+    size_t fileSize = 0;
+    if (!FileStorage::ReadFile(PRESETS_BINARY_FILE_PATH, &fileData, &fileSize)) {
+        return false;
+    }
+
+    PresetFileHeader header;
+    bool isValid = fileSize >= sizeof(PresetFileHeader);
+    if (isValid) {
+        memcpy(&header, fileData, sizeof(PresetFileHeader));
+        isValid = header.magic == PRESET_BINARY_MAGIC &&
+                  header.version == PRESET_BINARY_VERSION &&
+                  header.recordSize == sizeof(PresetRecord) &&
+                  header.recordCount > 0 &&
+                  header.recordCount <= MAX_PRESETS &&
+                  fileSize == sizeof(PresetFileHeader) + header.recordCount * sizeof(PresetRecord) +
+                              header.poolSize;
+    }
+
+    if (isValid) {
+        const PresetRecord* records = reinterpret_cast<const PresetRecord*>(fileData + sizeof(PresetFileHeader));
+        const char* pool = reinterpret_cast<const char*>(records + header.recordCount);
+        isValid = InstallPresets(records, static_cast<int>(header.recordCount), pool, header.poolSize);
+    }
+
+    if (!isValid) {
+        free(fileData);
+        return false;
+    }
+
+    gBinaryFileData = fileData;
+    gBinaryFileSize = fileSize;
+    return true;
+}
 
 // =============================================================================
 // Simple JSON Parser
@@ -128,72 +626,9 @@ const char* FindKey(const char* json, const char* key) {
 }
 
 /**
- * Find the end of a JSON value (string, number, object, or array).
- */
-const char* SkipValue(const char* p) {
-    p = SkipWhitespace(p);
-
-    if (*p == '"') {
-        // String
-        p++;
-        while (*p && *p != '"') {
-            if (*p == '\\' && *(p + 1)) p++;
-            p++;
-        }
-        if (*p == '"') p++;
-    } else if (*p == '{') {
-        // Object
-        int depth = 1;
-        p++;
-        while (*p && depth > 0) {
-            if (*p == '{') depth++;
-            else if (*p == '}') depth--;
-            else if (*p == '"') {
-                p++;
-                while (*p && *p != '"') {
-                    if (*p == '\\' && *(p + 1)) p++;
-                    p++;
-                }
-            }
-            if (*p) p++;
-        }
-    } else if (*p == '[') {
-        // Array
-        int depth = 1;
-        p++;
-        while (*p && depth > 0) {
-            if (*p == '[') depth++;
-            else if (*p == ']') depth--;
-            else if (*p == '"') {
-                p++;
-                while (*p && *p != '"') {
-                    if (*p == '\\' && *(p + 1)) p++;
-                    p++;
-                }
-            }
-            if (*p) p++;
-        }
-    } else {
-        // Number, true, false, null
-        while (*p && *p != ',' && *p != '}' && *p != ']' &&
-               *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') {
-            p++;
-        }
-    }
-
-    return p;
-}
-
-/**
- * Parse a single title object from JSON.
+ * Parse a single title object from JSON (NUL-terminated after its '}').
  */
-bool ParseTitleObject(const char* objStart, const char* objEnd, TitlePreset* preset) {
-    // Create a null-terminated copy of the object
-    int objLen = objEnd - objStart;
-    char* obj = new char[objLen + 1];
-    memcpy(obj, objStart, objLen);
-    obj[objLen] = '\0';
-
+bool ParseTitleObject(const char* obj, ParsedPreset* preset) {
     bool success = false;
     char tempStr[MAX_PRESET_NAME];
 
@@ -207,7 +642,6 @@ bool ParseTitleObject(const char* objStart, const char* objEnd, TitlePreset* pre
     }
 
     if (!success) {
-        delete[] obj;
         return false;
     }
 
@@ -248,70 +682,349 @@ bool ParseTitleObject(const char* objStart, const char* objEnd, TitlePreset* pre
         ParseString(val, preset->genre, MAX_GENRE_NAME);
     }
 
-    delete[] obj;
     return true;
 }
 
 /**
- * Parse the titles array from JSON.
+ * Copy a string into a pool (offset 0 holds ""), returning its offset.
+ */
+uint32_t AddToPool(std::vector<char>& pool, const char* str) {
+    if (str[0] == '\0') {
+        return 0;
+    }
+    uint32_t offset = static_cast<uint32_t>(pool.size());
+    pool.insert(pool.end(), str, str + strlen(str) + 1);
+    return offset;
+}
+
+// =============================================================================
+// Streaming Input
+// =============================================================================
+// The JSON file is read through a fixed window, so parsing needs the same
+// memory for any database size. A title object that doesn't fit in the
+// window on its own is skipped.
+
+constexpr size_t JSON_WINDOW_SIZE = 32 * 1024;
+
+struct JsonStream {
+    FileStorage::FileReader reader;
+
+    // JSON_WINDOW_SIZE bytes plus a NUL kept after the last byte read
+    char* window;
+
+    // Unconsumed bytes are window[start, end)
+    size_t start;
+    size_t end;
+    bool isAtEnd;
+};
+
+bool IsJsonSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Move the unconsumed bytes to the front of the window and read more
+ * after them.
+ *
+ * @return false if nothing more could be read (end of file, or a full window)
  */
-int ParseTitlesArray(const char* json) {
+bool FillStream(JsonStream& stream) {
+    size_t remaining = stream.end - stream.start;
+    if (stream.isAtEnd || remaining == JSON_WINDOW_SIZE) {
+        return false;
+    }
+
+    memmove(stream.window, stream.window + stream.start, remaining);
+    size_t bytesRead = FileStorage::ReadChunk(stream.reader, stream.window + remaining,
+                                              JSON_WINDOW_SIZE - remaining);
+    stream.start = 0;
+    stream.end = remaining + bytesRead;
+    stream.window[stream.end] = '\0';
+    stream.isAtEnd = bytesRead == 0;
+    return bytesRead > 0;
+}
+
+/**
+ * Skip whitespace and return the next character, or '\0' at the end.
+ */
+char PeekToken(JsonStream& stream) {
+    for (;;) {
+        while (stream.start < stream.end && IsJsonSpace(stream.window[stream.start])) {
+            stream.start++;
+        }
+        if (stream.start < stream.end) {
+            return stream.window[stream.start];
+        }
+        if (!FillStream(stream)) {
+            return '\0';
+        }
+    }
+}
+
+/**
+ * Consume everything up to and including the first occurrence of text.
+ */
+bool SkipPast(JsonStream& stream, const char* text) {
+    size_t textLength = strlen(text);
+    for (;;) {
+        const char* found = strstr(stream.window + stream.start, text);
+        if (found) {
+            stream.start = (found - stream.window) + textLength;
+            return true;
+        }
+
+        // The tail may hold the start of a match split across reads
+        if (stream.end - stream.start >= textLength) {
+            stream.start = stream.end - (textLength - 1);
+        }
+        if (!FillStream(stream)) {
+            return false;
+        }
+    }
+}
+
+enum class ObjectScan {
+    COMPLETE,   // The whole object is in the window
+    TOO_LARGE,  // The object didn't fit; it has been consumed
+    TRUNCATED   // The file ended inside the object
+};
+
+/**
+ * Find the end of the object or string at the stream position, reading
+ * more as needed. Braces inside strings don't count.
+ *
+ * @param outLength Receives its length through the closing '}' or '"'
+ */
+ObjectScan ScanValue(JsonStream& stream, size_t& outLength) {
+    int depth = 0;
+    bool isInString = false;
+    bool isEscaped = false;
+    bool isTooLarge = false;
+    size_t length = 0;
+
+    for (;;) {
+        while (stream.start + length < stream.end) {
+            char c = stream.window[stream.start + length++];
+            bool isValueEnd = false;
+            if (isInString) {
+                if (isEscaped) {
+                    isEscaped = false;
+                } else if (c == '\\') {
+                    isEscaped = true;
+                } else if (c == '"') {
+                    isInString = false;
+                    isValueEnd = depth == 0;
+                }
+            } else if (c == '"') {
+                isInString = true;
+            } else if (c == '{') {
+                depth++;
+            } else if (c == '}') {
+                isValueEnd = --depth == 0;
+            }
+
+            if (isValueEnd) {
+                if (isTooLarge) {
+                    stream.start += length;
+                    return ObjectScan::TOO_LARGE;
+                }
+                outLength = length;
+                return ObjectScan::COMPLETE;
+            }
+        }
+
+        // A full window can't hold this value; drop what was seen so far
+        // and keep scanning for its end
+        if (stream.end - stream.start == JSON_WINDOW_SIZE) {
+            isTooLarge = true;
+            stream.start += length;
+            length = 0;
+        }
+        if (!FillStream(stream)) {
+            return ObjectScan::TRUNCATED;
+        }
+    }
+}
+
+/**
+ * Parse the titles array from the stream into records over gParsedPool.
+ */
+int ParseTitlesStream(JsonStream& stream, std::vector<PresetRecord>& outRecords) {
     int count = 0;
 
+    // Offset 0 is the shared empty string
+    gParsedPool.assign(1, '\0');
+    outRecords.clear();
+
     // Find the "titles" array
-    const char* val = FindKey(json, "titles");
-    if (!val || *val != '[') {
+    if (!SkipPast(stream, "\"titles\"") || PeekToken(stream) != ':') {
         return 0;
     }
+    stream.start++;
+    if (PeekToken(stream) != '[') {
+        return 0;
+    }
+    stream.start++;
 
-    const char* p = val + 1; // Skip '['
-    p = SkipWhitespace(p);
-
-    while (*p && *p != ']' && count < MAX_PRESETS) {
-        if (*p == '{') {
-            // Find the end of this object
-            const char* objStart = p;
-            p = SkipValue(p);
-            const char* objEnd = p;
+    while (count < MAX_PRESETS) {
+        char token = PeekToken(stream);
+        if (token == '\0' || token == ']') {
+            break;
+        }
+        if (token != '{' && token != '"') {
+            // Separators, numbers and literals
+            stream.start++;
+            continue;
+        }
 
-            TitlePreset preset;
-            if (ParseTitleObject(objStart, objEnd, &preset)) {
-                gPresets[count++] = preset;
-            }
+        size_t objectLength = 0;
+        ObjectScan scan = ScanValue(stream, objectLength);
+        if (scan == ObjectScan::TRUNCATED) {
+            break;
+        }
+        if (scan == ObjectScan::TOO_LARGE) {
+            continue;
+        }
+        if (token == '"') {
+            stream.start += objectLength;
+            continue;
         }
 
-        p = SkipWhitespace(p);
-        if (*p == ',') {
-            p++;
-            p = SkipWhitespace(p);
+        // Terminate the object in place for the key search
+        char* object = stream.window + stream.start;
+        char following = object[objectLength];
+        object[objectLength] = '\0';
+
+        ParsedPreset preset;
+        if (ParseTitleObject(object, &preset)) {
+            PresetRecord record;
+            record.gameIdOffset = AddToPool(gParsedPool, preset.gameId);
+            record.nameOffset = AddToPool(gParsedPool, preset.name);
+            record.publisherOffset = AddToPool(gParsedPool, preset.publisher);
+            record.developerOffset = AddToPool(gParsedPool, preset.developer);
+            record.regionOffset = AddToPool(gParsedPool, preset.region);
+            record.genreOffset = AddToPool(gParsedPool, preset.genre);
+            record.releaseYear = preset.releaseYear;
+            record.releaseMonth = preset.releaseMonth;
+            record.releaseDay = preset.releaseDay;
+            outRecords.push_back(record);
+            count++;
         }
+
+        object[objectLength] = following;
+        stream.start += objectLength;
     }
 
     return count;
 }
 
+bool IsGameIdCovered(const char* gameId) {
+    return std::binary_search(gCoveredGameIds.begin(), gCoveredGameIds.end(), gameId,
+                              [](const char* a, const char* b) { return strcasecmp(a, b) < 0; });
+}
+
 /**
- * Case-insensitive string comparison.
+ * Replace the loaded presets with the ones the given IDs match, keeping
+ * their order so every lookup still picks the same preset.
  */
-bool StrEqualsIgnoreCase(const char* a, const char* b) {
-    while (*a && *b) {
-        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
-            return false;
+void RetainMatching(const std::vector<const char*>& gameIds) {
+    std::vector<bool> isKept(gPresetCount, false);
+    for (const char* gameId : gameIds) {
+        int presetIndex = GetPresetIndexByGameId(gameId);
+        if (presetIndex >= 0) {
+            isKept[presetIndex] = true;
         }
-        a++;
-        b++;
     }
-    return *a == *b;
+
+    std::vector<char> pool(1, '\0');
+    std::vector<PresetRecord> records;
+    for (int i = 0; i < gPresetCount; i++) {
+        if (!isKept[i]) {
+            continue;
+        }
+
+        const TitlePreset& preset = gPresets[i];
+        PresetRecord record;
+        record.gameIdOffset = AddToPool(pool, preset.gameId);
+        record.nameOffset = AddToPool(pool, preset.name);
+        record.publisherOffset = AddToPool(pool, preset.publisher);
+        record.developerOffset = AddToPool(pool, preset.developer);
+        record.regionOffset = AddToPool(pool, preset.region);
+        record.genreOffset = AddToPool(pool, preset.genre);
+        record.releaseYear = preset.releaseYear;
+        record.releaseMonth = preset.releaseMonth;
+        record.releaseDay = preset.releaseDay;
+        records.push_back(record);
+    }
+
+    // IDs without a preset are covered too, so they don't force a reload
+    std::vector<uint32_t> coveredOffsets;
+    for (const char* gameId : gameIds) {
+        if (gameId && gameId[0] != '\0') {
+            coveredOffsets.push_back(AddToPool(pool, gameId));
+        }
+    }
+
+    ReleasePresets();
+    pool.shrink_to_fit();
+    gParsedPool.swap(pool);
+    InstallPresets(records.data(), static_cast<int>(records.size()), gParsedPool.data(), gParsedPool.size());
+
+    for (uint32_t offset : coveredOffsets) {
+        gCoveredGameIds.push_back(gParsedPool.data() + offset);
+    }
+    std::sort(gCoveredGameIds.begin(), gCoveredGameIds.end(),
+              [](const char* a, const char* b) { return strcasecmp(a, b) < 0; });
+
+    gIsRetainedSubset = true;
+    gGeneration++;
 }
 
-/**
- * Check if string 'haystack' ends with 'needle' (case-insensitive).
- */
-bool StrEndsWith(const char* haystack, const char* needle) {
-    int hLen = strlen(haystack);
-    int nLen = strlen(needle);
-    if (nLen > hLen) return false;
-    return StrEqualsIgnoreCase(haystack + (hLen - nLen), needle);
+bool LoadPresets() {
+    // Reset state
+    gIsLoadPending = false;
+    gIsLoadRequested = false;
+    ReleasePresets();
+    gIsLoaded = false;
+    gGeneration++;
+
+    // The precompiled file needs no parsing
+    if (LoadBinary()) {
+        gIsLoaded = true;
+        return true;
+    }
+
+    // Otherwise stream the JSON file through a fixed window
+    JsonStream stream;
+    if (!FileStorage::OpenReader(PRESETS_FILE_PATH, stream.reader)) {
+        return false;
+    }
+
+    stream.window = static_cast<char*>(malloc(JSON_WINDOW_SIZE + 1));
+    if (!stream.window) {
+        FileStorage::CloseReader(stream.reader);
+        return false;
+    }
+    stream.window[0] = '\0';
+    stream.start = 0;
+    stream.end = 0;
+    stream.isAtEnd = false;
+
+    std::vector<PresetRecord> records;
+    int parsedCount;
+    {
+        TRACE_SCOPE("Preset parse");
+        parsedCount = ParseTitlesStream(stream, records);
+    }
+    free(stream.window);
+    FileStorage::CloseReader(stream.reader);
+
+    if (parsedCount > 0) {
+        InstallPresets(records.data(), parsedCount, gParsedPool.data(), gParsedPool.size());
+    }
+
+    gIsLoaded = (gPresetCount > 0);
+    return gIsLoaded;
 }
 
 } // anonymous namespace
@@ -321,111 +1034,172 @@ bool StrEndsWith(const char* haystack, const char* needle) {
 // =============================================================================
 
 bool Load() {
-    // Reset state
-    gPresetCount = 0;
-    gIsLoaded = false;
+    TRACE_SCOPE("Preset load");
 
-    // Open the presets file
-    FILE* file = fopen(PRESETS_FILE_PATH, "rb");
-    if (!file) {
-        return false;
+    // Only a load during startup belongs in the startup profile
+    if (StartupProfile::IsFinished()) {
+        return LoadPresets();
     }
 
-    // Get file size
-    fseek(file, 0, SEEK_END);
-    long fileSize = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    if (fileSize <= 0 || fileSize > 4 * 1024 * 1024) { // Max 4MB
-        fclose(file);
-        return false;
+    bool isLoaded;
+    {
+        StartupProfile::Scope profileScope(StartupProfile::Phase::PRESET_LOAD);
+        isLoaded = LoadPresets();
     }
+    StartupProfile::Add(StartupProfile::Counter::PRESETS_PARSED, static_cast<uint32_t>(gPresetCount));
+    return isLoaded;
+}
+
+void DeferLoad() {
+    gIsLoadPending = true;
+}
 
-    // Read file into memory
-    char* json = new char[fileSize + 1];
-    if (fread(json, 1, fileSize, file) != (size_t)fileSize) {
-        delete[] json;
-        fclose(file);
+bool IsLoadPending() {
+    return gIsLoadPending;
+}
+
+void RequestLoad() {
+    gIsLoadRequested = gIsLoadPending;
+}
+
+bool LoadIfPending(bool isIdle) {
+    if (!gIsLoadPending || (!isIdle && !gIsLoadRequested)) {
         return false;
     }
-    json[fileSize] = '\0';
-    fclose(file);
 
-    // Parse the JSON
-    gPresetCount = ParseTitlesArray(json);
-    delete[] json;
-
-    gIsLoaded = (gPresetCount > 0);
-    return gIsLoaded;
+    Load();
+    return true;
 }
 
 bool IsLoaded() {
     return gIsLoaded;
 }
 
-int GetPresetCount() {
-    return gPresetCount;
+void Unload() {
+    if (!gIsLoaded) {
+        return;
+    }
+
+    FreePresets();
+    gIsLoaded = false;
+    gGeneration++;
+    DeferLoad();
 }
 
-void GetStats(PresetStats& stats) {
-    stats.totalPresets = gPresetCount;
-    stats.titlesWithReleaseDate = 0;
+size_t GetMemoryUsage() {
+    size_t bytes = gPresets.capacity() * sizeof(TitlePreset) + gParsedPool.capacity() + gBinaryFileSize +
+                   gCoveredGameIds.capacity() * sizeof(const char*) +
+                   gGameIdSlots.capacity() * sizeof(GameIdSlot) +
+                   gPresetValueIds.capacity() * sizeof(gPresetValueIds[0]) +
+                   gReleaseYears.capacity() * sizeof(uint16_t) +
+                   (gYearKeys.capacity() + gYearPresetIndices.capacity()) * sizeof(uint16_t) +
+                   gYearStarts.capacity() * sizeof(uint32_t);
+    for (int field = 0; field < VALUE_FIELD_COUNT; field++) {
+        const ValueIndex& index = gValueIndexes[field];
+        bytes += gFieldValues[field].capacity() * sizeof(const char*) +
+                 index.presetIndices.capacity() * sizeof(uint16_t) +
+                 index.groupValues.capacity() * sizeof(const char*) +
+                 index.groupStarts.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
 
-    std::set<std::string> publishers, developers, genres, regions;
+uint32_t GetGeneration() {
+    return gGeneration;
+}
 
-    for (int i = 0; i < gPresetCount; i++) {
-        const TitlePreset& p = gPresets[i];
+void SetRetentionMode(RetentionMode mode) {
+    gRetentionMode = mode;
+    if (mode == RetentionMode::ALL && gIsRetainedSubset) {
+        Load();
+    }
+}
 
-        if (p.publisher[0]) publishers.insert(p.publisher);
-        if (p.developer[0]) developers.insert(p.developer);
-        if (p.genre[0]) genres.insert(p.genre);
-        if (p.region[0]) regions.insert(p.region);
-        if (p.releaseYear > 0) stats.titlesWithReleaseDate++;
+void RetainInstalled(const std::vector<const char*>& gameIds) {
+    if (gRetentionMode != RetentionMode::INSTALLED_ONLY) {
+        return;
     }
 
-    stats.uniquePublishers = static_cast<int>(publishers.size());
-    stats.uniqueDevelopers = static_cast<int>(developers.size());
-    stats.uniqueGenres = static_cast<int>(genres.size());
-    stats.uniqueRegions = static_cast<int>(regions.size());
+    if (gIsRetainedSubset) {
+        bool isEveryIdCovered = true;
+        for (const char* gameId : gameIds) {
+            if (gameId && gameId[0] != '\0' && !IsGameIdCovered(gameId)) {
+                isEveryIdCovered = false;
+                break;
+            }
+        }
+        if (isEveryIdCovered) {
+            return;
+        }
+
+        // A new title may be in the part of the database we dropped
+        Load();
+    }
+
+    if (gIsLoaded) {
+        RetainMatching(gameIds);
+    }
+}
+
+int GetPresetCount() {
+    return gPresetCount;
+}
+
+void GetStats(PresetStats& stats) {
+    stats.totalPresets = gPresetCount;
+    stats.uniquePublishers = static_cast<int>(gFieldValues[PUBLISHER_FIELD].size());
+    stats.uniqueDevelopers = static_cast<int>(gFieldValues[DEVELOPER_FIELD].size());
+    stats.uniqueGenres = static_cast<int>(gFieldValues[GENRE_FIELD].size());
+    stats.uniqueRegions = static_cast<int>(gFieldValues[REGION_FIELD].size());
+    stats.titlesWithReleaseDate = gTitlesWithReleaseDate;
 }
 
 const TitlePreset* GetPresetByGameId(const char* gameId) {
+    int presetIndex = GetPresetIndexByGameId(gameId);
+    return presetIndex >= 0 ? &gPresets[presetIndex] : nullptr;
+}
+
+int GetPresetIndexByGameId(const char* gameId) {
     if (!gameId || gameId[0] == '\0') {
-        return nullptr;
+        return -1;
     }
 
     int searchLen = strlen(gameId);
-
-    for (int i = 0; i < gPresetCount; i++) {
-        const char* presetId = gPresets[i].gameId;
-
-        // Exact match
-        if (StrEqualsIgnoreCase(presetId, gameId)) {
-            return &gPresets[i];
+    int bestPreset = gPresetCount;
+
+    // Exact match, and partial match on the end of the search string:
+    // product code "WUP-P-ARDE01" should match "ARDE01". Both mean some
+    // suffix of the search string is a whole preset ID
+    for (int start = 0; start < searchLen; start++) {
+        const GameIdSlot* slot = LookupGameId(gameId + start, searchLen - start);
+        if (slot && slot->exactPreset != NO_PRESET) {
+            bestPreset = std::min(bestPreset, slot->exactPreset - 1);
         }
+    }
 
-        // Partial match: product code like "WUP-P-ARDE01" should match "ARDE01"
-        // Check if the preset's gameId matches the end of the search string
-        if (StrEndsWith(gameId, presetId)) {
-            return &gPresets[i];
-        }
+    // Also check if search string matches end of preset's gameId
+    // e.g., searching "DE01" should match preset "ARDE01"
+    const GameIdSlot* endingSlot = LookupGameId(gameId, searchLen);
+    if (endingSlot && endingSlot->endingPreset != NO_PRESET) {
+        bestPreset = std::min(bestPreset, endingSlot->endingPreset - 1);
+    }
 
-        // Also check if search string matches end of preset's gameId
-        // e.g., searching "ARDE" should match preset "ARDE01"
-        int presetLen = strlen(presetId);
-        if (searchLen <= presetLen && StrEndsWith(presetId, gameId)) {
-            return &gPresets[i];
-        }
+    if (bestPreset < gPresetCount) {
+        return bestPreset;
+    }
 
-        // Check after last hyphen in search string
-        // e.g., "WUP-P-ARDE01" -> check "ARDE01"
-        const char* lastHyphen = strrchr(gameId, '-');
-        if (lastHyphen && StrEqualsIgnoreCase(lastHyphen + 1, presetId)) {
-            return &gPresets[i];
+    // Failing those, a 4-character code like "WUP-P-ARDE" matches the
+    // first preset whose ID starts with it (e.g., "ARDE01")
+    const char* lastHyphen = strrchr(gameId, '-');
+    const char* segment = lastHyphen ? lastHyphen + 1 : gameId;
+    if (strlen(segment) == GAME_ID_PREFIX_LENGTH) {
+        const GameIdSlot* prefixSlot = LookupGameId(segment, GAME_ID_PREFIX_LENGTH);
+        if (prefixSlot && prefixSlot->prefixPreset != NO_PRESET) {
+            return prefixSlot->prefixPreset - 1;
         }
     }
 
-    return nullptr;
+    return -1;
 }
 
 const TitlePreset* GetPresetByIndex(int index) {
@@ -440,160 +1214,93 @@ const TitlePreset* GetPresetByIndex(int index) {
 // =============================================================================
 
 int GetUniquePublishers(std::vector<const char*>& outPublishers) {
-    outPublishers.clear();
-    std::set<std::string> seen;
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].publisher[0] && seen.find(gPresets[i].publisher) == seen.end()) {
-            seen.insert(gPresets[i].publisher);
-            outPublishers.push_back(gPresets[i].publisher);
-        }
-    }
-
-    // Sort alphabetically
-    std::sort(outPublishers.begin(), outPublishers.end(),
-              [](const char* a, const char* b) { return strcmp(a, b) < 0; });
-
+    outPublishers = gFieldValues[PUBLISHER_FIELD];
     return static_cast<int>(outPublishers.size());
 }
 
 int GetUniqueDevelopers(std::vector<const char*>& outDevelopers) {
-    outDevelopers.clear();
-    std::set<std::string> seen;
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].developer[0] && seen.find(gPresets[i].developer) == seen.end()) {
-            seen.insert(gPresets[i].developer);
-            outDevelopers.push_back(gPresets[i].developer);
-        }
-    }
-
-    std::sort(outDevelopers.begin(), outDevelopers.end(),
-              [](const char* a, const char* b) { return strcmp(a, b) < 0; });
-
+    outDevelopers = gFieldValues[DEVELOPER_FIELD];
     return static_cast<int>(outDevelopers.size());
 }
 
 int GetUniqueGenres(std::vector<const char*>& outGenres) {
-    outGenres.clear();
-    std::set<std::string> seen;
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].genre[0] && seen.find(gPresets[i].genre) == seen.end()) {
-            seen.insert(gPresets[i].genre);
-            outGenres.push_back(gPresets[i].genre);
-        }
-    }
-
-    std::sort(outGenres.begin(), outGenres.end(),
-              [](const char* a, const char* b) { return strcmp(a, b) < 0; });
-
+    outGenres = gFieldValues[GENRE_FIELD];
     return static_cast<int>(outGenres.size());
 }
 
 int GetUniqueRegions(std::vector<const char*>& outRegions) {
-    outRegions.clear();
-    std::set<std::string> seen;
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].region[0] && seen.find(gPresets[i].region) == seen.end()) {
-            seen.insert(gPresets[i].region);
-            outRegions.push_back(gPresets[i].region);
-        }
-    }
-
-    std::sort(outRegions.begin(), outRegions.end(),
-              [](const char* a, const char* b) { return strcmp(a, b) < 0; });
-
+    outRegions = gFieldValues[REGION_FIELD];
     return static_cast<int>(outRegions.size());
 }
 
 int GetUniqueYears(std::vector<uint16_t>& outYears) {
-    outYears.clear();
-    std::set<uint16_t> seen;
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].releaseYear > 0 && seen.find(gPresets[i].releaseYear) == seen.end()) {
-            seen.insert(gPresets[i].releaseYear);
-            outYears.push_back(gPresets[i].releaseYear);
-        }
-    }
-
-    std::sort(outYears.begin(), outYears.end());
-
+    outYears = gReleaseYears;
     return static_cast<int>(outYears.size());
 }
 
 int GetGameIdsByPublisher(const char* publisher, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (StrEqualsIgnoreCase(gPresets[i].publisher, publisher)) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
-    }
-
-    return static_cast<int>(outGameIds.size());
+    return CopyGameIds(GetPresetsByPublisher(publisher), outGameIds);
 }
 
 int GetGameIdsByDeveloper(const char* developer, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
-
-    for (int i = 0; i < gPresetCount; i++) {
-        if (StrEqualsIgnoreCase(gPresets[i].developer, developer)) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
-    }
-
-    return static_cast<int>(outGameIds.size());
+    return CopyGameIds(GetPresetsByDeveloper(developer), outGameIds);
 }
 
 int GetGameIdsByGenre(const char* genre, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
+    return CopyGameIds(GetPresetsByGenre(genre), outGameIds);
+}
 
-    for (int i = 0; i < gPresetCount; i++) {
-        if (StrEqualsIgnoreCase(gPresets[i].genre, genre)) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
-    }
+int GetGameIdsByRegion(const char* region, std::vector<const char*>& outGameIds) {
+    return CopyGameIds(GetPresetsByRegion(region), outGameIds);
+}
 
-    return static_cast<int>(outGameIds.size());
+int GetGameIdsByYear(uint16_t year, std::vector<const char*>& outGameIds) {
+    return CopyGameIds(GetPresetsByYear(year), outGameIds);
 }
 
-int GetGameIdsByRegion(const char* region, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
+int GetGameIdsByYearRange(uint16_t startYear, uint16_t endYear, std::vector<const char*>& outGameIds) {
+    // The span is grouped by year; callers of this one get preset order
+    PresetSpan span = GetPresetsByYearRange(startYear, endYear);
+    std::vector<uint16_t> presetIndices(span.indices, span.indices + span.count);
+    std::sort(presetIndices.begin(), presetIndices.end());
+    return CopyGameIds({ presetIndices.data(), span.count }, outGameIds);
+}
 
-    for (int i = 0; i < gPresetCount; i++) {
-        if (StrEqualsIgnoreCase(gPresets[i].region, region)) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
-    }
+// =============================================================================
+// Index Query Functions Implementation
+// =============================================================================
 
-    return static_cast<int>(outGameIds.size());
+PresetSpan GetPresetsByPublisher(const char* publisher) {
+    return FindValueSpan(PUBLISHER_FIELD, publisher);
 }
 
-int GetGameIdsByYear(uint16_t year, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
+PresetSpan GetPresetsByDeveloper(const char* developer) {
+    return FindValueSpan(DEVELOPER_FIELD, developer);
+}
 
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].releaseYear == year) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
-    }
+PresetSpan GetPresetsByGenre(const char* genre) {
+    return FindValueSpan(GENRE_FIELD, genre);
+}
 
-    return static_cast<int>(outGameIds.size());
+PresetSpan GetPresetsByRegion(const char* region) {
+    return FindValueSpan(REGION_FIELD, region);
 }
 
-int GetGameIdsByYearRange(uint16_t startYear, uint16_t endYear, std::vector<const char*>& outGameIds) {
-    outGameIds.clear();
+PresetSpan GetPresetsByYear(uint16_t year) {
+    return GetPresetsByYearRange(year, year);
+}
 
-    for (int i = 0; i < gPresetCount; i++) {
-        if (gPresets[i].releaseYear >= startYear && gPresets[i].releaseYear <= endYear) {
-            outGameIds.push_back(gPresets[i].gameId);
-        }
+PresetSpan GetPresetsByYearRange(uint16_t startYear, uint16_t endYear) {
+    size_t first = std::lower_bound(gYearKeys.begin(), gYearKeys.end(), startYear) - gYearKeys.begin();
+    size_t last = std::upper_bound(gYearKeys.begin(), gYearKeys.end(), endYear) - gYearKeys.begin();
+    if (first >= last) {
+        return PresetSpan();
     }
 
-    return static_cast<int>(outGameIds.size());
+    PresetSpan span;
+    span.indices = gYearPresetIndices.data() + gYearStarts[first];
+    span.count = static_cast<int>(gYearStarts[last] - gYearStarts[first]);
+    return span;
 }
 
 // =============================================================================
@@ -605,110 +1312,62 @@ int GetSuggestedCategories(PresetCategoryType type,
                            int minTitles) {
     outSuggestions.clear();
 
+    // Counts come straight from the index spans, without collecting IDs
+    auto suggest = [&outSuggestions, minTitles](const char* name, PresetSpan span) {
+        if (span.count >= minTitles) {
+            SuggestedCategory cat;
+            strncpy(cat.name, name, MAX_PUBLISHER_NAME - 1);
+            cat.name[MAX_PUBLISHER_NAME - 1] = '\0';
+            cat.titleCount = span.count;
+            outSuggestions.push_back(cat);
+        }
+    };
+
     switch (type) {
-        case PresetCategoryType::Publisher: {
-            std::vector<const char*> publishers;
-            GetUniquePublishers(publishers);
-            for (const char* pub : publishers) {
-                std::vector<const char*> gameIds;
-                GetGameIdsByPublisher(pub, gameIds);
-                if (static_cast<int>(gameIds.size()) >= minTitles) {
-                    SuggestedCategory cat;
-                    strncpy(cat.name, pub, MAX_PUBLISHER_NAME - 1);
-                    cat.name[MAX_PUBLISHER_NAME - 1] = '\0';
-                    cat.titleCount = static_cast<int>(gameIds.size());
-                    outSuggestions.push_back(cat);
-                }
+        case PresetCategoryType::Publisher:
+            for (const char* pub : gFieldValues[PUBLISHER_FIELD]) {
+                suggest(pub, GetPresetsByPublisher(pub));
             }
             break;
-        }
 
-        case PresetCategoryType::Developer: {
-            std::vector<const char*> developers;
-            GetUniqueDevelopers(developers);
-            for (const char* dev : developers) {
-                std::vector<const char*> gameIds;
-                GetGameIdsByDeveloper(dev, gameIds);
-                if (static_cast<int>(gameIds.size()) >= minTitles) {
-                    SuggestedCategory cat;
-                    strncpy(cat.name, dev, MAX_PUBLISHER_NAME - 1);
-                    cat.name[MAX_PUBLISHER_NAME - 1] = '\0';
-                    cat.titleCount = static_cast<int>(gameIds.size());
-                    outSuggestions.push_back(cat);
-                }
+        case PresetCategoryType::Developer:
+            for (const char* dev : gFieldValues[DEVELOPER_FIELD]) {
+                suggest(dev, GetPresetsByDeveloper(dev));
             }
             break;
-        }
 
-        case PresetCategoryType::Genre: {
-            std::vector<const char*> genres;
-            GetUniqueGenres(genres);
-            for (const char* genre : genres) {
-                std::vector<const char*> gameIds;
-                GetGameIdsByGenre(genre, gameIds);
-                if (static_cast<int>(gameIds.size()) >= minTitles) {
-                    SuggestedCategory cat;
-                    strncpy(cat.name, genre, MAX_PUBLISHER_NAME - 1);
-                    cat.name[MAX_PUBLISHER_NAME - 1] = '\0';
-                    cat.titleCount = static_cast<int>(gameIds.size());
-                    outSuggestions.push_back(cat);
-                }
+        case PresetCategoryType::Genre:
+            for (const char* genre : gFieldValues[GENRE_FIELD]) {
+                suggest(genre, GetPresetsByGenre(genre));
             }
             break;
-        }
 
-        case PresetCategoryType::Region: {
-            std::vector<const char*> regions;
-            GetUniqueRegions(regions);
-            for (const char* region : regions) {
-                std::vector<const char*> gameIds;
-                GetGameIdsByRegion(region, gameIds);
-                if (static_cast<int>(gameIds.size()) >= minTitles) {
-                    SuggestedCategory cat;
-                    strncpy(cat.name, region, MAX_PUBLISHER_NAME - 1);
-                    cat.name[MAX_PUBLISHER_NAME - 1] = '\0';
-                    cat.titleCount = static_cast<int>(gameIds.size());
-                    outSuggestions.push_back(cat);
-                }
+        case PresetCategoryType::Region:
+            for (const char* region : gFieldValues[REGION_FIELD]) {
+                suggest(region, GetPresetsByRegion(region));
             }
             break;
-        }
 
-        case PresetCategoryType::ReleaseYear: {
-            std::vector<uint16_t> years;
-            GetUniqueYears(years);
-            for (uint16_t year : years) {
-                std::vector<const char*> gameIds;
-                GetGameIdsByYear(year, gameIds);
-                if (static_cast<int>(gameIds.size()) >= minTitles) {
-                    SuggestedCategory cat;
-                    snprintf(cat.name, MAX_PUBLISHER_NAME, "%d", year);
-                    cat.titleCount = static_cast<int>(gameIds.size());
-                    outSuggestions.push_back(cat);
-                }
+        case PresetCategoryType::ReleaseYear:
+            for (uint16_t year : gReleaseYears) {
+                char name[8];
+                snprintf(name, sizeof(name), "%d", year);
+                suggest(name, GetPresetsByYear(year));
             }
             break;
-        }
 
         case PresetCategoryType::ReleasePeriod: {
             // Group by 2-year periods (e.g., 2012-2013, 2014-2015)
-            std::vector<uint16_t> years;
-            GetUniqueYears(years);
-            if (!years.empty()) {
-                uint16_t minYear = years.front();
-                uint16_t maxYear = years.back();
+            if (!gReleaseYears.empty()) {
+                uint16_t minYear = gReleaseYears.front();
+                uint16_t maxYear = gReleaseYears.back();
                 // Round down to even year
                 minYear = (minYear / 2) * 2;
 
                 for (uint16_t y = minYear; y <= maxYear; y += 2) {
-                    std::vector<const char*> gameIds;
-                    GetGameIdsByYearRange(y, y + 1, gameIds);
-                    if (static_cast<int>(gameIds.size()) >= minTitles) {
-                        SuggestedCategory cat;
-                        snprintf(cat.name, MAX_PUBLISHER_NAME, "%d-%d", y, y + 1);
-                        cat.titleCount = static_cast<int>(gameIds.size());
-                        outSuggestions.push_back(cat);
-                    }
+                    char name[16];
+                    snprintf(name, sizeof(name), "%d-%d", y, y + 1);
+                    suggest(name, GetPresetsByYearRange(y, y + 1));
                 }
             }
             break;
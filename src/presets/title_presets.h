@@ -18,6 +18,9 @@
  * Use the included Python converter script to transform wiiutdb.xml to JSON:
  *   python3 tools/convert_gametdb.py wiiutdb.xml TitleSwitcher_presets.json
  *
+ * The converter also writes TitleSwitcher_presets.bin next to the JSON.
+ * When that file is present, Load() uses it instead (see BINARY FORMAT).
+ *
  * JSON SCHEMA:
  * ------------
  * {
@@ -40,6 +43,36 @@
  * portion of the Wii U product code (e.g., "ARDE01" from "WUP-P-ARDE01").
  * This allows automatic matching against installed titles.
  *
+ * BINARY FORMAT:
+ * --------------
+ * The same data, laid out so it loads with one read and no parsing. All
+ * integers are big-endian (the Wii U's byte order):
+ *
+ *   header:  magic 'TSPR', version, record size, record count, pool size
+ *   records: one PresetRecord per title (string offsets, release date)
+ *   pool:    NUL-terminated UTF-8 strings, shared between records
+ *
+ * The loaded presets point straight into the pool, so nothing is copied.
+ * A file with the wrong magic or version, or offsets outside the pool, is
+ * ignored and the JSON file is parsed instead.
+ *
+ * DEFERRED LOADING:
+ * -----------------
+ * DeferLoad() keeps the SD read off the plugin's boot path. The menu then
+ * calls LoadIfPending() every frame: the load runs on the first idle
+ * frame, or on the next frame at all once RequestLoad() says a view is
+ * waiting for the data. Until then IsLoadPending() is true and lookups
+ * find nothing.
+ *
+ * INSTALLED-ONLY RETENTION:
+ * -------------------------
+ * Most of the database describes games the user doesn't own. With
+ * RetentionMode::INSTALLED_ONLY, RetainInstalled() (called by Titles when
+ * it joins presets to titles) copies the matching presets into a small
+ * pool and frees the rest. The query functions then only see installed
+ * titles. When the title list later offers a product code that wasn't
+ * part of that join, the full database is re-read from SD first.
+ *
  * USAGE:
  * ------
  *   // Load presets from SD card
@@ -62,6 +95,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -85,6 +119,17 @@ constexpr int MAX_PRESETS = 2048;
 // Current preset file version
 constexpr int PRESET_VERSION = 1;
 
+// Current binary preset file version (see BINARY FORMAT above)
+constexpr uint32_t PRESET_BINARY_VERSION = 1;
+
+/**
+ * Which presets stay loaded after RetainInstalled().
+ */
+enum class RetentionMode {
+    ALL,            // Keep the whole database
+    INSTALLED_ONLY  // Keep only presets matching installed titles
+};
+
 // =============================================================================
 // Data Structures
 // =============================================================================
@@ -94,20 +139,31 @@ constexpr int PRESET_VERSION = 1;
  *
  * Titles are identified by their GameTDB game ID (product code), which
  * can be matched against the productCode field in Titles::TitleInfo.
+ *
+ * String fields are never null; missing values are "". They point into
+ * data owned by the presets module and stay valid until the next Load().
+ * Publisher, developer, region and genre are interned: presets with the
+ * same value share one pointer.
  */
 struct TitlePreset {
     // GameTDB game ID / product code (e.g., "ARDE01", "ALZE01")
     // This matches against Titles::TitleInfo::productCode
-    char gameId[MAX_GAME_ID];
+    const char* gameId;
 
     // Display name of the title
-    char name[MAX_PRESET_NAME];
+    const char* name;
 
     // Publisher name (e.g., "Nintendo", "Capcom")
-    char publisher[MAX_PUBLISHER_NAME];
+    const char* publisher;
 
     // Developer name (e.g., "Nintendo EAD", "Platinum Games")
-    char developer[MAX_DEVELOPER_NAME];
+    const char* developer;
+
+    // Region code (e.g., "USA", "EUR", "JPN")
+    const char* region;
+
+    // Game genre (e.g., "Platformer", "RPG", "Action")
+    const char* genre;
 
     // Release year (0 if unknown)
     uint16_t releaseYear;
@@ -118,21 +174,38 @@ struct TitlePreset {
     // Release day (1-31, 0 if unknown)
     uint8_t releaseDay;
 
-    // Region code (e.g., "USA", "EUR", "JPN")
-    char region[MAX_REGION_NAME];
+    // Default constructor
+    TitlePreset()
+        : gameId(""), name(""), publisher(""), developer(""), region(""), genre(""),
+          releaseYear(0), releaseMonth(0), releaseDay(0) {}
+};
 
-    // Game genre (e.g., "Platformer", "RPG", "Action")
-    char genre[MAX_GENRE_NAME];
+/**
+ * One title as stored in the binary preset file. Strings are byte offsets
+ * into the file's string pool.
+ */
+struct PresetRecord {
+    uint32_t gameIdOffset;
+    uint32_t nameOffset;
+    uint32_t publisherOffset;
+    uint32_t developerOffset;
+    uint32_t regionOffset;
+    uint32_t genreOffset;
+    uint16_t releaseYear;
+    uint8_t releaseMonth;
+    uint8_t releaseDay;
+};
 
-    // Default constructor
-    TitlePreset() : releaseYear(0), releaseMonth(0), releaseDay(0) {
-        gameId[0] = '\0';
-        name[0] = '\0';
-        publisher[0] = '\0';
-        developer[0] = '\0';
-        region[0] = '\0';
-        genre[0] = '\0';
-    }
+/**
+ * A run of preset indices (for GetPresetByIndex()) returned by the index
+ * queries. Points into the presets module; valid until the next Load().
+ */
+struct PresetSpan {
+    const uint16_t* indices;
+    int count;
+
+    PresetSpan() : indices(nullptr), count(0) {}
+    PresetSpan(const uint16_t* spanIndices, int spanCount) : indices(spanIndices), count(spanCount) {}
 };
 
 /**
@@ -152,14 +225,42 @@ struct PresetStats {
 // =============================================================================
 
 /**
- * Load presets from the JSON file on SD card.
+ * Load presets from the SD card.
  *
- * Looks for: sd:/wiiu/plugins/config/TitleSwitcher_presets.json
+ * Reads TitleSwitcher_presets.bin if it is present and valid, otherwise
+ * parses TitleSwitcher_presets.json (both in the Aroma plugin config
+ * directory). The JSON file is streamed, so it has no size limit beyond
+ * MAX_PRESETS.
  *
  * @return true if loaded successfully, false if file not found or parse error
  */
 bool Load();
 
+/**
+ * Load later instead of now (see DEFERRED LOADING).
+ */
+void DeferLoad();
+
+/**
+ * Check if a deferred load hasn't happened yet.
+ */
+bool IsLoadPending();
+
+/**
+ * Ask for a pending deferred load to run at the next LoadIfPending(),
+ * idle or not.
+ */
+void RequestLoad();
+
+/**
+ * Run a deferred load if one is pending and the caller is idle or the
+ * load was requested.
+ *
+ * @param isIdle Whether the caller has nothing more urgent to do
+ * @return true if presets were loaded by this call
+ */
+bool LoadIfPending(bool isIdle);
+
 /**
  * Check if presets have been loaded.
  *
@@ -167,6 +268,46 @@ bool Load();
  */
 bool IsLoaded();
 
+/**
+ * Free the loaded presets and defer the next load (memory pressure).
+ *
+ * Does nothing if no presets are loaded. Bumps GetGeneration(), so
+ * caches built from presets drop them; they come back with the next
+ * LoadIfPending().
+ */
+void Unload();
+
+/**
+ * Get the bytes held by the loaded presets, their strings and indexes.
+ */
+size_t GetMemoryUsage();
+
+/**
+ * Get a counter that changes every time Load() replaces the presets.
+ *
+ * Lets caches built from preset pointers or indices notice a reload.
+ */
+uint32_t GetGeneration();
+
+/**
+ * Choose which presets RetainInstalled() keeps (default: ALL).
+ *
+ * Switching back to ALL while a subset is retained reloads the database.
+ */
+void SetRetentionMode(RetentionMode mode);
+
+/**
+ * Drop presets that no installed title matches (INSTALLED_ONLY mode).
+ *
+ * Does nothing in ALL mode, or if every ID was already covered by the
+ * previous call. If any ID is new, the full database is reloaded before
+ * the subset is rebuilt, so newly installed titles still find their
+ * presets. A change bumps GetGeneration(), as lookups return new indices.
+ *
+ * @param gameIds Product codes of every installed title
+ */
+void RetainInstalled(const std::vector<const char*>& gameIds);
+
 /**
  * Get the number of loaded presets.
  *
@@ -177,6 +318,8 @@ int GetPresetCount();
 /**
  * Get statistics about loaded presets.
  *
+ * Counts are kept from Load(), so this doesn't scan the presets.
+ *
  * @param stats Output structure to fill with statistics
  */
 void GetStats(PresetStats& stats);
@@ -185,13 +328,25 @@ void GetStats(PresetStats& stats);
  * Get preset data for a title by its game ID (product code).
  *
  * This performs partial matching to support both full product codes
- * (e.g., "WUP-P-ARDE01") and GameTDB-style IDs (e.g., "ARDE01").
+ * (e.g., "WUP-P-ARDE01") and GameTDB-style IDs (e.g., "ARDE01"). A
+ * 4-character code such as "WUP-P-ARDE" falls back to the first preset
+ * whose ID starts with it.
+ *
+ * Lookups go through a hash index built at Load(), so they cost a few
+ * probes regardless of how many presets are loaded.
  *
  * @param gameId The game ID or product code to look up
  * @return Pointer to preset data, or nullptr if not found
  */
 const TitlePreset* GetPresetByGameId(const char* gameId);
 
+/**
+ * Same as GetPresetByGameId(), returning the preset's index instead.
+ *
+ * @return Index for GetPresetByIndex(), or -1 if not found
+ */
+int GetPresetIndexByGameId(const char* gameId);
+
 /**
  * Get preset data by index (for iteration).
  *
@@ -207,6 +362,9 @@ const TitlePreset* GetPresetByIndex(int index);
 /**
  * Get a list of all unique publisher names.
  *
+ * This and the other unique value queries copy a list built at Load(),
+ * sorted by strcmp().
+ *
  * @param outPublishers Vector to receive publisher names (cleared first)
  * @return Number of unique publishers
  */
@@ -299,6 +457,25 @@ int GetGameIdsByYear(uint16_t year, std::vector<const char*>& outGameIds);
  */
 int GetGameIdsByYearRange(uint16_t startYear, uint16_t endYear, std::vector<const char*>& outGameIds);
 
+// =============================================================================
+// Index Query Functions - Zero-Allocation Variants
+// =============================================================================
+// Same matching as GetGameIdsBy*(), answered from inverted indexes built
+// at Load(): a binary search, no scan and no copy. String spans are in
+// preset order.
+
+PresetSpan GetPresetsByPublisher(const char* publisher);
+PresetSpan GetPresetsByDeveloper(const char* developer);
+PresetSpan GetPresetsByGenre(const char* genre);
+PresetSpan GetPresetsByRegion(const char* region);
+PresetSpan GetPresetsByYear(uint16_t year);
+
+/**
+ * Presets released in a year range (inclusive), ordered by year, then
+ * preset order.
+ */
+PresetSpan GetPresetsByYearRange(uint16_t startYear, uint16_t endYear);
+
 // =============================================================================
 // Category Generation Helpers
 // =============================================================================
@@ -23,7 +23,7 @@ constexpr int CHAR_COUNT = LAST_CHAR - FIRST_CHAR + 1;
 
 // 8x8 bitmap font data - classic PC/console style
 // Each character is 8 bytes (one per row), MSB is leftmost pixel
-static const uint8_t FONT_DATA[CHAR_COUNT][8] = {
+static constexpr uint8_t FONT_DATA[CHAR_COUNT][8] = {
     // 32: Space
     {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     // 33: !
@@ -216,6 +216,27 @@ static const uint8_t FONT_DATA[CHAR_COUNT][8] = {
     {0x76, 0xDC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
 };
 
+// Glyphs doubled vertically, as the menu draws them (8x16), built at
+// compile time so text drawing reads one byte per output row
+constexpr int SCALE_Y = 2;
+constexpr int SCALED_CHAR_HEIGHT = CHAR_HEIGHT * SCALE_Y;
+
+struct ScaledFont {
+    uint8_t glyphs[CHAR_COUNT][SCALED_CHAR_HEIGHT];
+};
+
+constexpr ScaledFont makeScaledFont() {
+    ScaledFont font = {};
+    for (int index = 0; index < CHAR_COUNT; index++) {
+        for (int y = 0; y < SCALED_CHAR_HEIGHT; y++) {
+            font.glyphs[index][y] = FONT_DATA[index][y / SCALE_Y];
+        }
+    }
+    return font;
+}
+
+static constexpr ScaledFont SCALED_FONT = makeScaledFont();
+
 /**
  * Get the glyph data for a character.
  * @param c Character to look up
@@ -229,6 +250,19 @@ inline const uint8_t* GetGlyph(char c) {
     return FONT_DATA[index];
 }
 
+/**
+ * Get the vertically doubled glyph data for a character.
+ * @param c Character to look up
+ * @return Pointer to 16 bytes of glyph data, or nullptr if out of range
+ */
+inline const uint8_t* GetScaledGlyph(char c) {
+    int index = static_cast<unsigned char>(c) - FIRST_CHAR;
+    if (index < 0 || index >= CHAR_COUNT) {
+        return nullptr;
+    }
+    return SCALED_FONT.glyphs[index];
+}
+
 /**
  * Check if a pixel is set in a glyph.
  * @param glyph Pointer to 8 bytes of glyph data
@@ -0,0 +1,63 @@
+/**
+ * Draw Command List Implementation
+ *
+ * See draw_list.h for usage documentation.
+ */
+
+#include "draw_list.h"
+
+#include <cstring>
+
+namespace DrawList {
+
+void List::Reset()
+{
+    commands.clear();
+    textArena.clear();
+}
+
+void List::AddText(int column, int row, const char* text, uint32_t color)
+{
+    Command command = {};
+    command.type = CommandType::TEXT;
+    command.x = column;
+    command.y = row;
+    command.color = color;
+    command.textOffset = static_cast<uint32_t>(textArena.size());
+
+    // Offsets rather than pointers, since the arena can move as it grows
+    size_t length = strlen(text);
+    textArena.insert(textArena.end(), text, text + length + 1);
+    commands.push_back(command);
+}
+
+void List::AddImage(int pixelX, int pixelY, Renderer::ImageData* image, int width, int height)
+{
+    Command command = {};
+    command.type = CommandType::IMAGE;
+    command.x = pixelX;
+    command.y = pixelY;
+    command.width = width;
+    command.height = height;
+    command.image = image;
+    commands.push_back(command);
+}
+
+void List::AddRect(CommandType type, int x, int y, int width, int height, uint32_t color)
+{
+    Command command = {};
+    command.type = type;
+    command.x = x;
+    command.y = y;
+    command.width = width;
+    command.height = height;
+    command.color = color;
+    commands.push_back(command);
+}
+
+const char* List::GetText(const Command& command) const
+{
+    return textArena.data() + command.textOffset;
+}
+
+} // namespace DrawList
@@ -0,0 +1,98 @@
+/**
+ * Draw Command List
+ *
+ * Records one frame's Renderer draw calls as plain commands, so a backend
+ * can consume the whole frame at once instead of drawing call by call.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Renderer::BeginFrame() resets the list and every Draw* call appends a
+ * command. Text is copied into the list's own arena, since callers pass
+ * stack buffers (DrawTextF). Renderer::EndFrame() walks the commands
+ * through the selected backend (OSScreen, GX2, or the web preview canvas).
+ *
+ * Reset() keeps the storage of both the commands and the text arena, so
+ * after the first few frames recording doesn't allocate.
+ *
+ * Having the frame as data is what lets draws be grouped by texture, two
+ * frames be compared, or a frame be replayed elsewhere.
+ *
+ * USAGE:
+ * ------
+ *   DrawList::List list;
+ *   list.Reset();
+ *   list.AddText(4, 2, "Favorites", 0xFFFFFFFF);
+ *   list.AddRect(DrawList::CommandType::HLINE, 0, 47, 854, 1, 0x666666FF);
+ *
+ *   for (const DrawList::Command& command : list.GetCommands()) {
+ *       if (command.type == DrawList::CommandType::TEXT) {
+ *           drawText(command.x, command.y, list.GetText(command));
+ *       }
+ *   }
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Renderer {
+struct ImageData;
+}
+
+namespace DrawList {
+
+// =============================================================================
+// Data Structures
+// =============================================================================
+
+enum class CommandType : uint8_t {
+    TEXT,           // Grid column/row, text, color
+    IMAGE,          // Pixel position, image, size (0 = image's own)
+    PLACEHOLDER,    // Filled rectangle
+    PIXEL,          // Single pixel at x, y
+    HLINE,          // width pixels to the right of x, y
+    VLINE           // height pixels down from x, y
+};
+
+struct Command {
+    CommandType type;
+    int x;
+    int y;
+    int width;
+    int height;
+    uint32_t color;
+    uint32_t textOffset;            // TEXT: start of the string in the arena
+    Renderer::ImageData* image;     // IMAGE only
+};
+
+/**
+ * One frame of commands plus the text they reference.
+ */
+struct List {
+    /**
+     * Drop every command; storage is kept for the next frame.
+     */
+    void Reset();
+
+    void AddText(int column, int row, const char* text, uint32_t color);
+    void AddImage(int pixelX, int pixelY, Renderer::ImageData* image, int width, int height);
+
+    /**
+     * Add a PLACEHOLDER, PIXEL, HLINE or VLINE command.
+     */
+    void AddRect(CommandType type, int x, int y, int width, int height, uint32_t color);
+
+    const std::vector<Command>& GetCommands() const { return commands; }
+
+    /**
+     * Get a TEXT command's string (null-terminated, valid until Reset()).
+     */
+    const char* GetText(const Command& command) const;
+
+private:
+    std::vector<Command> commands;
+    std::vector<char> textArena;
+};
+
+} // namespace DrawList
@@ -8,7 +8,8 @@
 #ifdef ENABLE_GX2_RENDERING
 
 #include "SchriftGX2.h"
-#include "shaders/Texture2DShader.h"
+#include "quad_batch.h"
+#include <algorithm>
 #include <cstring>
 #include <malloc.h>
 #include <coreinit/cache.h>
@@ -16,13 +17,86 @@
 #include <coreinit/memory.h>
 #include <gx2/mem.h>
 #include <gx2/sampler.h>
+#include <gx2/surface.h>
 #include <memory/mappedmemory.h>
 
-#pragma GCC diagnostic ignored "-Wvolatile"
-#include <glm/glm.hpp>
-
 namespace SchriftGX2 {
 
+// Empty texels kept around each glyph so linear filtering doesn't bleed
+// a neighbour into it
+static constexpr int GLYPH_PADDING = 1;
+
+// Printable ASCII, rasterized up front by PrewarmDefaultFont()
+static constexpr uint32_t PREWARM_FIRST_CODEPOINT = 0x20;
+static constexpr uint32_t PREWARM_LAST_CODEPOINT = 0x7E;
+
+// Next codepoint PrewarmDefaultFont() rasterizes
+static uint32_t sPrewarmCodepoint = PREWARM_FIRST_CODEPOINT;
+
+// Set between Init() and Shutdown(). Before that, the atlas can be written
+// (at plugin init) but only the CPU cache is flushed; Init() then has the
+// GPU re-read the pages
+static bool sIsGPUReady = false;
+
+// Counted by BeginFrame(); streaming cells drawn in the last
+// QuadBatch::FRAMES_IN_FLIGHT frames may still be read by the GPU
+static uint32_t sFrame = 0;
+
+static void flushTexels(void* texels, uint32_t size) {
+    if (sIsGPUReady) {
+        GX2Invalidate(GX2_INVALIDATE_MODE_CPU_TEXTURE, texels, size);
+    } else {
+        DCFlushRange(texels, size);
+    }
+}
+
+// =============================================================================
+// Atlas Textures
+// =============================================================================
+
+static GX2Texture* createAtlasTexture() {
+    GX2Texture* texture = (GX2Texture*)calloc(1, sizeof(GX2Texture));
+    if (!texture) {
+        return nullptr;
+    }
+
+    texture->surface.width = ATLAS_SIZE;
+    texture->surface.height = ATLAS_SIZE;
+    texture->surface.depth = 1;
+    texture->surface.dim = GX2_SURFACE_DIM_TEXTURE_2D;
+    texture->surface.format = GX2_SURFACE_FORMAT_UNORM_R8;
+    texture->surface.aa = GX2_AA_MODE1X;
+    texture->surface.use = GX2_SURFACE_USE_TEXTURE;
+    texture->surface.mipLevels = 1;
+    texture->surface.tileMode = GX2_TILE_MODE_LINEAR_ALIGNED;
+    texture->viewNumMips = 1;
+    texture->viewNumSlices = 1;
+    texture->compMap = 0x00000000; // R channel only
+
+    GX2CalcSurfaceSizeAndAlignment(&texture->surface);
+
+    texture->surface.image = MEMAllocFromMappedMemoryForGX2Ex(
+        texture->surface.imageSize,
+        texture->surface.alignment
+    );
+    if (!texture->surface.image) {
+        free(texture);
+        return nullptr;
+    }
+
+    memset(texture->surface.image, 0, texture->surface.imageSize);
+    flushTexels(texture->surface.image, texture->surface.imageSize);
+    GX2InitTextureRegs(texture);
+    return texture;
+}
+
+static void freeAtlasTexture(GX2Texture* texture) {
+    if (texture->surface.image) {
+        MEMFreeToMappedMemory(texture->surface.image);
+    }
+    free(texture);
+}
+
 // =============================================================================
 // Font Implementation
 // =============================================================================
@@ -33,7 +107,10 @@ Font::Font(const void* fontData, size_t fontDataSize, float pointSize)
     , mLineHeight(0)
     , mAscender(0)
     , mDescender(0)
+    , mStreamCellSize(ATLAS_SIZE)
 {
+    clearMeasurements();
+
     // Load font from memory
     mFont = sft_loadmem(fontData, fontDataSize);
     if (!mFont) {
@@ -55,6 +132,13 @@ Font::Font(const void* fontData, size_t fontDataSize, float pointSize)
         mDescender = (float)lmetrics.descender;
         mLineHeight = mAscender - mDescender + (float)lmetrics.lineGap;
     }
+
+    // Streaming cells fit any glyph no taller than a line
+    float cellSize = mLineHeight > pointSize ? mLineHeight : pointSize;
+    mStreamCellSize = (int)cellSize + 1 + GLYPH_PADDING;
+    if (mStreamCellSize > ATLAS_SIZE) {
+        mStreamCellSize = ATLAS_SIZE;
+    }
 }
 
 Font::~Font() {
@@ -66,63 +150,170 @@ Font::~Font() {
 }
 
 void Font::clearCache() {
-    for (auto& pair : mGlyphCache) {
-        if (pair.second.texture) {
-            // Free texture surface data
-            if (pair.second.texture->surface.image) {
-                MEMFreeToMappedMemory(pair.second.texture->surface.image);
-            }
-            free(pair.second.texture);
-        }
+    for (AtlasPage& page : mAtlasPages) {
+        freeAtlasTexture(page.texture);
+    }
+    mAtlasPages.clear();
+    for (GX2Texture* texture : mStreamPages) {
+        freeAtlasTexture(texture);
     }
+    mStreamPages.clear();
+    mStreamCells.clear();
     mGlyphCache.clear();
+    clearMeasurements();
+}
+
+void Font::clearMeasurements() {
+    for (int codepoint = 0; codepoint < ASCII_COUNT; codepoint++) {
+        mAsciiAdvance[codepoint] = -1;
+    }
+    memset(mWidthMemo, 0, sizeof(mWidthMemo));
+}
+
+Font::AtlasPage* Font::allocateGlyphRect(int width, int height, int* outX, int* outY) {
+    int paddedWidth = width + GLYPH_PADDING;
+    int paddedHeight = height + GLYPH_PADDING;
+    if (paddedWidth > ATLAS_SIZE || paddedHeight > ATLAS_SIZE) {
+        return nullptr;
+    }
+
+    AtlasPage* page = mAtlasPages.empty() ? nullptr : &mAtlasPages.back();
+    if (page && page->cursorX + paddedWidth > ATLAS_SIZE) {
+        page->shelfY += page->shelfHeight;
+        page->shelfHeight = 0;
+        page->cursorX = 0;
+    }
+    if (!page || page->shelfY + paddedHeight > ATLAS_SIZE) {
+        GX2Texture* texture = createAtlasTexture();
+        if (!texture) {
+            return nullptr;
+        }
+        mAtlasPages.push_back({ texture, 0, 0, 0 });
+        page = &mAtlasPages.back();
+    }
+
+    *outX = page->cursorX;
+    *outY = page->shelfY;
+    page->cursorX += paddedWidth;
+    if (paddedHeight > page->shelfHeight) {
+        page->shelfHeight = paddedHeight;
+    }
+    return page;
 }
 
 const GlyphData* Font::getGlyph(uint32_t codepoint) {
-    // Check cache first
-    auto it = mGlyphCache.find(codepoint);
-    if (it != mGlyphCache.end()) {
-        return &it->second;
+    GlyphData* glyph = findMetrics(codepoint);
+    if (!glyph) {
+        return nullptr;
     }
 
-    // Render and cache the glyph
-    if (renderGlyph(codepoint)) {
-        return &mGlyphCache[codepoint];
+    if (glyph->texture) {
+        if (glyph->streamCell >= 0) {
+            mStreamCells[glyph->streamCell].lastUsedFrame = sFrame;
+        }
+        return glyph;
     }
 
-    return nullptr;
+    // Empty glyphs (like space) have nothing to rasterize. A glyph that
+    // can't be placed now still advances the cursor; it is retried the
+    // next time it is drawn
+    if (glyph->width > 0 && glyph->height > 0) {
+        rasterizeGlyph(codepoint, *glyph);
+    }
+    return glyph;
 }
 
-bool Font::renderGlyph(uint32_t codepoint) {
+GlyphData* Font::findMetrics(uint32_t codepoint) {
+    auto it = mGlyphCache.find(codepoint);
+    if (it != mGlyphCache.end()) {
+        return &it->second;
+    }
+
     // Look up glyph ID
     SFT_Glyph glyph;
     if (sft_lookup(&mSft, codepoint, &glyph) < 0) {
-        return false;
+        return nullptr;
     }
 
     // Get glyph metrics
     SFT_GMetrics metrics;
     if (sft_gmetrics(&mSft, glyph, &metrics) < 0) {
-        return false;
+        return nullptr;
     }
 
-    // Create glyph data entry
     GlyphData glyphData = {};
+    glyphData.texture = nullptr;
+    glyphData.streamCell = -1;
     glyphData.width = metrics.minWidth;
     glyphData.height = metrics.minHeight;
     glyphData.offsetX = (int)metrics.leftSideBearing;
     glyphData.offsetY = metrics.yOffset;
     glyphData.advanceX = (int)metrics.advanceWidth;
+    if (codepoint < ASCII_COUNT) {
+        mAsciiAdvance[codepoint] = glyphData.advanceX;
+    }
 
-    // Handle empty glyphs (like space)
-    if (metrics.minWidth <= 0 || metrics.minHeight <= 0) {
-        glyphData.texture = nullptr;
-        mGlyphCache[codepoint] = glyphData;
-        return true;
+    return &(mGlyphCache[codepoint] = glyphData);
+}
+
+GX2Texture* Font::allocateStreamCell(uint32_t codepoint, int* outCell) {
+    // A free cell first, then a new page while under the cap, and only
+    // then the least recently drawn cell the GPU is done with
+    int best = -1;
+    for (int index = 0; index < (int)mStreamCells.size(); index++) {
+        const StreamCell& cell = mStreamCells[index];
+        if (!cell.isUsed) {
+            best = index;
+            break;
+        }
+        if (sFrame - cell.lastUsedFrame < QuadBatch::FRAMES_IN_FLIGHT) {
+            continue;
+        }
+        if (best < 0 || cell.lastUsedFrame < mStreamCells[best].lastUsedFrame) {
+            best = index;
+        }
+    }
+
+    bool hasFreeCell = best >= 0 && !mStreamCells[best].isUsed;
+    if (!hasFreeCell && (int)mStreamPages.size() < STREAM_PAGE_COUNT) {
+        GX2Texture* texture = createAtlasTexture();
+        if (texture) {
+            int cellsPerRow = ATLAS_SIZE / mStreamCellSize;
+            best = (int)mStreamCells.size();
+            mStreamPages.push_back(texture);
+            mStreamCells.resize(mStreamCells.size() + cellsPerRow * cellsPerRow, { 0, 0, false });
+        }
+    }
+    if (best < 0) {
+        return nullptr;
+    }
+
+    StreamCell& cell = mStreamCells[best];
+    if (cell.isUsed) {
+        // Evicted glyphs keep their metrics, so measuring them stays free
+        GlyphData& evicted = mGlyphCache[cell.codepoint];
+        evicted.texture = nullptr;
+        evicted.streamCell = -1;
+    }
+    cell = { codepoint, sFrame, true };
+
+    *outCell = best;
+    return streamCellPage(best);
+}
+
+GX2Texture* Font::streamCellPage(int cellIndex) const {
+    int cellsPerRow = ATLAS_SIZE / mStreamCellSize;
+    return mStreamPages[cellIndex / (cellsPerRow * cellsPerRow)];
+}
+
+bool Font::rasterizeGlyph(uint32_t codepoint, GlyphData& glyphData) {
+    SFT_Glyph glyph;
+    if (sft_lookup(&mSft, codepoint, &glyph) < 0) {
+        return false;
     }
 
     // Allocate render buffer (8-bit grayscale)
-    size_t bufferSize = metrics.minWidth * metrics.minHeight;
+    size_t bufferSize = glyphData.width * glyphData.height;
     uint8_t* buffer = (uint8_t*)malloc(bufferSize);
     if (!buffer) {
         return false;
@@ -132,76 +323,139 @@ bool Font::renderGlyph(uint32_t codepoint) {
     // Render glyph to buffer
     SFT_Image image;
     image.pixels = buffer;
-    image.width = metrics.minWidth;
-    image.height = metrics.minHeight;
+    image.width = glyphData.width;
+    image.height = glyphData.height;
 
     if (sft_render(&mSft, glyph, image) < 0) {
         free(buffer);
         return false;
     }
 
-    // Create GX2 texture (R8 format for grayscale)
-    GX2Texture* texture = (GX2Texture*)calloc(1, sizeof(GX2Texture));
-    if (!texture) {
-        free(buffer);
-        return false;
+    // ASCII is packed for good; anything else streams through the bounded
+    // cells, unless it is too big for one
+    GX2Texture* texture = nullptr;
+    int atlasX = 0;
+    int atlasY = 0;
+    int streamCell = -1;
+    int paddedSize = (glyphData.width > glyphData.height ? glyphData.width : glyphData.height) + GLYPH_PADDING;
+    bool isStreamed = codepoint >= ASCII_COUNT && paddedSize <= mStreamCellSize;
+
+    int clearSize = 0;
+    if (isStreamed) {
+        // Every cell drawn too recently to reuse, or out of memory
+        texture = allocateStreamCell(codepoint, &streamCell);
+        if (!texture) {
+            free(buffer);
+            return false;
+        }
+        int cellsPerRow = ATLAS_SIZE / mStreamCellSize;
+        int cellInPage = streamCell % (cellsPerRow * cellsPerRow);
+        atlasX = (cellInPage % cellsPerRow) * mStreamCellSize;
+        atlasY = (cellInPage / cellsPerRow) * mStreamCellSize;
+        // An evicted glyph's texels would bleed into the padding
+        clearSize = mStreamCellSize;
+    } else {
+        AtlasPage* page = allocateGlyphRect(glyphData.width, glyphData.height, &atlasX, &atlasY);
+        if (!page) {
+            free(buffer);
+            return false;
+        }
+        texture = page->texture;
     }
 
-    texture->surface.width = metrics.minWidth;
-    texture->surface.height = metrics.minHeight;
-    texture->surface.depth = 1;
-    texture->surface.dim = GX2_SURFACE_DIM_TEXTURE_2D;
-    texture->surface.format = GX2_SURFACE_FORMAT_UNORM_R8;
-    texture->surface.aa = GX2_AA_MODE1X;
-    texture->surface.use = GX2_SURFACE_USE_TEXTURE;
-    texture->surface.mipLevels = 1;
-    texture->surface.tileMode = GX2_TILE_MODE_LINEAR_ALIGNED;
-    texture->viewNumMips = 1;
-    texture->viewNumSlices = 1;
-    texture->compMap = 0x00000000; // R channel only
+    // Copy the glyph into its rectangle, then flush just those rows
+    uint32_t pitch = texture->surface.pitch;
+    uint8_t* dst = (uint8_t*)texture->surface.image + atlasY * pitch + atlasX;
 
-    // Calculate surface info
-    GX2CalcSurfaceSizeAndAlignment(&texture->surface);
+    for (int y = 0; y < clearSize; y++) {
+        memset(dst + y * pitch, 0, clearSize);
+    }
+    for (int y = 0; y < glyphData.height; y++) {
+        memcpy(dst + y * pitch, buffer + y * glyphData.width, glyphData.width);
+    }
+    int rowCount = clearSize > glyphData.height ? clearSize : glyphData.height;
+    flushTexels((uint8_t*)texture->surface.image + atlasY * pitch, rowCount * pitch);
 
-    // Allocate texture memory
-    texture->surface.image = MEMAllocFromMappedMemoryForGX2Ex(
-        texture->surface.imageSize,
-        texture->surface.alignment
-    );
+    free(buffer);
 
-    if (!texture->surface.image) {
-        free(texture);
-        free(buffer);
-        return false;
-    }
+    glyphData.texture = texture;
+    glyphData.streamCell = streamCell;
+    glyphData.texCoords = {
+        (float)atlasX / ATLAS_SIZE,
+        (float)atlasY / ATLAS_SIZE,
+        (float)(atlasX + glyphData.width) / ATLAS_SIZE,
+        (float)(atlasY + glyphData.height) / ATLAS_SIZE
+    };
 
-    // Copy glyph data to texture
-    // Need to handle pitch alignment
-    uint32_t pitch = texture->surface.pitch;
-    uint8_t* dst = (uint8_t*)texture->surface.image;
+    return true;
+}
 
-    for (int y = 0; y < metrics.minHeight; y++) {
-        memcpy(dst + y * pitch, buffer + y * metrics.minWidth, metrics.minWidth);
+bool Font::prewarm(uint32_t firstCodepoint, uint32_t lastCodepoint) {
+    bool isComplete = true;
+    for (uint32_t codepoint = firstCodepoint; codepoint <= lastCodepoint; codepoint++) {
+        const GlyphData* glyph = getGlyph(codepoint);
+        bool hasTexels = glyph && glyph->width > 0 && glyph->height > 0;
+        if (!glyph || (hasTexels && !glyph->texture)) {
+            isComplete = false;
+        }
     }
+    return isComplete;
+}
 
-    // Flush cache
-    GX2Invalidate(GX2_INVALIDATE_MODE_CPU_TEXTURE, texture->surface.image, texture->surface.imageSize);
+void Font::invalidateTextures() {
+    for (AtlasPage& page : mAtlasPages) {
+        GX2Invalidate(GX2_INVALIDATE_MODE_TEXTURE, page.texture->surface.image,
+                      page.texture->surface.imageSize);
+    }
+    for (GX2Texture* texture : mStreamPages) {
+        GX2Invalidate(GX2_INVALIDATE_MODE_TEXTURE, texture->surface.image, texture->surface.imageSize);
+    }
+}
 
-    // Initialize texture for sampling
-    GX2InitTextureRegs(texture);
+size_t Font::getTextureBytes() const {
+    size_t bytes = 0;
+    for (const AtlasPage& page : mAtlasPages) {
+        bytes += page.texture->surface.imageSize;
+    }
+    for (const GX2Texture* texture : mStreamPages) {
+        bytes += texture->surface.imageSize;
+    }
+    return bytes;
+}
 
-    // Clean up render buffer
-    free(buffer);
+float Font::getStringWidth(const char* text) {
+    if (!text) {
+        return 0;
+    }
 
-    // Store in cache
-    glyphData.texture = texture;
-    mGlyphCache[codepoint] = glyphData;
+    // FNV-1a, which also finds the length
+    uint32_t hash = 2166136261u;
+    size_t length = 0;
+    for (const uint8_t* p = (const uint8_t*)text; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+        length++;
+    }
 
-    return true;
+    WidthMemoEntry* entry = nullptr;
+    if (length > 0 && length < WIDTH_MEMO_TEXT_MAX) {
+        entry = &mWidthMemo[hash % WIDTH_MEMO_SIZE];
+        if (memcmp(entry->text, text, length + 1) == 0) {
+            return entry->width;
+        }
+    }
+
+    float width = 0;
+    // A width missing a glyph may be right next time, so isn't kept
+    if (measureString(text, &width) && entry) {
+        memcpy(entry->text, text, length + 1);
+        entry->width = width;
+    }
+    return width;
 }
 
-float Font::getStringWidth(const char* text) {
+bool Font::measureString(const char* text, float* outWidth) {
     float width = 0;
+    bool isComplete = true;
 
     // Simple UTF-8 decoding
     const uint8_t* p = (const uint8_t*)text;
@@ -209,6 +463,10 @@ float Font::getStringWidth(const char* text) {
         uint32_t codepoint;
         if ((*p & 0x80) == 0) {
             codepoint = *p++;
+            if (mAsciiAdvance[codepoint] >= 0) {
+                width += mAsciiAdvance[codepoint];
+                continue;
+            }
         } else if ((*p & 0xE0) == 0xC0) {
             codepoint = (*p++ & 0x1F) << 6;
             codepoint |= (*p++ & 0x3F);
@@ -227,13 +485,17 @@ float Font::getStringWidth(const char* text) {
             continue;
         }
 
-        const GlyphData* glyph = getGlyph(codepoint);
+        // Measuring needs only the metrics, not the texels
+        const GlyphData* glyph = findMetrics(codepoint);
         if (glyph) {
             width += glyph->advanceX;
+        } else {
+            isComplete = false;
         }
     }
 
-    return width;
+    *outWidth = width;
+    return isComplete;
 }
 
 // =============================================================================
@@ -242,6 +504,7 @@ float Font::getStringWidth(const char* text) {
 
 static bool sInitialized = false;
 static GX2Sampler* sFontSampler = nullptr;
+static Font* sDefaultFont = nullptr;
 static float sScreenWidth = 854.0f;
 static float sScreenHeight = 480.0f;
 
@@ -256,6 +519,11 @@ bool Init() {
     }
     GX2InitSampler(sFontSampler, GX2_TEX_CLAMP_MODE_CLAMP, GX2_TEX_XY_FILTER_MODE_LINEAR);
 
+    sIsGPUReady = true;
+    if (sDefaultFont) {
+        sDefaultFont->invalidateTextures();
+    }
+
     sInitialized = true;
     return true;
 }
@@ -270,9 +538,15 @@ void Shutdown() {
         sFontSampler = nullptr;
     }
 
+    // The default font's atlas is kept for the next Init()
+    sIsGPUReady = false;
     sInitialized = false;
 }
 
+void BeginFrame() {
+    sFrame++;
+}
+
 void SetScreenSize(float width, float height) {
     sScreenWidth = width;
     sScreenHeight = height;
@@ -292,6 +566,56 @@ Font* LoadDefaultFont(float pointSize) {
     return new Font(fontData, fontSize, pointSize);
 }
 
+static bool loadSharedDefaultFont() {
+    if (sDefaultFont) {
+        return true;
+    }
+
+    sDefaultFont = LoadDefaultFont(DEFAULT_POINT_SIZE);
+    if (!sDefaultFont) {
+        return false;
+    }
+    if (!sDefaultFont->isValid()) {
+        delete sDefaultFont;
+        sDefaultFont = nullptr;
+        return false;
+    }
+
+    sPrewarmCodepoint = PREWARM_FIRST_CODEPOINT;
+    return true;
+}
+
+bool PrewarmDefaultFont(uint32_t maxGlyphs) {
+    // The call that loads the font rasterizes nothing
+    if (!sDefaultFont) {
+        return !loadSharedDefaultFont();
+    }
+
+    uint32_t glyphsLeft = PREWARM_LAST_CODEPOINT + 1 - sPrewarmCodepoint;
+    uint32_t glyphCount = std::min(maxGlyphs, glyphsLeft);
+    if (glyphCount > 0) {
+        sDefaultFont->prewarm(sPrewarmCodepoint, sPrewarmCodepoint + glyphCount - 1);
+        sPrewarmCodepoint += glyphCount;
+    }
+    return sPrewarmCodepoint > PREWARM_LAST_CODEPOINT;
+}
+
+Font* GetDefaultFont() {
+    // Glyphs the prewarm hasn't reached are rasterized as they are drawn
+    loadSharedDefaultFont();
+    return sDefaultFont;
+}
+
+void ReleaseDefaultFont() {
+    delete sDefaultFont;
+    sDefaultFont = nullptr;
+    sPrewarmCodepoint = PREWARM_FIRST_CODEPOINT;
+}
+
+size_t GetDefaultFontBytes() {
+    return sDefaultFont ? sDefaultFont->getTextureBytes() : 0;
+}
+
 void DrawText(Font* font, float x, float y, const char* text, uint32_t color) {
     if (!font || !font->isValid() || !sFontSampler) {
         return;
@@ -300,14 +624,6 @@ void DrawText(Font* font, float x, float y, const char* text, uint32_t color) {
     float cursorX = x;
     float baseline = y + font->getAscender();
 
-    // Convert RGBA color to vec4
-    glm::vec4 colorVec(
-        ((color >> 24) & 0xFF) / 255.0f,
-        ((color >> 16) & 0xFF) / 255.0f,
-        ((color >> 8) & 0xFF) / 255.0f,
-        (color & 0xFF) / 255.0f
-    );
-
     // Simple UTF-8 decoding
     const uint8_t* p = (const uint8_t*)text;
     while (*p) {
@@ -337,31 +653,10 @@ void DrawText(Font* font, float x, float y, const char* text, uint32_t color) {
                 float glyphX = cursorX + glyph->offsetX;
                 float glyphY = baseline + glyph->offsetY;
 
-                // Calculate quad center and size in NDC
-                float centerX = glyphX + glyph->width / 2.0f;
-                float centerY = glyphY + glyph->height / 2.0f;
-
-                glm::vec3 offset(
-                    (centerX / sScreenWidth) * 2.0f - 1.0f,
-                    1.0f - (centerY / sScreenHeight) * 2.0f,
-                    0.0f
-                );
-
-                glm::vec3 scale(
-                    (float)glyph->width / sScreenWidth,
-                    (float)glyph->height / sScreenHeight,
-                    1.0f
-                );
-
-                Texture2DShader::instance()->setShaders();
-                Texture2DShader::instance()->setAttributeBuffer();
-                Texture2DShader::instance()->setAngle(0.0f);
-                Texture2DShader::instance()->setOffset(offset);
-                Texture2DShader::instance()->setScale(scale);
-                Texture2DShader::instance()->setColorIntensity(colorVec);
-                Texture2DShader::instance()->setBlurring(glm::vec3(0.0f));
-                Texture2DShader::instance()->setTextureAndSampler(glyph->texture, sFontSampler);
-                Texture2DShader::instance()->draw();
+                // Glyphs share atlas pages, so a run of text joins one batch
+                QuadBatch::AddTexturedRect(glyph->texture, sFontSampler, glyphX, glyphY,
+                                           (float)glyph->width, (float)glyph->height,
+                                           glyph->texCoords, color);
             }
             cursorX += glyph->advanceX;
         }
@@ -1,24 +1,44 @@
 /**
  * SchriftGX2 - TrueType Font Rendering for GX2
  *
- * Uses libschrift to rasterize glyphs and renders them as GX2 textures.
+ * Uses libschrift to rasterize glyphs into shared atlas textures, so a run
+ * of text is one texture and can be drawn as one batch.
  * Based on the NotificationModule implementation.
+ *
+ * ASCII glyphs are packed into atlas pages and kept. Everything else (the
+ * CJK in Japanese title names, mostly) streams through a bounded set of
+ * pages cut into line-sized cells: a glyph is rasterized the first time
+ * it is drawn, and when the cells run out the least recently drawn glyph
+ * gives up its cell. Metrics are kept for every glyph seen, so measuring
+ * text never rasterizes.
  */
 
 #pragma once
 
 #include <cstdint>
 #include <map>
+#include <vector>
 #include <gx2/texture.h>
 #include "schrift.h"
+#include "quad_batch.h"
 
 namespace SchriftGX2 {
 
+// Side of one glyph atlas texture (R8, so 256 KB each)
+constexpr int ATLAS_SIZE = 512;
+
+// Atlas pages non-ASCII glyphs stream through, per font. At the default
+// size that's about 900 glyphs at once
+constexpr int STREAM_PAGE_COUNT = 2;
+
 /**
  * Cached glyph data for quick rendering.
  */
 struct GlyphData {
-    GX2Texture* texture;
+    GX2Texture* texture;            // Atlas page holding the glyph, or
+                                    // nullptr if not resident
+    int streamCell;                 // Streaming cell, or -1 if packed
+    QuadBatch::TexCoords texCoords; // Glyph's rectangle within the page
     int width;
     int height;
     int offsetX;
@@ -46,9 +66,11 @@ public:
     bool isValid() const { return mFont != nullptr; }
 
     /**
-     * Get cached glyph data, rendering if necessary.
+     * Get cached glyph data, rendering if necessary. Counts as drawing the
+     * glyph this frame.
      * @param codepoint Unicode codepoint
-     * @return Glyph data or nullptr if not available
+     * @return Glyph data or nullptr if the font has no such glyph. The
+     *         texture is nullptr if there was no room for it this frame
      */
     const GlyphData* getGlyph(uint32_t codepoint);
 
@@ -68,7 +90,26 @@ public:
     float getDescender() const { return mDescender; }
 
     /**
-     * Calculate the width of a string in pixels.
+     * Rasterize a range of codepoints ahead of first use.
+     * @return false if any glyph couldn't be rasterized
+     */
+    bool prewarm(uint32_t firstCodepoint, uint32_t lastCodepoint);
+
+    /**
+     * Make the GPU re-read every atlas page, for pages written before
+     * GX2 rendering was set up.
+     */
+    void invalidateTextures();
+
+    /**
+     * Get the bytes of mapped memory the atlas and streaming pages hold.
+     */
+    size_t getTextureBytes() const;
+
+    /**
+     * Calculate the width of a string in pixels. Recently measured strings
+     * are remembered, so measuring the same text every frame is a hash and
+     * a compare.
      * @param text UTF-8 encoded text
      * @return Width in pixels
      */
@@ -85,15 +126,92 @@ private:
     // Glyph cache: codepoint -> glyph data
     std::map<uint32_t, GlyphData> mGlyphCache;
 
+    // Advance of each ASCII glyph, or -1 until it is cached, so measuring
+    // ASCII never searches the map
+    static constexpr int ASCII_COUNT = 128;
+    int mAsciiAdvance[ASCII_COUNT];
+
+    /**
+     * Widths of recently measured strings, one per slot by a hash of the
+     * text. Longer strings aren't kept.
+     */
+    static constexpr int WIDTH_MEMO_SIZE = 64;
+    static constexpr int WIDTH_MEMO_TEXT_MAX = 64;
+    struct WidthMemoEntry {
+        char text[WIDTH_MEMO_TEXT_MAX];  // Empty if unused
+        float width;
+    };
+    WidthMemoEntry mWidthMemo[WIDTH_MEMO_SIZE];
+
+    /**
+     * Sum the advances of a string's glyphs.
+     * @return false if a glyph couldn't be loaded, so the width is short
+     */
+    bool measureString(const char* text, float* outWidth);
+
+    /**
+     * Forget the advance table and remembered widths.
+     */
+    void clearMeasurements();
+
+    /**
+     * One atlas texture, filled shelf by shelf: glyphs go left to right
+     * along the open shelf, and a glyph that doesn't fit starts a new
+     * shelf below the tallest glyph so far.
+     */
+    struct AtlasPage {
+        GX2Texture* texture;
+        int shelfY;
+        int shelfHeight;
+        int cursorX;
+    };
+    std::vector<AtlasPage> mAtlasPages;
+
+    /**
+     * Find room for a glyph, adding a page when the last one is full.
+     * @return Page the glyph goes in, or nullptr if out of memory
+     */
+    AtlasPage* allocateGlyphRect(int width, int height, int* outX, int* outY);
+
     /**
-     * Render a glyph to a GX2 texture.
+     * Streaming pages, cut into square cells of mStreamCellSize, and what
+     * each cell holds.
+     */
+    struct StreamCell {
+        uint32_t codepoint;
+        uint32_t lastUsedFrame;
+        bool isUsed;
+    };
+    int mStreamCellSize;
+    std::vector<GX2Texture*> mStreamPages;
+    std::vector<StreamCell> mStreamCells;
+
+    /**
+     * Take a streaming cell for a glyph: a free one, a new page's while
+     * under STREAM_PAGE_COUNT, or the least recently drawn one.
+     * @return Page holding the cell, or nullptr if every cell was drawn
+     *         too recently to reuse
+     */
+    GX2Texture* allocateStreamCell(uint32_t codepoint, int* outCell);
+
+    GX2Texture* streamCellPage(int cellIndex) const;
+
+    /**
+     * Get a glyph's metrics, loading them (without rasterizing) if needed.
+     * @return Glyph data or nullptr if the font has no such glyph
+     */
+    GlyphData* findMetrics(uint32_t codepoint);
+
+    /**
+     * Rasterize a glyph into the atlas.
      * @param codepoint Unicode codepoint
+     * @param glyphData The glyph's metrics, updated with where it went
      * @return true on success
      */
-    bool renderGlyph(uint32_t codepoint);
+    bool rasterizeGlyph(uint32_t codepoint, GlyphData& glyphData);
 
     /**
-     * Free all cached glyph textures.
+     * Free all cached glyphs and atlas pages.
      */
     void clearCache();
 };
@@ -111,6 +229,12 @@ bool Init();
  */
 void Shutdown();
 
+/**
+ * Start a frame. Streaming cells drawn QuadBatch::FRAMES_IN_FLIGHT frames
+ * ago become reusable.
+ */
+void BeginFrame();
+
 /**
  * Set the screen size for text positioning.
  * @param width Screen width in pixels
@@ -125,6 +249,39 @@ void SetScreenSize(float width, float height);
  */
 Font* LoadDefaultFont(float pointSize);
 
+// Size of the shared default font
+constexpr float DEFAULT_POINT_SIZE = 16.0f;
+
+/**
+ * Load the shared default font and rasterize printable ASCII into its
+ * atlas, at most maxGlyphs per call, carrying on where the last call
+ * stopped; the call that loads the font rasterizes nothing. Safe before
+ * Init(): no GX2 calls are made until then.
+ *
+ * The font stays resident across Init()/Shutdown(), so the first frame
+ * after opening the menu doesn't pay for rasterizing.
+ * @return true once nothing is left to do: every glyph is rasterized, or
+ *         the font couldn't be loaded
+ */
+bool PrewarmDefaultFont(uint32_t maxGlyphs);
+
+/**
+ * Get the shared default font, loading it if needed.
+ * Owned by SchriftGX2; don't delete it.
+ */
+Font* GetDefaultFont();
+
+/**
+ * Free the shared default font (at plugin shutdown).
+ */
+void ReleaseDefaultFont();
+
+/**
+ * Get the bytes of glyph textures the shared default font holds, or 0 if
+ * it isn't loaded.
+ */
+size_t GetDefaultFontBytes();
+
 /**
  * Draw text at the specified position.
  * @param font Font to use
@@ -5,12 +5,17 @@
  * 1. Hook GX2CopyColorBufferToScanBuffer via WUPS function replacement
  * 2. Before copy, draw our overlay into the color buffer
  * 3. Restore game's GX2 context state
+ *
+ * The hooks are only installed in games, and pass straight through while
+ * no menu is open.
  */
 
 #ifdef ENABLE_GX2_RENDERING
 
 #include "gx2_overlay.h"
 #include "SchriftGX2.h"
+#include "quad_batch.h"
+#include "icon_textures.h"
 #include "shaders/ColorShader.h"
 #include "shaders/Texture2DShader.h"
 
@@ -21,6 +26,7 @@
 #include <coreinit/cache.h>
 #include <coreinit/memory.h>
 #include <coreinit/systeminfo.h>
+#include <coreinit/time.h>
 #include <gx2/context.h>
 #include <gx2/display.h>
 #include <gx2/draw.h>
@@ -37,6 +43,9 @@
 
 namespace GX2Overlay {
 
+// A game that copied a color buffer this recently is still presenting
+constexpr uint32_t GAME_FRAME_TIMEOUT_MS = 100;
+
 // State
 static bool sInitialized = false;
 static bool sEnabled = false;
@@ -47,69 +56,99 @@ GX2ContextState* sSavedContextState = nullptr;
 static float sScreenWidth = 1280.0f;
 static float sScreenHeight = 720.0f;
 
-// Color vertex buffer for rectangles (4 vertices, RGBA each)
-static uint8_t* sColorVtxs = nullptr;
-static const uint32_t COLOR_VTX_COUNT = 4;
-
 // Font for text rendering
 static SchriftGX2::Font* sDefaultFont = nullptr;
 
+// Sampler for DrawTexture (icons)
+static GX2Sampler* sTextureSampler = nullptr;
+
+// Set by the menu; both run on the game's thread inside the copy hook
+static FrameCallback sUpdateCallback = nullptr;
+static FrameCallback sDrawCallback = nullptr;
+
+// Scan targets drawn since the last update. A target coming round again
+// starts the next game frame
+static uint32_t sTargetsSinceUpdate = 0;
+
+static OSTime sLastGameFrameTime = 0;
+
 namespace {
 
 void drawOverlay(GX2ColorBuffer* colorBuffer, GX2ScanTarget scanTarget) {
-    if (!sEnabled || !sContextState) {
+    sLastGameFrameTime = OSGetSystemTime();
+    if (!sUpdateCallback && !sEnabled) {
+        return;
+    }
+
+    // Without the game's context there would be nothing to restore
+    GX2ContextState* gameContext = sSavedContextState;
+    if (!gameContext) {
         return;
     }
 
-    GX2ContextState* savedContext = sSavedContextState;
-    GX2SetContextState(sContextState);
-
-    GX2SetViewport(0, 0, colorBuffer->surface.width, colorBuffer->surface.height, 0.0f, 1.0f);
-    GX2SetScissor(0, 0, colorBuffer->surface.width, colorBuffer->surface.height);
-    GX2SetColorBuffer(colorBuffer, GX2_RENDER_TARGET_0);
-    GX2SetDepthOnlyControl(GX2_FALSE, GX2_FALSE, GX2_COMPARE_FUNC_ALWAYS);
-
-    // Enable alpha blending
-    GX2SetColorControl(GX2_LOGIC_OP_COPY, 0xFF, FALSE, TRUE);
-    GX2SetBlendControl(
-        GX2_RENDER_TARGET_0,
-        GX2_BLEND_MODE_SRC_ALPHA,
-        GX2_BLEND_MODE_INV_SRC_ALPHA,
-        GX2_BLEND_COMBINE_MODE_ADD,
-        TRUE,
-        GX2_BLEND_MODE_ONE,
-        GX2_BLEND_MODE_INV_SRC_ALPHA,
-        GX2_BLEND_COMBINE_MODE_ADD
-    );
-
-    // Drawing happens here when menu calls DrawRect/DrawText
-
-    if (savedContext) {
-        GX2SetContextState(savedContext);
+    uint32_t targetBit = static_cast<uint32_t>(scanTarget);
+    if (sTargetsSinceUpdate == 0 || (sTargetsSinceUpdate & targetBit)) {
+        sTargetsSinceUpdate = 0;
+        // May Init() or Shutdown() the overlay
+        if (sUpdateCallback) {
+            sUpdateCallback();
+        }
+    }
+    sTargetsSinceUpdate |= targetBit;
+
+    if (sEnabled && sContextState && sDrawCallback) {
+        GX2SetContextState(sContextState);
+
+        GX2SetViewport(0, 0, colorBuffer->surface.width, colorBuffer->surface.height, 0.0f, 1.0f);
+        GX2SetScissor(0, 0, colorBuffer->surface.width, colorBuffer->surface.height);
+        GX2SetColorBuffer(colorBuffer, GX2_RENDER_TARGET_0);
+        GX2SetDepthOnlyControl(GX2_FALSE, GX2_FALSE, GX2_COMPARE_FUNC_ALWAYS);
+
+        // Enable alpha blending
+        GX2SetColorControl(GX2_LOGIC_OP_COPY, 0xFF, FALSE, TRUE);
+        GX2SetBlendControl(
+            GX2_RENDER_TARGET_0,
+            GX2_BLEND_MODE_SRC_ALPHA,
+            GX2_BLEND_MODE_INV_SRC_ALPHA,
+            GX2_BLEND_COMBINE_MODE_ADD,
+            TRUE,
+            GX2_BLEND_MODE_ONE,
+            GX2_BLEND_MODE_INV_SRC_ALPHA,
+            GX2_BLEND_COMBINE_MODE_ADD
+        );
+
+        // Skips this copy rather than stall if the GPU is still reading the
+        // space the frame would be drawn into
+        if (BeginDraw()) {
+            sDrawCallback();
+            EndDraw();
+        }
     }
+
+    // Init() sets up a context of its own too
+    GX2SetContextState(gameContext);
 }
 
 } // anonymous namespace
 } // namespace GX2Overlay
 
-// WUPS Function Replacements - DISABLED
-// These hooks cause system freeze on Wii U Menu because they intercept GX2
-// calls even when the overlay is disabled. The hook-based overlay approach
-// needs architectural redesign to work properly for full-screen menu takeover.
-#if 0
+// WUPS Function Replacements
+// Games only: hooking these in the Wii U Menu froze it, and the menu
+// takes over the screen with OSScreen there anyway
 DECL_FUNCTION(void, GX2SetContextState_hook, GX2ContextState* state) {
     GX2Overlay::sSavedContextState = state;
     real_GX2SetContextState_hook(state);
 }
-WUPS_MUST_REPLACE(GX2SetContextState_hook, WUPS_LOADER_LIBRARY_GX2, GX2SetContextState);
+WUPS_MUST_REPLACE_FOR_PROCESS(GX2SetContextState_hook, WUPS_LOADER_LIBRARY_GX2, GX2SetContextState,
+                              WUPS_FP_TARGET_PROCESS_GAME);
 
 DECL_FUNCTION(void, GX2CopyColorBufferToScanBuffer_hook,
               GX2ColorBuffer* colorBuffer, GX2ScanTarget scanTarget) {
     GX2Overlay::drawOverlay(colorBuffer, scanTarget);
     real_GX2CopyColorBufferToScanBuffer_hook(colorBuffer, scanTarget);
 }
-WUPS_MUST_REPLACE(GX2CopyColorBufferToScanBuffer_hook, WUPS_LOADER_LIBRARY_GX2, GX2CopyColorBufferToScanBuffer);
-#endif
+WUPS_MUST_REPLACE_FOR_PROCESS(GX2CopyColorBufferToScanBuffer_hook, WUPS_LOADER_LIBRARY_GX2,
+                              GX2CopyColorBufferToScanBuffer, WUPS_FP_TARGET_PROCESS_GAME);
 
 namespace GX2Overlay {
 
@@ -130,18 +169,26 @@ bool Init() {
     ColorShader::instance();
     Texture2DShader::instance();
 
-    // Allocate color vertex buffer
-    sColorVtxs = (uint8_t*)MEMAllocFromMappedMemoryForGX2Ex(
-        COLOR_VTX_COUNT * ColorShader::cuColorAttrSize, GX2_VERTEX_BUFFER_ALIGNMENT);
-    if (!sColorVtxs) {
+    // Rectangles and glyphs are drawn in batches from per-frame buffers
+    if (!QuadBatch::Init()) {
         MEMFreeToMappedMemory(sContextState);
         sContextState = nullptr;
         return false;
     }
 
+    sTextureSampler = (GX2Sampler*)MEMAllocFromMappedMemoryForGX2Ex(sizeof(GX2Sampler), 64);
+    if (!sTextureSampler) {
+        QuadBatch::Shutdown();
+        MEMFreeToMappedMemory(sContextState);
+        sContextState = nullptr;
+        return false;
+    }
+    GX2InitSampler(sTextureSampler, GX2_TEX_CLAMP_MODE_CLAMP, GX2_TEX_XY_FILTER_MODE_LINEAR);
+    IconTextures::Init();
+
     // Initialize font system and load default font
     SchriftGX2::Init();
-    sDefaultFont = SchriftGX2::LoadDefaultFont(16.0f);
+    sDefaultFont = SchriftGX2::GetDefaultFont();
 
     sInitialized = true;
     sEnabled = false;
@@ -153,18 +200,21 @@ void Shutdown() {
         return;
     }
 
-    // Clean up font
-    if (sDefaultFont) {
-        delete sDefaultFont;
-        sDefaultFont = nullptr;
-    }
+    // Frames still in flight read the buffers and textures freed below
+    GX2DrawDone();
+
+    // The font and its glyph atlas stay loaded for the next Init()
+    sDefaultFont = nullptr;
     SchriftGX2::Shutdown();
 
-    if (sColorVtxs) {
-        MEMFreeToMappedMemory(sColorVtxs);
-        sColorVtxs = nullptr;
+    IconTextures::Shutdown();
+    if (sTextureSampler) {
+        MEMFreeToMappedMemory(sTextureSampler);
+        sTextureSampler = nullptr;
     }
 
+    QuadBatch::Shutdown();
+
     Texture2DShader::destroyInstance();
     ColorShader::destroyInstance();
 
@@ -177,71 +227,62 @@ void Shutdown() {
     sEnabled = false;
 }
 
+bool Prewarm(uint32_t maxGlyphs) {
+    return SchriftGX2::PrewarmDefaultFont(maxGlyphs);
+}
+
+void ReleaseResources() {
+    if (!sInitialized) {
+        SchriftGX2::ReleaseDefaultFont();
+    }
+}
+
+size_t GetResourceBytes() {
+    return SchriftGX2::GetDefaultFontBytes();
+}
+
 bool IsInitialized() { return sInitialized; }
 void SetEnabled(bool enabled) { sEnabled = enabled; }
 bool IsEnabled() { return sEnabled; }
 
+void SetUpdateCallback(FrameCallback callback) {
+    sUpdateCallback = callback;
+    sTargetsSinceUpdate = 0;
+}
+
+void SetDrawCallback(FrameCallback callback) { sDrawCallback = callback; }
+
+bool IsGameRendering() {
+    if (sLastGameFrameTime == 0) {
+        return false;
+    }
+    OSTime elapsed = OSGetSystemTime() - sLastGameFrameTime;
+    return OSTicksToMilliseconds(elapsed) < GAME_FRAME_TIMEOUT_MS;
+}
+
 void SetScreenSize(float width, float height) {
     sScreenWidth = width;
     sScreenHeight = height;
     SchriftGX2::SetScreenSize(width, height);
 }
 
-void BeginDraw(uint32_t clearColor) {
+bool BeginDraw(uint32_t clearColor) {
     (void)clearColor;
+    if (!QuadBatch::TryBegin(sScreenWidth, sScreenHeight)) {
+        return false;
+    }
+    IconTextures::BeginFrame();
+    SchriftGX2::BeginFrame();
+    return true;
 }
 
 void EndDraw() {
-    GX2DrawDone();
+    // Fenced rather than waited on; the next frames draw into other space
+    QuadBatch::End();
 }
 
 void DrawRect(int x, int y, int width, int height, uint32_t color) {
-    if (!sColorVtxs) {
-        return;
-    }
-
-    // Set color for all 4 vertices (RGBA format)
-    uint8_t r = (color >> 24) & 0xFF;
-    uint8_t g = (color >> 16) & 0xFF;
-    uint8_t b = (color >> 8) & 0xFF;
-    uint8_t a = color & 0xFF;
-
-    for (int i = 0; i < 4; i++) {
-        sColorVtxs[i * 4 + 0] = r;
-        sColorVtxs[i * 4 + 1] = g;
-        sColorVtxs[i * 4 + 2] = b;
-        sColorVtxs[i * 4 + 3] = a;
-    }
-    GX2Invalidate(GX2_INVALIDATE_MODE_CPU_ATTRIBUTE_BUFFER, sColorVtxs, COLOR_VTX_COUNT * 4);
-
-    // Calculate offset and scale for the shader
-    // Shader uses normalized device coords (-1 to 1)
-    // offset is the center of the quad, scale is half-size
-    float centerX = (float)x + (float)width / 2.0f;
-    float centerY = (float)y + (float)height / 2.0f;
-
-    // Convert to NDC: x: 0..screenWidth -> -1..1, y: 0..screenHeight -> 1..-1 (flipped)
-    glm::vec3 offset(
-        (centerX / sScreenWidth) * 2.0f - 1.0f,
-        1.0f - (centerY / sScreenHeight) * 2.0f,
-        0.0f
-    );
-
-    glm::vec3 scale(
-        (float)width / sScreenWidth,
-        (float)height / sScreenHeight,
-        1.0f
-    );
-
-    glm::vec4 colorIntensity(1.0f, 1.0f, 1.0f, 1.0f);
-
-    ColorShader::instance()->setShaders();
-    ColorShader::instance()->setAttributeBuffer(sColorVtxs);
-    ColorShader::instance()->setAngle(0.0f);
-    ColorShader::instance()->setOffset(offset);
-    ColorShader::instance()->setScale(scale);
-    ColorShader::instance()->setColorIntensity(colorIntensity);
-    ColorShader::instance()->draw();
+    QuadBatch::AddRect((float)x, (float)y, (float)width, (float)height, color);
 }
 
 void DrawText(int x, int y, const char* text, uint32_t color, int size) {
@@ -253,8 +294,14 @@ void DrawText(int x, int y, const char* text, uint32_t color, int size) {
 }
 
 void DrawTexture(int x, int y, GX2Texture* texture, int width, int height) {
-    // TODO: Texture rendering - Texture2DShader needs adaptation
-    (void)x; (void)y; (void)texture; (void)width; (void)height;
+    if (!texture || !sTextureSampler) {
+        return;
+    }
+
+    float drawWidth = (width > 0) ? (float)width : (float)texture->surface.width;
+    float drawHeight = (height > 0) ? (float)height : (float)texture->surface.height;
+    QuadBatch::AddTexturedRect(texture, sTextureSampler, (float)x, (float)y, drawWidth, drawHeight,
+                               QuadBatch::FULL_TEXTURE, 0xFFFFFFFF);
 }
 
 int GetScreenWidth() { return (int)sScreenWidth; }
@@ -3,16 +3,27 @@
  *
  * Provides GPU-accelerated overlay rendering on top of game graphics.
  * Uses libfunctionpatcher to hook GX2CopyColorBufferToScanBuffer.
+ *
+ * The overlay draws inside the game's own frame: each time the game copies
+ * a color buffer to the TV or DRC, the hook runs the update callback (once
+ * per game frame), then the draw callback into that color buffer, and puts
+ * the game's context state back. Drawing never waits on the GPU; if the
+ * space a frame would use is still in flight, that copy goes without the
+ * overlay, and a frame adds at most QuadBatch::MAX_QUADS quads of GPU work.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <gx2/texture.h>
 #include <gx2/context.h>
 
 namespace GX2Overlay {
 
+// Runs on the game's thread inside the copy hook
+using FrameCallback = void (*)();
+
 /**
  * Initialize the GX2 overlay system.
  * Must be called before any rendering.
@@ -26,6 +37,24 @@ bool Init();
  */
 void Shutdown();
 
+/**
+ * Load the default font and rasterize its common glyphs ahead of the
+ * first Init(), at most maxGlyphs per call. Call until it returns true;
+ * the result stays resident across Init()/Shutdown().
+ * @return true once done (see SchriftGX2::PrewarmDefaultFont)
+ */
+bool Prewarm(uint32_t maxGlyphs);
+
+/**
+ * Free what Prewarm() loaded. Call at plugin shutdown, after Shutdown().
+ */
+void ReleaseResources();
+
+/**
+ * Get the bytes of mapped memory Prewarm() holds.
+ */
+size_t GetResourceBytes();
+
 /**
  * Check if the overlay system is initialized.
  */
@@ -42,12 +71,33 @@ void SetEnabled(bool enabled);
  */
 bool IsEnabled();
 
+/**
+ * Set the function run once per game frame, before the overlay is drawn.
+ * It may Init() or Shutdown() the overlay. nullptr (the default) leaves
+ * the hooks passing straight through.
+ */
+void SetUpdateCallback(FrameCallback callback);
+
+/**
+ * Set the function that issues the overlay's draw commands, run for each
+ * scan buffer copy while enabled.
+ */
+void SetDrawCallback(FrameCallback callback);
+
+/**
+ * Check if the game in this process is presenting frames through the
+ * hooks, so an overlay would be drawn.
+ */
+bool IsGameRendering();
+
 /**
  * Begin drawing to the overlay.
  * Call before issuing draw commands.
  * @param clearColor Background color (RGBA)
+ * @return false, with nothing to end, if the GPU is too far behind to
+ *         draw this frame without waiting
  */
-void BeginDraw(uint32_t clearColor = 0x00000000);
+bool BeginDraw(uint32_t clearColor = 0x00000000);
 
 /**
  * End drawing to the overlay.
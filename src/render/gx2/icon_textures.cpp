@@ -0,0 +1,214 @@
+/**
+ * GX2 Icon Texture Pool Implementation
+ *
+ * See icon_textures.h for usage documentation.
+ */
+
+#ifdef ENABLE_GX2_RENDERING
+
+#include "icon_textures.h"
+#include "quad_batch.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <gx2/mem.h>
+#include <gx2/surface.h>
+#include <memory/mappedmemory.h>
+
+namespace IconTextures {
+
+namespace {
+
+struct Slot {
+    const Renderer::ImageData* owner;   // nullptr if free
+    GX2Texture* texture;                // Kept while the slot is free
+    uint32_t lastDrawnFrame;
+};
+
+Slot sSlots[SLOT_COUNT];
+uint32_t sFrame = 0;
+int sUploadCount = 0;
+
+GX2Texture* createTexture(int width, int height)
+{
+    GX2Texture* texture = static_cast<GX2Texture*>(calloc(1, sizeof(GX2Texture)));
+    if (!texture) {
+        return nullptr;
+    }
+
+    texture->surface.width = width;
+    texture->surface.height = height;
+    texture->surface.depth = 1;
+    texture->surface.dim = GX2_SURFACE_DIM_TEXTURE_2D;
+    texture->surface.format = GX2_SURFACE_FORMAT_UNORM_R8_G8_B8_A8;
+    texture->surface.aa = GX2_AA_MODE1X;
+    texture->surface.use = GX2_SURFACE_USE_TEXTURE;
+    texture->surface.mipLevels = 1;
+    texture->surface.tileMode = GX2_TILE_MODE_LINEAR_ALIGNED;
+    texture->viewNumMips = 1;
+    texture->viewNumSlices = 1;
+    texture->compMap = 0x00010203;  // RGBA
+
+    GX2CalcSurfaceSizeAndAlignment(&texture->surface);
+
+    texture->surface.image = MEMAllocFromMappedMemoryForGX2Ex(texture->surface.imageSize,
+                                                              texture->surface.alignment);
+    if (!texture->surface.image) {
+        free(texture);
+        return nullptr;
+    }
+
+    GX2InitTextureRegs(texture);
+    return texture;
+}
+
+void freeTexture(GX2Texture*& texture)
+{
+    if (!texture) {
+        return;
+    }
+    if (texture->surface.image) {
+        MEMFreeToMappedMemory(texture->surface.image);
+    }
+    free(texture);
+    texture = nullptr;
+}
+
+// Compact formats expanded to RGBA8888 (0xRRGGBBAA), matching getImageRow
+// on the OSScreen side
+uint32_t expandPixel(const Renderer::ImageData* image, int index)
+{
+    uint16_t pixel = image->pixels16[index];
+    if (image->format == Renderer::PixelFormat::RGB565) {
+        uint32_t red = (pixel >> 11) & 0x1F;
+        uint32_t green = (pixel >> 5) & 0x3F;
+        uint32_t blue = pixel & 0x1F;
+        return (((red << 3) | (red >> 2)) << 24) | (((green << 2) | (green >> 4)) << 16) |
+               (((blue << 3) | (blue >> 2)) << 8) | 0xFF;
+    }
+
+    uint32_t red = (pixel >> 12) & 0xF;
+    uint32_t green = (pixel >> 8) & 0xF;
+    uint32_t blue = (pixel >> 4) & 0xF;
+    uint32_t alpha = pixel & 0xF;
+    return (red * 0x11u << 24) | (green * 0x11u << 16) | (blue * 0x11u << 8) | (alpha * 0x11u);
+}
+
+void upload(const Renderer::ImageData* image, GX2Texture* texture)
+{
+    uint32_t* texels = static_cast<uint32_t*>(texture->surface.image);
+    uint32_t pitch = texture->surface.pitch;
+
+    for (int y = 0; y < image->height; y++) {
+        uint32_t* row = texels + y * pitch;
+        if (image->format == Renderer::PixelFormat::RGBA8888) {
+            memcpy(row, image->pixels + y * image->width, image->width * sizeof(uint32_t));
+        } else {
+            for (int x = 0; x < image->width; x++) {
+                row[x] = expandPixel(image, y * image->width + x);
+            }
+        }
+    }
+
+    GX2Invalidate(GX2_INVALIDATE_MODE_CPU_TEXTURE, texture->surface.image, texture->surface.imageSize);
+    sUploadCount++;
+}
+
+// A free slot if there is one, else the least recently drawn one. Slots
+// drawn in the last few frames may still be read by the GPU
+Slot* findSlotToFill()
+{
+    Slot* oldest = nullptr;
+    for (Slot& slot : sSlots) {
+        if (slot.lastDrawnFrame != 0 && sFrame - slot.lastDrawnFrame < QuadBatch::FRAMES_IN_FLIGHT) {
+            continue;
+        }
+        if (!slot.owner) {
+            return &slot;
+        }
+        if (!oldest || slot.lastDrawnFrame < oldest->lastDrawnFrame) {
+            oldest = &slot;
+        }
+    }
+    return oldest;
+}
+
+} // anonymous namespace
+
+void Init()
+{
+    for (Slot& slot : sSlots) {
+        slot = { nullptr, nullptr, 0 };
+    }
+    sFrame = 0;
+    sUploadCount = 0;
+}
+
+void Shutdown()
+{
+    for (Slot& slot : sSlots) {
+        freeTexture(slot.texture);
+        slot.owner = nullptr;
+    }
+}
+
+void BeginFrame()
+{
+    sFrame++;
+}
+
+GX2Texture* Acquire(const Renderer::ImageData* image)
+{
+    if (!image || !image->pixels || image->width <= 0 || image->height <= 0) {
+        return nullptr;
+    }
+
+    for (Slot& slot : sSlots) {
+        if (slot.owner == image) {
+            slot.lastDrawnFrame = sFrame;
+            return slot.texture;
+        }
+    }
+
+    Slot* slot = findSlotToFill();
+    if (!slot) {
+        return nullptr;
+    }
+
+    GX2Texture*& texture = slot->texture;
+    if (texture && (static_cast<int>(texture->surface.width) != image->width ||
+                    static_cast<int>(texture->surface.height) != image->height)) {
+        freeTexture(texture);
+    }
+    if (!texture) {
+        texture = createTexture(image->width, image->height);
+        if (!texture) {
+            slot->owner = nullptr;
+            return nullptr;
+        }
+    }
+
+    upload(image, texture);
+    slot->owner = image;
+    slot->lastDrawnFrame = sFrame;
+    return texture;
+}
+
+void Release(const Renderer::ImageData* image)
+{
+    for (Slot& slot : sSlots) {
+        if (slot.owner == image) {
+            slot.owner = nullptr;
+            return;
+        }
+    }
+}
+
+int GetUploadCount()
+{
+    return sUploadCount;
+}
+
+} // namespace IconTextures
+
+#endif // ENABLE_GX2_RENDERING
@@ -0,0 +1,82 @@
+/**
+ * GX2 Icon Texture Pool
+ *
+ * Keeps decoded icons resident as GX2 textures, so the GX2 backend draws
+ * an icon as one textured quad with no per-frame CPU pixel work.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The pool has a fixed number of slots, each holding one RGBA8 texture.
+ * The first time an ImageData is drawn it is uploaded into a free slot, or
+ * into the least recently drawn one (compact RGB565/RGBA4444 images are
+ * expanded on the way). Later draws of the same image reuse the slot.
+ * A slot's texture is kept when the next image has the same size, which
+ * it always does for icons decoded at the layout's icon size.
+ *
+ * ImageStore::FreeImage() calls Renderer::ReleaseImage(), which frees the
+ * image's slot, so an evicted icon never leaves a stale texture behind.
+ * A slot drawn in the last QuadBatch::FRAMES_IN_FLIGHT frames is never
+ * reused, because the GPU may not have read it yet.
+ *
+ * Everything but Release() runs on the menu thread. The loader's worker
+ * can free an image too, but only one it never published, which can't
+ * own a slot; its Release() only reads.
+ *
+ * USAGE:
+ * ------
+ *   IconTextures::Init();
+ *
+ *   IconTextures::BeginFrame();
+ *   GX2Texture* texture = IconTextures::Acquire(image);
+ *   if (texture) {
+ *       GX2Overlay::DrawTexture(x, y, texture, size, size);
+ *   }
+ *
+ *   IconTextures::Release(image);  // Before freeing the image
+ */
+
+#pragma once
+
+#include "../renderer.h"
+
+#include <gx2/texture.h>
+
+namespace IconTextures {
+
+// Enough for every icon on screen at once (list row icons plus details)
+constexpr int SLOT_COUNT = 32;
+
+/**
+ * Set up the empty pool.
+ */
+void Init();
+
+/**
+ * Free every slot's texture.
+ */
+void Shutdown();
+
+/**
+ * Start a frame; slots drawn FRAMES_IN_FLIGHT frames ago become reusable.
+ */
+void BeginFrame();
+
+/**
+ * Get an image's texture, uploading it if it isn't resident.
+ * @param image Decoded image
+ * @return Texture, or nullptr if out of memory or every slot is in use
+ *         this frame
+ */
+GX2Texture* Acquire(const Renderer::ImageData* image);
+
+/**
+ * Drop an image's slot, if it has one.
+ */
+void Release(const Renderer::ImageData* image);
+
+/**
+ * Get the number of uploads since Init(), for profiling.
+ */
+int GetUploadCount();
+
+} // namespace IconTextures
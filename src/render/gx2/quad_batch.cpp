@@ -0,0 +1,344 @@
+/**
+ * GX2 Quad Batcher Implementation
+ *
+ * See quad_batch.h for usage documentation.
+ */
+
+#ifdef ENABLE_GX2_RENDERING
+
+#include "quad_batch.h"
+#include "shaders/ColorShader.h"
+#include "shaders/Texture2DShader.h"
+
+#include <coreinit/cache.h>
+#include <coreinit/time.h>
+#include <gx2/draw.h>
+#include <gx2/event.h>
+#include <gx2/mem.h>
+#include <gx2/state.h>
+#include <memory/mappedmemory.h>
+
+#pragma GCC diagnostic ignored "-Wvolatile"
+#include <glm/glm.hpp>
+
+namespace QuadBatch {
+
+namespace {
+
+enum class BatchKind {
+    NONE,
+    COLOR,
+    TEXTURE
+};
+
+constexpr int VERTICES_PER_QUAD = 4;
+constexpr int MAX_VERTICES = MAX_QUADS * VERTICES_PER_QUAD * FRAMES_IN_FLIGHT;
+
+// Per-vertex attributes for every ring region, in the shaders' layouts
+float* sPositions = nullptr;     // x, y, z
+float* sTexCoords = nullptr;     // u, v
+uint8_t* sColors = nullptr;      // r, g, b, a
+
+float sScreenWidth = 1280.0f;
+float sScreenHeight = 720.0f;
+
+// Ring region of the current frame, and the GPU timestamp each region's
+// last frame was submitted with
+int sRegion = 0;
+int sRegionStart = 0;
+OSTime sRegionFences[FRAMES_IN_FLIGHT] = {};
+
+// Quads written this frame, and where the pending run starts, both
+// counted from sRegionStart
+int sQuadCount = 0;
+int sBatchStart = 0;
+
+// What the pending run shares
+BatchKind sBatchKind = BatchKind::NONE;
+const GX2Texture* sBatchTexture = nullptr;
+const GX2Sampler* sBatchSampler = nullptr;
+uint32_t sBatchColor = 0;
+
+// Shader bound by the last flush, so runs of one kind don't rebind it
+BatchKind sBoundKind = BatchKind::NONE;
+
+// False for a frame started with TryBegin(), which drops quads past
+// MAX_QUADS rather than waiting on the GPU
+bool sCanWait = true;
+
+int sDrawCount = 0;
+
+glm::vec4 toColorVector(uint32_t color)
+{
+    return glm::vec4(((color >> 24) & 0xFF) / 255.0f,
+                     ((color >> 16) & 0xFF) / 255.0f,
+                     ((color >> 8) & 0xFF) / 255.0f,
+                     (color & 0xFF) / 255.0f);
+}
+
+// The GPU may still cache what a region held frames ago
+void invalidateRegion()
+{
+    uint32_t firstVertex = sRegionStart * VERTICES_PER_QUAD;
+    uint32_t vertexCount = MAX_QUADS * VERTICES_PER_QUAD;
+    GX2Invalidate(GX2_INVALIDATE_MODE_ATTRIBUTE_BUFFER, sPositions + firstVertex * 3,
+                  vertexCount * Shader::cuVertexAttrSize);
+    GX2Invalidate(GX2_INVALIDATE_MODE_ATTRIBUTE_BUFFER, sTexCoords + firstVertex * 2,
+                  vertexCount * Shader::cuTexCoordAttrSize);
+    GX2Invalidate(GX2_INVALIDATE_MODE_ATTRIBUTE_BUFFER, sColors + firstVertex * 4,
+                  vertexCount * Shader::cuColorAttrSize);
+}
+
+/**
+ * Make room for one quad of the given kind, flushing the pending run if
+ * the quad can't join it.
+ * @return false if the region is full and the frame can't wait
+ */
+bool beginQuad(BatchKind kind, const GX2Texture* texture, const GX2Sampler* sampler, uint32_t color)
+{
+    bool canJoin = (kind == sBatchKind) &&
+                   (kind == BatchKind::COLOR ||
+                    (texture == sBatchTexture && sampler == sBatchSampler && color == sBatchColor));
+    if (!canJoin) {
+        Flush();
+    }
+
+    // Out of room: the region can only be rewritten once the GPU is done
+    // with this frame's draws so far
+    if (sQuadCount == MAX_QUADS) {
+        if (!sCanWait) {
+            return false;
+        }
+        Flush();
+        GX2DrawDone();
+        invalidateRegion();
+        sQuadCount = 0;
+        sBatchStart = 0;
+    }
+
+    sBatchKind = kind;
+    sBatchTexture = texture;
+    sBatchSampler = sampler;
+    sBatchColor = color;
+    return true;
+}
+
+// Move to the next ring region and start an empty frame in it
+void startRegion(float screenWidth, float screenHeight)
+{
+    sScreenWidth = screenWidth;
+    sScreenHeight = screenHeight;
+
+    if (sPositions) {
+        invalidateRegion();
+    }
+
+    sQuadCount = 0;
+    sBatchStart = 0;
+    sBatchKind = BatchKind::NONE;
+    sBoundKind = BatchKind::NONE;
+    sDrawCount = 0;
+}
+
+int nextRegion()
+{
+    return (sRegion + 1) % FRAMES_IN_FLIGHT;
+}
+
+// Screen rectangle to the four NDC corners, in the order the shaders'
+// default quad uses: bottom-left, bottom-right, top-right, top-left
+void writePositions(int quad, float x, float y, float width, float height)
+{
+    float left = (x / sScreenWidth) * 2.0f - 1.0f;
+    float right = ((x + width) / sScreenWidth) * 2.0f - 1.0f;
+    float top = 1.0f - (y / sScreenHeight) * 2.0f;
+    float bottom = 1.0f - ((y + height) / sScreenHeight) * 2.0f;
+
+    float* position = sPositions + (sRegionStart + quad) * VERTICES_PER_QUAD * 3;
+    position[0] = left;   position[1] = bottom;  position[2] = 0.0f;
+    position[3] = right;  position[4] = bottom;  position[5] = 0.0f;
+    position[6] = right;  position[7] = top;     position[8] = 0.0f;
+    position[9] = left;   position[10] = top;    position[11] = 0.0f;
+}
+
+} // anonymous namespace
+
+bool Init()
+{
+    if (sPositions) {
+        return true;
+    }
+
+    sPositions = static_cast<float*>(MEMAllocFromMappedMemoryForGX2Ex(
+        MAX_VERTICES * Shader::cuVertexAttrSize, GX2_VERTEX_BUFFER_ALIGNMENT));
+    sTexCoords = static_cast<float*>(MEMAllocFromMappedMemoryForGX2Ex(
+        MAX_VERTICES * Shader::cuTexCoordAttrSize, GX2_VERTEX_BUFFER_ALIGNMENT));
+    sColors = static_cast<uint8_t*>(MEMAllocFromMappedMemoryForGX2Ex(
+        MAX_VERTICES * Shader::cuColorAttrSize, GX2_VERTEX_BUFFER_ALIGNMENT));
+
+    if (!sPositions || !sTexCoords || !sColors) {
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void Shutdown()
+{
+    if (sPositions) {
+        MEMFreeToMappedMemory(sPositions);
+        sPositions = nullptr;
+    }
+    if (sTexCoords) {
+        MEMFreeToMappedMemory(sTexCoords);
+        sTexCoords = nullptr;
+    }
+    if (sColors) {
+        MEMFreeToMappedMemory(sColors);
+        sColors = nullptr;
+    }
+}
+
+void Begin(float screenWidth, float screenHeight)
+{
+    // Usually retired long ago; only a GPU FRAMES_IN_FLIGHT frames behind
+    // makes this wait
+    sRegion = nextRegion();
+    sRegionStart = sRegion * MAX_QUADS;
+    if (GX2GetRetiredTimeStamp() < sRegionFences[sRegion]) {
+        GX2WaitTimeStamp(sRegionFences[sRegion]);
+    }
+
+    sCanWait = true;
+    startRegion(screenWidth, screenHeight);
+}
+
+bool TryBegin(float screenWidth, float screenHeight)
+{
+    int region = nextRegion();
+    if (GX2GetRetiredTimeStamp() < sRegionFences[region]) {
+        return false;
+    }
+
+    sRegion = region;
+    sRegionStart = sRegion * MAX_QUADS;
+    sCanWait = false;
+    startRegion(screenWidth, screenHeight);
+    return true;
+}
+
+void AddRect(float x, float y, float width, float height, uint32_t color)
+{
+    if (!sPositions) {
+        return;
+    }
+
+    if (!beginQuad(BatchKind::COLOR, nullptr, nullptr, 0)) {
+        return;
+    }
+
+    writePositions(sQuadCount, x, y, width, height);
+    uint8_t* vertexColor = sColors + (sRegionStart + sQuadCount) * VERTICES_PER_QUAD * 4;
+    for (int vertex = 0; vertex < VERTICES_PER_QUAD; vertex++) {
+        vertexColor[vertex * 4 + 0] = (color >> 24) & 0xFF;
+        vertexColor[vertex * 4 + 1] = (color >> 16) & 0xFF;
+        vertexColor[vertex * 4 + 2] = (color >> 8) & 0xFF;
+        vertexColor[vertex * 4 + 3] = color & 0xFF;
+    }
+    sQuadCount++;
+}
+
+void AddTexturedRect(const GX2Texture* texture, const GX2Sampler* sampler,
+                     float x, float y, float width, float height,
+                     const TexCoords& texCoords, uint32_t color)
+{
+    if (!sPositions || !texture || !sampler) {
+        return;
+    }
+
+    if (!beginQuad(BatchKind::TEXTURE, texture, sampler, color)) {
+        return;
+    }
+
+    writePositions(sQuadCount, x, y, width, height);
+    float* texCoord = sTexCoords + (sRegionStart + sQuadCount) * VERTICES_PER_QUAD * 2;
+    texCoord[0] = texCoords.left;   texCoord[1] = texCoords.bottom;
+    texCoord[2] = texCoords.right;  texCoord[3] = texCoords.bottom;
+    texCoord[4] = texCoords.right;  texCoord[5] = texCoords.top;
+    texCoord[6] = texCoords.left;   texCoord[7] = texCoords.top;
+    sQuadCount++;
+}
+
+void Flush()
+{
+    int quadCount = sQuadCount - sBatchStart;
+    BatchKind kind = sBatchKind;
+    sBatchKind = BatchKind::NONE;
+    if (quadCount == 0 || kind == BatchKind::NONE) {
+        return;
+    }
+
+    uint32_t firstVertex = (sRegionStart + sBatchStart) * VERTICES_PER_QUAD;
+    uint32_t vertexCount = quadCount * VERTICES_PER_QUAD;
+    sBatchStart = sQuadCount;
+
+    // The region was invalidated for the GPU in Begin(); only the CPU's
+    // cache still holds the new vertices
+    float* positions = sPositions + firstVertex * 3;
+    DCFlushRange(positions, vertexCount * Shader::cuVertexAttrSize);
+
+    const glm::vec3 noOffset(0.0f);
+    const glm::vec3 noScale(1.0f);
+
+    if (kind == BatchKind::COLOR) {
+        uint8_t* colors = sColors + firstVertex * 4;
+        DCFlushRange(colors, vertexCount * Shader::cuColorAttrSize);
+
+        ColorShader* shader = ColorShader::instance();
+        if (sBoundKind != BatchKind::COLOR) {
+            shader->setShaders();
+            shader->setAngle(0.0f);
+            shader->setOffset(noOffset);
+            shader->setScale(noScale);
+            shader->setColorIntensity(glm::vec4(1.0f));
+            sBoundKind = BatchKind::COLOR;
+        }
+        shader->setAttributeBuffer(colors, positions, vertexCount);
+        shader->draw(GX2_PRIMITIVE_MODE_QUADS, vertexCount);
+    } else {
+        float* texCoords = sTexCoords + firstVertex * 2;
+        DCFlushRange(texCoords, vertexCount * Shader::cuTexCoordAttrSize);
+
+        Texture2DShader* shader = Texture2DShader::instance();
+        if (sBoundKind != BatchKind::TEXTURE) {
+            shader->setShaders();
+            shader->setAngle(0.0f);
+            shader->setOffset(noOffset);
+            shader->setScale(noScale);
+            shader->setBlurring(glm::vec3(0.0f));
+            sBoundKind = BatchKind::TEXTURE;
+        }
+        shader->setColorIntensity(toColorVector(sBatchColor));
+        shader->setTextureAndSampler(sBatchTexture, sBatchSampler);
+        shader->setAttributeBuffer(texCoords, positions, vertexCount);
+        shader->draw(GX2_PRIMITIVE_MODE_QUADS, vertexCount);
+    }
+
+    sDrawCount++;
+}
+
+void End()
+{
+    Flush();
+    GX2Flush();
+    sRegionFences[sRegion] = GX2GetLastSubmittedTimeStamp();
+}
+
+int GetDrawCount()
+{
+    return sDrawCount;
+}
+
+} // namespace QuadBatch
+
+#endif // ENABLE_GX2_RENDERING
@@ -0,0 +1,125 @@
+/**
+ * GX2 Quad Batcher
+ *
+ * Collects the overlay's rectangles and glyphs as quads and draws each run
+ * that shares a shader, texture and tint with one GX2DrawEx call, instead
+ * of setting every uniform and issuing a draw per quad.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Quads are written in screen pixels into per-frame vertex buffers, with
+ * positions already in NDC so the shaders' offset/scale/angle uniforms
+ * stay at identity. A quad that can't join the pending run flushes it
+ * first, so draw order is kept. Solid rectangles carry their color per
+ * vertex and always batch together; textured quads batch while the
+ * texture, sampler and tint stay the same.
+ *
+ * The buffers are a ring of FRAMES_IN_FLIGHT regions, so each frame
+ * writes fresh space while the GPU may still be reading earlier ones.
+ * End() fences a region with the GPU timestamp of the frame's submission,
+ * and Begin() only waits if the region it is about to reuse hasn't
+ * retired yet. The GPU's view of a region is invalidated once per frame;
+ * each run only flushes the CPU cache.
+ *
+ * A frame drawn inside the game's frame starts with TryBegin() instead,
+ * which never waits: it fails if the region isn't free yet, and quads past
+ * MAX_QUADS are dropped instead of waiting for the GPU to catch up. That
+ * caps the GPU work one frame can add to the game's.
+ *
+ * USAGE:
+ * ------
+ *   QuadBatch::Begin(screenWidth, screenHeight);
+ *   QuadBatch::AddRect(0, 0, 100, 24, 0x333333FF);
+ *   QuadBatch::AddTexturedRect(texture, sampler, 8, 4, 16, 16, QuadBatch::FULL_TEXTURE, color);
+ *   QuadBatch::End();
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <gx2/sampler.h>
+#include <gx2/texture.h>
+
+namespace QuadBatch {
+
+// Quads one frame's region holds before the frame has to wait on the GPU
+// to reuse it
+constexpr int MAX_QUADS = 2048;
+
+// Frames whose vertices can be in flight at once. Anything the GPU reads
+// in frame N (like an icon texture) may be rewritten from frame
+// N + FRAMES_IN_FLIGHT on. The overlay draws a frame per scan buffer copy,
+// so this covers three game frames of TV and DRC copies
+constexpr int FRAMES_IN_FLIGHT = 6;
+
+/**
+ * Part of a texture to sample, in normalized coordinates.
+ */
+struct TexCoords {
+    float left;
+    float top;
+    float right;
+    float bottom;
+};
+
+constexpr TexCoords FULL_TEXTURE = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+/**
+ * Allocate the vertex buffers.
+ * @return true on success
+ */
+bool Init();
+
+/**
+ * Free the vertex buffers.
+ */
+void Shutdown();
+
+/**
+ * Start a frame in the next ring region, waiting only if the GPU hasn't
+ * finished the frame that last used it.
+ * @param screenWidth Render target width in pixels
+ * @param screenHeight Render target height in pixels
+ */
+void Begin(float screenWidth, float screenHeight);
+
+/**
+ * Start a frame in the next ring region without ever waiting on the GPU.
+ * Quads past MAX_QUADS are dropped.
+ * @return false, with nothing started, if the region is still in flight
+ */
+bool TryBegin(float screenWidth, float screenHeight);
+
+/**
+ * Add a solid rectangle.
+ * @param color Fill color (RGBA)
+ */
+void AddRect(float x, float y, float width, float height, uint32_t color);
+
+/**
+ * Add a textured rectangle tinted by color.
+ * @param texture Texture to sample
+ * @param sampler Sampler to use
+ * @param texCoords Part of the texture to map onto the rectangle
+ * @param color Tint (RGBA), multiplied with the texture
+ */
+void AddTexturedRect(const GX2Texture* texture, const GX2Sampler* sampler,
+                     float x, float y, float width, float height,
+                     const TexCoords& texCoords, uint32_t color);
+
+/**
+ * Draw the pending run of quads.
+ */
+void Flush();
+
+/**
+ * Flush, submit the frame to the GPU (GX2Flush) and fence its region.
+ */
+void End();
+
+/**
+ * Get the number of draw calls issued since Begin().
+ */
+int GetDrawCount();
+
+} // namespace QuadBatch
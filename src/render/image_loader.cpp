@@ -1,15 +1,29 @@
 /**
  * Async image loading with priority queue.
  * Uses ImageStore for loading from various sources.
+ *
+ * Reading and decoding run on a worker thread. The menu thread hands it
+ * title IDs through one single-producer/single-consumer ring and takes
+ * decoded images back through another, so Update() only drains results
+ * and tops up the job ring. Neither side ever blocks on the other.
  */
 
 #include "image_loader.h"
 #include "renderer.h"
 #include "../storage/image_store.h"
+#include "../titles/titles.h"
+#include "../utils/worker_threads.h"
+
+#include <coreinit/event.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
 
-#include <map>
-#include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <vector>
 
 namespace ImageLoader {
 
@@ -22,39 +36,701 @@ struct RequestInfo {
     Priority priority;
     Status status;
     Renderer::ImageHandle handle;
+
+    // Position in loadQueue while QUEUED, -1 otherwise
+    int heapIndex;
+
+    // Request order, so equal priorities load first-come first-served
+    uint32_t sequence;
+
+    // Why the last load failed, and when a transient failure may retry
+    ImageStore::LoadError failure;
+    int failedAttempts;
+    OSTime retryAfter;
 };
 
-std::map<uint64_t, RequestInfo> requestMap;
-std::vector<uint64_t> loadQueue;
+// Binary max-heap of QUEUED requests by (priority, earliest sequence)
+std::vector<RequestInfo*> loadQueue;
+uint32_t nextSequence = 0;
 
 int updateCallCount = 0;
 int lastQueueSize = 0;
 
-void sortLoadQueue()
+// =============================================================================
+// Request Table
+// =============================================================================
+// One RequestInfo per title requested since the last clear. Entries live
+// in fixed-size blocks that never move, so the load queue can point
+// straight at them, and an open-addressed table of entry indices finds
+// them by title ID, like the title store's ID index. Blocks are allocated
+// as the table grows and kept until ClearCache() or Shutdown(): once the
+// library has been scrolled through, requesting, re-prioritizing and
+// cancelling allocate nothing, where a node per title used to come and
+// go on the plugin heap in the middle of browsing.
+
+constexpr int REQUEST_BLOCK_SIZE = 64;
+constexpr int MAX_REQUEST_BLOCKS = (Titles::MAX_TITLES + REQUEST_BLOCK_SIZE - 1) / REQUEST_BLOCK_SIZE;
+constexpr int MIN_REQUEST_SLOTS = 128;
+
+// Slots hold requestIndex + 1 so zeroed tables start out empty
+constexpr uint16_t EMPTY_SLOT = 0;
+
+RequestInfo* requestBlocks[MAX_REQUEST_BLOCKS] = {};
+int requestBlockCount = 0;
+int requestCount = 0;
+
+uint16_t* requestSlots = nullptr;
+int requestSlotCount = 0;
+
+uint32_t hashTitleId(uint64_t titleId)
+{
+    uint64_t mixed = titleId * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(mixed >> 32);
+}
+
+RequestInfo& requestAt(int requestIndex)
+{
+    return requestBlocks[requestIndex / REQUEST_BLOCK_SIZE][requestIndex % REQUEST_BLOCK_SIZE];
+}
+
+// Entries that fit both the blocks and a half-full index
+int getRequestCapacity()
+{
+    return std::min(requestBlockCount * REQUEST_BLOCK_SIZE, requestSlotCount / 2);
+}
+
+void insertSlot(int requestIndex)
+{
+    int slot = hashTitleId(requestAt(requestIndex).titleId) & (requestSlotCount - 1);
+    while (requestSlots[slot] != EMPTY_SLOT) {
+        slot = (slot + 1) & (requestSlotCount - 1);
+    }
+    requestSlots[slot] = static_cast<uint16_t>(requestIndex + 1);
+}
+
+RequestInfo* findRequest(uint64_t titleId)
+{
+    if (requestCount == 0) {
+        return nullptr;
+    }
+
+    int slot = hashTitleId(titleId) & (requestSlotCount - 1);
+    while (requestSlots[slot] != EMPTY_SLOT) {
+        RequestInfo& request = requestAt(requestSlots[slot] - 1);
+        if (request.titleId == titleId) {
+            return &request;
+        }
+        slot = (slot + 1) & (requestSlotCount - 1);
+    }
+    return nullptr;
+}
+
+/**
+ * Make room for count entries: blocks to hold them, an index at most half
+ * full and a load queue that can take all of them.
+ *
+ * @return false if an allocation failed (what was added is kept)
+ */
+bool reserveRequests(int count)
+{
+    count = std::min(count, MAX_REQUEST_BLOCKS * REQUEST_BLOCK_SIZE);
+    while (requestBlockCount * REQUEST_BLOCK_SIZE < count) {
+        RequestInfo* block = static_cast<RequestInfo*>(malloc(REQUEST_BLOCK_SIZE * sizeof(RequestInfo)));
+        if (!block) {
+            return false;
+        }
+        requestBlocks[requestBlockCount++] = block;
+    }
+
+    int capacity = requestBlockCount * REQUEST_BLOCK_SIZE;
+    int requiredSlots = MIN_REQUEST_SLOTS;
+    while (requiredSlots < capacity * 2) {
+        requiredSlots *= 2;
+    }
+    if (requiredSlots > requestSlotCount) {
+        uint16_t* newSlots = static_cast<uint16_t*>(malloc(requiredSlots * sizeof(uint16_t)));
+        if (!newSlots) {
+            return false;
+        }
+        free(requestSlots);
+        requestSlots = newSlots;
+        requestSlotCount = requiredSlots;
+        memset(requestSlots, 0, requestSlotCount * sizeof(uint16_t));
+        for (int requestIndex = 0; requestIndex < requestCount; requestIndex++) {
+            insertSlot(requestIndex);
+        }
+    }
+
+    loadQueue.reserve(capacity);
+    return true;
+}
+
+// Forget every entry, keeping the blocks for the next requests
+void clearRequests()
+{
+    requestCount = 0;
+    if (requestSlots) {
+        memset(requestSlots, 0, requestSlotCount * sizeof(uint16_t));
+    }
+}
+
+// Forget every entry and give the memory back. The queue must be clear
+void releaseRequests()
+{
+    for (int blockIndex = 0; blockIndex < requestBlockCount; blockIndex++) {
+        free(requestBlocks[blockIndex]);
+        requestBlocks[blockIndex] = nullptr;
+    }
+    free(requestSlots);
+    requestSlots = nullptr;
+    requestSlotCount = 0;
+    requestBlockCount = 0;
+    requestCount = 0;
+    std::vector<RequestInfo*>().swap(loadQueue);
+}
+
+// =============================================================================
+// Failures
+// =============================================================================
+// A missing or undecodable icon stays FAILED; asking again would only
+// repeat the same lookups. Read errors and allocation failures retry,
+// each time waiting twice as long as the last.
+
+constexpr int RETRY_BACKOFF_MS = 2000;
+constexpr int MAX_RETRY_BACKOFF_MS = 5 * 60 * 1000;
+
+bool isTransient(ImageStore::LoadError error)
+{
+    return error == ImageStore::LoadError::READ_FAILED ||
+           error == ImageStore::LoadError::OUT_OF_MEMORY;
+}
+
+bool canRetry(const RequestInfo& request)
+{
+    return request.status == Status::FAILED && isTransient(request.failure) &&
+           OSGetTime() >= request.retryAfter;
+}
+
+void recordFailure(RequestInfo& request, ImageStore::LoadError error)
+{
+    request.status = Status::FAILED;
+    request.handle = Renderer::INVALID_IMAGE;
+    request.failure = error;
+    if (!isTransient(error)) {
+        return;
+    }
+
+    int backoffMs = RETRY_BACKOFF_MS;
+    for (int attempt = 0; attempt < request.failedAttempts && backoffMs < MAX_RETRY_BACKOFF_MS; attempt++) {
+        backoffMs *= 2;
+    }
+    if (backoffMs > MAX_RETRY_BACKOFF_MS) {
+        backoffMs = MAX_RETRY_BACKOFF_MS;
+    }
+    request.failedAttempts++;
+    request.retryAfter = OSGetTime() + OSMillisecondsToTicks(backoffMs);
+}
+
+void recordSuccess(RequestInfo& request, Renderer::ImageHandle handle)
+{
+    request.status = Status::READY;
+    request.handle = handle;
+    request.failure = ImageStore::LoadError::NONE;
+    request.failedAttempts = 0;
+}
+
+// =============================================================================
+// Decode Worker
+// =============================================================================
+// The menu thread is the only producer of jobs and the only consumer of
+// results; the worker is the reverse. At most WORKER_RING_SIZE jobs are in
+// flight, so the result ring can never fill up.
+
+constexpr uint32_t WORKER_RING_SIZE = 8;
+
+// libgd's PNG/JPEG decoders keep their large state on the heap
+constexpr int WORKER_STACK_SIZE = 64 * 1024;
+
+struct WorkerJob {
+    uint64_t titleId;
+    int iconSize;
+    Renderer::PixelFormat format;
+    bool isHighPriority;
+};
+
+struct WorkerResult {
+    uint64_t titleId;
+    Renderer::ImageHandle handle;
+    ImageStore::LoadError error;
+    int iconSize;
+    bool isHighPriority;
+};
+
+WorkerJob jobRing[WORKER_RING_SIZE];
+std::atomic<uint32_t> jobRingHead{0};
+std::atomic<uint32_t> jobRingTail{0};
+
+WorkerResult resultRing[WORKER_RING_SIZE];
+std::atomic<uint32_t> resultRingHead{0};
+std::atomic<uint32_t> resultRingTail{0};
+
+// Menu thread only: jobs pushed whose results haven't been drained yet
+int inFlightCount = 0;
+int highPriorityInFlight = 0;
+
+// Auto-reset; signaled after every job push and on shutdown
+OSEvent workerEvent;
+std::atomic<bool> isWorkerStopping{false};
+
+OSThread* workerThread = nullptr;
+uint8_t* workerStack = nullptr;
+bool isWorkerRunning = false;
+
+// Stopped with the application that ran it (OnApplicationEnd); the next
+// Update() starts another
+bool isWorkerParked = false;
+
+// Edited icons on their way to ImageStore::ReplaceStoredIcon(), which
+// rewrites the icon pack and so runs on the worker. Another single-
+// producer/single-consumer ring; the worker empties it before each load
+// and flush, so nothing reads the replaced icon from storage
+constexpr uint32_t EDIT_RING_SIZE = 4;
+
+struct IconEdit {
+    uint64_t titleId;
+    uint32_t* pixels;  // malloc'd, freed once applied
+    int width;
+    int height;
+};
+
+IconEdit editRing[EDIT_RING_SIZE];
+std::atomic<uint32_t> editRingHead{0};
+std::atomic<uint32_t> editRingTail{0};
+
+// On the worker, or on the menu thread once the worker has stopped
+void applyIconEdits()
+{
+    uint32_t tail = editRingTail.load(std::memory_order_relaxed);
+    uint32_t head = editRingHead.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        IconEdit& edit = editRing[tail % EDIT_RING_SIZE];
+        ImageStore::ReplaceStoredIcon(edit.titleId, edit.pixels, edit.width, edit.height);
+        free(edit.pixels);
+        edit.pixels = nullptr;
+    }
+    editRingTail.store(tail, std::memory_order_release);
+}
+
+int workerThreadEntry(int, const char**)
+{
+    while (!isWorkerStopping.load(std::memory_order_acquire)) {
+        applyIconEdits();
+
+        uint32_t tail = jobRingTail.load(std::memory_order_relaxed);
+        uint32_t head = jobRingHead.load(std::memory_order_acquire);
+        if (tail == head) {
+            // Idle: write out the icon pack and SD copies before sleeping
+            ImageStore::FlushPendingWrites();
+            OSWaitEvent(&workerEvent);
+            continue;
+        }
+
+        WorkerJob job = jobRing[tail % WORKER_RING_SIZE];
+        jobRingTail.store(tail + 1, std::memory_order_release);
+
+        WorkerResult result;
+        result.titleId = job.titleId;
+        result.handle = ImageStore::LoadFromStorage(job.titleId, job.iconSize, job.format, &result.error);
+        result.iconSize = job.iconSize;
+        result.isHighPriority = job.isHighPriority;
+
+        uint32_t resultHead = resultRingHead.load(std::memory_order_relaxed);
+        resultRing[resultHead % WORKER_RING_SIZE] = result;
+        resultRingHead.store(resultHead + 1, std::memory_order_release);
+    }
+    return 0;
+}
+
+void startWorker()
 {
-    std::sort(loadQueue.begin(), loadQueue.end(),
-        [](uint64_t titleIdFirst, uint64_t titleIdSecond) {
-            auto requestIterFirst = requestMap.find(titleIdFirst);
-            auto requestIterSecond = requestMap.find(titleIdSecond);
-            if (requestIterFirst == requestMap.end()) return false;
-            if (requestIterSecond == requestMap.end()) return true;
-            return static_cast<int>(requestIterFirst->second.priority) >
-                   static_cast<int>(requestIterSecond->second.priority);
-        });
+    jobRingHead.store(0);
+    jobRingTail.store(0);
+    resultRingHead.store(0);
+    resultRingTail.store(0);
+    editRingHead.store(0);
+    editRingTail.store(0);
+    inFlightCount = 0;
+    highPriorityInFlight = 0;
+    isWorkerStopping.store(false);
+    OSInitEvent(&workerEvent, FALSE, OS_EVENT_MODE_AUTO);
+
+    workerThread = static_cast<OSThread*>(memalign(16, sizeof(OSThread)));
+    workerStack = static_cast<uint8_t*>(memalign(16, WORKER_STACK_SIZE));
+
+    isWorkerRunning = workerThread && workerStack &&
+                      OSCreateThread(workerThread, workerThreadEntry, 0, nullptr,
+                                     workerStack + WORKER_STACK_SIZE, WORKER_STACK_SIZE,
+                                     24, WorkerThreads::GetAffinity());
+    if (!isWorkerRunning) {
+        // Update() falls back to loading images within its time budget
+        free(workerThread);
+        free(workerStack);
+        workerThread = nullptr;
+        workerStack = nullptr;
+        return;
+    }
+
+    OSSetThreadName(workerThread, "TitleSwitcher Images");
+    WorkerThreads::Register(workerThread);
+    OSResumeThread(workerThread);
 }
 
+void stopWorker()
+{
+    if (!isWorkerRunning) {
+        return;
+    }
+
+    // Jobs still in the ring are dropped, not decoded
+    isWorkerStopping.store(true, std::memory_order_release);
+    OSSignalEvent(&workerEvent);
+
+    int threadResult = 0;
+    OSJoinThread(workerThread, &threadResult);
+    WorkerThreads::Unregister(workerThread);
+    free(workerThread);
+    free(workerStack);
+    workerThread = nullptr;
+    workerStack = nullptr;
+    isWorkerRunning = false;
+
+    // Edits are kept even if the worker never got to them
+    applyIconEdits();
+
+    // Decoded images nobody collected aren't in the memory cache yet
+    uint32_t tail = resultRingTail.load();
+    uint32_t head = resultRingHead.load();
+    for (; tail != head; tail++) {
+        ImageStore::FreeImage(resultRing[tail % WORKER_RING_SIZE].handle);
+    }
+    resultRingTail.store(tail);
+    inFlightCount = 0;
+    highPriorityInFlight = 0;
+}
+
+// =============================================================================
+// Load Queue (indexed binary heap)
+// =============================================================================
+// Every RequestInfo in the heap knows its slot, so re-prioritizing and
+// cancelling sift one entry in O(log n) instead of searching the queue.
+
+bool loadsBefore(const RequestInfo* first, const RequestInfo* second)
+{
+    if (first->priority != second->priority) {
+        return first->priority > second->priority;
+    }
+    // Wrap-safe "issued earlier"
+    return static_cast<int32_t>(first->sequence - second->sequence) < 0;
 }
 
-bool Init(int cacheSize)
+void placeInQueue(RequestInfo* request, int heapIndex)
+{
+    loadQueue[heapIndex] = request;
+    request->heapIndex = heapIndex;
+}
+
+void siftUp(int heapIndex)
+{
+    RequestInfo* request = loadQueue[heapIndex];
+    while (heapIndex > 0) {
+        int parentIndex = (heapIndex - 1) / 2;
+        if (!loadsBefore(request, loadQueue[parentIndex])) {
+            break;
+        }
+        placeInQueue(loadQueue[parentIndex], heapIndex);
+        heapIndex = parentIndex;
+    }
+    placeInQueue(request, heapIndex);
+}
+
+void siftDown(int heapIndex)
+{
+    int queueSize = static_cast<int>(loadQueue.size());
+    RequestInfo* request = loadQueue[heapIndex];
+    for (;;) {
+        int childIndex = heapIndex * 2 + 1;
+        if (childIndex >= queueSize) {
+            break;
+        }
+        if (childIndex + 1 < queueSize && loadsBefore(loadQueue[childIndex + 1], loadQueue[childIndex])) {
+            childIndex++;
+        }
+        if (!loadsBefore(loadQueue[childIndex], request)) {
+            break;
+        }
+        placeInQueue(loadQueue[childIndex], heapIndex);
+        heapIndex = childIndex;
+    }
+    placeInQueue(request, heapIndex);
+}
+
+void pushQueue(RequestInfo* request)
+{
+    request->status = Status::QUEUED;
+    request->sequence = nextSequence++;
+    loadQueue.push_back(request);
+    siftUp(static_cast<int>(loadQueue.size()) - 1);
+}
+
+void removeFromQueue(RequestInfo* request)
+{
+    int heapIndex = request->heapIndex;
+    if (heapIndex < 0) {
+        return;
+    }
+    request->heapIndex = -1;
+
+    RequestInfo* last = loadQueue.back();
+    loadQueue.pop_back();
+    if (last == request) {
+        return;
+    }
+
+    // The moved entry may belong above or below the hole
+    placeInQueue(last, heapIndex);
+    siftUp(heapIndex);
+    siftDown(last->heapIndex);
+}
+
+RequestInfo* popQueue()
+{
+    RequestInfo* request = loadQueue.front();
+    removeFromQueue(request);
+    return request;
+}
+
+void setQueuedPriority(RequestInfo* request, Priority priority)
+{
+    Priority previous = request->priority;
+    request->priority = priority;
+    if (request->heapIndex < 0 || priority == previous) {
+        return;
+    }
+    if (priority > previous) {
+        siftUp(request->heapIndex);
+    } else {
+        siftDown(request->heapIndex);
+    }
+}
+
+void clearQueue()
+{
+    for (RequestInfo* request : loadQueue) {
+        request->heapIndex = -1;
+    }
+    loadQueue.clear();
+}
+
+void finishLoad(uint64_t titleId, Renderer::ImageHandle handle, ImageStore::LoadError error, int iconSize)
+{
+    // Evicted, cleared or re-queued while the worker had it
+    RequestInfo* request = findRequest(titleId);
+    if (!request || request->status != Status::LOADING) {
+        ImageStore::FreeImage(handle);
+        return;
+    }
+
+    // Decoded for a layout or format that has since changed
+    if (handle != Renderer::INVALID_IMAGE &&
+        (iconSize != ImageStore::GetIconSize() || handle->format != ImageStore::GetPixelFormat())) {
+        ImageStore::FreeImage(handle);
+        pushQueue(request);
+        return;
+    }
+
+    if (handle == Renderer::INVALID_IMAGE) {
+        recordFailure(*request, error);
+        return;
+    }
+
+    if (ImageStore::IsSourceEnabled(ImageStore::Source::MEMORY)) {
+        ImageStore::StoreInMemoryCache(titleId, handle);
+    }
+    recordSuccess(*request, handle);
+}
+
+// Results left when the deadline passes wait in the ring for the next call
+void drainResults(OSTime deadline)
+{
+    uint32_t tail = resultRingTail.load(std::memory_order_relaxed);
+    uint32_t head = resultRingHead.load(std::memory_order_acquire);
+    bool hasDrained = false;
+    for (; tail != head; tail++) {
+        if (hasDrained && OSGetSystemTime() >= deadline) {
+            break;
+        }
+        hasDrained = true;
+
+        const WorkerResult& result = resultRing[tail % WORKER_RING_SIZE];
+        inFlightCount--;
+        if (result.isHighPriority) {
+            highPriorityInFlight--;
+        }
+        finishLoad(result.titleId, result.handle, result.error, result.iconSize);
+    }
+    resultRingTail.store(tail, std::memory_order_release);
+}
+
+void feedWorker()
+{
+    bool hasPushed = false;
+    while (!loadQueue.empty() && inFlightCount < static_cast<int>(WORKER_RING_SIZE)) {
+        RequestInfo* request = popQueue();
+        uint64_t titleId = request->titleId;
+
+        // Already decoded for an earlier request, or kept compressed
+        Renderer::ImageHandle cached = ImageStore::GetFromMemoryCache(titleId);
+        if (cached == Renderer::INVALID_IMAGE) {
+            cached = ImageStore::PromoteFromWarmCache(titleId);
+        }
+        if (cached != Renderer::INVALID_IMAGE) {
+            request->status = Status::READY;
+            request->handle = cached;
+            continue;
+        }
+
+        request->status = Status::LOADING;
+        bool isHighPriority = request->priority == Priority::HIGH;
+
+        uint32_t head = jobRingHead.load(std::memory_order_relaxed);
+        jobRing[head % WORKER_RING_SIZE] = { titleId, ImageStore::GetIconSize(),
+                                             ImageStore::GetPixelFormat(), isHighPriority };
+        jobRingHead.store(head + 1, std::memory_order_release);
+
+        inFlightCount++;
+        if (isHighPriority) {
+            highPriorityInFlight++;
+        }
+        hasPushed = true;
+    }
+
+    if (hasPushed) {
+        OSSignalEvent(&workerEvent);
+    }
+}
+
+// Used when the worker thread couldn't be created
+void loadNextSync()
+{
+    RequestInfo* request = popQueue();
+    request->status = Status::LOADING;
+
+    Renderer::ImageHandle handle;
+    ImageStore::LoadError error;
+    if (ImageStore::Load(request->titleId, handle, &error)) {
+        recordSuccess(*request, handle);
+    } else {
+        recordFailure(*request, error);
+    }
+}
+
+// Loads a stopped worker dropped go back in the queue
+void requeueInFlight()
+{
+    for (int requestIndex = 0; requestIndex < requestCount; requestIndex++) {
+        RequestInfo& request = requestAt(requestIndex);
+        if (request.status == Status::LOADING) {
+            pushQueue(&request);
+        }
+    }
+}
+
+// The entry for a title, reset to NOT_REQUESTED; the caller makes sure
+// an existing entry isn't queued. Null when the table can't grow
+RequestInfo* addRequest(uint64_t titleId, Priority priority)
+{
+    RequestInfo* request = findRequest(titleId);
+    if (!request) {
+        // Full at MAX_TITLES entries, or out of memory
+        if (requestCount >= getRequestCapacity()) {
+            reserveRequests(requestCount + 1);
+            if (requestCount >= getRequestCapacity()) {
+                return nullptr;
+            }
+        }
+        request = &requestAt(requestCount);
+        request->titleId = titleId;
+        insertSlot(requestCount++);
+    }
+
+    RequestInfo newRequest;
+    newRequest.titleId = titleId;
+    newRequest.priority = priority;
+    newRequest.status = Status::NOT_REQUESTED;
+    newRequest.handle = Renderer::INVALID_IMAGE;
+    newRequest.heapIndex = -1;
+    newRequest.sequence = 0;
+    newRequest.failure = ImageStore::LoadError::NONE;
+    newRequest.failedAttempts = 0;
+    newRequest.retryAfter = 0;
+
+    *request = newRequest;
+    return request;
+}
+
+// Side set by SetIconSize(), or 0 for the layout's details icon
+int requestedIconSize = 0;
+
+// Decode at the size the layout draws icons, so drawing doesn't rescale.
+// Cached icons of the old size are dropped; Get() re-queues them
+void followLayoutIconSize()
+{
+    ImageStore::SetIconSize(requestedIconSize > 0 ? requestedIconSize : Renderer::GetLayout().iconSize);
+}
+
+/**
+ * Have the worker store an edited icon (see applyIconEdits). Without a
+ * worker it is stored here. Waits for room if the worker is still busy
+ * with earlier edits.
+ */
+void queueIconEdit(uint64_t titleId, const uint32_t* pixels, int width, int height)
+{
+    if (!isWorkerRunning) {
+        ImageStore::ReplaceStoredIcon(titleId, pixels, width, height);
+        return;
+    }
+
+    size_t pixelBytes = static_cast<size_t>(width) * height * sizeof(uint32_t);
+    uint32_t* copy = static_cast<uint32_t*>(malloc(pixelBytes));
+    if (copy) {
+        memcpy(copy, pixels, pixelBytes);
+    }
+
+    // Without a copy the old packed icon is still forgotten; the next
+    // load finds the edit's PNG in the SD icon folder
+    uint32_t head = editRingHead.load(std::memory_order_relaxed);
+    while (head - editRingTail.load(std::memory_order_acquire) >= EDIT_RING_SIZE) {
+        OSSleepTicks(OSMillisecondsToTicks(1));
+    }
+    editRing[head % EDIT_RING_SIZE] = { titleId, copy, copy ? width : 0, copy ? height : 0 };
+    editRingHead.store(head + 1, std::memory_order_release);
+    OSSignalEvent(&workerEvent);
+}
+
+}
+
+bool Init(size_t cacheBudgetBytes)
 {
     if (isInitialized) {
         return true;
     }
 
-    ImageStore::Init(cacheSize > 0 ? cacheSize : DEFAULT_CACHE_SIZE);
+    ImageStore::Init(cacheBudgetBytes > 0 ? cacheBudgetBytes : DEFAULT_CACHE_BUDGET);
+    followLayoutIconSize();
 
-    requestMap.clear();
-    loadQueue.clear();
+    clearQueue();
+    clearRequests();
+    startWorker();
     isInitialized = true;
     return true;
 }
@@ -65,41 +741,54 @@ void Shutdown()
         return;
     }
 
+    stopWorker();
+    isWorkerParked = false;
     ImageStore::Shutdown();
-    requestMap.clear();
-    loadQueue.clear();
+    clearQueue();
+    releaseRequests();
     isInitialized = false;
 }
 
-void Update()
+void OnApplicationEnd()
+{
+    if (!isInitialized || !isWorkerRunning) {
+        return;
+    }
+
+    stopWorker();
+    requeueInFlight();
+    isWorkerParked = true;
+}
+
+void Update(uint32_t budgetMicros)
 {
     updateCallCount++;
     lastQueueSize = static_cast<int>(loadQueue.size());
 
-    if (!isInitialized || loadQueue.empty()) {
+    if (!isInitialized) {
         return;
     }
 
-    sortLoadQueue();
+    followLayoutIconSize();
+    OSTime deadline = OSGetSystemTime() + OSMicrosecondsToTicks(budgetMicros);
 
-    uint64_t titleId = loadQueue.front();
-    loadQueue.erase(loadQueue.begin());
+    if (isWorkerParked) {
+        isWorkerParked = false;
+        startWorker();
+    }
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator == requestMap.end()) {
+    if (!isWorkerRunning) {
+        while (!loadQueue.empty()) {
+            loadNextSync();
+            if (OSGetSystemTime() >= deadline) {
+                break;
+            }
+        }
         return;
     }
 
-    requestIterator->second.status = Status::LOADING;
-
-    Renderer::ImageHandle handle;
-    if (ImageStore::Load(titleId, handle)) {
-        requestIterator->second.status = Status::READY;
-        requestIterator->second.handle = handle;
-    } else {
-        requestIterator->second.status = Status::FAILED;
-        requestIterator->second.handle = Renderer::INVALID_IMAGE;
-    }
+    drainResults(deadline);
+    feedWorker();
 }
 
 void Request(uint64_t titleId, Priority priority)
@@ -108,28 +797,31 @@ void Request(uint64_t titleId, Priority priority)
         return;
     }
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end()) {
-        if (requestIterator->second.status == Status::READY) {
+    RequestInfo* existing = findRequest(titleId);
+    if (existing) {
+        if (existing->status == Status::READY) {
             return;
         }
-        if (requestIterator->second.status == Status::QUEUED ||
-            requestIterator->second.status == Status::LOADING) {
-            if (priority > requestIterator->second.priority) {
-                requestIterator->second.priority = priority;
+        if (existing->status == Status::FAILED) {
+            // Asked for every frame while shown; only a due retry loads
+            if (canRetry(*existing)) {
+                existing->priority = priority;
+                pushQueue(existing);
+            }
+            return;
+        }
+        if (existing->status == Status::QUEUED || existing->status == Status::LOADING) {
+            if (priority > existing->priority) {
+                setQueuedPriority(existing, priority);
             }
             return;
         }
     }
 
-    RequestInfo newRequest;
-    newRequest.titleId = titleId;
-    newRequest.priority = priority;
-    newRequest.status = Status::QUEUED;
-    newRequest.handle = Renderer::INVALID_IMAGE;
-
-    requestMap[titleId] = newRequest;
-    loadQueue.push_back(titleId);
+    RequestInfo* request = addRequest(titleId, priority);
+    if (request) {
+        pushQueue(request);
+    }
 }
 
 void Cancel(uint64_t titleId)
@@ -138,14 +830,10 @@ void Cancel(uint64_t titleId)
         return;
     }
 
-    auto queueIterator = std::find(loadQueue.begin(), loadQueue.end(), titleId);
-    if (queueIterator != loadQueue.end()) {
-        loadQueue.erase(queueIterator);
-    }
-
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end() && requestIterator->second.status == Status::QUEUED) {
-        requestIterator->second.status = Status::NOT_REQUESTED;
+    RequestInfo* request = findRequest(titleId);
+    if (request && request->status == Status::QUEUED) {
+        removeFromQueue(request);
+        request->status = Status::NOT_REQUESTED;
     }
 }
 
@@ -155,9 +843,9 @@ void SetPriority(uint64_t titleId, Priority priority)
         return;
     }
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end()) {
-        requestIterator->second.priority = priority;
+    RequestInfo* request = findRequest(titleId);
+    if (request) {
+        setQueuedPriority(request, priority);
     }
 }
 
@@ -167,11 +855,8 @@ Status GetStatus(uint64_t titleId)
         return Status::NOT_REQUESTED;
     }
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end()) {
-        return requestIterator->second.status;
-    }
-    return Status::NOT_REQUESTED;
+    RequestInfo* request = findRequest(titleId);
+    return request ? request->status : Status::NOT_REQUESTED;
 }
 
 bool IsReady(uint64_t titleId)
@@ -181,11 +866,13 @@ bool IsReady(uint64_t titleId)
 
 bool HasHighPriorityPending()
 {
-    if (!isInitialized || loadQueue.empty()) {
+    if (!isInitialized) {
         return false;
     }
-    auto it = requestMap.find(loadQueue.front());
-    return it != requestMap.end() && it->second.priority == Priority::HIGH;
+    if (highPriorityInFlight > 0) {
+        return true;
+    }
+    return !loadQueue.empty() && loadQueue.front()->priority == Priority::HIGH;
 }
 
 Renderer::ImageHandle Get(uint64_t titleId)
@@ -194,11 +881,22 @@ Renderer::ImageHandle Get(uint64_t titleId)
         return Renderer::INVALID_IMAGE;
     }
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end() && requestIterator->second.status == Status::READY) {
-        return requestIterator->second.handle;
+    RequestInfo* request = findRequest(titleId);
+    if (!request || request->status != Status::READY) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    if (!ImageStore::IsSourceEnabled(ImageStore::Source::MEMORY)) {
+        return request->handle;
     }
-    return Renderer::INVALID_IMAGE;
+
+    // The cache owns the image and may have evicted it to stay in budget;
+    // load it again rather than hand out a freed handle
+    request->handle = ImageStore::GetFromMemoryCache(titleId);
+    if (request->handle == Renderer::INVALID_IMAGE) {
+        pushQueue(request);
+    }
+    return request->handle;
 }
 
 void GetDebugInfo(int* outUpdateCalls, int* outQueueSize, bool* outInitialized)
@@ -212,8 +910,8 @@ void GetLoadingStats(int* outPending, int* outReady, int* outFailed, int* outTot
 {
     int pending = 0, ready = 0, failed = 0;
 
-    for (const auto& entry : requestMap) {
-        switch (entry.second.status) {
+    for (int requestIndex = 0; requestIndex < requestCount; requestIndex++) {
+        switch (requestAt(requestIndex).status) {
             case Status::QUEUED:
             case Status::LOADING:
                 pending++;
@@ -241,10 +939,10 @@ void RetryFailed()
         return;
     }
 
-    for (auto& entry : requestMap) {
-        if (entry.second.status == Status::FAILED) {
-            entry.second.status = Status::QUEUED;
-            loadQueue.push_back(entry.first);
+    for (int requestIndex = 0; requestIndex < requestCount; requestIndex++) {
+        RequestInfo& request = requestAt(requestIndex);
+        if (canRetry(request)) {
+            pushQueue(&request);
         }
     }
 }
@@ -256,8 +954,8 @@ void ClearCache()
     }
 
     ImageStore::ClearMemoryCache();
-    requestMap.clear();
-    loadQueue.clear();
+    clearQueue();
+    releaseRequests();
 }
 
 void Evict(uint64_t titleId)
@@ -268,15 +966,35 @@ void Evict(uint64_t titleId)
 
     ImageStore::RemoveFromMemoryCache(titleId);
 
-    auto requestIterator = requestMap.find(titleId);
-    if (requestIterator != requestMap.end()) {
-        requestMap.erase(requestIterator);
+    // The entry stays in the table as NOT_REQUESTED, like a cancelled one
+    RequestInfo* request = findRequest(titleId);
+    if (request) {
+        removeFromQueue(request);
+        request->status = Status::NOT_REQUESTED;
+        request->handle = Renderer::INVALID_IMAGE;
+        request->failure = ImageStore::LoadError::NONE;
+        request->failedAttempts = 0;
     }
+}
+
+void Replace(uint64_t titleId, const uint32_t* pixels, int width, int height)
+{
+    if (!isInitialized) {
+        return;
+    }
+
+    // Forgetting the request makes finishLoad() free an in-flight result
+    Evict(titleId);
 
-    auto queueIterator = std::find(loadQueue.begin(), loadQueue.end(), titleId);
-    if (queueIterator != loadQueue.end()) {
-        loadQueue.erase(queueIterator);
+    Renderer::ImageHandle handle = ImageStore::ReplaceInMemoryCache(titleId, pixels, width, height);
+    if (handle != Renderer::INVALID_IMAGE) {
+        RequestInfo* request = addRequest(titleId, Priority::NORMAL);
+        if (request) {
+            recordSuccess(*request, handle);
+        }
     }
+
+    queueIconEdit(titleId, pixels, width, height);
 }
 
 int GetCacheCount()
@@ -284,9 +1002,70 @@ int GetCacheCount()
     return ImageStore::GetMemoryCacheCount();
 }
 
-int GetCacheCapacity()
+size_t GetCacheBytes()
+{
+    return ImageStore::GetMemoryCacheBytes();
+}
+
+size_t GetCacheBudget()
+{
+    return ImageStore::GetMemoryBudget();
+}
+
+void SetCacheBudget(size_t cacheBudgetBytes)
 {
-    return ImageStore::GetMemoryCacheCapacity();
+    ImageStore::SetMemoryBudget(cacheBudgetBytes);
+}
+
+void SetIconSize(int iconSize)
+{
+    requestedIconSize = iconSize;
+    if (isInitialized) {
+        followLayoutIconSize();
+    }
+}
+
+void Demote()
+{
+    if (!isInitialized) {
+        return;
+    }
+
+    // READY requests whose image went are re-queued by Get(), and then
+    // unpacked or loaded again when the menu draws them
+    ImageStore::DemoteMemoryCache(DEMOTED_CACHE_BUDGET);
+}
+
+void Promote(const uint64_t* titleIds, int count)
+{
+    if (!isInitialized || !titleIds) {
+        return;
+    }
+
+    for (int index = 0; index < count; index++) {
+        uint64_t titleId = titleIds[index];
+        Renderer::ImageHandle handle = ImageStore::GetFromMemoryCache(titleId);
+        if (handle == Renderer::INVALID_IMAGE) {
+            handle = ImageStore::PromoteFromWarmCache(titleId);
+        }
+        if (handle == Renderer::INVALID_IMAGE) {
+            Request(titleId, Priority::NORMAL);
+            continue;
+        }
+
+        RequestInfo* request = findRequest(titleId);
+        if (request && request->status == Status::QUEUED) {
+            removeFromQueue(request);
+        }
+        if (request) {
+            request->priority = Priority::NORMAL;
+        } else {
+            request = addRequest(titleId, Priority::NORMAL);
+        }
+        if (request) {
+            recordSuccess(*request, handle);
+        }
+    }
 }
 
 void Prefetch(const uint64_t* titleIdArray, int count)
@@ -295,6 +1074,8 @@ void Prefetch(const uint64_t* titleIdArray, int count)
         return;
     }
 
+    // One allocation for the whole batch rather than one per block
+    reserveRequests(requestCount + count);
     for (int index = 0; index < count; index++) {
         Request(titleIdArray[index], Priority::LOW);
     }
@@ -306,23 +1087,18 @@ void LoadAllSync()
         return;
     }
 
-    while (!loadQueue.empty()) {
-        uint64_t titleId = loadQueue.front();
-        loadQueue.erase(loadQueue.begin());
-
-        auto requestIterator = requestMap.find(titleId);
-        if (requestIterator == requestMap.end()) {
-            continue;
+    if (isWorkerRunning) {
+        for (;;) {
+            Update();
+            if (loadQueue.empty() && inFlightCount == 0) {
+                return;
+            }
+            OSSleepTicks(OSMillisecondsToTicks(1));
         }
+    }
 
-        Renderer::ImageHandle handle;
-        if (ImageStore::Load(titleId, handle)) {
-            requestIterator->second.status = Status::READY;
-            requestIterator->second.handle = handle;
-        } else {
-            requestIterator->second.status = Status::FAILED;
-            requestIterator->second.handle = Renderer::INVALID_IMAGE;
-        }
+    while (!loadQueue.empty()) {
+        loadNextSync();
     }
 }
 
@@ -3,14 +3,21 @@
 #pragma once
 
 #include "renderer.h"
+#include <cstddef>
 #include <cstdint>
 
 namespace ImageLoader {
 
-constexpr int DEFAULT_CACHE_SIZE = 500;
+// Bytes of decoded icons kept in memory (32 KB per 128x128 RGB565 icon)
+constexpr size_t DEFAULT_CACHE_BUDGET = 4 * 1024 * 1024;
+// Decoded icons kept while the menu is closed (see Demote)
+constexpr size_t DEMOTED_CACHE_BUDGET = 256 * 1024;
 constexpr int ICON_WIDTH = 128;
 constexpr int ICON_HEIGHT = 128;
 
+// Time Update() may spend when the caller has no better figure
+constexpr uint32_t DEFAULT_UPDATE_BUDGET_US = 2000;
+
 enum class Priority {
     LOW,
     NORMAL,
@@ -26,9 +33,15 @@ enum class Status {
 };
 
 // Lifecycle
-bool Init(int cacheSize = DEFAULT_CACHE_SIZE);
+bool Init(size_t cacheBudgetBytes = DEFAULT_CACHE_BUDGET);
 void Shutdown();
-void Update();
+// The worker thread belongs to the running application: stop it when the
+// application ends (loads it had are queued again); the next Update()
+// starts a new one
+void OnApplicationEnd();
+// Collects decoded icons (or, without a worker thread, loads them) until
+// budgetMicros has passed; always handles at least one so it keeps moving
+void Update(uint32_t budgetMicros = DEFAULT_UPDATE_BUDGET_US);
 
 // Requests
 void Request(uint64_t titleId, Priority priority = Priority::NORMAL);
@@ -43,14 +56,38 @@ Renderer::ImageHandle Get(uint64_t titleId);
 void GetDebugInfo(int* outUpdateCalls, int* outQueueSize, bool* outInitialized);
 void GetLoadingStats(int* outPending, int* outReady, int* outFailed, int* outTotal);
 
-// Retry failed loads (call when menu opens)
+// Retry transient failures whose backoff has passed (call when menu
+// opens); missing and undecodable icons stay failed
 void RetryFailed();
 
 // Cache management
 void ClearCache();
 void Evict(uint64_t titleId);
+
+// Show new pixels (RGBA8888) for a title's icon at once, without a load
+// (see ImageStore::ReplaceInMemoryCache). A load already under way for
+// it is dropped. If the copy can't be made the icon is evicted instead.
+// The worker then packs the pixels in place of the title's old icon
+// (ImageStore::ReplaceStoredIcon), so later loads find the edit too
+void Replace(uint64_t titleId, const uint32_t* pixels, int width, int height);
 int GetCacheCount();
-int GetCacheCapacity();
+size_t GetCacheBytes();
+size_t GetCacheBudget();
+void SetCacheBudget(size_t cacheBudgetBytes);
+
+// Side of the square icons are decoded to, for a view that draws them
+// smaller than the details icon (the browse grid); 0 follows the layout's
+// details icon. Changing it drops the decoded icons, which load again at
+// the new size from the icon pack's scaled variants
+void SetIconSize(int iconSize);
+
+// Shrink to a small footprint while a game runs: the icons drawn last
+// stay decoded, the next ones are kept compressed, the rest are freed
+void Demote();
+
+// Make these icons ready first (call when the menu opens, with the
+// visible window): compressed ones are unpacked now, others are queued
+void Promote(const uint64_t* titleIds, int count);
 
 // Batch operations
 void Prefetch(const uint64_t* titleIds, int count);
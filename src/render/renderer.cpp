@@ -4,12 +4,14 @@
  */
 
 #include "renderer.h"
+#include "draw_list.h"
 #include "bitmap_font.h"
 #include "../common/screen_constants.h"
 #include "../utils/dc.h"
 
 #ifdef ENABLE_GX2_RENDERING
 #include "gx2/gx2_overlay.h"
+#include "gx2/icon_textures.h"
 #endif
 
 #include <wups.h>
@@ -23,6 +25,9 @@
 
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <algorithm>
+#include <vector>
 
 // Captured game buffers for fallback when memory allocation fails
 struct StoredBuffer {
@@ -68,6 +73,13 @@ namespace {
 Backend selectedBackend = Backend::OS_SCREEN;
 bool isInitialized = false;
 
+// Draw calls of the current frame, consumed by the backend in EndFrame
+DrawList::List frameList;
+
+// Alpha of the overlay's backdrop: enough to read text over any game
+constexpr uint32_t OVERLAY_BACKDROP_ALPHA = 0xD8;
+uint32_t overlayBackdropColor = OVERLAY_BACKDROP_ALPHA;
+
 bool homeButtonWasEnabled = false;
 DCRegisters savedDCRegisters;
 void* tvFramebuffer = nullptr;
@@ -77,6 +89,469 @@ uint32_t drcFramebufferSize = 0;
 bool usingFallbackTV = false;
 bool usingFallbackDRC = false;
 
+// Framebuffers kept between opens, so opening doesn't have to find
+// megabytes of mapped memory (see StandbyPolicy)
+struct StandbyBuffer {
+    void* buffer = nullptr;
+    uint32_t size = 0;
+};
+
+StandbyPolicy standbyPolicy = StandbyPolicy::RELEASE_ON_PRESSURE;
+StandbyBuffer standbyTV;
+StandbyBuffer standbyDRC;
+
+void freeStandby(StandbyBuffer& standby)
+{
+    if (standby.buffer) {
+        MEMFreeToMappedMemory(standby.buffer);
+    }
+    standby = {};
+}
+
+bool reserveStandby(StandbyBuffer& standby, uint32_t size)
+{
+    if (standby.buffer && standby.size >= size) {
+        return true;
+    }
+    freeStandby(standby);
+    if (size == 0) {
+        return false;
+    }
+    standby.buffer = MEMAllocFromMappedMemoryForGX2Ex(size, 0x100);
+    standby.size = standby.buffer ? size : 0;
+    return standby.buffer != nullptr;
+}
+
+// The standby buffer if it is big enough, else a fresh allocation
+void* acquireFramebuffer(StandbyBuffer& standby, uint32_t size)
+{
+    if (standby.buffer && standby.size >= size) {
+        void* buffer = standby.buffer;
+        standby = {};
+        return buffer;
+    }
+    freeStandby(standby);
+    return MEMAllocFromMappedMemoryForGX2Ex(size, 0x100);
+}
+
+// Back to standby unless the policy frees framebuffers on close
+void releaseFramebuffer(StandbyBuffer& standby, void* buffer, uint32_t size)
+{
+    if (standbyPolicy == StandbyPolicy::OFF) {
+        MEMFreeToMappedMemory(buffer);
+        return;
+    }
+    freeStandby(standby);
+    standby.buffer = buffer;
+    standby.size = size;
+}
+
+// Where OSScreenPutPixelEx lands on one screen. OSScreen keeps both of a
+// screen's buffers in the one allocation and draws into the back one
+struct RasterTarget {
+    uint32_t* buffers[2];
+    int pitch;        // Pixels per framebuffer row
+    int width;
+    int height;
+    int backIndex;    // Buffer drawn into this frame
+};
+
+RasterTarget tvRaster;
+RasterTarget drcRaster;
+
+// With direct access the frame is composed once on the DRC and scaled to
+// the TV's own resolution in EndFrame. Without it every pixel goes through
+// OSScreenPutPixelEx, once per screen, at DRC coordinates
+bool hasDirectRaster = false;
+
+// DRC column for each TV column
+std::vector<uint16_t> tvColumnMap;
+
+constexpr uint32_t PROBE_COLOR = 0xFFFFFF00;
+
+/**
+ * Find a screen's back buffer and pitch by plotting one pixel through
+ * OSScreen and looking for it. Both buffers must be cleared to 0 first.
+ */
+bool probeRasterTarget(OSScreenID screen, void* framebuffer, uint32_t framebufferSize,
+                       RasterTarget& target)
+{
+    uint32_t* words = static_cast<uint32_t*>(framebuffer);
+    uint32_t bufferWords = framebufferSize / (2 * sizeof(uint32_t));
+
+    OSScreenPutPixelEx(screen, 0, 1, PROBE_COLOR);
+
+    uint32_t probeIndex = 0;
+    while (probeIndex < bufferWords * 2 && words[probeIndex] != PROBE_COLOR) {
+        probeIndex++;
+    }
+    OSScreenPutPixelEx(screen, 0, 1, 0);
+
+    if (probeIndex >= bufferWords * 2) {
+        return false;
+    }
+
+    target.buffers[0] = words;
+    target.buffers[1] = words + bufferWords;
+    target.backIndex = (probeIndex >= bufferWords) ? 1 : 0;
+    target.pitch = static_cast<int>(probeIndex - target.backIndex * bufferWords);
+    if (target.pitch <= 0) {
+        return false;
+    }
+
+    // OSScreen buffers have no row padding beyond the pitch
+    target.width = target.pitch;
+    target.height = static_cast<int>(bufferWords / target.pitch);
+    return true;
+}
+
+/**
+ * Confirm which buffer OSScreen draws into after a flip. Costs one
+ * PutPixel per screen; pixel (0,0) is put back afterwards, since a
+ * retained frame may not redraw it.
+ */
+bool syncRasterTarget(OSScreenID screen, RasterTarget& target)
+{
+    uint32_t* backPixel = target.buffers[target.backIndex];
+    uint32_t* frontPixel = target.buffers[target.backIndex ^ 1];
+    uint32_t savedBack = *backPixel;
+    uint32_t savedFront = *frontPixel;
+
+    // Differs from the back pixel, so a write to it always shows
+    uint32_t probe = (savedBack ^ 0xFFFFFF00) & 0xFFFFFF00;
+    OSScreenPutPixelEx(screen, 0, 0, probe);
+
+    if ((*backPixel & 0xFFFFFF00) == probe) {
+        *backPixel = savedBack;
+        return true;
+    }
+    if ((*frontPixel & 0xFFFFFF00) == probe && savedFront != *frontPixel) {
+        *frontPixel = savedFront;
+        target.backIndex ^= 1;
+        return true;
+    }
+    return false;
+}
+
+inline uint32_t* getRasterRow(const RasterTarget& target, int y)
+{
+    return target.buffers[target.backIndex] + y * target.pitch;
+}
+
+// A pixel rectangle in DRC coordinates
+struct DirtyRect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+constexpr DirtyRect FULL_SCREEN_RECT = { 0, 0, Screen::DRC::WIDTH, Screen::DRC::HEIGHT };
+
+// Disjoint rectangles; past MAX_DIRTY_RECTS they collapse into their bounds
+constexpr int MAX_DIRTY_RECTS = 16;
+
+struct DirtyRegion {
+    DirtyRect rects[MAX_DIRTY_RECTS];
+    int count;
+};
+
+// What each buffer has missed since it was last drawn. An invalidation
+// goes to both, since the back buffer still holds the frame before last
+DirtyRegion pendingRegions[2];
+
+// Where this frame clears, draws and flushes; everything else is kept
+DirtyRegion frameRegion;
+
+// The same for the TV's buffers, which are drawn at their own pace
+// (SetTVPacing) from the composed DRC frame. Still in DRC coordinates
+DirtyRegion tvPendingRegions[2];
+DirtyRegion tvFrameRegion;
+
+// Which frames draw the TV (shared with the mock and the web preview)
+TVPacer tvPacer;
+
+// Redraw only invalidated regions (OSScreen with direct access only)
+bool isRetainedMode = false;
+uint32_t frameClearColor = 0;
+
+// WaitForVsync() already waited for this frame's vsync
+bool hasWaitedForVsync = false;
+
+// Clip a rectangle to another; false if nothing is left
+bool clipToRect(int& x, int& y, int& width, int& height, const DirtyRect& clip)
+{
+    int right = std::min(x + width, clip.x + clip.width);
+    int bottom = std::min(y + height, clip.y + clip.height);
+    x = std::max(x, clip.x);
+    y = std::max(y, clip.y);
+    width = right - x;
+    height = bottom - y;
+    return width > 0 && height > 0;
+}
+
+// Overlapping or sharing an edge
+bool rectsTouch(const DirtyRect& first, const DirtyRect& second)
+{
+    return first.x <= second.x + second.width && second.x <= first.x + first.width &&
+           first.y <= second.y + second.height && second.y <= first.y + first.height;
+}
+
+bool rectsOverlap(const DirtyRect& first, const DirtyRect& second)
+{
+    return first.x < second.x + second.width && second.x < first.x + first.width &&
+           first.y < second.y + second.height && second.y < first.y + first.height;
+}
+
+inline int rectArea(const DirtyRect& rect)
+{
+    return rect.width * rect.height;
+}
+
+DirtyRect unionRects(const DirtyRect& first, const DirtyRect& second)
+{
+    int left = std::min(first.x, second.x);
+    int top = std::min(first.y, second.y);
+    int right = std::max(first.x + first.width, second.x + second.width);
+    int bottom = std::max(first.y + first.height, second.y + second.height);
+    return { left, top, right - left, bottom - top };
+}
+
+void addDirtyRect(DirtyRegion& region, DirtyRect rect)
+{
+    if (!clipToRect(rect.x, rect.y, rect.width, rect.height, FULL_SCREEN_RECT)) {
+        return;
+    }
+
+    // Absorb every rectangle the new one overlaps, so none is drawn twice,
+    // and any it shares an edge with when their bounds cover no more than
+    // the two do (neighbouring list rows), starting over as it grows. The
+    // footer beside the details panel stays apart rather than pulling the
+    // whole list into their bounds
+    for (int index = 0; index < region.count;) {
+        const DirtyRect& other = region.rects[index];
+        DirtyRect bounds = unionRects(other, rect);
+        if (rectsOverlap(other, rect) ||
+            (rectsTouch(other, rect) && rectArea(bounds) <= rectArea(other) + rectArea(rect))) {
+            rect = bounds;
+            region.rects[index] = region.rects[--region.count];
+            index = 0;
+        } else {
+            index++;
+        }
+    }
+
+    if (region.count == MAX_DIRTY_RECTS) {
+        for (int index = 0; index < region.count; index++) {
+            rect = unionRects(rect, region.rects[index]);
+        }
+        region.count = 0;
+    }
+    region.rects[region.count++] = rect;
+}
+
+void invalidateRect(const DirtyRect& rect)
+{
+    addDirtyRect(pendingRegions[0], rect);
+    addDirtyRect(pendingRegions[1], rect);
+    addDirtyRect(tvPendingRegions[0], rect);
+    addDirtyRect(tvPendingRegions[1], rect);
+}
+
+bool isFullScreen(const DirtyRegion& region)
+{
+    const DirtyRect& rect = region.rects[0];
+    return region.count == 1 && rect.x == 0 && rect.y == 0 &&
+           rect.width == Screen::DRC::WIDTH && rect.height == Screen::DRC::HEIGHT;
+}
+
+bool initDirectRaster()
+{
+    // Both buffers of each screen are clear now, so the probe pixel is
+    // the only thing it can find
+    bool isProbed = probeRasterTarget(SCREEN_TV, tvFramebuffer, tvFramebufferSize, tvRaster) &&
+                    probeRasterTarget(SCREEN_DRC, drcFramebuffer, drcFramebufferSize, drcRaster);
+    if (!isProbed || drcRaster.width < Screen::DRC::WIDTH || drcRaster.height < Screen::DRC::HEIGHT) {
+        return false;
+    }
+
+    tvColumnMap.resize(tvRaster.width);
+    for (int x = 0; x < tvRaster.width; x++) {
+        tvColumnMap[x] = static_cast<uint16_t>((x * Screen::DRC::WIDTH) / tvRaster.width);
+    }
+    return true;
+}
+
+// First TV pixel whose source pixel is at or past a DRC coordinate
+inline int toTVCoordinate(int drcCoordinate, int tvSize, int drcSize)
+{
+    return (drcCoordinate * tvSize + drcSize - 1) / drcSize;
+}
+
+/**
+ * Scale part of the composed DRC frame into the TV back buffer (nearest
+ * neighbour). TV rows that sample the same DRC row are copied from the
+ * one above.
+ *
+ * @return The TV rectangle written
+ */
+DirtyRect scaleToTV(const DirtyRect& rect)
+{
+    int left = toTVCoordinate(rect.x, tvRaster.width, Screen::DRC::WIDTH);
+    int right = toTVCoordinate(rect.x + rect.width, tvRaster.width, Screen::DRC::WIDTH);
+    int top = toTVCoordinate(rect.y, tvRaster.height, Screen::DRC::HEIGHT);
+    int bottom = toTVCoordinate(rect.y + rect.height, tvRaster.height, Screen::DRC::HEIGHT);
+
+    const uint16_t* columnMap = tvColumnMap.data();
+    size_t spanBytes = static_cast<size_t>(right - left) * sizeof(uint32_t);
+
+    int previousSourceY = -1;
+    const uint32_t* previousRow = nullptr;
+    for (int y = top; y < bottom; y++) {
+        int sourceY = (y * Screen::DRC::HEIGHT) / tvRaster.height;
+        uint32_t* destRow = getRasterRow(tvRaster, y);
+
+        if (sourceY == previousSourceY) {
+            memcpy(destRow + left, previousRow + left, spanBytes);
+            continue;
+        }
+
+        const uint32_t* sourceRow = getRasterRow(drcRaster, sourceY);
+        for (int x = left; x < right; x++) {
+            destRow[x] = sourceRow[columnMap[x]];
+        }
+        previousSourceY = sourceY;
+        previousRow = destRow;
+    }
+
+    return { left, top, right - left, bottom - top };
+}
+
+// Below this share of the pitch a rectangle is flushed row by row
+constexpr int FLUSH_ROWS_MIN_PERCENT = 50;
+
+/**
+ * Write back the cache lines a rectangle covers. A narrow one (an icon, a
+ * list row's text) is flushed one row span at a time so the lines beside
+ * it are left alone; a wide one as a single range of whole rows.
+ */
+void flushRect(const RasterTarget& target, const DirtyRect& rect)
+{
+    if (rect.width * 100 >= target.pitch * FLUSH_ROWS_MIN_PERCENT) {
+        DCFlushRange(getRasterRow(target, rect.y),
+                     static_cast<uint32_t>(rect.height * target.pitch) * sizeof(uint32_t));
+        return;
+    }
+
+    uint32_t spanBytes = static_cast<uint32_t>(rect.width) * sizeof(uint32_t);
+    for (int row = 0; row < rect.height; row++) {
+        DCFlushRange(getRasterRow(target, rect.y + row) + rect.x, spanBytes);
+    }
+}
+
+inline bool isTVFrame()
+{
+    return tvFrameRegion.count > 0;
+}
+
+// Without direct access: a pixel on the DRC, and on the TV if it's drawn
+// this frame
+inline void putPixel(int x, int y, uint32_t rgbx)
+{
+    if (isTVFrame()) {
+        OSScreenPutPixelEx(SCREEN_TV, x, y, rgbx);
+    }
+    OSScreenPutPixelEx(SCREEN_DRC, x, y, rgbx);
+}
+
+// Spans below are already clipped and in RGBX
+
+void fillSpan(int x, int y, int length, uint32_t rgbx)
+{
+    if (!hasDirectRaster) {
+        for (int offset = 0; offset < length; offset++) {
+            putPixel(x + offset, y, rgbx);
+        }
+        return;
+    }
+
+    std::fill_n(getRasterRow(drcRaster, y) + x, length, rgbx);
+}
+
+void copySpan(int x, int y, const uint32_t* pixels, int length)
+{
+    if (!hasDirectRaster) {
+        for (int offset = 0; offset < length; offset++) {
+            putPixel(x + offset, y, pixels[offset]);
+        }
+        return;
+    }
+
+    memcpy(getRasterRow(drcRaster, y) + x, pixels, length * sizeof(uint32_t));
+}
+
+// Source over destination in RGBX; red and blue share one multiply
+inline uint32_t blendPixel(uint32_t source, uint32_t dest, uint32_t alpha)
+{
+    uint32_t weight = alpha + (alpha >> 7);  // 0-256
+    uint32_t sourceRB = (source >> 8) & 0x00FF00FF;
+    uint32_t destRB = (dest >> 8) & 0x00FF00FF;
+    uint32_t sourceG = (source >> 16) & 0xFF;
+    uint32_t destG = (dest >> 16) & 0xFF;
+    uint32_t blendedRB = ((sourceRB * weight + destRB * (256 - weight)) >> 8) & 0x00FF00FF;
+    uint32_t blendedG = ((sourceG * weight + destG * (256 - weight)) >> 8) & 0xFF;
+    return (blendedRB << 8) | (blendedG << 16);
+}
+
+// Blend RGBA pixels by their alpha. Without direct access the framebuffer
+// can't be read back, so alpha becomes a 50% cutoff
+void blendSpan(int x, int y, const uint32_t* pixels, int length)
+{
+    if (!hasDirectRaster) {
+        for (int offset = 0; offset < length; offset++) {
+            if ((pixels[offset] & 0xFF) >= 0x80) {
+                putPixel(x + offset, y, pixels[offset] & 0xFFFFFF00);
+            }
+        }
+        return;
+    }
+
+    uint32_t* dest = getRasterRow(drcRaster, y) + x;
+    for (int offset = 0; offset < length; offset++) {
+        uint32_t source = pixels[offset];
+        uint32_t alpha = source & 0xFF;
+        if (alpha == 0xFF) {
+            dest[offset] = source & 0xFFFFFF00;
+        } else if (alpha != 0) {
+            dest[offset] = blendPixel(source, dest[offset], alpha);
+        }
+    }
+}
+
+void fillRect(int x, int y, int width, int height, uint32_t rgbx)
+{
+    for (int index = 0; index < frameRegion.count; index++) {
+        int clipX = x;
+        int clipY = y;
+        int clipWidth = width;
+        int clipHeight = height;
+        if (!clipToRect(clipX, clipY, clipWidth, clipHeight, frameRegion.rects[index])) {
+            continue;
+        }
+        for (int row = 0; row < clipHeight; row++) {
+            fillSpan(clipX, clipY + row, clipWidth, rgbx);
+        }
+    }
+}
+
+void invalidateAllOSScreen()
+{
+    pendingRegions[0].count = 0;
+    pendingRegions[1].count = 0;
+    tvPendingRegions[0].count = 0;
+    tvPendingRegions[1].count = 0;
+    invalidateRect(FULL_SCREEN_RECT);
+}
 
 bool initOSScreen()
 {
@@ -91,9 +566,9 @@ bool initOSScreen()
     usingFallbackTV = false;
     usingFallbackDRC = false;
 
-    // Try to allocate fresh buffers
-    tvFramebuffer = MEMAllocFromMappedMemoryForGX2Ex(tvFramebufferSize, 0x100);
-    drcFramebuffer = MEMAllocFromMappedMemoryForGX2Ex(drcFramebufferSize, 0x100);
+    // Standby buffers if reserved, else fresh ones
+    tvFramebuffer = acquireFramebuffer(standbyTV, tvFramebufferSize);
+    drcFramebuffer = acquireFramebuffer(standbyDRC, drcFramebufferSize);
 
     // Fallback to captured game buffers if allocation failed
     if (!tvFramebuffer && gStoredTVBuffer.buffer &&
@@ -111,11 +586,11 @@ bool initOSScreen()
     // If still no buffers, clean up and fail
     if (!tvFramebuffer || !drcFramebuffer) {
         if (tvFramebuffer && !usingFallbackTV) {
-            MEMFreeToMappedMemory(tvFramebuffer);
+            releaseFramebuffer(standbyTV, tvFramebuffer, tvFramebufferSize);
         }
         tvFramebuffer = nullptr;
         if (drcFramebuffer && !usingFallbackDRC) {
-            MEMFreeToMappedMemory(drcFramebuffer);
+            releaseFramebuffer(standbyDRC, drcFramebuffer, drcFramebufferSize);
         }
         drcFramebuffer = nullptr;
         usingFallbackTV = false;
@@ -136,6 +611,9 @@ bool initOSScreen()
         OSScreenFlipBuffersEx(SCREEN_DRC);
     }
 
+    hasDirectRaster = initDirectRaster();
+    invalidateAllOSScreen();
+
     OSScreenEnableEx(SCREEN_TV, TRUE);
     OSScreenEnableEx(SCREEN_DRC, TRUE);
     OSEnableHomeButtonMenu(false);
@@ -148,154 +626,410 @@ void shutdownOSScreen()
     OSEnableHomeButtonMenu(homeButtonWasEnabled);
     DCRestoreRegisters(&savedDCRegisters);
 
-    // Only free buffers we allocated (not fallback buffers borrowed from game)
+    // Only keep or free buffers we allocated (not fallback buffers
+    // borrowed from game)
     if (tvFramebuffer && !usingFallbackTV) {
-        MEMFreeToMappedMemory(tvFramebuffer);
+        releaseFramebuffer(standbyTV, tvFramebuffer, tvFramebufferSize);
     }
     tvFramebuffer = nullptr;
 
     if (drcFramebuffer && !usingFallbackDRC) {
-        MEMFreeToMappedMemory(drcFramebuffer);
+        releaseFramebuffer(standbyDRC, drcFramebuffer, drcFramebufferSize);
     }
     drcFramebuffer = nullptr;
 
     tvFramebufferSize = 0;
     drcFramebufferSize = 0;
+    hasDirectRaster = false;
+    isRetainedMode = false;
+    hasWaitedForVsync = false;
+    tvColumnMap.clear();
     usingFallbackTV = false;
     usingFallbackDRC = false;
 }
 
 void beginFrameOSScreen(uint32_t clearColor)
 {
-    GX2WaitForVsync();
-    OSScreenClearBufferEx(SCREEN_TV, clearColor);
-    OSScreenClearBufferEx(SCREEN_DRC, clearColor);
+    if (!hasWaitedForVsync) {
+        GX2WaitForVsync();
+    }
+    hasWaitedForVsync = false;
+
+    if (hasDirectRaster) {
+        hasDirectRaster = syncRasterTarget(SCREEN_TV, tvRaster) &&
+                          syncRasterTarget(SCREEN_DRC, drcRaster);
+    }
+
+    // A new clear color shows everywhere
+    if (!isRetainedMode || !hasDirectRaster || clearColor != frameClearColor) {
+        invalidateAllOSScreen();
+    }
+    frameClearColor = clearColor;
+
+    DirtyRegion& pending = pendingRegions[drcRaster.backIndex];
+    frameRegion = pending;
+    pending.count = 0;
+
+    DirtyRegion& tvPending = tvPendingRegions[tvRaster.backIndex];
+    if (tvPacer.BeginFrame(tvPending.count > 0, frameRegion.count > 0)) {
+        tvFrameRegion = tvPending;
+        tvPending.count = 0;
+    } else {
+        tvFrameRegion.count = 0;
+    }
+
+    if (!hasDirectRaster) {
+        if (isTVFrame()) {
+            OSScreenClearBufferEx(SCREEN_TV, clearColor);
+        }
+        OSScreenClearBufferEx(SCREEN_DRC, clearColor);
+        return;
+    }
+
+    // A scaled TV frame overwrites what it covers, so only the DRC is
+    // cleared. The composed DRC frame is whole after drawing even where
+    // this frame keeps it, so the TV can scale any part of it
+    if (isFullScreen(frameRegion)) {
+        OSScreenClearBufferEx(SCREEN_DRC, clearColor);
+        return;
+    }
+    for (int index = 0; index < frameRegion.count; index++) {
+        const DirtyRect& rect = frameRegion.rects[index];
+        for (int row = 0; row < rect.height; row++) {
+            std::fill_n(getRasterRow(drcRaster, rect.y + row) + rect.x, rect.width, clearColor);
+        }
+    }
 }
 
 void endFrameOSScreen()
 {
-    DCFlushRange(tvFramebuffer, tvFramebufferSize);
-    DCFlushRange(drcFramebuffer, drcFramebufferSize);
-    OSScreenFlipBuffersEx(SCREEN_TV);
-    OSScreenFlipBuffersEx(SCREEN_DRC);
+    // A screen with nothing to redraw already shows the current frame in
+    // both buffers, or is waiting for its turn
+    if (isTVFrame()) {
+        if (hasDirectRaster) {
+            for (int index = 0; index < tvFrameRegion.count; index++) {
+                flushRect(tvRaster, scaleToTV(tvFrameRegion.rects[index]));
+            }
+        } else {
+            DCFlushRange(tvFramebuffer, tvFramebufferSize);
+        }
+        OSScreenFlipBuffersEx(SCREEN_TV);
+        tvRaster.backIndex ^= 1;
+    }
+
+    if (frameRegion.count > 0) {
+        if (hasDirectRaster) {
+            for (int index = 0; index < frameRegion.count; index++) {
+                flushRect(drcRaster, frameRegion.rects[index]);
+            }
+        } else {
+            DCFlushRange(drcFramebuffer, drcFramebufferSize);
+        }
+        OSScreenFlipBuffersEx(SCREEN_DRC);
+        drcRaster.backIndex ^= 1;
+    }
 }
 
-void drawTextOSScreen(int column, int row, const char* text, uint32_t color)
-{
-    // Always use bitmap font rendering for consistent positioning with web preview
-    // Convert color from RGBA to RGBX format for OSScreenPutPixelEx
-    uint32_t rgbx = (color == 0) ? 0xFFFFFF00 : (color & 0xFFFFFF00);
+// The 8x8 font is drawn 2x tall (8x16), centered in a 24px row
+constexpr int TEXT_HEIGHT = BitmapFont::SCALED_CHAR_HEIGHT;
+constexpr int TEXT_OFFSET_Y = (Screen::Grid::CHAR_HEIGHT - TEXT_HEIGHT) / 2;
 
-    // Calculate pixel position from character grid position
-    int baseX = column * Screen::Grid::CHAR_WIDTH;
-    int baseY = row * Screen::Grid::CHAR_HEIGHT;
+void drawTextClipped(const char* text, int length, int textX, int glyphTop, uint32_t rgbx,
+                     const DirtyRect& clip)
+{
+    int clipX = textX;
+    int clipY = glyphTop;
+    int clipWidth = length * Screen::Grid::CHAR_WIDTH;
+    int clipHeight = TEXT_HEIGHT;
+    if (!clipToRect(clipX, clipY, clipWidth, clipHeight, clip)) {
+        return;
+    }
 
-    // 2x vertical scale to make 8x8 font fill 8x16, centered in 24px row
-    constexpr int SCALE_Y = 2;
-    constexpr int SCALED_HEIGHT = BitmapFont::CHAR_HEIGHT * SCALE_Y;  // 16px
-    int yOffset = (Screen::Grid::CHAR_HEIGHT - SCALED_HEIGHT) / 2;  // Center in 24px row
+    int firstChar = (clipX - textX) / Screen::Grid::CHAR_WIDTH;
+    int lastChar = (clipX + clipWidth - 1 - textX) / Screen::Grid::CHAR_WIDTH;
 
-    // Render each character
-    for (int i = 0; text[i] != '\0'; i++) {
-        const uint8_t* glyph = BitmapFont::GetGlyph(text[i]);
+    for (int charIndex = firstChar; charIndex <= lastChar; charIndex++) {
+        const uint8_t* glyph = BitmapFont::GetScaledGlyph(text[charIndex]);
         if (!glyph) {
-            baseX += Screen::Grid::CHAR_WIDTH;
             continue;
         }
 
-        // Draw each pixel of the glyph with 2x vertical scale
-        for (int gy = 0; gy < BitmapFont::CHAR_HEIGHT; gy++) {
-            for (int gx = 0; gx < BitmapFont::CHAR_WIDTH; gx++) {
-                if (BitmapFont::IsPixelSet(glyph, gx, gy)) {
-                    int px = baseX + gx;
-                    int py = baseY + yOffset + gy * SCALE_Y;
-                    OSScreenPutPixelEx(SCREEN_TV, px, py, rgbx);
-                    OSScreenPutPixelEx(SCREEN_TV, px, py + 1, rgbx);
-                    OSScreenPutPixelEx(SCREEN_DRC, px, py, rgbx);
-                    OSScreenPutPixelEx(SCREEN_DRC, px, py + 1, rgbx);
+        int cellX = textX + charIndex * Screen::Grid::CHAR_WIDTH;
+        int firstX = std::max(clipX - cellX, 0);
+        int lastX = std::min(clipX + clipWidth - cellX, BitmapFont::CHAR_WIDTH);
+
+        // Bit 7 is the leftmost pixel; drop the columns outside the clip
+        uint8_t columnMask = static_cast<uint8_t>((0xFF >> firstX) & (0xFF << (BitmapFont::CHAR_WIDTH - lastX)));
+
+        for (int py = clipY; py < clipY + clipHeight; py++) {
+            uint8_t bits = glyph[py - glyphTop] & columnMask;
+            if (bits == 0) {
+                continue;
+            }
+
+            if (!hasDirectRaster) {
+                for (int gx = firstX; gx < lastX; gx++) {
+                    if (bits & (0x80 >> gx)) {
+                        putPixel(cellX + gx, py, rgbx);
+                    }
                 }
+                continue;
+            }
+
+            uint32_t* dest = getRasterRow(drcRaster, py) + cellX;
+            if (bits == 0xFF) {
+                std::fill_n(dest, BitmapFont::CHAR_WIDTH, rgbx);
+                continue;
+            }
+
+            // Select the text or the existing pixel without a branch per pixel
+            for (int gx = firstX; gx < lastX; gx++) {
+                uint32_t pixelMask = 0u - ((bits >> (7 - gx)) & 1u);
+                dest[gx] = (dest[gx] & ~pixelMask) | (rgbx & pixelMask);
             }
         }
+    }
+}
+
+void drawTextOSScreen(int column, int row, const char* text, uint32_t color)
+{
+    // Always use bitmap font rendering for consistent positioning with web preview
+    // Convert color from RGBA to RGBX format for the framebuffer
+    uint32_t rgbx = (color == 0) ? 0xFFFFFF00 : (color & 0xFFFFFF00);
 
-        baseX += Screen::Grid::CHAR_WIDTH;
+    // Calculate pixel position from character grid position
+    int textX = column * Screen::Grid::CHAR_WIDTH;
+    int glyphTop = row * Screen::Grid::CHAR_HEIGHT + TEXT_OFFSET_Y;
+    int length = static_cast<int>(strlen(text));
+
+    for (int index = 0; index < frameRegion.count; index++) {
+        drawTextClipped(text, length, textX, glyphTop, rgbx, frameRegion.rects[index]);
     }
 }
 
-void drawImageOSScreen(int pixelX, int pixelY, ImageHandle image, int targetWidth, int targetHeight)
+// Row of a compact image expanded to RGBA8888
+std::vector<uint32_t> imageRowBuffer;
+
+// One destination row of an image, written or blended as a span
+std::vector<uint32_t> spanBuffer;
+
+// Source column for each destination column of a scaled image
+std::vector<uint16_t> imageColumnMap;
+
+// One source row as RGBA8888; compact formats are expanded into a buffer
+const uint32_t* getImageRow(ImageHandle image, int sourceY)
 {
-    if (!image || !image->pixels) {
-        return;
+    size_t rowStart = static_cast<size_t>(sourceY) * image->width;
+    if (image->format == PixelFormat::RGBA8888) {
+        return image->pixels + rowStart;
     }
 
+    if (imageRowBuffer.size() < static_cast<size_t>(image->width)) {
+        imageRowBuffer.resize(image->width);
+    }
+    const uint16_t* source = image->pixels16 + rowStart;
+    uint32_t* row = imageRowBuffer.data();
+
+    if (image->format == PixelFormat::RGB565) {
+        for (int x = 0; x < image->width; x++) {
+            uint32_t pixel = source[x];
+            uint32_t red = pixel >> 11;
+            uint32_t green = (pixel >> 5) & 0x3F;
+            uint32_t blue = pixel & 0x1F;
+            row[x] = (((red << 3) | (red >> 2)) << 24) | (((green << 2) | (green >> 4)) << 16) |
+                     (((blue << 3) | (blue >> 2)) << 8) | 0xFF;
+        }
+    } else {
+        for (int x = 0; x < image->width; x++) {
+            uint32_t pixel = source[x];
+            row[x] = ((pixel >> 12) * 0x11u << 24) | (((pixel >> 8) & 0xF) * 0x11u << 16) |
+                     (((pixel >> 4) & 0xF) * 0x11u << 8) | ((pixel & 0xF) * 0x11u);
+        }
+    }
+    return row;
+}
+
+void drawImageClipped(int pixelX, int pixelY, ImageHandle image, int destWidth, int destHeight,
+                      const DirtyRect& clip)
+{
     int sourceWidth = image->width;
     int sourceHeight = image->height;
-    int destWidth = (targetWidth > 0) ? targetWidth : sourceWidth;
-    int destHeight = (targetHeight > 0) ? targetHeight : sourceHeight;
 
-    for (int destY = 0; destY < destHeight; destY++) {
-        int sourceY = (destY * sourceHeight) / destHeight;
-        for (int destX = 0; destX < destWidth; destX++) {
-            int sourceX = (destX * sourceWidth) / destWidth;
+    int clipX = pixelX;
+    int clipY = pixelY;
+    int clipWidth = destWidth;
+    int clipHeight = destHeight;
+    if (!clipToRect(clipX, clipY, clipWidth, clipHeight, clip)) {
+        return;
+    }
+    int firstDestX = clipX - pixelX;
+
+    if (spanBuffer.size() < static_cast<size_t>(clipWidth)) {
+        spanBuffer.resize(clipWidth);
+    }
+    uint32_t* span = spanBuffer.data();
+
+    // ImageStore decodes icons at the layout size, so this is the usual case
+    bool isUnscaled = (destWidth == sourceWidth && destHeight == sourceHeight);
+
+    // Scaled: work out each column's source once per draw, not per pixel
+    const uint16_t* columnMap = nullptr;
+    if (!isUnscaled) {
+        if (imageColumnMap.size() < static_cast<size_t>(clipWidth)) {
+            imageColumnMap.resize(clipWidth);
+        }
+        for (int offset = 0; offset < clipWidth; offset++) {
+            imageColumnMap[offset] = static_cast<uint16_t>(((firstDestX + offset) * sourceWidth) / destWidth);
+        }
+        columnMap = imageColumnMap.data();
+    }
+
+    // Source rows are stepped through rather than divided out per row
+    int firstDestY = clipY - pixelY;
+    int sourceY = isUnscaled ? firstDestY : (firstDestY * sourceHeight) / destHeight;
+    int sourceRemainder = isUnscaled ? 0 : (firstDestY * sourceHeight) % destHeight;
 
-            uint32_t pixel = image->pixels[sourceY * sourceWidth + sourceX];
-            uint32_t rgbxPixel = pixel & 0xFFFFFF00;
+    bool isOpaqueFormat = image->format == PixelFormat::RGB565;
+
+    int rowY = -1;
+    const uint32_t* row = nullptr;
+    for (int rowIndex = 0; rowIndex < clipHeight; rowIndex++) {
+        if (sourceY != rowY) {
+            row = getImageRow(image, sourceY);
+            rowY = sourceY;
+        }
 
-            OSScreenPutPixelEx(SCREEN_TV, pixelX + destX, pixelY + destY, rgbxPixel);
-            OSScreenPutPixelEx(SCREEN_DRC, pixelX + destX, pixelY + destY, rgbxPixel);
+        uint32_t alphaAnd = 0xFF;
+        if (isUnscaled) {
+            const uint32_t* source = row + firstDestX;
+            for (int offset = 0; offset < clipWidth; offset++) {
+                span[offset] = source[offset];
+                alphaAnd &= source[offset];
+            }
+        } else {
+            for (int offset = 0; offset < clipWidth; offset++) {
+                span[offset] = row[columnMap[offset]];
+                alphaAnd &= span[offset];
+            }
+        }
+
+        // Fully opaque rows (every icon from a game) skip the blend
+        if (isOpaqueFormat || alphaAnd == 0xFF) {
+            for (int offset = 0; offset < clipWidth; offset++) {
+                span[offset] &= 0xFFFFFF00;
+            }
+            copySpan(clipX, clipY + rowIndex, span, clipWidth);
+        } else {
+            blendSpan(clipX, clipY + rowIndex, span, clipWidth);
+        }
+
+        if (isUnscaled) {
+            sourceY++;
+        } else {
+            sourceRemainder += sourceHeight;
+            while (sourceRemainder >= destHeight) {
+                sourceRemainder -= destHeight;
+                sourceY++;
+            }
         }
     }
 }
 
-void drawPlaceholderOSScreen(int pixelX, int pixelY, int width, int height, uint32_t color)
+void drawImageOSScreen(int pixelX, int pixelY, ImageHandle image, int targetWidth, int targetHeight)
 {
-    uint32_t rgbxColor = color & 0xFFFFFF00;
+    if (!image || !image->pixels) {
+        return;
+    }
 
-    for (int offsetY = 0; offsetY < height; offsetY++) {
-        for (int offsetX = 0; offsetX < width; offsetX++) {
-            OSScreenPutPixelEx(SCREEN_TV, pixelX + offsetX, pixelY + offsetY, rgbxColor);
-            OSScreenPutPixelEx(SCREEN_DRC, pixelX + offsetX, pixelY + offsetY, rgbxColor);
-        }
+    int destWidth = (targetWidth > 0) ? targetWidth : image->width;
+    int destHeight = (targetHeight > 0) ? targetHeight : image->height;
+
+    for (int index = 0; index < frameRegion.count; index++) {
+        drawImageClipped(pixelX, pixelY, image, destWidth, destHeight, frameRegion.rects[index]);
     }
 }
 
+void drawPlaceholderOSScreen(int pixelX, int pixelY, int width, int height, uint32_t color)
+{
+    fillRect(pixelX, pixelY, width, height, color & 0xFFFFFF00);
+}
+
 void drawPixelOSScreen(int x, int y, uint32_t color)
 {
-    if (x < 0 || x >= Screen::DRC::WIDTH || y < 0 || y >= Screen::DRC::HEIGHT) return;
-    uint32_t rgbx = color & 0xFFFFFF00;
-    OSScreenPutPixelEx(SCREEN_TV, x, y, rgbx);
-    OSScreenPutPixelEx(SCREEN_DRC, x, y, rgbx);
+    fillRect(x, y, 1, 1, color & 0xFFFFFF00);
 }
 
 void drawHLineOSScreen(int x, int y, int length, uint32_t color)
 {
-    uint32_t rgbx = color & 0xFFFFFF00;
-    for (int i = 0; i < length; i++) {
-        int px = x + i;
-        if (px >= 0 && px < Screen::DRC::WIDTH && y >= 0 && y < Screen::DRC::HEIGHT) {
-            OSScreenPutPixelEx(SCREEN_TV, px, y, rgbx);
-            OSScreenPutPixelEx(SCREEN_DRC, px, y, rgbx);
-        }
-    }
+    fillRect(x, y, length, 1, color & 0xFFFFFF00);
 }
 
 void drawVLineOSScreen(int x, int y, int length, uint32_t color)
 {
-    uint32_t rgbx = color & 0xFFFFFF00;
-    for (int i = 0; i < length; i++) {
-        int py = y + i;
-        if (x >= 0 && x < Screen::DRC::WIDTH && py >= 0 && py < Screen::DRC::HEIGHT) {
-            OSScreenPutPixelEx(SCREEN_TV, x, py, rgbx);
-            OSScreenPutPixelEx(SCREEN_DRC, x, py, rgbx);
+    fillRect(x, y, 1, length, color & 0xFFFFFF00);
+}
+
+#ifdef ENABLE_GX2_RENDERING
+void drawTextGX2(int column, int row, const char* text, uint32_t color)
+{
+    // Convert column/row to pixels (OSScreen uses 8x24 character cells)
+    int pixelX = column * 8;
+    int pixelY = row * 24;
+    GX2Overlay::DrawText(pixelX, pixelY, text, color, 16);
+}
+
+void drawImageGX2(int pixelX, int pixelY, ImageHandle image, int width, int height)
+{
+    // Uploaded once, then one textured quad per draw
+    GX2Texture* texture = IconTextures::Acquire(image);
+    if (texture) {
+        GX2Overlay::DrawTexture(pixelX, pixelY, texture, width, height);
+    }
+}
+
+void drawRectGX2(int x, int y, int width, int height, uint32_t color)
+{
+    GX2Overlay::DrawRect(x, y, width, height, color);
+}
+
+void executeGX2(const DrawList::List& list)
+{
+    for (const DrawList::Command& command : list.GetCommands()) {
+        switch (command.type) {
+            case DrawList::CommandType::TEXT:
+                drawTextGX2(command.x, command.y, list.GetText(command), command.color);
+                break;
+            case DrawList::CommandType::IMAGE:
+                drawImageGX2(command.x, command.y, command.image, command.width, command.height);
+                break;
+            case DrawList::CommandType::PLACEHOLDER:
+            case DrawList::CommandType::PIXEL:
+            case DrawList::CommandType::HLINE:
+            case DrawList::CommandType::VLINE:
+                drawRectGX2(command.x, command.y, command.width, command.height, command.color);
+                break;
         }
     }
 }
 
+// Run by the overlay for every scan buffer the game copies
+void drawOverlayGX2()
+{
+    drawRectGX2(0, 0, Screen::DRC::WIDTH, Screen::DRC::HEIGHT, overlayBackdropColor);
+    executeGX2(frameList);
+}
+#endif
+
 bool initGX2()
 {
 #ifdef ENABLE_GX2_RENDERING
-    if (!GX2Overlay::Init()) {
+    // The overlay needs mapped memory the idle OSScreen standby may hold
+    if (!GX2Overlay::Init() && (!RelieveMemoryPressure() || !GX2Overlay::Init())) {
         return false;
     }
+    // Panels lay out for the DRC; the overlay scales that to each buffer
+    GX2Overlay::SetScreenSize(Screen::DRC::WIDTH, Screen::DRC::HEIGHT);
+    GX2Overlay::SetDrawCallback(drawOverlayGX2);
     GX2Overlay::SetEnabled(true);
     return true;
 #else
@@ -307,46 +1041,42 @@ void shutdownGX2()
 {
 #ifdef ENABLE_GX2_RENDERING
     GX2Overlay::SetEnabled(false);
+    GX2Overlay::SetDrawCallback(nullptr);
     GX2Overlay::Shutdown();
 #endif
 }
 
+// The overlay has no buffer of its own to clear; the menu sits on a
+// translucent backdrop of the background color instead
 void beginFrameGX2(uint32_t clearColor)
 {
-#ifdef ENABLE_GX2_RENDERING
-    GX2Overlay::BeginDraw(clearColor);
-#else
-    (void)clearColor;
-#endif
-}
-
-void endFrameGX2()
-{
-#ifdef ENABLE_GX2_RENDERING
-    GX2Overlay::EndDraw();
-#endif
-}
-
-void drawTextGX2(int column, int row, const char* text, uint32_t color)
-{
-#ifdef ENABLE_GX2_RENDERING
-    // Convert column/row to pixels (OSScreen uses 8x24 character cells)
-    int pixelX = column * 8;
-    int pixelY = row * 24;
-    GX2Overlay::DrawText(pixelX, pixelY, text, color, 16);
-#else
-    (void)column; (void)row; (void)text; (void)color;
-#endif
+    overlayBackdropColor = (clearColor & 0xFFFFFF00) | OVERLAY_BACKDROP_ALPHA;
 }
 
-void drawImageGX2(int pixelX, int pixelY, ImageHandle image, int width, int height)
+void executeOSScreen(const DrawList::List& list)
 {
-#ifdef ENABLE_GX2_RENDERING
-    // TODO: Image rendering not yet implemented
-    (void)pixelX; (void)pixelY; (void)image; (void)width; (void)height;
-#else
-    (void)pixelX; (void)pixelY; (void)image; (void)width; (void)height;
-#endif
+    for (const DrawList::Command& command : list.GetCommands()) {
+        switch (command.type) {
+            case DrawList::CommandType::TEXT:
+                drawTextOSScreen(command.x, command.y, list.GetText(command), 0xFFFFFFFF);
+                break;
+            case DrawList::CommandType::IMAGE:
+                drawImageOSScreen(command.x, command.y, command.image, command.width, command.height);
+                break;
+            case DrawList::CommandType::PLACEHOLDER:
+                drawPlaceholderOSScreen(command.x, command.y, command.width, command.height, command.color);
+                break;
+            case DrawList::CommandType::PIXEL:
+                drawPixelOSScreen(command.x, command.y, command.color);
+                break;
+            case DrawList::CommandType::HLINE:
+                drawHLineOSScreen(command.x, command.y, command.width, command.color);
+                break;
+            case DrawList::CommandType::VLINE:
+                drawVLineOSScreen(command.x, command.y, command.height, command.color);
+                break;
+        }
+    }
 }
 
 }
@@ -402,11 +1132,116 @@ void Shutdown()
     isInitialized = false;
 }
 
+bool Prewarm(uint32_t maxGlyphs)
+{
+#ifdef ENABLE_GX2_RENDERING
+    // Games open the menu as the GX2 overlay
+    return GX2Overlay::Prewarm(maxGlyphs);
+#else
+    (void)maxGlyphs;
+    return true;
+#endif
+}
+
+void ReleaseResources()
+{
+#ifdef ENABLE_GX2_RENDERING
+    GX2Overlay::ReleaseResources();
+#endif
+    ReleaseStandby();
+}
+
+size_t GetResourceBytes()
+{
+#ifdef ENABLE_GX2_RENDERING
+    return GX2Overlay::GetResourceBytes();
+#else
+    return 0;
+#endif
+}
+
+void SetStandbyPolicy(StandbyPolicy policy)
+{
+    standbyPolicy = policy;
+    if (policy == StandbyPolicy::OFF) {
+        ReleaseStandby();
+    }
+}
+
+StandbyPolicy GetStandbyPolicy()
+{
+    return standbyPolicy;
+}
+
+bool ReserveStandby()
+{
+    if (standbyPolicy == StandbyPolicy::OFF || isInitialized) {
+        return false;
+    }
+
+    bool hasTV = reserveStandby(standbyTV, OSScreenGetBufferSizeEx(SCREEN_TV));
+    bool hasDRC = reserveStandby(standbyDRC, OSScreenGetBufferSizeEx(SCREEN_DRC));
+    return hasTV && hasDRC;
+}
+
+void ReleaseStandby()
+{
+    freeStandby(standbyTV);
+    freeStandby(standbyDRC);
+}
+
+bool IsStandbyReserved()
+{
+    return standbyTV.buffer && standbyDRC.buffer;
+}
+
+size_t GetStandbyBytes()
+{
+    return static_cast<size_t>(standbyTV.size) + standbyDRC.size;
+}
+
+bool RelieveMemoryPressure()
+{
+    if (standbyPolicy != StandbyPolicy::RELEASE_ON_PRESSURE ||
+        (!standbyTV.buffer && !standbyDRC.buffer)) {
+        return false;
+    }
+    ReleaseStandby();
+    return true;
+}
+
 bool IsInitialized()
 {
     return isInitialized;
 }
 
+bool IsOverlayAvailable()
+{
+#ifdef ENABLE_GX2_RENDERING
+    return GX2Overlay::IsGameRendering();
+#else
+    return false;
+#endif
+}
+
+void SetOverlayFrameCallback(void (*callback)())
+{
+#ifdef ENABLE_GX2_RENDERING
+    GX2Overlay::SetUpdateCallback(callback);
+#else
+    (void)callback;
+#endif
+}
+
+void WaitForVsync()
+{
+    if (!isInitialized || selectedBackend != Backend::OS_SCREEN || hasWaitedForVsync) {
+        return;
+    }
+    GX2WaitForVsync();
+    hasWaitedForVsync = true;
+}
+
 void BeginFrame(uint32_t clearColor)
 {
     if (!isInitialized) {
@@ -421,6 +1256,8 @@ void BeginFrame(uint32_t clearColor)
             beginFrameGX2(clearColor);
             break;
     }
+
+    frameList.Reset();
 }
 
 void EndFrame()
@@ -431,10 +1268,11 @@ void EndFrame()
 
     switch (selectedBackend) {
         case Backend::OS_SCREEN:
+            executeOSScreen(frameList);
             endFrameOSScreen();
             break;
         case Backend::GX2:
-            endFrameGX2();
+            // Kept for the overlay, which draws it into the game's frames
             break;
     }
 }
@@ -445,14 +1283,7 @@ void DrawText(int column, int row, const char* text, uint32_t color)
         return;
     }
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawTextOSScreen(column, row, text, 0xFFFFFFFF);
-            break;
-        case Backend::GX2:
-            drawTextGX2(column, row, text, color);
-            break;
-    }
+    frameList.AddText(column, row, text, color);
 }
 
 void DrawTextF(int column, int row, uint32_t color, const char* format, ...)
@@ -503,14 +1334,16 @@ void DrawImage(int pixelX, int pixelY, ImageHandle image, int width, int height)
         return;
     }
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawImageOSScreen(pixelX, pixelY, image, width, height);
-            break;
-        case Backend::GX2:
-            drawImageGX2(pixelX, pixelY, image, width, height);
-            break;
-    }
+    frameList.AddImage(pixelX, pixelY, image, width, height);
+}
+
+void ReleaseImage(ImageHandle image)
+{
+#ifdef ENABLE_GX2_RENDERING
+    IconTextures::Release(image);
+#else
+    (void)image;
+#endif
 }
 
 void DrawPlaceholder(int pixelX, int pixelY, int width, int height, uint32_t color)
@@ -519,52 +1352,102 @@ void DrawPlaceholder(int pixelX, int pixelY, int width, int height, uint32_t col
         return;
     }
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawPlaceholderOSScreen(pixelX, pixelY, width, height, color);
-            break;
-        case Backend::GX2:
-            break;
-    }
+    frameList.AddRect(DrawList::CommandType::PLACEHOLDER, pixelX, pixelY, width, height, color);
 }
 
 void DrawPixel(int x, int y, uint32_t color)
 {
     if (!isInitialized) return;
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawPixelOSScreen(x, y, color);
-            break;
-        case Backend::GX2:
-            break;
-    }
+    frameList.AddRect(DrawList::CommandType::PIXEL, x, y, 1, 1, color);
 }
 
 void DrawHLine(int x, int y, int length, uint32_t color)
 {
     if (!isInitialized) return;
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawHLineOSScreen(x, y, length, color);
-            break;
-        case Backend::GX2:
-            break;
-    }
+    frameList.AddRect(DrawList::CommandType::HLINE, x, y, length, 1, color);
 }
 
 void DrawVLine(int x, int y, int length, uint32_t color)
 {
     if (!isInitialized) return;
 
-    switch (selectedBackend) {
-        case Backend::OS_SCREEN:
-            drawVLineOSScreen(x, y, length, color);
-            break;
-        case Backend::GX2:
-            break;
+    frameList.AddRect(DrawList::CommandType::VLINE, x, y, 1, length, color);
+}
+
+const DrawList::List& GetDrawList()
+{
+    return frameList;
+}
+
+void SetRetainedMode(bool enabled)
+{
+    // Buffers drawn in full meanwhile may have been left showing anything
+    if (enabled && !isRetainedMode) {
+        InvalidateAll();
+    }
+    isRetainedMode = enabled;
+}
+
+void Invalidate(int pixelX, int pixelY, int width, int height)
+{
+    if (!isInitialized || selectedBackend != Backend::OS_SCREEN) {
+        return;
+    }
+    invalidateRect({ pixelX, pixelY, width, height });
+}
+
+void InvalidateRows(int firstRow, int rowCount)
+{
+    Invalidate(0, RowToPixelY(firstRow), GetScreenWidth(), rowCount * Screen::Grid::CHAR_HEIGHT);
+}
+
+void InvalidateAll()
+{
+    if (!isInitialized || selectedBackend != Backend::OS_SCREEN) {
+        return;
+    }
+    invalidateAllOSScreen();
+}
+
+void SetTVPacing(TVPacing pacing, int frameDivisor)
+{
+    tvPacer.Set(pacing, frameDivisor);
+}
+
+TVPacing GetTVPacing()
+{
+    return tvPacer.GetPacing();
+}
+
+bool IsTVBehind()
+{
+    if (!isInitialized || selectedBackend != Backend::OS_SCREEN || tvPacer.GetPacing() == TVPacing::OFF) {
+        return false;
+    }
+    return tvPendingRegions[0].count > 0 || tvPendingRegions[1].count > 0;
+}
+
+bool NeedsDraw(int pixelX, int pixelY, int width, int height)
+{
+    if (!isInitialized) {
+        return false;
     }
+    if (selectedBackend != Backend::OS_SCREEN) {
+        return true;
+    }
+
+    for (int index = 0; index < frameRegion.count; index++) {
+        int clipX = pixelX;
+        int clipY = pixelY;
+        int clipWidth = width;
+        int clipHeight = height;
+        if (clipToRect(clipX, clipY, clipWidth, clipHeight, frameRegion.rects[index])) {
+            return true;
+        }
+    }
+    return false;
 }
 
 int ColToPixelX(int column)
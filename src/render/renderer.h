@@ -5,9 +5,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include "tv_pacing.h"
 #include "../ui/layout.h"
 
+namespace DrawList {
+struct List;
+}
+
 namespace Renderer {
 
 enum class Backend {
@@ -18,10 +24,27 @@ enum class Backend {
 void SetBackend(Backend backend);
 Backend GetBackend();
 
+// Pixel layouts an image can be stored in. Icons are opaque, so RGB565
+// holds them in half the memory of RGBA8888; RGBA4444 keeps some alpha
+enum class PixelFormat : uint8_t {
+    RGBA8888,
+    RGB565,
+    RGBA4444
+};
+
+inline int GetBytesPerPixel(PixelFormat format)
+{
+    return format == PixelFormat::RGBA8888 ? 4 : 2;
+}
+
 struct ImageData {
-    uint32_t* pixels;
+    union {
+        uint32_t* pixels;      // RGBA8888
+        uint16_t* pixels16;    // RGB565, RGBA4444
+    };
     int width;
     int height;
+    PixelFormat format = PixelFormat::RGBA8888;
 };
 
 using ImageHandle = ImageData*;
@@ -31,9 +54,56 @@ bool Init();
 void Shutdown();
 bool IsInitialized();
 
+// Backend resources that outlive Init()/Shutdown(), like the GX2 glyph
+// atlas, so the first frame after opening the menu doesn't build them.
+// Prewarm builds them at most maxGlyphs glyphs per call and returns true
+// once done (the warm-up font job calls it until then); release at
+// plugin shutdown
+bool Prewarm(uint32_t maxGlyphs);
+void ReleaseResources();
+
+// Bytes Prewarm() holds; ReleaseResources() frees them while not
+// initialized
+size_t GetResourceBytes();
+
+// What happens to the OSScreen framebuffers between opens. Reserved ahead
+// of time, they make Init() instant and immune to a fragmented heap
+enum class StandbyPolicy {
+    OFF,                    // Allocated by each Init(), freed by Shutdown()
+    KEEP,                   // Kept until ReleaseResources()
+    RELEASE_ON_PRESSURE     // Kept, but freed by RelieveMemoryPressure()
+};
+
+void SetStandbyPolicy(StandbyPolicy policy);
+StandbyPolicy GetStandbyPolicy();
+
+// Allocate the standby framebuffers now; a no-op while initialized or
+// with the policy OFF. Returns true if both are reserved
+bool ReserveStandby();
+void ReleaseStandby();
+bool IsStandbyReserved();
+size_t GetStandbyBytes();
+
+// Something needs mapped memory: free the standby if the policy allows.
+// Returns true if anything was freed, so the caller can retry
+bool RelieveMemoryPressure();
+
+// Wait for the next vsync ahead of BeginFrame(), which then doesn't wait
+// again, so input read in between is drawn this frame. A no-op on the
+// GX2 backend, where the game paces the frames
+void WaitForVsync();
+
 void BeginFrame(uint32_t clearColor);
 void EndFrame();
 
+// Overlay mode (the GX2 backend): the menu draws over a running game's
+// frames instead of taking over the screen. The callback runs once per
+// game frame on the game's thread and does the menu's frame there,
+// Init() included; EndFrame() keeps the list, which the overlay then draws
+// into each scan buffer the game copies. nullptr stops the callbacks
+bool IsOverlayAvailable();
+void SetOverlayFrameCallback(void (*callback)());
+
 void DrawText(int column, int row, const char* text, uint32_t color = 0xFFFFFFFF);
 void DrawTextF(int column, int row, uint32_t color, const char* format, ...);
 void DrawTextF(int column, int row, const char* format, ...);
@@ -42,11 +112,40 @@ bool SupportsImages();
 void DrawImage(int pixelX, int pixelY, ImageHandle image, int width = 0, int height = 0);
 void DrawPlaceholder(int pixelX, int pixelY, int width, int height, uint32_t color);
 
+// Drop any backend copy of an image (the GX2 icon texture) before the
+// image is freed; ImageStore::FreeImage calls this
+void ReleaseImage(ImageHandle image);
+
 // Pixel drawing (for debug overlays)
 void DrawPixel(int x, int y, uint32_t color);
 void DrawHLine(int x, int y, int length, uint32_t color);
 void DrawVLine(int x, int y, int length, uint32_t color);
 
+// Draw calls are recorded as commands and drawn together in EndFrame
+// (see draw_list.h); this is the current frame's list so far
+const DrawList::List& GetDrawList();
+
+// Dirty-rectangle rendering (OSScreen). In retained mode a frame only
+// clears, draws and flushes what was invalidated since each buffer was
+// last drawn; draws elsewhere are clipped away. Off by default
+void SetRetainedMode(bool enabled);
+void Invalidate(int pixelX, int pixelY, int width, int height);
+void InvalidateRows(int firstRow, int rowCount);
+void InvalidateAll();
+
+// Whether anything drawn in this rectangle would show this frame; false
+// where retained mode keeps what is already there. Lets a caller with
+// many small draws skip building the ones that would be clipped away
+bool NeedsDraw(int pixelX, int pixelY, int width, int height);
+
+// How often the TV's copy of the menu is drawn (see tv_pacing.h)
+void SetTVPacing(TVPacing pacing, int frameDivisor = 2);
+TVPacing GetTVPacing();
+
+// Whether the TV hasn't shown everything the DRC has yet; never with
+// pacing OFF. The menu keeps drawing frames until it has
+bool IsTVBehind();
+
 int ColToPixelX(int column);
 int RowToPixelY(int row);
 
@@ -0,0 +1,50 @@
+/**
+ * TV Pacing Implementation
+ *
+ * See tv_pacing.h for usage documentation.
+ */
+
+#include "tv_pacing.h"
+
+#include <algorithm>
+
+namespace Renderer {
+
+void TVPacer::Set(TVPacing pacing, int frameDivisor)
+{
+    // Past the cap a skipped-frame count never reaches it
+    mPacing = pacing;
+    mFrameDivisor = std::clamp(frameDivisor, 1, TV_ON_CHANGE_MAX_FRAMES);
+}
+
+bool TVPacer::BeginFrame(bool isTVBehind, bool isDRCChanging)
+{
+    if (isTVBehind && isDue(isDRCChanging)) {
+        mSkippedFrames = 0;
+        return true;
+    }
+    mSkippedFrames = std::min(mSkippedFrames + 1, TV_ON_CHANGE_MAX_FRAMES);
+    return false;
+}
+
+void TVPacer::Reset()
+{
+    *this = TVPacer();
+}
+
+bool TVPacer::isDue(bool isDRCChanging) const
+{
+    switch (mPacing) {
+        case TVPacing::EVERY_FRAME:
+            return true;
+        case TVPacing::DIVIDED:
+            return mSkippedFrames + 1 >= mFrameDivisor;
+        case TVPacing::ON_CHANGE:
+            return !isDRCChanging || mSkippedFrames + 1 >= TV_ON_CHANGE_MAX_FRAMES;
+        case TVPacing::OFF:
+            return false;
+    }
+    return true;
+}
+
+} // namespace Renderer
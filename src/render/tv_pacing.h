@@ -0,0 +1,73 @@
+/**
+ * TV Pacing
+ *
+ * Decides which frames draw the TV's copy of the menu, shared by the
+ * OSScreen backend, the unit test renderer and the web preview so all
+ * three pace the TV the same way.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The DRC is drawn every frame; the TV is drawn from the composed DRC
+ * frame at the chosen pace. Once a frame, after the DRC's part of it is
+ * known, the backend tells the pacer whether the TV is behind (it hasn't
+ * shown something the DRC has) and whether the DRC changes this frame.
+ * A frame draws the TV if the TV is behind and the pace allows it; every
+ * other frame counts as skipped, which is what DIVIDED and ON_CHANGE's
+ * upper bound count against.
+ *
+ * What the TV missed is the backend's to track (dirty regions, a frame
+ * hash); a skipped frame leaves it pending for the next TV frame.
+ *
+ * USAGE:
+ * ------
+ *   Renderer::TVPacer pacer;
+ *   pacer.Set(Renderer::TVPacing::DIVIDED, 2);
+ *
+ *   // Each frame, once the DRC's region is known
+ *   if (pacer.BeginFrame(tvPending.count > 0, frameRegion.count > 0)) {
+ *       ...scale, flush and flip the TV
+ *   }
+ */
+
+#pragma once
+
+namespace Renderer {
+
+// How often the TV's copy of the menu is drawn (OSScreen). The DRC is
+// drawn every frame; the TV shows the same frame scaled to its own
+// resolution, which at 1080p costs several times the DRC's fill and
+// flush. Frames the TV skips are neither scaled, flushed nor flipped,
+// and its next frame catches up on everything invalidated meanwhile
+enum class TVPacing {
+    EVERY_FRAME,    // In step with the DRC
+    DIVIDED,        // At most every frameDivisor'th frame
+    ON_CHANGE,      // Once the DRC stops changing, and every
+                    // TV_ON_CHANGE_MAX_FRAMES while it keeps changing
+    OFF             // Never; the TV keeps what it showed
+};
+
+constexpr int TV_ON_CHANGE_MAX_FRAMES = 30;
+
+class TVPacer {
+public:
+    // frameDivisor is clamped to 1..TV_ON_CHANGE_MAX_FRAMES
+    void Set(TVPacing pacing, int frameDivisor);
+    TVPacing GetPacing() const { return mPacing; }
+
+    // Whether this frame draws the TV; call once per frame
+    bool BeginFrame(bool isTVBehind, bool isDRCChanging);
+
+    // Back to EVERY_FRAME with nothing skipped
+    void Reset();
+
+private:
+    bool isDue(bool isDRCChanging) const;
+
+    TVPacing mPacing = TVPacing::EVERY_FRAME;
+    int mFrameDivisor = 1;
+
+    // Frames since the TV was last drawn, up to TV_ON_CHANGE_MAX_FRAMES
+    int mSkippedFrames = 0;
+};
+
+} // namespace Renderer
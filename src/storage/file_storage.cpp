@@ -1,13 +1,473 @@
 // Low-level file I/O operations
 
 #include "file_storage.h"
+#include "../utils/worker_threads.h"
 
+#include <coreinit/event.h>
+#include <coreinit/filesystem.h>
+#include <coreinit/mutex.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <malloc.h>
 #include <sys/stat.h>
+#include <vector>
 
 namespace FileStorage {
 
+namespace {
+
+// Size of an open file, leaving it positioned at the start; 0 if empty
+// or unknown
+size_t getFileSize(FILE* file)
+{
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    return fileSize > 0 ? static_cast<size_t>(fileSize) : 0;
+}
+
+bool reserveReadBuffer(ReadBuffer& buffer, size_t size)
+{
+    if (size <= buffer.capacity) {
+        return true;
+    }
+
+    // The old contents are never needed, so there's nothing to copy
+    size_t capacity = (size + READ_BUFFER_ALIGNMENT - 1) & ~(READ_BUFFER_ALIGNMENT - 1);
+    FreeReadBuffer(buffer);
+    buffer.data = static_cast<uint8_t*>(memalign(READ_BUFFER_ALIGNMENT, capacity));
+    if (!buffer.data) {
+        return false;
+    }
+    buffer.capacity = capacity;
+    return true;
+}
+
+// =============================================================================
+// Direct FS Client
+// =============================================================================
+// Whole-file and positioned reads go straight to an FS client, as large
+// reads into 0x40-aligned memory, skipping the devoptab and stdio's small
+// buffered reads. A path the client can't take, an unaligned buffer or an
+// FS error other than a missing file falls back to stdio.
+
+constexpr const char* SD_PREFIX = "sd:/";
+constexpr const char* SD_VOLUME = "/vol/external01/";
+constexpr const char* VOLUME_PREFIX = "/vol/";
+
+// Largest single FS read
+constexpr uint32_t MAX_DIRECT_READ = 1024 * 1024;
+
+enum class DirectResult {
+    OK,
+    NOT_FOUND,
+    UNAVAILABLE
+};
+
+FSClient* sClient = nullptr;
+FSCmdBlock* sCmdBlock = nullptr;
+
+// Every thread shares the one command block
+OSMutex sClientMutex;
+
+// "sd:/..." becomes an SD volume path; "/vol/..." is used as is
+bool toVolumePath(const char* path, char* outPath, size_t maxLen)
+{
+    size_t prefixLength = strlen(SD_PREFIX);
+    if (strncmp(path, SD_PREFIX, prefixLength) == 0) {
+        int written = snprintf(outPath, maxLen, "%s%s", SD_VOLUME, path + prefixLength);
+        return written > 0 && static_cast<size_t>(written) < maxLen;
+    }
+    if (strncmp(path, VOLUME_PREFIX, strlen(VOLUME_PREFIX)) == 0 && strlen(path) < maxLen) {
+        strcpy(outPath, path);
+        return true;
+    }
+    return false;
+}
+
+bool readDirect(FSFileHandle handle, uint8_t* buffer, size_t offset, size_t size)
+{
+    while (size > 0) {
+        uint32_t request = size < MAX_DIRECT_READ ? static_cast<uint32_t>(size) : MAX_DIRECT_READ;
+        FSStatus result = FSReadFileWithPos(sClient, sCmdBlock, buffer, 1, request,
+                                            static_cast<uint32_t>(offset), handle,
+                                            FS_READ_FLAG_NONE, FS_ERROR_FLAG_ALL);
+        // Sizes are known up front, so a short read means a failed one
+        if (result != static_cast<FSStatus>(request)) {
+            return false;
+        }
+        buffer += result;
+        offset += result;
+        size -= result;
+    }
+    return true;
+}
+
+// Read size bytes at offset, or the whole file (size 0) into a grown
+// buffer. Either destination must be 0x40-aligned
+DirectResult readFileDirect(const char* path, ReadBuffer* wholeFile, size_t* outSize,
+                            size_t offset, void* destination, size_t size)
+{
+    char volumePath[256];
+    if (!sClient || !toVolumePath(path, volumePath, sizeof(volumePath))) {
+        return DirectResult::UNAVAILABLE;
+    }
+
+    OSLockMutex(&sClientMutex);
+
+    FSFileHandle handle;
+    FSStatus openResult = FSOpenFile(sClient, sCmdBlock, volumePath, "r", &handle, FS_ERROR_FLAG_ALL);
+    if (openResult != FS_STATUS_OK) {
+        OSUnlockMutex(&sClientMutex);
+        return openResult == FS_STATUS_NOT_FOUND ? DirectResult::NOT_FOUND : DirectResult::UNAVAILABLE;
+    }
+
+    DirectResult result = DirectResult::UNAVAILABLE;
+    if (wholeFile) {
+        FSStat stat;
+        if (FSGetStatFile(sClient, sCmdBlock, handle, &stat, FS_ERROR_FLAG_ALL) == FS_STATUS_OK &&
+            stat.size > 0 && reserveReadBuffer(*wholeFile, stat.size) &&
+            readDirect(handle, wholeFile->data, 0, stat.size)) {
+            *outSize = stat.size;
+            result = DirectResult::OK;
+        }
+    } else if (readDirect(handle, static_cast<uint8_t*>(destination), offset, size)) {
+        result = DirectResult::OK;
+    }
+
+    FSCloseFile(sClient, sCmdBlock, handle, FS_ERROR_FLAG_ALL);
+    OSUnlockMutex(&sClientMutex);
+    return result;
+}
+
+bool isAligned(const void* pointer)
+{
+    return (reinterpret_cast<uintptr_t>(pointer) & (READ_BUFFER_ALIGNMENT - 1)) == 0;
+}
+
+// =============================================================================
+// Asynchronous Operations
+// =============================================================================
+// One I/O thread, started by the first request after the last one exited
+// (as the settings writer does), services the queue a batch at a time.
+
+enum class AsyncOperation {
+    READ,
+    WRITE,
+    COPY
+};
+
+struct AsyncRequest {
+    AsyncOperation operation;
+    char path[MAX_ASYNC_PATH];
+    char destinationPath[MAX_ASYNC_PATH];
+    uint8_t* data;
+    size_t size;
+    bool success;
+    AsyncCallback callback;
+    void* context;
+};
+
+// How long the I/O thread waits for more work before exiting
+constexpr int IO_IDLE_MS = 250;
+constexpr int IO_STACK_SIZE = 16 * 1024;
+
+OSThread* ioThread = nullptr;
+uint8_t* ioStack = nullptr;
+
+// Serializes starting and joining the thread
+OSMutex threadMutex;
+
+// Guards the queues and flags below between callers and the I/O thread
+OSMutex queueMutex;
+std::vector<AsyncRequest> queuedRequests;
+std::vector<AsyncRequest> finishedRequests;
+int outstandingCount = 0;
+bool isThreadRunning = false;
+bool isStopping = false;
+
+// Auto-reset; signaled when requests are queued or the thread should stop
+OSEvent wakeEvent;
+
+bool isAsyncInitialized = false;
+
+// I/O thread only: the batch being serviced
+std::vector<AsyncRequest> activeBatch;
+
+size_t directoryLength(const char* path)
+{
+    const char* lastSlash = strrchr(path, '/');
+    return lastSlash ? static_cast<size_t>(lastSlash - path) : 0;
+}
+
+bool isDirectoryBefore(const AsyncRequest& first, const AsyncRequest& second)
+{
+    size_t firstLength = directoryLength(first.path);
+    size_t secondLength = directoryLength(second.path);
+    int order = strncmp(first.path, second.path, std::min(firstLength, secondLength));
+    return order != 0 ? order < 0 : firstLength < secondLength;
+}
+
+void service(AsyncRequest& request)
+{
+    switch (request.operation) {
+        case AsyncOperation::READ:
+            request.success = ReadFile(request.path, &request.data, &request.size);
+            break;
+        case AsyncOperation::WRITE:
+            request.success = WriteFile(request.path, request.data, request.size);
+            free(request.data);
+            request.data = nullptr;
+            request.size = 0;
+            break;
+        case AsyncOperation::COPY:
+            request.success = CopyFile(request.path, request.destinationPath);
+            break;
+    }
+}
+
+// Call with queueMutex held
+void finishRequest(AsyncRequest& request)
+{
+    if (request.callback) {
+        finishedRequests.push_back(request);
+    } else {
+        free(request.data);
+    }
+}
+
+int ioThreadEntry(int, const char**)
+{
+    for (;;) {
+        OSLockMutex(&queueMutex);
+        bool shouldWait = queuedRequests.empty() && !isStopping;
+        OSUnlockMutex(&queueMutex);
+
+        if (shouldWait) {
+            // A request arriving while we wait keeps the thread alive
+            OSWaitEventWithTimeout(&wakeEvent, OSMillisecondsToTicks(IO_IDLE_MS));
+        }
+
+        OSLockMutex(&queueMutex);
+        if (queuedRequests.empty()) {
+            isThreadRunning = false;
+            OSUnlockMutex(&queueMutex);
+            return 0;
+        }
+        activeBatch.swap(queuedRequests);
+        OSUnlockMutex(&queueMutex);
+
+        // Stable, so operations on one file keep their order
+        std::stable_sort(activeBatch.begin(), activeBatch.end(), isDirectoryBefore);
+        for (AsyncRequest& request : activeBatch) {
+            service(request);
+        }
+
+        OSLockMutex(&queueMutex);
+        for (AsyncRequest& request : activeBatch) {
+            finishRequest(request);
+        }
+        outstandingCount -= static_cast<int>(activeBatch.size());
+        OSUnlockMutex(&queueMutex);
+        activeBatch.clear();
+    }
+}
+
+// Call with threadMutex held
+void joinIOThread()
+{
+    if (!ioThread) {
+        return;
+    }
+
+    int threadResult = 0;
+    OSJoinThread(ioThread, &threadResult);
+    free(ioThread);
+    free(ioStack);
+    ioThread = nullptr;
+    ioStack = nullptr;
+}
+
+// Without a thread, queued requests run on the caller; their callbacks
+// still wait for Update()
+void runQueuedInline()
+{
+    OSLockMutex(&queueMutex);
+    std::vector<AsyncRequest> pending;
+    pending.swap(queuedRequests);
+    isThreadRunning = false;
+    OSUnlockMutex(&queueMutex);
+
+    for (AsyncRequest& request : pending) {
+        service(request);
+    }
+
+    OSLockMutex(&queueMutex);
+    for (AsyncRequest& request : pending) {
+        finishRequest(request);
+    }
+    outstandingCount -= static_cast<int>(pending.size());
+    OSUnlockMutex(&queueMutex);
+}
+
+bool enqueue(const AsyncRequest& request)
+{
+    if (!isAsyncInitialized) {
+        // Before Init() there is no thread or lock; run it here and now
+        AsyncRequest inlineRequest = request;
+        service(inlineRequest);
+        if (inlineRequest.callback) {
+            inlineRequest.callback(inlineRequest.context, inlineRequest.success,
+                                   inlineRequest.data, inlineRequest.size);
+        } else {
+            free(inlineRequest.data);
+        }
+        return true;
+    }
+
+    OSLockMutex(&queueMutex);
+    queuedRequests.push_back(request);
+    outstandingCount++;
+    bool needsThread = !isThreadRunning;
+    isThreadRunning = true;
+    OSUnlockMutex(&queueMutex);
+
+    if (!needsThread) {
+        OSSignalEvent(&wakeEvent);
+        return true;
+    }
+
+    OSLockMutex(&threadMutex);
+
+    // The previous thread has already decided to exit
+    joinIOThread();
+
+    ioThread = static_cast<OSThread*>(memalign(16, sizeof(OSThread)));
+    ioStack = static_cast<uint8_t*>(memalign(16, IO_STACK_SIZE));
+
+    bool isCreated = ioThread && ioStack &&
+                     OSCreateThread(ioThread, ioThreadEntry, 0, nullptr,
+                                    ioStack + IO_STACK_SIZE, IO_STACK_SIZE,
+                                    24, WorkerThreads::GetAffinity());
+    if (!isCreated) {
+        free(ioThread);
+        free(ioStack);
+        ioThread = nullptr;
+        ioStack = nullptr;
+        OSUnlockMutex(&threadMutex);
+
+        runQueuedInline();
+        return true;
+    }
+
+    OSSetThreadName(ioThread, "TitleSwitcher I/O");
+    OSResumeThread(ioThread);
+    OSUnlockMutex(&threadMutex);
+    return true;
+}
+
+bool copyPath(char* destination, const char* path)
+{
+    if (!path || strlen(path) >= MAX_ASYNC_PATH) {
+        return false;
+    }
+    strcpy(destination, path);
+    return true;
+}
+
+AsyncRequest makeRequest(AsyncOperation operation, AsyncCallback callback, void* context)
+{
+    AsyncRequest request;
+    request.operation = operation;
+    request.path[0] = '\0';
+    request.destinationPath[0] = '\0';
+    request.data = nullptr;
+    request.size = 0;
+    request.success = false;
+    request.callback = callback;
+    request.context = context;
+    return request;
+}
+
+void initAsync()
+{
+    if (isAsyncInitialized) {
+        return;
+    }
+
+    OSInitMutex(&threadMutex);
+    OSInitMutex(&queueMutex);
+    OSInitEvent(&wakeEvent, FALSE, OS_EVENT_MODE_AUTO);
+    isAsyncInitialized = true;
+}
+
+void shutdownAsync()
+{
+    if (!isAsyncInitialized) {
+        return;
+    }
+
+    // Also runs the callbacks of everything that was still queued
+    WaitForAsync();
+    isAsyncInitialized = false;
+}
+
+// Every successful read adds to this, whichever thread it runs on
+std::atomic<uint64_t> sBytesRead{0};
+
+void countBytesRead(size_t size)
+{
+    sBytesRead.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void Init()
+{
+    if (sClient) {
+        return;
+    }
+
+    initAsync();
+    FSInit();
+    OSInitMutex(&sClientMutex);
+
+    FSClient* client = static_cast<FSClient*>(memalign(READ_BUFFER_ALIGNMENT, sizeof(FSClient)));
+    sCmdBlock = static_cast<FSCmdBlock*>(memalign(READ_BUFFER_ALIGNMENT, sizeof(FSCmdBlock)));
+    if (!client || !sCmdBlock || FSAddClient(client, FS_ERROR_FLAG_ALL) != FS_STATUS_OK) {
+        // Everything goes through stdio
+        free(client);
+        free(sCmdBlock);
+        sCmdBlock = nullptr;
+        return;
+    }
+
+    FSInitCmdBlock(sCmdBlock);
+    sClient = client;
+}
+
+void Shutdown()
+{
+    shutdownAsync();
+    if (!sClient) {
+        return;
+    }
+
+    OSLockMutex(&sClientMutex);
+    FSDelClient(sClient, FS_ERROR_FLAG_ALL);
+    free(sClient);
+    free(sCmdBlock);
+    sClient = nullptr;
+    sCmdBlock = nullptr;
+    OSUnlockMutex(&sClientMutex);
+}
+
 bool ReadFile(const char* path, uint8_t** outData, size_t* outSize)
 {
     if (!path || !outData || !outSize) {
@@ -15,41 +475,64 @@ bool ReadFile(const char* path, uint8_t** outData, size_t* outSize)
     }
 
     *outData = nullptr;
-    *outSize = 0;
 
-    FILE* file = fopen(path, "rb");
-    if (!file) {
+    // The buffer's storage is handed over; free() releases it
+    ReadBuffer buffer;
+    if (!ReadFileInto(path, buffer, outSize)) {
+        FreeReadBuffer(buffer);
         return false;
     }
 
-    fseek(file, 0, SEEK_END);
-    long fileSize = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    *outData = buffer.data;
+    return true;
+}
 
-    if (fileSize <= 0) {
-        fclose(file);
+bool ReadFileInto(const char* path, ReadBuffer& buffer, size_t* outSize)
+{
+    if (!path || !outSize) {
         return false;
     }
 
-    uint8_t* buffer = static_cast<uint8_t*>(malloc(fileSize));
-    if (!buffer) {
+    *outSize = 0;
+
+    DirectResult direct = readFileDirect(path, &buffer, outSize, 0, nullptr, 0);
+    if (direct != DirectResult::UNAVAILABLE) {
+        if (direct == DirectResult::OK) {
+            countBytesRead(*outSize);
+        }
+        return direct == DirectResult::OK;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    size_t fileSize = getFileSize(file);
+    if (fileSize == 0 || !reserveReadBuffer(buffer, fileSize)) {
         fclose(file);
         return false;
     }
 
-    size_t bytesRead = fread(buffer, 1, fileSize, file);
+    size_t bytesRead = fread(buffer.data, 1, fileSize, file);
     fclose(file);
 
-    if (bytesRead != static_cast<size_t>(fileSize)) {
-        free(buffer);
+    if (bytesRead != fileSize) {
         return false;
     }
 
-    *outData = buffer;
     *outSize = bytesRead;
+    countBytesRead(bytesRead);
     return true;
 }
 
+void FreeReadBuffer(ReadBuffer& buffer)
+{
+    free(buffer.data);
+    buffer.data = nullptr;
+    buffer.capacity = 0;
+}
+
 bool WriteFile(const char* path, const uint8_t* data, size_t size)
 {
     if (!path || !data || size == 0) {
@@ -100,6 +583,169 @@ bool CopyFile(const char* srcPath, const char* dstPath)
     return success;
 }
 
+bool ReadAt(const char* path, size_t offset, void* buffer, size_t size)
+{
+    if (!path || !buffer || size == 0) {
+        return false;
+    }
+
+    if (isAligned(buffer)) {
+        DirectResult direct = readFileDirect(path, nullptr, nullptr, offset, buffer, size);
+        if (direct != DirectResult::UNAVAILABLE) {
+            if (direct == DirectResult::OK) {
+                countBytesRead(size);
+            }
+            return direct == DirectResult::OK;
+        }
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    bool success = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+                   fread(buffer, 1, size, file) == size;
+    fclose(file);
+    if (success) {
+        countBytesRead(size);
+    }
+    return success;
+}
+
+bool WriteAt(const char* path, size_t offset, const void* data, size_t size)
+{
+    if (!path || !data || size == 0) {
+        return false;
+    }
+
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        file = fopen(path, "w+b");
+    }
+    if (!file) {
+        return false;
+    }
+
+    bool success = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+                   fwrite(data, 1, size, file) == size;
+    fclose(file);
+    return success;
+}
+
+bool OpenReader(const char* path, FileReader& reader)
+{
+    reader.file = path ? fopen(path, "rb") : nullptr;
+    return reader.file != nullptr;
+}
+
+size_t ReadChunk(FileReader& reader, void* buffer, size_t size)
+{
+    if (!reader.file || !buffer || size == 0) {
+        return 0;
+    }
+
+    size_t bytesRead = fread(buffer, 1, size, reader.file);
+    countBytesRead(bytesRead);
+    return bytesRead;
+}
+
+uint64_t GetBytesRead()
+{
+    return sBytesRead.load(std::memory_order_relaxed);
+}
+
+void CloseReader(FileReader& reader)
+{
+    if (reader.file) {
+        fclose(reader.file);
+        reader.file = nullptr;
+    }
+}
+
+bool ReadAsync(const char* path, AsyncCallback callback, void* context)
+{
+    AsyncRequest request = makeRequest(AsyncOperation::READ, callback, context);
+    if (!copyPath(request.path, path)) {
+        return false;
+    }
+    return enqueue(request);
+}
+
+bool WriteAsync(const char* path, uint8_t* data, size_t size, AsyncCallback callback, void* context)
+{
+    AsyncRequest request = makeRequest(AsyncOperation::WRITE, callback, context);
+    request.data = data;
+    request.size = size;
+    if (!data || size == 0 || !copyPath(request.path, path) || !enqueue(request)) {
+        free(data);
+        return false;
+    }
+    return true;
+}
+
+bool CopyAsync(const char* srcPath, const char* dstPath, AsyncCallback callback, void* context)
+{
+    AsyncRequest request = makeRequest(AsyncOperation::COPY, callback, context);
+    if (!copyPath(request.path, srcPath) || !copyPath(request.destinationPath, dstPath)) {
+        return false;
+    }
+    return enqueue(request);
+}
+
+int Update()
+{
+    if (!isAsyncInitialized) {
+        return 0;
+    }
+
+    // Callbacks may queue more work, so they run outside the lock
+    std::vector<AsyncRequest> finished;
+    OSLockMutex(&queueMutex);
+    finished.swap(finishedRequests);
+    OSUnlockMutex(&queueMutex);
+
+    for (AsyncRequest& request : finished) {
+        request.callback(request.context, request.success, request.data, request.size);
+    }
+    return static_cast<int>(finished.size());
+}
+
+void WaitForAsync()
+{
+    if (!isAsyncInitialized) {
+        return;
+    }
+
+    OSLockMutex(&queueMutex);
+    isStopping = true;
+    OSUnlockMutex(&queueMutex);
+
+    // The thread drains the queue, then exits without its idle wait
+    OSSignalEvent(&wakeEvent);
+    OSLockMutex(&threadMutex);
+    joinIOThread();
+    OSUnlockMutex(&threadMutex);
+
+    OSLockMutex(&queueMutex);
+    isStopping = false;
+    OSUnlockMutex(&queueMutex);
+
+    Update();
+}
+
+bool HasPendingAsync()
+{
+    if (!isAsyncInitialized) {
+        return false;
+    }
+
+    OSLockMutex(&queueMutex);
+    bool hasPending = outstandingCount > 0 || !finishedRequests.empty();
+    OSUnlockMutex(&queueMutex);
+    return hasPending;
+}
+
 bool Exists(const char* path)
 {
     if (!path) {
@@ -1,21 +1,120 @@
 // Low-level file I/O operations for SD card access
+//
+// Whole-file reads and ReadAt() into 0x40-aligned memory use a direct FS
+// client once Init() has run; everything else, and any path the client
+// can't open, goes through stdio.
 
 #pragma once
 
 #include <cstdint>
 #include <cstddef>
+#include <cstdio>
 
 namespace FileStorage {
 
+// Set up the direct FS client (falls back to stdio if it can't)
+void Init();
+
+// Finish asynchronous operations and release the FS client; reads go
+// through stdio afterwards
+void Shutdown();
+
 // Read entire file into buffer. Caller must free() the returned data.
 bool ReadFile(const char* path, uint8_t** outData, size_t* outSize);
 
+// Scratch buffer for reading many files one after another. Storage is
+// 0x40-aligned (what FS reads want) and only grows, so a run of reads
+// costs no heap allocation once it is large enough
+constexpr size_t READ_BUFFER_ALIGNMENT = 0x40;
+
+struct ReadBuffer {
+    uint8_t* data;
+    size_t capacity;
+
+    ReadBuffer() : data(nullptr), capacity(0) {}
+};
+
+// Read entire file into buffer, growing it if needed. The data stays
+// valid until the next read into the same buffer
+bool ReadFileInto(const char* path, ReadBuffer& buffer, size_t* outSize);
+
+// Free a buffer's storage (it can be read into again afterwards)
+void FreeReadBuffer(ReadBuffer& buffer);
+
 // Write buffer to file
 bool WriteFile(const char* path, const uint8_t* data, size_t size);
 
 // Copy file from srcPath to dstPath
 bool CopyFile(const char* srcPath, const char* dstPath);
 
+// Read exactly size bytes starting at offset (direct when buffer is
+// 0x40-aligned)
+bool ReadAt(const char* path, size_t offset, void* buffer, size_t size);
+
+// Write size bytes at offset, creating the file if needed; the rest of
+// an existing file is kept
+bool WriteAt(const char* path, size_t offset, const void* data, size_t size);
+
+// Sequential reader for files too large to read in one go
+struct FileReader {
+    FILE* file;
+
+    FileReader() : file(nullptr) {}
+};
+
+// Open a file for ReadChunk()
+bool OpenReader(const char* path, FileReader& reader);
+
+// Read up to size bytes. Returns the count read, 0 at end of file or on error
+size_t ReadChunk(FileReader& reader, void* buffer, size_t size);
+
+// Close a reader (safe to call on one that failed to open)
+void CloseReader(FileReader& reader);
+
+// Bytes read by the functions above since boot, from any thread
+uint64_t GetBytesRead();
+
+// =============================================================================
+// Asynchronous Operations
+// =============================================================================
+// Reads, writes and copies queued here run on one I/O thread, started on
+// demand and gone again once idle. The thread takes everything queued so
+// far as one batch and services it grouped by directory, in queue order
+// within a directory. Completions run from Update(), on the thread that
+// calls it. Before Init() an operation runs, callback included, at once.
+
+// Called with the outcome; for a read, data is the file's contents and
+// the callback must free() it. data is nullptr for writes, copies and
+// failed reads
+using AsyncCallback = void (*)(void* context, bool success, uint8_t* data, size_t size);
+
+// Longest path an asynchronous operation accepts
+constexpr size_t MAX_ASYNC_PATH = 256;
+
+// Queue a whole-file read. Returns false if the request couldn't be queued.
+// Without a callback the result is discarded
+bool ReadAsync(const char* path, AsyncCallback callback, void* context);
+
+// Queue a write. Takes ownership of data (malloc'd), freed once written,
+// whether or not the request could be queued
+bool WriteAsync(const char* path, uint8_t* data, size_t size, AsyncCallback callback = nullptr,
+                void* context = nullptr);
+
+// Queue a copy of srcPath to dstPath
+bool CopyAsync(const char* srcPath, const char* dstPath, AsyncCallback callback = nullptr,
+               void* context = nullptr);
+
+// Run the callbacks of finished operations. Returns how many ran
+int Update();
+
+// Block until everything queued so far has finished and the I/O thread
+// has exited, then run pending callbacks (call before the application
+// that owns the thread ends)
+void WaitForAsync();
+
+// Check if operations are queued, running, or waiting for Update()
+bool HasPendingAsync();
+
 // Check if file exists
 bool Exists(const char* path);
 
@@ -2,13 +2,14 @@
 
 #include "image_store.h"
 #include "file_storage.h"
+#include "../utils/trace.h"
 
-#include <map>
 #include <vector>
 #include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <malloc.h>
 
 #include <gd.h>
 #include <nn/acp/title.h>
@@ -20,166 +21,1277 @@ namespace {
 // SD card paths
 constexpr const char* CONFIG_DIR = "sd:/wiiu/environments/aroma/plugins/config/TitleSwitcher";
 constexpr const char* ICONS_DIR = "sd:/wiiu/environments/aroma/plugins/config/TitleSwitcher/icons";
+constexpr const char* ICON_PACK_PATH = "sd:/wiiu/environments/aroma/plugins/config/TitleSwitcher/icons.pack";
+constexpr const char* MISSING_ICONS_PATH = "sd:/wiiu/environments/aroma/plugins/config/TitleSwitcher/missing_icons.bin";
 
 // Source configuration
 bool sMemoryEnabled = true;
+bool sIconPackEnabled = true;
+bool sIconPackWriteEnabled = true;
 bool sSDCardEnabled = true;
 bool sNANDEnabled = true;
 bool sSDCardWriteEnabled = false;  // Disabled by default until we debug the issue
 
-// Memory cache
+// Side decoded icons are scaled to fit, 0 for source size
+int sIconSize = 0;
+Renderer::PixelFormat sPixelFormat = DEFAULT_PIXEL_FORMAT;
+
+// =============================================================================
+// Memory Cache
+// =============================================================================
+// A fixed pool of entries, sized at Init(), indexed by an open-addressed
+// hash table (linear probing, backward-shift deletion) and threaded on an
+// intrusive doubly linked LRU list. Hits, inserts and evictions are O(1)
+// and never allocate. Inserting evicts from the LRU end until the new
+// image fits the byte budget.
+
+constexpr int32_t NO_ENTRY = -1;
+
 struct CacheEntry {
+    uint64_t titleId;
     Renderer::ImageHandle handle;
+    uint32_t byteCount;
+
+    // LRU neighbours while cached; nextEntry also links the free list
+    int32_t previousEntry;
+    int32_t nextEntry;
 };
-std::map<uint64_t, CacheEntry> sMemoryCache;
-std::vector<uint64_t> sLRUOrder;  // Most recently used at end
-int sCacheCapacity = 50;
+
+std::vector<CacheEntry> sCacheEntries;
+
+// Entry index per slot, NO_ENTRY when empty; size is a power of two
+// at least twice the capacity, so probes stay short
+std::vector<int32_t> sCacheSlots;
+uint32_t sSlotMask = 0;
+
+// Least recently used at the head, most recently used at the tail
+int32_t sLRUHead = NO_ENTRY;
+int32_t sLRUTail = NO_ENTRY;
+int32_t sFreeEntries = NO_ENTRY;
+int sCacheCount = 0;
+
+size_t sCacheBytes = 0;
+size_t sMemoryBudget = DEFAULT_MEMORY_BUDGET;
 bool sInitialized = false;
 
-void touchLRU(uint64_t titleId)
-{
-    auto it = std::find(sLRUOrder.begin(), sLRUOrder.end(), titleId);
-    if (it != sLRUOrder.end()) {
-        sLRUOrder.erase(it);
+uint32_t homeSlot(uint64_t titleId)
+{
+    // Fibonacci hashing; title IDs differ mostly in their low bits
+    return static_cast<uint32_t>((titleId * 0x9E3779B97F4A7C15ull) >> 32) & sSlotMask;
+}
+
+// Slot holding the title, or the empty slot where it would go
+uint32_t findSlot(uint64_t titleId)
+{
+    uint32_t slot = homeSlot(titleId);
+    while (sCacheSlots[slot] != NO_ENTRY && sCacheEntries[sCacheSlots[slot]].titleId != titleId) {
+        slot = (slot + 1) & sSlotMask;
+    }
+    return slot;
+}
+
+int32_t findEntry(uint64_t titleId)
+{
+    if (sCacheSlots.empty()) {
+        return NO_ENTRY;
+    }
+    return sCacheSlots[findSlot(titleId)];
+}
+
+void removeSlot(uint32_t slot)
+{
+    // Pull later members of the probe run back so lookups never stop early
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1) & sSlotMask;
+    while (sCacheSlots[next] != NO_ENTRY) {
+        uint32_t home = homeSlot(sCacheEntries[sCacheSlots[next]].titleId);
+        if (((next - home) & sSlotMask) >= ((next - hole) & sSlotMask)) {
+            sCacheSlots[hole] = sCacheSlots[next];
+            hole = next;
+        }
+        next = (next + 1) & sSlotMask;
+    }
+    sCacheSlots[hole] = NO_ENTRY;
+}
+
+void unlinkLRU(int32_t entryIndex)
+{
+    CacheEntry& entry = sCacheEntries[entryIndex];
+    if (entry.previousEntry != NO_ENTRY) {
+        sCacheEntries[entry.previousEntry].nextEntry = entry.nextEntry;
+    } else {
+        sLRUHead = entry.nextEntry;
+    }
+    if (entry.nextEntry != NO_ENTRY) {
+        sCacheEntries[entry.nextEntry].previousEntry = entry.previousEntry;
+    } else {
+        sLRUTail = entry.previousEntry;
+    }
+}
+
+void appendLRU(int32_t entryIndex)
+{
+    CacheEntry& entry = sCacheEntries[entryIndex];
+    entry.previousEntry = sLRUTail;
+    entry.nextEntry = NO_ENTRY;
+    if (sLRUTail != NO_ENTRY) {
+        sCacheEntries[sLRUTail].nextEntry = entryIndex;
+    } else {
+        sLRUHead = entryIndex;
+    }
+    sLRUTail = entryIndex;
+}
+
+void touchLRU(int32_t entryIndex)
+{
+    if (entryIndex != sLRUTail) {
+        unlinkLRU(entryIndex);
+        appendLRU(entryIndex);
+    }
+}
+
+// Drop an entry from the table and the LRU list, and free its image
+void releaseEntry(int32_t entryIndex)
+{
+    CacheEntry& entry = sCacheEntries[entryIndex];
+    removeSlot(findSlot(entry.titleId));
+    unlinkLRU(entryIndex);
+
+    FreeImage(entry.handle);
+    entry.handle = Renderer::INVALID_IMAGE;
+    entry.nextEntry = sFreeEntries;
+    sFreeEntries = entryIndex;
+    sCacheCount--;
+    sCacheBytes -= entry.byteCount;
+}
+
+// Evict least recently used images until the budget has room for
+// incomingBytes more and a free entry exists
+void evictToFit(size_t incomingBytes)
+{
+    while (sLRUHead != NO_ENTRY &&
+           (sFreeEntries == NO_ENTRY || sCacheBytes + incomingBytes > sMemoryBudget)) {
+        releaseEntry(sLRUHead);
+    }
+}
+
+void resetCache()
+{
+    int slotCount = 1;
+    while (slotCount < MAX_CACHED_IMAGES * 2) {
+        slotCount <<= 1;
+    }
+
+    sCacheEntries.assign(MAX_CACHED_IMAGES, CacheEntry());
+    sCacheSlots.assign(slotCount, NO_ENTRY);
+    sSlotMask = static_cast<uint32_t>(slotCount - 1);
+
+    // Chain every entry onto the free list
+    for (int entryIndex = 0; entryIndex < MAX_CACHED_IMAGES; entryIndex++) {
+        sCacheEntries[entryIndex].handle = Renderer::INVALID_IMAGE;
+        sCacheEntries[entryIndex].nextEntry = entryIndex + 1 < MAX_CACHED_IMAGES ? entryIndex + 1 : NO_ENTRY;
+    }
+    sFreeEntries = 0;
+    sLRUHead = NO_ENTRY;
+    sLRUTail = NO_ENTRY;
+    sCacheCount = 0;
+    sCacheBytes = 0;
+}
+
+void freeCachedImages()
+{
+    for (int32_t entryIndex = sLRUHead; entryIndex != NO_ENTRY; entryIndex = sCacheEntries[entryIndex].nextEntry) {
+        FreeImage(sCacheEntries[entryIndex].handle);
+    }
+}
+
+// =============================================================================
+// Icon Pack
+// =============================================================================
+// Layout: IconPackHeader, then pixel data (RGBA, native byte order) for
+// each icon, then the index of IconPackEntry sorted by titleId, width and
+// height. A title has one entry for its source icon (the largest) and
+// one per scaled variant. A flush
+// writes new pixels over the old index, the new index after them, and
+// the header last; the index checksum catches a flush cut short, and a
+// bad pack is simply started over. Replaced and removed icons leave their
+// pixels behind; once those pass a quarter of the data, a flush first
+// slides the live pixels down over them.
+
+constexpr uint32_t ICON_PACK_MAGIC = 0x54534950;  // "TSIP"
+constexpr uint32_t ICON_PACK_VERSION = 1;
+constexpr int MAX_PACKED_ICONS = 4096;
+constexpr int MAX_PACKED_ICON_SIDE = 256;
+
+// Decoded icons held for the next flush (at 128x128, 64 KB each)
+constexpr int MAX_PENDING_PACK_ICONS = 16;
+
+struct IconPackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t indexOffset;
+    uint32_t indexChecksum;
+};
+
+struct IconPackEntry {
+    uint64_t titleId;
+    uint32_t offset;
+    uint16_t width;
+    uint16_t height;
+};
+
+std::vector<IconPackEntry> sPackIndex;
+
+// Where the next flush writes pixels (the current index offset)
+uint32_t sPackDataEnd = sizeof(IconPackHeader);
+
+// Entries were dropped since the index was last written
+bool hasUnsavedPackIndex = false;
+
+struct PendingPackIcon {
+    uint64_t titleId;
+    Renderer::ImageHandle image;
+};
+std::vector<PendingPackIcon> sPendingPackIcons;
+
+// FNV-1a
+uint32_t checksumBytes(const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t hash = 0x811C9DC5u;
+    for (size_t index = 0; index < size; index++) {
+        hash ^= bytes[index];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+void loadIconPackIndex()
+{
+    sPackIndex.clear();
+    sPackDataEnd = sizeof(IconPackHeader);
+    hasUnsavedPackIndex = false;
+
+    IconPackHeader header;
+    if (!FileStorage::ReadAt(ICON_PACK_PATH, 0, &header, sizeof(header)) ||
+        header.magic != ICON_PACK_MAGIC || header.version != ICON_PACK_VERSION ||
+        header.entryCount == 0 || header.entryCount > MAX_PACKED_ICONS ||
+        header.indexOffset < sizeof(IconPackHeader)) {
+        return;
+    }
+
+    std::vector<IconPackEntry> index(header.entryCount);
+    size_t indexSize = index.size() * sizeof(IconPackEntry);
+    if (!FileStorage::ReadAt(ICON_PACK_PATH, header.indexOffset, index.data(), indexSize) ||
+        checksumBytes(index.data(), indexSize) != header.indexChecksum) {
+        return;
+    }
+
+    sPackIndex.swap(index);
+    sPackDataEnd = header.indexOffset;
+}
+
+bool packEntryBefore(const IconPackEntry& first, const IconPackEntry& second)
+{
+    if (first.titleId != second.titleId) return first.titleId < second.titleId;
+    if (first.width != second.width) return first.width < second.width;
+    return first.height < second.height;
+}
+
+const IconPackEntry* findPackedIcon(uint64_t titleId, int width, int height)
+{
+    IconPackEntry key = {};
+    key.titleId = titleId;
+    key.width = static_cast<uint16_t>(width);
+    key.height = static_cast<uint16_t>(height);
+
+    auto position = std::lower_bound(sPackIndex.begin(), sPackIndex.end(), key, packEntryBefore);
+    if (position == sPackIndex.end() || position->titleId != titleId ||
+        position->width != key.width || position->height != key.height) {
+        return nullptr;
+    }
+    return &*position;
+}
+
+// The widest entry for a title is its source icon
+const IconPackEntry* findPackedSource(uint64_t titleId)
+{
+    auto position = std::upper_bound(sPackIndex.begin(), sPackIndex.end(), titleId,
+                                     [](uint64_t id, const IconPackEntry& entry) {
+                                         return id < entry.titleId;
+                                     });
+    if (position == sPackIndex.begin() || (position - 1)->titleId != titleId) {
+        return nullptr;
+    }
+    return &*(position - 1);
+}
+
+// Size an image takes when scaled down to fit iconSize, keeping its aspect
+void fitToIconSize(int width, int height, int iconSize, int& outWidth, int& outHeight)
+{
+    outWidth = width;
+    outHeight = height;
+    if (iconSize <= 0 || (width <= iconSize && height <= iconSize)) {
+        return;
+    }
+
+    if (width >= height) {
+        outWidth = iconSize;
+        outHeight = height * iconSize / width;
+    } else {
+        outHeight = iconSize;
+        outWidth = width * iconSize / height;
+    }
+    if (outWidth < 1) outWidth = 1;
+    if (outHeight < 1) outHeight = 1;
+}
+
+/**
+ * Box-filter an image down to width x height. Each destination pixel
+ * averages the block of source pixels it covers, so downscaled icons
+ * don't alias the way per-frame nearest-neighbour sampling does.
+ */
+Renderer::ImageHandle scaleImage(Renderer::ImageHandle source, int width, int height)
+{
+    uint32_t* pixels = static_cast<uint32_t*>(malloc(static_cast<size_t>(width) * height * sizeof(uint32_t)));
+    if (!pixels) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    int sourceWidth = source->width;
+    int sourceHeight = source->height;
+    for (int destY = 0; destY < height; destY++) {
+        int firstY = destY * sourceHeight / height;
+        int endY = (destY + 1) * sourceHeight / height;
+        if (endY <= firstY) endY = firstY + 1;
+
+        for (int destX = 0; destX < width; destX++) {
+            int firstX = destX * sourceWidth / width;
+            int endX = (destX + 1) * sourceWidth / width;
+            if (endX <= firstX) endX = firstX + 1;
+
+            uint32_t red = 0, green = 0, blue = 0, alpha = 0;
+            for (int sourceY = firstY; sourceY < endY; sourceY++) {
+                const uint32_t* row = source->pixels + sourceY * sourceWidth;
+                for (int sourceX = firstX; sourceX < endX; sourceX++) {
+                    uint32_t pixel = row[sourceX];
+                    red += pixel >> 24;
+                    green += (pixel >> 16) & 0xFF;
+                    blue += (pixel >> 8) & 0xFF;
+                    alpha += pixel & 0xFF;
+                }
+            }
+
+            uint32_t count = static_cast<uint32_t>((endX - firstX) * (endY - firstY));
+            uint32_t half = count / 2;
+            pixels[destY * width + destX] = (((red + half) / count) << 24) |
+                                            (((green + half) / count) << 16) |
+                                            (((blue + half) / count) << 8) |
+                                            ((alpha + half) / count);
+        }
+    }
+
+    Renderer::ImageData* imageData = new Renderer::ImageData();
+    imageData->pixels = pixels;
+    imageData->width = width;
+    imageData->height = height;
+    return imageData;
+}
+
+Renderer::ImageHandle readPackedIcon(const IconPackEntry& entry)
+{
+    // Aligned so the read goes straight from the card into the pixels
+    size_t pixelBytes = static_cast<size_t>(entry.width) * entry.height * sizeof(uint32_t);
+    uint32_t* pixels = static_cast<uint32_t*>(memalign(FileStorage::READ_BUFFER_ALIGNMENT, pixelBytes));
+    if (!pixels) {
+        return Renderer::INVALID_IMAGE;
+    }
+    if (!FileStorage::ReadAt(ICON_PACK_PATH, entry.offset, pixels, pixelBytes)) {
+        free(pixels);
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageData* imageData = new Renderer::ImageData();
+    imageData->pixels = pixels;
+    imageData->width = entry.width;
+    imageData->height = entry.height;
+    return imageData;
+}
+
+/**
+ * Keep a copy of a freshly decoded icon for the next flush.
+ */
+void queuePackIcon(uint64_t titleId, Renderer::ImageHandle handle)
+{
+    if (!sIconPackWriteEnabled || !handle ||
+        handle->width > MAX_PACKED_ICON_SIDE || handle->height > MAX_PACKED_ICON_SIDE ||
+        sPackIndex.size() + sPendingPackIcons.size() >= MAX_PACKED_ICONS) {
+        return;
+    }
+
+    size_t pixelBytes = static_cast<size_t>(handle->width) * handle->height * sizeof(uint32_t);
+    uint32_t* pixels = static_cast<uint32_t*>(malloc(pixelBytes));
+    if (!pixels) {
+        return;
+    }
+    memcpy(pixels, handle->pixels, pixelBytes);
+
+    Renderer::ImageData* copy = new Renderer::ImageData();
+    copy->pixels = pixels;
+    copy->width = handle->width;
+    copy->height = handle->height;
+    sPendingPackIcons.push_back({ titleId, copy });
+
+    if (static_cast<int>(sPendingPackIcons.size()) >= MAX_PENDING_PACK_ICONS) {
+        FlushPendingWrites();
+    }
+}
+
+/**
+ * Scale a decoded icon to fit iconSize, queueing the variant for the
+ * pack. Takes ownership of source; returns it when it already fits.
+ */
+Renderer::ImageHandle scaleForIconSize(uint64_t titleId, Renderer::ImageHandle source, int iconSize)
+{
+    int width, height;
+    fitToIconSize(source->width, source->height, iconSize, width, height);
+    if (width == source->width && height == source->height) {
+        return source;
+    }
+
+    Renderer::ImageHandle scaled = scaleImage(source, width, height);
+    FreeImage(source);
+    queuePackIcon(titleId, scaled);
+    return scaled;
+}
+
+void freePendingPackIcons()
+{
+    for (const PendingPackIcon& pending : sPendingPackIcons) {
+        FreeImage(pending.image);
+    }
+    sPendingPackIcons.clear();
+}
+
+/**
+ * Drop a title's index entries and queued icons. Its pixels stay in the
+ * file, unreferenced, until a flush compacts the pack.
+ */
+void forgetPackedIcons(uint64_t titleId)
+{
+    auto first = std::lower_bound(sPackIndex.begin(), sPackIndex.end(), titleId,
+                                  [](const IconPackEntry& entry, uint64_t id) {
+                                      return entry.titleId < id;
+                                  });
+    auto last = first;
+    while (last != sPackIndex.end() && last->titleId == titleId) {
+        ++last;
+    }
+    if (first != last) {
+        sPackIndex.erase(first, last);
+        if (sIconPackWriteEnabled) {
+            hasUnsavedPackIndex = true;
+        }
+    }
+
+    auto pending = sPendingPackIcons.begin();
+    while (pending != sPendingPackIcons.end()) {
+        if (pending->titleId == titleId) {
+            FreeImage(pending->image);
+            pending = sPendingPackIcons.erase(pending);
+        } else {
+            ++pending;
+        }
+    }
+}
+
+bool loadFromIconPack(uint64_t titleId, int iconSize, Renderer::ImageHandle& outHandle)
+{
+    const IconPackEntry* source = findPackedSource(titleId);
+    if (!source) {
+        return false;
+    }
+
+    int width, height;
+    fitToIconSize(source->width, source->height, iconSize, width, height);
+    const IconPackEntry* variant = findPackedIcon(titleId, width, height);
+    if (variant) {
+        outHandle = readPackedIcon(*variant);
+        return outHandle != Renderer::INVALID_IMAGE;
+    }
+
+    // First time at this size: scale the packed source and pack the result
+    Renderer::ImageHandle sourceImage = readPackedIcon(*source);
+    if (sourceImage == Renderer::INVALID_IMAGE) {
+        return false;
+    }
+    outHandle = scaleForIconSize(titleId, sourceImage, iconSize);
+    return outHandle != Renderer::INVALID_IMAGE;
+}
+
+// =============================================================================
+// Missing Icons
+// =============================================================================
+// Titles no source has an icon for, sorted, so later loads (and later
+// sessions) skip the pack, SD and NAND lookups. Saved next to the icon
+// pack by FlushPendingWrites(); same one-thread rule as the pack.
+
+constexpr uint32_t MISSING_ICONS_MAGIC = 0x54534D49;  // "TSMI"
+constexpr uint32_t MISSING_ICONS_VERSION = 1;
+constexpr int MAX_MISSING_ICONS = 4096;
+
+struct MissingIconsHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t checksum;
+};
+
+std::vector<uint64_t> sMissingIcons;
+bool hasUnsavedMissingIcons = false;
+
+bool isKnownMissing(uint64_t titleId)
+{
+    return std::binary_search(sMissingIcons.begin(), sMissingIcons.end(), titleId);
+}
+
+void markMissing(uint64_t titleId)
+{
+    if (static_cast<int>(sMissingIcons.size()) >= MAX_MISSING_ICONS) {
+        return;
+    }
+
+    auto position = std::lower_bound(sMissingIcons.begin(), sMissingIcons.end(), titleId);
+    if (position == sMissingIcons.end() || *position != titleId) {
+        sMissingIcons.insert(position, titleId);
+        hasUnsavedMissingIcons = true;
+    }
+}
+
+void forgetMissing(uint64_t titleId)
+{
+    auto position = std::lower_bound(sMissingIcons.begin(), sMissingIcons.end(), titleId);
+    if (position != sMissingIcons.end() && *position == titleId) {
+        sMissingIcons.erase(position);
+        hasUnsavedMissingIcons = true;
+    }
+}
+
+void loadMissingIcons()
+{
+    sMissingIcons.clear();
+    hasUnsavedMissingIcons = false;
+
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!FileStorage::ReadFile(MISSING_ICONS_PATH, &data, &size)) {
+        return;
+    }
+
+    MissingIconsHeader header;
+    bool isValid = size >= sizeof(header);
+    if (isValid) {
+        memcpy(&header, data, sizeof(header));
+        size_t idsSize = static_cast<size_t>(header.count) * sizeof(uint64_t);
+        isValid = header.magic == MISSING_ICONS_MAGIC && header.version == MISSING_ICONS_VERSION &&
+                  header.count <= MAX_MISSING_ICONS && size == sizeof(header) + idsSize &&
+                  checksumBytes(data + sizeof(header), idsSize) == header.checksum;
+    }
+    if (isValid) {
+        sMissingIcons.resize(header.count);
+        memcpy(sMissingIcons.data(), data + sizeof(header), sMissingIcons.size() * sizeof(uint64_t));
+        std::sort(sMissingIcons.begin(), sMissingIcons.end());
+    }
+    free(data);
+}
+
+void saveMissingIcons()
+{
+    if (!hasUnsavedMissingIcons || !sIconPackWriteEnabled) {
+        return;
+    }
+
+    size_t idsSize = sMissingIcons.size() * sizeof(uint64_t);
+    MissingIconsHeader header;
+    header.magic = MISSING_ICONS_MAGIC;
+    header.version = MISSING_ICONS_VERSION;
+    header.count = static_cast<uint32_t>(sMissingIcons.size());
+    header.checksum = checksumBytes(sMissingIcons.data(), idsSize);
+
+    std::vector<uint8_t> block(sizeof(header) + idsSize);
+    memcpy(block.data(), &header, sizeof(header));
+    memcpy(block.data() + sizeof(header), sMissingIcons.data(), idsSize);
+    if (FileStorage::WriteFile(MISSING_ICONS_PATH, block.data(), block.size())) {
+        hasUnsavedMissingIcons = false;
+    }
+}
+
+// =============================================================================
+// SD Write-Back
+// =============================================================================
+// Icons that came from NAND are copied to the SD icon folder from the
+// bytes already read for decoding, a batch at a time when loading goes
+// idle, instead of re-reading NAND and writing while an image is due.
+
+// Raw iconTex.tga files are about 64 KB each
+constexpr int MAX_PENDING_WRITE_BACKS = 8;
+
+struct PendingWriteBack {
+    uint64_t titleId;
+    uint8_t* data;
+    size_t size;
+};
+std::vector<PendingWriteBack> sPendingWriteBacks;
+
+void flushWriteBacks()
+{
+    if (sPendingWriteBacks.empty()) {
+        return;
+    }
+
+    // Fails harmlessly when the folder exists
+    FileStorage::CreateDir(ICONS_DIR);
+
+    // The I/O thread writes them (and frees the data) while loads go on
+    for (const PendingWriteBack& pending : sPendingWriteBacks) {
+        char path[160];
+        GetIconPath(pending.titleId, path, sizeof(path));
+        FileStorage::WriteAsync(path, pending.data, pending.size);
+    }
+    sPendingWriteBacks.clear();
+}
+
+// Copies data, which is usually the reused icon read buffer
+void queueWriteBack(uint64_t titleId, const uint8_t* data, size_t size)
+{
+    if (!sSDCardWriteEnabled) {
+        return;
+    }
+
+    uint8_t* copy = static_cast<uint8_t*>(malloc(size));
+    if (!copy) {
+        return;
+    }
+    memcpy(copy, data, size);
+
+    sPendingWriteBacks.push_back({ titleId, copy, size });
+    if (static_cast<int>(sPendingWriteBacks.size()) >= MAX_PENDING_WRITE_BACKS) {
+        flushWriteBacks();
+    }
+}
+
+void freePendingWriteBacks()
+{
+    for (const PendingWriteBack& pending : sPendingWriteBacks) {
+        free(pending.data);
+    }
+    sPendingWriteBacks.clear();
+}
+
+// =============================================================================
+// Decoding
+// =============================================================================
+// Title icons (NAND iconTex.tga) are uncompressed 32-bpp TGA, so TGA is
+// decoded here straight into the RGBA buffer. Everything else goes
+// through libgd, converted a row at a time from its pixel arrays rather
+// than through per-pixel accessor calls.
+
+constexpr size_t TGA_HEADER_SIZE = 18;
+constexpr uint8_t TGA_TYPE_TRUECOLOR = 2;
+constexpr uint8_t TGA_TYPE_TRUECOLOR_RLE = 10;
+constexpr uint8_t TGA_DESCRIPTOR_RIGHT_TO_LEFT = 0x10;
+constexpr uint8_t TGA_DESCRIPTOR_TOP_TO_BOTTOM = 0x20;
+// Larger TGA headers are treated as corrupt
+constexpr int MAX_DECODED_SIDE = 1024;
+
+Renderer::ImageHandle newImage(int width, int height)
+{
+    uint32_t* pixels = static_cast<uint32_t*>(malloc(static_cast<size_t>(width) * height * sizeof(uint32_t)));
+    if (!pixels) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageData* imageData = new Renderer::ImageData();
+    imageData->pixels = pixels;
+    imageData->width = width;
+    imageData->height = height;
+    return imageData;
+}
+
+// BGR(A) little-endian TGA pixel to RGBA
+inline uint32_t tgaPixel(const uint8_t* bytes, int bytesPerPixel)
+{
+    uint8_t alpha = bytesPerPixel == 4 ? bytes[3] : 255;
+    return (static_cast<uint32_t>(bytes[2]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[0]) << 8) | alpha;
+}
+
+/**
+ * Decode 24/32-bpp truecolor TGA, raw or RLE. Returns INVALID_IMAGE for
+ * anything else (colour-mapped, greyscale, mirrored, truncated), which
+ * parseImage() then hands to libgd, or with outError set to
+ * OUT_OF_MEMORY if the pixels couldn't be allocated.
+ */
+Renderer::ImageHandle decodeTGA(const uint8_t* data, size_t size, LoadError& outError)
+{
+    if (size < TGA_HEADER_SIZE) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    uint8_t idLength = data[0];
+    uint8_t colorMapType = data[1];
+    uint8_t imageType = data[2];
+    int width = data[12] | (data[13] << 8);
+    int height = data[14] | (data[15] << 8);
+    int bytesPerPixel = data[16] / 8;
+    uint8_t descriptor = data[17];
+
+    if (colorMapType != 0 ||
+        (imageType != TGA_TYPE_TRUECOLOR && imageType != TGA_TYPE_TRUECOLOR_RLE) ||
+        (data[16] != 24 && data[16] != 32) || (descriptor & TGA_DESCRIPTOR_RIGHT_TO_LEFT) ||
+        width <= 0 || height <= 0 || width > MAX_DECODED_SIDE || height > MAX_DECODED_SIDE) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    const uint8_t* source = data + TGA_HEADER_SIZE + idLength;
+    const uint8_t* sourceEnd = data + size;
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    if (source > sourceEnd ||
+        (imageType == TGA_TYPE_TRUECOLOR && static_cast<size_t>(sourceEnd - source) < pixelCount * bytesPerPixel)) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageHandle image = newImage(width, height);
+    if (!image) {
+        outError = LoadError::OUT_OF_MEMORY;
+        return Renderer::INVALID_IMAGE;
+    }
+
+    // Rows are stored bottom-up unless the descriptor says otherwise
+    bool isTopDown = (descriptor & TGA_DESCRIPTOR_TOP_TO_BOTTOM) != 0;
+    uint32_t* pixels = image->pixels;
+
+    if (imageType == TGA_TYPE_TRUECOLOR) {
+        for (int row = 0; row < height; row++) {
+            uint32_t* destRow = pixels + static_cast<size_t>(isTopDown ? row : height - 1 - row) * width;
+            for (int x = 0; x < width; x++, source += bytesPerPixel) {
+                destRow[x] = tgaPixel(source, bytesPerPixel);
+            }
+        }
+        return image;
+    }
+
+    // RLE packets may run across row ends
+    int row = 0;
+    int x = 0;
+    uint32_t* destRow = pixels + static_cast<size_t>(isTopDown ? 0 : height - 1) * width;
+    for (size_t decoded = 0; decoded < pixelCount;) {
+        if (source >= sourceEnd) {
+            FreeImage(image);
+            return Renderer::INVALID_IMAGE;
+        }
+
+        uint8_t packet = *source++;
+        int runLength = (packet & 0x7F) + 1;
+        bool isRun = (packet & 0x80) != 0;
+        size_t packetBytes = static_cast<size_t>(isRun ? 1 : runLength) * bytesPerPixel;
+        if (static_cast<size_t>(sourceEnd - source) < packetBytes ||
+            decoded + runLength > pixelCount) {
+            FreeImage(image);
+            return Renderer::INVALID_IMAGE;
+        }
+
+        uint32_t runPixel = isRun ? tgaPixel(source, bytesPerPixel) : 0;
+        for (int index = 0; index < runLength; index++) {
+            destRow[x] = isRun ? runPixel : tgaPixel(source + index * bytesPerPixel, bytesPerPixel);
+            if (++x == width) {
+                x = 0;
+                row++;
+                destRow = pixels + static_cast<size_t>(isTopDown ? row : height - 1 - row) * width;
+            }
+        }
+        source += packetBytes;
+        decoded += runLength;
+    }
+    return image;
+}
+
+// libgd alpha is 0 (opaque) to 127 (transparent)
+inline uint8_t alphaFromGd(int gdAlpha)
+{
+    return static_cast<uint8_t>(255 - gdAlpha * 2);
+}
+
+Renderer::ImageHandle convertGdImage(gdImagePtr gdImg, LoadError& outError)
+{
+    int width = gdImageSX(gdImg);
+    int height = gdImageSY(gdImg);
+    Renderer::ImageHandle image = newImage(width, height);
+    if (!image) {
+        outError = LoadError::OUT_OF_MEMORY;
+        return Renderer::INVALID_IMAGE;
+    }
+
+    if (gdImageTrueColor(gdImg)) {
+        // tpixels rows hold gd's packed ARGB (7-bit inverted alpha)
+        for (int y = 0; y < height; y++) {
+            const int* sourceRow = gdImg->tpixels[y];
+            uint32_t* destRow = image->pixels + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                uint32_t pixel = static_cast<uint32_t>(sourceRow[x]);
+                destRow[x] = ((pixel & 0x00FFFFFFu) << 8) | alphaFromGd((pixel >> 24) & 0x7F);
+            }
+        }
+        return image;
+    }
+
+    // Palette image: convert the palette once, then index it per pixel
+    uint32_t palette[gdMaxColors];
+    for (int color = 0; color < gdMaxColors; color++) {
+        palette[color] = (static_cast<uint32_t>(gdImg->red[color] & 0xFF) << 24) |
+                         (static_cast<uint32_t>(gdImg->green[color] & 0xFF) << 16) |
+                         (static_cast<uint32_t>(gdImg->blue[color] & 0xFF) << 8) |
+                         alphaFromGd(gdImg->alpha[color] & 0x7F);
+    }
+    for (int y = 0; y < height; y++) {
+        const unsigned char* sourceRow = gdImg->pixels[y];
+        uint32_t* destRow = image->pixels + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; x++) {
+            destRow[x] = palette[sourceRow[x]];
+        }
+    }
+    return image;
+}
+
+// Parse image data into RGBA pixels, setting outError on failure
+Renderer::ImageHandle parseImage(const uint8_t* data, size_t size, LoadError& outError)
+{
+    outError = LoadError::DECODE_FAILED;
+    if (!data || size < 8) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    // Detect format; TGA has no magic, so it is whatever isn't PNG/JPEG/BMP
+    gdImagePtr gdImg = nullptr;
+    if (data[0] == 0x89 && data[1] == 'P' && data[2] == 'N' && data[3] == 'G') {
+        gdImg = gdImageCreateFromPngPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+    } else if (data[0] == 0xFF && data[1] == 0xD8) {
+        gdImg = gdImageCreateFromJpegPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+    } else if (data[0] == 'B' && data[1] == 'M') {
+        gdImg = gdImageCreateFromBmpPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+    } else {
+        Renderer::ImageHandle image = decodeTGA(data, size, outError);
+        if (image || outError == LoadError::OUT_OF_MEMORY) {
+            if (image) outError = LoadError::NONE;
+            return image;
+        }
+        gdImg = gdImageCreateFromTgaPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+    }
+
+    if (!gdImg) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageHandle image = convertGdImage(gdImg, outError);
+    gdImageDestroy(gdImg);
+    if (image) {
+        outError = LoadError::NONE;
+    }
+    return image;
+}
+
+// Icon files are read into one reused buffer; only the thread that
+// calls LoadFromStorage() touches it
+FileStorage::ReadBuffer sIconReadBuffer;
+
+// Read and decode one icon file. With outData, a decoded file's bytes are
+// handed to the caller; they stay valid until the next icon file is read
+LoadError loadIconFile(const char* path, Renderer::ImageHandle& outHandle,
+                       const uint8_t** outData = nullptr, size_t* outSize = nullptr)
+{
+    outHandle = Renderer::INVALID_IMAGE;
+
+    size_t size = 0;
+    TRACE_BEGIN("Icon read");
+    bool isRead = FileStorage::ReadFileInto(path, sIconReadBuffer, &size);
+    TRACE_END("Icon read");
+    if (!isRead) {
+        // ReadFileInto can't tell a missing file from a failed read
+        return FileStorage::Exists(path) ? LoadError::READ_FAILED : LoadError::NOT_FOUND;
+    }
+
+    LoadError error = LoadError::NONE;
+    TRACE_BEGIN("Icon decode");
+    outHandle = parseImage(sIconReadBuffer.data, size, error);
+    TRACE_END("Icon decode");
+    if (outHandle && outData) {
+        *outData = sIconReadBuffer.data;
+        *outSize = size;
+    }
+    return error;
+}
+
+// Icon pack, then SD card, then NAND; the result is RGBA8888
+Renderer::ImageHandle loadScaledIcon(uint64_t titleId, int iconSize, LoadError& outError)
+{
+    outError = LoadError::NOT_FOUND;
+    if (isKnownMissing(titleId)) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageHandle handle = Renderer::INVALID_IMAGE;
+    if (sIconPackEnabled && loadFromIconPack(titleId, iconSize, handle)) {
+        outError = LoadError::NONE;
+        return handle;
+    }
+
+    // A source that has the icon but fails to give it up explains the
+    // failure better than one that doesn't have it
+    if (sSDCardEnabled) {
+        char path[160];
+        GetIconPath(titleId, path, sizeof(path));
+        LoadError error = loadIconFile(path, handle);
+        if (handle) {
+            // Pack the source before scaling, so other sizes can come from it
+            queuePackIcon(titleId, handle);
+            handle = scaleForIconSize(titleId, handle, iconSize);
+            outError = handle ? LoadError::NONE : LoadError::OUT_OF_MEMORY;
+            return handle;
+        }
+        if (error != LoadError::NOT_FOUND) {
+            outError = error;
+        }
     }
-    sLRUOrder.push_back(titleId);
-}
 
-void freeImage(Renderer::ImageHandle handle)
-{
-    if (handle) {
-        if (handle->pixels) {
-            free(handle->pixels);
+    if (sNANDEnabled) {
+        char metaPath[256];
+        if (ACPGetTitleMetaDir(titleId, metaPath, sizeof(metaPath)) == ACP_RESULT_SUCCESS) {
+            char nandPath[280];
+            snprintf(nandPath, sizeof(nandPath), "%s/iconTex.tga", metaPath);
+            const uint8_t* fileData = nullptr;
+            size_t fileSize = 0;
+            LoadError error = loadIconFile(nandPath, handle, &fileData, &fileSize);
+            if (handle) {
+                // Copy to SD card for future loads
+                queueWriteBack(titleId, fileData, fileSize);
+                queuePackIcon(titleId, handle);
+                handle = scaleForIconSize(titleId, handle, iconSize);
+                outError = handle ? LoadError::NONE : LoadError::OUT_OF_MEMORY;
+                return handle;
+            }
+            if (error != LoadError::NOT_FOUND) {
+                outError = error;
+            }
         }
-        delete handle;
     }
+
+    // Only a lookup that covered every source proves there is no icon
+    if (outError == LoadError::NOT_FOUND && sSDCardEnabled && sNANDEnabled) {
+        markMissing(titleId);
+    }
+    return Renderer::INVALID_IMAGE;
 }
 
-void evictIfNeeded()
+// =============================================================================
+// Pixel Formats
+// =============================================================================
+// Decoding, scaling and the icon pack all work in RGBA8888; an image is
+// converted to the stored format as the last step of a load.
+
+inline uint32_t scaleChannel(uint32_t value, uint32_t maxValue)
 {
-    while (static_cast<int>(sLRUOrder.size()) > sCacheCapacity && !sLRUOrder.empty()) {
-        uint64_t oldest = sLRUOrder.front();
-        sLRUOrder.erase(sLRUOrder.begin());
+    return (value * maxValue + 127) / 255;
+}
 
-        auto it = sMemoryCache.find(oldest);
-        if (it != sMemoryCache.end()) {
-            freeImage(it->second.handle);
-            sMemoryCache.erase(it);
-        }
-    }
+inline uint16_t toRGB565(uint32_t pixel)
+{
+    return static_cast<uint16_t>((scaleChannel(pixel >> 24, 31) << 11) |
+                                 (scaleChannel((pixel >> 16) & 0xFF, 63) << 5) |
+                                 scaleChannel((pixel >> 8) & 0xFF, 31));
 }
 
-// Parse image data into RGBA pixels
-Renderer::ImageHandle parseImage(const uint8_t* data, size_t size)
+inline uint16_t toRGBA4444(uint32_t pixel)
 {
-    if (!data || size < 8) {
+    return static_cast<uint16_t>((scaleChannel(pixel >> 24, 15) << 12) |
+                                 (scaleChannel((pixel >> 16) & 0xFF, 15) << 8) |
+                                 (scaleChannel((pixel >> 8) & 0xFF, 15) << 4) |
+                                 scaleChannel(pixel & 0xFF, 15));
+}
+
+/**
+ * Convert an RGBA8888 image to format in place. On allocation failure
+ * the image is freed and INVALID_IMAGE returned.
+ */
+Renderer::ImageHandle convertImage(Renderer::ImageHandle image, Renderer::PixelFormat format)
+{
+    if (!image || format == image->format) {
+        return image;
+    }
+
+    size_t pixelCount = static_cast<size_t>(image->width) * image->height;
+    uint16_t* compact = static_cast<uint16_t*>(malloc(pixelCount * sizeof(uint16_t)));
+    if (!compact) {
+        FreeImage(image);
         return Renderer::INVALID_IMAGE;
     }
 
-    // Detect format and load with libgd
-    gdImagePtr gdImg = nullptr;
-    if (data[0] == 0x89 && data[1] == 'P' && data[2] == 'N' && data[3] == 'G') {
-        gdImg = gdImageCreateFromPngPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
-    } else if (data[0] == 0xFF && data[1] == 0xD8) {
-        gdImg = gdImageCreateFromJpegPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
-    } else if (data[0] == 'B' && data[1] == 'M') {
-        gdImg = gdImageCreateFromBmpPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+    const uint32_t* source = image->pixels;
+    if (format == Renderer::PixelFormat::RGB565) {
+        for (size_t index = 0; index < pixelCount; index++) {
+            compact[index] = toRGB565(source[index]);
+        }
     } else {
-        gdImg = gdImageCreateFromTgaPtr(static_cast<int>(size), const_cast<uint8_t*>(data));
+        for (size_t index = 0; index < pixelCount; index++) {
+            compact[index] = toRGBA4444(source[index]);
+        }
     }
 
-    if (!gdImg) {
-        return Renderer::INVALID_IMAGE;
-    }
+    free(image->pixels);
+    image->pixels16 = compact;
+    image->format = format;
+    return image;
+}
 
-    int width = gdImageSX(gdImg);
-    int height = gdImageSY(gdImg);
+// =============================================================================
+// Warm Tier
+// =============================================================================
+// While the menu is closed the memory cache shrinks to the icons drawn
+// last; the next few are kept here compressed, newest first, so reopening
+// costs an unpack rather than an SD read and decode. The oldest are
+// dropped when the budget is full; the icon pack is the cold tier behind.
+//
+// Encoding works on whole pixels in the image's own format. Each tag byte
+// holds an op in its top two bits and a count or index in the rest: a run
+// of the previous pixel, a hit in a table of recently seen pixels, or
+// literal pixels that follow the tag.
 
-    uint32_t* pixels = static_cast<uint32_t*>(malloc(width * height * sizeof(uint32_t)));
-    if (!pixels) {
-        gdImageDestroy(gdImg);
-        return Renderer::INVALID_IMAGE;
+constexpr uint8_t WARM_OP_RUN = 0x00;
+constexpr uint8_t WARM_OP_INDEX = 0x40;
+constexpr uint8_t WARM_OP_LITERAL = 0xC0;
+constexpr uint8_t WARM_OP_MASK = 0xC0;
+constexpr uint8_t WARM_ARG_MASK = 0x3F;
+constexpr int WARM_MAX_COUNT = 64;
+constexpr int WARM_TABLE_SIZE = 64;
+
+struct WarmIcon {
+    uint64_t titleId;
+    uint16_t width;
+    uint16_t height;
+    Renderer::PixelFormat format;
+    uint8_t* data;
+    uint32_t size;
+};
+
+std::vector<WarmIcon> sWarmIcons;
+size_t sWarmBytes = 0;
+
+// Reused encode buffer, sized for the worst case of one tag per pixel
+std::vector<uint8_t> sWarmScratch;
+
+inline uint32_t warmHash(uint32_t pixel)
+{
+    return (pixel * 2654435761u) >> 26;
+}
+
+inline uint32_t readPixel(Renderer::ImageHandle image, size_t index)
+{
+    return image->format == Renderer::PixelFormat::RGBA8888 ? image->pixels[index] : image->pixels16[index];
+}
+
+inline void writePixel(Renderer::ImageHandle image, size_t index, uint32_t pixel)
+{
+    if (image->format == Renderer::PixelFormat::RGBA8888) {
+        image->pixels[index] = pixel;
+    } else {
+        image->pixels16[index] = static_cast<uint16_t>(pixel);
     }
+}
 
-    // Convert to RGBA
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int pixel = gdImageGetPixel(gdImg, x, y);
-            uint8_t r = gdImageRed(gdImg, pixel);
-            uint8_t g = gdImageGreen(gdImg, pixel);
-            uint8_t b = gdImageBlue(gdImg, pixel);
-            uint8_t a = 255 - (gdImageAlpha(gdImg, pixel) * 2);
-            pixels[y * width + x] = (r << 24) | (g << 16) | (b << 8) | a;
+/**
+ * Compress an image into a new malloc'd block. Returns nullptr if the
+ * block couldn't be allocated.
+ */
+uint8_t* encodeWarmIcon(Renderer::ImageHandle image, uint32_t& outSize)
+{
+    size_t pixelCount = static_cast<size_t>(image->width) * image->height;
+    size_t bytesPerPixel = Renderer::GetBytesPerPixel(image->format);
+    sWarmScratch.resize(pixelCount * (bytesPerPixel + 1));
+
+    uint8_t* out = sWarmScratch.data();
+    uint32_t table[WARM_TABLE_SIZE] = {};
+    uint32_t previous = 0;
+    size_t index = 0;
+    while (index < pixelCount) {
+        uint32_t pixel = readPixel(image, index);
+        if (pixel == previous) {
+            int run = 1;
+            while (run < WARM_MAX_COUNT && index + run < pixelCount &&
+                   readPixel(image, index + run) == previous) {
+                run++;
+            }
+            *out++ = static_cast<uint8_t>(WARM_OP_RUN | (run - 1));
+            index += run;
+            continue;
         }
-    }
 
-    gdImageDestroy(gdImg);
+        uint32_t slot = warmHash(pixel);
+        if (table[slot] == pixel) {
+            *out++ = static_cast<uint8_t>(WARM_OP_INDEX | slot);
+            previous = pixel;
+            index++;
+            continue;
+        }
 
-    Renderer::ImageData* imageData = new Renderer::ImageData();
-    imageData->pixels = pixels;
-    imageData->width = width;
-    imageData->height = height;
+        // Literals until a pixel the other ops would cover
+        uint8_t* tag = out++;
+        int count = 0;
+        do {
+            table[slot] = pixel;
+            memcpy(out, &pixel, bytesPerPixel);
+            out += bytesPerPixel;
+            previous = pixel;
+            index++;
+            count++;
+            if (index == pixelCount) break;
+            pixel = readPixel(image, index);
+            slot = warmHash(pixel);
+        } while (count < WARM_MAX_COUNT && pixel != previous && table[slot] != pixel);
+        *tag = static_cast<uint8_t>(WARM_OP_LITERAL | (count - 1));
+    }
 
-    return imageData;
+    outSize = static_cast<uint32_t>(out - sWarmScratch.data());
+    uint8_t* data = static_cast<uint8_t*>(malloc(outSize));
+    if (data) {
+        memcpy(data, sWarmScratch.data(), outSize);
+    }
+    return data;
 }
 
-// Try loading from SD card
-bool loadFromSDCard(uint64_t titleId, Renderer::ImageHandle& outHandle)
+Renderer::ImageHandle decodeWarmIcon(const WarmIcon& icon)
 {
-    char path[160];
-    GetIconPath(titleId, path, sizeof(path));
+    size_t pixelCount = static_cast<size_t>(icon.width) * icon.height;
+    size_t bytesPerPixel = Renderer::GetBytesPerPixel(icon.format);
+    void* pixels = malloc(pixelCount * bytesPerPixel);
+    if (!pixels) {
+        return Renderer::INVALID_IMAGE;
+    }
 
-    uint8_t* data = nullptr;
-    size_t size = 0;
-    if (!FileStorage::ReadFile(path, &data, &size)) {
-        return false;
+    Renderer::ImageData* image = new Renderer::ImageData();
+    image->pixels = static_cast<uint32_t*>(pixels);
+    image->width = icon.width;
+    image->height = icon.height;
+    image->format = icon.format;
+
+    const uint8_t* in = icon.data;
+    const uint8_t* end = icon.data + icon.size;
+    uint32_t table[WARM_TABLE_SIZE] = {};
+    uint32_t previous = 0;
+    size_t index = 0;
+    while (in < end && index < pixelCount) {
+        uint8_t tag = *in++;
+        size_t count = static_cast<size_t>(tag & WARM_ARG_MASK) + 1;
+        switch (tag & WARM_OP_MASK) {
+            case WARM_OP_RUN:
+                for (; count > 0 && index < pixelCount; count--) {
+                    writePixel(image, index++, previous);
+                }
+                break;
+            case WARM_OP_INDEX:
+                previous = table[tag & WARM_ARG_MASK];
+                writePixel(image, index++, previous);
+                break;
+            default:
+                for (; count > 0 && index < pixelCount && in + bytesPerPixel <= end; count--) {
+                    uint32_t pixel = 0;
+                    memcpy(&pixel, in, bytesPerPixel);
+                    in += bytesPerPixel;
+                    table[warmHash(pixel)] = pixel;
+                    previous = pixel;
+                    writePixel(image, index++, pixel);
+                }
+                break;
+        }
     }
+    return image;
+}
 
-    outHandle = parseImage(data, size);
-    free(data);
+int findWarmIcon(uint64_t titleId)
+{
+    for (size_t warmIndex = 0; warmIndex < sWarmIcons.size(); warmIndex++) {
+        if (sWarmIcons[warmIndex].titleId == titleId) {
+            return static_cast<int>(warmIndex);
+        }
+    }
+    return -1;
+}
 
-    return outHandle != Renderer::INVALID_IMAGE;
+void eraseWarmIcon(int warmIndex)
+{
+    sWarmBytes -= sWarmIcons[warmIndex].size;
+    free(sWarmIcons[warmIndex].data);
+    sWarmIcons.erase(sWarmIcons.begin() + warmIndex);
 }
 
-// Try loading from NAND (title meta directory)
-bool loadFromNAND(uint64_t titleId, Renderer::ImageHandle& outHandle, char* outNANDPath, size_t maxPathLen)
+void removeWarmIcon(uint64_t titleId)
 {
-    char metaPath[256];
-    if (ACPGetTitleMetaDir(titleId, metaPath, sizeof(metaPath)) != ACP_RESULT_SUCCESS) {
-        return false;
+    int warmIndex = findWarmIcon(titleId);
+    if (warmIndex >= 0) {
+        eraseWarmIcon(warmIndex);
     }
+}
 
-    char iconPath[280];
-    snprintf(iconPath, sizeof(iconPath), "%s/iconTex.tga", metaPath);
+/**
+ * Compress an image into the warm tier at position insertAt, dropping
+ * older icons past it to make room. Returns false if it doesn't fit even
+ * then; the image itself is left to the caller.
+ */
+bool insertWarmIcon(uint64_t titleId, Renderer::ImageHandle image, size_t insertAt)
+{
+    removeWarmIcon(titleId);
 
-    uint8_t* data = nullptr;
-    size_t size = 0;
-    if (!FileStorage::ReadFile(iconPath, &data, &size)) {
+    uint32_t size = 0;
+    uint8_t* data = encodeWarmIcon(image, size);
+    if (!data) {
         return false;
     }
 
-    outHandle = parseImage(data, size);
-    free(data);
-
-    if (outHandle != Renderer::INVALID_IMAGE && outNANDPath) {
-        strncpy(outNANDPath, iconPath, maxPathLen - 1);
-        outNANDPath[maxPathLen - 1] = '\0';
+    while (sWarmBytes + size > WARM_CACHE_BUDGET && sWarmIcons.size() > insertAt) {
+        eraseWarmIcon(static_cast<int>(sWarmIcons.size()) - 1);
+    }
+    if (sWarmBytes + size > WARM_CACHE_BUDGET) {
+        free(data);
+        return false;
     }
 
-    return outHandle != Renderer::INVALID_IMAGE;
+    WarmIcon icon = { titleId, static_cast<uint16_t>(image->width), static_cast<uint16_t>(image->height),
+                      image->format, data, size };
+    sWarmIcons.insert(sWarmIcons.begin() + insertAt, icon);
+    sWarmBytes += size;
+    return true;
+}
+
+void freeWarmIcons()
+{
+    for (const WarmIcon& icon : sWarmIcons) {
+        free(icon.data);
+    }
+    sWarmIcons.clear();
+    sWarmBytes = 0;
 }
 
 } // anonymous namespace
 
-void Init(int memoryCacheSize)
+void Init(size_t memoryBudgetBytes)
 {
     if (sInitialized) {
         return;
     }
 
-    sCacheCapacity = memoryCacheSize > 0 ? memoryCacheSize : 50;
-    sMemoryCache.clear();
-    sLRUOrder.clear();
+    sMemoryBudget = memoryBudgetBytes > 0 ? memoryBudgetBytes : DEFAULT_MEMORY_BUDGET;
+    resetCache();
+    loadIconPackIndex();
+    loadMissingIcons();
     sInitialized = true;
 }
 
@@ -189,20 +1301,29 @@ void Shutdown()
         return;
     }
 
-    for (auto& pair : sMemoryCache) {
-        freeImage(pair.second.handle);
-    }
-    sMemoryCache.clear();
-    sLRUOrder.clear();
+    FlushPendingWrites();
+    freePendingPackIcons();
+    freePendingWriteBacks();
+    FileStorage::FreeReadBuffer(sIconReadBuffer);
+    sPackIndex.clear();
+    sMissingIcons.clear();
+
+    freeCachedImages();
+    freeWarmIcons();
+    sCacheEntries.clear();
+    sCacheSlots.clear();
+    sCacheCount = 0;
+    sCacheBytes = 0;
     sInitialized = false;
 }
 
 void SetSourceEnabled(Source src, bool enabled)
 {
     switch (src) {
-        case Source::MEMORY:   sMemoryEnabled = enabled; break;
-        case Source::SD_CARD:  sSDCardEnabled = enabled; break;
-        case Source::NAND:     sNANDEnabled = enabled; break;
+        case Source::MEMORY:    sMemoryEnabled = enabled; break;
+        case Source::ICON_PACK: sIconPackEnabled = enabled; break;
+        case Source::SD_CARD:   sSDCardEnabled = enabled; break;
+        case Source::NAND:      sNANDEnabled = enabled; break;
     }
 }
 
@@ -210,16 +1331,19 @@ void SetWriteEnabled(Source src, bool enabled)
 {
     if (src == Source::SD_CARD) {
         sSDCardWriteEnabled = enabled;
+    } else if (src == Source::ICON_PACK) {
+        sIconPackWriteEnabled = enabled;
     }
 }
 
 bool IsSourceEnabled(Source src)
 {
     switch (src) {
-        case Source::MEMORY:   return sMemoryEnabled;
-        case Source::SD_CARD:  return sSDCardEnabled;
-        case Source::NAND:     return sNANDEnabled;
-        default:               return false;
+        case Source::MEMORY:    return sMemoryEnabled;
+        case Source::ICON_PACK: return sIconPackEnabled;
+        case Source::SD_CARD:   return sSDCardEnabled;
+        case Source::NAND:      return sNANDEnabled;
+        default:                return false;
     }
 }
 
@@ -228,12 +1352,18 @@ bool IsWriteEnabled(Source src)
     if (src == Source::SD_CARD) {
         return sSDCardWriteEnabled;
     }
+    if (src == Source::ICON_PACK) {
+        return sIconPackWriteEnabled;
+    }
     return false;
 }
 
-bool Load(uint64_t titleId, Renderer::ImageHandle& outHandle)
+bool Load(uint64_t titleId, Renderer::ImageHandle& outHandle, LoadError* outError)
 {
     outHandle = Renderer::INVALID_IMAGE;
+    if (outError) {
+        *outError = LoadError::NONE;
+    }
 
     if (!sInitialized) {
         return false;
@@ -241,57 +1371,228 @@ bool Load(uint64_t titleId, Renderer::ImageHandle& outHandle)
 
     // 1. Check memory cache
     if (sMemoryEnabled) {
-        auto it = sMemoryCache.find(titleId);
-        if (it != sMemoryCache.end()) {
-            touchLRU(titleId);
-            outHandle = it->second.handle;
+        outHandle = GetFromMemoryCache(titleId);
+        if (outHandle == Renderer::INVALID_IMAGE) {
+            outHandle = PromoteFromWarmCache(titleId);
+        }
+        if (outHandle != Renderer::INVALID_IMAGE) {
             return true;
         }
     }
 
-    // 2. Check SD card
-    if (sSDCardEnabled) {
-        if (loadFromSDCard(titleId, outHandle)) {
-            if (sMemoryEnabled) {
-                StoreInMemoryCache(titleId, outHandle);
-            }
-            return true;
+    // 2. Check the icon pack, SD card, then NAND
+    outHandle = LoadFromStorage(titleId, sIconSize, sPixelFormat, outError);
+    if (outHandle == Renderer::INVALID_IMAGE) {
+        return false;
+    }
+
+    if (sMemoryEnabled) {
+        StoreInMemoryCache(titleId, outHandle);
+    }
+    return true;
+}
+
+Renderer::ImageHandle LoadFromStorage(uint64_t titleId, int iconSize, Renderer::PixelFormat format,
+                                      LoadError* outError)
+{
+    TRACE_SCOPE("Icon load");
+
+    LoadError error = LoadError::NONE;
+    Renderer::ImageHandle image = loadScaledIcon(titleId, iconSize, error);
+    if (image) {
+        image = convertImage(image, format);
+        error = image ? LoadError::NONE : LoadError::OUT_OF_MEMORY;
+    }
+
+    if (outError) {
+        *outError = error;
+    }
+    return image;
+}
+
+/**
+ * Bytes in the pixel data no index entry refers to.
+ */
+uint32_t unreferencedPackBytes()
+{
+    size_t liveBytes = 0;
+    for (const IconPackEntry& entry : sPackIndex) {
+        liveBytes += static_cast<size_t>(entry.width) * entry.height * sizeof(uint32_t);
+    }
+    size_t dataBytes = sPackDataEnd - sizeof(IconPackHeader);
+    return liveBytes < dataBytes ? static_cast<uint32_t>(dataBytes - liveBytes) : 0;
+}
+
+/**
+ * Move the live pixels to the front of the pack, in file order, and mark
+ * the index for the flush that follows. The header is invalidated first
+ * so a compaction cut short reads as a bad pack; on a failed write the
+ * pack is started over.
+ */
+void compactIconPack()
+{
+    IconPackHeader invalidHeader = {};
+    std::vector<size_t> order(sPackIndex.size());
+    for (size_t position = 0; position < order.size(); position++) {
+        order[position] = position;
+    }
+    std::sort(order.begin(), order.end(), [](size_t first, size_t second) {
+        return sPackIndex[first].offset < sPackIndex[second].offset;
+    });
+
+    bool isCompacted = FileStorage::WriteAt(ICON_PACK_PATH, 0, &invalidHeader, sizeof(invalidHeader));
+    std::vector<uint8_t> pixels;
+    uint32_t offset = sizeof(IconPackHeader);
+    for (size_t position = 0; position < order.size() && isCompacted; position++) {
+        IconPackEntry& entry = sPackIndex[order[position]];
+        size_t pixelBytes = static_cast<size_t>(entry.width) * entry.height * sizeof(uint32_t);
+        if (entry.offset != offset) {
+            // Entries only move down, so the read never sees moved pixels
+            pixels.resize(pixelBytes);
+            isCompacted = FileStorage::ReadAt(ICON_PACK_PATH, entry.offset, pixels.data(), pixelBytes) &&
+                          FileStorage::WriteAt(ICON_PACK_PATH, offset, pixels.data(), pixelBytes);
+            entry.offset = offset;
         }
+        offset += static_cast<uint32_t>(pixelBytes);
     }
 
-    // 3. Check NAND
-    if (sNANDEnabled) {
-        char nandPath[280] = {0};
-        if (loadFromNAND(titleId, outHandle, nandPath, sizeof(nandPath))) {
-            if (sMemoryEnabled) {
-                StoreInMemoryCache(titleId, outHandle);
-            }
-            // Copy to SD card for future loads
-            if (sSDCardWriteEnabled && nandPath[0] != '\0') {
-                char sdPath[160];
-                GetIconPath(titleId, sdPath, sizeof(sdPath));
-                FileStorage::CopyFile(nandPath, sdPath);
-            }
-            return true;
+    if (!isCompacted) {
+        sPackIndex.clear();
+        offset = sizeof(IconPackHeader);
+    }
+    sPackDataEnd = offset;
+    hasUnsavedPackIndex = true;
+}
+
+void FlushPendingWrites()
+{
+    saveMissingIcons();
+    flushWriteBacks();
+
+    if (sPendingPackIcons.empty() && !hasUnsavedPackIndex) {
+        return;
+    }
+
+    if (sIconPackWriteEnabled && unreferencedPackBytes() > sPackDataEnd / 4) {
+        compactIconPack();
+    }
+
+    // New pixels go where the old index was, followed by the new index
+    std::vector<IconPackEntry> index = sPackIndex;
+    std::vector<uint8_t> block;
+    uint32_t offset = sPackDataEnd;
+    for (const PendingPackIcon& pending : sPendingPackIcons) {
+        // Icons decoded twice before a flush keep their first copy
+        int width = pending.image->width;
+        int height = pending.image->height;
+        bool isPacked = findPackedIcon(pending.titleId, width, height) != nullptr;
+        for (size_t added = sPackIndex.size(); added < index.size() && !isPacked; added++) {
+            isPacked = index[added].titleId == pending.titleId &&
+                       index[added].width == width && index[added].height == height;
         }
+        if (isPacked) {
+            continue;
+        }
+
+        size_t pixelBytes = static_cast<size_t>(pending.image->width) * pending.image->height * sizeof(uint32_t);
+        const uint8_t* pixels = reinterpret_cast<const uint8_t*>(pending.image->pixels);
+        block.insert(block.end(), pixels, pixels + pixelBytes);
+
+        IconPackEntry entry;
+        entry.titleId = pending.titleId;
+        entry.offset = offset;
+        entry.width = static_cast<uint16_t>(pending.image->width);
+        entry.height = static_cast<uint16_t>(pending.image->height);
+        index.push_back(entry);
+        offset += static_cast<uint32_t>(pixelBytes);
     }
+    freePendingPackIcons();
 
-    return false;
+    if (index.size() == sPackIndex.size() && !hasUnsavedPackIndex) {
+        return;
+    }
+
+    std::sort(index.begin(), index.end(), packEntryBefore);
+
+    size_t indexSize = index.size() * sizeof(IconPackEntry);
+    const uint8_t* indexBytes = reinterpret_cast<const uint8_t*>(index.data());
+    block.insert(block.end(), indexBytes, indexBytes + indexSize);
+
+    IconPackHeader header;
+    header.magic = ICON_PACK_MAGIC;
+    header.version = ICON_PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(index.size());
+    header.indexOffset = offset;
+    header.indexChecksum = checksumBytes(index.data(), indexSize);
+
+    if (!FileStorage::WriteAt(ICON_PACK_PATH, sPackDataEnd, block.data(), block.size()) ||
+        !FileStorage::WriteAt(ICON_PACK_PATH, 0, &header, sizeof(header))) {
+        return;
+    }
+
+    sPackIndex.swap(index);
+    sPackDataEnd = offset;
+    hasUnsavedPackIndex = false;
+}
+
+void SetPixelFormat(Renderer::PixelFormat format)
+{
+    if (format == sPixelFormat) {
+        return;
+    }
+
+    sPixelFormat = format;
+    ClearMemoryCache();
+}
+
+Renderer::PixelFormat GetPixelFormat()
+{
+    return sPixelFormat;
+}
+
+void SetIconSize(int iconSize)
+{
+    if (iconSize < 0) {
+        iconSize = 0;
+    }
+    if (iconSize == sIconSize) {
+        return;
+    }
+
+    // Cached icons are the old size; they are decoded again on demand
+    sIconSize = iconSize;
+    ClearMemoryCache();
+}
+
+int GetIconSize()
+{
+    return sIconSize;
+}
+
+void FreeImage(Renderer::ImageHandle handle)
+{
+    if (handle) {
+        Renderer::ReleaseImage(handle);
+        if (handle->pixels) {
+            free(handle->pixels);
+        }
+        delete handle;
+    }
 }
 
 bool IsInMemoryCache(uint64_t titleId)
 {
-    return sMemoryCache.find(titleId) != sMemoryCache.end();
+    return findEntry(titleId) != NO_ENTRY;
 }
 
 Renderer::ImageHandle GetFromMemoryCache(uint64_t titleId)
 {
-    auto it = sMemoryCache.find(titleId);
-    if (it != sMemoryCache.end()) {
-        touchLRU(titleId);
-        return it->second.handle;
+    int32_t entryIndex = findEntry(titleId);
+    if (entryIndex == NO_ENTRY) {
+        return Renderer::INVALID_IMAGE;
     }
-    return Renderer::INVALID_IMAGE;
+    touchLRU(entryIndex);
+    return sCacheEntries[entryIndex].handle;
 }
 
 void StoreInMemoryCache(uint64_t titleId, Renderer::ImageHandle handle)
@@ -300,50 +1601,196 @@ void StoreInMemoryCache(uint64_t titleId, Renderer::ImageHandle handle)
         return;
     }
 
-    auto it = sMemoryCache.find(titleId);
-    if (it != sMemoryCache.end()) {
-        touchLRU(titleId);
+    uint32_t slot = findSlot(titleId);
+    if (sCacheSlots[slot] != NO_ENTRY) {
+        touchLRU(sCacheSlots[slot]);
         return;
     }
 
-    CacheEntry entry;
+    // An image bigger than the whole budget still gets cached, alone
+    size_t byteCount = GetImageBytes(handle);
+    if (sFreeEntries == NO_ENTRY || sCacheBytes + byteCount > sMemoryBudget) {
+        evictToFit(byteCount);
+        // The evictions may have shifted the probe run
+        slot = findSlot(titleId);
+    }
+
+    int32_t entryIndex = sFreeEntries;
+    CacheEntry& entry = sCacheEntries[entryIndex];
+    sFreeEntries = entry.nextEntry;
+
+    entry.titleId = titleId;
     entry.handle = handle;
-    sMemoryCache[titleId] = entry;
-    touchLRU(titleId);
-    evictIfNeeded();
+    entry.byteCount = static_cast<uint32_t>(byteCount);
+    appendLRU(entryIndex);
+    sCacheSlots[slot] = entryIndex;
+    sCacheCount++;
+    sCacheBytes += byteCount;
+
+    // Loaded again from storage while a warm copy was waiting
+    if (!sWarmIcons.empty()) {
+        removeWarmIcon(titleId);
+    }
 }
 
 void RemoveFromMemoryCache(uint64_t titleId)
 {
-    auto it = sMemoryCache.find(titleId);
-    if (it != sMemoryCache.end()) {
-        freeImage(it->second.handle);
-        sMemoryCache.erase(it);
+    int32_t entryIndex = findEntry(titleId);
+    if (entryIndex != NO_ENTRY) {
+        releaseEntry(entryIndex);
+    }
+    removeWarmIcon(titleId);
+}
+
+Renderer::ImageHandle ReplaceInMemoryCache(uint64_t titleId, const uint32_t* pixels, int width, int height)
+{
+    if (!sInitialized || !pixels || width <= 0 || height <= 0) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageHandle image = newImage(width, height);
+    if (!image) {
+        return Renderer::INVALID_IMAGE;
+    }
+    memcpy(image->pixels, pixels, static_cast<size_t>(width) * height * sizeof(uint32_t));
+
+    int scaledWidth, scaledHeight;
+    fitToIconSize(width, height, sIconSize, scaledWidth, scaledHeight);
+    if (scaledWidth != width || scaledHeight != height) {
+        Renderer::ImageHandle scaled = scaleImage(image, scaledWidth, scaledHeight);
+        FreeImage(image);
+        image = scaled;
+    }
+    image = convertImage(image, sPixelFormat);
+    if (!image) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    RemoveFromMemoryCache(titleId);
+    StoreInMemoryCache(titleId, image);
+    return image;
+}
+
+void ReplaceStoredIcon(uint64_t titleId, const uint32_t* pixels, int width, int height)
+{
+    if (!sInitialized) {
+        return;
     }
 
-    auto lruIt = std::find(sLRUOrder.begin(), sLRUOrder.end(), titleId);
-    if (lruIt != sLRUOrder.end()) {
-        sLRUOrder.erase(lruIt);
+    forgetPackedIcons(titleId);
+    forgetMissing(titleId);
+
+    if (pixels && width > 0 && height > 0) {
+        // queuePackIcon() keeps a copy
+        Renderer::ImageData source;
+        source.pixels = const_cast<uint32_t*>(pixels);
+        source.width = width;
+        source.height = height;
+        queuePackIcon(titleId, &source);
     }
+    FlushPendingWrites();
 }
 
 void ClearMemoryCache()
 {
-    for (auto& pair : sMemoryCache) {
-        freeImage(pair.second.handle);
+    if (!sInitialized) {
+        return;
+    }
+
+    freeCachedImages();
+    freeWarmIcons();
+    resetCache();
+}
+
+void DemoteMemoryCache(size_t hotBytes)
+{
+    if (!sInitialized) {
+        return;
+    }
+
+    // The most recently used icons are the ones drawn last; they stay
+    // decoded, newest first, as long as they fit
+    int32_t entryIndex = sLRUTail;
+    size_t keptBytes = 0;
+    while (entryIndex != NO_ENTRY && keptBytes + sCacheEntries[entryIndex].byteCount <= hotBytes) {
+        keptBytes += sCacheEntries[entryIndex].byteCount;
+        entryIndex = sCacheEntries[entryIndex].previousEntry;
+    }
+
+    // The rest go warm newest first, ahead of icons that were already warm
+    size_t insertAt = 0;
+    bool isWarmFull = false;
+    while (entryIndex != NO_ENTRY) {
+        CacheEntry& entry = sCacheEntries[entryIndex];
+        int32_t olderEntry = entry.previousEntry;
+        if (!isWarmFull) {
+            isWarmFull = !insertWarmIcon(entry.titleId, entry.handle, insertAt);
+            if (!isWarmFull) {
+                insertAt++;
+            }
+        }
+        releaseEntry(entryIndex);
+        entryIndex = olderEntry;
+    }
+}
+
+Renderer::ImageHandle PromoteFromWarmCache(uint64_t titleId)
+{
+    int warmIndex = findWarmIcon(titleId);
+    if (warmIndex < 0) {
+        return Renderer::INVALID_IMAGE;
+    }
+
+    Renderer::ImageHandle image = decodeWarmIcon(sWarmIcons[warmIndex]);
+    eraseWarmIcon(warmIndex);
+
+    if (image) {
+        StoreInMemoryCache(titleId, image);
+    }
+    return image;
+}
+
+int GetWarmCacheCount()
+{
+    return static_cast<int>(sWarmIcons.size());
+}
+
+size_t GetWarmCacheBytes()
+{
+    return sWarmBytes;
+}
+
+void SetMemoryBudget(size_t memoryBudgetBytes)
+{
+    sMemoryBudget = memoryBudgetBytes > 0 ? memoryBudgetBytes : DEFAULT_MEMORY_BUDGET;
+    while (sLRUHead != NO_ENTRY && sCacheBytes > sMemoryBudget) {
+        releaseEntry(sLRUHead);
     }
-    sMemoryCache.clear();
-    sLRUOrder.clear();
 }
 
 int GetMemoryCacheCount()
 {
-    return static_cast<int>(sMemoryCache.size());
+    return sCacheCount;
+}
+
+size_t GetMemoryCacheBytes()
+{
+    return sCacheBytes;
 }
 
-int GetMemoryCacheCapacity()
+size_t GetMemoryBudget()
 {
-    return sCacheCapacity;
+    return sMemoryBudget;
+}
+
+size_t GetImageBytes(Renderer::ImageHandle handle)
+{
+    if (!handle) {
+        return 0;
+    }
+    return sizeof(Renderer::ImageData) +
+           static_cast<size_t>(handle->width) * static_cast<size_t>(handle->height) *
+           Renderer::GetBytesPerPixel(handle->format);
 }
 
 const char* GetIconsDirectory()
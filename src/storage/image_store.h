@@ -1,4 +1,27 @@
-// Image storage with pluggable sources (memory cache, SD card, NAND)
+// Image storage with pluggable sources (memory cache, icon pack, SD card, NAND)
+//
+// The icon pack is one SD file of already-decoded icons with a sorted
+// titleId index, so a packed icon costs one read and no decode. Icons
+// decoded from the SD icon folder or NAND are appended to it in batches.
+// Delete icons.pack to pick up changed custom icons.
+//
+// Icons are scaled down to the layout's icon size when they are decoded,
+// so drawing one is a 1:1 copy. The memory cache holds only the scaled
+// icon; the pack keeps the source next to each scaled variant, so going
+// back to a size already seen costs no decode and no rescale.
+//
+// While the menu is closed, DemoteMemoryCache() shrinks the memory cache
+// to the icons drawn last and keeps the next ones compressed in a small
+// warm tier; loads unpack a warm icon instead of going to storage.
+//
+// ReplaceInMemoryCache() swaps in an icon the pixel editor just drew
+// without reading it back from the SD card, and ReplaceStoredIcon() packs
+// it in place of the title's old entries, so the edit outlives the memory
+// cache.
+//
+// Titles that no source has an icon for are listed in missing_icons.bin
+// next to the pack, so they cost no lookups in later sessions. Delete it
+// after adding a custom icon for one of them.
 
 #pragma once
 
@@ -10,13 +33,32 @@ namespace ImageStore {
 
 // Storage sources
 enum class Source {
-    MEMORY,   // In-memory LRU cache
-    SD_CARD,  // SD card icon cache
-    NAND      // Title meta directory (read-only)
+    MEMORY,     // In-memory LRU cache
+    ICON_PACK,  // Pre-decoded icons in one SD file
+    SD_CARD,    // SD card icon cache
+    NAND        // Title meta directory (read-only)
 };
 
+// Why a load returned no image
+enum class LoadError {
+    NONE,
+    NOT_FOUND,      // No source has an icon (remembered; see above)
+    DECODE_FAILED,  // An icon file exists but isn't a readable image
+    READ_FAILED,    // An icon file exists but couldn't be read
+    OUT_OF_MEMORY   // Decoding couldn't allocate its pixels
+};
+
+// Memory cache limits. The budget counts stored pixel bytes, so icons
+// of any size or format are accounted for; the entry limit only sizes
+// the index
+constexpr size_t DEFAULT_MEMORY_BUDGET = 4 * 1024 * 1024;
+constexpr int MAX_CACHED_IMAGES = 1024;
+
+// Compressed bytes the warm tier may hold
+constexpr size_t WARM_CACHE_BUDGET = 1024 * 1024;
+
 // Initialize the image store
-void Init(int memoryCacheSize = 50);
+void Init(size_t memoryBudgetBytes = DEFAULT_MEMORY_BUDGET);
 
 // Shutdown and free all cached images
 void Shutdown();
@@ -28,8 +70,38 @@ bool IsSourceEnabled(Source src);
 bool IsWriteEnabled(Source src);
 
 // Load image for a title (tries enabled sources in order)
-// Returns true if image was loaded, false if not found
-bool Load(uint64_t titleId, Renderer::ImageHandle& outHandle);
+// Returns true if image was loaded, false if not (see outError)
+bool Load(uint64_t titleId, Renderer::ImageHandle& outHandle, LoadError* outError = nullptr);
+
+// Read a title's image from the icon pack, SD or NAND, skipping the
+// memory cache, scaled to fit iconSize (see SetIconSize) and stored as
+// format. Touches no cache state, so a worker thread may call it, but
+// only one thread at a time (it shares the icon pack with
+// FlushPendingWrites). Returns INVALID_IMAGE if not found, with the reason in
+// outError; the caller owns the result
+Renderer::ImageHandle LoadFromStorage(uint64_t titleId, int iconSize, Renderer::PixelFormat format,
+                                      LoadError* outError = nullptr);
+
+// Write what loads have queued for the SD card: icons decoded since the
+// last flush go into the icon pack, NAND icons are copied to the icon
+// folder (if SD writes are enabled) and newly found missing icons are
+// saved. Runs on its own every few icons; call it when loading goes
+// idle, from the thread that calls LoadFromStorage()
+void FlushPendingWrites();
+
+// Format images are stored in once decoded (see Renderer::PixelFormat).
+// Changing it clears the memory cache
+constexpr Renderer::PixelFormat DEFAULT_PIXEL_FORMAT = Renderer::PixelFormat::RGB565;
+void SetPixelFormat(Renderer::PixelFormat format);
+Renderer::PixelFormat GetPixelFormat();
+
+// Side of the square decoded icons are scaled down to fit (0 keeps the
+// source size). Changing it clears the memory cache
+void SetIconSize(int iconSize);
+int GetIconSize();
+
+// Free an image that isn't in the memory cache
+void FreeImage(Renderer::ImageHandle handle);
 
 // Check if image is in memory cache
 bool IsInMemoryCache(uint64_t titleId);
@@ -40,15 +112,44 @@ Renderer::ImageHandle GetFromMemoryCache(uint64_t titleId);
 // Store image in memory cache
 void StoreInMemoryCache(uint64_t titleId, Renderer::ImageHandle handle);
 
-// Remove from memory cache
+// Remove from memory cache and the warm tier
 void RemoveFromMemoryCache(uint64_t titleId);
 
-// Clear entire memory cache
+// Replace a title's cached icon with a copy of RGBA8888 pixels, scaled
+// and converted like a decoded icon. The old cached and warm copies are
+// freed. Returns the cached image, or INVALID_IMAGE if it couldn't be
+// allocated (the old copies are kept then)
+Renderer::ImageHandle ReplaceInMemoryCache(uint64_t titleId, const uint32_t* pixels, int width, int height);
+
+// Forget a title's packed icons and missing mark and pack RGBA8888 pixels
+// as its new source icon (written out at once, so the next load finds
+// it). Pixels too large for the pack are left to the SD icon folder.
+// Same one-thread rule as LoadFromStorage()
+void ReplaceStoredIcon(uint64_t titleId, const uint32_t* pixels, int width, int height);
+
+// Clear entire memory cache, warm tier included
 void ClearMemoryCache();
 
+// Keep the most recently used images that fit hotBytes decoded, compress
+// as many of the rest as the warm tier holds and free them all
+void DemoteMemoryCache(size_t hotBytes);
+
+// Unpack a title's warm icon into the memory cache (no file I/O).
+// Returns INVALID_IMAGE if it has none
+Renderer::ImageHandle PromoteFromWarmCache(uint64_t titleId);
+
+// Change the memory budget, evicting least recently used images to fit
+void SetMemoryBudget(size_t memoryBudgetBytes);
+
 // Get memory cache stats
 int GetMemoryCacheCount();
-int GetMemoryCacheCapacity();
+size_t GetMemoryCacheBytes();
+size_t GetMemoryBudget();
+int GetWarmCacheCount();
+size_t GetWarmCacheBytes();
+
+// Bytes an image holds in the memory cache
+size_t GetImageBytes(Renderer::ImageHandle handle);
 
 // SD card icon paths
 const char* GetIconsDirectory();
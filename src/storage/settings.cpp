@@ -20,19 +20,32 @@
  *
  * BINARY DATA FORMAT:
  * -------------------
- * For favorites: Array of uint64_t title IDs
- * For categories: Array of Category structs
- * For titleCategories: Array of TitleCategoryAssignment structs
+ * Since config v3 everything is one binary item ("settingsData"): a
+ * checksummed header and the scalar settings, followed by (v4 and later):
+ *   categories: Category structs
+ *   recentLaunches: uint64_t title IDs
+ *   favorites: sorted, delta-coded title IDs
+ *   titleCategories: sorted, delta-coded title IDs, each with a mask of
+ *                    its categories
+ * v3 records stored favorites and titleCategories as raw arrays instead.
+ * See "Packed Record" below for the details.
+ *
+ * v1/v2 stored each scalar under its own int key and each array as a
+ * count key plus a binary item; Load() still reads that layout and the
+ * next Save() migrates it.
  *
  * Reference: https://github.com/wiiu-env/WiiUPluginSystem/wiki/Storage-API
  */
 
 #include "settings.h"
+#include "../utils/trace.h"
 
 // WUPS Storage API
 #include <wups/storage.h>
 
 // Standard library
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
 
@@ -47,11 +60,72 @@ namespace {
 // The global settings instance
 PluginSettings gSettings;
 
+// See GetMembershipGeneration()
+uint32_t gMembershipGeneration = 1;
+
+// See GetCategoryOrder(): positions in gSettings.categories in display
+// order, all of them and visible only. Rebuilt on first use after a
+// category is created, deleted, moved or hidden, or settings are replaced
+int gCategoryOrder[MAX_CATEGORIES];
+int gCategoryOrderCount = 0;
+int gVisibleCategoryOrder[MAX_CATEGORIES];
+int gVisibleCategoryOrderCount = 0;
+bool isCategoryOrderValid = false;
+
+// Open-addressed set over gSettings.favorites: each used slot holds one
+// plus the position of a title ID in the vector (0 is empty), so lookups,
+// inserts and removals are O(1) and removal can swap the last element in
+constexpr int FAVORITE_SLOT_COUNT = 2048;
+constexpr uint16_t EMPTY_FAVORITE_SLOT = 0;
+static_assert(FAVORITE_SLOT_COUNT >= MAX_FAVORITES * 2, "favorite set must stay under half load");
+static_assert((FAVORITE_SLOT_COUNT & (FAVORITE_SLOT_COUNT - 1)) == 0, "slot count must be a power of two");
+uint16_t gFavoriteSlots[FAVORITE_SLOT_COUNT] = {};
+
+// Index over gSettings.titleCategories: every record sits on one chain for
+// its title and one for its category, threaded through the next arrays.
+// Chain heads live in open-addressed tables keyed by title or category ID;
+// a key whose chain empties keeps its slot until the next rebuild
+constexpr int16_t NO_ASSIGNMENT = -1;
+constexpr int TITLE_CHAIN_SLOT_COUNT = 4096;
+constexpr int CATEGORY_CHAIN_SLOT_COUNT = 64;
+static_assert(TITLE_CHAIN_SLOT_COUNT >= MAX_TITLE_CATEGORIES * 2, "title chains must stay under half load");
+static_assert(CATEGORY_CHAIN_SLOT_COUNT >= MAX_CATEGORIES * 2, "category chains must stay under half load");
+static_assert(MAX_TITLE_CATEGORIES <= 32767, "records are linked with int16_t");
+
+struct AssignmentChain {
+    uint64_t key;
+    int16_t first;
+    bool isUsed;
+};
+
+template <int SlotCount>
+struct AssignmentTable {
+    static_assert((SlotCount & (SlotCount - 1)) == 0, "slot count must be a power of two");
+    static constexpr int SLOT_COUNT = SlotCount;
+
+    AssignmentChain slots[SlotCount];
+    int usedCount;
+};
+
+AssignmentTable<TITLE_CHAIN_SLOT_COUNT> gTitleChains;
+AssignmentTable<CATEGORY_CHAIN_SLOT_COUNT> gCategoryChains;
+int16_t gNextForTitle[MAX_TITLE_CATEGORIES];
+int16_t gNextForCategory[MAX_TITLE_CATEGORIES];
+
+// The packed record storage holds, so Save() can skip unchanged settings;
+// false until a Load() or Save() establishes it
+std::vector<uint8_t> gPersistedBlob;
+bool hasPersistedSettings = false;
+
+// See SetFlushBackend(); nullptr flushes synchronously in Save()
+const FlushBackend* gFlushBackend = nullptr;
+
 // Storage keys (used to identify data in the WUPS storage file)
 // These are arbitrary strings; just need to be consistent and unique
 constexpr const char* KEY_VERSION          = "configVersion";
 constexpr const char* KEY_LAST_INDEX       = "lastIndex";
 constexpr const char* KEY_LAST_CATEGORY    = "lastCategory";
+constexpr const char* KEY_SORT_ORDER       = "sortOrder";
 constexpr const char* KEY_SHOW_NUMBERS     = "showNumbers";
 constexpr const char* KEY_SHOW_FAVORITES   = "showFavorites";
 constexpr const char* KEY_BG_COLOR         = "bgColor";
@@ -67,9 +141,28 @@ constexpr const char* KEY_CATEGORIES_DATA  = "categoriesData";
 constexpr const char* KEY_TITLE_CAT_COUNT  = "titleCatCount";
 constexpr const char* KEY_TITLE_CAT_DATA   = "titleCatData";
 constexpr const char* KEY_NEXT_CAT_ID      = "nextCategoryId";
+constexpr const char* KEY_RECENT_COUNT     = "recentCount";
+constexpr const char* KEY_RECENT_DATA      = "recentData";
 constexpr const char* KEY_LAYOUT_FONT_SCALE    = "layoutFontScale";
 constexpr const char* KEY_LAYOUT_LIST_WIDTH    = "layoutListWidth";
 constexpr const char* KEY_LAYOUT_ICON_SIZE     = "layoutIconSize";
+constexpr const char* KEY_SETTINGS_DATA    = "settingsData";
+
+// First config version stored as one packed record (see packSettings)
+constexpr int32_t PACKED_CONFIG_VERSION = 3;
+
+// First config version whose packed scalars end with iconCacheKB
+constexpr int32_t ICON_CACHE_CONFIG_VERSION = 5;
+
+// First config version with the built-in Recent category at index 2,
+// ahead of the user categories that used to start there
+constexpr int32_t RECENT_CATEGORY_CONFIG_VERSION = 6;
+constexpr int32_t RECENT_CATEGORY_INDEX = 2;
+
+// First config versions whose packed scalars end with showIconGrid, and
+// then with tvRefresh
+constexpr int32_t ICON_GRID_CONFIG_VERSION = 7;
+constexpr int32_t TV_REFRESH_CONFIG_VERSION = 8;
 
 // =============================================================================
 // Storage Helpers
@@ -91,48 +184,694 @@ inline void LoadColor(const char* key, uint32_t& out) {
     }
 }
 
-} // anonymous namespace
+int getFavoriteHomeSlot(uint64_t titleId)
+{
+    uint64_t hash = titleId * 0x9E3779B97F4A7C15ull;
+    return static_cast<int>(hash >> 48) & (FAVORITE_SLOT_COUNT - 1);
+}
+
+/**
+ * Find the slot holding a title, or the empty slot that ends its probe run.
+ */
+int findFavoriteSlot(uint64_t titleId)
+{
+    int slot = getFavoriteHomeSlot(titleId);
+    while (gFavoriteSlots[slot] != EMPTY_FAVORITE_SLOT &&
+           gSettings.favorites[gFavoriteSlots[slot] - 1] != titleId) {
+        slot = (slot + 1) & (FAVORITE_SLOT_COUNT - 1);
+    }
+    return slot;
+}
+
+/**
+ * Empty a slot, shifting later entries of the probe run back so lookups
+ * never need tombstones.
+ */
+void clearFavoriteSlot(int slot)
+{
+    int hole = slot;
+    int next = (slot + 1) & (FAVORITE_SLOT_COUNT - 1);
+
+    while (gFavoriteSlots[next] != EMPTY_FAVORITE_SLOT) {
+        int home = getFavoriteHomeSlot(gSettings.favorites[gFavoriteSlots[next] - 1]);
+
+        // Move the entry into the hole unless its home lies after the hole
+        // (cyclically) and at or before its current slot
+        int distanceToHole = (hole - home) & (FAVORITE_SLOT_COUNT - 1);
+        int distanceToNext = (next - home) & (FAVORITE_SLOT_COUNT - 1);
+        if (distanceToHole < distanceToNext) {
+            gFavoriteSlots[hole] = gFavoriteSlots[next];
+            hole = next;
+        }
+        next = (next + 1) & (FAVORITE_SLOT_COUNT - 1);
+    }
+
+    gFavoriteSlots[hole] = EMPTY_FAVORITE_SLOT;
+}
+
+/**
+ * Rebuild the set after gSettings.favorites was replaced, dropping
+ * duplicate and excess entries.
+ */
+void rebuildFavoriteSet()
+{
+    for (int slot = 0; slot < FAVORITE_SLOT_COUNT; slot++) {
+        gFavoriteSlots[slot] = EMPTY_FAVORITE_SLOT;
+    }
+
+    std::vector<uint64_t>& favorites = gSettings.favorites;
+    size_t keptCount = 0;
+    for (size_t favIndex = 0; favIndex < favorites.size() && keptCount < MAX_FAVORITES; favIndex++) {
+        uint64_t titleId = favorites[favIndex];
+
+        // Only the first keptCount entries are in the set so far
+        favorites[keptCount] = titleId;
+        int slot = findFavoriteSlot(titleId);
+        if (gFavoriteSlots[slot] == EMPTY_FAVORITE_SLOT) {
+            keptCount++;
+            gFavoriteSlots[slot] = static_cast<uint16_t>(keptCount);
+        }
+    }
+    favorites.resize(keptCount);
+}
+
+int16_t* getNextForTitle(int record) { return &gNextForTitle[record]; }
+int16_t* getNextForCategory(int record) { return &gNextForCategory[record]; }
+
+template <typename Table>
+void clearAssignmentTable(Table& table)
+{
+    for (int slot = 0; slot < Table::SLOT_COUNT; slot++) {
+        table.slots[slot].isUsed = false;
+    }
+    table.usedCount = 0;
+}
+
+/**
+ * Find the chain for a key, optionally claiming a slot for a new key.
+ *
+ * @return The chain, or nullptr if the key is absent (and not created)
+ */
+template <typename Table>
+AssignmentChain* findAssignmentChain(Table& table, uint64_t key, bool shouldCreate)
+{
+    uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    int slot = static_cast<int>(hash >> 48) & (Table::SLOT_COUNT - 1);
+
+    while (table.slots[slot].isUsed) {
+        if (table.slots[slot].key == key) {
+            return &table.slots[slot];
+        }
+        slot = (slot + 1) & (Table::SLOT_COUNT - 1);
+    }
+
+    if (!shouldCreate) {
+        return nullptr;
+    }
+
+    AssignmentChain& chain = table.slots[slot];
+    chain.key = key;
+    chain.first = NO_ASSIGNMENT;
+    chain.isUsed = true;
+    table.usedCount++;
+    return &chain;
+}
+
+/**
+ * Find the link (a chain head or a next entry) that points at a record.
+ */
+int16_t* findAssignmentLink(AssignmentChain* chain, int16_t* (*getNext)(int), int record)
+{
+    int16_t* link = &chain->first;
+    while (*link != NO_ASSIGNMENT && *link != record) {
+        link = getNext(*link);
+    }
+    return link;
+}
+
+/**
+ * Put the last record on both of its chains. Title chains keep
+ * assignment order, so records are appended there.
+ */
+void linkLastAssignment()
+{
+    int record = static_cast<int>(gSettings.titleCategories.size()) - 1;
+    const TitleCategoryAssignment& assignment = gSettings.titleCategories[record];
+
+    AssignmentChain* titleChain = findAssignmentChain(gTitleChains, assignment.titleId, true);
+    *findAssignmentLink(titleChain, getNextForTitle, NO_ASSIGNMENT) = static_cast<int16_t>(record);
+    gNextForTitle[record] = NO_ASSIGNMENT;
+
+    AssignmentChain* categoryChain = findAssignmentChain(gCategoryChains, assignment.categoryId, true);
+    gNextForCategory[record] = categoryChain->first;
+    categoryChain->first = static_cast<int16_t>(record);
+}
+
+/**
+ * Rebuild both tables after gSettings.titleCategories was replaced,
+ * dropping duplicate and excess records. Also compacts keys whose
+ * chains have emptied.
+ */
+void rebuildAssignmentIndex()
+{
+    clearAssignmentTable(gTitleChains);
+    clearAssignmentTable(gCategoryChains);
+
+    std::vector<TitleCategoryAssignment> records;
+    records.swap(gSettings.titleCategories);
+    gSettings.titleCategories.reserve(records.size());
+
+    for (const TitleCategoryAssignment& assignment : records) {
+        if (gSettings.titleCategories.size() >= MAX_TITLE_CATEGORIES ||
+            TitleHasCategory(assignment.titleId, assignment.categoryId)) {
+            continue;
+        }
+        gSettings.titleCategories.push_back(assignment);
+        linkLastAssignment();
+    }
+}
+
+/**
+ * Remove one record, moving the last record into its place so the
+ * array stays dense. Costs one walk of each affected chain.
+ */
+void removeAssignmentAt(int record)
+{
+    std::vector<TitleCategoryAssignment>& records = gSettings.titleCategories;
+
+    const TitleCategoryAssignment& removed = records[record];
+    int16_t* titleLink = findAssignmentLink(findAssignmentChain(gTitleChains, removed.titleId, false),
+                                            getNextForTitle, record);
+    *titleLink = gNextForTitle[record];
+    int16_t* categoryLink = findAssignmentLink(findAssignmentChain(gCategoryChains, removed.categoryId, false),
+                                               getNextForCategory, record);
+    *categoryLink = gNextForCategory[record];
+
+    int lastRecord = static_cast<int>(records.size()) - 1;
+    if (record != lastRecord) {
+        // Repoint whatever linked to the last record at its new slot
+        const TitleCategoryAssignment& moved = records[lastRecord];
+        *findAssignmentLink(findAssignmentChain(gTitleChains, moved.titleId, false),
+                            getNextForTitle, lastRecord) = static_cast<int16_t>(record);
+        *findAssignmentLink(findAssignmentChain(gCategoryChains, moved.categoryId, false),
+                            getNextForCategory, lastRecord) = static_cast<int16_t>(record);
+
+        records[record] = moved;
+        gNextForTitle[record] = gNextForTitle[lastRecord];
+        gNextForCategory[record] = gNextForCategory[lastRecord];
+    }
+    records.pop_back();
+}
 
 // =============================================================================
-// Core Functions Implementation
+// Packed Record (config v3 and later)
 // =============================================================================
+// All settings live in one binary item: a header, then PackedScalars, the
+// categories and launch history as raw arrays, then favorites and
+// assignments in a compact form. The checksum covers everything after the
+// header. The header carries the config version that wrote it; from v4 on,
+// later versions only append scalars, so older records still decode.
+//
+// Favorites and assigned titles are written as sorted ID lists: IDs are
+// grouped by their high word (nearly all titles share 0x00050000), and
+// within a group only varint deltas between low words are stored. Each
+// assigned title is followed by a mask of its categories by list position.
+// A typical ID costs two or three bytes instead of eight, and assignments
+// go from one 16-byte record per pair to one ID plus two bytes per title.
+
+struct PackedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t payloadSize;
+    uint32_t checksum;
+};
+
+struct PackedScalars {
+    int32_t lastIndex;
+    int32_t lastCategoryIndex;
+    int32_t sortOrder;
+    uint32_t bgColor;
+    uint32_t titleColor;
+    uint32_t highlightedTitleColor;
+    uint32_t favoriteColor;
+    uint32_t headerColor;
+    uint32_t categoryColor;
+    int32_t fontScale;
+    int32_t listWidthPercent;
+    int32_t iconSizePercent;
+    uint16_t nextCategoryId;
+    uint8_t showNumbers;
+    uint8_t showFavorites;
+    uint16_t categoryCount;
+    uint16_t recentCount;
+
+    // Added in v5; v4 records end their scalars before it
+    int32_t iconCacheKB;
+
+    // Added in v7; v5 and v6 records end their scalars before it
+    uint8_t showIconGrid;
+
+    // Added in v8; v7 records end their scalars before it
+    int32_t tvRefresh;
+};
+
+// v3 records share the scalars up to categoryCount, then count all four
+// arrays, which follow raw: favorites, categories, assignments, launches
+struct PackedCountsV3 {
+    uint16_t favoriteCount;
+    uint16_t categoryCount;
+    uint16_t assignmentCount;
+    uint16_t recentCount;
+};
+
+constexpr size_t V3_SHARED_SCALARS_SIZE = offsetof(PackedScalars, categoryCount);
+constexpr size_t V3_SCALARS_SIZE = V3_SHARED_SCALARS_SIZE + sizeof(PackedCountsV3);
+constexpr size_t V4_SCALARS_SIZE = offsetof(PackedScalars, iconCacheKB);
+constexpr size_t V5_SCALARS_SIZE = offsetof(PackedScalars, showIconGrid);
+constexpr size_t V7_SCALARS_SIZE = offsetof(PackedScalars, tvRefresh);
+
+constexpr uint32_t PACKED_MAGIC = 0x54534346;
+
+// Worst case for one varint and for one ID (a group of its own: high word,
+// group size, low word)
+constexpr size_t MAX_VARINT_SIZE = 5;
+constexpr size_t MAX_ENCODED_ID_SIZE = MAX_VARINT_SIZE * 3;
+
+static_assert(MAX_CATEGORIES <= 16, "category masks are stored as 16 bits");
+
+constexpr size_t MAX_PACKED_SIZE = sizeof(PackedHeader) + sizeof(PackedScalars) +
+                                   MAX_CATEGORIES * sizeof(Category) +
+                                   MAX_RECENT_LAUNCHES * sizeof(uint64_t) +
+                                   MAX_VARINT_SIZE * 2 + MAX_FAVORITES * MAX_ENCODED_ID_SIZE +
+                                   MAX_VARINT_SIZE * 2 +
+                                   MAX_TITLE_CATEGORIES * (MAX_ENCODED_ID_SIZE + sizeof(uint16_t));
+
+// FNV-1a over the payload
+uint32_t checksumBytes(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t byteIndex = 0; byteIndex < size; byteIndex++) {
+        hash ^= data[byteIndex];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-void Init()
+template <typename T>
+void appendArray(std::vector<uint8_t>& out, const std::vector<T>& values)
 {
-    // Initialize with default values
-    gSettings = PluginSettings();
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+    out.insert(out.end(), bytes, bytes + values.size() * sizeof(T));
 }
 
-void Load()
+/**
+ * Copy count elements out of the packed payload, advancing the read offset.
+ *
+ * @return false if the payload is too short
+ */
+template <typename T>
+bool readArray(const uint8_t* payload, size_t payloadSize, size_t& offset,
+               int count, std::vector<T>& out)
 {
-    // -------------------------------------------------------------------------
-    // Step 1: Check for existing settings and their version
-    // -------------------------------------------------------------------------
-    int32_t version = 0;
-    WUPSStorageAPI_GetInt(nullptr, KEY_VERSION, &version);
+    size_t byteCount = static_cast<size_t>(count) * sizeof(T);
+    if (payloadSize - offset < byteCount) {
+        return false;
+    }
+    out.resize(count);
+    if (byteCount > 0) {
+        memcpy(out.data(), payload + offset, byteCount);
+    }
+    offset += byteCount;
+    return true;
+}
 
-    if (version == 0) {
-        // No saved settings found - keep defaults
-        return;
+void appendVarint(std::vector<uint8_t>& out, uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t* payload, size_t payloadSize, size_t& offset, uint32_t& out)
+{
+    out = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (offset >= payloadSize) {
+            return false;
+        }
+        uint8_t byte = payload[offset++];
+        out |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Write sorted, unique title IDs as high-word groups of delta-coded low
+ * words.
+ */
+void appendTitleIds(std::vector<uint8_t>& out, const std::vector<uint64_t>& sortedIds)
+{
+    appendVarint(out, static_cast<uint32_t>(sortedIds.size()));
+
+    size_t groupStart = 0;
+    while (groupStart < sortedIds.size()) {
+        uint32_t highWord = static_cast<uint32_t>(sortedIds[groupStart] >> 32);
+        size_t groupEnd = groupStart;
+        while (groupEnd < sortedIds.size() && static_cast<uint32_t>(sortedIds[groupEnd] >> 32) == highWord) {
+            groupEnd++;
+        }
+
+        appendVarint(out, highWord);
+        appendVarint(out, static_cast<uint32_t>(groupEnd - groupStart));
+        uint32_t previousLow = 0;
+        for (size_t idIndex = groupStart; idIndex < groupEnd; idIndex++) {
+            uint32_t lowWord = static_cast<uint32_t>(sortedIds[idIndex]);
+            appendVarint(out, lowWord - previousLow);
+            previousLow = lowWord;
+        }
+        groupStart = groupEnd;
+    }
+}
+
+/**
+ * Decode an ID list written by appendTitleIds().
+ *
+ * @return false if the list is truncated or longer than maxCount
+ */
+bool readTitleIds(const uint8_t* payload, size_t payloadSize, size_t& offset,
+                  int maxCount, std::vector<uint64_t>& out)
+{
+    uint32_t totalCount = 0;
+    if (!readVarint(payload, payloadSize, offset, totalCount) ||
+        totalCount > static_cast<uint32_t>(maxCount)) {
+        return false;
+    }
+
+    out.clear();
+    out.reserve(totalCount);
+    while (out.size() < totalCount) {
+        uint32_t highWord = 0;
+        uint32_t groupSize = 0;
+        if (!readVarint(payload, payloadSize, offset, highWord) ||
+            !readVarint(payload, payloadSize, offset, groupSize) ||
+            groupSize == 0 || groupSize > totalCount - out.size()) {
+            return false;
+        }
+
+        uint32_t lowWord = 0;
+        for (uint32_t idIndex = 0; idIndex < groupSize; idIndex++) {
+            uint32_t delta = 0;
+            if (!readVarint(payload, payloadSize, offset, delta)) {
+                return false;
+            }
+            lowWord += delta;
+            out.push_back((static_cast<uint64_t>(highWord) << 32) | lowWord);
+        }
+    }
+    return true;
+}
+
+/**
+ * Write assignments as a sorted list of titles, each followed by a mask
+ * of its categories by list position.
+ */
+void appendAssignments(std::vector<uint8_t>& out)
+{
+    struct TitleMask {
+        uint64_t titleId;
+        uint16_t mask;
+    };
+
+    std::vector<TitleMask> titleMasks;
+    titleMasks.reserve(gSettings.titleCategories.size());
+    const std::vector<Category>& categories = gSettings.categories;
+    for (const TitleCategoryAssignment& assignment : gSettings.titleCategories) {
+        for (size_t position = 0; position < categories.size(); position++) {
+            if (categories[position].id == assignment.categoryId) {
+                titleMasks.push_back({ assignment.titleId, static_cast<uint16_t>(1u << position) });
+                break;
+            }
+        }
+    }
+    std::sort(titleMasks.begin(), titleMasks.end(), [](const TitleMask& first, const TitleMask& second) {
+        return first.titleId < second.titleId;
+    });
+
+    // Merge each title's records into one mask
+    std::vector<uint64_t> titleIds;
+    std::vector<uint16_t> masks;
+    for (const TitleMask& titleMask : titleMasks) {
+        if (!titleIds.empty() && titleIds.back() == titleMask.titleId) {
+            masks.back() |= titleMask.mask;
+        } else {
+            titleIds.push_back(titleMask.titleId);
+            masks.push_back(titleMask.mask);
+        }
+    }
+
+    appendTitleIds(out, titleIds);
+    for (uint16_t mask : masks) {
+        out.push_back(static_cast<uint8_t>(mask));
+        out.push_back(static_cast<uint8_t>(mask >> 8));
+    }
+}
+
+/**
+ * Decode assignments written by appendAssignments(); categories must
+ * already be decoded.
+ */
+bool readAssignments(const uint8_t* payload, size_t payloadSize, size_t& offset,
+                     const std::vector<Category>& categories,
+                     std::vector<TitleCategoryAssignment>& out)
+{
+    std::vector<uint64_t> titleIds;
+    if (!readTitleIds(payload, payloadSize, offset, MAX_TITLE_CATEGORIES, titleIds) ||
+        payloadSize - offset < titleIds.size() * sizeof(uint16_t)) {
+        return false;
+    }
+
+    out.clear();
+    for (uint64_t titleId : titleIds) {
+        uint16_t mask = static_cast<uint16_t>(payload[offset] | (payload[offset + 1] << 8));
+        offset += sizeof(uint16_t);
+        if (mask == 0 || (mask >> categories.size()) != 0) {
+            return false;
+        }
+
+        for (size_t position = 0; position < categories.size(); position++) {
+            if (mask & (1u << position)) {
+                if (out.size() >= MAX_TITLE_CATEGORIES) {
+                    return false;
+                }
+                TitleCategoryAssignment assignment;
+                assignment.titleId = titleId;
+                assignment.categoryId = categories[position].id;
+                out.push_back(assignment);
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Decode the raw arrays of a v3 record.
+ */
+bool readV3Arrays(const uint8_t* payload, size_t payloadSize, size_t& offset,
+                  const PackedCountsV3& counts, PluginSettings& out)
+{
+    return counts.favoriteCount <= MAX_FAVORITES &&
+           counts.assignmentCount <= MAX_TITLE_CATEGORIES &&
+           readArray(payload, payloadSize, offset, counts.favoriteCount, out.favorites) &&
+           readArray(payload, payloadSize, offset, counts.categoryCount, out.categories) &&
+           readArray(payload, payloadSize, offset, counts.assignmentCount, out.titleCategories) &&
+           readArray(payload, payloadSize, offset, counts.recentCount, out.recentLaunches);
+}
+
+void packSettings(std::vector<uint8_t>& out)
+{
+    PackedScalars scalars = {};
+    scalars.lastIndex = gSettings.lastIndex;
+    scalars.lastCategoryIndex = gSettings.lastCategoryIndex;
+    scalars.sortOrder = gSettings.sortOrder;
+    scalars.bgColor = gSettings.bgColor;
+    scalars.titleColor = gSettings.titleColor;
+    scalars.highlightedTitleColor = gSettings.highlightedTitleColor;
+    scalars.favoriteColor = gSettings.favoriteColor;
+    scalars.headerColor = gSettings.headerColor;
+    scalars.categoryColor = gSettings.categoryColor;
+    scalars.fontScale = gSettings.layoutPrefs.fontScale;
+    scalars.listWidthPercent = gSettings.layoutPrefs.listWidthPercent;
+    scalars.iconSizePercent = gSettings.layoutPrefs.iconSizePercent;
+    scalars.nextCategoryId = gSettings.nextCategoryId;
+    scalars.showNumbers = gSettings.showNumbers ? 1 : 0;
+    scalars.showFavorites = gSettings.showFavorites ? 1 : 0;
+    scalars.categoryCount = static_cast<uint16_t>(gSettings.categories.size());
+    scalars.recentCount = static_cast<uint16_t>(gSettings.recentLaunches.size());
+    scalars.iconCacheKB = gSettings.iconCacheKB;
+    scalars.showIconGrid = gSettings.showIconGrid ? 1 : 0;
+    scalars.tvRefresh = gSettings.tvRefresh;
+
+    out.clear();
+    out.resize(sizeof(PackedHeader));
+    const uint8_t* scalarBytes = reinterpret_cast<const uint8_t*>(&scalars);
+    out.insert(out.end(), scalarBytes, scalarBytes + sizeof(scalars));
+    appendArray(out, gSettings.categories);
+    appendArray(out, gSettings.recentLaunches);
+
+    std::vector<uint64_t> sortedFavorites = gSettings.favorites;
+    std::sort(sortedFavorites.begin(), sortedFavorites.end());
+    appendTitleIds(out, sortedFavorites);
+    appendAssignments(out);
+
+    PackedHeader header;
+    header.magic = PACKED_MAGIC;
+    header.version = CONFIG_VERSION;
+    header.payloadSize = static_cast<uint32_t>(out.size() - sizeof(PackedHeader));
+    header.checksum = checksumBytes(out.data() + sizeof(PackedHeader), header.payloadSize);
+    memcpy(out.data(), &header, sizeof(header));
+}
+
+/**
+ * Decode a packed record into gSettings.
+ *
+ * @return false (leaving gSettings untouched) if the record is damaged
+ */
+bool unpackSettings(const uint8_t* data, size_t size)
+{
+    PackedHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    const uint8_t* payload = data + sizeof(header);
+    size_t payloadSize = size - sizeof(header);
+    bool isV3Record = header.version == static_cast<uint32_t>(PACKED_CONFIG_VERSION);
+    size_t scalarsSize = sizeof(PackedScalars);
+    if (isV3Record) {
+        scalarsSize = V3_SCALARS_SIZE;
+    } else if (header.version < static_cast<uint32_t>(ICON_CACHE_CONFIG_VERSION)) {
+        scalarsSize = V4_SCALARS_SIZE;
+    } else if (header.version < static_cast<uint32_t>(ICON_GRID_CONFIG_VERSION)) {
+        scalarsSize = V5_SCALARS_SIZE;
+    } else if (header.version < static_cast<uint32_t>(TV_REFRESH_CONFIG_VERSION)) {
+        scalarsSize = V7_SCALARS_SIZE;
+    }
+    if (header.magic != PACKED_MAGIC ||
+        header.version < static_cast<uint32_t>(PACKED_CONFIG_VERSION) ||
+        header.version > static_cast<uint32_t>(CONFIG_VERSION) ||
+        header.payloadSize != payloadSize || payloadSize < scalarsSize ||
+        header.checksum != checksumBytes(payload, payloadSize)) {
+        return false;
+    }
+
+    PackedScalars scalars;
+    scalars.iconCacheKB = DEFAULT_ICON_CACHE_KB;
+    scalars.showIconGrid = 0;
+    scalars.tvRefresh = 1;
+    PackedCountsV3 v3Counts = {};
+    if (isV3Record) {
+        memcpy(&scalars, payload, V3_SHARED_SCALARS_SIZE);
+        memcpy(&v3Counts, payload + V3_SHARED_SCALARS_SIZE, sizeof(v3Counts));
+        scalars.categoryCount = v3Counts.categoryCount;
+        scalars.recentCount = v3Counts.recentCount;
+    } else {
+        memcpy(&scalars, payload, scalarsSize);
+    }
+    if (scalars.categoryCount > MAX_CATEGORIES || scalars.recentCount > MAX_RECENT_LAUNCHES) {
+        return false;
     }
 
-    // TODO: Handle version migration if version < CONFIG_VERSION
-    // For now, we just load what we can
+    // Decode into a copy so a short payload can't leave settings half-loaded
+    PluginSettings decoded = gSettings;
+    size_t offset = scalarsSize;
+    bool isComplete = isV3Record
+        ? readV3Arrays(payload, payloadSize, offset, v3Counts, decoded)
+        : readArray(payload, payloadSize, offset, scalars.categoryCount, decoded.categories) &&
+          readArray(payload, payloadSize, offset, scalars.recentCount, decoded.recentLaunches) &&
+          readTitleIds(payload, payloadSize, offset, MAX_FAVORITES, decoded.favorites) &&
+          readAssignments(payload, payloadSize, offset, decoded.categories, decoded.titleCategories);
+    if (!isComplete || offset != payloadSize) {
+        return false;
+    }
+
+    decoded.lastIndex = scalars.lastIndex;
+    decoded.lastCategoryIndex = scalars.lastCategoryIndex;
+    decoded.sortOrder = scalars.sortOrder;
+    decoded.bgColor = scalars.bgColor;
+    decoded.titleColor = scalars.titleColor;
+    decoded.highlightedTitleColor = scalars.highlightedTitleColor;
+    decoded.favoriteColor = scalars.favoriteColor;
+    decoded.headerColor = scalars.headerColor;
+    decoded.categoryColor = scalars.categoryColor;
+    decoded.layoutPrefs.fontScale = scalars.fontScale;
+    decoded.layoutPrefs.listWidthPercent = scalars.listWidthPercent;
+    decoded.layoutPrefs.iconSizePercent = scalars.iconSizePercent;
+    decoded.nextCategoryId = scalars.nextCategoryId;
+    decoded.showNumbers = scalars.showNumbers != 0;
+    decoded.showFavorites = scalars.showFavorites != 0;
+    decoded.showIconGrid = scalars.showIconGrid != 0;
+    decoded.iconCacheKB = scalars.iconCacheKB >= MIN_ICON_CACHE_KB && scalars.iconCacheKB <= MAX_ICON_CACHE_KB
+                              ? scalars.iconCacheKB
+                              : DEFAULT_ICON_CACHE_KB;
+    decoded.tvRefresh = scalars.tvRefresh >= TV_REFRESH_OFF && scalars.tvRefresh <= MAX_TV_FRAME_DIVISOR
+                            ? scalars.tvRefresh
+                            : 1;
+
+    gSettings = decoded;
+    rebuildFavoriteSet();
+    rebuildAssignmentIndex();
+    return true;
+}
 
+/**
+ * Read the packed record with a single storage call.
+ */
+bool loadPackedSettings()
+{
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(MAX_PACKED_SIZE));
+    if (!buffer) {
+        return false;
+    }
+
+    uint32_t readSize = 0;
+    bool isLoaded = WUPSStorageAPI_GetBinary(nullptr, KEY_SETTINGS_DATA, buffer,
+                                             MAX_PACKED_SIZE, &readSize) == WUPS_STORAGE_ERROR_SUCCESS &&
+                    unpackSettings(buffer, readSize);
+    if (isLoaded) {
+        gPersistedBlob.assign(buffer, buffer + readSize);
+        hasPersistedSettings = true;
+    }
+
+    free(buffer);
+    return isLoaded;
+}
+
+/**
+ * Read the per-key layout used up to config v2.
+ */
+void loadLegacyKeys()
+{
     // -------------------------------------------------------------------------
-    // Step 2: Load integer settings
+    // Step 1: Load integer settings
     // -------------------------------------------------------------------------
     WUPSStorageAPI_GetInt(nullptr, KEY_LAST_INDEX, &gSettings.lastIndex);
     WUPSStorageAPI_GetInt(nullptr, KEY_LAST_CATEGORY, &gSettings.lastCategoryIndex);
+    WUPSStorageAPI_GetInt(nullptr, KEY_SORT_ORDER, &gSettings.sortOrder);
 
     // -------------------------------------------------------------------------
-    // Step 3: Load boolean settings
+    // Step 2: Load boolean settings
     // -------------------------------------------------------------------------
     LoadBool(KEY_SHOW_NUMBERS, gSettings.showNumbers);
     LoadBool(KEY_SHOW_FAVORITES, gSettings.showFavorites);
 
     // -------------------------------------------------------------------------
-    // Step 4: Load colors
+    // Step 3: Load colors
     // -------------------------------------------------------------------------
     LoadColor(KEY_BG_COLOR, gSettings.bgColor);
     LoadColor(KEY_TITLE_COLOR, gSettings.titleColor);
@@ -142,7 +881,7 @@ void Load()
     LoadColor(KEY_CATEGORY_COLOR, gSettings.categoryColor);
 
     // -------------------------------------------------------------------------
-    // Step 5: Load layout preferences
+    // Step 4: Load layout preferences
     // -------------------------------------------------------------------------
     int32_t layoutTemp;
     if (WUPSStorageAPI_GetInt(nullptr, KEY_LAYOUT_FONT_SCALE, &layoutTemp) == WUPS_STORAGE_ERROR_SUCCESS) {
@@ -155,11 +894,8 @@ void Load()
         gSettings.layoutPrefs.iconSizePercent = layoutTemp;
     }
 
-    // Apply loaded layout preferences to the layout system
-    Layout::SetCurrentPreferences(gSettings.layoutPrefs);
-
     // -------------------------------------------------------------------------
-    // Step 6: Load next category ID
+    // Step 5: Load next category ID
     // -------------------------------------------------------------------------
     int32_t nextId;
     if (WUPSStorageAPI_GetInt(nullptr, KEY_NEXT_CAT_ID, &nextId) == WUPS_STORAGE_ERROR_SUCCESS) {
@@ -167,7 +903,7 @@ void Load()
     }
 
     // -------------------------------------------------------------------------
-    // Step 7: Load favorites
+    // Step 6: Load favorites
     // -------------------------------------------------------------------------
     // Favorites are stored as a binary blob (array of uint64_t)
     int32_t favCount = 0;
@@ -185,13 +921,14 @@ void Load()
             for (int32_t i = 0; i < favCount; i++) {
                 gSettings.favorites.push_back(favData[i]);
             }
+            rebuildFavoriteSet();
         }
 
         delete[] favData;
     }
 
     // -------------------------------------------------------------------------
-    // Step 8: Load categories
+    // Step 7: Load categories
     // -------------------------------------------------------------------------
     int32_t catCount = 0;
     WUPSStorageAPI_GetInt(nullptr, KEY_CATEGORIES_COUNT, &catCount);
@@ -213,7 +950,7 @@ void Load()
     }
 
     // -------------------------------------------------------------------------
-    // Step 9: Load title-category assignments
+    // Step 8: Load title-category assignments
     // -------------------------------------------------------------------------
     int32_t tcCount = 0;
     WUPSStorageAPI_GetInt(nullptr, KEY_TITLE_CAT_COUNT, &tcCount);
@@ -229,91 +966,126 @@ void Load()
             for (int32_t i = 0; i < tcCount; i++) {
                 gSettings.titleCategories.push_back(tcData[i]);
             }
+            rebuildAssignmentIndex();
         }
 
         delete[] tcData;
     }
 
-    gSettings.configVersion = version;
-}
-
-void Save()
-{
     // -------------------------------------------------------------------------
-    // Save version
+    // Step 9: Load launch history
     // -------------------------------------------------------------------------
-    WUPSStorageAPI_StoreInt(nullptr, KEY_VERSION, CONFIG_VERSION);
+    int32_t recentCount = 0;
+    WUPSStorageAPI_GetInt(nullptr, KEY_RECENT_COUNT, &recentCount);
 
-    // -------------------------------------------------------------------------
-    // Save integer settings
-    // -------------------------------------------------------------------------
-    WUPSStorageAPI_StoreInt(nullptr, KEY_LAST_INDEX, gSettings.lastIndex);
-    WUPSStorageAPI_StoreInt(nullptr, KEY_LAST_CATEGORY, gSettings.lastCategoryIndex);
-    WUPSStorageAPI_StoreInt(nullptr, KEY_NEXT_CAT_ID, gSettings.nextCategoryId);
+    if (recentCount > 0 && recentCount <= MAX_RECENT_LAUNCHES) {
+        uint64_t recentData[MAX_RECENT_LAUNCHES];
+        uint32_t maxSize = recentCount * sizeof(uint64_t);
+        uint32_t readSize = 0;
 
-    // -------------------------------------------------------------------------
-    // Save boolean settings (stored as int: 0=false, 1=true)
-    // -------------------------------------------------------------------------
-    WUPSStorageAPI_StoreInt(nullptr, KEY_SHOW_NUMBERS, gSettings.showNumbers ? 1 : 0);
-    WUPSStorageAPI_StoreInt(nullptr, KEY_SHOW_FAVORITES, gSettings.showFavorites ? 1 : 0);
+        if (WUPSStorageAPI_GetBinary(nullptr, KEY_RECENT_DATA, recentData,
+                                      maxSize, &readSize) == WUPS_STORAGE_ERROR_SUCCESS) {
+            gSettings.recentLaunches.assign(recentData, recentData + recentCount);
+        }
+    }
+}
 
-    // -------------------------------------------------------------------------
-    // Save colors (cast to signed for storage)
-    // -------------------------------------------------------------------------
-    WUPSStorageAPI_StoreInt(nullptr, KEY_BG_COLOR, static_cast<int32_t>(gSettings.bgColor));
-    WUPSStorageAPI_StoreInt(nullptr, KEY_TITLE_COLOR, static_cast<int32_t>(gSettings.titleColor));
-    WUPSStorageAPI_StoreInt(nullptr, KEY_HIGHLIGHTED, static_cast<int32_t>(gSettings.highlightedTitleColor));
-    WUPSStorageAPI_StoreInt(nullptr, KEY_FAVORITE_COLOR, static_cast<int32_t>(gSettings.favoriteColor));
-    WUPSStorageAPI_StoreInt(nullptr, KEY_HEADER_COLOR, static_cast<int32_t>(gSettings.headerColor));
-    WUPSStorageAPI_StoreInt(nullptr, KEY_CATEGORY_COLOR, static_cast<int32_t>(gSettings.categoryColor));
+} // anonymous namespace
 
-    // -------------------------------------------------------------------------
-    // Save layout preferences
-    // -------------------------------------------------------------------------
-    WUPSStorageAPI_StoreInt(nullptr, KEY_LAYOUT_FONT_SCALE, gSettings.layoutPrefs.fontScale);
-    WUPSStorageAPI_StoreInt(nullptr, KEY_LAYOUT_LIST_WIDTH, gSettings.layoutPrefs.listWidthPercent);
-    WUPSStorageAPI_StoreInt(nullptr, KEY_LAYOUT_ICON_SIZE, gSettings.layoutPrefs.iconSizePercent);
+// =============================================================================
+// Core Functions Implementation
+// =============================================================================
+
+void Init()
+{
+    // Initialize with default values
+    gSettings = PluginSettings();
+    rebuildFavoriteSet();
+    rebuildAssignmentIndex();
+    hasPersistedSettings = false;
+    isCategoryOrderValid = false;
+    gMembershipGeneration++;
+}
+
+void Load()
+{
+    isCategoryOrderValid = false;
+    gMembershipGeneration++;
 
     // -------------------------------------------------------------------------
-    // Save favorites
+    // Step 1: Check for existing settings and their version
     // -------------------------------------------------------------------------
-    int32_t favCount = static_cast<int32_t>(gSettings.favorites.size());
-    WUPSStorageAPI_StoreInt(nullptr, KEY_FAVORITES_COUNT, favCount);
+    int32_t version = 0;
+    WUPSStorageAPI_GetInt(nullptr, KEY_VERSION, &version);
 
-    if (favCount > 0) {
-        WUPSStorageAPI_StoreBinary(nullptr, KEY_FAVORITES_DATA,
-                                   gSettings.favorites.data(),
-                                   favCount * sizeof(uint64_t));
+    if (version == 0) {
+        // No saved settings found - keep defaults
+        return;
     }
 
-    // -------------------------------------------------------------------------
-    // Save categories
-    // -------------------------------------------------------------------------
-    int32_t catCount = static_cast<int32_t>(gSettings.categories.size());
-    WUPSStorageAPI_StoreInt(nullptr, KEY_CATEGORIES_COUNT, catCount);
+    if (version < PACKED_CONFIG_VERSION || !loadPackedSettings()) {
+        // Older configs (and a damaged packed record) fall back to the
+        // per-key layout; the next Save() rewrites them as one record
+        loadLegacyKeys();
+        gPersistedBlob.clear();
+        hasPersistedSettings = false;
+    }
 
-    if (catCount > 0) {
-        WUPSStorageAPI_StoreBinary(nullptr, KEY_CATEGORIES_DATA,
-                                   gSettings.categories.data(),
-                                   catCount * sizeof(Category));
+    // A user category selected before Recent existed is one further on
+    if (version < RECENT_CATEGORY_CONFIG_VERSION && gSettings.lastCategoryIndex >= RECENT_CATEGORY_INDEX) {
+        gSettings.lastCategoryIndex++;
     }
 
-    // -------------------------------------------------------------------------
-    // Save title-category assignments
-    // -------------------------------------------------------------------------
-    int32_t tcCount = static_cast<int32_t>(gSettings.titleCategories.size());
-    WUPSStorageAPI_StoreInt(nullptr, KEY_TITLE_CAT_COUNT, tcCount);
+    // Apply loaded layout preferences to the layout system
+    Layout::SetCurrentPreferences(gSettings.layoutPrefs);
 
-    if (tcCount > 0) {
-        WUPSStorageAPI_StoreBinary(nullptr, KEY_TITLE_CAT_DATA,
-                                   gSettings.titleCategories.data(),
-                                   tcCount * sizeof(TitleCategoryAssignment));
+    gSettings.configVersion = version;
+}
+
+void Save()
+{
+    TRACE_SCOPE("Settings save");
+
+    // The whole config is one record; skip the write (and the SD flush)
+    // when it comes out identical to what storage already holds
+    std::vector<uint8_t> packed;
+    packed.reserve(gPersistedBlob.size());
+    packSettings(packed);
+    if (hasPersistedSettings && packed == gPersistedBlob) {
+        return;
+    }
+
+    if (!hasPersistedSettings || gSettings.configVersion != CONFIG_VERSION) {
+        WUPSStorageAPI_StoreInt(nullptr, KEY_VERSION, CONFIG_VERSION);
+        gSettings.configVersion = CONFIG_VERSION;
     }
+    WUPSStorageAPI_StoreBinary(nullptr, KEY_SETTINGS_DATA, packed.data(),
+                               static_cast<uint32_t>(packed.size()));
+    gPersistedBlob.swap(packed);
+    hasPersistedSettings = true;
 
     // -------------------------------------------------------------------------
     // Flush to SD card
     // -------------------------------------------------------------------------
-    WUPSStorageAPI_SaveStorage(false);
+    if (gFlushBackend) {
+        gFlushBackend->requestFlush();
+    } else {
+        WUPSStorageAPI_SaveStorage(false);
+    }
+}
+
+void Flush()
+{
+    if (gFlushBackend) {
+        gFlushBackend->waitForFlush();
+    }
+}
+
+void SetFlushBackend(const FlushBackend* backend)
+{
+    // Don't strand a flush the previous backend still owes
+    Flush();
+    gFlushBackend = backend;
 }
 
 PluginSettings& Get()
@@ -324,6 +1096,10 @@ PluginSettings& Get()
 void ResetToDefaults()
 {
     gSettings = PluginSettings();
+    rebuildFavoriteSet();
+    rebuildAssignmentIndex();
+    isCategoryOrderValid = false;
+    gMembershipGeneration++;
 }
 
 // =============================================================================
@@ -332,9 +1108,7 @@ void ResetToDefaults()
 
 bool IsFavorite(uint64_t titleId)
 {
-    return std::find(gSettings.favorites.begin(),
-                     gSettings.favorites.end(),
-                     titleId) != gSettings.favorites.end();
+    return gFavoriteSlots[findFavoriteSlot(titleId)] != EMPTY_FAVORITE_SLOT;
 }
 
 void ToggleFavorite(uint64_t titleId)
@@ -349,7 +1123,8 @@ void ToggleFavorite(uint64_t titleId)
 void AddFavorite(uint64_t titleId)
 {
     // Check if already favorited
-    if (IsFavorite(titleId)) {
+    int slot = findFavoriteSlot(titleId);
+    if (gFavoriteSlots[slot] != EMPTY_FAVORITE_SLOT) {
         return;
     }
 
@@ -359,17 +1134,65 @@ void AddFavorite(uint64_t titleId)
     }
 
     gSettings.favorites.push_back(titleId);
+    gFavoriteSlots[slot] = static_cast<uint16_t>(gSettings.favorites.size());
+    gMembershipGeneration++;
 }
 
 void RemoveFavorite(uint64_t titleId)
 {
-    auto it = std::find(gSettings.favorites.begin(),
-                        gSettings.favorites.end(),
-                        titleId);
+    int slot = findFavoriteSlot(titleId);
+    if (gFavoriteSlots[slot] == EMPTY_FAVORITE_SLOT) {
+        return;
+    }
 
-    if (it != gSettings.favorites.end()) {
-        gSettings.favorites.erase(it);
+    // Fill the hole with the last favorite instead of shifting the rest;
+    // favorites are unordered, as stored on disk
+    std::vector<uint64_t>& favorites = gSettings.favorites;
+    int position = gFavoriteSlots[slot] - 1;
+    clearFavoriteSlot(slot);
+
+    int lastPosition = static_cast<int>(favorites.size()) - 1;
+    if (position != lastPosition) {
+        uint64_t movedTitleId = favorites[lastPosition];
+        gFavoriteSlots[findFavoriteSlot(movedTitleId)] = static_cast<uint16_t>(position + 1);
+        favorites[position] = movedTitleId;
     }
+    favorites.pop_back();
+    gMembershipGeneration++;
+}
+
+// =============================================================================
+// Launch History Implementation
+// =============================================================================
+
+void RecordLaunch(uint64_t titleId)
+{
+    auto& recent = gSettings.recentLaunches;
+
+    auto it = std::find(recent.begin(), recent.end(), titleId);
+    if (it != recent.end()) {
+        recent.erase(it);
+    }
+
+    recent.insert(recent.begin(), titleId);
+
+    if (recent.size() > MAX_RECENT_LAUNCHES) {
+        recent.resize(MAX_RECENT_LAUNCHES);
+    }
+
+    // The Recent category is built from this list
+    gMembershipGeneration++;
+}
+
+int GetLaunchRank(uint64_t titleId)
+{
+    const auto& recent = gSettings.recentLaunches;
+
+    auto it = std::find(recent.begin(), recent.end(), titleId);
+    if (it == recent.end()) {
+        return -1;
+    }
+    return static_cast<int>(it - recent.begin());
 }
 
 // =============================================================================
@@ -391,6 +1214,7 @@ uint16_t CreateCategory(const char* name)
     newCat.name[MAX_CATEGORY_NAME - 1] = '\0';
 
     gSettings.categories.push_back(newCat);
+    isCategoryOrderValid = false;
     return newCat.id;
 }
 
@@ -405,17 +1229,28 @@ void DeleteCategory(uint16_t categoryId)
 
     if (catIt != gSettings.categories.end()) {
         gSettings.categories.erase(catIt);
+        isCategoryOrderValid = false;
     }
 
-    // Remove all title assignments for this category
-    gSettings.titleCategories.erase(
-        std::remove_if(gSettings.titleCategories.begin(),
-                       gSettings.titleCategories.end(),
-                       [categoryId](const TitleCategoryAssignment& tc) {
-                           return tc.categoryId == categoryId;
-                       }),
-        gSettings.titleCategories.end()
-    );
+    // Remove all title assignments for this category, highest record
+    // first: each removal moves the last record down, which is then never
+    // one still waiting to be removed
+    AssignmentChain* chain = findAssignmentChain(gCategoryChains, categoryId, false);
+    if (chain) {
+        int16_t records[MAX_TITLE_CATEGORIES];
+        int recordCount = 0;
+        for (int16_t record = chain->first; record != NO_ASSIGNMENT; record = gNextForCategory[record]) {
+            records[recordCount++] = record;
+        }
+
+        std::sort(records, records + recordCount, [](int16_t first, int16_t second) {
+            return first > second;
+        });
+        for (int recordIndex = 0; recordIndex < recordCount; recordIndex++) {
+            removeAssignmentAt(records[recordIndex]);
+        }
+    }
+    gMembershipGeneration++;
 }
 
 void RenameCategory(uint16_t categoryId, const char* newName)
@@ -424,6 +1259,7 @@ void RenameCategory(uint16_t categoryId, const char* newName)
         if (cat.id == categoryId) {
             strncpy(cat.name, newName, MAX_CATEGORY_NAME - 1);
             cat.name[MAX_CATEGORY_NAME - 1] = '\0';
+            gMembershipGeneration++;
             return;
         }
     }
@@ -446,8 +1282,13 @@ int GetCategoryCount()
 
 bool TitleHasCategory(uint64_t titleId, uint16_t categoryId)
 {
-    for (const auto& tc : gSettings.titleCategories) {
-        if (tc.titleId == titleId && tc.categoryId == categoryId) {
+    AssignmentChain* chain = findAssignmentChain(gTitleChains, titleId, false);
+    if (!chain) {
+        return false;
+    }
+
+    for (int16_t record = chain->first; record != NO_ASSIGNMENT; record = gNextForTitle[record]) {
+        if (gSettings.titleCategories[record].categoryId == categoryId) {
             return true;
         }
     }
@@ -466,31 +1307,50 @@ void AssignTitleToCategory(uint64_t titleId, uint16_t categoryId)
         return;
     }
 
+    // Keys of emptied chains linger; compact before a new key could
+    // push either table past half load
+    if (gTitleChains.usedCount >= TITLE_CHAIN_SLOT_COUNT / 2 ||
+        gCategoryChains.usedCount >= CATEGORY_CHAIN_SLOT_COUNT / 2) {
+        rebuildAssignmentIndex();
+    }
+
     TitleCategoryAssignment assignment;
     assignment.titleId = titleId;
     assignment.categoryId = categoryId;
     gSettings.titleCategories.push_back(assignment);
+    linkLastAssignment();
+    gMembershipGeneration++;
 }
 
 void RemoveTitleFromCategory(uint64_t titleId, uint16_t categoryId)
 {
-    gSettings.titleCategories.erase(
-        std::remove_if(gSettings.titleCategories.begin(),
-                       gSettings.titleCategories.end(),
-                       [titleId, categoryId](const TitleCategoryAssignment& tc) {
-                           return tc.titleId == titleId && tc.categoryId == categoryId;
-                       }),
-        gSettings.titleCategories.end()
-    );
+    AssignmentChain* chain = findAssignmentChain(gTitleChains, titleId, false);
+    for (int16_t record = chain ? chain->first : NO_ASSIGNMENT; record != NO_ASSIGNMENT;
+         record = gNextForTitle[record]) {
+        if (gSettings.titleCategories[record].categoryId == categoryId) {
+            removeAssignmentAt(record);
+            break;
+        }
+    }
+    gMembershipGeneration++;
+}
+
+uint32_t GetMembershipGeneration()
+{
+    return gMembershipGeneration;
 }
 
 int GetCategoriesForTitle(uint64_t titleId, uint16_t* outIds, int maxIds)
 {
+    AssignmentChain* chain = findAssignmentChain(gTitleChains, titleId, false);
+    if (!chain) {
+        return 0;
+    }
+
     int count = 0;
-    for (const auto& tc : gSettings.titleCategories) {
-        if (tc.titleId == titleId && count < maxIds) {
-            outIds[count++] = tc.categoryId;
-        }
+    for (int16_t record = chain->first; record != NO_ASSIGNMENT && count < maxIds;
+         record = gNextForTitle[record]) {
+        outIds[count++] = gSettings.titleCategories[record].categoryId;
     }
     return count;
 }
@@ -504,6 +1364,7 @@ void SetCategoryHidden(uint16_t categoryId, bool hidden)
     for (auto& cat : gSettings.categories) {
         if (cat.id == categoryId) {
             cat.hidden = hidden;
+            isCategoryOrderValid = false;
             return;
         }
     }
@@ -536,6 +1397,8 @@ void MoveCategoryUp(uint16_t categoryId)
 
     // Swap with previous category
     std::swap(cats[idx], cats[idx - 1]);
+    isCategoryOrderValid = false;
+    gMembershipGeneration++;
 }
 
 void MoveCategoryDown(uint16_t categoryId)
@@ -555,19 +1418,43 @@ void MoveCategoryDown(uint16_t categoryId)
 
     // Swap with next category
     std::swap(cats[idx], cats[idx + 1]);
+    isCategoryOrderValid = false;
+    gMembershipGeneration++;
 }
 
-int GetSortedCategoryIndices(int* outIndices, int maxCount, bool includeHidden)
+const int* GetCategoryOrder(bool includeHidden, int* outCount)
 {
-    int count = 0;
-    const auto& cats = gSettings.categories;
-
-    for (size_t i = 0; i < cats.size() && count < maxCount; i++) {
-        if (includeHidden || !cats[i].hidden) {
-            outIndices[count++] = static_cast<int>(i);
+    if (!isCategoryOrderValid) {
+        // The vector is kept in display order, so this is a filter, not a sort
+        const auto& cats = gSettings.categories;
+        int categoryCount = std::min(static_cast<int>(cats.size()), MAX_CATEGORIES);
+
+        gCategoryOrderCount = 0;
+        gVisibleCategoryOrderCount = 0;
+        for (int i = 0; i < categoryCount; i++) {
+            gCategoryOrder[gCategoryOrderCount++] = i;
+            if (!cats[i].hidden) {
+                gVisibleCategoryOrder[gVisibleCategoryOrderCount++] = i;
+            }
         }
+        isCategoryOrderValid = true;
+    }
+
+    if (includeHidden) {
+        *outCount = gCategoryOrderCount;
+        return gCategoryOrder;
     }
+    *outCount = gVisibleCategoryOrderCount;
+    return gVisibleCategoryOrder;
+}
+
+int GetSortedCategoryIndices(int* outIndices, int maxCount, bool includeHidden)
+{
+    int orderCount = 0;
+    const int* order = GetCategoryOrder(includeHidden, &orderCount);
 
+    int count = std::min(orderCount, maxCount);
+    std::copy(order, order + count, outIndices);
     return count;
 }
 
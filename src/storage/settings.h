@@ -59,14 +59,14 @@ namespace Settings {
 
 // Current settings version - increment this when the storage format changes
 // Old versions will be detected and migrated (or reset to defaults)
-constexpr int32_t CONFIG_VERSION = 2;
+constexpr int32_t CONFIG_VERSION = 8;
 
 // =============================================================================
 // Limits
 // =============================================================================
 
 // Maximum number of favorites a user can have
-constexpr int MAX_FAVORITES = 64;
+constexpr int MAX_FAVORITES = 1024;
 
 // Maximum number of custom categories
 constexpr int MAX_CATEGORIES = 16;
@@ -76,7 +76,26 @@ constexpr int MAX_CATEGORY_NAME = 32;
 
 // Maximum number of title-to-category assignments
 // (titles can belong to multiple categories)
-constexpr int MAX_TITLE_CATEGORIES = 512;
+constexpr int MAX_TITLE_CATEGORIES = 2048;
+
+// Maximum number of recently launched titles remembered (most recent first)
+constexpr int MAX_RECENT_LAUNCHES = 32;
+
+// Memory budget for decoded icons, in KB; the settings panel steps it by
+// doubling from the minimum
+constexpr int32_t DEFAULT_ICON_CACHE_KB = 4096;
+constexpr int32_t MIN_ICON_CACHE_KB = 1024;
+constexpr int32_t MAX_ICON_CACHE_KB = 16384;
+
+// How often the TV is redrawn (see Renderer::TVPacing): every Nth frame
+// for N from 1 to MAX_TV_FRAME_DIVISOR, or one of these
+constexpr int32_t TV_REFRESH_ON_CHANGE = 0;
+constexpr int32_t TV_REFRESH_OFF = -1;
+constexpr int32_t MAX_TV_FRAME_DIVISOR = 4;
+
+// Bit set in a title's category mask (see GetMembershipGeneration) when the
+// title is a favorite; bits 0-15 are user categories by list position
+constexpr uint32_t FAVORITE_MASK_BIT = 1u << 31;
 
 // =============================================================================
 // Default Colors
@@ -170,6 +189,9 @@ struct PluginSettings {
     // Last selected category index
     int32_t lastCategoryIndex;
 
+    // Title list sort order (a Titles::SortOrder value)
+    int32_t sortOrder;
+
     // -------------------------------------------------------------------------
     // Display Options
     // -------------------------------------------------------------------------
@@ -182,6 +204,21 @@ struct PluginSettings {
     // Default: true (on) - can be turned off since favorites category exists
     bool showFavorites;
 
+    // Browse titles as a grid of icons instead of the list and details
+    // Default: false (off)
+    bool showIconGrid;
+
+    // Memory kept for decoded icons, in KB (MIN_ICON_CACHE_KB to
+    // MAX_ICON_CACHE_KB)
+    // Default: DEFAULT_ICON_CACHE_KB
+    int32_t iconCacheKB;
+
+    // How often the TV is redrawn: 1 to MAX_TV_FRAME_DIVISOR (every Nth
+    // frame), TV_REFRESH_ON_CHANGE or TV_REFRESH_OFF. The GamePad is
+    // redrawn every frame regardless
+    // Default: 1 (every frame)
+    int32_t tvRefresh;
+
     // -------------------------------------------------------------------------
     // Layout Preferences
     // -------------------------------------------------------------------------
@@ -204,8 +241,10 @@ struct PluginSettings {
     // Favorites
     // -------------------------------------------------------------------------
 
-    // List of favorited title IDs
+    // List of favorited title IDs, in no particular order
     // Using vector for convenience; stored as binary blob in WUPS storage
+    // Modify only through the favorites functions, which keep a lookup
+    // set in sync with it
     std::vector<uint64_t> favorites;
 
     // -------------------------------------------------------------------------
@@ -215,12 +254,21 @@ struct PluginSettings {
     // User-defined categories
     std::vector<Category> categories;
 
-    // Title-to-category assignments
+    // Title-to-category assignments, in no particular order
+    // Modify only through the category functions, which keep per-title and
+    // per-category indexes in sync with it
     std::vector<TitleCategoryAssignment> titleCategories;
 
     // Next category ID to assign (incremented each time a category is created)
     uint16_t nextCategoryId;
 
+    // -------------------------------------------------------------------------
+    // Launch History
+    // -------------------------------------------------------------------------
+
+    // Recently launched title IDs, most recent first
+    std::vector<uint64_t> recentLaunches;
+
     // -------------------------------------------------------------------------
     // Constructor with defaults
     // -------------------------------------------------------------------------
@@ -229,8 +277,12 @@ struct PluginSettings {
         configVersion(CONFIG_VERSION),
         lastIndex(0),
         lastCategoryIndex(0),
+        sortOrder(0),
         showNumbers(false),
         showFavorites(true),
+        showIconGrid(false),
+        iconCacheKB(DEFAULT_ICON_CACHE_KB),
+        tvRefresh(1),
         layoutPrefs(Layout::LayoutPreferences::Default()),
         bgColor(DEFAULT_BG_COLOR),
         titleColor(DEFAULT_TITLE_COLOR),
@@ -259,7 +311,12 @@ void Init();
  *
  * Reads settings from the WUPS storage (SD card).
  * If no saved settings exist, defaults are used.
- * If settings version is old, migration may be performed.
+ *
+ * Config v3 and later read everything with one storage call and verify
+ * a checksum. v3 records, with favorites and assignments uncompressed,
+ * still decode, and records older than v5 predate iconCacheKB, which
+ * keeps its default. Older configs, or a record that fails the check,
+ * are read from the per-key layout instead; the next Save() migrates them.
  *
  * Call this once at plugin startup, after Init().
  */
@@ -271,11 +328,43 @@ void Load();
  * Writes current settings to the WUPS storage (SD card).
  * Call this after modifying settings that should persist.
  *
+ * All settings are written as one packed record. Nothing is written or
+ * flushed if the record matches what the last Load() or Save() saw.
+ *
+ * With a flush backend installed (see SetFlushBackend), the SD write is
+ * handed off and Save() returns once the record is staged; call
+ * Flush() where the data must be on the card.
+ *
  * NOTE: Saving is not instantaneous - it writes to SD card.
  *       Avoid calling this every frame; batch changes and save once.
  */
 void Save();
 
+/**
+ * Wait until every Save() so far has reached the SD card.
+ *
+ * A no-op without a flush backend, since Save() then flushes itself.
+ */
+void Flush();
+
+/**
+ * Hooks that take the SD flush off Save()'s caller.
+ */
+struct FlushBackend {
+    // Called by Save() after staging changes, instead of flushing
+    void (*requestFlush)();
+
+    // Called by Flush(); returns once every requested flush is done
+    void (*waitForFlush)();
+};
+
+/**
+ * Install (or, with nullptr, remove) a flush backend.
+ *
+ * @param backend Hooks to use; must outlive its installation
+ */
+void SetFlushBackend(const FlushBackend* backend);
+
 /**
  * Get a reference to the settings structure.
  *
@@ -301,6 +390,8 @@ void ResetToDefaults();
 /**
  * Check if a title is favorited.
  *
+ * Constant time; safe to call per row per frame.
+ *
  * @param titleId The title to check
  * @return true if the title is in the favorites list
  */
@@ -328,12 +419,36 @@ void AddFavorite(uint64_t titleId);
 /**
  * Remove a title from favorites.
  *
- * No-op if not currently favorited.
+ * No-op if not currently favorited. The last favorite takes the removed
+ * one's place in the list.
  *
  * @param titleId The title to unfavorite
  */
 void RemoveFavorite(uint64_t titleId);
 
+// =============================================================================
+// Launch History Functions
+// =============================================================================
+
+/**
+ * Record that a title was launched.
+ *
+ * Moves the title to the front of the recent list, dropping the oldest
+ * entry when the list is full.
+ * Does NOT automatically save - call Save() when appropriate.
+ *
+ * @param titleId The title being launched
+ */
+void RecordLaunch(uint64_t titleId);
+
+/**
+ * Get how recently a title was launched.
+ *
+ * @param titleId The title to check
+ * @return 0 for the most recent launch, or -1 if not in the recent list
+ */
+int GetLaunchRank(uint64_t titleId);
+
 // =============================================================================
 // Category Functions
 // =============================================================================
@@ -416,6 +531,20 @@ void RemoveTitleFromCategory(uint64_t titleId, uint16_t categoryId);
  */
 int GetCategoriesForTitle(uint64_t titleId, uint16_t* outIds, int maxIds);
 
+/**
+ * Get a counter that changes whenever title membership may have changed.
+ *
+ * Bumped by favorite changes, category assignment and removal, category
+ * deletion, renaming and reordering, RecordLaunch(), Load() and
+ * ResetToDefaults(). Caches
+ * derived from favorites or categories (like the per-title category masks
+ * kept by the title store, or the browse panel's details) compare it to
+ * know when to rebuild.
+ *
+ * @return Current generation (starts at 1 and only changes by incrementing)
+ */
+uint32_t GetMembershipGeneration();
+
 // =============================================================================
 // Category Visibility and Ordering
 // =============================================================================
@@ -450,9 +579,22 @@ void MoveCategoryUp(uint16_t categoryId);
  */
 void MoveCategoryDown(uint16_t categoryId);
 
+/**
+ * Get categories in display order without copying.
+ * Returns indices into the categories vector. The array is cached and
+ * only rebuilt after CreateCategory, DeleteCategory, MoveCategoryUp/Down,
+ * SetCategoryHidden, Init, Load or ResetToDefaults, so it is cheap to
+ * walk every frame. It stays valid until one of those is called.
+ *
+ * @param includeHidden If true, include hidden categories
+ * @param outCount Receives the number of indices
+ * @return Cached array of indices
+ */
+const int* GetCategoryOrder(bool includeHidden, int* outCount);
+
 /**
  * Get categories sorted by display order.
- * Returns indices into the categories vector.
+ * Returns indices into the categories vector; a copy of GetCategoryOrder().
  *
  * @param outIndices Array to receive sorted indices
  * @param maxCount Maximum number of indices to return
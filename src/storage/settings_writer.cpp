@@ -0,0 +1,149 @@
+/**
+ * Background Settings Writer Implementation
+ *
+ * See settings_writer.h for usage documentation.
+ */
+
+#include "settings_writer.h"
+#include "settings.h"
+#include "../utils/worker_threads.h"
+
+#include <wups/storage.h>
+#include <coreinit/event.h>
+#include <coreinit/mutex.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+
+#include <cstdlib>
+#include <malloc.h>
+
+namespace SettingsWriter {
+
+namespace {
+
+constexpr int WRITER_STACK_SIZE = 8 * 1024;
+OSThread* writerThread = nullptr;
+uint8_t* writerStack = nullptr;
+
+// Guards the handoff flags below between Save() and the worker
+OSMutex stateMutex;
+bool hasPendingFlush = false;
+bool isWriterRunning = false;
+
+// Signaled by Flush() to end the coalescing window early
+OSEvent wakeEvent;
+
+bool isInitialized = false;
+
+int writerThreadEntry(int, const char**)
+{
+    for (;;) {
+        // Requests arriving while we wait join this flush
+        OSWaitEventWithTimeout(&wakeEvent, OSMillisecondsToTicks(COALESCE_WINDOW_MS));
+
+        OSLockMutex(&stateMutex);
+        if (!hasPendingFlush) {
+            isWriterRunning = false;
+            OSUnlockMutex(&stateMutex);
+            return 0;
+        }
+        hasPendingFlush = false;
+        OSUnlockMutex(&stateMutex);
+
+        WUPSStorageAPI_SaveStorage(false);
+    }
+}
+
+void joinWriterThread()
+{
+    if (!writerThread) {
+        return;
+    }
+
+    int threadResult = 0;
+    OSJoinThread(writerThread, &threadResult);
+    free(writerThread);
+    free(writerStack);
+    writerThread = nullptr;
+    writerStack = nullptr;
+}
+
+void requestFlush()
+{
+    OSLockMutex(&stateMutex);
+    hasPendingFlush = true;
+    bool needsWriter = !isWriterRunning;
+    isWriterRunning = true;
+    OSUnlockMutex(&stateMutex);
+
+    if (!needsWriter) {
+        return;
+    }
+
+    // The previous worker has already decided to exit
+    joinWriterThread();
+
+    writerThread = static_cast<OSThread*>(memalign(16, sizeof(OSThread)));
+    writerStack = static_cast<uint8_t*>(memalign(16, WRITER_STACK_SIZE));
+
+    bool isCreated = writerThread && writerStack &&
+                     OSCreateThread(writerThread, writerThreadEntry, 0, nullptr,
+                                    writerStack + WRITER_STACK_SIZE, WRITER_STACK_SIZE,
+                                    24, WorkerThreads::GetAffinity());
+    if (!isCreated) {
+        free(writerThread);
+        free(writerStack);
+        writerThread = nullptr;
+        writerStack = nullptr;
+
+        OSLockMutex(&stateMutex);
+        hasPendingFlush = false;
+        isWriterRunning = false;
+        OSUnlockMutex(&stateMutex);
+
+        WUPSStorageAPI_SaveStorage(false);
+        return;
+    }
+
+    OSSetThreadName(writerThread, "TitleSwitcher Settings");
+    OSResumeThread(writerThread);
+}
+
+void waitForFlush()
+{
+    // The worker drains every pending request before it sees the window
+    // is over, then exits
+    OSSignalEvent(&wakeEvent);
+    joinWriterThread();
+    OSResetEvent(&wakeEvent);
+}
+
+const Settings::FlushBackend backend = { requestFlush, waitForFlush };
+
+} // anonymous namespace
+
+void Init()
+{
+    if (isInitialized) {
+        return;
+    }
+
+    OSInitMutex(&stateMutex);
+    OSInitEvent(&wakeEvent, FALSE, OS_EVENT_MODE_MANUAL);
+    isInitialized = true;
+
+    Settings::SetFlushBackend(&backend);
+}
+
+void Shutdown()
+{
+    if (!isInitialized) {
+        return;
+    }
+
+    // Flushes through waitForFlush() before falling back to synchronous
+    Settings::SetFlushBackend(nullptr);
+    isInitialized = false;
+}
+
+} // namespace SettingsWriter
@@ -0,0 +1,51 @@
+/**
+ * Background Settings Writer
+ *
+ * Moves the SD card write behind Settings::Save() onto a worker thread, so
+ * closing the menu to launch a title doesn't wait for the card.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Settings::Save() still stages the settings record on the calling thread
+ * (that only touches WUPS storage in memory). Instead of flushing, it asks
+ * this module for a flush. The first request starts a worker that waits a
+ * short coalescing window, then calls WUPSStorageAPI_SaveStorage() once
+ * for every request that arrived in the meantime. The worker exits when a
+ * window passes with no new requests.
+ *
+ * Settings::Flush() cuts the window short and returns only after the last
+ * requested write has finished, for points like ON_APPLICATION_ENDS where
+ * the data must be on the card.
+ *
+ * USAGE:
+ * ------
+ *   // At plugin startup, after Settings::Load()
+ *   SettingsWriter::Init();
+ *
+ *   Settings::AddFavorite(titleId);
+ *   Settings::Save();    // Returns without touching the SD card
+ *
+ *   Settings::Flush();   // Blocks until the write is done
+ *
+ *   // At plugin shutdown
+ *   SettingsWriter::Shutdown();
+ */
+
+#pragma once
+
+namespace SettingsWriter {
+
+// How long a flush request waits for more requests to join it
+constexpr int COALESCE_WINDOW_MS = 500;
+
+/**
+ * Install the background writer as the settings flush backend.
+ */
+void Init();
+
+/**
+ * Flush anything pending and go back to synchronous saves.
+ */
+void Shutdown();
+
+} // namespace SettingsWriter
@@ -0,0 +1,67 @@
+/**
+ * Title Collation Implementation
+ *
+ * See title_collation.h for usage documentation.
+ */
+
+#include "title_collation.h"
+
+#include <cctype>
+#include <cstring>
+#include <strings.h>
+#include <algorithm>
+
+namespace TitleCollation {
+
+uint64_t ComputeKey(const char* name)
+{
+    uint64_t key = 0;
+    int byteIndex = 0;
+    for (; byteIndex < 8 && name[byteIndex] != '\0'; byteIndex++) {
+        uint8_t foldedByte = static_cast<uint8_t>(tolower(static_cast<unsigned char>(name[byteIndex])));
+        key = (key << 8) | foldedByte;
+    }
+    return key << ((8 - byteIndex) * 8);
+}
+
+bool NameOrder::operator()(uint16_t firstRecord, uint16_t secondRecord) const
+{
+    uint64_t firstKey = keys[firstRecord];
+    uint64_t secondKey = keys[secondRecord];
+    if (firstKey != secondKey) {
+        return firstKey < secondKey;
+    }
+
+    int nameComparison = strcasecmp(records[firstRecord].name, records[secondRecord].name);
+    if (nameComparison != 0) {
+        return nameComparison < 0;
+    }
+    return firstRecord < secondRecord;
+}
+
+void SortByName(uint16_t* order, int count, const uint64_t* keys,
+                const Titles::TitleInfo* records, SortStats* outStats)
+{
+    for (int recordIndex = 0; recordIndex < count; recordIndex++) {
+        order[recordIndex] = static_cast<uint16_t>(recordIndex);
+    }
+
+    NameOrder isOrderedBefore{keys, records};
+    if (!outStats) {
+        std::sort(order, order + count, isOrderedBefore);
+        return;
+    }
+
+    // Counting costs a branch per comparison, so only when asked
+    *outStats = SortStats();
+    std::sort(order, order + count,
+        [&isOrderedBefore, keys, outStats](uint16_t firstRecord, uint16_t secondRecord) {
+            outStats->comparisons++;
+            if (keys[firstRecord] == keys[secondRecord]) {
+                outStats->nameComparisons++;
+            }
+            return isOrderedBefore(firstRecord, secondRecord);
+        });
+}
+
+} // namespace TitleCollation
@@ -0,0 +1,52 @@
+/**
+ * Title Collation
+ *
+ * The order the title list is sorted in by name, kept apart from titles.cpp
+ * so the tests and benchmarks sort with exactly what the plugin does.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Each record gets a collation key: its first 8 case-folded bytes packed
+ * big-endian. Most comparisons are settled by one integer compare of the
+ * keys; only names sharing those 8 bytes (sequels, "The Legend of ...")
+ * fall back to strcasecmp, and identical names keep record order.
+ *
+ * USAGE:
+ * ------
+ *   keys[recordIndex] = TitleCollation::ComputeKey(records[recordIndex].name);
+ *
+ *   TitleCollation::SortByName(nameOrder, count, keys, records);
+ *
+ *   if (TitleCollation::NameOrder{keys, records}(first, second)) ...
+ */
+
+#pragma once
+
+#include "titles.h"
+
+#include <cstdint>
+
+namespace TitleCollation {
+
+// Work done by one SortByName(), for scaling tests
+struct SortStats {
+    int comparisons = 0;
+    // Comparisons the keys couldn't settle
+    int nameComparisons = 0;
+};
+
+uint64_t ComputeKey(const char* name);
+
+// Strict weak order on record indices: key, then strcasecmp, then index
+struct NameOrder {
+    const uint64_t* keys;
+    const Titles::TitleInfo* records;
+
+    bool operator()(uint16_t firstRecord, uint16_t secondRecord) const;
+};
+
+// Fill order with 0..count-1 sorted by NameOrder
+void SortByName(uint16_t* order, int count, const uint64_t* keys,
+                const Titles::TitleInfo* records, SortStats* outStats = nullptr);
+
+} // namespace TitleCollation
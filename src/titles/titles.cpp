@@ -3,27 +3,262 @@
  */
 
 #include "titles.h"
+#include "title_collation.h"
 #include "../render/image_loader.h"
+#include "../storage/file_storage.h"
+#include "../storage/settings.h"
+#include "../presets/title_presets.h"
+#include "../utils/paths.h"
+#include "../utils/startup_profile.h"
+#include "../utils/trace.h"
+#include "../utils/worker_threads.h"
 
 #include <coreinit/mcp.h>
+#include <coreinit/thread.h>
 #include <coreinit/title.h>
 #include <nn/acp/title.h>
 
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 #include <cctype>
 #include <malloc.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace Titles {
 
 namespace {
 
-TitleInfo titleCache[MAX_TITLES];
-int titleCount = 0;
+// Records stay in the order they were added; each sort order is a display
+// permutation over them, so sorting only moves 2-byte indices.
+// Hot fields live in parallel columns so ID scans and flag checks walk
+// contiguous arrays; records are the cold name/code pool behind GetTitle()
+struct TitleBuffer {
+    uint64_t* titleIds;
+    uint8_t* flags;
+
+    // Favorite bit plus one bit per user category, rebuilt whenever the
+    // settings membership generation moves
+    uint32_t* categoryMasks;
+    uint32_t categoryMaskGeneration;
+    bool areCategoryMasksValid;
+
+    // Preset index + 1 per record (0 for none), joined once per presets
+    // load so readers never match product codes themselves
+    uint16_t* presetLinks;
+    uint32_t presetLinkGeneration;
+    bool arePresetLinksValid;
+
+    TitleInfo* records;
+    uint64_t* collationKeys;
+    uint16_t* nameOrder;
+    uint16_t* sortOrders[SORT_ORDER_COUNT];
+    bool areSortOrdersValid;
+
+    // Inverse of the active permutation: record index -> display index
+    uint16_t* displayPositions;
+    bool areDisplayPositionsValid;
+
+    int count;
+    int capacity;
+};
+
+// Per-record bits in TitleBuffer::flags
+constexpr uint8_t FLAG_NAME_RESOLVED = 0x01;
+
+// Columns grow on demand from the MCP title count, never past what the
+// memory budget allows
+constexpr int INITIAL_TITLE_CAPACITY = 64;
+constexpr size_t BYTES_PER_TITLE =
+    2 * (sizeof(TitleInfo) + 2 * sizeof(uint64_t) + sizeof(uint32_t) +
+         (3 + SORT_ORDER_COUNT) * sizeof(uint16_t) + sizeof(uint8_t)) +
+    sizeof(uint64_t) +
+    4 * sizeof(uint16_t) +
+    8 * (sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t));
+size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+// The menu reads the published buffer while the loader fills the staging
+// one, and the pointers swap when a load completes
+TitleBuffer titleBuffers[2];
+TitleBuffer* published = &titleBuffers[0];
+TitleBuffer* staging = &titleBuffers[1];
 bool isLoaded = false;
+bool isStagingValid = false;
+
+// Bumped whenever the published list or its order may have changed. The
+// loader also bumps it while filling staging, which only costs consumers
+// an extra rebuild
+std::atomic<uint32_t> listGeneration{1};
+SortOrder activeSortOrder = SortOrder::NAME;
+
+// The running title is dropped from the list but kept here so a reconcile
+// or snapshot write doesn't need to query its metadata again
+TitleInfo runningTitle;
+bool hasRunningTitle = false;
+
+// List and preset generations TitlePresets::RetainInstalled() last saw
+uint32_t retainedListGeneration = 0;
+uint32_t retainedPresetGeneration = 0;
+
+// Loader state shared with the worker thread
+std::atomic<int> loadPhase{static_cast<int>(LoadPhase::IDLE)};
+std::atomic<int> streamedCount{0};
+std::atomic<int> listedCount{0};
+std::atomic<bool> isWorkerFinished{false};
+bool isWorkerRunning = false;
+bool isReconcileLoad = false;
+bool isStreamingToCache = false;
+int mergedCount = 0;
+uint64_t currentTitleId = 0;
+
+// Set by CancelLoad(); the worker checks it between titles and leaves
+// what it has unpublished (wasLoadCancelled, read after the join)
+std::atomic<bool> isCancelRequested{false};
+bool wasLoadCancelled = false;
+
+// A reconcile started by StartChangeCheck(): the worker stops after the
+// MCP title count unless it moved
+bool isChangeCheck = false;
+
+// MCP's installed-title count at the last enumeration; the change watcher
+// compares against it so an unchanged system costs one MCP query
+int32_t knownInstalledTitleCount = -1;
+
+uint64_t* removedTitleIds = nullptr;
+int removedCount = 0;
+
+// Lazy name resolution: the worker lists IDs first, then resolves names
+// (hinted ones first) and hands each result to the menu through a ring
+NameResolution nameResolution = NameResolution::LAZY;
+bool isLazyLoad = false;
+bool arePlaceholdersMerged = false;
+std::atomic<bool> areIdsListed{false};
+
+constexpr int NAME_HINT_SLOTS = 8;
+std::atomic<uint64_t> nameHints[NAME_HINT_SLOTS];
+int nextNameHintSlot = 0;
+
+constexpr uint32_t RESOLVED_RING_SIZE = 64;
+TitleInfo resolvedRing[RESOLVED_RING_SIZE];
+std::atomic<uint32_t> resolvedRingHead{0};
+std::atomic<uint32_t> resolvedRingTail{0};
+
+// Open-addressing indexes over the published records, rebuilt on publish
+// and extended as streamed titles are merged. Table sizes are powers of
+// two: twice the record capacity for IDs, eight times for code suffixes
+constexpr int MIN_INDEX_SLOTS = 64;
+constexpr int MIN_INDEXED_CODE_LENGTH = 3;
+
+// Slots hold recordIndex + 1 so zero-initialized tables start out empty
+constexpr uint16_t EMPTY_SLOT = 0;
+
+int idIndexSlotCount = 0;
+uint16_t* idIndexSlots = nullptr;
+int codeIndexSlotCount = 0;
+uint32_t* codeIndexHashes = nullptr;
+uint16_t* codeIndexRecords = nullptr;
+uint8_t* codeIndexLengths = nullptr;
+int idIndexEntryCount = 0;
+int codeIndexEntryCount = 0;
+bool hasCodeIndexOverflowed = false;
+
+constexpr int LOADER_STACK_SIZE = 16 * 1024;
+OSThread* loaderThread = nullptr;
+uint8_t* loaderStack = nullptr;
+
+// One ACP metadata buffer for a whole enumeration rather than a 64-byte
+// aligned allocation per title. Only the thread running runEnumeration()
+// touches it
+ACPMetaXml* enumerationMetaXml = nullptr;
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x54535453;
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t titleListHash;
+    uint32_t recordSize;
+    uint32_t recordCount;
+};
+
+template <typename T>
+bool growArray(T*& array, int capacity)
+{
+    T* grownArray = static_cast<T*>(realloc(array, capacity * sizeof(T)));
+    if (!grownArray) {
+        return false;
+    }
+    array = grownArray;
+    return true;
+}
+
+int getCapacityLimit()
+{
+    size_t budgetedTitles = memoryBudget / BYTES_PER_TITLE;
+    return budgetedTitles < static_cast<size_t>(MAX_TITLES) ? static_cast<int>(budgetedTitles) : MAX_TITLES;
+}
+
+// Grow every column to hold at least requiredCount records. Existing
+// records are kept; a failed allocation leaves the old capacity usable
+bool reserveBuffer(TitleBuffer& buffer, int requiredCount)
+{
+    if (requiredCount <= buffer.capacity) {
+        return true;
+    }
+
+    int capacityLimit = getCapacityLimit();
+    if (requiredCount > capacityLimit) {
+        return false;
+    }
+
+    int newCapacity = std::max(buffer.capacity * 2, INITIAL_TITLE_CAPACITY);
+    newCapacity = std::min(std::max(newCapacity, requiredCount), capacityLimit);
+
+    bool isGrown = growArray(buffer.titleIds, newCapacity) &&
+                   growArray(buffer.flags, newCapacity) &&
+                   growArray(buffer.categoryMasks, newCapacity) &&
+                   growArray(buffer.presetLinks, newCapacity) &&
+                   growArray(buffer.records, newCapacity) &&
+                   growArray(buffer.collationKeys, newCapacity) &&
+                   growArray(buffer.nameOrder, newCapacity) &&
+                   growArray(buffer.displayPositions, newCapacity);
+    for (int orderIndex = 0; isGrown && orderIndex < SORT_ORDER_COUNT; orderIndex++) {
+        isGrown = growArray(buffer.sortOrders[orderIndex], newCapacity);
+    }
+    if (!isGrown) {
+        return false;
+    }
+
+    buffer.capacity = newCapacity;
+    buffer.areSortOrdersValid = false;
+    buffer.areDisplayPositionsValid = false;
+    return true;
+}
+
+void releaseBuffer(TitleBuffer& buffer)
+{
+    free(buffer.titleIds);
+    free(buffer.flags);
+    free(buffer.categoryMasks);
+    free(buffer.presetLinks);
+    free(buffer.records);
+    free(buffer.collationKeys);
+    free(buffer.nameOrder);
+    free(buffer.displayPositions);
+    for (int orderIndex = 0; orderIndex < SORT_ORDER_COUNT; orderIndex++) {
+        free(buffer.sortOrders[orderIndex]);
+    }
+    buffer = TitleBuffer{};
+}
 
+// Reads into the enumeration's buffer when called from it, otherwise into
+// a buffer of its own
 void getTitleMetadataFromSystem(uint64_t titleId, char* outputName, int maxNameLength,
-                                 char* outputProductCode, int maxCodeLength)
+                                 char* outputProductCode, int maxCodeLength,
+                                 ACPMetaXml* scratchMetaXml = nullptr)
 {
     if (outputName) {
         snprintf(outputName, maxNameLength, "%016llX", static_cast<unsigned long long>(titleId));
@@ -32,13 +267,17 @@ void getTitleMetadataFromSystem(uint64_t titleId, char* outputName, int maxNameL
         outputProductCode[0] = '\0';
     }
 
-    ACPMetaXml* metaXml = static_cast<ACPMetaXml*>(memalign(0x40, sizeof(ACPMetaXml)));
+    ACPMetaXml* metaXml = scratchMetaXml;
+    if (!metaXml) {
+        metaXml = static_cast<ACPMetaXml*>(memalign(0x40, sizeof(ACPMetaXml)));
+    }
     if (!metaXml) {
         return;
     }
 
     memset(metaXml, 0, sizeof(ACPMetaXml));
     ACPResult result = ACPGetTitleMetaXml(titleId, metaXml);
+    StartupProfile::Add(StartupProfile::Counter::ACP_CALLS, 1);
 
     if (result == ACP_RESULT_SUCCESS) {
         if (outputName) {
@@ -63,7 +302,9 @@ void getTitleMetadataFromSystem(uint64_t titleId, char* outputName, int maxNameL
         }
     }
 
-    free(metaXml);
+    if (metaXml != scratchMetaXml) {
+        free(metaXml);
+    }
 }
 
 void getTitleNameFromSystem(uint64_t titleId, char* outputName, int maxLength)
@@ -71,165 +312,1385 @@ void getTitleNameFromSystem(uint64_t titleId, char* outputName, int maxLength)
     getTitleMetadataFromSystem(titleId, outputName, maxLength, nullptr, 0);
 }
 
-void sortTitlesAlphabetically()
+bool isOrderedBefore(const TitleBuffer& buffer, uint16_t firstRecord, uint16_t secondRecord)
 {
-    for (int outerIndex = 0; outerIndex < titleCount - 1; outerIndex++) {
-        for (int innerIndex = 0; innerIndex < titleCount - outerIndex - 1; innerIndex++) {
-            if (strcasecmp(titleCache[innerIndex].name, titleCache[innerIndex + 1].name) > 0) {
-                TitleInfo temporary = titleCache[innerIndex];
-                titleCache[innerIndex] = titleCache[innerIndex + 1];
-                titleCache[innerIndex + 1] = temporary;
-            }
-        }
+    return TitleCollation::NameOrder{buffer.collationKeys, buffer.records}(firstRecord, secondRecord);
+}
+
+void sortTitlesAlphabetically(TitleBuffer& buffer)
+{
+    listGeneration.fetch_add(1, std::memory_order_relaxed);
+    buffer.areSortOrdersValid = false;
+    buffer.areDisplayPositionsValid = false;
+    TitleCollation::SortByName(buffer.nameOrder, buffer.count, buffer.collationKeys, buffer.records);
+}
+
+int appendRecord(TitleBuffer& buffer, const TitleInfo& title)
+{
+    if (!reserveBuffer(buffer, buffer.count + 1)) {
+        return -1;
     }
+
+    int recordIndex = buffer.count++;
+    listGeneration.fetch_add(1, std::memory_order_relaxed);
+    buffer.titleIds[recordIndex] = title.titleId;
+    buffer.flags[recordIndex] = FLAG_NAME_RESOLVED;
+    buffer.areCategoryMasksValid = false;
+    buffer.arePresetLinksValid = false;
+    buffer.records[recordIndex] = title;
+    buffer.collationKeys[recordIndex] = TitleCollation::ComputeKey(title.name);
+    return recordIndex;
 }
 
+// Append a record and splice it into nameOrder with a binary search
+int insertTitleSorted(TitleBuffer& buffer, const TitleInfo& title)
+{
+    int recordIndex = appendRecord(buffer, title);
+    if (recordIndex < 0) {
+        return -1;
+    }
+
+    int lowIndex = 0;
+    int highIndex = recordIndex;
+    while (lowIndex < highIndex) {
+        int middleIndex = (lowIndex + highIndex) / 2;
+        if (isOrderedBefore(buffer, buffer.nameOrder[middleIndex], static_cast<uint16_t>(recordIndex))) {
+            lowIndex = middleIndex + 1;
+        } else {
+            highIndex = middleIndex;
+        }
+    }
+
+    memmove(&buffer.nameOrder[lowIndex + 1], &buffer.nameOrder[lowIndex],
+            (recordIndex - lowIndex) * sizeof(uint16_t));
+    buffer.nameOrder[lowIndex] = static_cast<uint16_t>(recordIndex);
+    buffer.areSortOrdersValid = false;
+    buffer.areDisplayPositionsValid = false;
+    return recordIndex;
 }
 
-void Load(bool forceReload)
+// Once the whole list is known, let TitlePresets drop presets for titles
+// that aren't installed; the running title counts as installed
+void retainInstalledPresets(const TitleBuffer& buffer)
 {
-    if (isLoaded && !forceReload) {
+    uint32_t currentListGeneration = listGeneration.load(std::memory_order_relaxed);
+    if (!isLoaded || isWorkerRunning ||
+        (retainedListGeneration == currentListGeneration &&
+         retainedPresetGeneration == TitlePresets::GetGeneration())) {
         return;
     }
 
-    titleCount = 0;
-    isLoaded = false;
+    std::vector<const char*> productCodes;
+    productCodes.reserve(buffer.count + 1);
+    for (int recordIndex = 0; recordIndex < buffer.count; recordIndex++) {
+        productCodes.push_back(buffer.records[recordIndex].productCode);
+    }
+    if (hasRunningTitle) {
+        productCodes.push_back(runningTitle.productCode);
+    }
+
+    TitlePresets::RetainInstalled(productCodes);
+    retainedListGeneration = currentListGeneration;
+    retainedPresetGeneration = TitlePresets::GetGeneration();
+}
 
-    uint64_t currentTitleId = OSGetTitleID();
+// Look up every record's preset once; the index makes each lookup O(1)
+void linkPresets(TitleBuffer& buffer)
+{
+    retainInstalledPresets(buffer);
 
-    int32_t mcpHandle = MCP_Open();
-    if (mcpHandle < 0) {
-        isLoaded = true;
+    uint32_t presetGeneration = TitlePresets::GetGeneration();
+    if (buffer.arePresetLinksValid && buffer.presetLinkGeneration == presetGeneration) {
         return;
     }
 
-    MCPTitleListType* titleListBuffer = static_cast<MCPTitleListType*>(
-        malloc(sizeof(MCPTitleListType) * MAX_TITLES)
-    );
+    for (int recordIndex = 0; recordIndex < buffer.count; recordIndex++) {
+        const TitleInfo& record = buffer.records[recordIndex];
+        int presetIndex = record.productCode[0] != '\0'
+            ? TitlePresets::GetPresetIndexByGameId(record.productCode) : -1;
+        buffer.presetLinks[recordIndex] = static_cast<uint16_t>(presetIndex + 1);
+    }
 
-    if (!titleListBuffer) {
-        MCP_Close(mcpHandle);
-        isLoaded = true;
-        return;
+    buffer.presetLinkGeneration = presetGeneration;
+    buffer.arePresetLinksValid = true;
+}
+
+const TitlePresets::TitlePreset* getLinkedPreset(const TitleBuffer& buffer, int recordIndex)
+{
+    uint16_t presetLink = buffer.presetLinks[recordIndex];
+    return presetLink != 0 ? TitlePresets::GetPresetByIndex(presetLink - 1) : nullptr;
+}
+
+// Builds the non-name orders on the main thread, since they read launch
+// history and presets; ties fall back to name order
+void buildSortOrders(TitleBuffer& buffer)
+{
+    // displayPositions is stale after a rebuild anyway, so it doubles as
+    // the record -> name position scratch table
+    uint16_t* namePositions = buffer.displayPositions;
+    linkPresets(buffer);
+    int32_t* orderKeys = static_cast<int32_t*>(malloc(std::max(buffer.count, 1) * sizeof(int32_t)));
+
+    for (int position = 0; position < buffer.count; position++) {
+        namePositions[buffer.nameOrder[position]] = static_cast<uint16_t>(position);
     }
 
-    uint32_t foundTitleCount = 0;
-    MCPError mcpError = MCP_TitleListByAppType(
-        mcpHandle,
-        MCP_APP_TYPE_GAME,
-        &foundTitleCount,
-        titleListBuffer,
-        sizeof(MCPTitleListType) * MAX_TITLES
-    );
+    for (int orderIndex = 0; orderIndex < SORT_ORDER_COUNT; orderIndex++) {
+        SortOrder order = static_cast<SortOrder>(orderIndex);
+        uint16_t* permutation = buffer.sortOrders[orderIndex];
+        memcpy(permutation, buffer.nameOrder, buffer.count * sizeof(uint16_t));
+        if (order == SortOrder::NAME || !orderKeys) {
+            continue;
+        }
 
-    if (mcpError >= 0 && foundTitleCount > 0) {
-        for (uint32_t listIndex = 0; listIndex < foundTitleCount && titleCount < MAX_TITLES; listIndex++) {
-            uint64_t titleId = titleListBuffer[listIndex].titleId;
+        if (order == SortOrder::TITLE_ID) {
+            std::sort(permutation, permutation + buffer.count,
+                [&buffer](uint16_t firstRecord, uint16_t secondRecord) {
+                    return buffer.titleIds[firstRecord] < buffer.titleIds[secondRecord];
+                });
+            continue;
+        }
 
-            if (titleId == currentTitleId) {
-                continue;
+        for (int recordIndex = 0; recordIndex < buffer.count; recordIndex++) {
+            int32_t orderKey = INT32_MAX;
+            if (order == SortOrder::RECENT) {
+                int launchRank = Settings::GetLaunchRank(buffer.titleIds[recordIndex]);
+                if (launchRank >= 0) {
+                    orderKey = launchRank;
+                }
+            } else {
+                // Newest first; titles without a release year go last
+                const TitlePresets::TitlePreset* preset = getLinkedPreset(buffer, recordIndex);
+                if (preset && preset->releaseYear > 0) {
+                    orderKey = -static_cast<int32_t>(preset->releaseYear);
+                }
             }
-
-            titleCache[titleCount].titleId = titleId;
-            getTitleMetadataFromSystem(titleId,
-                                       titleCache[titleCount].name, MAX_NAME_LENGTH,
-                                       titleCache[titleCount].productCode, MAX_PRODUCT_CODE);
-            ImageLoader::Request(titleId, ImageLoader::Priority::LOW);
-            titleCount++;
+            orderKeys[recordIndex] = orderKey;
         }
+
+        std::sort(permutation, permutation + buffer.count,
+            [orderKeys, namePositions](uint16_t firstRecord, uint16_t secondRecord) {
+                if (orderKeys[firstRecord] != orderKeys[secondRecord]) {
+                    return orderKeys[firstRecord] < orderKeys[secondRecord];
+                }
+                return namePositions[firstRecord] < namePositions[secondRecord];
+            });
     }
 
-    free(titleListBuffer);
-    MCP_Close(mcpHandle);
-    sortTitlesAlphabetically();
-    isLoaded = true;
+    free(orderKeys);
+    buffer.areSortOrdersValid = true;
+    buffer.areDisplayPositionsValid = false;
 }
 
-bool IsLoaded()
+const uint16_t* getActivePermutation()
 {
-    return isLoaded;
+    if (activeSortOrder == SortOrder::NAME) {
+        return published->nameOrder;
+    }
+    if (!published->areSortOrdersValid) {
+        buildSortOrders(*published);
+    }
+    return published->sortOrders[static_cast<int>(activeSortOrder)];
 }
 
-void Clear()
+int getDisplayPosition(int recordIndex)
 {
-    titleCount = 0;
-    isLoaded = false;
+    if (!published->areDisplayPositionsValid) {
+        const uint16_t* permutation = getActivePermutation();
+        for (int position = 0; position < published->count; position++) {
+            published->displayPositions[permutation[position]] = static_cast<uint16_t>(position);
+        }
+        published->areDisplayPositionsValid = true;
+    }
+    return published->displayPositions[recordIndex];
 }
 
-int GetCount()
+uint32_t hashTitleId(uint64_t titleId)
 {
-    return titleCount;
+    uint64_t mixed = titleId * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(mixed >> 32);
 }
 
-const TitleInfo* GetTitle(int index)
+// FNV-1a over the case-folded code, matching strcasecmp equality
+uint32_t hashProductCode(const char* code, int length)
 {
-    if (index < 0 || index >= titleCount) {
-        return nullptr;
+    uint32_t hash = 0x811C9DC5u;
+    for (int charIndex = 0; charIndex < length; charIndex++) {
+        hash ^= static_cast<uint8_t>(toupper(static_cast<unsigned char>(code[charIndex])));
+        hash *= 0x01000193u;
     }
-    return &titleCache[index];
+    return hash;
 }
 
-const TitleInfo* FindById(uint64_t titleId)
+void indexProductCodeSuffix(int recordIndex, const char* suffix, int suffixLength)
 {
-    for (int index = 0; index < titleCount; index++) {
-        if (titleCache[index].titleId == titleId) {
-            return &titleCache[index];
+    if (codeIndexEntryCount >= codeIndexSlotCount / 2) {
+        hasCodeIndexOverflowed = true;
+        return;
+    }
+
+    uint32_t keyHash = hashProductCode(suffix, suffixLength);
+    int slot = keyHash & (codeIndexSlotCount - 1);
+    while (codeIndexRecords[slot] != EMPTY_SLOT) {
+        // Keep the earliest record for a given code, like the linear scan did
+        if (codeIndexHashes[slot] == keyHash && codeIndexLengths[slot] == suffixLength) {
+            const char* storedCode = published->records[codeIndexRecords[slot] - 1].productCode;
+            if (strcasecmp(storedCode + strlen(storedCode) - suffixLength, suffix) == 0) {
+                return;
+            }
         }
+        slot = (slot + 1) & (codeIndexSlotCount - 1);
     }
-    return nullptr;
+
+    codeIndexHashes[slot] = keyHash;
+    codeIndexRecords[slot] = static_cast<uint16_t>(recordIndex + 1);
+    codeIndexLengths[slot] = static_cast<uint8_t>(suffixLength);
+    codeIndexEntryCount++;
 }
 
-int FindIndexById(uint64_t titleId)
+// Hyphen-free lookups can only match a suffix of the code's last segment,
+// so indexing those suffixes covers exact, suffix and after-hyphen matches
+void indexProductCode(int recordIndex)
 {
-    for (int index = 0; index < titleCount; index++) {
-        if (titleCache[index].titleId == titleId) {
-            return index;
-        }
+    const TitleInfo& record = published->records[recordIndex];
+    const char* code = record.productCode;
+    int codeLength = strlen(code);
+    const char* lastHyphen = strrchr(code, '-');
+    int segmentLength = lastHyphen ? static_cast<int>(code + codeLength - (lastHyphen + 1)) : codeLength;
+
+    for (int suffixLength = MIN_INDEXED_CODE_LENGTH; suffixLength <= segmentLength; suffixLength++) {
+        indexProductCodeSuffix(recordIndex, code + codeLength - suffixLength, suffixLength);
     }
-    return -1;
 }
 
-void GetNameForId(uint64_t titleId, char* outputName, int maxLength)
+void rebuildIndexes();
+
+void indexRecord(int recordIndex)
 {
-    const TitleInfo* cachedTitle = FindById(titleId);
-    if (cachedTitle) {
-        strncpy(outputName, cachedTitle->name, maxLength - 1);
-        outputName[maxLength - 1] = '\0';
+    // Past half load the tables are resized, which re-indexes this record too
+    if ((idIndexEntryCount + 1) * 2 > idIndexSlotCount) {
+        rebuildIndexes();
         return;
     }
 
-    getTitleNameFromSystem(titleId, outputName, maxLength);
+    int slot = hashTitleId(published->titleIds[recordIndex]) & (idIndexSlotCount - 1);
+    while (idIndexSlots[slot] != EMPTY_SLOT) {
+        slot = (slot + 1) & (idIndexSlotCount - 1);
+    }
+    idIndexSlots[slot] = static_cast<uint16_t>(recordIndex + 1);
+    idIndexEntryCount++;
+
+    indexProductCode(recordIndex);
 }
 
-const TitleInfo* FindByProductCode(const char* productCode)
+// Size both tables for the published capacity, keeping the old tables if
+// the allocation fails (lookups then fall back to linear scans)
+void reserveIndexes()
 {
-    if (!productCode || productCode[0] == '\0') {
-        return nullptr;
+    int requiredSlots = MIN_INDEX_SLOTS;
+    while (requiredSlots < published->capacity * 2) {
+        requiredSlots *= 2;
+    }
+
+    if (requiredSlots > idIndexSlotCount) {
+        uint16_t* newIdSlots = static_cast<uint16_t*>(malloc(requiredSlots * sizeof(uint16_t)));
+        if (newIdSlots) {
+            free(idIndexSlots);
+            idIndexSlots = newIdSlots;
+            idIndexSlotCount = requiredSlots;
+        }
+    }
+
+    int requiredCodeSlots = requiredSlots * 4;
+    if (requiredCodeSlots > codeIndexSlotCount &&
+        growArray(codeIndexHashes, requiredCodeSlots) &&
+        growArray(codeIndexRecords, requiredCodeSlots) &&
+        growArray(codeIndexLengths, requiredCodeSlots)) {
+        codeIndexSlotCount = requiredCodeSlots;
+    }
+}
+
+void releaseIndexes()
+{
+    free(idIndexSlots);
+    free(codeIndexHashes);
+    free(codeIndexRecords);
+    free(codeIndexLengths);
+    idIndexSlots = nullptr;
+    codeIndexHashes = nullptr;
+    codeIndexRecords = nullptr;
+    codeIndexLengths = nullptr;
+    idIndexSlotCount = 0;
+    codeIndexSlotCount = 0;
+    idIndexEntryCount = 0;
+    codeIndexEntryCount = 0;
+}
+
+void rebuildIndexes()
+{
+    reserveIndexes();
+    if (idIndexSlots) {
+        memset(idIndexSlots, 0, idIndexSlotCount * sizeof(uint16_t));
+    }
+    if (codeIndexRecords) {
+        memset(codeIndexRecords, 0, codeIndexSlotCount * sizeof(uint16_t));
+    }
+    idIndexEntryCount = 0;
+    codeIndexEntryCount = 0;
+    hasCodeIndexOverflowed = false;
+
+    for (int recordIndex = 0; recordIndex < published->count; recordIndex++) {
+        if ((idIndexEntryCount + 1) * 2 > idIndexSlotCount) {
+            break;
+        }
+        indexRecord(recordIndex);
+    }
+}
+
+int findRecordByIdLinear(uint64_t titleId)
+{
+    for (int recordIndex = 0; recordIndex < published->count; recordIndex++) {
+        if (published->titleIds[recordIndex] == titleId) {
+            return recordIndex;
+        }
+    }
+    return -1;
+}
+
+int findRecordById(uint64_t titleId)
+{
+    if (idIndexSlotCount == 0 || idIndexEntryCount < published->count) {
+        return findRecordByIdLinear(titleId);
+    }
+
+    int slot = hashTitleId(titleId) & (idIndexSlotCount - 1);
+    while (idIndexSlots[slot] != EMPTY_SLOT) {
+        int recordIndex = idIndexSlots[slot] - 1;
+        if (recordIndex < published->count && published->titleIds[recordIndex] == titleId) {
+            return recordIndex;
+        }
+        slot = (slot + 1) & (idIndexSlotCount - 1);
     }
+    return -1;
+}
 
+const TitleInfo* findByProductCodeLinear(const char* productCode)
+{
     int searchLength = strlen(productCode);
 
-    for (int index = 0; index < titleCount; index++) {
-        const char* storedCode = titleCache[index].productCode;
+    for (int recordIndex = 0; recordIndex < published->count; recordIndex++) {
+        const TitleInfo& record = published->records[recordIndex];
+        const char* storedCode = record.productCode;
         if (storedCode[0] == '\0') continue;
 
         int storedCodeLength = strlen(storedCode);
 
         if (strcasecmp(storedCode, productCode) == 0) {
-            return &titleCache[index];
+            return &record;
         }
 
         if (searchLength <= storedCodeLength) {
             const char* codeSuffix = storedCode + (storedCodeLength - searchLength);
             if (strcasecmp(codeSuffix, productCode) == 0) {
-                return &titleCache[index];
+                return &record;
             }
         }
 
         const char* lastHyphen = strrchr(storedCode, '-');
         if (lastHyphen && strcasecmp(lastHyphen + 1, productCode) == 0) {
-            return &titleCache[index];
+            return &record;
+        }
+    }
+
+    return nullptr;
+}
+
+// One pass over favorites and assignments instead of one per title
+void buildCategoryMasks()
+{
+    TitleBuffer& buffer = *published;
+    memset(buffer.categoryMasks, 0, buffer.count * sizeof(uint32_t));
+
+    const Settings::PluginSettings& settings = Settings::Get();
+    for (uint64_t favoriteTitleId : settings.favorites) {
+        int recordIndex = findRecordById(favoriteTitleId);
+        if (recordIndex >= 0) {
+            buffer.categoryMasks[recordIndex] |= Settings::FAVORITE_MASK_BIT;
+        }
+    }
+
+    int categoryCount = std::min(static_cast<int>(settings.categories.size()), Settings::MAX_CATEGORIES);
+    for (const Settings::TitleCategoryAssignment& assignment : settings.titleCategories) {
+        int recordIndex = findRecordById(assignment.titleId);
+        if (recordIndex < 0) {
+            continue;
+        }
+        for (int position = 0; position < categoryCount; position++) {
+            if (settings.categories[position].id == assignment.categoryId) {
+                buffer.categoryMasks[recordIndex] |= 1u << position;
+                break;
+            }
+        }
+    }
+
+    buffer.categoryMaskGeneration = Settings::GetMembershipGeneration();
+    buffer.areCategoryMasksValid = true;
+}
+
+// FNV-1a over the raw MCP title ID list; any install/uninstall changes it
+uint64_t hashTitleList(const MCPTitleListType* titleList, uint32_t listCount)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint32_t listIndex = 0; listIndex < listCount; listIndex++) {
+        uint64_t titleId = titleList[listIndex].titleId;
+        for (int byteIndex = 0; byteIndex < 8; byteIndex++) {
+            hash ^= (titleId >> (byteIndex * 8)) & 0xFF;
+            hash *= 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+
+// A snapshot holds every listed title; one cut short by the memory
+// budget (see getCapacityLimit) is never saved, and never accepted
+bool loadSnapshot(uint64_t titleListHash, uint32_t titleListCount)
+{
+    TRACE_SCOPE("Title snapshot load");
+    uint8_t* fileData = nullptr;
+    size_t fileSize = 0;
+    if (!FileStorage::ReadFile(Paths::TITLE_SNAPSHOT_FILE, &fileData, &fileSize)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    bool isValid = fileSize >= sizeof(SnapshotHeader);
+    if (isValid) {
+        memcpy(&header, fileData, sizeof(SnapshotHeader));
+        isValid = header.magic == SNAPSHOT_MAGIC &&
+                  header.version == SNAPSHOT_VERSION &&
+                  header.titleListHash == titleListHash &&
+                  header.recordCount == titleListCount &&
+                  header.recordSize == sizeof(TitleInfo) &&
+                  fileSize == sizeof(SnapshotHeader) + header.recordCount * sizeof(TitleInfo) &&
+                  reserveBuffer(*staging, static_cast<int>(header.recordCount));
+    }
+
+    if (isValid) {
+        memcpy(staging->records, fileData + sizeof(SnapshotHeader), header.recordCount * sizeof(TitleInfo));
+        staging->count = static_cast<int>(header.recordCount);
+        for (int recordIndex = 0; recordIndex < staging->count; recordIndex++) {
+            TitleInfo& record = staging->records[recordIndex];
+            record.name[MAX_NAME_LENGTH - 1] = '\0';
+            record.productCode[MAX_PRODUCT_CODE - 1] = '\0';
+            staging->titleIds[recordIndex] = record.titleId;
+            staging->flags[recordIndex] = FLAG_NAME_RESOLVED;
+            staging->areCategoryMasksValid = false;
+            staging->arePresetLinksValid = false;
+            staging->collationKeys[recordIndex] = TitleCollation::ComputeKey(record.name);
+        }
+        sortTitlesAlphabetically(*staging);
+    }
+
+    free(fileData);
+    return isValid;
+}
+
+void saveSnapshot(uint64_t titleListHash)
+{
+    TRACE_SCOPE("Title snapshot save");
+    size_t fileSize = sizeof(SnapshotHeader) + staging->count * sizeof(TitleInfo);
+    uint8_t* fileData = static_cast<uint8_t*>(malloc(fileSize));
+    if (!fileData) {
+        return;
+    }
+
+    SnapshotHeader header = {};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.titleListHash = titleListHash;
+    header.recordSize = sizeof(TitleInfo);
+    header.recordCount = static_cast<uint32_t>(staging->count);
+    memcpy(fileData, &header, sizeof(SnapshotHeader));
+    memcpy(fileData + sizeof(SnapshotHeader), staging->records, staging->count * sizeof(TitleInfo));
+
+    if (!FileStorage::Exists(Paths::CACHE_DIR)) {
+        FileStorage::CreateDir(Paths::CACHE_DIR);
+    }
+    // Takes fileData; the loader finishes without waiting for the card
+    FileStorage::WriteAsync(Paths::TITLE_SNAPSHOT_FILE, fileData, fileSize);
+}
+
+void removeTitleFromCache(uint64_t titleId)
+{
+    TitleBuffer& buffer = *published;
+    int writeIndex = 0;
+    for (int readIndex = 0; readIndex < buffer.count; readIndex++) {
+        if (buffer.titleIds[readIndex] == titleId) {
+            runningTitle = buffer.records[readIndex];
+            hasRunningTitle = true;
+            continue;
+        }
+        if (writeIndex != readIndex) {
+            buffer.titleIds[writeIndex] = buffer.titleIds[readIndex];
+            buffer.flags[writeIndex] = buffer.flags[readIndex];
+            buffer.records[writeIndex] = buffer.records[readIndex];
+            buffer.collationKeys[writeIndex] = buffer.collationKeys[readIndex];
+        }
+        writeIndex++;
+    }
+
+    if (writeIndex != buffer.count) {
+        buffer.count = writeIndex;
+        buffer.areCategoryMasksValid = false;
+        buffer.arePresetLinksValid = false;
+        sortTitlesAlphabetically(buffer);
+    }
+}
+
+// Diff the fresh MCP list against the published records: drop removed
+// titles, keep surviving ones, and only query ACP for new IDs
+void reconcileWithTitleList(const MCPTitleListType* titleList, uint32_t listCount)
+{
+    uint64_t* sortedTitleIds = static_cast<uint64_t*>(malloc(sizeof(uint64_t) * listCount));
+    if (!sortedTitleIds) {
+        isStagingValid = false;
+        return;
+    }
+    for (uint32_t listIndex = 0; listIndex < listCount; listIndex++) {
+        sortedTitleIds[listIndex] = titleList[listIndex].titleId;
+    }
+    std::sort(sortedTitleIds, sortedTitleIds + listCount);
+
+    // The published buffer is read-only while a load runs, so start from a copy
+    staging->count = 0;
+    removedCount = 0;
+    if (!reserveBuffer(*staging, std::min(static_cast<int>(listCount), getCapacityLimit())) ||
+        !growArray(removedTitleIds, std::max(published->count, 1))) {
+        free(sortedTitleIds);
+        isStagingValid = false;
+        return;
+    }
+    for (int recordIndex = 0; recordIndex < published->count; recordIndex++) {
+        uint64_t publishedTitleId = published->titleIds[recordIndex];
+        if (!std::binary_search(sortedTitleIds, sortedTitleIds + listCount, publishedTitleId)) {
+            removedTitleIds[removedCount++] = publishedTitleId;
+            continue;
+        }
+        appendRecord(*staging, published->records[recordIndex]);
+    }
+
+    // Every kept ID is listed, so the kept IDs fit in the same array; a
+    // binary search then tells cached titles from new ones
+    int keptCount = staging->count;
+    std::copy(staging->titleIds, staging->titleIds + keptCount, sortedTitleIds);
+    std::sort(sortedTitleIds, sortedTitleIds + keptCount);
+
+    for (uint32_t listIndex = 0; listIndex < listCount; listIndex++) {
+        if (isCancelRequested.load(std::memory_order_acquire)) {
+            wasLoadCancelled = true;
+            break;
+        }
+        uint64_t titleId = titleList[listIndex].titleId;
+        streamedCount.store(static_cast<int>(listIndex), std::memory_order_relaxed);
+
+        if (std::binary_search(sortedTitleIds, sortedTitleIds + keptCount, titleId)) {
+            continue;
+        }
+
+        if (hasRunningTitle && runningTitle.titleId == titleId) {
+            appendRecord(*staging, runningTitle);
+            continue;
+        }
+
+        TitleInfo newTitle;
+        newTitle.titleId = titleId;
+        getTitleMetadataFromSystem(titleId, newTitle.name, MAX_NAME_LENGTH,
+                                   newTitle.productCode, MAX_PRODUCT_CODE, enumerationMetaXml);
+        appendRecord(*staging, newTitle);
+    }
+    free(sortedTitleIds);
+
+    sortTitlesAlphabetically(*staging);
+}
+
+// Query every listed title, publishing each finished entry through
+// streamedCount so the menu can merge a partial list meanwhile
+void enumerateTitleList(const MCPTitleListType* titleList, uint32_t listCount)
+{
+    // Reserve up front: the menu reads staging records while this runs, so
+    // the columns must not move once streaming starts
+    staging->count = 0;
+    reserveBuffer(*staging, std::min(static_cast<int>(listCount), getCapacityLimit()));
+    for (uint32_t listIndex = 0; listIndex < listCount && staging->count < staging->capacity; listIndex++) {
+        if (isCancelRequested.load(std::memory_order_acquire)) {
+            wasLoadCancelled = true;
+            return;
+        }
+        TitleInfo newTitle;
+        newTitle.titleId = titleList[listIndex].titleId;
+        getTitleMetadataFromSystem(newTitle.titleId, newTitle.name, MAX_NAME_LENGTH,
+                                   newTitle.productCode, MAX_PRODUCT_CODE, enumerationMetaXml);
+        appendRecord(*staging, newTitle);
+        streamedCount.store(staging->count, std::memory_order_release);
+    }
+    sortTitlesAlphabetically(*staging);
+}
+
+int takeHintedRecord()
+{
+    for (int hintSlot = 0; hintSlot < NAME_HINT_SLOTS; hintSlot++) {
+        uint64_t hintedTitleId = nameHints[hintSlot].exchange(0);
+        if (hintedTitleId == 0) {
+            continue;
+        }
+        for (int recordIndex = 0; recordIndex < staging->count; recordIndex++) {
+            if (staging->titleIds[recordIndex] == hintedTitleId &&
+                !(staging->flags[recordIndex] & FLAG_NAME_RESOLVED)) {
+                return recordIndex;
+            }
+        }
+    }
+    return -1;
+}
+
+// Results are dropped when the menu isn't draining the ring; the final
+// publish carries every name anyway
+void pushResolvedTitle(const TitleInfo& title)
+{
+    uint32_t head = resolvedRingHead.load(std::memory_order_relaxed);
+    uint32_t tail = resolvedRingTail.load(std::memory_order_acquire);
+    if (head - tail >= RESOLVED_RING_SIZE) {
+        return;
+    }
+    resolvedRing[head % RESOLVED_RING_SIZE] = title;
+    resolvedRingHead.store(head + 1, std::memory_order_release);
+}
+
+// List every ID with a placeholder name, then resolve names one at a time,
+// preferring titles the menu is currently showing
+void enumerateTitleListLazily(const MCPTitleListType* titleList, uint32_t listCount)
+{
+    staging->count = 0;
+    int listedLimit = std::min(static_cast<int>(listCount), getCapacityLimit());
+    if (!reserveBuffer(*staging, listedLimit)) {
+        enumerateTitleList(titleList, listCount);
+        return;
+    }
+
+    for (int listIndex = 0; listIndex < listedLimit; listIndex++) {
+        TitleInfo placeholder;
+        placeholder.titleId = titleList[listIndex].titleId;
+        snprintf(placeholder.name, MAX_NAME_LENGTH, "%016llX", static_cast<unsigned long long>(placeholder.titleId));
+        placeholder.productCode[0] = '\0';
+
+        int recordIndex = appendRecord(*staging, placeholder);
+        staging->flags[recordIndex] &= ~FLAG_NAME_RESOLVED;
+    }
+    listedCount.store(staging->count);
+    areIdsListed.store(true, std::memory_order_release);
+
+    int sequentialCursor = 0;
+    for (int resolvedCount = 0; resolvedCount < staging->count; resolvedCount++) {
+        if (isCancelRequested.load(std::memory_order_acquire)) {
+            wasLoadCancelled = true;
+            return;
+        }
+        int recordIndex = takeHintedRecord();
+        if (recordIndex < 0) {
+            while (staging->flags[sequentialCursor] & FLAG_NAME_RESOLVED) {
+                sequentialCursor++;
+            }
+            recordIndex = sequentialCursor;
+        }
+
+        TitleInfo& record = staging->records[recordIndex];
+        getTitleMetadataFromSystem(record.titleId, record.name, MAX_NAME_LENGTH,
+                                   record.productCode, MAX_PRODUCT_CODE, enumerationMetaXml);
+        staging->collationKeys[recordIndex] = TitleCollation::ComputeKey(record.name);
+        staging->flags[recordIndex] |= FLAG_NAME_RESOLVED;
+
+        pushResolvedTitle(record);
+        streamedCount.store(resolvedCount + 1, std::memory_order_relaxed);
+    }
+    sortTitlesAlphabetically(*staging);
+}
+
+// Runs on the loader thread (or inline for a blocking Load); only writes
+// the staging buffer and the atomics, never the published list or ImageLoader
+void enumerateInstalledTitles()
+{
+    loadPhase.store(static_cast<int>(LoadPhase::ENUMERATING));
+
+    staging->count = 0;
+    removedCount = 0;
+    isStagingValid = !isReconcileLoad;
+
+    int32_t mcpHandle = MCP_Open();
+    if (mcpHandle < 0) {
+        return;
+    }
+
+    // Every installed title counts here, so the game list always fits
+    int32_t installedTitleCount = MCP_TitleCount(mcpHandle);
+    if (installedTitleCount <= 0 ||
+        (isChangeCheck && installedTitleCount == knownInstalledTitleCount)) {
+        MCP_Close(mcpHandle);
+        return;
+    }
+    knownInstalledTitleCount = installedTitleCount;
+
+    MCPTitleListType* titleListBuffer = static_cast<MCPTitleListType*>(
+        malloc(sizeof(MCPTitleListType) * installedTitleCount)
+    );
+
+    if (!titleListBuffer) {
+        MCP_Close(mcpHandle);
+        return;
+    }
+
+    uint32_t foundTitleCount = 0;
+    MCPError mcpError = MCP_TitleListByAppType(
+        mcpHandle,
+        MCP_APP_TYPE_GAME,
+        &foundTitleCount,
+        titleListBuffer,
+        sizeof(MCPTitleListType) * installedTitleCount
+    );
+
+    // A failed query leaves a reconcile's staging invalid so the published
+    // list is kept rather than wiped
+    if (mcpError >= 0 && foundTitleCount > 0) {
+        isStagingValid = true;
+        listedCount.store(static_cast<int>(foundTitleCount));
+        loadPhase.store(static_cast<int>(LoadPhase::RESOLVING));
+
+        // The snapshot holds every listed title (including the running one) so
+        // it stays valid no matter which game the menu is opened from
+        uint64_t titleListHash = hashTitleList(titleListBuffer, foundTitleCount);
+
+        if (!loadSnapshot(titleListHash, foundTitleCount)) {
+            // Null on failure: each query then allocates its own
+            enumerationMetaXml = static_cast<ACPMetaXml*>(memalign(0x40, sizeof(ACPMetaXml)));
+            if (isReconcileLoad) {
+                reconcileWithTitleList(titleListBuffer, foundTitleCount);
+            } else if (isLazyLoad) {
+                enumerateTitleListLazily(titleListBuffer, foundTitleCount);
+            } else {
+                enumerateTitleList(titleListBuffer, foundTitleCount);
+            }
+            free(enumerationMetaXml);
+            enumerationMetaXml = nullptr;
+
+            // A cancelled list is incomplete: keep the published one and
+            // enumerate again at the next check. A list the memory budget
+            // cut short is published but not snapshotted, so the next
+            // load enumerates the missing titles again
+            if (wasLoadCancelled) {
+                isStagingValid = false;
+                knownInstalledTitleCount = -1;
+            } else if (staging->count == static_cast<int>(foundTitleCount)) {
+                saveSnapshot(titleListHash);
+            }
+        }
+    }
+
+    free(titleListBuffer);
+    MCP_Close(mcpHandle);
+}
+
+void runEnumeration()
+{
+    TRACE_SCOPE("Title enumeration");
+    {
+        StartupProfile::Scope profileScope(StartupProfile::Phase::TITLE_ENUMERATION);
+        enumerateInstalledTitles();
+    }
+
+    // The first enumeration is the last of the work startup kicks off
+    StartupProfile::Add(StartupProfile::Counter::TITLES_ENUMERATED, static_cast<uint32_t>(listedCount.load()));
+    StartupProfile::Finish();
+}
+
+int loaderThreadEntry(int argc, const char** argv)
+{
+    (void)argc;
+    (void)argv;
+    runEnumeration();
+    isWorkerFinished.store(true, std::memory_order_release);
+    return 0;
+}
+
+void mergeStreamedTitles()
+{
+    int availableCount = streamedCount.load(std::memory_order_acquire);
+    reserveBuffer(*published, availableCount);
+    for (; mergedCount < availableCount; mergedCount++) {
+        if (staging->titleIds[mergedCount] != currentTitleId) {
+            int recordIndex = insertTitleSorted(*published, staging->records[mergedCount]);
+            if (recordIndex >= 0) {
+                indexRecord(recordIndex);
+            }
+        }
+    }
+}
+
+void mergeListedPlaceholders()
+{
+    published->count = 0;
+    int listedTotal = listedCount.load();
+    reserveBuffer(*published, listedTotal);
+    for (int listIndex = 0; listIndex < listedTotal; listIndex++) {
+        // The worker never rewrites the staging ID column after listing it
+        uint64_t listedTitleId = staging->titleIds[listIndex];
+        if (listedTitleId == currentTitleId) {
+            continue;
+        }
+
+        TitleInfo placeholder;
+        placeholder.titleId = listedTitleId;
+        snprintf(placeholder.name, MAX_NAME_LENGTH, "%016llX", static_cast<unsigned long long>(placeholder.titleId));
+        placeholder.productCode[0] = '\0';
+
+        int recordIndex = appendRecord(*published, placeholder);
+        published->flags[recordIndex] &= ~FLAG_NAME_RESOLVED;
+        ImageLoader::Request(placeholder.titleId, ImageLoader::Priority::LOW);
+    }
+
+    sortTitlesAlphabetically(*published);
+    rebuildIndexes();
+    arePlaceholdersMerged = true;
+}
+
+// Copy a resolved name into the published record and move it to its new
+// place in name order
+void applyResolvedTitle(const TitleInfo& resolvedTitle)
+{
+    int recordIndex = findRecordById(resolvedTitle.titleId);
+    if (recordIndex < 0) {
+        return;
+    }
+
+    TitleBuffer& buffer = *published;
+    for (int position = 0; position < buffer.count; position++) {
+        if (buffer.nameOrder[position] == recordIndex) {
+            memmove(&buffer.nameOrder[position], &buffer.nameOrder[position + 1],
+                    (buffer.count - position - 1) * sizeof(uint16_t));
+            break;
+        }
+    }
+
+    buffer.records[recordIndex] = resolvedTitle;
+    buffer.collationKeys[recordIndex] = TitleCollation::ComputeKey(resolvedTitle.name);
+    buffer.arePresetLinksValid = false;
+    buffer.flags[recordIndex] |= FLAG_NAME_RESOLVED;
+
+    int lowIndex = 0;
+    int highIndex = buffer.count - 1;
+    while (lowIndex < highIndex) {
+        int middleIndex = (lowIndex + highIndex) / 2;
+        if (isOrderedBefore(buffer, buffer.nameOrder[middleIndex], static_cast<uint16_t>(recordIndex))) {
+            lowIndex = middleIndex + 1;
+        } else {
+            highIndex = middleIndex;
+        }
+    }
+    memmove(&buffer.nameOrder[lowIndex + 1], &buffer.nameOrder[lowIndex],
+            (buffer.count - 1 - lowIndex) * sizeof(uint16_t));
+    buffer.nameOrder[lowIndex] = static_cast<uint16_t>(recordIndex);
+
+    buffer.areSortOrdersValid = false;
+    buffer.areDisplayPositionsValid = false;
+    listGeneration.fetch_add(1, std::memory_order_relaxed);
+    indexProductCode(recordIndex);
+}
+
+bool drainResolvedTitles()
+{
+    bool hasChanged = false;
+    uint32_t tail = resolvedRingTail.load(std::memory_order_relaxed);
+    uint32_t head = resolvedRingHead.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        applyResolvedTitle(resolvedRing[tail % RESOLVED_RING_SIZE]);
+        hasChanged = true;
+    }
+    resolvedRingTail.store(tail, std::memory_order_release);
+    return hasChanged;
+}
+
+// A different application is now running: put the previous one back in
+// the list and take the new one out, without touching MCP or ACP
+void switchRunningTitle(uint64_t newTitleId)
+{
+    currentTitleId = newTitleId;
+    if (hasRunningTitle) {
+        appendRecord(*published, runningTitle);
+        hasRunningTitle = false;
+    }
+    removeTitleFromCache(newTitleId);
+    sortTitlesAlphabetically(*published);
+    rebuildIndexes();
+}
+
+void publishWorkCache()
+{
+    // A cancelled first load leaves part of a list published; the next
+    // StartLoadAsync() starts over
+    bool isPartial = wasLoadCancelled && !isReconcileLoad;
+
+    if (isStagingValid) {
+        for (int removedIndex = 0; removedIndex < removedCount; removedIndex++) {
+            ImageLoader::Evict(removedTitleIds[removedIndex]);
+        }
+
+        TitleBuffer* previousBuffer = published;
+        published = staging;
+        staging = previousBuffer;
+        listGeneration.fetch_add(1, std::memory_order_relaxed);
+
+        removeTitleFromCache(currentTitleId);
+        buildSortOrders(*published);
+        rebuildIndexes();
+        for (int recordIndex = 0; recordIndex < published->count; recordIndex++) {
+            ImageLoader::Request(published->titleIds[recordIndex], ImageLoader::Priority::LOW);
+        }
+    }
+
+    staging->count = 0;
+    removedCount = 0;
+    isStagingValid = false;
+    isStreamingToCache = false;
+    isLazyLoad = false;
+    wasLoadCancelled = false;
+    isLoaded = !isPartial;
+    loadPhase.store(static_cast<int>(isPartial ? LoadPhase::IDLE : LoadPhase::READY));
+}
+
+void joinLoaderThread()
+{
+    if (!loaderThread) {
+        return;
+    }
+
+    int threadResult = 0;
+    OSJoinThread(loaderThread, &threadResult);
+    free(loaderThread);
+    free(loaderStack);
+    loaderThread = nullptr;
+    loaderStack = nullptr;
+}
+
+void prepareLoad(bool forceReload)
+{
+    isReconcileLoad = forceReload && isLoaded && published->count > 0;
+    isStreamingToCache = !isReconcileLoad;
+    if (isStreamingToCache) {
+        published->count = 0;
+        listGeneration.fetch_add(1, std::memory_order_relaxed);
+        rebuildIndexes();
+    }
+
+    currentTitleId = OSGetTitleID();
+    mergedCount = 0;
+    isChangeCheck = false;
+    wasLoadCancelled = false;
+    isLazyLoad = false;
+    arePlaceholdersMerged = false;
+    areIdsListed.store(false);
+    resolvedRingHead.store(0);
+    resolvedRingTail.store(0);
+    for (int hintSlot = 0; hintSlot < NAME_HINT_SLOTS; hintSlot++) {
+        nameHints[hintSlot].store(0);
+    }
+    streamedCount.store(0);
+    listedCount.store(0);
+    isWorkerFinished.store(false);
+
+    // Not READY from here on, even before the loader thread gets to run
+    loadPhase.store(static_cast<int>(LoadPhase::ENUMERATING));
+}
+
+// Run the load prepareLoad() set up on the loader thread, or inline if
+// the thread can't be created
+void startLoaderThread()
+{
+    loaderThread = static_cast<OSThread*>(memalign(16, sizeof(OSThread)));
+    loaderStack = static_cast<uint8_t*>(memalign(16, LOADER_STACK_SIZE));
+
+    // Off the game's and the menu's core, which keeps MCP/ACP I/O away
+    // from both
+    bool isCreated = loaderThread && loaderStack &&
+                     OSCreateThread(loaderThread, loaderThreadEntry, 0, nullptr,
+                                    loaderStack + LOADER_STACK_SIZE, LOADER_STACK_SIZE,
+                                    24, WorkerThreads::GetAffinity());
+    if (!isCreated) {
+        free(loaderThread);
+        free(loaderStack);
+        loaderThread = nullptr;
+        loaderStack = nullptr;
+        isLazyLoad = false;
+        runEnumeration();
+        publishWorkCache();
+        return;
+    }
+
+    OSSetThreadName(loaderThread, "TitleSwitcher Loader");
+    isWorkerRunning = true;
+    OSResumeThread(loaderThread);
+}
+
+}
+
+void Load(bool forceReload)
+{
+    if (isWorkerRunning) {
+        WaitForLoad();
+        if (!forceReload) {
+            return;
+        }
+    }
+
+    if (isLoaded && !forceReload) {
+        return;
+    }
+
+    prepareLoad(forceReload);
+    runEnumeration();
+    publishWorkCache();
+}
+
+void StartLoadAsync(bool forceReload)
+{
+    if (isWorkerRunning || (isLoaded && !forceReload)) {
+        return;
+    }
+
+    prepareLoad(forceReload);
+    isLazyLoad = !isReconcileLoad && nameResolution == NameResolution::LAZY;
+    startLoaderThread();
+}
+
+bool Update()
+{
+    if (!isWorkerRunning) {
+        return false;
+    }
+
+    if (isWorkerFinished.load(std::memory_order_acquire)) {
+        joinLoaderThread();
+        isWorkerRunning = false;
+
+        // A change check that found nothing leaves the list as it was
+        bool hasChanged = isStagingValid;
+        publishWorkCache();
+        return hasChanged;
+    }
+
+    if (isLazyLoad) {
+        bool hasChanged = false;
+        if (!arePlaceholdersMerged && areIdsListed.load(std::memory_order_acquire)) {
+            mergeListedPlaceholders();
+            hasChanged = true;
+        }
+        if (arePlaceholdersMerged) {
+            hasChanged = drainResolvedTitles() || hasChanged;
+        }
+        return hasChanged;
+    }
+
+    if (isStreamingToCache) {
+        int previousCount = published->count;
+        mergeStreamedTitles();
+        return published->count != previousCount;
+    }
+
+    return false;
+}
+
+bool RefreshIfChanged()
+{
+    if (!isLoaded || isWorkerRunning) {
+        return false;
+    }
+
+    int32_t mcpHandle = MCP_Open();
+    if (mcpHandle < 0) {
+        return false;
+    }
+    int32_t installedTitleCount = MCP_TitleCount(mcpHandle);
+    MCP_Close(mcpHandle);
+
+    if (installedTitleCount > 0 && installedTitleCount != knownInstalledTitleCount) {
+        StartLoadAsync(true);
+        return true;
+    }
+
+    uint64_t runningTitleId = OSGetTitleID();
+    if (runningTitleId != currentTitleId) {
+        switchRunningTitle(runningTitleId);
+        return true;
+    }
+    return false;
+}
+
+bool StartChangeCheck()
+{
+    if (!isLoaded || isWorkerRunning) {
+        return false;
+    }
+
+    uint64_t runningTitleId = OSGetTitleID();
+    if (runningTitleId != currentTitleId) {
+        switchRunningTitle(runningTitleId);
+    }
+
+    prepareLoad(true);
+    isChangeCheck = true;
+    startLoaderThread();
+    return true;
+}
+
+void SetNameResolution(NameResolution mode)
+{
+    nameResolution = mode;
+}
+
+void PrioritizeName(uint64_t titleId)
+{
+    if (!isLazyLoad || !arePlaceholdersMerged) {
+        return;
+    }
+
+    int recordIndex = findRecordById(titleId);
+    if (recordIndex < 0 || (published->flags[recordIndex] & FLAG_NAME_RESOLVED)) {
+        return;
+    }
+
+    for (int hintSlot = 0; hintSlot < NAME_HINT_SLOTS; hintSlot++) {
+        if (nameHints[hintSlot].load(std::memory_order_relaxed) == titleId) {
+            return;
+        }
+    }
+    nameHints[nextNameHintSlot].store(titleId, std::memory_order_relaxed);
+    nextNameHintSlot = (nextNameHintSlot + 1) % NAME_HINT_SLOTS;
+}
+
+void WaitForLoad()
+{
+    if (!isWorkerRunning) {
+        return;
+    }
+
+    joinLoaderThread();
+    isWorkerRunning = false;
+    publishWorkCache();
+}
+
+void CancelLoad()
+{
+    if (!isWorkerRunning) {
+        return;
+    }
+
+    isCancelRequested.store(true, std::memory_order_release);
+    joinLoaderThread();
+    isCancelRequested.store(false, std::memory_order_relaxed);
+    isWorkerRunning = false;
+    publishWorkCache();
+}
+
+LoadState GetLoadState()
+{
+    LoadState state;
+    state.phase = static_cast<LoadPhase>(loadPhase.load());
+    state.resolvedCount = streamedCount.load(std::memory_order_relaxed);
+    state.totalCount = listedCount.load(std::memory_order_relaxed);
+    if (state.phase == LoadPhase::READY) {
+        state.resolvedCount = state.totalCount;
+    }
+    return state;
+}
+
+void SetSortOrder(SortOrder order)
+{
+    if (static_cast<int>(order) < 0 || static_cast<int>(order) >= SORT_ORDER_COUNT) {
+        order = SortOrder::NAME;
+    }
+    if (order != activeSortOrder) {
+        activeSortOrder = order;
+        published->areDisplayPositionsValid = false;
+        listGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SortOrder GetSortOrder()
+{
+    return activeSortOrder;
+}
+
+const char* GetSortOrderName(SortOrder order)
+{
+    switch (order) {
+        case SortOrder::NAME:         return "Name";
+        case SortOrder::TITLE_ID:     return "Title ID";
+        case SortOrder::RECENT:       return "Recent";
+        case SortOrder::RELEASE_YEAR: return "Year";
+    }
+    return "";
+}
+
+void RefreshSortOrders()
+{
+    published->areSortOrdersValid = false;
+    published->areDisplayPositionsValid = false;
+    listGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t GetListGeneration()
+{
+    return listGeneration.load(std::memory_order_relaxed);
+}
+
+bool IsLoaded()
+{
+    return isLoaded;
+}
+
+void Clear()
+{
+    WaitForLoad();
+    releaseBuffer(*published);
+    releaseBuffer(*staging);
+    releaseIndexes();
+    free(removedTitleIds);
+    removedTitleIds = nullptr;
+    listGeneration.fetch_add(1, std::memory_order_relaxed);
+    isLoaded = false;
+    loadPhase.store(static_cast<int>(LoadPhase::IDLE));
+}
+
+void SetMemoryBudget(size_t bytes)
+{
+    memoryBudget = bytes;
+}
+
+size_t GetMemoryUsage()
+{
+    size_t bufferBytes = static_cast<size_t>(published->capacity + staging->capacity) *
+        (sizeof(TitleInfo) + 2 * sizeof(uint64_t) + sizeof(uint32_t) +
+         (3 + SORT_ORDER_COUNT) * sizeof(uint16_t) + sizeof(uint8_t));
+    size_t indexBytes = static_cast<size_t>(idIndexSlotCount) * sizeof(uint16_t) +
+        static_cast<size_t>(codeIndexSlotCount) * (sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t));
+    return bufferBytes + indexBytes;
+}
+
+int GetCount()
+{
+    return published->count;
+}
+
+const TitleInfo* GetTitle(int index)
+{
+    if (index < 0 || index >= published->count) {
+        return nullptr;
+    }
+    return &published->records[getActivePermutation()[index]];
+}
+
+uint64_t GetTitleId(int index)
+{
+    if (index < 0 || index >= published->count) {
+        return 0;
+    }
+    return published->titleIds[getActivePermutation()[index]];
+}
+
+uint32_t GetCategoryMask(int index)
+{
+    if (index < 0 || index >= published->count) {
+        return 0;
+    }
+    if (!published->areCategoryMasksValid ||
+        published->categoryMaskGeneration != Settings::GetMembershipGeneration()) {
+        buildCategoryMasks();
+    }
+    return published->categoryMasks[getActivePermutation()[index]];
+}
+
+const TitlePresets::TitlePreset* GetPreset(int index)
+{
+    if (index < 0 || index >= published->count) {
+        return nullptr;
+    }
+    linkPresets(*published);
+    return getLinkedPreset(*published, getActivePermutation()[index]);
+}
+
+bool GetRecord(int index, TitleRecord* outRecord)
+{
+    if (index < 0 || index >= published->count) {
+        return false;
+    }
+    if (!published->areCategoryMasksValid ||
+        published->categoryMaskGeneration != Settings::GetMembershipGeneration()) {
+        buildCategoryMasks();
+    }
+    linkPresets(*published);
+
+    int recordIndex = getActivePermutation()[index];
+    outRecord->info = &published->records[recordIndex];
+    outRecord->preset = getLinkedPreset(*published, recordIndex);
+    outRecord->categoryMask = published->categoryMasks[recordIndex];
+    outRecord->isNameResolved = (published->flags[recordIndex] & FLAG_NAME_RESOLVED) != 0;
+    return true;
+}
+
+const TitleInfo* FindById(uint64_t titleId)
+{
+    int recordIndex = findRecordById(titleId);
+    return recordIndex >= 0 ? &published->records[recordIndex] : nullptr;
+}
+
+int FindIndexById(uint64_t titleId)
+{
+    int recordIndex = findRecordById(titleId);
+    return recordIndex >= 0 ? getDisplayPosition(recordIndex) : -1;
+}
+
+void GetNameForId(uint64_t titleId, char* outputName, int maxLength)
+{
+    const TitleInfo* cachedTitle = FindById(titleId);
+    if (cachedTitle) {
+        strncpy(outputName, cachedTitle->name, maxLength - 1);
+        outputName[maxLength - 1] = '\0';
+        return;
+    }
+
+    getTitleNameFromSystem(titleId, outputName, maxLength);
+}
+
+const TitleInfo* FindByProductCode(const char* productCode)
+{
+    if (!productCode || productCode[0] == '\0') {
+        return nullptr;
+    }
+
+    int searchLength = strlen(productCode);
+    if (hasCodeIndexOverflowed || codeIndexSlotCount == 0 || searchLength < MIN_INDEXED_CODE_LENGTH ||
+        searchLength > MAX_PRODUCT_CODE || strchr(productCode, '-')) {
+        return findByProductCodeLinear(productCode);
+    }
+
+    uint32_t keyHash = hashProductCode(productCode, searchLength);
+    int slot = keyHash & (codeIndexSlotCount - 1);
+    while (codeIndexRecords[slot] != EMPTY_SLOT) {
+        if (codeIndexHashes[slot] == keyHash && codeIndexLengths[slot] == searchLength) {
+            const TitleInfo& record = published->records[codeIndexRecords[slot] - 1];
+            const char* storedCode = record.productCode;
+            if (strcasecmp(storedCode + strlen(storedCode) - searchLength, productCode) == 0) {
+                return &record;
+            }
         }
+        slot = (slot + 1) & (codeIndexSlotCount - 1);
     }
 
     return nullptr;
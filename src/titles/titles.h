@@ -28,6 +28,9 @@
  *   // At startup (can take a few seconds):
  *   Titles::Load();
  *
+ *   // Or without blocking, polling Update() each frame:
+ *   Titles::StartLoadAsync();
+ *
  *   // Get title count:
  *   int count = Titles::GetCount();
  *
@@ -44,6 +47,14 @@
  * we need to read metadata from each title. The results are cached in memory
  * after the first load, so subsequent calls to Load() return immediately.
  *
+ * The store grows with the library (sized from MCP's title count), up to
+ * the limit that fits in the memory budget; see SetMemoryBudget().
+ *
+ * The metadata is also written to a binary snapshot on the SD card
+ * (Paths::TITLE_SNAPSHOT_FILE), keyed by a hash of the MCP title ID list.
+ * When the installed set is unchanged, a boot reads the snapshot instead of
+ * calling ACPGetTitleMetaXml() for every title.
+ *
  * To force a refresh (e.g., if user installed new games), call:
  *   Titles::Load(true);  // Force reload
  *
@@ -55,6 +66,9 @@
 
 #pragma once
 
+#include "../presets/title_presets.h"
+
+#include <cstddef>
 #include <cstdint>
 
 namespace Titles {
@@ -63,9 +77,12 @@ namespace Titles {
 // Constants
 // =============================================================================
 
-// Maximum number of titles we can store
-// 512 should be more than enough for any Wii U library
-constexpr int MAX_TITLES = 512;
+// Hard ceiling on stored titles (records are addressed by 16-bit indices);
+// the memory budget usually limits the store well before this
+constexpr int MAX_TITLES = 4096;
+
+// Default heap budget for the title store and its indexes (~1700 titles)
+constexpr size_t DEFAULT_MEMORY_BUDGET = 512 * 1024;
 
 // Maximum length of a title name (including null terminator)
 constexpr int MAX_NAME_LENGTH = 64;
@@ -99,6 +116,36 @@ struct TitleInfo {
     char productCode[MAX_PRODUCT_CODE];
 };
 
+// Display orders maintained for the title list
+enum class SortOrder {
+    NAME,           // Alphabetical (case-insensitive)
+    TITLE_ID,       // Ascending 64-bit title ID
+    RECENT,         // Most recently launched first, then by name
+    RELEASE_YEAR    // Newest GameTDB release year first, then by name
+};
+
+constexpr int SORT_ORDER_COUNT = 4;
+
+// How a background load fills in title names
+enum class NameResolution {
+    EAGER,          // Resolve each title before it appears in the list
+    LAZY            // List every ID at once, then resolve names (visible first)
+};
+
+// Progress of the current (or last) title enumeration
+enum class LoadPhase {
+    IDLE,           // Nothing loaded yet
+    ENUMERATING,    // Querying the MCP title list
+    RESOLVING,      // Reading metadata for listed titles
+    READY           // Published list is complete
+};
+
+struct LoadState {
+    LoadPhase phase;
+    int resolvedCount;   // Titles with metadata so far
+    int totalCount;      // Titles reported by MCP (0 until known)
+};
+
 // =============================================================================
 // Loading Functions
 // =============================================================================
@@ -112,8 +159,10 @@ struct TitleInfo {
  * The first call may take several seconds depending on library size.
  * Subsequent calls return immediately unless forceReload is true.
  *
- * @param forceReload If true, clear cache and reload from system even if
- *                    already loaded. Use this after game installs/uninstalls.
+ * @param forceReload If true, re-enumerate from the system even if already
+ *                    loaded. Use this after game installs/uninstalls. An
+ *                    existing cache is reconciled: only newly installed IDs
+ *                    are queried and surviving entries keep their position.
  *
  * Titles are automatically sorted alphabetically by name after loading.
  *
@@ -122,6 +171,86 @@ struct TitleInfo {
  */
 void Load(bool forceReload = false);
 
+/**
+ * Start loading titles on a background thread (pinned to core 2).
+ *
+ * Returns immediately. While the load runs, Update() merges finished entries
+ * into the list so the menu can show a partial, sorted list. A reconcile
+ * (forceReload with an existing list) keeps the old list until it completes.
+ *
+ * Does nothing if a load is already running, or if loaded and !forceReload.
+ */
+void StartLoadAsync(bool forceReload = false);
+
+/**
+ * Publish background load progress. Call once per frame from the main thread.
+ *
+ * @return true if the title list changed (indices from before are stale)
+ */
+bool Update();
+
+/**
+ * Block until a running background load finishes and publish its result.
+ */
+void WaitForLoad();
+
+/**
+ * Stop a running background load after the title it is on and wait for
+ * its thread (call before the application that runs it ends). A reconcile
+ * keeps the list it started from and runs again at the next change check;
+ * a first load leaves nothing loaded and StartLoadAsync() starts over.
+ */
+void CancelLoad();
+
+/**
+ * Cheap change watcher for application starts and menu opens.
+ *
+ * Compares MCP's installed-title count with the one seen at the last load
+ * and starts a background reconcile (StartLoadAsync(true)) only if it
+ * differs, e.g. after a USB drive was attached or a title installed. If a
+ * different application is now running, the previous one is put back in
+ * the list and the new one removed, without any MCP/ACP enumeration.
+ *
+ * Does nothing before the first load or while a load is running.
+ *
+ * @return true if the list changed or a reload was started
+ */
+bool RefreshIfChanged();
+
+/**
+ * RefreshIfChanged() without blocking on MCP, for the warm-up scheduler.
+ *
+ * A change of running application is handled here. The title count is
+ * queried on the loader thread, which goes on to a reconcile only if it
+ * differs; Update() publishes the outcome like any other load, and
+ * GetLoadState() is READY again once it has.
+ *
+ * Does nothing before the first load or while a load is running.
+ *
+ * @return true if the check was started
+ */
+bool StartChangeCheck();
+
+/**
+ * Choose how StartLoadAsync() fills in names (default LAZY).
+ *
+ * In LAZY mode the list appears as soon as MCP returns the ID list, with
+ * hex-ID placeholder names, and names are resolved in the background.
+ * Blocking Load() and reconciles always resolve eagerly.
+ */
+void SetNameResolution(NameResolution mode);
+
+/**
+ * Hint that a title is on screen so its name is resolved next.
+ * Cheap no-op once the name is known or when no lazy load is running.
+ */
+void PrioritizeName(uint64_t titleId);
+
+/**
+ * Get the progress of the current (or last) load.
+ */
+LoadState GetLoadState();
+
 /**
  * Check if titles have been loaded.
  *
@@ -133,10 +262,57 @@ bool IsLoaded();
  * Clear the cached title list.
  *
  * After calling this, GetCount() will return 0 and IsLoaded() will return false.
- * The next call to Load() will re-enumerate titles from the system.
+ * The store's heap is released; the next call to Load() will re-enumerate
+ * titles from the system.
  */
 void Clear();
 
+/**
+ * Cap the heap used by the title store and its lookup indexes.
+ *
+ * Titles past the cap are left out of the list. Takes effect on the next
+ * load; an existing list is never truncated.
+ *
+ * @param bytes Budget in bytes (DEFAULT_MEMORY_BUDGET by default)
+ */
+void SetMemoryBudget(size_t bytes);
+
+/**
+ * Get the bytes currently allocated for the title store and its indexes.
+ */
+size_t GetMemoryUsage();
+
+// =============================================================================
+// Sort Order Functions
+// =============================================================================
+
+/**
+ * Select the order GetTitle() indexes by.
+ *
+ * Every order is precomputed as a permutation when titles are published,
+ * so switching is O(1). Indices from before the switch are stale.
+ */
+void SetSortOrder(SortOrder order);
+
+SortOrder GetSortOrder();
+
+// Short label for the footer/settings (e.g. "Name")
+const char* GetSortOrderName(SortOrder order);
+
+/**
+ * Mark the non-name orders stale after launch history or presets change.
+ * They are rebuilt on next access; no metadata is re-read.
+ */
+void RefreshSortOrders();
+
+/**
+ * Get a counter that changes whenever GetTitle() indices may have moved:
+ * titles added, removed or renamed, a load published, or the sort order
+ * changed. Consumers that cache index lists compare it to know when to
+ * rebuild.
+ */
+uint32_t GetListGeneration();
+
 // =============================================================================
 // Access Functions
 // =============================================================================
@@ -151,7 +327,7 @@ int GetCount();
 /**
  * Get a title by index.
  *
- * @param index Zero-based index (0 to GetCount()-1)
+ * @param index Zero-based index (0 to GetCount()-1) in the active sort order
  * @return Pointer to TitleInfo, or nullptr if index is out of range
  *
  * The returned pointer is valid until Clear() or Load(true) is called.
@@ -164,13 +340,69 @@ int GetCount();
  */
 const TitleInfo* GetTitle(int index);
 
+/**
+ * Get just the title ID at an index (same order as GetTitle()).
+ *
+ * Reads the contiguous ID column without touching the name/code records,
+ * so prefer it in loops that only need IDs.
+ *
+ * @return Title ID, or 0 if index is out of range
+ */
+uint64_t GetTitleId(int index);
+
+/**
+ * Get a title's category membership mask (same order as GetTitle()).
+ *
+ * Bit N is set when the title is assigned to the user category at position
+ * N in Settings::Get().categories; Settings::FAVORITE_MASK_BIT marks
+ * favorites. Masks are rebuilt in one pass when the settings membership
+ * generation changes, so filtering a category is one AND per title.
+ *
+ * @return Membership mask, or 0 if index is out of range
+ */
+uint32_t GetCategoryMask(int index);
+
+/**
+ * Get a title's preset metadata (same order as GetTitle()).
+ *
+ * Titles are matched to presets by product code in one pass, redone only
+ * when the title list or the loaded presets change, so this is an array
+ * read rather than a string lookup.
+ *
+ * @return The title's preset, or nullptr if it has none or index is out of range
+ */
+const TitlePresets::TitlePreset* GetPreset(int index);
+
+/**
+ * Everything the menu shows for one title, read at one record from the
+ * store's columns (see GetRecord()).
+ */
+struct TitleRecord {
+    const TitleInfo* info;
+    const TitlePresets::TitlePreset* preset;  // nullptr if the title has none
+    uint32_t categoryMask;                    // As GetCategoryMask()
+    bool isNameResolved;                      // False while a lazy load shows the hex ID
+};
+
+/**
+ * Get a title's record (same order as GetTitle()).
+ *
+ * One permutation lookup, then one read per column at that record, so
+ * drawing a row needs no ID-keyed lookups in Settings or TitlePresets.
+ * Category masks and preset links are brought up to date first, as in
+ * GetCategoryMask() and GetPreset().
+ *
+ * @return false (leaving outRecord untouched) if index is out of range
+ */
+bool GetRecord(int index, TitleRecord* outRecord);
+
 /**
  * Find a title by its ID.
  *
  * @param titleId The 64-bit title ID to search for
  * @return Pointer to TitleInfo, or nullptr if not found
  *
- * This performs a linear search through the title list.
+ * This is a constant-time hash lookup.
  *
  * Example:
  *   const auto* mkart = Titles::FindById(0x000500001010EC00);  // Mario Kart 8 USA
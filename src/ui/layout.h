@@ -7,6 +7,14 @@
  * - User-customizable font scale, list width, icon size
  * - Pixel-perfect rendering (font heights divide evenly into resolution)
  *
+ * HOW IT WORKS:
+ * -------------
+ * ComputeLayout() is constexpr, and so is all the data it reads, so the
+ * layout of every screen type with default preferences is worked out at
+ * compile time (DEFAULT_LAYOUTS). GetCurrentLayout() hands those out as
+ * they are and only computes a layout at runtime for custom preferences.
+ * The web preview includes this header too, so both always agree.
+ *
  * USAGE:
  * ------
  *   // Get layout for current screen with default preferences
@@ -52,9 +60,9 @@ struct Rect {
     int width;
     int height;
 
-    int Right() const { return x + width; }
-    int Bottom() const { return y + height; }
-    bool Contains(int px, int py) const {
+    constexpr int Right() const { return x + width; }
+    constexpr int Bottom() const { return y + height; }
+    constexpr bool Contains(int px, int py) const {
         return px >= x && px < Right() && py >= y && py < Bottom();
     }
 };
@@ -66,11 +74,11 @@ struct Panel {
     int contentHeight;
     int rowHeight;
 
-    int GetVisibleRows() const {
+    constexpr int GetVisibleRows() const {
         return rowHeight > 0 ? contentHeight / rowHeight : 0;
     }
 
-    int GetRowY(int row) const {
+    constexpr int GetRowY(int row) const {
         return contentY + (row * rowHeight);
     }
 };
@@ -84,9 +92,17 @@ struct LayoutPreferences {
     int listWidthPercent;   // 25-50, default 30
     int iconSizePercent;    // 50-150, default 100
 
-    static LayoutPreferences Default() {
+    static constexpr LayoutPreferences Default() {
         return { 100, 30, 100 };
     }
+
+    constexpr bool operator==(const LayoutPreferences& other) const {
+        return fontScale == other.fontScale && listWidthPercent == other.listWidthPercent &&
+               iconSizePercent == other.iconSizePercent;
+    }
+    constexpr bool operator!=(const LayoutPreferences& other) const {
+        return !(*this == other);
+    }
 };
 
 // =============================================================================
@@ -126,6 +142,23 @@ struct PixelLayout {
     // Icon size (separate field for clarity, used by details.icon)
     int iconSize;
 
+    // Browse grid view: square cells of a smaller icon, filling the
+    // content area above a caption row for the selected title's name
+    struct Grid {
+        Rect area;          // Top-left cell's corner to the bottom-right's
+        int iconSize;
+        int cellSize;       // iconSize plus the gap between icons
+        int columns;
+        int rows;
+
+        constexpr int GetCellCount() const { return columns * rows; }
+
+        // Icon of the cell at (column, row) of the visible cells
+        constexpr Rect GetIconRect(int column, int row) const {
+            return { area.x + column * cellSize, area.y + row * cellSize, iconSize, iconSize };
+        }
+    } grid;
+
     // Divider decorations
     struct Dividers {
         const char* header;         // e.g., "--------------------"
@@ -134,22 +167,22 @@ struct PixelLayout {
     } dividers;
 
     // Helper: Get row Y position in left panel
-    int GetLeftPanelRowY(int row) const {
+    constexpr int GetLeftPanelRowY(int row) const {
         return leftPanel.GetRowY(row);
     }
 
     // Helper: Get row Y position in right panel
-    int GetRightPanelRowY(int row) const {
+    constexpr int GetRightPanelRowY(int row) const {
         return rightPanel.GetRowY(row);
     }
 
     // Helper: Get maximum characters that fit in left panel
-    int GetLeftPanelMaxChars() const {
+    constexpr int GetLeftPanelMaxChars() const {
         return font.charWidth > 0 ? leftPanel.width / font.charWidth : 0;
     }
 
     // Helper: Get maximum characters that fit in right panel
-    int GetRightPanelMaxChars() const {
+    constexpr int GetRightPanelMaxChars() const {
         return font.charWidth > 0 ? rightPanel.width / font.charWidth : 0;
     }
 };
@@ -165,17 +198,237 @@ struct ScreenInfo {
     bool is4x3;
 };
 
-const ScreenInfo& GetScreenInfo(ScreenType type);
+inline constexpr ScreenInfo SCREEN_INFO[] = {
+    { 854,  480,  "DRC (GamePad)", false },
+    { 1920, 1080, "TV 1080p",      false },
+    { 1280, 720,  "TV 720p",       false },
+    { 640,  480,  "TV 480p (4:3)", true  },
+};
+
+constexpr int SCREEN_TYPE_COUNT = static_cast<int>(ScreenType::COUNT);
+
+// Out-of-range types get the DRC's
+constexpr int GetScreenIndex(ScreenType type) {
+    int idx = static_cast<int>(type);
+    return idx >= 0 && idx < SCREEN_TYPE_COUNT ? idx : 0;
+}
+
+constexpr const ScreenInfo& GetScreenInfo(ScreenType type) {
+    return SCREEN_INFO[GetScreenIndex(type)];
+}
 
 // =============================================================================
-// Layout Access
+// Base Layout Values Per Resolution
+// =============================================================================
+
+struct BaseValues {
+    int fontSize;
+    int lineHeight;
+    int charWidth;
+    int iconSize;
+    int margin;
+    int headerHeight;
+    int footerHeight;
+    int categoryBarHeight;
+    int panelGap;
+};
+
+inline constexpr BaseValues BASE_VALUES[] = {
+    // DRC: 854x480 - close viewing, smaller text OK
+    { 16, 24, 8, 128, 8, 24, 24, 24, 16 },
+
+    // TV 1080p: 1920x1080 - far viewing, larger text
+    { 24, 36, 12, 192, 16, 36, 36, 36, 24 },
+
+    // TV 720p: 1280x720 - medium distance
+    { 20, 30, 10, 160, 12, 30, 30, 30, 20 },
+
+    // TV 480p: 640x480 - 4:3 aspect, compact
+    { 16, 24, 8, 96, 8, 24, 24, 24, 12 },
+};
+
+// =============================================================================
+// Divider Strings
+// =============================================================================
+
+inline constexpr const char* HEADER_DIVIDER_60 = "------------------------------------------------------------";
+inline constexpr const char* HEADER_DIVIDER_80 = "--------------------------------------------------------------------------------";
+inline constexpr const char* SECTION_UNDERLINE = "--------";
+
+// =============================================================================
+// Layout Computation
 // =============================================================================
 
 /**
  * Compute layout for a screen type with given preferences.
- * This is the core function that builds a PixelLayout.
+ * This is the core function that builds a PixelLayout; constexpr so the
+ * default layouts below cost nothing at runtime.
  */
-PixelLayout ComputeLayout(ScreenType screen, const LayoutPreferences& prefs);
+constexpr PixelLayout ComputeLayout(ScreenType screen, const LayoutPreferences& prefs) {
+    const ScreenInfo& info = GetScreenInfo(screen);
+    const BaseValues& base = BASE_VALUES[GetScreenIndex(screen)];
+
+    PixelLayout layout = {};
+
+    // Screen dimensions
+    layout.screenWidth = info.width;
+    layout.screenHeight = info.height;
+
+    // Font metrics (adjusted by fontScale preference)
+    int scaledFontSize = (base.fontSize * prefs.fontScale) / 100;
+    int scaledLineHeight = (base.lineHeight * prefs.fontScale) / 100;
+    int scaledCharWidth = (base.charWidth * prefs.fontScale) / 100;
+
+    // Ensure minimum sizes
+    if (scaledFontSize < 8) scaledFontSize = 8;
+    if (scaledLineHeight < 12) scaledLineHeight = 12;
+    if (scaledCharWidth < 4) scaledCharWidth = 4;
+
+    layout.font.size = scaledFontSize;
+    layout.font.lineHeight = scaledLineHeight;
+    layout.font.charWidth = scaledCharWidth;
+
+    // Icon size (adjusted by iconSizePercent preference)
+    layout.iconSize = (base.iconSize * prefs.iconSizePercent) / 100;
+    if (layout.iconSize < 48) layout.iconSize = 48;
+
+    // Chrome heights (scale with font)
+    int categoryBarHeight = (base.categoryBarHeight * prefs.fontScale) / 100;
+    int headerHeight = (base.headerHeight * prefs.fontScale) / 100;
+    int footerHeight = (base.footerHeight * prefs.fontScale) / 100;
+
+    // Category bar at top
+    layout.chrome.categoryBar = {
+        0,
+        0,
+        info.width,
+        categoryBarHeight
+    };
+
+    // Header below category bar
+    layout.chrome.header = {
+        0,
+        categoryBarHeight,
+        info.width,
+        headerHeight
+    };
+
+    // Footer at bottom
+    layout.chrome.footer = {
+        0,
+        info.height - footerHeight,
+        info.width,
+        footerHeight
+    };
+
+    // Content area (between header and footer)
+    int contentTop = categoryBarHeight + headerHeight;
+    int contentBottom = info.height - footerHeight;
+    int contentHeight = contentBottom - contentTop;
+
+    // Panel widths (listWidthPercent determines left panel)
+    int leftPanelWidth = (info.width * prefs.listWidthPercent) / 100;
+    int panelGap = base.panelGap;
+    int rightPanelX = leftPanelWidth + panelGap;
+    int rightPanelWidth = info.width - rightPanelX - base.margin;
+
+    // Left panel
+    layout.leftPanel = {
+        base.margin,
+        leftPanelWidth - base.margin,
+        contentTop,
+        contentHeight,
+        scaledLineHeight
+    };
+
+    // Right panel
+    layout.rightPanel = {
+        rightPanelX,
+        rightPanelWidth,
+        contentTop,
+        contentHeight,
+        scaledLineHeight
+    };
+
+    // Details section layout (within right panel)
+    // Title area at top of right panel
+    layout.details.titleArea = {
+        rightPanelX,
+        contentTop,
+        rightPanelWidth,
+        scaledLineHeight * 2
+    };
+
+    // Icon below title
+    int iconY = contentTop + scaledLineHeight * 2 + base.margin;
+    layout.details.icon = {
+        rightPanelX + (rightPanelWidth - layout.iconSize) / 2,
+        iconY,
+        layout.iconSize,
+        layout.iconSize
+    };
+
+    // Info area below icon
+    int infoY = iconY + layout.iconSize + base.margin;
+    int infoHeight = contentBottom - infoY;
+    layout.details.infoArea = {
+        rightPanelX,
+        infoY,
+        rightPanelWidth,
+        infoHeight > 0 ? infoHeight : 0
+    };
+
+    // Grid view: icons at half the details size, spaced by the margin,
+    // centered in the content area less the caption row
+    layout.grid.iconSize = (base.iconSize / 2 * prefs.iconSizePercent) / 100;
+    if (layout.grid.iconSize < 32) layout.grid.iconSize = 32;
+    layout.grid.cellSize = layout.grid.iconSize + base.margin;
+
+    int gridWidth = info.width - base.margin;
+    int gridHeight = contentHeight - scaledLineHeight + base.margin;
+    layout.grid.columns = gridWidth / layout.grid.cellSize;
+    layout.grid.rows = gridHeight / layout.grid.cellSize;
+    if (layout.grid.columns < 1) layout.grid.columns = 1;
+    if (layout.grid.rows < 1) layout.grid.rows = 1;
+    layout.grid.area = {
+        base.margin + (gridWidth - layout.grid.columns * layout.grid.cellSize) / 2,
+        contentTop + (gridHeight - layout.grid.rows * layout.grid.cellSize) / 2,
+        layout.grid.columns * layout.grid.cellSize - base.margin,
+        layout.grid.rows * layout.grid.cellSize - base.margin
+    };
+
+    // Divider strings based on panel width
+    int dividerChars = rightPanelWidth / scaledCharWidth;
+    if (dividerChars >= 80) {
+        layout.dividers.header = HEADER_DIVIDER_80;
+        layout.dividers.headerLength = 80;
+    } else {
+        layout.dividers.header = HEADER_DIVIDER_60;
+        layout.dividers.headerLength = 60;
+    }
+    layout.dividers.sectionShort = SECTION_UNDERLINE;
+
+    return layout;
+}
+
+// Every screen type with default preferences, built at compile time
+inline constexpr PixelLayout DEFAULT_LAYOUTS[] = {
+    ComputeLayout(ScreenType::DRC, LayoutPreferences::Default()),
+    ComputeLayout(ScreenType::TV_1080P, LayoutPreferences::Default()),
+    ComputeLayout(ScreenType::TV_720P, LayoutPreferences::Default()),
+    ComputeLayout(ScreenType::TV_480P, LayoutPreferences::Default()),
+};
+
+static_assert(sizeof(DEFAULT_LAYOUTS) / sizeof(DEFAULT_LAYOUTS[0]) == SCREEN_TYPE_COUNT,
+              "One default layout per screen type");
+
+constexpr const PixelLayout& GetDefaultLayout(ScreenType type) {
+    return DEFAULT_LAYOUTS[GetScreenIndex(type)];
+}
+
+// =============================================================================
+// Layout Access
+// =============================================================================
 
 /**
  * Get the current screen type.
@@ -183,6 +436,11 @@ PixelLayout ComputeLayout(ScreenType screen, const LayoutPreferences& prefs);
  */
 ScreenType GetCurrentScreenType();
 
+/**
+ * Set the current screen type (updates cached layout).
+ */
+void SetCurrentScreenType(ScreenType type);
+
 /**
  * Get the current preferences from settings.
  * Returns default preferences if settings not loaded.
@@ -195,8 +453,8 @@ const LayoutPreferences& GetCurrentPreferences();
 void SetCurrentPreferences(const LayoutPreferences& prefs);
 
 /**
- * Get cached layout for current screen type and preferences.
- * Recomputes if preferences have changed.
+ * Get the layout for the current screen type and preferences: the
+ * compile-time default, or a cached one computed for custom preferences.
  */
 const PixelLayout& GetCurrentLayout();
 
@@ -8,6 +8,8 @@
 #include "render/measurements.h"
 #include "menu/menu.h"
 
+#include <coreinit/time.h>
+
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
@@ -61,6 +63,7 @@ void State::MoveSelection(int delta, int visibleRows, bool wrap) {
         return;
     }
 
+    lastMoveDelta = delta;
     int newIndex = selectedIndex + delta;
 
     if (wrap) {
@@ -85,39 +88,94 @@ void State::MoveSelection(int delta, int visibleRows, bool wrap) {
     Clamp(visibleRows);
 }
 
-void HandleInput(State& state, uint32_t pressed, const Config& config) {
-    if (state.itemCount <= 0) {
-        return;
-    }
+namespace {
 
+// The move a navigation button asks for, or 0. Page beats skip beats step
+// when several are down at once
+int getNavDelta(uint32_t buttons, const Config& config, uint32_t* outButton) {
     int delta = 0;
+    uint32_t button = 0;
 
-    if (Buttons::Actions::NAV_UP.Pressed(pressed)) {
-        delta = -1;
+    if (Buttons::Actions::NAV_UP.Pressed(buttons)) {
+        delta = -config.step;
+        button = Buttons::Actions::NAV_UP.input;
     }
-    if (Buttons::Actions::NAV_DOWN.Pressed(pressed)) {
-        delta = 1;
+    if (Buttons::Actions::NAV_DOWN.Pressed(buttons)) {
+        delta = config.step;
+        button = Buttons::Actions::NAV_DOWN.input;
     }
 
-    if (Buttons::Actions::NAV_SKIP_UP.Pressed(pressed)) {
+    if (Buttons::Actions::NAV_SKIP_UP.Pressed(buttons)) {
         delta = -config.smallSkip;
+        button = Buttons::Actions::NAV_SKIP_UP.input;
     }
-    if (Buttons::Actions::NAV_SKIP_DOWN.Pressed(pressed)) {
+    if (Buttons::Actions::NAV_SKIP_DOWN.Pressed(buttons)) {
         delta = config.smallSkip;
+        button = Buttons::Actions::NAV_SKIP_DOWN.input;
     }
 
     if (!config.canReorder) {
-        if (Buttons::Actions::NAV_PAGE_UP.Pressed(pressed)) {
+        if (Buttons::Actions::NAV_PAGE_UP.Pressed(buttons)) {
             delta = -config.largeSkip;
+            button = Buttons::Actions::NAV_PAGE_UP.input;
         }
-        if (Buttons::Actions::NAV_PAGE_DOWN.Pressed(pressed)) {
+        if (Buttons::Actions::NAV_PAGE_DOWN.Pressed(buttons)) {
             delta = config.largeSkip;
+            button = Buttons::Actions::NAV_PAGE_DOWN.input;
         }
     }
 
+    *outButton = button;
+    return delta;
+}
+
+// Wrap-safe: true once nowMs has reached targetMs
+bool hasReached(uint32_t nowMs, uint32_t targetMs) {
+    return static_cast<int32_t>(nowMs - targetMs) >= 0;
+}
+
+}
+
+void HandleInput(State& state, uint32_t pressed, uint32_t held, const Config& config) {
+    uint32_t nowMs = static_cast<uint32_t>(OSTicksToMilliseconds(OSGetSystemTime()));
+    HandleInputAt(state, pressed, held, nowMs, config);
+}
+
+void HandleInputAt(State& state, uint32_t pressed, uint32_t held, uint32_t nowMs, const Config& config) {
+    if (state.itemCount <= 0) {
+        state.repeatButton = 0;
+        return;
+    }
+
+    uint32_t button = 0;
+    int delta = getNavDelta(pressed, config, &button);
     if (delta != 0) {
         state.MoveSelection(delta, config.visibleRows, config.wrapAround);
+        state.repeatButton = button;
+        state.repeatStartMs = nowMs;
+        state.nextRepeatMs = nowMs + REPEAT_DELAY_MS;
+        return;
+    }
+
+    if (state.repeatButton == 0 || (held & state.repeatButton) == 0) {
+        state.repeatButton = 0;
+        return;
+    }
+    if (!hasReached(nowMs, state.nextRepeatMs)) {
+        return;
     }
+
+    delta = getNavDelta(state.repeatButton, config, &button);
+    uint32_t heldMs = nowMs - state.repeatStartMs;
+    if ((delta == config.step || delta == -config.step) && heldMs >= REPEAT_ACCEL_AFTER_MS) {
+        delta *= REPEAT_ACCEL_STEP;
+    }
+    state.MoveSelection(delta, config.visibleRows, false);
+
+    // From now rather than the missed deadline, so a slow frame can't
+    // queue a burst of moves
+    uint32_t interval = heldMs >= REPEAT_FAST_AFTER_MS ? REPEAT_FAST_INTERVAL_MS : REPEAT_INTERVAL_MS;
+    state.nextRepeatMs = nowMs + interval;
 }
 
 Action GetAction(uint32_t pressed, const Config& config) {
@@ -160,62 +218,85 @@ Action GetAction(uint32_t pressed, const Config& config) {
     return Action::NONE;
 }
 
-void Render(const State& state, const Config& config, RenderCallback getItem) {
-    if (!getItem) {
-        return;
-    }
+void RenderEmpty(const Config& config) {
+    Renderer::DrawText(config.col, config.row, "(empty)");
+}
 
-    if (state.itemCount <= 0) {
-        Renderer::DrawText(config.col, config.row, "(empty)");
-        return;
+namespace {
+
+// FNV-1a over everything a row's line depends on
+uint32_t hashBytes(uint32_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
     }
+    return hash;
+}
 
-    for (int i = 0; i < config.visibleRows; i++) {
-        int itemIndex = state.scrollOffset + i;
-        if (itemIndex >= state.itemCount) {
-            break;
-        }
+uint32_t hashString(uint32_t hash, const char* text) {
+    return hashBytes(hash, text ? text : "", text ? strlen(text) + 1 : 1);
+}
 
-        bool isSelected = (itemIndex == state.selectedIndex);
-        ItemView view = getItem(itemIndex, isSelected);
+uint32_t hashRow(const Config& config, int itemIndex, const ItemView& view) {
+    uint32_t hash = hashBytes(2166136261u, &itemIndex, sizeof(itemIndex));
+    hash = hashBytes(hash, &config.width, sizeof(config.width));
+    hash = hashBytes(hash, &config.showLineNumbers, sizeof(config.showLineNumbers));
+    hash = hashString(hash, view.prefix);
+    hash = hashString(hash, view.text);
+    return hashString(hash, view.suffix);
+}
 
-        char line[128];
-        int pos = 0;
+void formatRow(char* line, size_t lineSize, const Config& config, int itemIndex, const ItemView& view) {
+    int pos = 0;
 
-        if (config.showLineNumbers) {
-            pos += snprintf(line + pos, sizeof(line) - pos, "%3d.", itemIndex + 1);
-        }
+    if (config.showLineNumbers) {
+        pos += snprintf(line + pos, lineSize - pos, "%3d.", itemIndex + 1);
+    }
 
-        const char* prefix = view.prefix ? view.prefix : "  ";
-        pos += snprintf(line + pos, sizeof(line) - pos, "%s", prefix);
+    const char* prefix = view.prefix ? view.prefix : "  ";
+    pos += snprintf(line + pos, lineSize - pos, "%s", prefix);
 
-        int prefixLen = strlen(prefix);
-        int suffixLen = view.suffix ? strlen(view.suffix) : 0;
-        int numberLen = config.showLineNumbers ? 4 : 0;
-        int maxTextLen = config.width - prefixLen - suffixLen - numberLen - 1;
-        if (maxTextLen < 1) {
-            maxTextLen = 1;
-        }
+    int prefixLen = strlen(prefix);
+    int suffixLen = view.suffix ? strlen(view.suffix) : 0;
+    int numberLen = config.showLineNumbers ? 4 : 0;
+    int maxTextLen = config.width - prefixLen - suffixLen - numberLen - 1;
+    if (maxTextLen < 1) {
+        maxTextLen = 1;
+    }
 
-        const char* text = view.text ? view.text : "";
-        int textLen = strlen(text);
-        if (textLen > maxTextLen) {
-            pos += snprintf(line + pos, sizeof(line) - pos, "%.*s~", maxTextLen - 1, text);
-        } else {
-            pos += snprintf(line + pos, sizeof(line) - pos, "%-*s", maxTextLen, text);
-        }
+    const char* text = view.text ? view.text : "";
+    int textLen = strlen(text);
+    if (textLen > maxTextLen) {
+        pos += snprintf(line + pos, lineSize - pos, "%.*s~", maxTextLen - 1, text);
+    } else {
+        pos += snprintf(line + pos, lineSize - pos, "%-*s", maxTextLen, text);
+    }
 
-        if (view.suffix && view.suffix[0] != '\0') {
-            snprintf(line + pos, sizeof(line) - pos, "%s", view.suffix);
-        }
+    if (view.suffix && view.suffix[0] != '\0') {
+        snprintf(line + pos, lineSize - pos, "%s", view.suffix);
+    }
+}
+
+}
 
-        uint32_t color = view.dimmed ? 0x888888FF : view.textColor;
-        Renderer::DrawText(config.col, config.row + i, line, color);
+void RenderRow(const Config& config, int row, int itemIndex, const ItemView& view, RowCache* cache) {
+    uint32_t color = view.dimmed ? 0x888888FF : view.textColor;
+
+    if (!cache || row < 0 || row >= RowCache::MAX_ROWS) {
+        char line[RowCache::MAX_LINE];
+        formatRow(line, sizeof(line), config, itemIndex, view);
+        Renderer::DrawText(config.col, config.row + row, line, color);
+        return;
     }
 
-    if (config.showScrollIndicators) {
-        RenderScrollIndicators(state, config);
+    // Color isn't part of the key: it's passed to DrawText, not formatted
+    uint32_t key = hashRow(config, itemIndex, view);
+    if (cache->keys[row] != key) {
+        formatRow(cache->lines[row], sizeof(cache->lines[row]), config, itemIndex, view);
+        cache->keys[row] = key;
     }
+    Renderer::DrawText(config.col, config.row + row, cache->lines[row], color);
 }
 
 void RenderScrollIndicators(const State& state, const Config& config) {
@@ -273,6 +354,16 @@ Config BrowseModeConfig(int visibleRows) {
     return config;
 }
 
+Config BrowseGridConfig(int columns, int rows) {
+    Config config;
+    config.visibleRows = columns * rows;
+    config.step = columns;
+    config.smallSkip = 1;
+    config.largeSkip = columns * rows;
+    config.canFavorite = true;
+    return config;
+}
+
 Config EditModeConfig(int visibleRows) {
     Config config;
     config.visibleRows = visibleRows;
@@ -5,7 +5,6 @@
 #pragma once
 
 #include <cstdint>
-#include <functional>
 
 namespace UI {
 namespace ListView {
@@ -18,6 +17,8 @@ struct Config {
     bool showLineNumbers = false;
     bool showScrollIndicators = true;
     bool wrapAround = false;
+    // Up/Down move this many items (a grid's column count)
+    int step = 1;
     int smallSkip = 5;
     int largeSkip = 15;
     bool canConfirm = true;
@@ -33,6 +34,15 @@ struct State {
     int scrollOffset = 0;
     int itemCount = 0;
 
+    // Requested delta of the last MoveSelection (sign is the direction of
+    // travel, magnitude tells a step from a skip); read by icon prefetch
+    int lastMoveDelta = 0;
+
+    // Held-direction repeat, in milliseconds of system time (see HandleInput)
+    uint32_t repeatButton = 0;
+    uint32_t repeatStartMs = 0;
+    uint32_t nextRepeatMs = 0;
+
     void SetItemCount(int count, int visibleRows);
     void Clamp(int visibleRows);
     void MoveSelection(int delta, int visibleRows, bool wrap);
@@ -47,7 +57,16 @@ struct ItemView {
     bool dimmed = false;
 };
 
-using RenderCallback = std::function<ItemView(int index, bool isSelected)>;
+// Formatted rows kept between frames, for a list drawn every frame (the
+// browse list): a row whose view hasn't changed is drawn from here
+// without formatting it again
+struct RowCache {
+    static constexpr int MAX_ROWS = 32;
+    static constexpr int MAX_LINE = 128;
+
+    uint32_t keys[MAX_ROWS] = {};
+    char lines[MAX_ROWS][MAX_LINE] = {};
+};
 
 enum class Action {
     NONE,
@@ -60,11 +79,55 @@ enum class Action {
     MOVE_DOWN,
 };
 
-void HandleInput(State& state, uint32_t pressed, const Config& config);
+// Key repeat for held directions: a press moves at once, holding repeats
+// after REPEAT_DELAY_MS, faster after REPEAT_FAST_AFTER_MS, and single
+// steps grow to REPEAT_ACCEL_STEP rows after REPEAT_ACCEL_AFTER_MS.
+// Repeats stop at either end of the list instead of wrapping
+constexpr uint32_t REPEAT_DELAY_MS = 320;
+constexpr uint32_t REPEAT_INTERVAL_MS = 60;
+constexpr uint32_t REPEAT_FAST_AFTER_MS = 1000;
+constexpr uint32_t REPEAT_FAST_INTERVAL_MS = 30;
+constexpr uint32_t REPEAT_ACCEL_AFTER_MS = 2500;
+constexpr int REPEAT_ACCEL_STEP = 4;
+
+// Navigation from this frame's triggered and held buttons
+void HandleInput(State& state, uint32_t pressed, uint32_t held, const Config& config);
+// The same at a given time, for callers and tests that own the clock
+void HandleInputAt(State& state, uint32_t pressed, uint32_t held, uint32_t nowMs, const Config& config);
 Action GetAction(uint32_t pressed, const Config& config);
-void Render(const State& state, const Config& config, RenderCallback getItem);
 void RenderScrollIndicators(const State& state, const Config& config);
 
+// Render() building blocks: the placeholder for an empty list, and one
+// visible row (row 0 is the top of the list)
+void RenderEmpty(const Config& config);
+void RenderRow(const Config& config, int row, int itemIndex, const ItemView& view, RowCache* cache = nullptr);
+
+/**
+ * Draw the visible rows. getItem is any callable taking (int index, bool
+ * isSelected) and returning an ItemView, usually a lambda; as a template
+ * argument it is called directly, once per visible row, rather than
+ * through a std::function.
+ */
+template <typename GetItem>
+void Render(const State& state, const Config& config, GetItem&& getItem, RowCache* cache = nullptr) {
+    if (state.itemCount <= 0) {
+        RenderEmpty(config);
+        return;
+    }
+
+    for (int row = 0; row < config.visibleRows; row++) {
+        int itemIndex = state.scrollOffset + row;
+        if (itemIndex >= state.itemCount) {
+            break;
+        }
+        RenderRow(config, row, itemIndex, getItem(itemIndex, itemIndex == state.selectedIndex), cache);
+    }
+
+    if (config.showScrollIndicators) {
+        RenderScrollIndicators(state, config);
+    }
+}
+
 inline bool IsScrollable(const State& state, const Config& config) {
     return state.itemCount > config.visibleRows;
 }
@@ -85,6 +148,9 @@ Config LeftPanelConfig(int visibleRows = -1);
 Config DetailsPanelConfig(int rowOffset, int visibleRows);
 Config InputOnlyConfig(int visibleRows);
 Config BrowseModeConfig(int visibleRows);
+// Browse as a grid of cells, row by row: Up/Down a row, Left/Right a
+// cell, L/R a screenful
+Config BrowseGridConfig(int columns, int rows);
 Config EditModeConfig(int visibleRows);
 
 } // namespace ListView
@@ -0,0 +1,64 @@
+/**
+ * VPADRead Hook Statistics Implementation
+ *
+ * See hook_stats.h for usage documentation.
+ */
+
+#include "hook_stats.h"
+
+#include <atomic>
+
+namespace HookStats {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+std::atomic<uint32_t> sCalls{0};
+std::atomic<uint64_t> sTotalTicks{0};
+std::atomic<uint64_t> sMaxTicks{0};
+
+uint32_t ticksToNanos(uint64_t ticks)
+{
+    uint64_t nanos = static_cast<uint64_t>(OSTicksToNanoseconds(static_cast<OSTime>(ticks)));
+    return nanos > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(nanos);
+}
+
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void Record(OSTime ticks)
+{
+    uint64_t elapsed = ticks > 0 ? static_cast<uint64_t>(ticks) : 0;
+
+    sCalls.store(sCalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sTotalTicks.store(sTotalTicks.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    if (elapsed > sMaxTicks.load(std::memory_order_relaxed)) {
+        sMaxTicks.store(elapsed, std::memory_order_relaxed);
+    }
+}
+
+Stats Get()
+{
+    Stats stats = {};
+    stats.calls = sCalls.load(std::memory_order_relaxed);
+    if (stats.calls > 0) {
+        stats.avgNanos = ticksToNanos(sTotalTicks.load(std::memory_order_relaxed) / stats.calls);
+        stats.maxNanos = ticksToNanos(sMaxTicks.load(std::memory_order_relaxed));
+    }
+    return stats;
+}
+
+void Reset()
+{
+    sCalls.store(0);
+    sTotalTicks.store(0);
+    sMaxTicks.store(0);
+}
+
+}
@@ -0,0 +1,42 @@
+/**
+ * VPADRead Hook Statistics
+ *
+ * What the plugin's VPADRead hook adds to every game input read: how many
+ * calls, and their average and worst time. Shown on the debug panel, so a
+ * change that slows the hook shows up on real hardware.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The hook times itself with two timebase reads and calls Record() on the
+ * way out. Calls that open the full-screen menu aren't recorded: they
+ * return only when the menu closes. Record() does two relaxed loads and
+ * stores per figure, no locks or read-modify-write loops; a call racing
+ * another thread's may be lost, which is fine for diagnostics.
+ *
+ * USAGE:
+ * ------
+ *   OSTime start = OSGetSystemTime();
+ *   ...
+ *   HookStats::Record(OSGetSystemTime() - start);
+ *
+ *   HookStats::Stats stats = HookStats::Get();
+ */
+
+#pragma once
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+namespace HookStats {
+
+struct Stats {
+    uint32_t calls;
+    uint32_t avgNanos;
+    uint32_t maxNanos;
+};
+
+void Record(OSTime ticks);
+Stats Get();
+void Reset();
+
+}
@@ -0,0 +1,115 @@
+/**
+ * Memory Budget Implementation
+ *
+ * See memory_budget.h for usage documentation.
+ */
+
+#include "memory_budget.h"
+
+namespace MemoryBudget {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+struct Registration {
+    UsageFunction usage;
+    ShrinkFunction shrink;
+};
+
+Registration sPools[POOL_COUNT] = {};
+uint32_t sReliefCounts[PRESSURE_COUNT] = {};
+size_t sLastFreedBytes = 0;
+
+constexpr const char* POOL_NAMES[POOL_COUNT] = {
+    "Standby", "Icons", "Font", "Presets", "Titles"
+};
+
+constexpr const char* PRESSURE_NAMES[PRESSURE_COUNT] = {
+    "moderate", "critical"
+};
+
+}
+
+// =============================================================================
+// Registration
+// =============================================================================
+
+const char* GetPoolName(Pool pool)
+{
+    return POOL_NAMES[static_cast<int>(pool)];
+}
+
+const char* GetPressureName(Pressure pressure)
+{
+    return PRESSURE_NAMES[static_cast<int>(pressure)];
+}
+
+void Register(Pool pool, UsageFunction usage, ShrinkFunction shrink)
+{
+    sPools[static_cast<int>(pool)] = {usage, shrink};
+}
+
+void Unregister(Pool pool)
+{
+    sPools[static_cast<int>(pool)] = {};
+}
+
+bool IsRegistered(Pool pool)
+{
+    return sPools[static_cast<int>(pool)].usage != nullptr;
+}
+
+size_t GetUsage(Pool pool)
+{
+    UsageFunction usage = sPools[static_cast<int>(pool)].usage;
+    return usage ? usage() : 0;
+}
+
+size_t GetTotalUsage()
+{
+    size_t total = 0;
+    for (int poolIndex = 0; poolIndex < POOL_COUNT; poolIndex++) {
+        total += GetUsage(static_cast<Pool>(poolIndex));
+    }
+    return total;
+}
+
+// =============================================================================
+// Relief
+// =============================================================================
+
+size_t Relieve(Pressure pressure, size_t targetBytes)
+{
+    size_t freed = 0;
+    for (int poolIndex = 0; poolIndex < POOL_COUNT && freed < targetBytes; poolIndex++) {
+        Pool pool = static_cast<Pool>(poolIndex);
+        ShrinkFunction shrink = sPools[poolIndex].shrink;
+        if (!shrink) continue;
+
+        size_t before = GetUsage(pool);
+        shrink(pressure);
+        size_t after = GetUsage(pool);
+        if (after < before) {
+            freed += before - after;
+        }
+    }
+
+    sReliefCounts[static_cast<int>(pressure)]++;
+    sLastFreedBytes = freed;
+    return freed;
+}
+
+uint32_t GetReliefCount(Pressure pressure)
+{
+    return sReliefCounts[static_cast<int>(pressure)];
+}
+
+size_t GetLastFreedBytes()
+{
+    return sLastFreedBytes;
+}
+
+}
@@ -0,0 +1,87 @@
+/**
+ * Memory Budget
+ *
+ * One place that knows what each subsystem holds on to between menu opens
+ * and how to get it back, so a game that needs memory - or a menu open
+ * that can't find enough for its framebuffers - can take it from whoever
+ * can spare it most cheaply. Shown on the debug panel.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Each pool registers a usage function and, if it can give memory back, a
+ * shrink function. Relieve() calls the shrink functions in Pool order, the
+ * cheapest to rebuild first, and stops once the target is freed. A shrink
+ * function gets the pressure and decides how far to go:
+ *
+ *   MODERATE  A game just started (ON_APPLICATION_START). Give back what
+ *             the closed menu doesn't need; the next open may be slower.
+ *   CRITICAL  Something failed for lack of memory. Give back everything
+ *             that can be rebuilt later, even if that means reading it
+ *             from SD again.
+ *
+ * What was freed is measured from the usage functions before and after,
+ * so a shrink function doesn't have to count. Pools nobody registered
+ * read as unused. Everything here runs on the thread that owns the menu.
+ *
+ * USAGE:
+ * ------
+ *   MemoryBudget::Register(MemoryBudget::Pool::ICONS, getIconBytes, shrinkIcons);
+ *
+ *   MemoryBudget::Relieve(MemoryBudget::Pressure::MODERATE);
+ *
+ *   if (!Renderer::Init()) {
+ *       MemoryBudget::Relieve(MemoryBudget::Pressure::CRITICAL);
+ *       ...retry
+ *   }
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MemoryBudget {
+
+// In the order Relieve() shrinks them
+enum class Pool {
+    STANDBY_FRAMEBUFFERS,   // Renderer's idle OSScreen framebuffers
+    ICONS,                  // Decoded and compressed icons in ImageStore
+    FONT,                   // Default font and its glyph atlas textures
+    PRESETS,                // TitlePresets database and indexes
+    TITLES,                 // Titles store and lookup indexes
+    COUNT
+};
+
+constexpr int POOL_COUNT = static_cast<int>(Pool::COUNT);
+
+enum class Pressure {
+    MODERATE,
+    CRITICAL,
+    COUNT
+};
+
+constexpr int PRESSURE_COUNT = static_cast<int>(Pressure::COUNT);
+
+using UsageFunction = size_t (*)();
+using ShrinkFunction = void (*)(Pressure pressure);
+
+const char* GetPoolName(Pool pool);
+const char* GetPressureName(Pressure pressure);
+
+// Replace a pool's functions. shrink may be null for a pool that is only
+// reported
+void Register(Pool pool, UsageFunction usage, ShrinkFunction shrink = nullptr);
+void Unregister(Pool pool);
+bool IsRegistered(Pool pool);
+
+size_t GetUsage(Pool pool);
+size_t GetTotalUsage();
+
+// Shrink pools in order until targetBytes are freed; returns bytes freed
+size_t Relieve(Pressure pressure, size_t targetBytes = SIZE_MAX);
+
+// How often each pressure was relieved, and what the last call freed
+uint32_t GetReliefCount(Pressure pressure);
+size_t GetLastFreedBytes();
+
+}
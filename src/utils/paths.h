@@ -19,7 +19,11 @@
  *     │       └── plugins/
  *     │           ├── TitleSwitcherPlugin.wps    (plugin binary)
  *     │           └── config/
- *     │               └── TitleSwitcher_presets.json (metadata)
+ *     │               ├── TitleSwitcher_presets.json (metadata)
+ *     │               └── TitleSwitcher/
+ *     │                   ├── icons/                 (icon cache)
+ *     │                   ├── titles.bin             (title metadata snapshot)
+ *     │                   └── trace.json             (tracing builds only)
  *     │
  *     ├── plugins/
  *     │   └── config/
@@ -67,6 +71,26 @@ constexpr const char* AROMA_CONFIG_DIR = "fs:/vol/external01/wiiu/environments/a
 // Can be regenerated with: tools/convert_gametdb.py
 constexpr const char* PRESETS_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher_presets.json";
 
+// Precompiled form of the presets file, preferred when present
+constexpr const char* PRESETS_BINARY_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher_presets.bin";
+
+// Plugin cache directory (icon cache, title metadata snapshot)
+constexpr const char* CACHE_DIR = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher";
+
+// Binary snapshot of installed title metadata, written by Titles::Load()
+constexpr const char* TITLE_SNAPSHOT_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher/titles.bin";
+
+// Chrome trace of the last menu session, written on close by tracing
+// builds (make TRACE=1, see utils/trace.h)
+constexpr const char* TRACE_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher/trace.json";
+
+// Buttons of the last menu session, written on close by recording builds
+// (make RECORD=1, see input/input_recorder.h)
+constexpr const char* INPUT_RECORDING_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher/input.rec";
+
+// A recording to play back instead of reading the GamePad, while present
+constexpr const char* INPUT_REPLAY_FILE = "fs:/vol/external01/wiiu/environments/aroma/plugins/config/TitleSwitcher/replay.rec";
+
 // User content directory (for pixel editor saves, etc.)
 constexpr const char* USER_DATA_DIR = "fs:/vol/external01/wiiu/titleswitcher";
 
@@ -82,6 +106,7 @@ constexpr const char* SETTINGS_FILENAME = "TitleSwitcher.json";
 
 // Presets filename
 constexpr const char* PRESETS_FILENAME = "TitleSwitcher_presets.json";
+constexpr const char* PRESETS_BINARY_FILENAME = "TitleSwitcher_presets.bin";
 
 // =============================================================================
 // WUPS Storage Namespace
@@ -0,0 +1,132 @@
+/**
+ * Startup Profile Implementation
+ *
+ * See startup_profile.h for usage documentation.
+ */
+
+#include "startup_profile.h"
+#include "../storage/file_storage.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace StartupProfile {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "FileStorage",
+    "Settings",
+    "Menu",
+    "ImageLoader",
+    "Titles start",
+    "Initialize",
+    "Enumeration",
+    "Presets"
+};
+
+const char* const COUNTER_NAMES[COUNTER_COUNT] = {
+    "Titles",
+    "ACP calls",
+    "Presets",
+    "Bytes read"
+};
+
+// Zero means not recorded yet; a recorded phase is at least 1us
+std::atomic<uint32_t> sPhaseMicros[PHASE_COUNT];
+std::atomic<uint32_t> sCounters[COUNTER_COUNT];
+std::atomic<bool> sIsFinished{false};
+
+bool isValid(int index, int count)
+{
+    return index >= 0 && index < count;
+}
+
+uint32_t getBytesRead()
+{
+    uint64_t bytesRead = FileStorage::GetBytesRead();
+    return bytesRead > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(bytesRead);
+}
+
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+const char* GetPhaseName(Phase phase)
+{
+    int phaseIndex = static_cast<int>(phase);
+    return isValid(phaseIndex, PHASE_COUNT) ? PHASE_NAMES[phaseIndex] : "?";
+}
+
+const char* GetCounterName(Counter counter)
+{
+    int counterIndex = static_cast<int>(counter);
+    return isValid(counterIndex, COUNTER_COUNT) ? COUNTER_NAMES[counterIndex] : "?";
+}
+
+void RecordPhase(Phase phase, uint32_t micros)
+{
+    int phaseIndex = static_cast<int>(phase);
+    if (!isValid(phaseIndex, PHASE_COUNT)) {
+        return;
+    }
+
+    uint32_t unrecorded = 0;
+    sPhaseMicros[phaseIndex].compare_exchange_strong(unrecorded, micros > 0 ? micros : 1);
+}
+
+void Add(Counter counter, uint32_t amount)
+{
+    int counterIndex = static_cast<int>(counter);
+    if (!isValid(counterIndex, COUNTER_COUNT) || sIsFinished.load(std::memory_order_relaxed)) {
+        return;
+    }
+    sCounters[counterIndex].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Finish()
+{
+    if (sIsFinished.exchange(true)) {
+        return;
+    }
+
+    sCounters[static_cast<int>(Counter::BYTES_READ)].store(getBytesRead());
+}
+
+// =============================================================================
+// Queries
+// =============================================================================
+
+bool IsFinished()
+{
+    return sIsFinished.load();
+}
+
+bool IsPhaseRecorded(Phase phase)
+{
+    return GetPhaseMicros(phase) != 0;
+}
+
+uint32_t GetPhaseMicros(Phase phase)
+{
+    int phaseIndex = static_cast<int>(phase);
+    return isValid(phaseIndex, PHASE_COUNT) ? sPhaseMicros[phaseIndex].load() : 0;
+}
+
+uint32_t GetCounter(Counter counter)
+{
+    // Until startup is over, bytes read so far
+    if (counter == Counter::BYTES_READ && !IsFinished()) {
+        return getBytesRead();
+    }
+    int counterIndex = static_cast<int>(counter);
+    return isValid(counterIndex, COUNTER_COUNT) ? sCounters[counterIndex].load() : 0;
+}
+
+}
@@ -0,0 +1,99 @@
+/**
+ * Startup Profile
+ *
+ * How long each part of plugin startup took and how much work it did, so
+ * a change that slows console boot shows up on real hardware. Shown on
+ * the debug panel.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Startup runs from INITIALIZE_PLUGIN() until the first title enumeration
+ * finishes on the loader thread, which then calls Finish(). Enumeration is
+ * a warm-up job (see Warmup), so this spans the first grace period too. Each phase is
+ * timed by a Scope and kept the first time it runs only, so a later
+ * reload or menu open can't overwrite the boot figures. Counters are only
+ * added to while startup is running. Phases and counters may be recorded
+ * from any thread.
+ *
+ * USAGE:
+ * ------
+ *   {
+ *       StartupProfile::Scope scope(StartupProfile::Phase::SETTINGS);
+ *       Settings::Load();
+ *   }
+ *   StartupProfile::Add(StartupProfile::Counter::ACP_CALLS, 1);
+ *
+ *   uint32_t micros = StartupProfile::GetPhaseMicros(StartupProfile::Phase::SETTINGS);
+ */
+
+#pragma once
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+namespace StartupProfile {
+
+// INITIALIZE_PLUGIN() steps, then the background work that follows
+enum class Phase {
+    FILE_STORAGE,       // FileStorage::Init
+    SETTINGS,           // Settings::Init, Load and SettingsWriter::Init
+    MENU,               // Menu::Init
+    IMAGE_LOADER,       // ImageLoader::Init
+    TITLES_START,       // Titles::StartLoadAsync, from the warm-up job
+    INITIALIZE,         // All of INITIALIZE_PLUGIN()
+    TITLE_ENUMERATION,  // First title enumeration, on the loader thread
+    PRESET_LOAD,        // First TitlePresets::Load, if it ran during startup
+    COUNT
+};
+
+constexpr int PHASE_COUNT = static_cast<int>(Phase::COUNT);
+
+enum class Counter {
+    TITLES_ENUMERATED,
+    ACP_CALLS,
+    PRESETS_PARSED,
+    BYTES_READ,         // Everything read through FileStorage
+    COUNT
+};
+
+constexpr int COUNTER_COUNT = static_cast<int>(Counter::COUNT);
+
+const char* GetPhaseName(Phase phase);
+const char* GetCounterName(Counter counter);
+
+// Keep a phase's time unless the phase was already recorded
+void RecordPhase(Phase phase, uint32_t micros);
+
+// Add to a counter while startup is running
+void Add(Counter counter, uint32_t amount);
+
+// Startup is over; counters stop and BYTES_READ keeps FileStorage's total
+void Finish();
+
+bool IsFinished();
+bool IsPhaseRecorded(Phase phase);
+uint32_t GetPhaseMicros(Phase phase);
+uint32_t GetCounter(Counter counter);
+
+/**
+ * Times the enclosing block into a phase.
+ */
+class Scope {
+public:
+    explicit Scope(Phase phase) : mPhase(phase), mStart(OSGetSystemTime()) {}
+    ~Scope()
+    {
+        RecordPhase(mPhase, static_cast<uint32_t>(OSTicksToMicroseconds(OSGetSystemTime() - mStart)));
+    }
+
+    OSTime GetStart() const { return mStart; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Phase mPhase;
+    OSTime mStart;
+};
+
+}
@@ -0,0 +1,136 @@
+/**
+ * Event Tracing Implementation
+ *
+ * See trace.h for usage documentation.
+ */
+
+#include "trace.h"
+
+#ifdef ENABLE_TRACING
+
+#include "paths.h"
+#include "../storage/file_storage.h"
+
+#include <coreinit/thread.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Trace {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+struct Event {
+    OSTime time;
+    const char* name;
+    uint32_t threadId;
+    char phase;         // 'B' or 'E', as in the trace format
+};
+
+// Longest line one event formats to, name included
+constexpr size_t MAX_EVENT_JSON = 192;
+
+Event sEvents[MAX_EVENTS];
+
+// Claimed slots; can run past MAX_EVENTS, the excess being dropped events
+std::atomic<uint32_t> sNextEvent{0};
+
+void record(const char* name, char phase, OSTime time)
+{
+    uint32_t slot = sNextEvent.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= static_cast<uint32_t>(MAX_EVENTS)) {
+        return;
+    }
+
+    Event& event = sEvents[slot];
+    event.time = time;
+    event.name = name;
+    event.threadId = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(OSGetCurrentThread()));
+    event.phase = phase;
+}
+
+}
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+void Begin(const char* name)
+{
+    record(name, 'B', OSGetSystemTime());
+}
+
+void End(const char* name)
+{
+    record(name, 'E', OSGetSystemTime());
+}
+
+void Complete(const char* name, OSTime start, OSTime end)
+{
+    record(name, 'B', start);
+    record(name, 'E', end);
+}
+
+// =============================================================================
+// Output
+// =============================================================================
+
+void Flush()
+{
+    uint32_t claimed = sNextEvent.load(std::memory_order_acquire);
+    int eventCount = claimed < static_cast<uint32_t>(MAX_EVENTS) ? static_cast<int>(claimed) : MAX_EVENTS;
+    uint32_t droppedCount = claimed - static_cast<uint32_t>(eventCount);
+    if (eventCount == 0) {
+        return;
+    }
+
+    // Timestamps are written relative to the earliest event
+    OSTime baseTime = sEvents[0].time;
+    for (int eventIndex = 1; eventIndex < eventCount; eventIndex++) {
+        if (sEvents[eventIndex].time < baseTime) {
+            baseTime = sEvents[eventIndex].time;
+        }
+    }
+
+    size_t capacity = (static_cast<size_t>(eventCount) + 2) * MAX_EVENT_JSON;
+    char* json = static_cast<char*>(malloc(capacity));
+    if (!json) {
+        return;
+    }
+
+    size_t length = static_cast<size_t>(snprintf(json, capacity, "{\"traceEvents\":[\n"));
+    for (int eventIndex = 0; eventIndex < eventCount; eventIndex++) {
+        const Event& event = sEvents[eventIndex];
+        int written = snprintf(json + length, MAX_EVENT_JSON,
+                               "{\"name\":\"%.96s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u},\n",
+                               event.name, event.phase,
+                               static_cast<unsigned long long>(OSTicksToMicroseconds(event.time - baseTime)),
+                               static_cast<unsigned>(event.threadId));
+        if (written > 0) {
+            length += static_cast<size_t>(written) < MAX_EVENT_JSON ? static_cast<size_t>(written) : MAX_EVENT_JSON - 1;
+        }
+    }
+
+    // The trailing metadata event also closes the list without a stray comma
+    int written = snprintf(json + length, capacity - length,
+                           "{\"name\":\"dropped_events\",\"ph\":\"M\",\"pid\":1,\"args\":{\"count\":%u}}\n"
+                           "],\"displayTimeUnit\":\"ms\"}\n",
+                           static_cast<unsigned>(droppedCount));
+    if (written > 0) {
+        length += static_cast<size_t>(written);
+    }
+
+    sNextEvent.store(0, std::memory_order_release);
+
+    // Takes ownership of json
+    FileStorage::WriteAsync(Paths::TRACE_FILE, reinterpret_cast<uint8_t*>(json), length);
+}
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * Event Tracing
+ *
+ * A timeline of what the plugin spends its time on, written to SD as a
+ * Chrome trace (Paths::TRACE_FILE) for chrome://tracing or Perfetto.
+ *
+ * Only built with ENABLE_TRACING (make TRACE=1). Otherwise the macros
+ * expand to nothing and Flush() is an empty inline, so release builds pay
+ * nothing for the trace points.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Events go into a preallocated buffer of MAX_EVENTS, claimed with one
+ * atomic add, so any thread can record without locking or allocating.
+ * Once the buffer is full, later events are counted and dropped. Flush()
+ * formats the buffer as JSON, queues it as an asynchronous write and
+ * starts over.
+ *
+ * Names must be string literals (or otherwise outlive the next Flush()),
+ * since only the pointer is stored.
+ *
+ * USAGE:
+ * ------
+ *   void loadThing()
+ *   {
+ *       TRACE_SCOPE("Load thing");   // Begin now, end at the closing brace
+ *       ...
+ *   }
+ *
+ *   Trace::Flush();                  // On menu close
+ */
+
+#pragma once
+
+#ifdef ENABLE_TRACING
+
+#include <coreinit/time.h>
+#include <cstdint>
+
+namespace Trace {
+
+// Events kept between flushes (each begin and end is one event)
+constexpr int MAX_EVENTS = 8192;
+
+void Begin(const char* name);
+void End(const char* name);
+
+// A span that has already finished, e.g. one timed elsewhere
+void Complete(const char* name, OSTime start, OSTime end);
+
+// Queue everything recorded so far for writing to Paths::TRACE_FILE
+void Flush();
+
+class Scope {
+public:
+    explicit Scope(const char* name) : mName(name) { Begin(name); }
+    ~Scope() { End(mName); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* mName;
+};
+
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_BEGIN(name) Trace::Begin(name)
+#define TRACE_END(name) Trace::End(name)
+
+#else
+
+namespace Trace {
+
+inline void Flush() {}
+
+}
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name) ((void)0)
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * Worker Thread Placement Implementation
+ *
+ * See worker_threads.h for usage documentation.
+ */
+
+#include "worker_threads.h"
+
+#include <coreinit/mutex.h>
+
+namespace WorkerThreads {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+// Long-lived workers; the image loader's is the only one today
+constexpr int MAX_REGISTERED = 4;
+
+OSThread* sRegistered[MAX_REGISTERED] = {};
+
+// No core to avoid until the menu first opens
+uint32_t sAvoidedCore = 0xFFFFFFFF;
+
+// Set up on first use, which is ImageLoader::Init() in INITIALIZE_PLUGIN,
+// before any other thread can get here
+OSMutex sMutex;
+bool sIsMutexReady = false;
+
+void lock()
+{
+    if (!sIsMutexReady) {
+        OSInitMutex(&sMutex);
+        sIsMutexReady = true;
+    }
+    OSLockMutex(&sMutex);
+}
+
+}
+
+// =============================================================================
+// Placement
+// =============================================================================
+
+uint32_t GetAffinity()
+{
+    return sAvoidedCore == 2 ? OS_THREAD_ATTRIB_AFFINITY_CPU0 : OS_THREAD_ATTRIB_AFFINITY_CPU2;
+}
+
+void AvoidCore(uint32_t coreId)
+{
+    lock();
+    if (coreId != sAvoidedCore) {
+        sAvoidedCore = coreId;
+        uint32_t affinity = GetAffinity();
+        for (OSThread* thread : sRegistered) {
+            if (thread) {
+                OSSetThreadAffinity(thread, affinity);
+            }
+        }
+    }
+    OSUnlockMutex(&sMutex);
+}
+
+void Register(OSThread* thread)
+{
+    lock();
+    for (OSThread*& slot : sRegistered) {
+        if (!slot) {
+            slot = thread;
+            break;
+        }
+    }
+    OSUnlockMutex(&sMutex);
+}
+
+void Unregister(OSThread* thread)
+{
+    lock();
+    for (OSThread*& slot : sRegistered) {
+        if (slot == thread) {
+            slot = nullptr;
+        }
+    }
+    OSUnlockMutex(&sMutex);
+}
+
+}
@@ -0,0 +1,41 @@
+/**
+ * Worker Thread Placement
+ *
+ * Keeps the plugin's background threads (image decoding, title loading,
+ * file I/O, settings writes) off the core the menu is running on, so the
+ * menu and its loaders don't both crowd the game's threads on one core.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * The menu runs on whichever thread the game calls VPADRead() from, so its
+ * core is only known once it opens; Menu::Open() passes it to AvoidCore().
+ * Threads created afterwards take GetAffinity(), and long-lived threads
+ * added with Register() are moved at once. Workers use core 2 unless the
+ * menu is there, in which case they use core 0.
+ *
+ * USAGE:
+ * ------
+ *   OSCreateThread(thread, entry, 0, nullptr, stackTop, stackSize,
+ *                  24, WorkerThreads::GetAffinity());
+ *   WorkerThreads::Register(thread);     // Long-lived threads only
+ *   WorkerThreads::Unregister(thread);   // Before the thread is freed
+ */
+
+#pragma once
+
+#include <coreinit/thread.h>
+#include <cstdint>
+
+namespace WorkerThreads {
+
+// The menu runs on this core; move workers elsewhere
+void AvoidCore(uint32_t coreId);
+
+// OS_THREAD_ATTRIB_AFFINITY_* for a new worker thread
+uint32_t GetAffinity();
+
+// Keep a running thread on the worker core through later AvoidCore() calls
+void Register(OSThread* thread);
+void Unregister(OSThread* thread);
+
+}
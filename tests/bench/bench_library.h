@@ -0,0 +1,48 @@
+/**
+ * Generated libraries for the benchmarks
+ *
+ * One LibraryFixture library per scale, sized so every part of it grows
+ * with the scale, and helpers that hand it to the stores under test.
+ */
+
+#pragma once
+
+#include "../fixtures/library_fixture.h"
+#include "../mocks/storage/file_storage_mock.h"
+#include "../mocks/titles/titles_mock.h"
+#include "presets/title_presets.h"
+#include "storage/settings.h"
+#include "utils/paths.h"
+
+namespace BenchLibrary {
+
+inline LibraryFixture::Library generate(int scale) {
+    LibraryFixture::Options options;
+    options.titleCount = scale;
+    options.presetCount = scale;
+    options.assignmentCount = scale;
+    options.favoriteCount = scale / 3;
+    return LibraryFixture::Generate(options);
+}
+
+// Serve the preset file and load it (no binary cache)
+inline void loadPresets(const LibraryFixture::Library& library) {
+    MockFileStorage::Reset();
+    MockFileStorage::SetFile(Paths::PRESETS_FILE, library.presetJson);
+    TitlePresets::Load();
+}
+
+// Fresh settings holding the library's favorites and categories
+inline void assignSettings(const LibraryFixture::Library& library) {
+    Settings::Init();
+    LibraryFixture::ApplySettings(library);
+}
+
+// Titles, presets and settings
+inline void load(const LibraryFixture::Library& library) {
+    loadPresets(library);
+    assignSettings(library);
+    MockTitles::SetTitles(library.titles);
+}
+
+} // namespace BenchLibrary
@@ -0,0 +1,164 @@
+/**
+ * Micro-Benchmark Harness Implementation
+ *
+ * See benchmark.h for usage documentation.
+ */
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Bench {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+struct Registration {
+    const char* name;
+    Function function;
+};
+
+// Function-local so registrations from other files' static initializers
+// never see it unconstructed
+std::vector<Registration>& getRegistrations()
+{
+    static std::vector<Registration> registrations;
+    return registrations;
+}
+
+constexpr int64_t DEFAULT_MIN_NANOSECONDS = 100 * 1000 * 1000;
+constexpr int64_t MAX_BATCH_SIZE = int64_t(1) << 40;
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void formatDuration(double nanoseconds, char* buffer, size_t bufferSize)
+{
+    if (nanoseconds < 1000.0) {
+        snprintf(buffer, bufferSize, "%.1f ns", nanoseconds);
+    } else if (nanoseconds < 1000.0 * 1000.0) {
+        snprintf(buffer, bufferSize, "%.2f us", nanoseconds / 1000.0);
+    } else {
+        snprintf(buffer, bufferSize, "%.2f ms", nanoseconds / (1000.0 * 1000.0));
+    }
+}
+
+}
+
+// =============================================================================
+// State
+// =============================================================================
+
+State::State(int scale, int64_t minNanoseconds)
+    : mScale(scale), mMinNanoseconds(minNanoseconds), mBatchSize(1), mRemaining(0),
+      mBatchStart(-1), mLastBatchSize(0), mLastBatchNanoseconds(0)
+{
+}
+
+bool State::KeepRunning()
+{
+    if (mBatchStart < 0) {
+        mRemaining = mBatchSize;
+        mBatchStart = now();
+    }
+
+    if (mRemaining > 0) {
+        mRemaining--;
+        return true;
+    }
+
+    int64_t elapsed = now() - mBatchStart;
+    mLastBatchSize = mBatchSize;
+    mLastBatchNanoseconds = elapsed;
+    if (elapsed >= mMinNanoseconds || mBatchSize >= MAX_BATCH_SIZE) {
+        return false;
+    }
+
+    // Aim past the minimum from what this batch took, growing at most 10x
+    int64_t nextSize = mBatchSize * 10;
+    if (elapsed > 0) {
+        nextSize = std::min(nextSize, static_cast<int64_t>(mBatchSize * 1.4 * mMinNanoseconds / elapsed));
+    }
+    mBatchSize = std::max(nextSize, mBatchSize * 2);
+
+    mRemaining = mBatchSize - 1;
+    mBatchStart = now();
+    return true;
+}
+
+double State::GetNanosecondsPerIteration() const
+{
+    return mLastBatchSize > 0 ? static_cast<double>(mLastBatchNanoseconds) / mLastBatchSize : 0.0;
+}
+
+// =============================================================================
+// Registration
+// =============================================================================
+
+bool Register(const char* name, Function function)
+{
+    getRegistrations().push_back({ name, function });
+    return true;
+}
+
+}
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+int main(int argc, char** argv)
+{
+    int64_t minNanoseconds = Bench::DEFAULT_MIN_NANOSECONDS;
+    const char* prefix = "";
+    for (int arg = 1; arg < argc; arg++) {
+        if (strcmp(argv[arg], "--quick") == 0) {
+            minNanoseconds = 0;
+        } else {
+            prefix = argv[arg];
+        }
+    }
+
+    printf("%-40s", "Benchmark (time per iteration)");
+    for (int scale : Bench::SCALES) {
+        printf("%14d", scale);
+    }
+    printf("\n");
+
+    int runCount = 0;
+    for (const Bench::Registration& registration : Bench::getRegistrations()) {
+        if (strncmp(registration.name, prefix, strlen(prefix)) != 0) {
+            continue;
+        }
+
+        printf("%-40s", registration.name);
+        fflush(stdout);
+        for (int scale : Bench::SCALES) {
+            Bench::State state(scale, minNanoseconds);
+            registration.function(state);
+
+            char duration[32];
+            Bench::formatDuration(state.GetNanosecondsPerIteration(), duration, sizeof(duration));
+            printf("%14s", duration);
+            fflush(stdout);
+        }
+        printf("\n");
+        runCount++;
+    }
+
+    if (runCount == 0) {
+        fprintf(stderr, "No benchmark matches '%s'\n", prefix);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * Micro-Benchmark Harness
+ *
+ * Times the plugin's hot paths on the host so an optimization can come
+ * with before/after numbers. Not a substitute for measuring on hardware:
+ * the host is many times faster, but the ratios between scales, and
+ * between two builds, carry over.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Each benchmark runs once per scale (SCALES, the item counts that matter
+ * on the console). Setup before the loop is not timed; the clock starts at
+ * the first KeepRunning(). The loop body is repeated in doubling batches
+ * until a batch takes at least the minimum time, and that batch gives the
+ * reported time per iteration.
+ *
+ * USAGE:
+ * ------
+ *   BENCHMARK(Settings_IsFavorite)
+ *   {
+ *       setUpFavorites(state.GetScale());   // Not timed
+ *       while (state.KeepRunning()) {
+ *           Bench::DoNotOptimize(Settings::IsFavorite(nextId()));
+ *       }
+ *   }
+ *
+ *   ./run_benchmarks                 // Everything
+ *   ./run_benchmarks Settings_       // Names starting with Settings_
+ *   ./run_benchmarks --quick         // One short batch each (smoke test)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Bench {
+
+// Item counts each benchmark runs at: a small library, the old title
+// cap, and a library the size of the preset database
+constexpr int SCALES[] = { 64, 512, 2048 };
+constexpr int SCALE_COUNT = sizeof(SCALES) / sizeof(SCALES[0]);
+
+class State {
+public:
+    State(int scale, int64_t minNanoseconds);
+
+    // Items to set up for this run
+    int GetScale() const { return mScale; }
+
+    // True while the loop body should run again
+    bool KeepRunning();
+
+    // Average time of one loop body in the final batch
+    double GetNanosecondsPerIteration() const;
+
+private:
+    int mScale;
+    int64_t mMinNanoseconds;
+    int64_t mBatchSize;
+    int64_t mRemaining;
+    int64_t mBatchStart;
+    int64_t mLastBatchSize;
+    int64_t mLastBatchNanoseconds;
+};
+
+using Function = void (*)(State& state);
+
+// Add a benchmark to the run; used by BENCHMARK()
+bool Register(const char* name, Function function);
+
+// Keep the compiler from discarding a result nothing reads
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
+
+#define BENCHMARK(name)                                                        \
+    static void name(Bench::State& state);                                     \
+    static const bool name##Registered = Bench::Register(#name, name);         \
+    static void name(Bench::State& state)
@@ -0,0 +1,99 @@
+/**
+ * Benchmarks for src/menu/categories.cpp
+ *
+ * Times rebuilding the filtered title list, which happens whenever the
+ * category, search text, facets or membership change.
+ */
+
+#include "benchmark.h"
+#include "bench_library.h"
+#include "menu/categories.h"
+
+namespace {
+
+// Rebuild the current view from scratch on every iteration
+void runRefresh(Bench::State& state) {
+    while (state.KeepRunning()) {
+        MockTitles::Touch();
+        Categories::RefreshFilter();
+        Bench::DoNotOptimize(Categories::GetFilteredCount());
+    }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Category Filter
+// =============================================================================
+
+BENCHMARK(Categories_FilterAll) {
+    BenchLibrary::load(BenchLibrary::generate(state.GetScale()));
+    Categories::ClearFacetFilter();
+    Categories::ClearSearch();
+    Categories::SelectCategory(Categories::CATEGORY_ALL);
+    runRefresh(state);
+}
+
+BENCHMARK(Categories_FilterUserCategory) {
+    BenchLibrary::load(BenchLibrary::generate(state.GetScale()));
+    Categories::ClearFacetFilter();
+    Categories::ClearSearch();
+    Categories::SelectCategory(Categories::FIRST_USER_CATEGORY);
+    runRefresh(state);
+}
+
+BENCHMARK(Categories_FilterAfterMembershipChange) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::load(library);
+    Categories::ClearFacetFilter();
+    Categories::ClearSearch();
+    Categories::SelectCategory(Categories::CATEGORY_FAVORITES);
+
+    // Each toggle moves the membership generation, so masks and the view
+    // are rebuilt like after a favorite change on the console
+    int index = 0;
+    while (state.KeepRunning()) {
+        Settings::ToggleFavorite(library.titles[index].titleId);
+        Categories::RefreshFilter();
+        Bench::DoNotOptimize(Categories::GetFilteredCount());
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
+
+// =============================================================================
+// Search and Facets
+// =============================================================================
+
+BENCHMARK(Categories_Search) {
+    BenchLibrary::load(BenchLibrary::generate(state.GetScale()));
+    Categories::ClearFacetFilter();
+    Categories::SelectCategory(Categories::CATEGORY_ALL);
+
+    // Alternate queries so each call filters again; the index stays built
+    int query = 0;
+    while (state.KeepRunning()) {
+        Categories::SetSearchQuery(query ? "mario" : "quest");
+        Bench::DoNotOptimize(Categories::GetFilteredCount());
+        query ^= 1;
+    }
+    Categories::ClearSearch();
+}
+
+BENCHMARK(Categories_FacetGenre) {
+    BenchLibrary::load(BenchLibrary::generate(state.GetScale()));
+    Categories::ClearSearch();
+    Categories::SelectCategory(Categories::CATEGORY_ALL);
+
+    Facets::Filter filters[2] = {};
+    Facets::SetValue(filters[0], Facets::Field::GENRE, "action");
+    Facets::SetValue(filters[1], Facets::Field::GENRE, "racing");
+
+    int filter = 0;
+    while (state.KeepRunning()) {
+        Categories::SetFacetFilter(filters[filter]);
+        Bench::DoNotOptimize(Categories::GetFilteredCount());
+        filter ^= 1;
+    }
+    Categories::ClearFacetFilter();
+}
@@ -0,0 +1,151 @@
+/**
+ * Benchmarks for src/storage/image_store.cpp
+ *
+ * Times the memory cache the icon loader checks for every visible row,
+ * and the decoding and scaling a cache miss pays for on the worker.
+ * Icon files are served from memory by the FileStorage mock, so the
+ * decode and scale numbers leave out the card.
+ */
+
+#include "benchmark.h"
+#include "bench_library.h"
+#include "storage/image_store.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int ICON_SIDE = 128;
+constexpr int CACHED_ICON_SIDE = 32;
+constexpr uint64_t ICON_TITLE_ID = 0x0005000010101D00ull;
+
+Renderer::ImageHandle makeIcon(int side) {
+    Renderer::ImageData* image = new Renderer::ImageData();
+    image->pixels = static_cast<uint32_t*>(calloc(static_cast<size_t>(side) * side, sizeof(uint32_t)));
+    image->width = side;
+    image->height = side;
+    return image;
+}
+
+// Uncompressed 32-bpp top-down TGA, like a title's iconTex.tga, with a
+// gradient so no two rows are alike
+std::string makeIconTex() {
+    std::string tga(18, '\0');
+    tga[2] = 2;
+    tga[12] = ICON_SIDE & 0xFF;
+    tga[13] = ICON_SIDE >> 8;
+    tga[14] = ICON_SIDE & 0xFF;
+    tga[15] = ICON_SIDE >> 8;
+    tga[16] = 32;
+    tga[17] = 0x20;
+    for (int y = 0; y < ICON_SIDE; y++) {
+        for (int x = 0; x < ICON_SIDE; x++) {
+            tga += static_cast<char>(x * 2);
+            tga += static_cast<char>(y * 2);
+            tga += static_cast<char>(x + y);
+            tga += static_cast<char>(0xFF);
+        }
+    }
+    return tga;
+}
+
+// A fresh store whose memory cache is filled by one small icon per title
+void fillCache(const LibraryFixture::Library& library) {
+    Renderer::ImageHandle probe = makeIcon(CACHED_ICON_SIDE);
+    size_t iconBytes = ImageStore::GetImageBytes(probe);
+    ImageStore::FreeImage(probe);
+
+    ImageStore::Init(iconBytes * library.titles.size());
+    for (const Titles::TitleInfo& title : library.titles) {
+        ImageStore::StoreInMemoryCache(title.titleId, makeIcon(CACHED_ICON_SIDE));
+    }
+}
+
+// Only the SD icon folder, read and decoded on every load
+void startDecodeOnlyStore() {
+    MockFileStorage::Reset();
+    ImageStore::Init();
+    ImageStore::SetSourceEnabled(ImageStore::Source::ICON_PACK, false);
+    ImageStore::SetSourceEnabled(ImageStore::Source::NAND, false);
+    ImageStore::SetWriteEnabled(ImageStore::Source::ICON_PACK, false);
+
+    char path[160];
+    ImageStore::GetIconPath(ICON_TITLE_ID, path, sizeof(path));
+    MockFileStorage::SetFile(path, makeIconTex());
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Memory Cache
+// =============================================================================
+// The cache is full at every scale (up to MAX_CACHED_IMAGES entries), so
+// each insert evicts the least recently used icon.
+
+BENCHMARK(ImageStore_GetFromMemoryCache) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    fillCache(library);
+
+    // Cycling through every icon moves each to the LRU's head in turn
+    int index = 0;
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(ImageStore::GetFromMemoryCache(library.titles[index].titleId));
+        index = index + 1 < count ? index + 1 : 0;
+    }
+    ImageStore::Shutdown();
+}
+
+BENCHMARK(ImageStore_StoreAndEvict) {
+    LibraryFixture::Library library = BenchLibrary::generate(state.GetScale());
+    fillCache(library);
+
+    // Includes allocating the new icon and freeing the evicted one
+    uint64_t titleId = 0x0005000020000000ull;
+    while (state.KeepRunning()) {
+        ImageStore::StoreInMemoryCache(titleId++, makeIcon(CACHED_ICON_SIDE));
+    }
+    ImageStore::Shutdown();
+}
+
+// =============================================================================
+// Decoding and Scaling
+// =============================================================================
+// One icon per iteration, so these stay flat across scales.
+
+BENCHMARK(ImageStore_DecodeIconTex) {
+    startDecodeOnlyStore();
+
+    while (state.KeepRunning()) {
+        Renderer::ImageHandle image = ImageStore::LoadFromStorage(ICON_TITLE_ID, ICON_SIDE,
+                                                                  Renderer::PixelFormat::RGBA8888);
+        Bench::DoNotOptimize(image);
+        ImageStore::FreeImage(image);
+    }
+    ImageStore::Shutdown();
+    MockFileStorage::Reset();
+}
+
+BENCHMARK(ImageStore_ScalePackedIcon) {
+    // Pack the 128x128 source once, then stop packing the scaled variant
+    // so every load box-filters it again
+    MockFileStorage::Reset();
+    ImageStore::Init();
+    char path[160];
+    ImageStore::GetIconPath(ICON_TITLE_ID, path, sizeof(path));
+    MockFileStorage::SetFile(path, makeIconTex());
+    ImageStore::FreeImage(ImageStore::LoadFromStorage(ICON_TITLE_ID, ICON_SIDE, Renderer::PixelFormat::RGBA8888));
+    ImageStore::FlushPendingWrites();
+    ImageStore::SetWriteEnabled(ImageStore::Source::ICON_PACK, false);
+
+    while (state.KeepRunning()) {
+        Renderer::ImageHandle image = ImageStore::LoadFromStorage(ICON_TITLE_ID, ICON_SIDE / 2,
+                                                                  Renderer::PixelFormat::RGBA8888);
+        Bench::DoNotOptimize(image);
+        ImageStore::FreeImage(image);
+    }
+    ImageStore::Shutdown();
+    MockFileStorage::Reset();
+}
@@ -0,0 +1,69 @@
+/**
+ * Benchmarks for src/storage/settings.cpp
+ *
+ * Times the membership lookups the title list makes for every row.
+ */
+
+#include "benchmark.h"
+#include "bench_library.h"
+
+// =============================================================================
+// Favorites
+// =============================================================================
+
+BENCHMARK(Settings_IsFavorite) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::assignSettings(library);
+
+    // Mostly misses, like checking every row of the list
+    int index = 0;
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(Settings::IsFavorite(library.titles[index].titleId));
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
+
+BENCHMARK(Settings_ToggleFavorite) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::assignSettings(library);
+
+    int index = 0;
+    while (state.KeepRunning()) {
+        Settings::ToggleFavorite(library.titles[index].titleId);
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
+
+// =============================================================================
+// Categories
+// =============================================================================
+
+BENCHMARK(Settings_TitleHasCategory) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::assignSettings(library);
+    const auto& categories = Settings::Get().categories;
+
+    int index = 0;
+    while (state.KeepRunning()) {
+        uint16_t categoryId = categories[index % categories.size()].id;
+        Bench::DoNotOptimize(Settings::TitleHasCategory(library.titles[index].titleId, categoryId));
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
+
+BENCHMARK(Settings_GetCategoriesForTitle) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::assignSettings(library);
+
+    uint16_t categoryIds[Settings::MAX_CATEGORIES];
+    int index = 0;
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(Settings::GetCategoriesForTitle(library.titles[index].titleId,
+                                                             categoryIds, Settings::MAX_CATEGORIES));
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
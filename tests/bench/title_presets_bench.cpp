@@ -0,0 +1,57 @@
+/**
+ * Benchmarks for src/presets/title_presets.cpp
+ *
+ * Times parsing the GameTDB JSON export and the game ID lookups made when
+ * titles are linked to their presets.
+ */
+
+#include "benchmark.h"
+#include "bench_library.h"
+
+// =============================================================================
+// Loading
+// =============================================================================
+
+BENCHMARK(TitlePresets_ParseJson) {
+    LibraryFixture::Library library = BenchLibrary::generate(state.GetScale());
+    MockFileStorage::Reset();
+    MockFileStorage::SetFile(Paths::PRESETS_FILE, library.presetJson);
+
+    while (state.KeepRunning()) {
+        TitlePresets::Load();
+        Bench::DoNotOptimize(TitlePresets::GetPresetCount());
+    }
+}
+
+// =============================================================================
+// Lookup
+// =============================================================================
+
+BENCHMARK(TitlePresets_GetPresetByGameId) {
+    int count = state.GetScale();
+    LibraryFixture::Library library = BenchLibrary::generate(count);
+    BenchLibrary::loadPresets(library);
+
+    // Product codes as the title store passes them, matched by prefix
+    int index = 0;
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(TitlePresets::GetPresetByGameId(library.titles[index].productCode));
+        index = index + 1 < count ? index + 1 : 0;
+    }
+}
+
+BENCHMARK(TitlePresets_GetPresetByGameIdMiss) {
+    BenchLibrary::loadPresets(BenchLibrary::generate(state.GetScale()));
+
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(TitlePresets::GetPresetByGameId("WUP-P-ZZZZ"));
+    }
+}
+
+BENCHMARK(TitlePresets_GetPresetsByGenre) {
+    BenchLibrary::loadPresets(BenchLibrary::generate(state.GetScale()));
+
+    while (state.KeepRunning()) {
+        Bench::DoNotOptimize(TitlePresets::GetPresetsByGenre("racing"));
+    }
+}
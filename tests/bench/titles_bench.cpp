@@ -0,0 +1,43 @@
+/**
+ * Benchmarks for src/titles/title_collation.cpp
+ *
+ * Times sorting the title list by name, which happens after every load
+ * and whenever names are resolved in the background.
+ */
+
+#include "benchmark.h"
+#include "bench_library.h"
+#include "titles/title_collation.h"
+
+#include <vector>
+
+// =============================================================================
+// Sorting
+// =============================================================================
+
+BENCHMARK(Titles_SortByName) {
+    LibraryFixture::Library library = BenchLibrary::generate(state.GetScale());
+    std::vector<uint64_t> keys(library.titles.size());
+    for (size_t index = 0; index < library.titles.size(); index++) {
+        keys[index] = TitleCollation::ComputeKey(library.titles[index].name);
+    }
+    std::vector<uint16_t> order(library.titles.size());
+
+    while (state.KeepRunning()) {
+        TitleCollation::SortByName(order.data(), static_cast<int>(order.size()), keys.data(),
+                                   library.titles.data());
+        Bench::DoNotOptimize(order[0]);
+    }
+}
+
+BENCHMARK(Titles_ComputeKeys) {
+    LibraryFixture::Library library = BenchLibrary::generate(state.GetScale());
+    std::vector<uint64_t> keys(library.titles.size());
+
+    while (state.KeepRunning()) {
+        for (size_t index = 0; index < library.titles.size(); index++) {
+            keys[index] = TitleCollation::ComputeKey(library.titles[index].name);
+        }
+        Bench::DoNotOptimize(keys[0]);
+    }
+}
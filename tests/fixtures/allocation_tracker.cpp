@@ -0,0 +1,260 @@
+/**
+ * Allocation Tracker Implementation
+ *
+ * See allocation_tracker.h for usage documentation.
+ */
+
+#include "allocation_tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <cerrno>
+#define ALLOCATION_TRACKER_HOOKS_MALLOC 1
+#else
+#define ALLOCATION_TRACKER_HOOKS_MALLOC 0
+#endif
+
+namespace {
+
+// Constant-initialized: allocations can happen before static constructors
+std::atomic<bool> isTracking{false};
+std::atomic<int> allocationCount{0};
+std::atomic<size_t> allocatedBytes{0};
+std::atomic<size_t> lastSize{0};
+
+void noteAllocation(size_t size)
+{
+    if (!isTracking.load(std::memory_order_relaxed)) {
+        return;
+    }
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    lastSize.store(size, std::memory_order_relaxed);
+}
+
+// With malloc interposed, operator new is counted by the malloc it calls
+void noteNew(size_t size)
+{
+#if ALLOCATION_TRACKER_HOOKS_MALLOC
+    (void)size;
+#else
+    noteAllocation(size);
+#endif
+}
+
+void* allocateOrThrow(size_t size)
+{
+    noteNew(size);
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* allocateAlignedOrThrow(size_t size, std::align_val_t alignment)
+{
+    noteNew(size);
+    size_t alignmentBytes = static_cast<size_t>(alignment);
+    if (alignmentBytes < sizeof(void*)) {
+        alignmentBytes = sizeof(void*);
+    }
+    // aligned_alloc wants a multiple of the alignment
+    size_t roundedSize = (size + alignmentBytes - 1) / alignmentBytes * alignmentBytes;
+    void* memory = std::aligned_alloc(alignmentBytes, roundedSize != 0 ? roundedSize : alignmentBytes);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Tracking
+// =============================================================================
+
+namespace AllocationTracker {
+
+void Start()
+{
+    allocationCount.store(0);
+    allocatedBytes.store(0);
+    lastSize.store(0);
+    isTracking.store(true);
+}
+
+void Stop()
+{
+    isTracking.store(false);
+}
+
+bool IsTracking()
+{
+    return isTracking.load();
+}
+
+int GetCount()
+{
+    return allocationCount.load();
+}
+
+size_t GetBytes()
+{
+    return allocatedBytes.load();
+}
+
+size_t GetLastSize()
+{
+    return lastSize.load();
+}
+
+} // namespace AllocationTracker
+
+// =============================================================================
+// malloc Interposition (glibc)
+// =============================================================================
+// Definitions in the executable take precedence over libc's, including
+// for calls made from inside libstdc++ and gtest.
+
+#if ALLOCATION_TRACKER_HOOKS_MALLOC
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* memory, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* memory);
+
+void* malloc(size_t size)
+{
+    noteAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    noteAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* memory, size_t size)
+{
+    noteAllocation(size);
+    return __libc_realloc(memory, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+    noteAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+    noteAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** outMemory, size_t alignment, size_t size)
+{
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    noteAllocation(size);
+    void* memory = __libc_memalign(alignment, size);
+    if (!memory) {
+        return ENOMEM;
+    }
+    *outMemory = memory;
+    return 0;
+}
+
+void free(void* memory)
+{
+    __libc_free(memory);
+}
+
+}
+
+#endif
+
+// =============================================================================
+// operator new / delete
+// =============================================================================
+
+void* operator new(size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    noteNew(size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    noteNew(size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocateAlignedOrThrow(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return allocateAlignedOrThrow(size, alignment);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,56 @@
+/**
+ * Allocation Tracker
+ *
+ * Counts heap allocations made while tracking is on, so a test can assert
+ * that a steady-state path (a browse frame, a lookup) allocates nothing.
+ * On the console every allocation comes out of the plugin's small,
+ * fragmented heap: a few per frame add jitter and, over a long session,
+ * "not enough memory" failures elsewhere.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Linking allocation_tracker.cpp into a TEST_BUILD binary replaces the
+ * global operator new and delete, and on glibc interposes malloc, calloc,
+ * realloc and the aligned variants (forwarding to glibc's __libc_*
+ * entry points), so C allocations such as memalign() are seen too.
+ * Counting is off until Start() and costs one atomic load per
+ * allocation; frees are not counted, as a free-then-allocate pair in a
+ * frame is still an allocation.
+ *
+ * Allocations on every thread are counted. The tests that use this run
+ * single-threaded code through the mocks.
+ *
+ * USAGE:
+ * ------
+ *   renderFrames(WARMUP_FRAMES);
+ *
+ *   AllocationTracker::Start();
+ *   renderFrames(MEASURED_FRAMES);
+ *   AllocationTracker::Stop();
+ *
+ *   EXPECT_EQ(0, AllocationTracker::GetCount());
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace AllocationTracker {
+
+// Reset the counters and start counting
+void Start();
+
+// Stop counting; the counters keep their values
+void Stop();
+
+bool IsTracking();
+
+// Allocations and bytes requested since Start()
+int GetCount();
+size_t GetBytes();
+
+// Size of the most recent counted allocation, to tell what it was when a
+// count is unexpectedly non-zero
+size_t GetLastSize();
+
+} // namespace AllocationTracker
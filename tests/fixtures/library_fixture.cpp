@@ -0,0 +1,282 @@
+/**
+ * Synthetic Library Fixture Implementation
+ *
+ * See library_fixture.h for usage documentation.
+ */
+
+#include "library_fixture.h"
+#include "storage/settings.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <utility>
+
+namespace LibraryFixture {
+
+namespace {
+
+// xorshift32: small, fast and identical everywhere (unlike std::
+// distributions, whose output is implementation-defined)
+class Random {
+public:
+    explicit Random(uint32_t seed) : mState(seed != 0 ? seed : 1) {}
+
+    uint32_t Next() {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+
+    int Below(int limit) {
+        return static_cast<int>(Next() % static_cast<uint32_t>(limit));
+    }
+
+    template <size_t Count>
+    const char* Pick(const char* const (&words)[Count]) {
+        return words[Below(static_cast<int>(Count))];
+    }
+
+private:
+    uint32_t mState;
+};
+
+const char* const ADJECTIVES[] = {
+    "Super", "New", "Mega", "Ultra", "Tiny", "Dark", "Crystal", "Turbo",
+    "Lost", "Hyper", "Wild", "Silent", "Golden", "Pixel", "Royal", "Final"
+};
+
+const char* const NOUNS[] = {
+    "Mario", "Kart", "Zelda", "Racer", "Quest", "Legends", "Party", "World",
+    "Island", "Kingdom", "Warriors", "Tennis", "Galaxy", "Dungeon", "Saga", "Arena"
+};
+
+// Suffixes that sort wrongly as plain text
+const char* const SUFFIXES[] = {
+    "", "", "", " 2", " 3", " 9", " 10", " 11", " U", " HD", " Deluxe", " II"
+};
+
+const char* const ACCENTED[] = {
+    "Pok\xC3\xA9mon", "Caf\xC3\xA9", "\xC3\x89lan", "Se\xC3\xB1or", "\xC3\x9C" "ber"
+};
+
+const char* const LEADING_PUNCTUATION[] = { "#", "'", "[", "(", "!", "..." };
+
+const char* const PUBLISHERS[] = {
+    "Nintendo", "Ubisoft", "SEGA", "Capcom", "Bandai Namco", "Activision", "Warner Bros.", "Square Enix"
+};
+
+// Weighted like the GameTDB export: mostly action
+const char* const GENRES[] = {
+    "action", "action", "action", "action", "strategy", "sports", "adventure",
+    "role-playing", "puzzle", "racing", "simulation", "party", "arcade"
+};
+
+const char* const REGION_LETTERS = "EPJ";
+const char* const REGION_NAMES[] = { "USA", "EUR", "JPN" };
+constexpr int REGION_COUNT = 3;
+
+// Unique for index < 26^3 * REGION_COUNT
+std::string gameIdAt(int index) {
+    char gameId[5];
+    gameId[0] = static_cast<char>('A' + index / 676 % 26);
+    gameId[1] = static_cast<char>('A' + index / 26 % 26);
+    gameId[2] = static_cast<char>('A' + index % 26);
+    gameId[3] = REGION_LETTERS[index / 17576 % REGION_COUNT];
+    gameId[4] = '\0';
+    return gameId;
+}
+
+// Distinct for distinct index below 2^20: an odd multiplier is a
+// bijection modulo a power of two
+uint64_t titleIdAt(int index, uint32_t seed) {
+    uint64_t low = (static_cast<uint64_t>(index) * 0x9E3B5u + seed * 0x1F1Fu) & 0xFFFFFu;
+    return 0x0005000010000000ull | (low << 8);
+}
+
+void copyName(Titles::TitleInfo& title, const std::string& name) {
+    strncpy(title.name, name.c_str(), Titles::MAX_NAME_LENGTH - 1);
+    title.name[Titles::MAX_NAME_LENGTH - 1] = '\0';
+}
+
+std::string lowercase(const char* name) {
+    std::string result(name);
+    for (char& c : result) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+/**
+ * Name one title. Every 16 titles cover each collation case once; a few
+ * cases refer back to the title before.
+ */
+std::string makeName(Random& random, int index, const Titles::TitleInfo* previous, uint64_t titleId) {
+    std::string name;
+    switch (index % 16) {
+        case 8:
+            if (previous) return lowercase(previous->name);
+            break;
+        case 9:
+            if (previous) return previous->name;
+            break;
+        case 10:
+            return std::string("The ") + random.Pick(NOUNS) + " of " + random.Pick(NOUNS);
+        case 11:
+            return std::string(random.Pick(NOUNS)) + (random.Below(2) ? ": " : " & ") +
+                   random.Pick(ADJECTIVES) + " " + random.Pick(NOUNS);
+        case 12:
+            return std::string(random.Pick(ACCENTED)) + " " + random.Pick(NOUNS);
+        case 13:
+            while (name.size() < Titles::MAX_NAME_LENGTH) {
+                name += random.Pick(ADJECTIVES);
+                name += " ";
+            }
+            return name;
+        case 14:
+            return std::string(random.Pick(LEADING_PUNCTUATION)) + random.Pick(NOUNS);
+        case 15: {
+            char hexName[20];
+            snprintf(hexName, sizeof(hexName), "%016llX", static_cast<unsigned long long>(titleId));
+            return hexName;
+        }
+        default:
+            break;
+    }
+    return std::string(random.Pick(ADJECTIVES)) + " " + random.Pick(NOUNS) + random.Pick(SUFFIXES);
+}
+
+void appendPreset(std::string& json, Random& random, int index, const char* name, bool isLast) {
+    // About one in ten presets has only a year, one in twenty no date
+    char releaseDate[48];
+    int year = 2012 + random.Below(6);
+    int dateKind = random.Below(20);
+    if (dateKind == 0) {
+        releaseDate[0] = '\0';
+    } else if (dateKind < 3) {
+        snprintf(releaseDate, sizeof(releaseDate), "%d", year);
+    } else {
+        snprintf(releaseDate, sizeof(releaseDate), "%d-%02d-%02d", year, 1 + random.Below(12), 1 + random.Below(28));
+    }
+
+    char entry[512];
+    snprintf(entry, sizeof(entry),
+             "    {\n"
+             "      \"id\": \"%s01\",\n"
+             "      \"name\": \"%s\",\n"
+             "      \"publisher\": \"%s\",\n"
+             "      \"developer\": \"Studio %d\",\n"
+             "%s%s%s"
+             "      \"region\": \"%s\",\n"
+             "      \"genre\": \"%s\"\n"
+             "    }%s\n",
+             gameIdAt(index).c_str(), name, random.Pick(PUBLISHERS), random.Below(200),
+             releaseDate[0] ? "      \"releaseDate\": \"" : "", releaseDate, releaseDate[0] ? "\",\n" : "",
+             REGION_NAMES[index / 17576 % REGION_COUNT], random.Pick(GENRES), isLast ? "" : ",");
+    json += entry;
+}
+
+}
+
+// =============================================================================
+// Generation
+// =============================================================================
+
+Library Generate(const Options& options)
+{
+    Random random(options.seed);
+    Library library;
+
+    int titleCount = std::max(0, options.titleCount);
+    library.titles.resize(titleCount);
+    for (int index = 0; index < titleCount; index++) {
+        Titles::TitleInfo& title = library.titles[index];
+        title.titleId = titleIdAt(index, options.seed);
+        copyName(title, makeName(random, index, index > 0 ? &library.titles[index - 1] : nullptr, title.titleId));
+        snprintf(title.productCode, sizeof(title.productCode), "WUP-P-%s", gameIdAt(index).c_str());
+    }
+
+    int presetCount = std::max(options.presetCount, titleCount);
+    library.presetJson = "{\n  \"version\": 1,\n  \"titles\": [\n";
+    for (int index = 0; index < presetCount; index++) {
+        char name[32];
+        const char* presetName = name;
+        if (index < titleCount) {
+            // Hex names are the store's fallback, not a real game name
+            presetName = library.titles[index].name;
+            if (index % 16 == 15) {
+                snprintf(name, sizeof(name), "Unnamed %d", index);
+                presetName = name;
+            }
+        } else {
+            snprintf(name, sizeof(name), "Uninstalled %d", index);
+        }
+        appendPreset(library.presetJson, random, index, presetName, index + 1 == presetCount);
+    }
+    library.presetJson += "  ]\n}\n";
+
+    int categoryCount = std::min(std::max(0, options.categoryCount), Settings::MAX_CATEGORIES);
+    for (int position = 0; position < categoryCount; position++) {
+        char name[Settings::MAX_CATEGORY_NAME];
+        snprintf(name, sizeof(name), "%s %d", NOUNS[position % 16], position + 1);
+        library.categoryNames.push_back(name);
+    }
+
+    // Favorites: the front of a seeded shuffle
+    std::vector<int> order(titleCount);
+    for (int index = 0; index < titleCount; index++) {
+        order[index] = index;
+    }
+    for (int index = titleCount - 1; index > 0; index--) {
+        std::swap(order[index], order[random.Below(index + 1)]);
+    }
+    int favoriteCount = std::min({ std::max(0, options.favoriteCount), titleCount, Settings::MAX_FAVORITES });
+    for (int index = 0; index < favoriteCount; index++) {
+        library.favorites.push_back(library.titles[order[index]].titleId);
+    }
+
+    // Assignments: distinct random pairs
+    if (categoryCount > 0 && titleCount > 0) {
+        int assignmentCount = std::min({ std::max(0, options.assignmentCount),
+                                         titleCount * categoryCount, Settings::MAX_TITLE_CATEGORIES });
+        std::set<std::pair<int, int>> used;
+        while (static_cast<int>(library.assignments.size()) < assignmentCount) {
+            int titleIndex = random.Below(titleCount);
+            int position = random.Below(categoryCount);
+            if (used.insert({ titleIndex, position }).second) {
+                library.assignments.push_back({ library.titles[titleIndex].titleId, position });
+            }
+        }
+    }
+
+    return library;
+}
+
+// =============================================================================
+// Settings
+// =============================================================================
+
+void ApplySettings(const Library& library)
+{
+    std::vector<uint16_t> categoryIds;
+    for (const std::string& name : library.categoryNames) {
+        categoryIds.push_back(Settings::CreateCategory(name.c_str()));
+    }
+
+    for (uint64_t titleId : library.favorites) {
+        Settings::AddFavorite(titleId);
+    }
+
+    for (const Assignment& assignment : library.assignments) {
+        uint16_t categoryId = categoryIds[assignment.categoryPosition];
+        if (categoryId != 0) {
+            Settings::AssignTitleToCategory(assignment.titleId, categoryId);
+        }
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+/**
+ * Synthetic Library Fixture
+ *
+ * Generates a large, realistic-looking library: installed titles, a
+ * GameTDB preset export that covers them, favorites and category
+ * assignments. The performance cliffs (the 512-title and 512-assignment
+ * sizes, a 2048-entry preset database) only show with data this size, and
+ * the hand-written samples in the mocks are a few dozen titles.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * Everything comes from one seeded generator, so a seed always gives the
+ * same library on every host, and the unit tests, benchmarks and web
+ * preview see the same titles. Names deliberately include the collation
+ * cases a sort has to get right: case-only differences, numbers that sort
+ * wrongly as text ("Racer 10" vs "Racer 9"), leading articles and
+ * punctuation, UTF-8 accents, exact duplicates, names at the length limit
+ * and the hex ID the store shows for a title without metadata.
+ *
+ * Game IDs are unique 4-letter codes; product codes are "WUP-P-" plus the
+ * code and presets use the code plus "01", like real data. Presets beyond
+ * titleCount describe games that are not installed.
+ *
+ * Nothing here touches the stores: ApplySettings() hands the favorites and
+ * categories to Settings, and the caller passes the titles to its Titles
+ * mock and the JSON to its file mock.
+ *
+ * USAGE:
+ * ------
+ *   LibraryFixture::Options options;
+ *   options.titleCount = 2048;
+ *   LibraryFixture::Library library = LibraryFixture::Generate(options);
+ *
+ *   Settings::Init();
+ *   LibraryFixture::ApplySettings(library);
+ *   MockTitles::SetTitles(library.titles);
+ *   MockFileStorage::SetFile(Paths::PRESETS_FILE, library.presetJson);
+ */
+
+#pragma once
+
+#include "titles/titles.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace LibraryFixture {
+
+struct Options {
+    int titleCount = 512;
+    int presetCount = 2048;       // Raised to titleCount if smaller
+    int categoryCount = 8;        // At most Settings::MAX_CATEGORIES
+    int assignmentCount = 512;    // Title-category pairs, at most MAX_TITLE_CATEGORIES
+    int favoriteCount = 64;       // At most titleCount and MAX_FAVORITES
+    uint32_t seed = 1;
+};
+
+struct Assignment {
+    uint64_t titleId;
+    int categoryPosition;         // Index into categoryNames
+};
+
+struct Library {
+    std::vector<Titles::TitleInfo> titles;      // In generation order, not sorted
+    std::string presetJson;                     // Contents of Paths::PRESETS_FILE
+    std::vector<std::string> categoryNames;
+    std::vector<uint64_t> favorites;
+    std::vector<Assignment> assignments;
+};
+
+// Build a library; the same options always give the same library
+Library Generate(const Options& options);
+
+// Create the library's categories and add its favorites and assignments
+// through the Settings API (on top of whatever settings are loaded)
+void ApplySettings(const Library& library);
+
+} // namespace LibraryFixture
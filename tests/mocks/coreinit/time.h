@@ -0,0 +1,16 @@
+/**
+ * Mock coreinit time for unit tests
+ *
+ * Ticks are microseconds and the clock stands still; code under test that
+ * needs time takes it as a parameter.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+typedef int64_t OSTime;
+
+inline OSTime OSGetSystemTime() { return 0; }
+inline int64_t OSTicksToMicroseconds(OSTime ticks) { return ticks; }
+inline int64_t OSTicksToMilliseconds(OSTime ticks) { return ticks / 1000; }
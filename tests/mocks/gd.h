@@ -0,0 +1,35 @@
+/**
+ * Mock libgd for unit tests
+ *
+ * Just the types and calls ImageStore uses. Nothing decodes: every
+ * gdImageCreateFrom*Ptr() returns nullptr, so tests store icons as the
+ * TGA files ImageStore reads without libgd.
+ */
+
+#pragma once
+
+#define gdMaxColors 256
+
+struct gdImage {
+    unsigned char** pixels;
+    int sx;
+    int sy;
+    int red[gdMaxColors];
+    int green[gdMaxColors];
+    int blue[gdMaxColors];
+    int alpha[gdMaxColors];
+    int trueColor;
+    int** tpixels;
+};
+
+typedef gdImage* gdImagePtr;
+
+#define gdImageSX(image) ((image)->sx)
+#define gdImageSY(image) ((image)->sy)
+#define gdImageTrueColor(image) ((image)->trueColor)
+
+inline gdImagePtr gdImageCreateFromPngPtr(int, void*) { return nullptr; }
+inline gdImagePtr gdImageCreateFromJpegPtr(int, void*) { return nullptr; }
+inline gdImagePtr gdImageCreateFromBmpPtr(int, void*) { return nullptr; }
+inline gdImagePtr gdImageCreateFromTgaPtr(int, void*) { return nullptr; }
+inline void gdImageDestroy(gdImagePtr) {}
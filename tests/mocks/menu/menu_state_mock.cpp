@@ -0,0 +1,36 @@
+/**
+ * Mock menu state for unit tests
+ *
+ * The shared state and helpers menu.cpp defines for the panels (see
+ * src/menu/menu_state.h), so a panel can be driven on its own.
+ */
+
+#include "../../../src/menu/menu_state.h"
+#include "../../../src/menu/categories.h"
+#include "../../../src/render/measurements.h"
+#include "../../../src/render/renderer.h"
+
+namespace Menu {
+namespace Internal {
+
+bool sIsOpen = false;
+Mode sCurrentMode = Mode::BROWSE;
+
+UI::ListView::State sTitleListState;
+UI::ListView::State sEditCatsListState;
+UI::ListView::State sSettingsListState;
+
+SettingsSubMode sSettingsSubMode = SettingsSubMode::MAIN;
+TextInput::Field sInputField;
+
+void clampSelection() {
+    int count = Categories::GetFilteredCount();
+    sTitleListState.SetItemCount(count, Renderer::GetVisibleRows());
+}
+
+void drawHeaderDivider() {
+    Renderer::DrawText(0, HEADER_ROW, Measurements::HEADER_DIVIDER);
+}
+
+} // namespace Internal
+} // namespace Menu
@@ -0,0 +1,18 @@
+/**
+ * Mock <nn/acp/title.h> for unit tests
+ *
+ * There is no NAND on the host: every title's meta directory lookup
+ * fails, as for a title whose meta folder is gone.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+typedef int32_t ACPResult;
+
+constexpr ACPResult ACP_RESULT_SUCCESS = 0;
+constexpr ACPResult ACP_RESULT_NOT_FOUND = -500;
+
+inline ACPResult ACPGetTitleMetaDir(uint64_t, char*, size_t) { return ACP_RESULT_NOT_FOUND; }
@@ -0,0 +1,148 @@
+/**
+ * Mock ImageLoader implementation
+ *
+ * See image_loader_mock.h.
+ */
+
+#include "image_loader_mock.h"
+#include "../../../src/titles/titles.h"
+
+namespace {
+
+struct RequestInfo {
+    uint64_t titleId;
+    ImageLoader::Priority priority;
+    ImageLoader::Status status;
+};
+
+RequestInfo sRequests[Titles::MAX_TITLES];
+int sRequestCount = 0;
+int sIconSize = 0;
+
+uint16_t sBlankPixels[ImageLoader::ICON_WIDTH * ImageLoader::ICON_HEIGHT] = {};
+Renderer::ImageData sBlankIcon = {};
+
+RequestInfo* findRequest(uint64_t titleId) {
+    for (int index = 0; index < sRequestCount; index++) {
+        if (sRequests[index].titleId == titleId) {
+            return &sRequests[index];
+        }
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+namespace MockImageLoader {
+
+void Reset() {
+    sRequestCount = 0;
+    sIconSize = 0;
+}
+
+int GetRequestCount() {
+    int count = 0;
+    for (int index = 0; index < sRequestCount; index++) {
+        count += sRequests[index].status != ImageLoader::Status::NOT_REQUESTED;
+    }
+    return count;
+}
+
+int GetIconSize() {
+    return sIconSize;
+}
+
+} // namespace MockImageLoader
+
+namespace ImageLoader {
+
+bool Init(size_t cacheBudgetBytes) {
+    (void)cacheBudgetBytes;
+    return true;
+}
+
+void Shutdown() {
+    MockImageLoader::Reset();
+}
+
+void Update(uint32_t budgetMicros) {
+    (void)budgetMicros;
+    for (int index = 0; index < sRequestCount; index++) {
+        if (sRequests[index].status == Status::QUEUED) {
+            sRequests[index].status = Status::READY;
+        }
+    }
+}
+
+void Request(uint64_t titleId, Priority priority) {
+    RequestInfo* request = findRequest(titleId);
+    if (!request) {
+        if (sRequestCount >= Titles::MAX_TITLES) {
+            return;
+        }
+        request = &sRequests[sRequestCount++];
+        request->titleId = titleId;
+        request->status = Status::NOT_REQUESTED;
+    }
+
+    if (request->status == Status::NOT_REQUESTED) {
+        request->status = Status::QUEUED;
+        request->priority = priority;
+    } else if (priority > request->priority) {
+        request->priority = priority;
+    }
+}
+
+void Cancel(uint64_t titleId) {
+    RequestInfo* request = findRequest(titleId);
+    if (request && request->status == Status::QUEUED) {
+        request->status = Status::NOT_REQUESTED;
+    }
+}
+
+void SetPriority(uint64_t titleId, Priority priority) {
+    RequestInfo* request = findRequest(titleId);
+    if (request) {
+        request->priority = priority;
+    }
+}
+
+Status GetStatus(uint64_t titleId) {
+    RequestInfo* request = findRequest(titleId);
+    return request ? request->status : Status::NOT_REQUESTED;
+}
+
+bool IsReady(uint64_t titleId) {
+    return GetStatus(titleId) == Status::READY;
+}
+
+Renderer::ImageHandle Get(uint64_t titleId) {
+    if (!IsReady(titleId)) {
+        return Renderer::INVALID_IMAGE;
+    }
+    sBlankIcon.pixels16 = sBlankPixels;
+    sBlankIcon.width = ICON_WIDTH;
+    sBlankIcon.height = ICON_HEIGHT;
+    sBlankIcon.format = Renderer::PixelFormat::RGB565;
+    return &sBlankIcon;
+}
+
+void SetIconSize(int iconSize) {
+    sIconSize = iconSize;
+}
+
+void GetLoadingStats(int* outPending, int* outReady, int* outFailed, int* outTotal) {
+    int pending = 0;
+    int ready = 0;
+    for (int index = 0; index < sRequestCount; index++) {
+        pending += sRequests[index].status == Status::QUEUED;
+        ready += sRequests[index].status == Status::READY;
+    }
+
+    if (outPending) *outPending = pending;
+    if (outReady) *outReady = ready;
+    if (outFailed) *outFailed = 0;
+    if (outTotal) *outTotal = pending + ready;
+}
+
+} // namespace ImageLoader
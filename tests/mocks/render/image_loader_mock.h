@@ -0,0 +1,25 @@
+/**
+ * Mock ImageLoader for unit tests
+ *
+ * Tracks requests in a fixed table, like the real loader's request
+ * table: Request() queues a title and Update() "loads" everything queued
+ * at once, handing out one shared blank icon. Nothing is decoded and the
+ * mock never allocates, so frame tests only see the caller's allocations.
+ */
+
+#pragma once
+
+#include "../../../src/render/image_loader.h"
+
+namespace MockImageLoader {
+
+// Forget every request
+void Reset();
+
+// Titles requested and not cancelled since Reset()
+int GetRequestCount();
+
+// What the last SetIconSize() asked for (0 after Reset())
+int GetIconSize();
+
+} // namespace MockImageLoader
@@ -1,34 +1,61 @@
 /**
  * Mock Renderer for unit tests
+ *
+ * The real Renderer API over a fixed 100x18 grid on the DRC screen,
+ * implemented in renderer_mock.cpp. Nothing is drawn; MockRenderer counts
+ * the calls so a test can check what a frame asked for.
+ *
+ * HOW IT WORKS:
+ * The mock keeps the OSScreen backend's dirty regions: Invalidate() marks
+ * both buffers, BeginFrame() takes the back buffer's region and clears
+ * it, every draw is clipped to it, and EndFrame() "flushes" it to the DRC
+ * and flips. The TV's buffers keep regions of their own and are scaled,
+ * flushed and flipped at the SetTVPacing() pace, as a 720p screen. The
+ * cost counters add up what the real renderer would write for that:
+ * pixels per screen, glyphs, blits, lines and flushed bytes. Retained mode is off until SetRetainedMode(true),
+ * and then a frame with nothing invalidated costs nothing.
+ *
+ * USAGE:
+ *   MockRenderer::Reset();
+ *   Renderer::SetRetainedMode(true);
+ *   Renderer::BeginFrame(0);
+ *   ... draw ...
+ *   Renderer::EndFrame();
+ *   EXPECT_LT(MockRenderer::GetFrameCounters().drcPixels, budget);
  */
 
 #pragma once
 
-#include <cstdint>
+#include "../../../src/render/renderer.h"
 
-namespace Renderer {
+namespace MockRenderer {
 
-inline void DrawText(int col, int row, const char* text, uint32_t color = 0xFFFFFFFF) {
-    (void)col; (void)row; (void)text; (void)color;
-}
+struct Counters {
+    // Calls made, drawn or clipped away
+    int textCalls;
+    int imageCalls;
+    int placeholderCalls;
+    int invalidations;
 
-inline void DrawTextF(int col, int row, uint32_t color, const char* fmt, ...) {
-    (void)col; (void)row; (void)color; (void)fmt;
-}
+    // Work inside the frame's region
+    int glyphs;
+    int blits;
+    int lines;
+    long long drcPixels;    // Cleared, drawn or blitted on the DRC
+    long long tvPixels;     // Scaled onto the TV
+    long long flushBytes;   // Written back from the cache, both screens
+    int frames;             // EndFrame() calls
+    int tvFrames;           // Frames the TV was drawn and flipped
+};
 
-inline void DrawTextF(int col, int row, const char* fmt, ...) {
-    (void)col; (void)row; (void)fmt;
-}
+// Zero the counters, drop retained mode and TV pacing and mark the whole
+// screen dirty
+void Reset();
 
-// Layout helpers (mock values for testing)
-inline int GetGridWidth() { return 100; }
-inline int GetGridHeight() { return 18; }
-inline int GetDividerCol() { return 30; }
-inline int GetDetailsPanelCol() { return 32; }
-inline int GetListWidth() { return 30; }
-inline int GetVisibleRows() { return 15; }
-inline int GetFooterRow() { return 17; }
-inline int GetScreenWidth() { return 854; }
-inline int GetScreenHeight() { return 480; }
+// Everything since Reset()
+const Counters& GetCounters();
 
-} // namespace Renderer
+// The last frame from BeginFrame() to EndFrame()
+const Counters& GetFrameCounters();
+
+} // namespace MockRenderer
@@ -0,0 +1,434 @@
+/**
+ * Mock Renderer implementation
+ *
+ * See renderer.h. Layout values match the old header-only mock: a 100x18
+ * grid with the divider at column 30. Dirty regions follow renderer.cpp's
+ * OSScreen backend; costs are counted, not drawn.
+ */
+
+#include "renderer.h"
+#include "../../../src/common/screen_constants.h"
+#include "../../../src/render/bitmap_font.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+MockRenderer::Counters sTotalCounters = {};
+MockRenderer::Counters sFrameCounters = {};
+MockRenderer::Counters sLastFrameCounters = {};
+
+constexpr int GRID_WIDTH = 100;
+constexpr int GRID_HEIGHT = 18;
+constexpr int DIVIDER_COL = 30;
+constexpr int CHAR_WIDTH = Screen::Grid::CHAR_WIDTH;
+constexpr int ROW_HEIGHT = Screen::Grid::CHAR_HEIGHT;
+constexpr int SCREEN_WIDTH = Screen::DRC::WIDTH;
+constexpr int SCREEN_HEIGHT = Screen::DRC::HEIGHT;
+constexpr int TV_WIDTH = Screen::TV::P720::WIDTH;
+constexpr int TV_HEIGHT = Screen::TV::P720::HEIGHT;
+constexpr int ICON_SIZE = 128;
+constexpr int GRID_ICON_SIZE = 64;
+
+// Glyphs are 8x16, centered in a 24px row
+constexpr int TEXT_HEIGHT = BitmapFont::SCALED_CHAR_HEIGHT;
+constexpr int TEXT_OFFSET_Y = (ROW_HEIGHT - TEXT_HEIGHT) / 2;
+
+// Wider than this share of a row, a rectangle is flushed as whole rows
+constexpr int FLUSH_ROWS_MIN_PERCENT = 50;
+
+Layout::PixelLayout makeLayout() {
+    Layout::PixelLayout layout = {};
+    layout.screenWidth = SCREEN_WIDTH;
+    layout.screenHeight = SCREEN_HEIGHT;
+    layout.font = { 16, ROW_HEIGHT, CHAR_WIDTH };
+    layout.iconSize = ICON_SIZE;
+    layout.details.icon = { SCREEN_WIDTH - ICON_SIZE - 16, ROW_HEIGHT * 3, ICON_SIZE, ICON_SIZE };
+
+    // 11x4 cells of 64px icons between the header and the caption row
+    layout.grid.iconSize = GRID_ICON_SIZE;
+    layout.grid.cellSize = GRID_ICON_SIZE + 8;
+    layout.grid.columns = 11;
+    layout.grid.rows = 4;
+    layout.grid.area = { 35, ROW_HEIGHT * 3, layout.grid.columns * layout.grid.cellSize - 8,
+                         layout.grid.rows * layout.grid.cellSize - 8 };
+    return layout;
+}
+
+const Layout::PixelLayout sLayout = makeLayout();
+
+// =============================================================================
+// Dirty Regions
+// =============================================================================
+// The same bookkeeping as renderer.cpp: disjoint rectangles per buffer,
+// collapsing into their bounds past MAX_DIRTY_RECTS.
+
+struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+constexpr Rect FULL_SCREEN_RECT = { 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT };
+constexpr int MAX_DIRTY_RECTS = 16;
+
+struct Region {
+    Rect rects[MAX_DIRTY_RECTS];
+    int count;
+};
+
+// Both buffers start out missing everything
+Region sPendingRegions[2] = { { { FULL_SCREEN_RECT }, 1 }, { { FULL_SCREEN_RECT }, 1 } };
+Region sFrameRegion = { { FULL_SCREEN_RECT }, 1 };
+int sBackIndex = 0;
+bool sIsRetainedMode = false;
+
+// The TV's buffers, paced apart from the DRC's
+Region sTVPendingRegions[2] = { { { FULL_SCREEN_RECT }, 1 }, { { FULL_SCREEN_RECT }, 1 } };
+Region sTVFrameRegion = { { FULL_SCREEN_RECT }, 1 };
+int sTVBackIndex = 0;
+Renderer::TVPacer sTVPacer;
+
+bool clipToRect(Rect& rect, const Rect& clip) {
+    int right = std::min(rect.x + rect.width, clip.x + clip.width);
+    int bottom = std::min(rect.y + rect.height, clip.y + clip.height);
+    rect.x = std::max(rect.x, clip.x);
+    rect.y = std::max(rect.y, clip.y);
+    rect.width = right - rect.x;
+    rect.height = bottom - rect.y;
+    return rect.width > 0 && rect.height > 0;
+}
+
+bool rectsTouch(const Rect& first, const Rect& second) {
+    return first.x <= second.x + second.width && second.x <= first.x + first.width &&
+           first.y <= second.y + second.height && second.y <= first.y + first.height;
+}
+
+bool rectsOverlap(const Rect& first, const Rect& second) {
+    return first.x < second.x + second.width && second.x < first.x + first.width &&
+           first.y < second.y + second.height && second.y < first.y + first.height;
+}
+
+int rectArea(const Rect& rect) {
+    return rect.width * rect.height;
+}
+
+Rect unionRects(const Rect& first, const Rect& second) {
+    int left = std::min(first.x, second.x);
+    int top = std::min(first.y, second.y);
+    int right = std::max(first.x + first.width, second.x + second.width);
+    int bottom = std::max(first.y + first.height, second.y + second.height);
+    return { left, top, right - left, bottom - top };
+}
+
+void addDirtyRect(Region& region, Rect rect) {
+    if (!clipToRect(rect, FULL_SCREEN_RECT)) {
+        return;
+    }
+
+    for (int index = 0; index < region.count;) {
+        const Rect& other = region.rects[index];
+        Rect bounds = unionRects(other, rect);
+        if (rectsOverlap(other, rect) ||
+            (rectsTouch(other, rect) && rectArea(bounds) <= rectArea(other) + rectArea(rect))) {
+            rect = bounds;
+            region.rects[index] = region.rects[--region.count];
+            index = 0;
+        } else {
+            index++;
+        }
+    }
+
+    if (region.count == MAX_DIRTY_RECTS) {
+        for (int index = 0; index < region.count; index++) {
+            rect = unionRects(rect, region.rects[index]);
+        }
+        region.count = 0;
+    }
+    region.rects[region.count++] = rect;
+}
+
+void setFullScreen(Region& region) {
+    region.rects[0] = FULL_SCREEN_RECT;
+    region.count = 1;
+}
+
+// Pixels of a rectangle inside the frame's region
+long long clippedArea(const Rect& rect) {
+    long long area = 0;
+    for (int index = 0; index < sFrameRegion.count; index++) {
+        Rect clipped = rect;
+        if (clipToRect(clipped, sFrameRegion.rects[index])) {
+            area += static_cast<long long>(clipped.width) * clipped.height;
+        }
+    }
+    return area;
+}
+
+// =============================================================================
+// Cost Counting
+// =============================================================================
+
+template <typename T>
+void addCost(T MockRenderer::Counters::*field, T amount) {
+    sTotalCounters.*field += amount;
+    sFrameCounters.*field += amount;
+}
+
+void countText(int column, int row, const char* text) {
+    addCost(&MockRenderer::Counters::textCalls, 1);
+
+    int textX = column * CHAR_WIDTH;
+    int glyphTop = row * ROW_HEIGHT + TEXT_OFFSET_Y;
+    int length = static_cast<int>(strlen(text));
+    for (int charIndex = 0; charIndex < length; charIndex++) {
+        long long area = clippedArea({ textX + charIndex * CHAR_WIDTH, glyphTop, CHAR_WIDTH, TEXT_HEIGHT });
+        if (area > 0) {
+            addCost(&MockRenderer::Counters::glyphs, 1);
+            addCost(&MockRenderer::Counters::drcPixels, area);
+        }
+    }
+}
+
+// An image, placeholder or line: one pass over its clipped pixels
+long long countFill(int pixelX, int pixelY, int width, int height) {
+    long long area = clippedArea({ pixelX, pixelY, width, height });
+    addCost(&MockRenderer::Counters::drcPixels, area);
+    return area;
+}
+
+long long flushBytes(const Rect& rect, int pitch) {
+    if (rect.width * 100 >= pitch * FLUSH_ROWS_MIN_PERCENT) {
+        return static_cast<long long>(rect.height) * pitch * sizeof(uint32_t);
+    }
+    return static_cast<long long>(rect.width) * rect.height * sizeof(uint32_t);
+}
+
+// The TV rectangle a DRC rectangle scales onto
+Rect scaleToTV(const Rect& rect) {
+    auto toTV = [](int coordinate, int tvSize, int drcSize) {
+        return (coordinate * tvSize + drcSize - 1) / drcSize;
+    };
+    int left = toTV(rect.x, TV_WIDTH, SCREEN_WIDTH);
+    int right = toTV(rect.x + rect.width, TV_WIDTH, SCREEN_WIDTH);
+    int top = toTV(rect.y, TV_HEIGHT, SCREEN_HEIGHT);
+    int bottom = toTV(rect.y + rect.height, TV_HEIGHT, SCREEN_HEIGHT);
+    return { left, top, right - left, bottom - top };
+}
+
+} // anonymous namespace
+
+namespace MockRenderer {
+
+void Reset() {
+    sTotalCounters = {};
+    sFrameCounters = {};
+    sLastFrameCounters = {};
+    sIsRetainedMode = false;
+    sBackIndex = 0;
+    setFullScreen(sPendingRegions[0]);
+    setFullScreen(sPendingRegions[1]);
+    setFullScreen(sFrameRegion);
+    sTVBackIndex = 0;
+    setFullScreen(sTVPendingRegions[0]);
+    setFullScreen(sTVPendingRegions[1]);
+    setFullScreen(sTVFrameRegion);
+    sTVPacer.Reset();
+}
+
+const Counters& GetCounters() {
+    return sTotalCounters;
+}
+
+const Counters& GetFrameCounters() {
+    return sLastFrameCounters;
+}
+
+} // namespace MockRenderer
+
+namespace Renderer {
+
+void BeginFrame(uint32_t clearColor) {
+    (void)clearColor;
+    sFrameCounters = {};
+
+    if (!sIsRetainedMode) {
+        InvalidateAll();
+    }
+
+    Region& pending = sPendingRegions[sBackIndex];
+    sFrameRegion = pending;
+    pending.count = 0;
+
+    Region& tvPending = sTVPendingRegions[sTVBackIndex];
+    if (sTVPacer.BeginFrame(tvPending.count > 0, sFrameRegion.count > 0)) {
+        sTVFrameRegion = tvPending;
+        tvPending.count = 0;
+    } else {
+        sTVFrameRegion.count = 0;
+    }
+
+    for (int index = 0; index < sFrameRegion.count; index++) {
+        const Rect& rect = sFrameRegion.rects[index];
+        addCost(&MockRenderer::Counters::drcPixels, static_cast<long long>(rect.width) * rect.height);
+    }
+}
+
+void EndFrame() {
+    addCost(&MockRenderer::Counters::frames, 1);
+
+    for (int index = 0; index < sTVFrameRegion.count; index++) {
+        Rect tvRect = scaleToTV(sTVFrameRegion.rects[index]);
+        addCost(&MockRenderer::Counters::tvPixels, static_cast<long long>(tvRect.width) * tvRect.height);
+        addCost(&MockRenderer::Counters::flushBytes, flushBytes(tvRect, TV_WIDTH));
+    }
+    if (sTVFrameRegion.count > 0) {
+        addCost(&MockRenderer::Counters::tvFrames, 1);
+        sTVBackIndex ^= 1;
+    }
+
+    for (int index = 0; index < sFrameRegion.count; index++) {
+        addCost(&MockRenderer::Counters::flushBytes, flushBytes(sFrameRegion.rects[index], SCREEN_WIDTH));
+    }
+    if (sFrameRegion.count > 0) {
+        sBackIndex ^= 1;
+    }
+
+    sLastFrameCounters = sFrameCounters;
+}
+
+void DrawText(int column, int row, const char* text, uint32_t color) {
+    (void)color;
+    if (text) {
+        countText(column, row, text);
+    }
+}
+
+void DrawTextF(int column, int row, uint32_t color, const char* format, ...) {
+    (void)color;
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    countText(column, row, buffer);
+}
+
+void DrawTextF(int column, int row, const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    countText(column, row, buffer);
+}
+
+bool SupportsImages() {
+    return true;
+}
+
+void DrawImage(int pixelX, int pixelY, ImageHandle image, int width, int height) {
+    addCost(&MockRenderer::Counters::imageCalls, 1);
+    if (!image) {
+        return;
+    }
+    if (countFill(pixelX, pixelY, width > 0 ? width : image->width,
+                  height > 0 ? height : image->height) > 0) {
+        addCost(&MockRenderer::Counters::blits, 1);
+    }
+}
+
+void ReleaseImage(ImageHandle image) {
+    (void)image;
+}
+
+void DrawPlaceholder(int pixelX, int pixelY, int width, int height, uint32_t color) {
+    (void)color;
+    addCost(&MockRenderer::Counters::placeholderCalls, 1);
+    countFill(pixelX, pixelY, width, height);
+}
+
+void DrawPixel(int x, int y, uint32_t color) {
+    (void)color;
+    countFill(x, y, 1, 1);
+}
+
+void DrawHLine(int x, int y, int length, uint32_t color) {
+    (void)color;
+    if (countFill(x, y, length, 1) > 0) {
+        addCost(&MockRenderer::Counters::lines, 1);
+    }
+}
+
+void DrawVLine(int x, int y, int length, uint32_t color) {
+    (void)color;
+    if (countFill(x, y, 1, length) > 0) {
+        addCost(&MockRenderer::Counters::lines, 1);
+    }
+}
+
+void SetRetainedMode(bool enabled) {
+    if (enabled && !sIsRetainedMode) {
+        InvalidateAll();
+    }
+    sIsRetainedMode = enabled;
+}
+
+void Invalidate(int pixelX, int pixelY, int width, int height) {
+    addCost(&MockRenderer::Counters::invalidations, 1);
+    addDirtyRect(sPendingRegions[0], { pixelX, pixelY, width, height });
+    addDirtyRect(sPendingRegions[1], { pixelX, pixelY, width, height });
+    addDirtyRect(sTVPendingRegions[0], { pixelX, pixelY, width, height });
+    addDirtyRect(sTVPendingRegions[1], { pixelX, pixelY, width, height });
+}
+
+void InvalidateRows(int firstRow, int rowCount) {
+    Invalidate(0, RowToPixelY(firstRow), SCREEN_WIDTH, rowCount * ROW_HEIGHT);
+}
+
+void InvalidateAll() {
+    setFullScreen(sPendingRegions[0]);
+    setFullScreen(sPendingRegions[1]);
+    setFullScreen(sTVPendingRegions[0]);
+    setFullScreen(sTVPendingRegions[1]);
+}
+
+void SetTVPacing(TVPacing pacing, int frameDivisor) {
+    sTVPacer.Set(pacing, frameDivisor);
+}
+
+TVPacing GetTVPacing() {
+    return sTVPacer.GetPacing();
+}
+
+bool IsTVBehind() {
+    return sTVPacer.GetPacing() != TVPacing::OFF && (sTVPendingRegions[0].count > 0 || sTVPendingRegions[1].count > 0);
+}
+
+bool NeedsDraw(int pixelX, int pixelY, int width, int height) {
+    return clippedArea({ pixelX, pixelY, width, height }) > 0;
+}
+
+int ColToPixelX(int column) { return column * CHAR_WIDTH; }
+int RowToPixelY(int row) { return row * ROW_HEIGHT; }
+
+int GetScreenWidth() { return SCREEN_WIDTH; }
+int GetScreenHeight() { return SCREEN_HEIGHT; }
+int GetGridWidth() { return GRID_WIDTH; }
+int GetGridHeight() { return GRID_HEIGHT; }
+
+int GetDividerCol() { return DIVIDER_COL; }
+int GetDetailsPanelCol() { return DIVIDER_COL + 2; }
+int GetListWidth() { return DIVIDER_COL; }
+int GetVisibleRows() { return GRID_HEIGHT - 3; }
+int GetFooterRow() { return GRID_HEIGHT - 1; }
+
+const Layout::PixelLayout& GetLayout() {
+    return sLayout;
+}
+
+} // namespace Renderer
@@ -0,0 +1,161 @@
+/**
+ * Mock FileStorage implementation
+ *
+ * Provides the FileStorage functions the loaders and ImageStore use. See
+ * file_storage_mock.h.
+ */
+
+#include "file_storage_mock.h"
+#include "../../src/storage/file_storage.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace {
+
+std::map<std::string, std::string> sFiles;
+uint64_t sBytesRead = 0;
+
+const std::string* findFile(const char* path) {
+    auto file = sFiles.find(path);
+    return file != sFiles.end() ? &file->second : nullptr;
+}
+
+} // anonymous namespace
+
+namespace MockFileStorage {
+
+void SetFile(const char* path, const std::string& contents) {
+    sFiles[path] = contents;
+}
+
+void RemoveFile(const char* path) {
+    sFiles.erase(path);
+}
+
+void Reset() {
+    sFiles.clear();
+}
+
+size_t GetFileSize(const char* path) {
+    const std::string* file = findFile(path);
+    return file ? file->size() : 0;
+}
+
+} // namespace MockFileStorage
+
+namespace FileStorage {
+
+bool ReadFile(const char* path, uint8_t** outData, size_t* outSize) {
+    const std::string* file = findFile(path);
+    if (!file) {
+        return false;
+    }
+
+    // Callers free() the data, and an empty file still needs a pointer
+    *outData = static_cast<uint8_t*>(malloc(file->size() + 1));
+    if (!*outData) {
+        return false;
+    }
+    memcpy(*outData, file->data(), file->size());
+    *outSize = file->size();
+    sBytesRead += file->size();
+    return true;
+}
+
+bool ReadFileInto(const char* path, ReadBuffer& buffer, size_t* outSize) {
+    const std::string* file = findFile(path);
+    if (!file) {
+        return false;
+    }
+
+    if (buffer.capacity < file->size() + 1) {
+        free(buffer.data);
+        buffer.capacity = file->size() + 1;
+        buffer.data = static_cast<uint8_t*>(malloc(buffer.capacity));
+        if (!buffer.data) {
+            buffer.capacity = 0;
+            return false;
+        }
+    }
+    memcpy(buffer.data, file->data(), file->size());
+    *outSize = file->size();
+    sBytesRead += file->size();
+    return true;
+}
+
+void FreeReadBuffer(ReadBuffer& buffer) {
+    free(buffer.data);
+    buffer.data = nullptr;
+    buffer.capacity = 0;
+}
+
+bool ReadAt(const char* path, size_t offset, void* buffer, size_t size) {
+    const std::string* file = findFile(path);
+    if (!file || offset > file->size() || size > file->size() - offset) {
+        return false;
+    }
+    memcpy(buffer, file->data() + offset, size);
+    sBytesRead += size;
+    return true;
+}
+
+bool WriteAt(const char* path, size_t offset, const void* data, size_t size) {
+    std::string& file = sFiles[path];
+    if (file.size() < offset + size) {
+        file.resize(offset + size);
+    }
+    file.replace(offset, size, static_cast<const char*>(data), size);
+    return true;
+}
+
+bool WriteFile(const char* path, const uint8_t* data, size_t size) {
+    sFiles[path].assign(reinterpret_cast<const char*>(data), size);
+    return true;
+}
+
+bool WriteAsync(const char* path, uint8_t* data, size_t size, AsyncCallback callback, void* context) {
+    bool isWritten = WriteFile(path, data, size);
+    free(data);
+    if (callback) {
+        callback(context, isWritten, nullptr, 0);
+    }
+    return isWritten;
+}
+
+bool OpenReader(const char* path, FileReader& reader) {
+    const std::string* file = findFile(path);
+    reader.file = file ? fmemopen(const_cast<char*>(file->data()), file->size(), "rb") : nullptr;
+    return reader.file != nullptr;
+}
+
+size_t ReadChunk(FileReader& reader, void* buffer, size_t size) {
+    if (!reader.file) {
+        return 0;
+    }
+    size_t bytesRead = fread(buffer, 1, size, reader.file);
+    sBytesRead += bytesRead;
+    return bytesRead;
+}
+
+void CloseReader(FileReader& reader) {
+    if (reader.file) {
+        fclose(reader.file);
+        reader.file = nullptr;
+    }
+}
+
+uint64_t GetBytesRead() {
+    return sBytesRead;
+}
+
+bool Exists(const char* path) {
+    return findFile(path) != nullptr;
+}
+
+bool CreateDir(const char*) {
+    return true;
+}
+
+} // namespace FileStorage
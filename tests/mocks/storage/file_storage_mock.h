@@ -0,0 +1,28 @@
+/**
+ * Mock FileStorage for unit tests and benchmarks
+ *
+ * Serves files from memory through the FileStorage read API, so code that
+ * loads from SD (presets, profiles, icons) runs on the host. Writes
+ * replace the stored file; WriteAt() patches it in place.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace MockFileStorage {
+
+// Create or replace a file
+void SetFile(const char* path, const std::string& contents);
+
+// Remove a file (later reads fail as if it were missing)
+void RemoveFile(const char* path);
+
+// Remove every file
+void Reset();
+
+// Size of a file, 0 if there is none
+size_t GetFileSize(const char* path);
+
+} // namespace MockFileStorage
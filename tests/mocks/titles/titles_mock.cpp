@@ -0,0 +1,207 @@
+/**
+ * Mock Titles store implementation
+ *
+ * Provides the Titles functions the menu modules read. See titles_mock.h.
+ */
+
+#include "titles_mock.h"
+#include "../../src/storage/settings.h"
+#include "../../src/titles/title_collation.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+std::vector<Titles::TitleInfo> sTitles;
+
+// Title IDs with their list index, ascending by ID
+std::vector<std::pair<uint64_t, int>> sIdIndex;
+
+std::vector<uint32_t> sCategoryMasks;
+uint32_t sMaskGeneration = 0;
+bool areMasksValid = false;
+
+std::vector<int> sPresetLinks;
+uint32_t sPresetGeneration = 0;
+bool arePresetLinksValid = false;
+
+uint32_t sListGeneration = 1;
+
+Titles::SortOrder sSortOrder = Titles::SortOrder::NAME;
+
+void buildMasks() {
+    const Settings::PluginSettings& settings = Settings::Get();
+    sCategoryMasks.assign(sTitles.size(), 0);
+    for (size_t index = 0; index < sTitles.size(); index++) {
+        uint64_t titleId = sTitles[index].titleId;
+        uint32_t mask = Settings::IsFavorite(titleId) ? Settings::FAVORITE_MASK_BIT : 0;
+        int categoryCount = std::min(static_cast<int>(settings.categories.size()), Settings::MAX_CATEGORIES);
+        for (int position = 0; position < categoryCount; position++) {
+            if (Settings::TitleHasCategory(titleId, settings.categories[position].id)) {
+                mask |= 1u << position;
+            }
+        }
+        sCategoryMasks[index] = mask;
+    }
+    sMaskGeneration = Settings::GetMembershipGeneration();
+    areMasksValid = true;
+}
+
+void linkPresets() {
+    uint32_t presetGeneration = TitlePresets::GetGeneration();
+    if (arePresetLinksValid && sPresetGeneration == presetGeneration) {
+        return;
+    }
+
+    sPresetLinks.assign(sTitles.size(), -1);
+    for (size_t index = 0; index < sTitles.size(); index++) {
+        sPresetLinks[index] = TitlePresets::GetPresetIndexByGameId(sTitles[index].productCode);
+    }
+    sPresetGeneration = presetGeneration;
+    arePresetLinksValid = true;
+}
+
+bool isValidIndex(int index) {
+    return index >= 0 && index < static_cast<int>(sTitles.size());
+}
+
+} // anonymous namespace
+
+namespace MockTitles {
+
+void SetTitles(const std::vector<Titles::TitleInfo>& titles) {
+    // Name order exactly as the real list sorts it
+    std::vector<uint64_t> keys(titles.size());
+    for (size_t index = 0; index < titles.size(); index++) {
+        keys[index] = TitleCollation::ComputeKey(titles[index].name);
+    }
+    std::vector<uint16_t> order(titles.size());
+    TitleCollation::SortByName(order.data(), static_cast<int>(order.size()), keys.data(), titles.data());
+
+    sTitles.clear();
+    sTitles.reserve(titles.size());
+    for (uint16_t recordIndex : order) {
+        sTitles.push_back(titles[recordIndex]);
+    }
+
+    sIdIndex.clear();
+    for (size_t index = 0; index < sTitles.size(); index++) {
+        sIdIndex.emplace_back(sTitles[index].titleId, static_cast<int>(index));
+    }
+    std::sort(sIdIndex.begin(), sIdIndex.end());
+
+    areMasksValid = false;
+    arePresetLinksValid = false;
+    Touch();
+}
+
+void Touch() {
+    sListGeneration++;
+}
+
+void Reset() {
+    SetTitles({});
+    sSortOrder = Titles::SortOrder::NAME;
+}
+
+} // namespace MockTitles
+
+namespace Titles {
+
+bool IsLoaded() {
+    return !sTitles.empty();
+}
+
+// Names are always resolved and the list always complete
+LoadState GetLoadState() {
+    LoadState state;
+    state.phase = sTitles.empty() ? LoadPhase::IDLE : LoadPhase::READY;
+    state.resolvedCount = static_cast<int>(sTitles.size());
+    state.totalCount = static_cast<int>(sTitles.size());
+    return state;
+}
+
+void PrioritizeName(uint64_t titleId) {
+    (void)titleId;
+}
+
+// Only the name order is kept; the order setting is remembered for callers
+void SetSortOrder(SortOrder order) {
+    if (order != sSortOrder) {
+        sSortOrder = order;
+        MockTitles::Touch();
+    }
+}
+
+SortOrder GetSortOrder() {
+    return sSortOrder;
+}
+
+const char* GetSortOrderName(SortOrder order) {
+    switch (order) {
+        case SortOrder::NAME:         return "Name";
+        case SortOrder::TITLE_ID:     return "Title ID";
+        case SortOrder::RECENT:       return "Recent";
+        case SortOrder::RELEASE_YEAR: return "Year";
+    }
+    return "";
+}
+
+uint32_t GetListGeneration() {
+    return sListGeneration;
+}
+
+int GetCount() {
+    return static_cast<int>(sTitles.size());
+}
+
+const TitleInfo* GetTitle(int index) {
+    return isValidIndex(index) ? &sTitles[index] : nullptr;
+}
+
+uint64_t GetTitleId(int index) {
+    return isValidIndex(index) ? sTitles[index].titleId : 0;
+}
+
+uint32_t GetCategoryMask(int index) {
+    if (!isValidIndex(index)) {
+        return 0;
+    }
+    if (!areMasksValid || sMaskGeneration != Settings::GetMembershipGeneration()) {
+        buildMasks();
+    }
+    return sCategoryMasks[index];
+}
+
+const TitlePresets::TitlePreset* GetPreset(int index) {
+    if (!isValidIndex(index)) {
+        return nullptr;
+    }
+    linkPresets();
+    return sPresetLinks[index] >= 0 ? TitlePresets::GetPresetByIndex(sPresetLinks[index]) : nullptr;
+}
+
+bool GetRecord(int index, TitleRecord* outRecord) {
+    if (!isValidIndex(index)) {
+        return false;
+    }
+    outRecord->info = &sTitles[index];
+    outRecord->preset = GetPreset(index);
+    outRecord->categoryMask = GetCategoryMask(index);
+    outRecord->isNameResolved = true;
+    return true;
+}
+
+int FindIndexById(uint64_t titleId) {
+    auto position = std::lower_bound(sIdIndex.begin(), sIdIndex.end(), std::make_pair(titleId, 0));
+    return position != sIdIndex.end() && position->first == titleId ? position->second : -1;
+}
+
+const TitleInfo* FindById(uint64_t titleId) {
+    int index = FindIndexById(titleId);
+    return index >= 0 ? &sTitles[index] : nullptr;
+}
+
+} // namespace Titles
@@ -0,0 +1,28 @@
+/**
+ * Mock Titles store for unit tests and benchmarks
+ *
+ * Serves a caller-supplied title list through the Titles read API, with
+ * the real store's caching: category masks follow
+ * Settings::GetMembershipGeneration() and preset links follow
+ * TitlePresets::GetGeneration(), so code under test pays what it would on
+ * the console rather than what a naive mock costs.
+ */
+
+#pragma once
+
+#include "../../src/titles/titles.h"
+
+#include <vector>
+
+namespace MockTitles {
+
+// Replace the list; titles are ordered by name like the real store
+void SetTitles(const std::vector<Titles::TitleInfo>& titles);
+
+// Report a list change without changing it (drops consumers' caches)
+void Touch();
+
+// Empty the list
+void Reset();
+
+} // namespace MockTitles
@@ -11,22 +11,14 @@ namespace Layout {
 static LayoutPreferences sPrefs = LayoutPreferences::Default();
 static PixelLayout sCachedLayout = {};
 
-const ScreenInfo& GetScreenInfo(ScreenType type) {
-    static ScreenInfo info = { 854, 480, "DRC", false };
-    (void)type;
-    return info;
-}
-
-PixelLayout ComputeLayout(ScreenType screen, const LayoutPreferences& prefs) {
-    (void)screen;
-    (void)prefs;
-    return {};
-}
-
 ScreenType GetCurrentScreenType() {
     return ScreenType::DRC;
 }
 
+void SetCurrentScreenType(ScreenType type) {
+    (void)type;
+}
+
 const LayoutPreferences& GetCurrentPreferences() {
     return sPrefs;
 }
@@ -27,10 +27,16 @@ namespace MockStorage {
 inline std::map<std::string, int32_t> intStore;
 inline std::map<std::string, std::vector<uint8_t>> binaryStore;
 
+// Call counters, for tests that check how much a save writes
+inline int storeCount = 0;
+inline int flushCount = 0;
+
 // Reset all stored data (call in test SetUp)
 inline void Reset() {
     intStore.clear();
     binaryStore.clear();
+    storeCount = 0;
+    flushCount = 0;
 }
 
 } // namespace MockStorage
@@ -52,6 +58,7 @@ inline WUPSStorageError WUPSStorageAPI_StoreInt(void*, const char* key, int32_t
     if (!key) return WUPS_STORAGE_ERROR_INVALID_ARGS;
 
     MockStorage::intStore[key] = value;
+    MockStorage::storeCount++;
     return WUPS_STORAGE_ERROR_SUCCESS;
 }
 
@@ -77,9 +84,11 @@ inline WUPSStorageError WUPSStorageAPI_StoreBinary(void*, const char* key,
 
     const uint8_t* bytes = static_cast<const uint8_t*>(data);
     MockStorage::binaryStore[key] = std::vector<uint8_t>(bytes, bytes + size);
+    MockStorage::storeCount++;
     return WUPS_STORAGE_ERROR_SUCCESS;
 }
 
 inline void WUPSStorageAPI_SaveStorage(bool) {
-    // No-op for tests - data is already in memory
+    // Data is already in memory; just count the flush
+    MockStorage::flushCount++;
 }
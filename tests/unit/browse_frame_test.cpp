@@ -0,0 +1,352 @@
+/**
+ * Steady-state frame tests for the browse screen
+ *
+ * Drives src/menu/panels/browse_panel.cpp through the mocks, one input
+ * and one Render() per simulated frame, and checks that once every path
+ * has run once, further frames make no heap allocations and only redraw
+ * what changed (the mock renderer's cost counters).
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "../fixtures/allocation_tracker.h"
+#include "../fixtures/library_fixture.h"
+#include "../mocks/render/image_loader_mock.h"
+#include "../mocks/render/renderer.h"
+#include "../mocks/storage/file_storage_mock.h"
+#include "../mocks/titles/titles_mock.h"
+#include "common/screen_constants.h"
+#include "input/buttons.h"
+#include "menu/categories.h"
+#include "menu/menu_state.h"
+#include "menu/panels/browse_panel.h"
+#include "presets/title_presets.h"
+#include "storage/settings.h"
+#include "utils/paths.h"
+
+namespace {
+
+constexpr int LIBRARY_SIZE = 512;
+
+// One button press per frame, then a few idle frames: scrolling, paging,
+// switching category and back, and favoriting a title and un-favoriting it
+std::vector<uint32_t> makeBrowseScript() {
+    std::vector<uint32_t> script;
+    auto press = [&script](const Buttons::Button& button, int times) {
+        for (int time = 0; time < times; time++) {
+            script.push_back(button.input);
+            script.push_back(0);
+        }
+    };
+
+    press(Buttons::Actions::NAV_DOWN, 40);
+    press(Buttons::Actions::NAV_PAGE_DOWN, 4);
+    press(Buttons::Actions::NAV_SKIP_DOWN, 4);
+    press(Buttons::Actions::NAV_UP, 10);
+    press(Buttons::Actions::FAVORITE, 2);
+    press(Buttons::Actions::CATEGORY_NEXT, 3);
+    press(Buttons::Actions::NAV_DOWN, 10);
+    press(Buttons::Actions::CATEGORY_PREV, 3);
+    press(Buttons::Actions::NAV_PAGE_UP, 8);
+    return script;
+}
+
+// What menu.cpp does for a browse frame
+void runFrame(uint32_t pressed) {
+    Menu::BrowsePanel::HandleInput(pressed, 0);
+    Renderer::SetRetainedMode(true);
+    Renderer::BeginFrame(0);
+    Menu::BrowsePanel::Render();
+    ImageLoader::Update();
+    Renderer::EndFrame();
+}
+
+// Icons are ready the frame after they're requested, and each buffer then
+// catches up in turn; after that both show the current screen
+void settle() {
+    for (int frame = 0; frame < 5; frame++) {
+        runFrame(0);
+    }
+}
+
+// Switch to the icon grid with its top row showing and nothing loaded,
+// as opening the menu on it would
+void enterGrid() {
+    Settings::Get().showIconGrid = true;
+    runFrame(0);
+    Settings::Get().showIconGrid = false;
+    runFrame(0);
+    MockImageLoader::Reset();
+    Settings::Get().showIconGrid = true;
+}
+
+constexpr long long SCREEN_PIXELS = Screen::DRC::WIDTH * Screen::DRC::HEIGHT;
+
+void runScript(const std::vector<uint32_t>& script) {
+    for (uint32_t pressed : script) {
+        runFrame(pressed);
+    }
+}
+
+} // anonymous namespace
+
+// The no-allocation tests below are only as good as the tracker
+TEST(AllocationTrackerTest, CountsAllocations) {
+    AllocationTracker::Start();
+    std::vector<int>* values = new std::vector<int>(16);
+    delete values;
+    AllocationTracker::Stop();
+
+    EXPECT_EQ(2, AllocationTracker::GetCount());
+    EXPECT_GE(AllocationTracker::GetBytes(), 16 * sizeof(int));
+}
+
+class BrowseFrameTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        LibraryFixture::Options options;
+        options.titleCount = LIBRARY_SIZE;
+        library = LibraryFixture::Generate(options);
+
+        Settings::Init();
+        LibraryFixture::ApplySettings(library);
+        MockFileStorage::SetFile(Paths::PRESETS_FILE, library.presetJson);
+        TitlePresets::Load();
+        MockTitles::SetTitles(library.titles);
+        MockImageLoader::Reset();
+        MockRenderer::Reset();
+
+        Categories::Init();
+        Menu::Internal::sTitleListState = UI::ListView::State();
+        Menu::Internal::clampSelection();
+    }
+
+    void TearDown() override {
+        AllocationTracker::Stop();
+        Categories::ClearSearch();
+        Categories::ClearFacetFilter();
+        MockTitles::Reset();
+        MockFileStorage::Reset();
+        MockImageLoader::Reset();
+        Settings::Init();
+    }
+
+    LibraryFixture::Library library;
+};
+
+TEST_F(BrowseFrameTest, Frames_DrawTheScreen) {
+    runFrame(0);
+
+    const MockRenderer::Counters& counters = MockRenderer::GetCounters();
+    EXPECT_GT(counters.textCalls, Renderer::GetVisibleRows());
+    EXPECT_GT(counters.invalidations, 0);
+    EXPECT_EQ(1, counters.imageCalls + counters.placeholderCalls);
+    EXPECT_GT(MockImageLoader::GetRequestCount(), 1);
+}
+
+TEST_F(BrowseFrameTest, IdleFrames_DoNotAllocate) {
+    runFrame(0);
+
+    AllocationTracker::Start();
+    for (int frame = 0; frame < 120; frame++) {
+        runFrame(0);
+    }
+    AllocationTracker::Stop();
+
+    EXPECT_EQ(0, AllocationTracker::GetCount())
+        << AllocationTracker::GetBytes() << " bytes, last " << AllocationTracker::GetLastSize();
+}
+
+TEST_F(BrowseFrameTest, BrowsingAfterWarmup_DoesNotAllocate) {
+    std::vector<uint32_t> script = makeBrowseScript();
+    runScript(script);
+
+    AllocationTracker::Start();
+    runScript(script);
+    AllocationTracker::Stop();
+
+    EXPECT_EQ(0, AllocationTracker::GetCount())
+        << AllocationTracker::GetBytes() << " bytes, last " << AllocationTracker::GetLastSize();
+}
+
+TEST_F(BrowseFrameTest, FirstFrame_DrawsTheWholeScreen) {
+    runFrame(0);
+
+    const MockRenderer::Counters& frame = MockRenderer::GetFrameCounters();
+    EXPECT_GE(frame.drcPixels, SCREEN_PIXELS);
+    EXPECT_GT(frame.tvPixels, 0);
+    EXPECT_GT(frame.glyphs, Renderer::GetVisibleRows() * 10);
+    EXPECT_GE(frame.flushBytes, SCREEN_PIXELS * 4);
+}
+
+TEST_F(BrowseFrameTest, UnchangedFrame_CostsNothing) {
+    settle();
+    runFrame(0);
+
+    const MockRenderer::Counters& frame = MockRenderer::GetFrameCounters();
+    EXPECT_EQ(0, frame.drcPixels);
+    EXPECT_EQ(0, frame.tvPixels);
+    EXPECT_EQ(0, frame.glyphs);
+    EXPECT_EQ(0, frame.blits);
+    EXPECT_EQ(0, frame.flushBytes);
+}
+
+// What a press costs until both buffers show it: invalidations made by
+// Render() reach the buffers over the next frames
+MockRenderer::Counters measurePress(uint32_t pressed) {
+    MockRenderer::Counters before = MockRenderer::GetCounters();
+    runFrame(pressed);
+    settle();
+    const MockRenderer::Counters& after = MockRenderer::GetCounters();
+
+    MockRenderer::Counters cost = {};
+    cost.glyphs = after.glyphs - before.glyphs;
+    cost.blits = after.blits - before.blits;
+    cost.drcPixels = after.drcPixels - before.drcPixels;
+    cost.tvPixels = after.tvPixels - before.tvPixels;
+    cost.flushBytes = after.flushBytes - before.flushBytes;
+    return cost;
+}
+
+// The same measure for a redraw of the whole screen
+MockRenderer::Counters measureFullRedraw() {
+    Renderer::InvalidateAll();
+    return measurePress(0);
+}
+
+TEST_F(BrowseFrameTest, MovingTheSelection_RedrawsTwoRowsAndTheDetails) {
+    settle();
+    MockRenderer::Counters full = measureFullRedraw();
+    MockRenderer::Counters cost = measurePress(Buttons::Actions::NAV_DOWN.input);
+
+    // Two list rows, the details panel with its icon and the footer; the
+    // header and the other rows are kept
+    EXPECT_GT(cost.drcPixels, 0);
+    EXPECT_LT(cost.drcPixels, full.drcPixels * 6 / 10);
+    EXPECT_LT(cost.tvPixels, full.tvPixels * 2 / 3);
+    EXPECT_LT(cost.glyphs, full.glyphs / 2);
+
+    // The icon once per buffer, and again if it loads meanwhile
+    EXPECT_LE(cost.blits, 4);
+}
+
+TEST_F(BrowseFrameTest, ScrollingAPage_StaysUnderAFullRedraw) {
+    settle();
+    MockRenderer::Counters full = measureFullRedraw();
+    for (int press = 0; press < Renderer::GetVisibleRows(); press++) {
+        runFrame(Buttons::Actions::NAV_DOWN.input);
+    }
+    settle();
+
+    // Every list row changes; the header does not
+    MockRenderer::Counters cost = measurePress(Buttons::Actions::NAV_DOWN.input);
+    EXPECT_GT(cost.drcPixels, 0);
+    EXPECT_LT(cost.drcPixels, full.drcPixels);
+    EXPECT_LT(cost.glyphs, full.glyphs);
+}
+
+TEST_F(BrowseFrameTest, FullRedraws_CostTheWholeScreenOnBothBuffers) {
+    settle();
+    MockRenderer::Counters full = measureFullRedraw();
+
+    EXPECT_GE(full.drcPixels, 2 * SCREEN_PIXELS);
+    EXPECT_GE(full.tvPixels, 2LL * Screen::TV::P720::WIDTH * Screen::TV::P720::HEIGHT);
+    EXPECT_EQ(2, full.blits);
+}
+
+TEST_F(BrowseFrameTest, IconGrid_RequestsTheVisibleCellsAndTheNextRow) {
+    enterGrid();
+    runFrame(0);
+
+    const Layout::PixelLayout::Grid& grid = Renderer::GetLayout().grid;
+    EXPECT_EQ(grid.GetCellCount() + grid.columns, MockImageLoader::GetRequestCount());
+    EXPECT_EQ(grid.iconSize, MockImageLoader::GetIconSize());
+}
+
+TEST_F(BrowseFrameTest, IconGrid_ScrollingRequestsOnlyWhatScrollsIntoView) {
+    enterGrid();
+    runFrame(0);
+    int before = MockImageLoader::GetRequestCount();
+
+    // A page moves the selection a screenful and the grid one row, which
+    // was already prefetched; the row after it is new
+    runFrame(Buttons::Actions::NAV_PAGE_DOWN.input);
+    const Layout::PixelLayout::Grid& grid = Renderer::GetLayout().grid;
+    EXPECT_EQ(before + grid.columns, MockImageLoader::GetRequestCount());
+}
+
+TEST_F(BrowseFrameTest, IconGrid_LeavingIt_DecodesTheDetailsIcon) {
+    enterGrid();
+    runFrame(0);
+    Settings::Get().showIconGrid = false;
+    runFrame(0);
+
+    EXPECT_EQ(0, MockImageLoader::GetIconSize());
+}
+
+TEST_F(BrowseFrameTest, IconGrid_MovingTheSelection_RedrawsTwoCells) {
+    enterGrid();
+    settle();
+    MockRenderer::Counters full = measureFullRedraw();
+    MockRenderer::Counters cost = measurePress(Buttons::Actions::NAV_DOWN.input);
+
+    // Two cells, the caption and the footer
+    EXPECT_GT(cost.drcPixels, 0);
+    EXPECT_LT(cost.drcPixels, full.drcPixels / 4);
+    EXPECT_LT(cost.glyphs, full.glyphs / 2);
+    EXPECT_LE(cost.blits, 4);
+}
+
+TEST_F(BrowseFrameTest, BrowsingTheGridAfterWarmup_DoesNotAllocate) {
+    enterGrid();
+    std::vector<uint32_t> script = makeBrowseScript();
+    runScript(script);
+
+    AllocationTracker::Start();
+    runScript(script);
+    AllocationTracker::Stop();
+
+    EXPECT_EQ(0, AllocationTracker::GetCount())
+        << AllocationTracker::GetBytes() << " bytes, last " << AllocationTracker::GetLastSize();
+}
+
+TEST_F(BrowseFrameTest, TVPacingOff_DrawsOnlyTheDRC) {
+    settle();
+    Renderer::SetTVPacing(Renderer::TVPacing::OFF);
+    MockRenderer::Counters cost = measurePress(Buttons::Actions::NAV_DOWN.input);
+
+    EXPECT_GT(cost.drcPixels, 0);
+    EXPECT_EQ(0, cost.tvPixels);
+    EXPECT_FALSE(Renderer::IsTVBehind());
+}
+
+TEST_F(BrowseFrameTest, DividedTVPacing_DrawsTheTVEveryNthFrame) {
+    settle();
+    Renderer::SetTVPacing(Renderer::TVPacing::DIVIDED, 3);
+    int before = MockRenderer::GetCounters().tvFrames;
+    for (int frame = 0; frame < 12; frame++) {
+        runFrame(Buttons::Actions::NAV_DOWN.input);
+    }
+
+    // The first change is drawn at once, the rest every third frame
+    int tvFrames = MockRenderer::GetCounters().tvFrames - before;
+    EXPECT_GT(tvFrames, 0);
+    EXPECT_LE(tvFrames, 12 / 3 + 1);
+}
+
+TEST_F(BrowseFrameTest, OnChangeTVPacing_CatchesUpOnceTheDRCSettles) {
+    settle();
+    Renderer::SetTVPacing(Renderer::TVPacing::ON_CHANGE);
+    int before = MockRenderer::GetCounters().tvFrames;
+    for (int frame = 0; frame < 5; frame++) {
+        runFrame(Buttons::Actions::NAV_DOWN.input);
+    }
+    EXPECT_EQ(before, MockRenderer::GetCounters().tvFrames);
+    EXPECT_TRUE(Renderer::IsTVBehind());
+
+    // Each TV buffer once
+    settle();
+    EXPECT_EQ(before + 2, MockRenderer::GetCounters().tvFrames);
+    EXPECT_FALSE(Renderer::IsTVBehind());
+}
@@ -0,0 +1,133 @@
+/**
+ * Unit tests for src/editor/edit_history.cpp
+ *
+ * Tests undo/redo round trips, stroke grouping, delta size and the byte
+ * budget.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "editor/edit_history.h"
+
+class EditHistoryTest : public ::testing::Test {
+protected:
+    static constexpr int WIDTH = 100;   // Not a multiple of the tile size
+    static constexpr int HEIGHT = 60;
+    static constexpr uint32_t WHITE = 0xFFFFFFFF;
+
+    std::vector<uint32_t> pixels;
+
+    void SetUp() override {
+        pixels.assign(WIDTH * HEIGHT, WHITE);
+        EditHistory::Init(pixels.data(), WIDTH, HEIGHT);
+    }
+
+    void TearDown() override {
+        EditHistory::Clear();
+    }
+
+    void paint(int x, int y, uint32_t color) {
+        EditHistory::Record(x, y);
+        pixels[y * WIDTH + x] = color;
+    }
+
+    void fillAll(uint32_t color) {
+        EditHistory::BeginStroke();
+        for (int y = 0; y < HEIGHT; y++) {
+            EditHistory::RecordSpan(0, WIDTH - 1, y);
+            std::fill_n(pixels.begin() + y * WIDTH, WIDTH, color);
+        }
+        EditHistory::EndStroke();
+    }
+};
+
+// =============================================================================
+// Undo / Redo Tests
+// =============================================================================
+
+TEST_F(EditHistoryTest, UndoRedo_RestoresStroke) {
+    EditHistory::BeginStroke();
+    paint(3, 4, 0xFF0000FF);
+    paint(97, 58, 0x00FF00FF);
+    EditHistory::EndStroke();
+    std::vector<uint32_t> after = pixels;
+
+    EditHistory::PixelRect changed;
+    ASSERT_TRUE(EditHistory::Undo(&changed));
+    EXPECT_EQ(std::vector<uint32_t>(WIDTH * HEIGHT, WHITE), pixels);
+    EXPECT_EQ(0, changed.left);
+    EXPECT_EQ(0, changed.top);
+    EXPECT_EQ(WIDTH - 1, changed.right);
+    EXPECT_EQ(HEIGHT - 1, changed.bottom);
+
+    ASSERT_TRUE(EditHistory::Redo(&changed));
+    EXPECT_EQ(after, pixels);
+}
+
+TEST_F(EditHistoryTest, Stroke_IsOneStep) {
+    EditHistory::BeginStroke();
+    for (int x = 0; x < 50; x++) {
+        paint(x, 10, 0x000000FF);
+    }
+    EditHistory::EndStroke();
+
+    EXPECT_EQ(1, EditHistory::GetUndoCount());
+}
+
+TEST_F(EditHistoryTest, UnchangedStroke_IsDropped) {
+    EditHistory::BeginStroke();
+    paint(5, 5, 0x000000FF);
+    paint(5, 5, WHITE);
+    EditHistory::EndStroke();
+
+    EXPECT_FALSE(EditHistory::CanUndo());
+    EXPECT_EQ(0u, EditHistory::GetUsedBytes());
+}
+
+TEST_F(EditHistoryTest, NewStroke_DropsRedo) {
+    fillAll(0x000000FF);
+    EditHistory::PixelRect changed;
+    ASSERT_TRUE(EditHistory::Undo(&changed));
+    ASSERT_TRUE(EditHistory::CanRedo());
+
+    fillAll(0xFF0000FF);
+    EXPECT_FALSE(EditHistory::CanRedo());
+    EXPECT_EQ(1, EditHistory::GetUndoCount());
+}
+
+TEST_F(EditHistoryTest, OpenStroke_BlocksUndo) {
+    fillAll(0x000000FF);
+    EditHistory::BeginStroke();
+
+    EditHistory::PixelRect changed;
+    EXPECT_FALSE(EditHistory::Undo(&changed));
+    EditHistory::EndStroke();
+    EXPECT_TRUE(EditHistory::Undo(&changed));
+}
+
+// =============================================================================
+// Size Tests
+// =============================================================================
+
+TEST_F(EditHistoryTest, PlainFill_EncodesSmall) {
+    fillAll(0x000000FF);
+
+    // 13x8 tiles, each one repeated word plus its index and ops
+    EXPECT_LT(EditHistory::GetUsedBytes(), 13u * 8u * 16u + 256u);
+}
+
+TEST_F(EditHistoryTest, Budget_DropsOldestSteps) {
+    EditHistory::Init(pixels.data(), WIDTH, HEIGHT, 4096);
+    for (int step = 0; step < 50; step++) {
+        fillAll(step % 2 ? 0x000000FF : 0xFF0000FF);
+    }
+
+    EXPECT_LE(EditHistory::GetUsedBytes(), 4096u);
+    EXPECT_GT(EditHistory::GetUndoCount(), 0);
+    EXPECT_LT(EditHistory::GetUndoCount(), 50);
+
+    // Whatever is kept still undoes correctly
+    EditHistory::PixelRect changed;
+    ASSERT_TRUE(EditHistory::Undo(&changed));
+    EXPECT_EQ(0xFF0000FF, pixels[0]);
+}
@@ -0,0 +1,192 @@
+/**
+ * Unit tests for src/storage/image_store.cpp
+ *
+ * Tests that an icon edited with ReplaceStoredIcon() outlives the memory
+ * cache: it is read back from the icon pack after a clear and in the next
+ * session, ahead of the old pack entry, the SD icon and the missing list,
+ * and that repeated edits compact the pack instead of growing it. Icons
+ * are TGA files on the mock SD card.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "storage/image_store.h"
+#include "../mocks/storage/file_storage_mock.h"
+
+namespace {
+
+constexpr uint64_t TITLE_ID = 0x0005000010101D00ull;
+constexpr uint64_t OTHER_TITLE_ID = 0x0005000010144F00ull;
+constexpr int ICON_SIDE = 4;
+
+constexpr uint32_t RED = 0xFF0000FFu;
+constexpr uint32_t BLUE = 0x0000FFFFu;
+
+constexpr const char* ICON_PACK_PATH = "sd:/wiiu/environments/aroma/plugins/config/TitleSwitcher/icons.pack";
+
+// Uncompressed 32-bpp top-down TGA of one RGBA8888 color
+std::string makeTGA(uint32_t color) {
+    std::string tga(18, '\0');
+    tga[2] = 2;
+    tga[12] = ICON_SIDE;
+    tga[14] = ICON_SIDE;
+    tga[16] = 32;
+    tga[17] = 0x20;
+    for (int pixel = 0; pixel < ICON_SIDE * ICON_SIDE; pixel++) {
+        tga += static_cast<char>((color >> 8) & 0xFF);
+        tga += static_cast<char>((color >> 16) & 0xFF);
+        tga += static_cast<char>((color >> 24) & 0xFF);
+        tga += static_cast<char>(color & 0xFF);
+    }
+    return tga;
+}
+
+void setSDIcon(uint32_t color, uint64_t titleId = TITLE_ID) {
+    char path[160];
+    ImageStore::GetIconPath(titleId, path, sizeof(path));
+    MockFileStorage::SetFile(path, makeTGA(color));
+}
+
+void removeSDIcon(uint64_t titleId = TITLE_ID) {
+    char path[160];
+    ImageStore::GetIconPath(titleId, path, sizeof(path));
+    MockFileStorage::RemoveFile(path);
+}
+
+// First pixel of the title's icon after a load, 0 if none loaded
+uint32_t loadColor(uint64_t titleId = TITLE_ID) {
+    Renderer::ImageHandle handle = Renderer::INVALID_IMAGE;
+    if (!ImageStore::Load(titleId, handle) || !handle) {
+        return 0;
+    }
+    return handle->pixels[0];
+}
+
+// What the pixel editor does on close, with the worker's part inline
+void editIcon(uint32_t color) {
+    std::vector<uint32_t> pixels(ICON_SIDE * ICON_SIDE, color);
+    ImageStore::ReplaceInMemoryCache(TITLE_ID, pixels.data(), ICON_SIDE, ICON_SIDE);
+    ImageStore::ReplaceStoredIcon(TITLE_ID, pixels.data(), ICON_SIDE, ICON_SIDE);
+}
+
+}
+
+class ImageStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MockFileStorage::Reset();
+        ImageStore::Init();
+        ImageStore::SetIconSize(0);
+        ImageStore::SetPixelFormat(Renderer::PixelFormat::RGBA8888);
+    }
+
+    void TearDown() override {
+        ImageStore::Shutdown();
+        ImageStore::SetPixelFormat(ImageStore::DEFAULT_PIXEL_FORMAT);
+        MockFileStorage::Reset();
+    }
+};
+
+TEST_F(ImageStoreTest, Load_PacksSDIcon) {
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+
+    // The SD icon is gone; the pack still has it
+    removeSDIcon();
+    ImageStore::ClearMemoryCache();
+    EXPECT_EQ(loadColor(), RED);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_EditSurvivesClearedCache) {
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+
+    editIcon(BLUE);
+    EXPECT_EQ(loadColor(), BLUE);
+
+    // The old packed icon and the SD file are both still red
+    ImageStore::ClearMemoryCache();
+    EXPECT_EQ(loadColor(), BLUE);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_EditSurvivesNextSession) {
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+    editIcon(BLUE);
+
+    ImageStore::Shutdown();
+    ImageStore::Init();
+    EXPECT_EQ(loadColor(), BLUE);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_ClearsMissingMark) {
+    ImageStore::LoadError error = ImageStore::LoadError::NONE;
+    Renderer::ImageHandle handle = Renderer::INVALID_IMAGE;
+    EXPECT_FALSE(ImageStore::Load(TITLE_ID, handle, &error));
+    EXPECT_EQ(error, ImageStore::LoadError::NOT_FOUND);
+    ImageStore::FlushPendingWrites();
+
+    editIcon(BLUE);
+    ImageStore::ClearMemoryCache();
+    EXPECT_EQ(loadColor(), BLUE);
+
+    ImageStore::Shutdown();
+    ImageStore::Init();
+    EXPECT_EQ(loadColor(), BLUE);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_WithoutPixelsFallsBackToSD) {
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+
+    // The edit's copy couldn't be made; its SD file is read instead
+    setSDIcon(BLUE);
+    ImageStore::ReplaceStoredIcon(TITLE_ID, nullptr, 0, 0);
+    ImageStore::ClearMemoryCache();
+    EXPECT_EQ(loadColor(), BLUE);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_RepeatedEditsCompactPack) {
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+    size_t packSize = MockFileStorage::GetFileSize(ICON_PACK_PATH);
+    ASSERT_GT(packSize, 0u);
+
+    // Each edit strands the previous pixels; compaction reuses them
+    for (int edit = 0; edit < 32; edit++) {
+        editIcon(edit % 2 ? RED : BLUE);
+    }
+    EXPECT_LE(MockFileStorage::GetFileSize(ICON_PACK_PATH), packSize * 3);
+
+    ImageStore::ClearMemoryCache();
+    EXPECT_EQ(loadColor(), RED);
+
+    ImageStore::Shutdown();
+    ImageStore::Init();
+    EXPECT_EQ(loadColor(), RED);
+}
+
+TEST_F(ImageStoreTest, ReplaceStoredIcon_CompactionKeepsOtherIcons) {
+    setSDIcon(BLUE, OTHER_TITLE_ID);
+    EXPECT_EQ(loadColor(OTHER_TITLE_ID), BLUE);
+    setSDIcon(RED);
+    EXPECT_EQ(loadColor(), RED);
+    ImageStore::FlushPendingWrites();
+    removeSDIcon(OTHER_TITLE_ID);
+
+    // The other title's pixels sit below the dead ones and move with them
+    for (int edit = 0; edit < 8; edit++) {
+        editIcon(edit % 2 ? RED : BLUE);
+    }
+
+    ImageStore::Shutdown();
+    ImageStore::Init();
+    EXPECT_EQ(loadColor(OTHER_TITLE_ID), BLUE);
+    EXPECT_EQ(loadColor(), RED);
+}
@@ -0,0 +1,132 @@
+/**
+ * Unit tests for src/input/input_recorder.cpp
+ *
+ * Tests the record/replay round trip, run-length encoding, the file
+ * layout and rejecting files that aren't recordings.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "input/input_recorder.h"
+
+class InputRecorderTest : public ::testing::Test {
+protected:
+    static constexpr uint32_t BUTTON_A = 0x8000;
+    static constexpr uint32_t BUTTON_DOWN = 0x0100;
+
+    struct Frame {
+        bool hasRead;
+        uint32_t pressed;
+        uint32_t held;
+    };
+
+    void TearDown() override {
+        InputRecorder::Release();
+    }
+
+    void record(const std::vector<Frame>& frames) {
+        ASSERT_TRUE(InputRecorder::StartRecording());
+        for (const Frame& frame : frames) {
+            uint32_t pressed = frame.pressed;
+            uint32_t held = frame.held;
+            EXPECT_EQ(InputRecorder::Apply(frame.hasRead, &pressed, &held), frame.hasRead);
+            EXPECT_EQ(pressed, frame.pressed);
+            EXPECT_EQ(held, frame.held);
+        }
+        InputRecorder::Stop();
+    }
+
+    std::vector<uint8_t> encode() {
+        std::vector<uint8_t> data(InputRecorder::GetEncodedSize());
+        EXPECT_EQ(InputRecorder::Encode(data.data(), data.size()), data.size());
+        return data;
+    }
+
+    // Live input is the same every frame, so only the replay shows through
+    Frame replayFrame() {
+        Frame frame = {true, BUTTON_DOWN, BUTTON_DOWN};
+        frame.hasRead = InputRecorder::Apply(true, &frame.pressed, &frame.held);
+        return frame;
+    }
+};
+
+TEST_F(InputRecorderTest, Replay_ReturnsTheRecordedFramesInOrder) {
+    std::vector<Frame> frames = {
+        {true, 0, 0},
+        {true, BUTTON_DOWN, BUTTON_DOWN},
+        {true, 0, BUTTON_DOWN},
+        {true, 0, BUTTON_DOWN},
+        {false, 0, 0},
+        {true, BUTTON_A, BUTTON_A},
+        {true, 0, 0},
+    };
+    record(frames);
+    std::vector<uint8_t> data = encode();
+
+    ASSERT_TRUE(InputRecorder::StartReplay(data.data(), data.size()));
+    EXPECT_EQ(InputRecorder::GetFrameCount(), frames.size());
+    for (const Frame& expected : frames) {
+        ASSERT_EQ(InputRecorder::GetMode(), InputRecorder::Mode::REPLAYING);
+        Frame frame = replayFrame();
+        EXPECT_EQ(frame.hasRead, expected.hasRead);
+        EXPECT_EQ(frame.pressed, expected.pressed);
+        EXPECT_EQ(frame.held, expected.held);
+    }
+    EXPECT_EQ(InputRecorder::GetMode(), InputRecorder::Mode::IDLE);
+    EXPECT_EQ(InputRecorder::GetFrameCount(), 0u);
+}
+
+TEST_F(InputRecorderTest, ReplayEnded_PassesLiveInputThrough) {
+    record({{true, BUTTON_A, BUTTON_A}});
+    std::vector<uint8_t> data = encode();
+    ASSERT_TRUE(InputRecorder::StartReplay(data.data(), data.size()));
+
+    EXPECT_EQ(replayFrame().pressed, BUTTON_A);
+    Frame live = replayFrame();
+    EXPECT_TRUE(live.hasRead);
+    EXPECT_EQ(live.pressed, BUTTON_DOWN);
+}
+
+TEST_F(InputRecorderTest, RepeatedFrames_ShareOneRun) {
+    std::vector<Frame> frames(600, Frame{true, 0, BUTTON_DOWN});
+    frames.push_back({true, 0, 0});
+    record(frames);
+
+    EXPECT_EQ(InputRecorder::GetFrameCount(), 601u);
+    EXPECT_EQ(InputRecorder::GetEncodedSize(), InputRecorder::HEADER_SIZE + 2 * InputRecorder::RUN_SIZE);
+}
+
+TEST_F(InputRecorderTest, Encode_IsLittleEndian) {
+    record({{true, BUTTON_A, BUTTON_A}, {true, BUTTON_A, BUTTON_A}});
+    std::vector<uint8_t> data = encode();
+
+    ASSERT_EQ(data.size(), InputRecorder::HEADER_SIZE + InputRecorder::RUN_SIZE);
+    EXPECT_EQ(std::string(data.begin(), data.begin() + 4), "TSIR");
+    EXPECT_EQ(data[8], 1);      // Runs
+    EXPECT_EQ(data[12], 2);     // Frames
+    const uint8_t* run = data.data() + InputRecorder::HEADER_SIZE;
+    EXPECT_EQ(run[0], 0x00);
+    EXPECT_EQ(run[1], 0x80);    // BUTTON_A's low bytes
+    EXPECT_EQ(run[8], 2);
+}
+
+TEST_F(InputRecorderTest, StartReplay_RejectsWhatIsNotARecording) {
+    record({{true, BUTTON_A, BUTTON_A}});
+    std::vector<uint8_t> data = encode();
+
+    std::vector<uint8_t> badMagic = data;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(InputRecorder::StartReplay(badMagic.data(), badMagic.size()));
+
+    EXPECT_FALSE(InputRecorder::StartReplay(data.data(), data.size() - 1));
+    EXPECT_FALSE(InputRecorder::StartReplay(data.data(), InputRecorder::HEADER_SIZE - 1));
+    EXPECT_FALSE(InputRecorder::StartReplay(nullptr, 0));
+    EXPECT_EQ(InputRecorder::GetMode(), InputRecorder::Mode::IDLE);
+}
+
+TEST_F(InputRecorderTest, Idle_LeavesInputAlone) {
+    Frame frame = replayFrame();
+    EXPECT_TRUE(frame.hasRead);
+    EXPECT_EQ(frame.pressed, BUTTON_DOWN);
+    EXPECT_EQ(InputRecorder::GetFrameCount(), 0u);
+}
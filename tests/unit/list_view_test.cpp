@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include "ui/list_view.h"
+#include "input/buttons.h"
 
 using namespace UI::ListView;
 
@@ -255,3 +256,74 @@ TEST(ListViewItemViewTest, DefaultItemView_HasReasonableDefaults) {
     EXPECT_EQ(view.prefixColor, 0xFFFFFFFF);
     EXPECT_FALSE(view.dimmed);
 }
+
+// =============================================================================
+// Key Repeat Tests
+// =============================================================================
+
+class ListViewRepeatTest : public ::testing::Test {
+protected:
+    State state;
+    Config config;
+
+    static constexpr uint32_t DOWN = Buttons::Actions::NAV_DOWN.input;
+
+    void SetUp() override {
+        state = State();
+        state.itemCount = 500;
+        config = Config();
+        config.visibleRows = 10;
+    }
+};
+
+TEST_F(ListViewRepeatTest, Press_MovesOnce) {
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    EXPECT_EQ(state.selectedIndex, 1);
+}
+
+TEST_F(ListViewRepeatTest, Hold_WaitsForDelay) {
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    HandleInputAt(state, 0, DOWN, REPEAT_DELAY_MS - 1, config);
+    EXPECT_EQ(state.selectedIndex, 1);
+    HandleInputAt(state, 0, DOWN, REPEAT_DELAY_MS, config);
+    EXPECT_EQ(state.selectedIndex, 2);
+}
+
+TEST_F(ListViewRepeatTest, Release_StopsRepeat) {
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    HandleInputAt(state, 0, 0, 100, config);
+    HandleInputAt(state, 0, DOWN, REPEAT_DELAY_MS, config);
+    EXPECT_EQ(state.selectedIndex, 1);
+}
+
+TEST_F(ListViewRepeatTest, LongHold_Accelerates) {
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    uint32_t nowMs = 0;
+    while (nowMs < REPEAT_ACCEL_AFTER_MS) {
+        nowMs += 16;
+        HandleInputAt(state, 0, DOWN, nowMs, config);
+    }
+    int before = state.selectedIndex;
+    HandleInputAt(state, 0, DOWN, nowMs + REPEAT_FAST_INTERVAL_MS, config);
+    EXPECT_EQ(state.selectedIndex - before, REPEAT_ACCEL_STEP);
+}
+
+TEST_F(ListViewRepeatTest, Step_MovesAGridRow) {
+    config = BrowseGridConfig(8, 4);
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    EXPECT_EQ(state.selectedIndex, 8);
+    HandleInputAt(state, 0, DOWN, REPEAT_DELAY_MS, config);
+    EXPECT_EQ(state.selectedIndex, 16);
+
+    uint32_t right = Buttons::Actions::NAV_SKIP_DOWN.input;
+    HandleInputAt(state, right, right, REPEAT_DELAY_MS + 100, config);
+    EXPECT_EQ(state.selectedIndex, 17);
+}
+
+TEST_F(ListViewRepeatTest, Repeat_DoesNotWrap) {
+    config.wrapAround = true;
+    state.selectedIndex = 498;
+    HandleInputAt(state, DOWN, DOWN, 0, config);
+    HandleInputAt(state, 0, DOWN, REPEAT_DELAY_MS, config);
+    EXPECT_EQ(state.selectedIndex, 499);
+}
@@ -0,0 +1,109 @@
+/**
+ * Unit tests for src/utils/memory_budget.cpp
+ *
+ * Tests usage totals, shrink order, stopping at the target and the relief
+ * counters.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include "utils/memory_budget.h"
+
+using MemoryBudget::Pool;
+using MemoryBudget::Pressure;
+
+namespace {
+
+size_t sIconBytes = 0;
+size_t sPresetBytes = 0;
+size_t sTitleBytes = 0;
+std::string sShrinkOrder;
+
+size_t getIconBytes() { return sIconBytes; }
+size_t getPresetBytes() { return sPresetBytes; }
+size_t getTitleBytes() { return sTitleBytes; }
+
+// Icons halve under moderate pressure and go under critical
+void shrinkIcons(Pressure pressure)
+{
+    sShrinkOrder += "I";
+    sIconBytes = pressure == Pressure::CRITICAL ? 0 : sIconBytes / 2;
+}
+
+// Presets only go under critical pressure
+void shrinkPresets(Pressure pressure)
+{
+    sShrinkOrder += "P";
+    if (pressure == Pressure::CRITICAL) {
+        sPresetBytes = 0;
+    }
+}
+
+}
+
+class MemoryBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sIconBytes = 4000;
+        sPresetBytes = 2000;
+        sTitleBytes = 500;
+        sShrinkOrder.clear();
+
+        // Registered out of order; Pool order decides
+        MemoryBudget::Register(Pool::PRESETS, getPresetBytes, shrinkPresets);
+        MemoryBudget::Register(Pool::TITLES, getTitleBytes);
+        MemoryBudget::Register(Pool::ICONS, getIconBytes, shrinkIcons);
+    }
+
+    void TearDown() override {
+        for (int poolIndex = 0; poolIndex < MemoryBudget::POOL_COUNT; poolIndex++) {
+            MemoryBudget::Unregister(static_cast<Pool>(poolIndex));
+        }
+    }
+};
+
+// =============================================================================
+// Usage Tests
+// =============================================================================
+
+TEST_F(MemoryBudgetTest, Usage_SumsRegisteredPools) {
+    EXPECT_EQ(4000u, MemoryBudget::GetUsage(Pool::ICONS));
+    EXPECT_EQ(0u, MemoryBudget::GetUsage(Pool::FONT));
+    EXPECT_FALSE(MemoryBudget::IsRegistered(Pool::FONT));
+    EXPECT_EQ(6500u, MemoryBudget::GetTotalUsage());
+}
+
+// =============================================================================
+// Relief Tests
+// =============================================================================
+
+TEST_F(MemoryBudgetTest, Relieve_ShrinksInPoolOrder) {
+    size_t freed = MemoryBudget::Relieve(Pressure::MODERATE);
+
+    EXPECT_EQ("IP", sShrinkOrder);
+    EXPECT_EQ(2000u, freed);
+    EXPECT_EQ(2000u, MemoryBudget::GetUsage(Pool::ICONS));
+    EXPECT_EQ(2000u, MemoryBudget::GetUsage(Pool::PRESETS));
+    EXPECT_EQ(2000u, MemoryBudget::GetLastFreedBytes());
+}
+
+TEST_F(MemoryBudgetTest, Relieve_StopsAtTarget) {
+    size_t freed = MemoryBudget::Relieve(Pressure::CRITICAL, 1000);
+
+    EXPECT_EQ("I", sShrinkOrder);
+    EXPECT_EQ(4000u, freed);
+    EXPECT_EQ(2000u, MemoryBudget::GetUsage(Pool::PRESETS));
+}
+
+TEST_F(MemoryBudgetTest, Relieve_CountsEachPressure) {
+    uint32_t moderate = MemoryBudget::GetReliefCount(Pressure::MODERATE);
+    uint32_t critical = MemoryBudget::GetReliefCount(Pressure::CRITICAL);
+
+    MemoryBudget::Relieve(Pressure::MODERATE);
+    MemoryBudget::Relieve(Pressure::CRITICAL);
+    MemoryBudget::Relieve(Pressure::CRITICAL);
+
+    EXPECT_EQ(moderate + 1, MemoryBudget::GetReliefCount(Pressure::MODERATE));
+    EXPECT_EQ(critical + 2, MemoryBudget::GetReliefCount(Pressure::CRITICAL));
+    EXPECT_EQ(0u, MemoryBudget::GetLastFreedBytes());
+}
@@ -0,0 +1,204 @@
+/**
+ * Scaling stress tests over tests/fixtures/library_fixture.cpp
+ *
+ * Tests that the generated library is deterministic and realistic, and
+ * that the real title sort orders its collation cases and does n log n
+ * work from a small library to a 2048-title one. Work is counted, not
+ * timed, so a loaded host can't fail it; the timings of filtering, search,
+ * lookups and the preset parse per scale are in tests/bench.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <string>
+#include <strings.h>
+#include "../fixtures/library_fixture.h"
+#include "../mocks/storage/file_storage_mock.h"
+#include "../mocks/titles/titles_mock.h"
+#include "menu/categories.h"
+#include "menu/search_index.h"
+#include "presets/title_presets.h"
+#include "titles/title_collation.h"
+#include "storage/settings.h"
+#include "utils/paths.h"
+
+namespace {
+
+constexpr int SMALL_COUNT = 256;
+constexpr int LARGE_COUNT = 2048;
+
+// Eight times the items: n log n work grows about 11x, quadratic 64x
+constexpr int MAX_SORT_GROWTH = 16;
+
+LibraryFixture::Library makeLibrary(int count) {
+    LibraryFixture::Options options;
+    options.titleCount = count;
+    options.presetCount = count;
+    options.assignmentCount = count;
+    options.favoriteCount = count / 3;
+    return LibraryFixture::Generate(options);
+}
+
+void loadLibrary(const LibraryFixture::Library& library) {
+    Settings::Init();
+    LibraryFixture::ApplySettings(library);
+    MockFileStorage::SetFile(Paths::PRESETS_FILE, library.presetJson);
+    TitlePresets::Load();
+    MockTitles::SetTitles(library.titles);
+}
+
+// The library's records in the order the title list sorts them
+std::vector<uint16_t> sortLibrary(const LibraryFixture::Library& library,
+                                  TitleCollation::SortStats* outStats = nullptr) {
+    std::vector<uint64_t> keys(library.titles.size());
+    for (size_t index = 0; index < library.titles.size(); index++) {
+        keys[index] = TitleCollation::ComputeKey(library.titles[index].name);
+    }
+    std::vector<uint16_t> order(library.titles.size());
+    TitleCollation::SortByName(order.data(), static_cast<int>(order.size()), keys.data(),
+                               library.titles.data(), outStats);
+    return order;
+}
+
+} // anonymous namespace
+
+class ScalingTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        Categories::ClearSearch();
+        Categories::ClearFacetFilter();
+        MockTitles::Reset();
+        MockFileStorage::Reset();
+        Settings::Init();
+    }
+
+};
+
+// =============================================================================
+// Fixture Tests
+// =============================================================================
+
+TEST_F(ScalingTest, Fixture_IsDeterministic) {
+    LibraryFixture::Library first = makeLibrary(300);
+    LibraryFixture::Library second = makeLibrary(300);
+
+    ASSERT_EQ(first.titles.size(), second.titles.size());
+    for (size_t index = 0; index < first.titles.size(); index++) {
+        EXPECT_EQ(first.titles[index].titleId, second.titles[index].titleId);
+        EXPECT_STREQ(first.titles[index].name, second.titles[index].name);
+    }
+    EXPECT_EQ(first.presetJson, second.presetJson);
+    EXPECT_EQ(first.favorites, second.favorites);
+}
+
+TEST_F(ScalingTest, Fixture_IdsAreUnique) {
+    LibraryFixture::Library library = makeLibrary(LARGE_COUNT);
+
+    std::set<uint64_t> titleIds;
+    std::set<std::string> productCodes;
+    for (const Titles::TitleInfo& title : library.titles) {
+        titleIds.insert(title.titleId);
+        productCodes.insert(title.productCode);
+    }
+    EXPECT_EQ(titleIds.size(), library.titles.size());
+    EXPECT_EQ(productCodes.size(), library.titles.size());
+}
+
+TEST_F(ScalingTest, Fixture_HasCollationCases) {
+    LibraryFixture::Library library = makeLibrary(64);
+
+    int caseOnlyPairs = 0;
+    int longNames = 0;
+    int nonAscii = 0;
+    for (size_t index = 1; index < library.titles.size(); index++) {
+        const char* name = library.titles[index].name;
+        const char* previous = library.titles[index - 1].name;
+        if (strcmp(name, previous) != 0 && strcasecmp(name, previous) == 0) {
+            caseOnlyPairs++;
+        }
+        if (strlen(name) == Titles::MAX_NAME_LENGTH - 1) {
+            longNames++;
+        }
+        if (std::any_of(name, name + strlen(name), [](char c) { return (c & 0x80) != 0; })) {
+            nonAscii++;
+        }
+    }
+    EXPECT_GT(caseOnlyPairs, 0);
+    EXPECT_GT(longNames, 0);
+    EXPECT_GT(nonAscii, 0);
+}
+
+TEST_F(ScalingTest, Fixture_PresetsCoverTitles) {
+    LibraryFixture::Options options;
+    options.titleCount = 512;
+    options.presetCount = 2048;
+    LibraryFixture::Library library = LibraryFixture::Generate(options);
+    loadLibrary(library);
+
+    EXPECT_EQ(2048, TitlePresets::GetPresetCount());
+    for (const Titles::TitleInfo& title : library.titles) {
+        EXPECT_NE(nullptr, TitlePresets::GetPresetByGameId(title.productCode)) << title.productCode;
+    }
+}
+
+TEST_F(ScalingTest, Fixture_SettingsMatchLibrary) {
+    LibraryFixture::Library library = makeLibrary(512);
+    loadLibrary(library);
+
+    EXPECT_EQ(library.favorites.size(), Settings::Get().favorites.size());
+    EXPECT_EQ(library.assignments.size(), Settings::Get().titleCategories.size());
+    EXPECT_EQ(static_cast<int>(library.categoryNames.size()), Settings::GetCategoryCount());
+}
+
+// =============================================================================
+// Scaling Tests
+// =============================================================================
+
+TEST_F(ScalingTest, TitleSort_OrdersCollationCases) {
+    LibraryFixture::Library library = makeLibrary(LARGE_COUNT);
+    std::vector<uint16_t> order = sortLibrary(library);
+
+    // Case-insensitive, byte-wise past the key, duplicates in record order
+    int sharedKeyPairs = 0;
+    for (size_t position = 1; position < order.size(); position++) {
+        uint16_t previous = order[position - 1];
+        uint16_t current = order[position];
+        const char* previousName = library.titles[previous].name;
+        const char* currentName = library.titles[current].name;
+        int comparison = strcasecmp(previousName, currentName);
+        EXPECT_LE(comparison, 0) << previousName << " / " << currentName;
+        if (comparison == 0) {
+            EXPECT_LT(previous, current) << currentName;
+        }
+        if (TitleCollation::ComputeKey(previousName) == TitleCollation::ComputeKey(currentName)) {
+            sharedKeyPairs++;
+        }
+    }
+    EXPECT_GT(sharedKeyPairs, 0);
+}
+
+TEST_F(ScalingTest, TitleSort_MockListMatchesRealSort) {
+    LibraryFixture::Library library = makeLibrary(SMALL_COUNT);
+    std::vector<uint16_t> order = sortLibrary(library);
+    MockTitles::SetTitles(library.titles);
+
+    ASSERT_EQ(static_cast<int>(order.size()), Titles::GetCount());
+    for (size_t position = 0; position < order.size(); position++) {
+        EXPECT_EQ(library.titles[order[position]].titleId, Titles::GetTitle(static_cast<int>(position))->titleId);
+    }
+}
+
+TEST_F(ScalingTest, TitleSort_ComparisonsScaleNLogN) {
+    TitleCollation::SortStats small;
+    sortLibrary(makeLibrary(SMALL_COUNT), &small);
+    TitleCollation::SortStats large;
+    sortLibrary(makeLibrary(LARGE_COUNT), &large);
+
+    ASSERT_GT(small.comparisons, 0);
+    EXPECT_LT(large.comparisons, small.comparisons * MAX_SORT_GROWTH);
+
+    // The keys settle most comparisons without touching the names
+    EXPECT_LT(large.nameComparisons * 2, large.comparisons);
+}
@@ -0,0 +1,105 @@
+/**
+ * Unit tests for src/menu/search_index.cpp
+ *
+ * Tests name normalization, indexed and short queries, and narrowing.
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "menu/search_index.h"
+
+class SearchIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        static const char* const names[] = {
+            "Super Mario 3D World",
+            "Mario Kart 8",
+            "The Legend of Zelda: Breath of the Wild",
+            "Splatoon",
+            "Bayonetta 2",
+            nullptr,
+        };
+        SearchIndex::Build(names, 6);
+    }
+
+    void TearDown() override {
+        SearchIndex::Clear();
+    }
+
+    static std::vector<uint16_t> query(const char* text) {
+        return SearchIndex::Query(text);
+    }
+};
+
+// =============================================================================
+// Normalize Tests
+// =============================================================================
+
+TEST_F(SearchIndexTest, Normalize_LowercasesAndCollapsesSeparators) {
+    char output[64];
+    int length = SearchIndex::Normalize("  Zelda:  Breath--of ", output, sizeof(output));
+    EXPECT_STREQ(output, "zelda breath of");
+    EXPECT_EQ(length, 15);
+}
+
+TEST_F(SearchIndexTest, Normalize_TruncatesToBuffer) {
+    char output[6];
+    SearchIndex::Normalize("Splatoon", output, sizeof(output));
+    EXPECT_STREQ(output, "splat");
+}
+
+// =============================================================================
+// Query Tests
+// =============================================================================
+
+TEST_F(SearchIndexTest, Build_CountsEveryName) {
+    EXPECT_EQ(SearchIndex::GetCount(), 6);
+}
+
+TEST_F(SearchIndexTest, Query_EmptyMatchesEverything) {
+    EXPECT_EQ(query("").size(), 6u);
+}
+
+TEST_F(SearchIndexTest, Query_IndexedIsCaseInsensitive) {
+    std::vector<uint16_t> expected = { 0, 1 };
+    EXPECT_EQ(query("MARIO"), expected);
+}
+
+TEST_F(SearchIndexTest, Query_ShortQueryScansNames) {
+    EXPECT_EQ(query("t"), std::vector<uint16_t>({ 1, 2, 3, 4 }));
+    EXPECT_EQ(query("2"), std::vector<uint16_t>({ 4 }));
+}
+
+TEST_F(SearchIndexTest, Query_PunctuationMatchesAsSpace) {
+    EXPECT_EQ(query("zelda breath"), std::vector<uint16_t>({ 2 }));
+    EXPECT_EQ(query("zelda: breath"), std::vector<uint16_t>({ 2 }));
+}
+
+TEST_F(SearchIndexTest, Query_NoMatchReturnsEmpty) {
+    EXPECT_TRUE(query("metroid").empty());
+}
+
+// =============================================================================
+// Incremental Narrowing Tests
+// =============================================================================
+
+TEST_F(SearchIndexTest, Query_ExtendingNarrowsPreviousMatches) {
+    EXPECT_EQ(query("m").size(), 2u);
+    EXPECT_EQ(query("ma").size(), 2u);
+    EXPECT_EQ(query("mar").size(), 2u);
+    EXPECT_EQ(query("mario k"), std::vector<uint16_t>({ 1 }));
+}
+
+TEST_F(SearchIndexTest, Query_BackspaceWidensAgain) {
+    EXPECT_EQ(query("mario k").size(), 1u);
+    EXPECT_EQ(query("mario").size(), 2u);
+}
+
+TEST_F(SearchIndexTest, Build_ForgetsPreviousQuery) {
+    EXPECT_EQ(query("spla").size(), 1u);
+
+    static const char* const names[] = { "Splatoon", "Splatoon 2" };
+    SearchIndex::Build(names, 2);
+    EXPECT_EQ(query("splat").size(), 2u);
+}
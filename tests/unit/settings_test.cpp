@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include <cstring>
 #include "storage/settings.h"
+#include "wups/storage.h"
 
 class SettingsTest : public ::testing::Test {
 protected:
@@ -95,6 +96,45 @@ TEST_F(SettingsTest, AddFavorite_RespectsMaxLimit) {
     EXPECT_LE(Settings::Get().favorites.size(), static_cast<size_t>(Settings::MAX_FAVORITES));
 }
 
+TEST_F(SettingsTest, RemoveFavorite_KeepsListInSyncWithLookups) {
+    // Remove from the middle, front and back of a full list
+    for (int i = 0; i < Settings::MAX_FAVORITES; i++) {
+        Settings::AddFavorite(0x0005000010000000 + i * 0x100);
+    }
+    Settings::RemoveFavorite(0x0005000010000000 + 10 * 0x100);
+    Settings::RemoveFavorite(0x0005000010000000);
+    Settings::RemoveFavorite(0x0005000010000000 + (Settings::MAX_FAVORITES - 1) * 0x100);
+
+    const std::vector<uint64_t>& favorites = Settings::Get().favorites;
+    EXPECT_EQ(favorites.size(), static_cast<size_t>(Settings::MAX_FAVORITES - 3));
+    for (uint64_t titleId : favorites) {
+        EXPECT_TRUE(Settings::IsFavorite(titleId));
+    }
+    for (int i = 0; i < Settings::MAX_FAVORITES; i++) {
+        uint64_t titleId = 0x0005000010000000 + i * 0x100;
+        bool isRemoved = (i == 0 || i == 10 || i == Settings::MAX_FAVORITES - 1);
+        EXPECT_EQ(Settings::IsFavorite(titleId), !isRemoved);
+    }
+}
+
+TEST_F(SettingsTest, AddFavorite_AfterRemovalAtLimit) {
+    for (int i = 0; i < Settings::MAX_FAVORITES; i++) {
+        Settings::AddFavorite(0x0005000010000000 + i);
+    }
+    Settings::RemoveFavorite(0x0005000010000005);
+    Settings::AddFavorite(0x0005000020000000);
+
+    EXPECT_TRUE(Settings::IsFavorite(0x0005000020000000));
+    EXPECT_FALSE(Settings::IsFavorite(0x0005000010000005));
+    EXPECT_EQ(Settings::Get().favorites.size(), static_cast<size_t>(Settings::MAX_FAVORITES));
+}
+
+TEST_F(SettingsTest, ResetToDefaults_ClearsFavoriteLookups) {
+    Settings::AddFavorite(0x0005000010145D00);
+    Settings::ResetToDefaults();
+    EXPECT_FALSE(Settings::IsFavorite(0x0005000010145D00));
+}
+
 // =============================================================================
 // Category Creation Tests
 // =============================================================================
@@ -282,6 +322,61 @@ TEST_F(SettingsTest, GetCategoriesForTitle_UnassignedReturnsZero) {
     EXPECT_EQ(count, 0);
 }
 
+TEST_F(SettingsTest, GetCategoriesForTitle_KeepsAssignmentOrder) {
+    uint16_t cat1 = Settings::CreateCategory("Action");
+    uint16_t cat2 = Settings::CreateCategory("RPG");
+    uint16_t cat3 = Settings::CreateCategory("Puzzle");
+    uint64_t titleId = 0x0005000010145D00;
+
+    Settings::AssignTitleToCategory(titleId, cat2);
+    Settings::AssignTitleToCategory(titleId, cat3);
+    Settings::AssignTitleToCategory(titleId, cat1);
+
+    uint16_t outIds[16];
+    ASSERT_EQ(Settings::GetCategoriesForTitle(titleId, outIds, 16), 3);
+    EXPECT_EQ(outIds[0], cat2);
+    EXPECT_EQ(outIds[1], cat3);
+    EXPECT_EQ(outIds[2], cat1);
+}
+
+TEST_F(SettingsTest, DeleteCategory_KeepsOtherTitlesAssignments) {
+    uint16_t deletedCat = Settings::CreateCategory("Old");
+    uint16_t keptCat = Settings::CreateCategory("Kept");
+
+    for (int i = 0; i < 20; i++) {
+        uint64_t titleId = 0x0005000010000000 + i * 0x100;
+        Settings::AssignTitleToCategory(titleId, (i % 2) ? deletedCat : keptCat);
+        if (i % 3 == 0) {
+            Settings::AssignTitleToCategory(titleId, (i % 2) ? keptCat : deletedCat);
+        }
+    }
+    Settings::DeleteCategory(deletedCat);
+
+    for (int i = 0; i < 20; i++) {
+        uint64_t titleId = 0x0005000010000000 + i * 0x100;
+        bool hasKept = (i % 2 == 0) || (i % 3 == 0);
+        EXPECT_FALSE(Settings::TitleHasCategory(titleId, deletedCat));
+        EXPECT_EQ(Settings::TitleHasCategory(titleId, keptCat), hasKept);
+    }
+    for (const auto& tc : Settings::Get().titleCategories) {
+        EXPECT_EQ(tc.categoryId, keptCat);
+    }
+}
+
+TEST_F(SettingsTest, AssignTitleToCategory_RespectsMaxLimit) {
+    uint16_t catId = Settings::CreateCategory("Many");
+    for (int i = 0; i < Settings::MAX_TITLE_CATEGORIES + 10; i++) {
+        Settings::AssignTitleToCategory(0x0005000010000000 + i, catId);
+    }
+    EXPECT_EQ(Settings::Get().titleCategories.size(),
+              static_cast<size_t>(Settings::MAX_TITLE_CATEGORIES));
+
+    Settings::RemoveTitleFromCategory(0x0005000010000000, catId);
+    Settings::AssignTitleToCategory(0x0005000020000000, catId);
+    EXPECT_TRUE(Settings::TitleHasCategory(0x0005000020000000, catId));
+    EXPECT_TRUE(Settings::TitleHasCategory(0x0005000010000001, catId));
+}
+
 // =============================================================================
 // Category Ordering Tests
 // =============================================================================
@@ -379,6 +474,112 @@ TEST_F(SettingsTest, GetSortedCategoryIndices_IncludesHiddenWhenRequested) {
     EXPECT_EQ(count, 3);
 }
 
+TEST_F(SettingsTest, GetCategoryOrder_FollowsEdits) {
+    uint16_t firstId = Settings::CreateCategory("First");
+    uint16_t secondId = Settings::CreateCategory("Second");
+
+    int count = 0;
+    const int* order = Settings::GetCategoryOrder(false, &count);
+    ASSERT_EQ(count, 2);
+
+    Settings::SetCategoryHidden(firstId, true);
+    order = Settings::GetCategoryOrder(false, &count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(Settings::Get().categories[order[0]].id, secondId);
+
+    Settings::MoveCategoryUp(secondId);
+    order = Settings::GetCategoryOrder(false, &count);
+    ASSERT_EQ(count, 1);
+    EXPECT_EQ(order[0], 0);
+
+    Settings::DeleteCategory(secondId);
+    Settings::GetCategoryOrder(false, &count);
+    EXPECT_EQ(count, 0);
+    Settings::GetCategoryOrder(true, &count);
+    EXPECT_EQ(count, 1);
+}
+
+// =============================================================================
+// Launch History Tests
+// =============================================================================
+
+TEST_F(SettingsTest, RecordLaunch_MostRecentHasRankZero) {
+    Settings::RecordLaunch(0x0005000010145D00);
+    Settings::RecordLaunch(0x000500001010EC00);
+    EXPECT_EQ(Settings::GetLaunchRank(0x000500001010EC00), 0);
+    EXPECT_EQ(Settings::GetLaunchRank(0x0005000010145D00), 1);
+}
+
+TEST_F(SettingsTest, RecordLaunch_RelaunchMovesToFront) {
+    Settings::RecordLaunch(0x0005000010145D00);
+    Settings::RecordLaunch(0x000500001010EC00);
+    Settings::RecordLaunch(0x0005000010145D00);
+    EXPECT_EQ(Settings::GetLaunchRank(0x0005000010145D00), 0);
+    EXPECT_EQ(Settings::Get().recentLaunches.size(), 2u);
+}
+
+TEST_F(SettingsTest, RecordLaunch_RespectsMaxLimit) {
+    for (int i = 0; i < Settings::MAX_RECENT_LAUNCHES + 5; i++) {
+        Settings::RecordLaunch(0x0005000010000000 + i);
+    }
+    EXPECT_EQ(static_cast<int>(Settings::Get().recentLaunches.size()), Settings::MAX_RECENT_LAUNCHES);
+    EXPECT_EQ(Settings::GetLaunchRank(0x0005000010000000), -1);
+}
+
+TEST_F(SettingsTest, GetLaunchRank_NeverLaunched_ReturnsMinusOne) {
+    EXPECT_EQ(Settings::GetLaunchRank(0x0005000010145D00), -1);
+}
+
+// =============================================================================
+// Membership Generation Tests
+// =============================================================================
+
+TEST_F(SettingsTest, MembershipGeneration_ChangesOnFavoriteToggle) {
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::ToggleFavorite(0x0005000010145D00);
+    EXPECT_NE(Settings::GetMembershipGeneration(), before);
+}
+
+TEST_F(SettingsTest, MembershipGeneration_ChangesOnLaunch) {
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::RecordLaunch(0x0005000010145D00);
+    EXPECT_NE(Settings::GetMembershipGeneration(), before);
+}
+
+TEST_F(SettingsTest, MembershipGeneration_ChangesOnAssignAndRemove) {
+    uint16_t catId = Settings::CreateCategory("RPG");
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::AssignTitleToCategory(0x0005000010145D00, catId);
+    uint32_t afterAssign = Settings::GetMembershipGeneration();
+    EXPECT_NE(afterAssign, before);
+
+    Settings::RemoveTitleFromCategory(0x0005000010145D00, catId);
+    EXPECT_NE(Settings::GetMembershipGeneration(), afterAssign);
+}
+
+TEST_F(SettingsTest, MembershipGeneration_ChangesOnDeleteCategory) {
+    uint16_t catId = Settings::CreateCategory("RPG");
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::DeleteCategory(catId);
+    EXPECT_NE(Settings::GetMembershipGeneration(), before);
+}
+
+TEST_F(SettingsTest, MembershipGeneration_ChangesOnRenameCategory) {
+    uint16_t catId = Settings::CreateCategory("RPG");
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::RenameCategory(catId, "Role-playing");
+    EXPECT_NE(Settings::GetMembershipGeneration(), before);
+}
+
+TEST_F(SettingsTest, MembershipGeneration_UnchangedByNoOps) {
+    Settings::AddFavorite(0x0005000010145D00);
+    uint32_t before = Settings::GetMembershipGeneration();
+    Settings::AddFavorite(0x0005000010145D00);
+    Settings::RemoveFavorite(0x000500001010EC00);
+    Settings::RenameCategory(999, "Missing");
+    EXPECT_EQ(Settings::GetMembershipGeneration(), before);
+}
+
 // =============================================================================
 // Reset Tests
 // =============================================================================
@@ -416,3 +617,278 @@ TEST_F(SettingsTest, Get_ModificationsArePersistent) {
     Settings::Get().showNumbers = false;
     EXPECT_FALSE(Settings::Get().showNumbers);
 }
+
+// =============================================================================
+// Persistence Tests
+// =============================================================================
+
+TEST_F(SettingsTest, SaveLoad_RoundTripsSettings) {
+    MockStorage::Reset();
+    uint16_t catId = Settings::CreateCategory("Action");
+    Settings::AddFavorite(0x0005000010145D00);
+    Settings::AssignTitleToCategory(0x000500001010EC00, catId);
+    Settings::Get().lastIndex = 7;
+    Settings::Save();
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 7);
+    EXPECT_TRUE(Settings::IsFavorite(0x0005000010145D00));
+    EXPECT_TRUE(Settings::TitleHasCategory(0x000500001010EC00, catId));
+}
+
+TEST_F(SettingsTest, SaveLoad_RoundTripsIconCacheBudget) {
+    MockStorage::Reset();
+    EXPECT_EQ(Settings::Get().iconCacheKB, Settings::DEFAULT_ICON_CACHE_KB);
+    Settings::Get().iconCacheKB = Settings::MAX_ICON_CACHE_KB;
+    Settings::Save();
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().iconCacheKB, Settings::MAX_ICON_CACHE_KB);
+}
+
+TEST_F(SettingsTest, SaveLoad_RoundTripsIconGrid) {
+    MockStorage::Reset();
+    EXPECT_FALSE(Settings::Get().showIconGrid);
+    Settings::Get().showIconGrid = true;
+    Settings::Save();
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_TRUE(Settings::Get().showIconGrid);
+}
+
+TEST_F(SettingsTest, SaveLoad_RoundTripsTVRefresh) {
+    MockStorage::Reset();
+    EXPECT_EQ(Settings::Get().tvRefresh, 1);
+    Settings::Get().tvRefresh = Settings::TV_REFRESH_ON_CHANGE;
+    Settings::Save();
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().tvRefresh, Settings::TV_REFRESH_ON_CHANGE);
+}
+
+TEST_F(SettingsTest, Save_FirstSaveWritesVersionAndRecord) {
+    MockStorage::Reset();
+    Settings::Save();
+    EXPECT_EQ(MockStorage::storeCount, 2);
+    EXPECT_EQ(MockStorage::intStore["configVersion"], Settings::CONFIG_VERSION);
+    EXPECT_EQ(MockStorage::binaryStore.count("settingsData"), 1u);
+    EXPECT_EQ(MockStorage::flushCount, 1);
+}
+
+TEST_F(SettingsTest, Save_UnchangedSkipsFlush) {
+    MockStorage::Reset();
+    Settings::Save();
+    int storesAfterFirstSave = MockStorage::storeCount;
+
+    Settings::Save();
+    EXPECT_EQ(MockStorage::storeCount, storesAfterFirstSave);
+    EXPECT_EQ(MockStorage::flushCount, 1);
+}
+
+TEST_F(SettingsTest, Save_ChangeRewritesOnlyRecord) {
+    MockStorage::Reset();
+    Settings::Save();
+    int storesAfterFirstSave = MockStorage::storeCount;
+
+    Settings::Get().lastIndex = 12;
+    Settings::Save();
+    EXPECT_EQ(MockStorage::storeCount, storesAfterFirstSave + 1);
+    EXPECT_EQ(MockStorage::flushCount, 2);
+}
+
+TEST_F(SettingsTest, Save_AfterLoadWritesOnlyRecord) {
+    MockStorage::Reset();
+    Settings::Save();
+    Settings::Init();
+    Settings::Load();
+    int storesAfterLoad = MockStorage::storeCount;
+
+    Settings::Save();
+    EXPECT_EQ(MockStorage::storeCount, storesAfterLoad);
+
+    Settings::AddFavorite(0x0005000010145D00);
+    Settings::Save();
+    EXPECT_EQ(MockStorage::storeCount, storesAfterLoad + 1);
+}
+
+TEST_F(SettingsTest, Save_ManyFavoritesStayCompact) {
+    MockStorage::Reset();
+    for (int i = 0; i < Settings::MAX_FAVORITES; i++) {
+        Settings::AddFavorite(0x0005000010100000 + i * 0x100);
+    }
+    Settings::Save();
+
+    // Two bytes per favorite instead of eight
+    size_t recordSize = MockStorage::binaryStore["settingsData"].size();
+    EXPECT_LT(recordSize, Settings::MAX_FAVORITES * 3u);
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().favorites.size(), static_cast<size_t>(Settings::MAX_FAVORITES));
+    EXPECT_TRUE(Settings::IsFavorite(0x0005000010100000));
+    EXPECT_TRUE(Settings::IsFavorite(0x0005000010100000 + (Settings::MAX_FAVORITES - 1) * 0x100));
+}
+
+TEST_F(SettingsTest, SaveLoad_RoundTripsAssignmentsAcrossHighWords) {
+    MockStorage::Reset();
+    uint16_t firstCatId = Settings::CreateCategory("First");
+    uint16_t secondCatId = Settings::CreateCategory("Second");
+    Settings::AssignTitleToCategory(0x0005000010145D00, firstCatId);
+    Settings::AssignTitleToCategory(0x0005000010145D00, secondCatId);
+    Settings::AssignTitleToCategory(0x0005000E10145D00, secondCatId);
+    Settings::AssignTitleToCategory(0x000500001010EC00, firstCatId);
+    Settings::Save();
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().titleCategories.size(), 4u);
+    EXPECT_TRUE(Settings::TitleHasCategory(0x0005000010145D00, firstCatId));
+    EXPECT_TRUE(Settings::TitleHasCategory(0x0005000010145D00, secondCatId));
+    EXPECT_TRUE(Settings::TitleHasCategory(0x0005000E10145D00, secondCatId));
+    EXPECT_FALSE(Settings::TitleHasCategory(0x0005000E10145D00, firstCatId));
+    EXPECT_TRUE(Settings::TitleHasCategory(0x000500001010EC00, firstCatId));
+}
+
+TEST_F(SettingsTest, Load_MigratesVersion2Keys) {
+    MockStorage::Reset();
+    uint64_t favorite = 0x0005000010145D00;
+    MockStorage::intStore["configVersion"] = 2;
+    MockStorage::intStore["lastIndex"] = 5;
+    MockStorage::intStore["favoritesCount"] = 1;
+    MockStorage::binaryStore["favoritesData"] = std::vector<uint8_t>(
+        reinterpret_cast<uint8_t*>(&favorite), reinterpret_cast<uint8_t*>(&favorite) + sizeof(favorite));
+
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 5);
+    EXPECT_TRUE(Settings::IsFavorite(favorite));
+
+    // The first save rewrites everything as one packed record
+    Settings::Save();
+    EXPECT_EQ(MockStorage::intStore["configVersion"], Settings::CONFIG_VERSION);
+    EXPECT_EQ(MockStorage::binaryStore.count("settingsData"), 1u);
+
+    Settings::Init();
+    MockStorage::binaryStore.erase("favoritesData");
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 5);
+    EXPECT_TRUE(Settings::IsFavorite(favorite));
+}
+
+namespace {
+
+template <typename T>
+void appendBytes(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+}
+
+TEST_F(SettingsTest, Load_MigratesVersion3Record) {
+    MockStorage::Reset();
+    Settings::PluginSettings defaults;
+    uint64_t favorite = 0x000500001010EC00;
+    Settings::Category category = {};
+    category.id = 1;
+    strcpy(category.name, "Old");
+    Settings::TitleCategoryAssignment assignment = {};
+    assignment.titleId = 0x0005000010145D00;
+    assignment.categoryId = 1;
+
+    // v3 scalars end by counting all four arrays, which follow raw
+    std::vector<uint8_t> payload;
+    appendBytes(payload, int32_t{7});
+    appendBytes(payload, defaults.lastCategoryIndex);
+    appendBytes(payload, defaults.sortOrder);
+    appendBytes(payload, defaults.bgColor);
+    appendBytes(payload, defaults.titleColor);
+    appendBytes(payload, defaults.highlightedTitleColor);
+    appendBytes(payload, defaults.favoriteColor);
+    appendBytes(payload, defaults.headerColor);
+    appendBytes(payload, defaults.categoryColor);
+    appendBytes(payload, int32_t{defaults.layoutPrefs.fontScale});
+    appendBytes(payload, int32_t{defaults.layoutPrefs.listWidthPercent});
+    appendBytes(payload, int32_t{defaults.layoutPrefs.iconSizePercent});
+    appendBytes(payload, uint16_t{2});
+    appendBytes(payload, uint8_t{0});
+    appendBytes(payload, uint8_t{1});
+    for (uint16_t count : {1, 1, 1, 0}) {
+        appendBytes(payload, count);
+    }
+    appendBytes(payload, favorite);
+    appendBytes(payload, category);
+    appendBytes(payload, assignment);
+
+    uint32_t checksum = 2166136261u;
+    for (uint8_t byte : payload) {
+        checksum = (checksum ^ byte) * 16777619u;
+    }
+    std::vector<uint8_t> record;
+    appendBytes(record, uint32_t{0x54534346});
+    appendBytes(record, uint32_t{3});
+    appendBytes(record, static_cast<uint32_t>(payload.size()));
+    appendBytes(record, checksum);
+    record.insert(record.end(), payload.begin(), payload.end());
+    MockStorage::intStore["configVersion"] = 3;
+    MockStorage::binaryStore["settingsData"] = record;
+
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 7);
+    EXPECT_TRUE(Settings::IsFavorite(favorite));
+    ASSERT_EQ(Settings::GetCategoryCount(), 1);
+    EXPECT_TRUE(Settings::TitleHasCategory(assignment.titleId, 1));
+
+    // The next save rewrites it in the current layout
+    Settings::Save();
+    EXPECT_EQ(MockStorage::intStore["configVersion"], Settings::CONFIG_VERSION);
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 7);
+    EXPECT_TRUE(Settings::IsFavorite(favorite));
+    EXPECT_TRUE(Settings::TitleHasCategory(assignment.titleId, 1));
+}
+
+TEST_F(SettingsTest, Load_MovesUserCategoryPastRecent) {
+    MockStorage::Reset();
+    MockStorage::intStore["configVersion"] = 2;
+    MockStorage::intStore["lastCategory"] = 2;
+
+    // Saved when user categories started at index 2
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastCategoryIndex, 3);
+
+    Settings::Save();
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastCategoryIndex, 3);
+}
+
+TEST_F(SettingsTest, Load_RejectsCorruptRecord) {
+    MockStorage::Reset();
+    Settings::Get().lastIndex = 9;
+    Settings::Save();
+
+    std::vector<uint8_t>& record = MockStorage::binaryStore["settingsData"];
+    record.back() ^= 0xFF;
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_EQ(Settings::Get().lastIndex, 0);
+}
+
+TEST_F(SettingsTest, Load_RejectsTruncatedRecord) {
+    MockStorage::Reset();
+    Settings::AddFavorite(0x0005000010145D00);
+    Settings::Save();
+
+    std::vector<uint8_t>& record = MockStorage::binaryStore["settingsData"];
+    record.resize(record.size() - sizeof(uint64_t));
+
+    Settings::Init();
+    Settings::Load();
+    EXPECT_FALSE(Settings::IsFavorite(0x0005000010145D00));
+}
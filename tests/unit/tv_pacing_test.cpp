@@ -0,0 +1,107 @@
+/**
+ * Unit tests for src/render/tv_pacing.cpp
+ *
+ * Tests which frames each TVPacing draws the TV on, given whether the TV
+ * is behind and whether the DRC changes that frame. The OSScreen backend,
+ * the mock renderer and the web preview all pace the TV with TVPacer.
+ */
+
+#include <gtest/gtest.h>
+#include "render/tv_pacing.h"
+
+using Renderer::TVPacer;
+using Renderer::TVPacing;
+
+namespace {
+
+// Frames until the TV is drawn while it stays behind, 0 if it never is
+int framesUntilTVFrame(TVPacer& pacer, bool isDRCChanging, int maxFrames = 100) {
+    for (int frame = 1; frame <= maxFrames; frame++) {
+        if (pacer.BeginFrame(true, isDRCChanging)) {
+            return frame;
+        }
+    }
+    return 0;
+}
+
+}
+
+TEST(TVPacingTest, EveryFrame_DrawsWheneverBehind) {
+    TVPacer pacer;
+    EXPECT_EQ(TVPacing::EVERY_FRAME, pacer.GetPacing());
+    for (int frame = 0; frame < 5; frame++) {
+        EXPECT_TRUE(pacer.BeginFrame(true, true));
+    }
+}
+
+TEST(TVPacingTest, NotBehind_NeverDraws) {
+    TVPacer pacer;
+    EXPECT_FALSE(pacer.BeginFrame(false, false));
+
+    pacer.Set(TVPacing::ON_CHANGE, 2);
+    for (int frame = 0; frame < Renderer::TV_ON_CHANGE_MAX_FRAMES * 2; frame++) {
+        EXPECT_FALSE(pacer.BeginFrame(false, false));
+    }
+}
+
+TEST(TVPacingTest, Divided_DrawsEveryNthFrame) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::DIVIDED, 3);
+    EXPECT_EQ(3, framesUntilTVFrame(pacer, true));
+    EXPECT_EQ(3, framesUntilTVFrame(pacer, true));
+    EXPECT_EQ(3, framesUntilTVFrame(pacer, false));
+}
+
+TEST(TVPacingTest, Divided_SkippedFramesWhileUpToDateCount) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::DIVIDED, 4);
+    EXPECT_EQ(4, framesUntilTVFrame(pacer, true));
+
+    // Nothing to show for a while, then a change shows at once
+    for (int frame = 0; frame < 3; frame++) {
+        EXPECT_FALSE(pacer.BeginFrame(false, false));
+    }
+    EXPECT_TRUE(pacer.BeginFrame(true, true));
+}
+
+TEST(TVPacingTest, Divided_ClampsTheDivisor) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::DIVIDED, 0);
+    EXPECT_EQ(1, framesUntilTVFrame(pacer, true));
+    EXPECT_EQ(1, framesUntilTVFrame(pacer, true));
+
+    pacer.Set(TVPacing::DIVIDED, 1000);
+    EXPECT_EQ(Renderer::TV_ON_CHANGE_MAX_FRAMES, framesUntilTVFrame(pacer, true));
+}
+
+TEST(TVPacingTest, OnChange_WaitsForTheDRCToSettle) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::ON_CHANGE, 2);
+    EXPECT_FALSE(pacer.BeginFrame(true, true));
+    EXPECT_FALSE(pacer.BeginFrame(true, true));
+    EXPECT_TRUE(pacer.BeginFrame(true, false));
+}
+
+TEST(TVPacingTest, OnChange_DrawsAtLeastEveryMaxFrames) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::ON_CHANGE, 2);
+    EXPECT_EQ(Renderer::TV_ON_CHANGE_MAX_FRAMES, framesUntilTVFrame(pacer, true));
+    EXPECT_EQ(Renderer::TV_ON_CHANGE_MAX_FRAMES, framesUntilTVFrame(pacer, true));
+}
+
+TEST(TVPacingTest, Off_NeverDraws) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::OFF, 2);
+    EXPECT_EQ(0, framesUntilTVFrame(pacer, false));
+    EXPECT_EQ(TVPacing::OFF, pacer.GetPacing());
+}
+
+TEST(TVPacingTest, Reset_DrawsEveryFrameAgain) {
+    TVPacer pacer;
+    pacer.Set(TVPacing::OFF, 2);
+    EXPECT_FALSE(pacer.BeginFrame(true, false));
+
+    pacer.Reset();
+    EXPECT_EQ(TVPacing::EVERY_FRAME, pacer.GetPacing());
+    EXPECT_TRUE(pacer.BeginFrame(true, true));
+}
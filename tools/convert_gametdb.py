@@ -10,16 +10,38 @@ Usage:
 
 Download wiiutdb.xml from: https://www.gametdb.com/wiiutdb.zip
 
-The output JSON can be placed at:
-    sd:/wiiu/plugins/config/TitleSwitcher_presets.json
+Alongside the JSON it writes TitleSwitcher_presets.bin, a precompiled copy
+the plugin loads without parsing (see BINARY FORMAT in
+src/presets/title_presets.h). An existing presets JSON can also be given as
+the input to produce just the binary file.
+
+Both files can be placed at:
+    sd:/wiiu/environments/aroma/plugins/config/
 """
 
 import argparse
 import json
+import os
+import struct
 import sys
 import xml.etree.ElementTree as ET
 from typing import Optional
 
+# Must match src/presets/title_presets.h
+PRESET_BINARY_MAGIC = 0x54535052  # 'TSPR'
+PRESET_BINARY_VERSION = 1
+MAX_PRESETS = 2048
+FIELD_LIMITS = {
+    'id': 16,
+    'name': 128,
+    'publisher': 64,
+    'developer': 64,
+    'region': 16,
+    'genre': 32,
+}
+RECORD_FORMAT = '>6IHBB'
+HEADER_FORMAT = '>5I'
+
 
 def get_region_from_id(game_id: str) -> str:
     """
@@ -100,7 +122,79 @@ def get_genre(game_elem) -> str:
     return ''
 
 
+def split_date(date: str):
+    """Split YYYY[-MM[-DD]] into (year, month, day), like ParseDate()."""
+    parts = date.split('-')
+    try:
+        year = int(parts[0]) if len(parts[0]) >= 4 else 0
+        month = int(parts[1]) if len(parts) > 1 else 0
+        day = int(parts[2]) if len(parts) > 2 else 0
+    except ValueError:
+        return 0, 0, 0
+    return year, month, day
+
+
+def truncate_utf8(text: str, limit: int) -> bytes:
+    """Encode text, cut to fit a limit-byte C buffer (with its NUL)."""
+    encoded = text.encode('utf-8')[:limit - 1]
+    return encoded.decode('utf-8', errors='ignore').encode('utf-8')
+
+
+def write_binary(titles: list, output_file: str) -> None:
+    """
+    Write the precompiled presets file: a header, one fixed-size record per
+    title, then a pool of NUL-terminated strings shared between records.
+    Big-endian, matching the Wii U.
+    """
+    titles = titles[:MAX_PRESETS]
+    pool = bytearray(b'\0')  # Offset 0 is the empty string
+    pool_offsets = {b'': 0}
+
+    def add_string(entry: dict, key: str) -> int:
+        value = truncate_utf8(entry.get(key, ''), FIELD_LIMITS[key])
+        if value not in pool_offsets:
+            pool_offsets[value] = len(pool)
+            pool.extend(value + b'\0')
+        return pool_offsets[value]
+
+    records = bytearray()
+    for entry in titles:
+        year, month, day = split_date(entry.get('releaseDate', ''))
+        records += struct.pack(RECORD_FORMAT,
+                               add_string(entry, 'id'),
+                               add_string(entry, 'name'),
+                               add_string(entry, 'publisher'),
+                               add_string(entry, 'developer'),
+                               add_string(entry, 'region'),
+                               add_string(entry, 'genre'),
+                               year & 0xFFFF, month & 0xFF, day & 0xFF)
+
+    header = struct.pack(HEADER_FORMAT, PRESET_BINARY_MAGIC, PRESET_BINARY_VERSION,
+                         struct.calcsize(RECORD_FORMAT), len(titles), len(pool))
+
+    print(f"Writing {len(titles)} titles to {output_file}...")
+    with open(output_file, 'wb') as f:
+        f.write(header)
+        f.write(records)
+        f.write(pool)
+
+
+def convert_json(input_file: str, binary_file: str) -> int:
+    """Write the binary form of an existing presets JSON file."""
+    try:
+        with open(input_file, encoding='utf-8') as f:
+            titles = json.load(f).get('titles', [])
+    except (OSError, ValueError) as e:
+        print(f"Error reading {input_file}: {e}", file=sys.stderr)
+        return 0
+
+    titles = [t for t in titles if t.get('id')]
+    write_binary(titles, binary_file)
+    return len(titles)
+
+
 def convert_gametdb(input_file: str, output_file: str,
+                    binary_file: Optional[str] = None,
                     include_all_regions: bool = True,
                     preferred_lang: str = 'EN') -> int:
     """
@@ -109,6 +203,7 @@ def convert_gametdb(input_file: str, output_file: str,
     Args:
         input_file: Path to wiiutdb.xml
         output_file: Path to output JSON file
+        binary_file: Path to output binary file, or None to skip it
         include_all_regions: If True, include all regional variants
         preferred_lang: Preferred language for titles (EN, JA, DE, FR, etc.)
 
@@ -195,6 +290,9 @@ def convert_gametdb(input_file: str, output_file: str,
     with open(output_file, 'w', encoding='utf-8') as f:
         json.dump(output, f, indent=2, ensure_ascii=False)
 
+    if binary_file:
+        write_binary(titles, binary_file)
+
     # Print statistics
     publishers = set(t.get('publisher', '') for t in titles if t.get('publisher'))
     developers = set(t.get('developer', '') for t in titles if t.get('developer'))
@@ -221,23 +319,37 @@ def main():
 Examples:
     %(prog)s wiiutdb.xml TitleSwitcher_presets.json
     %(prog)s --lang JA wiiutdb.xml presets_ja.json
+    %(prog)s TitleSwitcher_presets.json TitleSwitcher_presets.bin
 
 Download wiiutdb.xml from: https://www.gametdb.com/wiiutdb.zip
         '''
     )
 
-    parser.add_argument('input', help='Input wiiutdb.xml file')
-    parser.add_argument('output', help='Output JSON file')
+    parser.add_argument('input', help='Input wiiutdb.xml file, or a presets JSON file')
+    parser.add_argument('output', help='Output JSON file (binary file for JSON input)')
     parser.add_argument('--lang', default='EN',
                        help='Preferred language for titles (default: EN)')
+    parser.add_argument('--binary',
+                       help='Output binary file (default: output with a .bin extension)')
+    parser.add_argument('--no-binary', action='store_true',
+                       help='Only write the JSON file')
 
     args = parser.parse_args()
 
-    count = convert_gametdb(args.input, args.output, preferred_lang=args.lang)
+    if args.input.lower().endswith('.json'):
+        count = convert_json(args.input, args.output)
+        outputs = [args.output]
+    else:
+        binary_file = None
+        if not args.no_binary:
+            binary_file = args.binary or os.path.splitext(args.output)[0] + '.bin'
+        count = convert_gametdb(args.input, args.output, binary_file,
+                                preferred_lang=args.lang)
+        outputs = [args.output] + ([binary_file] if binary_file else [])
 
     if count > 0:
-        print(f"\nDone! Copy {args.output} to:")
-        print("  sd:/wiiu/plugins/config/TitleSwitcher_presets.json")
+        print(f"\nDone! Copy {', '.join(outputs)} to:")
+        print("  sd:/wiiu/environments/aroma/plugins/config/")
         return 0
     else:
         return 1
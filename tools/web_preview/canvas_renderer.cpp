@@ -6,7 +6,9 @@
  */
 
 #include "stubs/renderer_stub.h"
+#include "perf_hud.h"
 #include "render/bitmap_font.h"
+#include "render/draw_list.h"
 #include "common/screen_constants.h"
 
 #ifdef __EMSCRIPTEN__
@@ -18,6 +20,7 @@
 #include <cstdio>
 #include <cstdarg>
 #include <algorithm>
+#include <vector>
 
 namespace Renderer {
 
@@ -44,6 +47,22 @@ static uint32_t* sTvFramebuffer = nullptr;
 static bool sInitialized = false;
 static uint32_t sBgColor = 0x1E1E2EFF;
 
+// Draw calls of the current screen, drawn into its framebuffer when the
+// screen is switched or the frame ends
+static DrawList::List sFrameList;
+
+// This frame's counts so far, and the last finished frame's
+static FrameStats sFrameStats = {};
+static FrameStats sLastFrameStats = {};
+
+// Whether this frame draws the TV (ShouldDrawTV()); a TV frame left out
+// keeps its canvas as it is. Behind: the TV hasn't shown the DRC's last
+// change yet
+static bool sIsTvFrame = true;
+static bool sIsTvBehind = false;
+
+static void flushCommands();
+
 // =============================================================================
 // Helper Functions
 // =============================================================================
@@ -60,6 +79,15 @@ static uint32_t* getCurrentFramebuffer() {
     return (sCurrentScreen == ScreenTarget::DRC) ? sDrcFramebuffer : sTvFramebuffer;
 }
 
+// Pixels written to the current screen's framebuffer
+static void countPixels(uint64_t count) {
+    if (sCurrentScreen == ScreenTarget::DRC) {
+        sFrameStats.drcPixels += count;
+    } else {
+        sFrameStats.tvPixels += count;
+    }
+}
+
 static int getGridCols() {
     // Use fixed OSScreen grid dimensions to match real hardware
     return Screen::Grid::COLS;
@@ -87,6 +115,7 @@ static void setPixel(int x, int y, uint32_t color) {
     uint8_t a = color & 0xFF;
 
     fb[y * width + x] = (a << 24) | (b << 16) | (g << 8) | r;
+    countPixels(1);
 }
 
 /**
@@ -146,15 +175,136 @@ bool IsInitialized() {
     return sInitialized;
 }
 
+// The canvas has nothing to build ahead of the first frame
+bool Prewarm(uint32_t) { return true; }
+void ReleaseResources() {}
+
+bool ReserveStandby() { return false; }
+bool RelieveMemoryPressure() { return false; }
+
+bool IsOverlayAvailable() { return false; }
+void SetOverlayFrameCallback(void (*callback)()) { (void)callback; }
+
+// =============================================================================
+// Presentation
+// =============================================================================
+// Every frame is drawn in full, but most frames change a few rows: the
+// selection, the details panel. Each screen keeps a hash of every row as
+// last uploaded, and only the runs of rows whose hash changed are put on
+// the canvas, through an ImageData kept over the framebuffer in the WASM
+// heap rather than a new one copied into each frame.
+
+// Rows closer than this are uploaded as one run
+constexpr int UPLOAD_GAP_ROWS = 8;
+constexpr int MAX_UPLOAD_RUNS = 16;
+
+struct ScreenUpload {
+    std::vector<uint64_t> rowHashes;    // Empty: the canvas needs everything
+    int32_t runs[MAX_UPLOAD_RUNS * 2];  // First row and row count of each run
+};
+
+static ScreenUpload sDrcUpload;
+static ScreenUpload sTvUpload;
+
+static uint64_t hashRow(const uint32_t* row, int width) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int x = 0; x < width; x++) {
+        hash = (hash ^ row[x]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+/**
+ * Compare each row with its hash from the last upload and collect the
+ * changed rows as runs, joining runs a few rows apart and, past
+ * MAX_UPLOAD_RUNS, everything from the last run on.
+ *
+ * @return The number of runs in upload.runs
+ */
+static int findChangedRuns(ScreenUpload& upload, const uint32_t* framebuffer, int width, int height) {
+    bool isFresh = upload.rowHashes.size() != static_cast<size_t>(height);
+    if (isFresh) {
+        upload.rowHashes.assign(height, 0);
+    }
+
+    int runCount = 0;
+    for (int y = 0; y < height; y++) {
+        uint64_t hash = hashRow(framebuffer + y * width, width);
+        if (!isFresh && hash == upload.rowHashes[y]) {
+            continue;
+        }
+        upload.rowHashes[y] = hash;
+
+        int32_t* last = runCount > 0 ? &upload.runs[(runCount - 1) * 2] : nullptr;
+        if (last && (y - (last[0] + last[1]) < UPLOAD_GAP_ROWS || runCount == MAX_UPLOAD_RUNS)) {
+            last[1] = y + 1 - last[0];
+        } else {
+            upload.runs[runCount * 2] = y;
+            upload.runs[runCount * 2 + 1] = 1;
+            runCount++;
+        }
+    }
+    return runCount;
+}
+
+/**
+ * Put a screen's changed rows on its canvas. The ImageData is made again
+ * only when the size or framebuffer changes, or the heap grew (which
+ * detaches views of the old one).
+ */
+static void presentScreen(ScreenUpload& upload, const char* canvasId, const uint32_t* framebuffer,
+                          int width, int height) {
+    if (!framebuffer) return;
+
+    int runCount = findChangedRuns(upload, framebuffer, width, height);
+    for (int run = 0; run < runCount; run++) {
+        sFrameStats.uploadBytes += static_cast<uint64_t>(upload.runs[run * 2 + 1]) * width * sizeof(uint32_t);
+    }
+    if (runCount == 0) return;
+
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        const id = UTF8ToString($0);
+        const canvas = document.getElementById(id);
+        if (!canvas) {
+            return;
+        }
+
+        Module.screenImages = Module.screenImages || {};
+        let screen = Module.screenImages[id];
+        if (!screen || screen.width !== $2 || screen.height !== $3 || screen.pointer !== $1 ||
+            screen.pixels.buffer !== HEAPU8.buffer) {
+            const pixels = new Uint8ClampedArray(HEAPU8.buffer, $1, $2 * $3 * 4);
+            screen = { width: $2, height: $3, pointer: $1, pixels: pixels,
+                       image: new ImageData(pixels, $2, $3), context: canvas.getContext('2d') };
+            Module.screenImages[id] = screen;
+        }
+
+        for (let run = 0; run < $5; run++) {
+            const firstRow = HEAP32[($4 >> 2) + run * 2];
+            const rowCount = HEAP32[($4 >> 2) + run * 2 + 1];
+            screen.context.putImageData(screen.image, 0, 0, 0, firstRow, $2, rowCount);
+        }
+    }, canvasId, framebuffer, width, height, upload.runs, runCount);
+#else
+    (void)canvasId;
+#endif
+}
+
 // =============================================================================
 // Screen Selection
 // =============================================================================
 
 void SelectScreen(int screen) {
+    flushCommands();
     sCurrentScreen = (screen == 0) ? ScreenTarget::DRC : ScreenTarget::TV;
 }
 
 void SetTvResolution(int resolution) {
+    // Resizing the canvas clears it
+    sTvUpload.rowHashes.clear();
+    sIsTvBehind = true;
+
     switch (resolution) {
         case 1080:
             sTvWidth = 1920;
@@ -176,6 +326,8 @@ void SetTvResolution(int resolution) {
 // Frame Management
 // =============================================================================
 
+void WaitForVsync() {}
+
 void BeginFrame(uint32_t bgColor) {
     sBgColor = bgColor;
     int width = getCurrentWidth();
@@ -191,44 +343,86 @@ void BeginFrame(uint32_t bgColor) {
     uint32_t abgr = (a << 24) | (b << 16) | (g << 8) | r;
 
     // Fill entire framebuffer at once (much faster than pixel-by-pixel)
+    double start = PerfHud::NowMicros();
     std::fill(fb, fb + (width * height), abgr);
+    sFrameStats.rasterMicros += static_cast<uint32_t>(PerfHud::NowMicros() - start);
+    countPixels(static_cast<uint64_t>(width) * height);
+
+    sFrameList.Reset();
 }
 
 void EndFrame() {
-#ifdef __EMSCRIPTEN__
-    // Push DRC framebuffer
-    EM_ASM({
-        const canvas = document.getElementById('screen-drc');
-        if (canvas) {
-            const ctx = canvas.getContext('2d');
-            const imageData = ctx.createImageData($0, $1);
-            const data = new Uint8ClampedArray(Module.HEAPU8.buffer, $2, $0 * $1 * 4);
-            imageData.data.set(data);
-            ctx.putImageData(imageData, 0, 0);
-        }
-    }, Screen::DRC::WIDTH, Screen::DRC::HEIGHT, sDrcFramebuffer);
+    flushCommands();
 
-    // Push TV framebuffer
-    EM_ASM({
-        const canvas = document.getElementById('screen-tv');
-        if (canvas) {
-            const ctx = canvas.getContext('2d');
-            const imageData = ctx.createImageData($0, $1);
-            const data = new Uint8ClampedArray(Module.HEAPU8.buffer, $2, $0 * $1 * 4);
-            imageData.data.set(data);
-            ctx.putImageData(imageData, 0, 0);
-        }
-    }, sTvWidth, sTvHeight, sTvFramebuffer);
+#ifdef __EMSCRIPTEN__
+    double uploadStart = PerfHud::NowMicros();
+#endif
+    presentScreen(sDrcUpload, "screen-drc", sDrcFramebuffer, Screen::DRC::WIDTH, Screen::DRC::HEIGHT);
+    if (sIsTvFrame) {
+        presentScreen(sTvUpload, "screen-tv", sTvFramebuffer, sTvWidth, sTvHeight);
+    }
+    sIsTvFrame = true;
+#ifdef __EMSCRIPTEN__
+    sFrameStats.uploadMicros = static_cast<uint32_t>(PerfHud::NowMicros() - uploadStart);
 #endif
+
+    sLastFrameStats = sFrameStats;
+    sFrameStats = {};
+}
+
+const FrameStats& GetFrameStats() {
+    return sLastFrameStats;
 }
 
 // =============================================================================
-// Text Rendering
+// TV Pacing
 // =============================================================================
+// The canvas has no dirty regions, so the DRC counts as changed when its
+// framebuffer's hash differs from the last frame's, and the TV as behind
+// from then until it is drawn.
 
-void DrawText(int col, int row, const char* text, uint32_t color) {
-    if (!sInitialized || !text) return;
+static TVPacer sTvPacer;
+static uint64_t sDrcFrameHash = 0;
 
+void SetTVPacing(TVPacing pacing, int frameDivisor) {
+    sTvPacer.Set(pacing, frameDivisor);
+}
+
+TVPacing GetTVPacing() {
+    return sTvPacer.GetPacing();
+}
+
+bool IsTVBehind() {
+    return sTvPacer.GetPacing() != TVPacing::OFF && sIsTvBehind;
+}
+
+bool ShouldDrawTV() {
+    if (!sDrcFramebuffer) {
+        return true;
+    }
+
+    ScreenTarget screen = sCurrentScreen;
+    sCurrentScreen = ScreenTarget::DRC;
+    flushCommands();
+    sCurrentScreen = screen;
+
+    uint64_t hash = hashRow(sDrcFramebuffer, Screen::DRC::WIDTH * Screen::DRC::HEIGHT);
+    bool hasChanged = hash != sDrcFrameHash;
+    sDrcFrameHash = hash;
+    sIsTvBehind = sIsTvBehind || hasChanged;
+
+    sIsTvFrame = sTvPacer.BeginFrame(sIsTvBehind, hasChanged);
+    if (sIsTvFrame) {
+        sIsTvBehind = false;
+    }
+    return sIsTvFrame;
+}
+
+// =============================================================================
+// Text Rendering
+// =============================================================================
+
+static void drawTextCanvas(int col, int row, const char* text, uint32_t color) {
     int width = getCurrentWidth();
     int height = getCurrentHeight();
     uint32_t* fb = getCurrentFramebuffer();
@@ -250,12 +444,14 @@ void DrawText(int col, int row, const char* text, uint32_t color) {
     int baseX = col * CHAR_W;
     int baseY = row * CHAR_H;
 
+    uint64_t pixelCount = 0;
     for (int i = 0; text[i] != '\0'; i++) {
         const uint8_t* glyph = BitmapFont::GetGlyph(text[i]);
         if (!glyph) {
             baseX += CHAR_W;
             continue;
         }
+        sFrameStats.glyphs++;
 
         for (int gy = 0; gy < BitmapFont::CHAR_HEIGHT; gy++) {
             for (int gx = 0; gx < BitmapFont::CHAR_WIDTH; gx++) {
@@ -266,6 +462,7 @@ void DrawText(int col, int row, const char* text, uint32_t color) {
                     if (px >= 0 && px < width && py >= 0 && py + 1 < height) {
                         fb[py * width + px] = abgr;
                         fb[(py + 1) * width + px] = abgr;
+                        pixelCount += 2;
                     }
                 }
             }
@@ -273,6 +470,7 @@ void DrawText(int col, int row, const char* text, uint32_t color) {
 
         baseX += CHAR_W;
     }
+    countPixels(pixelCount);
 }
 
 void DrawTextF(int col, int row, const char* fmt, ...) {
@@ -297,7 +495,7 @@ void DrawTextF(int col, int row, uint32_t color, const char* fmt, ...) {
 // Image Rendering
 // =============================================================================
 
-void DrawPlaceholder(int x, int y, int width, int height, uint32_t color) {
+static void drawPlaceholderCanvas(int x, int y, int width, int height, uint32_t color) {
     fillRect(x, y, width, height, color);
 
     // Draw border
@@ -312,11 +510,10 @@ void DrawPlaceholder(int x, int y, int width, int height, uint32_t color) {
     }
 }
 
-void DrawImage(int x, int y, ImageHandle handle, int width, int height) {
-    (void)handle;
+static void drawImageCanvas(int x, int y, int width, int height) {
     if (width <= 0) width = 64;
     if (height <= 0) height = 64;
-    DrawPlaceholder(x, y, width, height, 0x444444FF);
+    drawPlaceholderCanvas(x, y, width, height, 0x444444FF);
 }
 
 bool SupportsImages() { return false; }
@@ -325,23 +522,114 @@ bool SupportsImages() { return false; }
 // Pixel Drawing (for debug overlays)
 // =============================================================================
 
+static void drawHLineCanvas(int x, int y, int length, uint32_t color) {
+    for (int i = 0; i < length; i++) {
+        setPixel(x + i, y, color);
+    }
+}
+
+static void drawVLineCanvas(int x, int y, int length, uint32_t color) {
+    for (int i = 0; i < length; i++) {
+        setPixel(x, y + i, color);
+    }
+}
+
+// =============================================================================
+// Draw Commands
+// =============================================================================
+
+/**
+ * Draw a frame's recorded commands into the current framebuffer
+ */
+static void executeCommands(const DrawList::List& list) {
+    double start = PerfHud::NowMicros();
+
+    for (const DrawList::Command& command : list.GetCommands()) {
+        switch (command.type) {
+            case DrawList::CommandType::TEXT:
+                sFrameStats.textCommands++;
+                drawTextCanvas(command.x, command.y, list.GetText(command), command.color);
+                break;
+            case DrawList::CommandType::IMAGE:
+                sFrameStats.imageCommands++;
+                drawImageCanvas(command.x, command.y, command.width, command.height);
+                break;
+            case DrawList::CommandType::PLACEHOLDER:
+                sFrameStats.placeholderCommands++;
+                drawPlaceholderCanvas(command.x, command.y, command.width, command.height, command.color);
+                break;
+            case DrawList::CommandType::PIXEL:
+                sFrameStats.lineCommands++;
+                setPixel(command.x, command.y, command.color);
+                break;
+            case DrawList::CommandType::HLINE:
+                sFrameStats.lineCommands++;
+                drawHLineCanvas(command.x, command.y, command.width, command.color);
+                break;
+            case DrawList::CommandType::VLINE:
+                sFrameStats.lineCommands++;
+                drawVLineCanvas(command.x, command.y, command.height, command.color);
+                break;
+        }
+    }
+
+    sFrameStats.rasterMicros += static_cast<uint32_t>(PerfHud::NowMicros() - start);
+}
+
+void DrawText(int col, int row, const char* text, uint32_t color) {
+    if (!sInitialized || !text) return;
+    sFrameList.AddText(col, row, text, color);
+}
+
+void DrawPlaceholder(int x, int y, int width, int height, uint32_t color) {
+    sFrameList.AddRect(DrawList::CommandType::PLACEHOLDER, x, y, width, height, color);
+}
+
+void DrawImage(int x, int y, ImageHandle handle, int width, int height) {
+    sFrameList.AddImage(x, y, handle, width, height);
+}
+
 void DrawPixel(int x, int y, uint32_t color) {
     if (!sInitialized) return;
-    setPixel(x, y, color);
+    sFrameList.AddRect(DrawList::CommandType::PIXEL, x, y, 1, 1, color);
 }
 
 void DrawHLine(int x, int y, int length, uint32_t color) {
     if (!sInitialized) return;
-    for (int i = 0; i < length; i++) {
-        setPixel(x + i, y, color);
-    }
+    sFrameList.AddRect(DrawList::CommandType::HLINE, x, y, length, 1, color);
 }
 
 void DrawVLine(int x, int y, int length, uint32_t color) {
     if (!sInitialized) return;
-    for (int i = 0; i < length; i++) {
-        setPixel(x, y + i, color);
-    }
+    sFrameList.AddRect(DrawList::CommandType::VLINE, x, y, 1, length, color);
+}
+
+const DrawList::List& GetDrawList() { return sFrameList; }
+
+/**
+ * Draw what was recorded into the current screen's framebuffer.
+ * main.cpp renders both screens before one EndFrame, so this also runs
+ * when the screen is switched.
+ */
+static void flushCommands() {
+    executeCommands(sFrameList);
+    sFrameList.Reset();
+}
+
+// =============================================================================
+// Dirty Regions
+// =============================================================================
+
+// The canvas redraws every frame in full, so there is nothing to track
+void SetRetainedMode(bool enabled) { (void)enabled; }
+void Invalidate(int pixelX, int pixelY, int width, int height) {
+    (void)pixelX; (void)pixelY; (void)width; (void)height;
+}
+void InvalidateRows(int firstRow, int rowCount) { (void)firstRow; (void)rowCount; }
+void InvalidateAll() {}
+bool NeedsDraw(int pixelX, int pixelY, int width, int height) {
+    (void)pixelX; (void)pixelY; (void)width; (void)height;
+    return true;
 }
 
 // =============================================================================
@@ -7,16 +7,19 @@
  */
 
 #include "stubs/renderer_stub.h"
-#include "stubs/settings_stub.h"
+#include "perf_hud.h"
+#include "storage/settings.h"
 #include "stubs/titles_stub.h"
 #include "menu/menu.h"
 #include "menu/categories.h"
+#include "input/input_recorder.h"
 #include "vpad/input.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
+#include <algorithm>
 #include <cstdio>
 
 // Forward declarations from web_input.cpp
@@ -29,14 +32,17 @@ extern "C" {
 static bool sDirty = true;
 
 /**
- * Render both screens to canvas
+ * Render both screens to canvas, the TV at its pacing (Settings' TV
+ * Refresh)
  */
 static void renderBothScreens() {
     Renderer::SelectScreen(0);
     Menu::RenderFrame();
 
-    Renderer::SelectScreen(1);
-    Menu::RenderFrame();
+    if (Renderer::ShouldDrawTV()) {
+        Renderer::SelectScreen(1);
+        Menu::RenderFrame();
+    }
 
     Renderer::EndFrame();
 }
@@ -45,7 +51,9 @@ static void renderBothScreens() {
  * Process input and render immediately
  */
 static void processAndRender() {
+    double frameStart = PerfHud::NowMicros();
     Menu::FrameResult result = Menu::HandleInputFrame();
+    double renderStart = PerfHud::NowMicros();
 
     if (!result.shouldContinue) {
         if (result.titleToLaunch != 0) {
@@ -56,13 +64,30 @@ static void processAndRender() {
 
     renderBothScreens();
     sDirty = false;
+
+    // The renderer times its own rasterizing and upload; the rest of
+    // drawing both screens is the panels recording their draw calls
+    double frameEnd = PerfHud::NowMicros();
+    const Renderer::FrameStats& stats = Renderer::GetFrameStats();
+    uint32_t drawMicros = static_cast<uint32_t>(frameEnd - renderStart);
+    uint32_t rendererMicros = std::min(drawMicros, stats.rasterMicros + stats.uploadMicros);
+
+    PerfHud::FrameSample sample = {};
+    sample.phaseMicros[static_cast<int>(PerfHud::Phase::INPUT)] = static_cast<uint32_t>(renderStart - frameStart);
+    sample.phaseMicros[static_cast<int>(PerfHud::Phase::RENDER)] = drawMicros - rendererMicros;
+    sample.phaseMicros[static_cast<int>(PerfHud::Phase::RASTER)] = stats.rasterMicros;
+    sample.phaseMicros[static_cast<int>(PerfHud::Phase::UPLOAD)] = stats.uploadMicros;
+    sample.phaseMicros[static_cast<int>(PerfHud::Phase::FRAME)] = static_cast<uint32_t>(frameEnd - frameStart);
+    PerfHud::RecordFrame(sample, stats);
 }
 
 /**
- * Main loop - only renders if dirty
+ * Main loop - only renders if dirty, or every frame while recording or
+ * replaying input so each recorded frame is one menu frame, or while the
+ * TV catches up with the GamePad
  */
 static void mainLoop() {
-    if (sDirty) {
+    if (sDirty || InputRecorder::GetMode() != InputRecorder::Mode::IDLE || Renderer::IsTVBehind()) {
         processAndRender();
     }
 }
@@ -93,7 +118,7 @@ int main() {
     Menu::InitForWebPreview();
 
     printf("Loaded %d titles\n", Titles::GetCount());
-    printf("Controls: WASD=move, J=confirm, K=back, M=settings, Q/E=categories\n\n");
+    printf("Controls: WASD=move, J=confirm, K=back, M=settings, N=sort, Q/E=categories\n\n");
 
 #ifdef __EMSCRIPTEN__
     // Run main loop at 60 FPS
@@ -129,7 +154,10 @@ void setTvResolution(int resolution) {
  */
 void handleKeyDown(int keyCode) {
     onKeyDown(keyCode);
-    processAndRender();
+    // A replay owns the frames; keys pressed meanwhile wait for it to end
+    if (InputRecorder::GetMode() != InputRecorder::Mode::REPLAYING) {
+        processAndRender();
+    }
 }
 
 /**
@@ -137,7 +165,9 @@ void handleKeyDown(int keyCode) {
  */
 void handleKeyUp(int keyCode) {
     onKeyUp(keyCode);
-    processAndRender();
+    if (InputRecorder::GetMode() != InputRecorder::Mode::REPLAYING) {
+        processAndRender();
+    }
 }
 
 } // extern "C"
@@ -10,8 +10,8 @@ namespace ImageLoader {
 
 static bool sInitialized = false;
 
-bool Init(int cacheSize) {
-    (void)cacheSize;
+bool Init(size_t cacheBudgetBytes) {
+    (void)cacheBudgetBytes;
     sInitialized = true;
     return true;
 }
@@ -20,8 +20,8 @@ void Shutdown() {
     sInitialized = false;
 }
 
-void Update() {
-    // No-op
+void Update(uint32_t budgetMicros) {
+    (void)budgetMicros;
 }
 
 void Request(uint64_t titleId, Priority priority) {
@@ -86,10 +86,31 @@ int GetCacheCount() {
     return 0;
 }
 
-int GetCacheCapacity() {
+size_t GetCacheBytes() {
+    return 0;
+}
+
+size_t GetCacheBudget() {
     return 0;
 }
 
+void SetCacheBudget(size_t cacheBudgetBytes) {
+    (void)cacheBudgetBytes;
+}
+
+void SetIconSize(int iconSize) {
+    (void)iconSize;
+}
+
+void Demote() {
+    // No-op
+}
+
+void Promote(const uint64_t* titleIds, int count) {
+    (void)titleIds;
+    (void)count;
+}
+
 void Prefetch(const uint64_t* titleIds, int count) {
     (void)titleIds;
     (void)count;
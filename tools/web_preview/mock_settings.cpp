@@ -34,6 +34,7 @@ void initDefaults() {
     sSettings.showNumbers = false;
     sSettings.lastIndex = 0;
     sSettings.lastCategoryIndex = 0;
+    sSettings.sortOrder = 0;
     sSettings.nextCategoryId = 1;
 
     // Sample favorites
@@ -42,6 +43,11 @@ void initDefaults() {
     sSettings.favorites.push_back(0x000500001010EC00);  // Mario Kart 8
     sSettings.favorites.push_back(0x0005000010145000);  // Super Smash Bros
 
+    // Sample launch history, most recent first
+    sSettings.recentLaunches.clear();
+    sSettings.recentLaunches.push_back(0x000500001010EC00);  // Mario Kart 8
+    sSettings.recentLaunches.push_back(0x0005000010101D00);  // Super Mario 3D World
+
     // Sample categories
     sSettings.categories.clear();
 
@@ -118,6 +124,24 @@ void ToggleFavorite(uint64_t titleId) {
     }
 }
 
+/**
+ * Launch history
+ */
+void RecordLaunch(uint64_t titleId) {
+    auto& recent = sSettings.recentLaunches;
+    recent.erase(std::remove(recent.begin(), recent.end(), titleId), recent.end());
+    recent.insert(recent.begin(), titleId);
+    if ((int)recent.size() > MAX_RECENT_LAUNCHES) {
+        recent.resize(MAX_RECENT_LAUNCHES);
+    }
+}
+
+int GetLaunchRank(uint64_t titleId) {
+    const auto& recent = sSettings.recentLaunches;
+    auto it = std::find(recent.begin(), recent.end(), titleId);
+    return it == recent.end() ? -1 : (int)(it - recent.begin());
+}
+
 /**
  * Category management
  */
@@ -178,6 +202,12 @@ int GetCategoryCount() {
     return (int)sSettings.categories.size();
 }
 
+const int* GetCategoryOrder(bool includeHidden, int* outCount) {
+    static int order[MAX_CATEGORIES];
+    *outCount = GetSortedCategoryIndices(order, MAX_CATEGORIES, includeHidden);
+    return order;
+}
+
 int GetSortedCategoryIndices(int* outIndices, int maxCount, bool includeHidden) {
     int count = 0;
     for (size_t i = 0; i < sSettings.categories.size() && count < maxCount; i++) {
@@ -265,6 +295,12 @@ int GetCategoriesForTitle(uint64_t titleId, uint16_t* outIds, int maxIds) {
     return count;
 }
 
+uint32_t GetMembershipGeneration() {
+    // Report a change on every call so preview-side caches never go stale
+    static uint32_t sGeneration = 0;
+    return ++sGeneration;
+}
+
 void ResetToDefaults() {
     sInitialized = false;
     sSettings = PluginSettings();
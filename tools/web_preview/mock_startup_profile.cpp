@@ -0,0 +1,61 @@
+/**
+ * Mock StartupProfile for Web Preview
+ *
+ * Provides stub implementations - the browser has no plugin startup to
+ * profile, so every phase reads as not recorded.
+ */
+
+#include "utils/startup_profile.h"
+
+namespace StartupProfile {
+
+const char* GetPhaseName(Phase phase) {
+    static const char* const names[PHASE_COUNT] = {
+        "FileStorage", "Settings", "Menu", "ImageLoader",
+        "Titles start", "Initialize", "Enumeration", "Presets"
+    };
+    int phaseIndex = static_cast<int>(phase);
+    return phaseIndex >= 0 && phaseIndex < PHASE_COUNT ? names[phaseIndex] : "?";
+}
+
+const char* GetCounterName(Counter counter) {
+    static const char* const names[COUNTER_COUNT] = {
+        "Titles", "ACP calls", "Presets", "Bytes read"
+    };
+    int counterIndex = static_cast<int>(counter);
+    return counterIndex >= 0 && counterIndex < COUNTER_COUNT ? names[counterIndex] : "?";
+}
+
+void RecordPhase(Phase phase, uint32_t micros) {
+    (void)phase;
+    (void)micros;
+}
+
+void Add(Counter counter, uint32_t amount) {
+    (void)counter;
+    (void)amount;
+}
+
+void Finish() {
+}
+
+bool IsFinished() {
+    return true;
+}
+
+bool IsPhaseRecorded(Phase phase) {
+    (void)phase;
+    return false;
+}
+
+uint32_t GetPhaseMicros(Phase phase) {
+    (void)phase;
+    return 0;
+}
+
+uint32_t GetCounter(Counter counter) {
+    (void)counter;
+    return 0;
+}
+
+}
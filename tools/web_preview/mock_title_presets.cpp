@@ -15,10 +15,37 @@ bool Load() {
     return true;
 }
 
+void DeferLoad() {
+}
+
+bool IsLoadPending() {
+    return false;
+}
+
+void RequestLoad() {
+}
+
+bool LoadIfPending(bool isIdle) {
+    (void)isIdle;
+    return false;
+}
+
 bool IsLoaded() {
     return sLoaded;
 }
 
+uint32_t GetGeneration() {
+    return 1;
+}
+
+void SetRetentionMode(RetentionMode mode) {
+    (void)mode;
+}
+
+void RetainInstalled(const std::vector<const char*>& gameIds) {
+    (void)gameIds;
+}
+
 int GetPresetCount() {
     return 0;
 }
@@ -37,6 +64,11 @@ const TitlePreset* GetPresetByGameId(const char* gameId) {
     return nullptr;
 }
 
+int GetPresetIndexByGameId(const char* gameId) {
+    (void)gameId;
+    return -1;
+}
+
 const TitlePreset* GetPresetByIndex(int index) {
     (void)index;
     return nullptr;
@@ -104,6 +136,37 @@ int GetGameIdsByYearRange(uint16_t startYear, uint16_t endYear, std::vector<cons
     return 0;
 }
 
+PresetSpan GetPresetsByPublisher(const char* publisher) {
+    (void)publisher;
+    return PresetSpan();
+}
+
+PresetSpan GetPresetsByDeveloper(const char* developer) {
+    (void)developer;
+    return PresetSpan();
+}
+
+PresetSpan GetPresetsByGenre(const char* genre) {
+    (void)genre;
+    return PresetSpan();
+}
+
+PresetSpan GetPresetsByRegion(const char* region) {
+    (void)region;
+    return PresetSpan();
+}
+
+PresetSpan GetPresetsByYear(uint16_t year) {
+    (void)year;
+    return PresetSpan();
+}
+
+PresetSpan GetPresetsByYearRange(uint16_t startYear, uint16_t endYear) {
+    (void)startYear;
+    (void)endYear;
+    return PresetSpan();
+}
+
 int GetSuggestedCategories(PresetCategoryType type,
                            std::vector<SuggestedCategory>& outSuggestions,
                            int minTitles) {
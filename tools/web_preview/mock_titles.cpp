@@ -5,8 +5,17 @@
  */
 
 #include "titles/titles.h"
+#include "storage/settings.h"
 #include <cstring>
+#include <strings.h>
+#include <cstdio>
 #include <algorithm>
+#include <iterator>
+#include <vector>
+
+#if PREVIEW_LIBRARY_SIZE > 0
+#include "fixtures/library_fixture.h"
+#endif
 
 namespace Titles {
 
@@ -39,14 +48,131 @@ static TitleInfo sTitles[] = {
     { 0x00050000101A9300, "Animal Crossing: amiibo Festival", "WUP-P-AALP" },
 };
 
-static int sTitleCount = sizeof(sTitles) / sizeof(sTitles[0]);
+// The titles on show: the samples, or a generated library when built
+// with PREVIEW_LIBRARY_SIZE
+static std::vector<TitleInfo> sLibrary(std::begin(sTitles), std::end(sTitles));
+static int sTitleCount = static_cast<int>(sLibrary.size());
 static bool sLoaded = false;
 
+// Display permutation for the active sort order
+static std::vector<int> sOrder;
+static SortOrder sSortOrder = SortOrder::NAME;
+
+static void rebuildOrder() {
+    sOrder.resize(sTitleCount);
+    for (int i = 0; i < sTitleCount; i++) {
+        sOrder[i] = i;
+    }
+    std::stable_sort(sOrder.begin(), sOrder.end(), [](int a, int b) {
+        if (sSortOrder == SortOrder::TITLE_ID) {
+            return sLibrary[a].titleId < sLibrary[b].titleId;
+        }
+        if (sSortOrder == SortOrder::RECENT) {
+            int rankA = Settings::GetLaunchRank(sLibrary[a].titleId);
+            int rankB = Settings::GetLaunchRank(sLibrary[b].titleId);
+            if (rankA != rankB) {
+                if (rankA < 0) return false;
+                if (rankB < 0) return true;
+                return rankA < rankB;
+            }
+        }
+        return strcasecmp(sLibrary[a].name, sLibrary[b].name) < 0;
+    });
+}
+
+#if PREVIEW_LIBRARY_SIZE > 0
+/**
+ * Swap the samples for the shared synthetic library (tests/fixtures),
+ * favorites and categories included, to try the menu at scale.
+ */
+static void loadGeneratedLibrary() {
+    static bool sIsGenerated = false;
+    if (sIsGenerated) return;
+
+    LibraryFixture::Options options;
+    options.titleCount = PREVIEW_LIBRARY_SIZE;
+    LibraryFixture::Library library = LibraryFixture::Generate(options);
+    LibraryFixture::ApplySettings(library);
+
+    sLibrary = library.titles;
+    sTitleCount = static_cast<int>(sLibrary.size());
+    sIsGenerated = true;
+}
+#endif
+
 void Load(bool forceReload) {
     (void)forceReload;
+#if PREVIEW_LIBRARY_SIZE > 0
+    loadGeneratedLibrary();
+#endif
+    rebuildOrder();
     sLoaded = true;
 }
 
+void StartLoadAsync(bool forceReload) {
+    Load(forceReload);
+}
+
+bool Update() {
+    return false;
+}
+
+void WaitForLoad() {
+}
+
+uint32_t GetListGeneration() {
+    // Report a change on every call so preview-side caches never go stale
+    static uint32_t sGeneration = 0;
+    return ++sGeneration;
+}
+
+bool RefreshIfChanged() {
+    return false;
+}
+
+bool StartChangeCheck() {
+    return false;
+}
+
+void SetNameResolution(NameResolution mode) {
+    (void)mode;
+}
+
+void PrioritizeName(uint64_t titleId) {
+    (void)titleId;
+}
+
+LoadState GetLoadState() {
+    LoadState state;
+    state.phase = sLoaded ? LoadPhase::READY : LoadPhase::IDLE;
+    state.resolvedCount = sTitleCount;
+    state.totalCount = sTitleCount;
+    return state;
+}
+
+void SetSortOrder(SortOrder order) {
+    sSortOrder = order;
+    rebuildOrder();
+}
+
+SortOrder GetSortOrder() {
+    return sSortOrder;
+}
+
+const char* GetSortOrderName(SortOrder order) {
+    switch (order) {
+        case SortOrder::NAME:         return "Name";
+        case SortOrder::TITLE_ID:     return "Title ID";
+        case SortOrder::RECENT:       return "Recent";
+        case SortOrder::RELEASE_YEAR: return "Year";
+    }
+    return "";
+}
+
+void RefreshSortOrders() {
+    rebuildOrder();
+}
+
 bool IsLoaded() {
     return sLoaded;
 }
@@ -56,6 +182,14 @@ void Clear() {
     sLoaded = false;
 }
 
+void SetMemoryBudget(size_t bytes) {
+    (void)bytes;
+}
+
+size_t GetMemoryUsage() {
+    return sizeof(TitleInfo) * sTitleCount;
+}
+
 int GetCount() {
     return sTitleCount;
 }
@@ -64,13 +198,52 @@ const TitleInfo* GetTitle(int index) {
     if (index < 0 || index >= sTitleCount) {
         return nullptr;
     }
-    return &sTitles[index];
+    return &sLibrary[sOrder[index]];
+}
+
+uint64_t GetTitleId(int index) {
+    const TitleInfo* title = GetTitle(index);
+    return title ? title->titleId : 0;
+}
+
+uint32_t GetCategoryMask(int index) {
+    const TitleInfo* title = GetTitle(index);
+    if (!title) {
+        return 0;
+    }
+
+    uint32_t mask = Settings::IsFavorite(title->titleId) ? Settings::FAVORITE_MASK_BIT : 0;
+    const auto& categories = Settings::Get().categories;
+    for (int position = 0; position < (int)categories.size() && position < Settings::MAX_CATEGORIES; position++) {
+        if (Settings::TitleHasCategory(title->titleId, categories[position].id)) {
+            mask |= 1u << position;
+        }
+    }
+    return mask;
+}
+
+const TitlePresets::TitlePreset* GetPreset(int index) {
+    const TitleInfo* title = GetTitle(index);
+    return title ? TitlePresets::GetPresetByGameId(title->productCode) : nullptr;
+}
+
+bool GetRecord(int index, TitleRecord* outRecord) {
+    const TitleInfo* title = GetTitle(index);
+    if (!title) {
+        return false;
+    }
+
+    outRecord->info = title;
+    outRecord->preset = GetPreset(index);
+    outRecord->categoryMask = GetCategoryMask(index);
+    outRecord->isNameResolved = true;
+    return true;
 }
 
 const TitleInfo* FindById(uint64_t titleId) {
     for (int i = 0; i < sTitleCount; i++) {
-        if (sTitles[i].titleId == titleId) {
-            return &sTitles[i];
+        if (sLibrary[i].titleId == titleId) {
+            return &sLibrary[i];
         }
     }
     return nullptr;
@@ -78,7 +251,7 @@ const TitleInfo* FindById(uint64_t titleId) {
 
 int FindIndexById(uint64_t titleId) {
     for (int i = 0; i < sTitleCount; i++) {
-        if (sTitles[i].titleId == titleId) {
+        if (sLibrary[sOrder[i]].titleId == titleId) {
             return i;
         }
     }
@@ -89,8 +262,8 @@ const TitleInfo* FindByProductCode(const char* productCode) {
     if (!productCode) return nullptr;
 
     for (int i = 0; i < sTitleCount; i++) {
-        if (strstr(sTitles[i].productCode, productCode) != nullptr) {
-            return &sTitles[i];
+        if (strstr(sLibrary[i].productCode, productCode) != nullptr) {
+            return &sLibrary[i];
         }
     }
     return nullptr;
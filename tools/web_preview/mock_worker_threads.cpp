@@ -0,0 +1,28 @@
+/**
+ * Mock WorkerThreads for Web Preview
+ *
+ * Provides stub implementations - the browser runs no worker threads to
+ * place.
+ */
+
+#include "utils/worker_threads.h"
+
+namespace WorkerThreads {
+
+void AvoidCore(uint32_t coreId) {
+    (void)coreId;
+}
+
+uint32_t GetAffinity() {
+    return 0;
+}
+
+void Register(OSThread* thread) {
+    (void)thread;
+}
+
+void Unregister(OSThread* thread) {
+    (void)thread;
+}
+
+}
@@ -0,0 +1,177 @@
+/**
+ * Performance HUD Implementation
+ *
+ * See perf_hud.h for usage documentation.
+ */
+
+#include "perf_hud.h"
+#include "menu/frame_timing.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace PerfHud {
+
+// =============================================================================
+// Internal State
+// =============================================================================
+
+namespace {
+
+// The same window as the debug panel's frame timing
+constexpr int HISTORY_FRAMES = FrameTiming::HISTORY_FRAMES;
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "Input",
+    "Render",
+    "Raster",
+    "Upload",
+    "Frame"
+};
+
+// sHistory[phase][frame], as in frame_timing.cpp
+uint32_t sHistory[PHASE_COUNT][HISTORY_FRAMES];
+int sNextFrame = 0;
+int sFrameCount = 0;
+
+bool sEnabled = false;
+
+// Shown as soon as the HUD is turned on, without waiting for a frame
+FrameSample sLastSample = {};
+Renderer::FrameStats sLastStats = {};
+
+struct Stats {
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t p99Us;
+};
+
+Stats getStats(int phaseIndex) {
+    uint32_t sorted[HISTORY_FRAMES];
+    memcpy(sorted, sHistory[phaseIndex], sFrameCount * sizeof(uint32_t));
+    std::sort(sorted, sorted + sFrameCount);
+
+    uint64_t total = 0;
+    for (int frameIndex = 0; frameIndex < sFrameCount; frameIndex++) {
+        total += sorted[frameIndex];
+    }
+
+    int p99Index = (sFrameCount * 99 + 99) / 100 - 1;
+    return { sorted[0], static_cast<uint32_t>(total / sFrameCount), sorted[sFrameCount - 1], sorted[p99Index] };
+}
+
+// The debug panel's table, then the last frame's draw work
+void formatHud(char* buffer, size_t size, const FrameSample& sample, const Renderer::FrameStats& stats) {
+    int length = snprintf(buffer, size, "FRAME TIME (us, last %d)\nPhase     last   min   avg   max   p99\n",
+                          sFrameCount);
+
+    for (int phaseIndex = 0; phaseIndex < PHASE_COUNT && length < static_cast<int>(size); phaseIndex++) {
+        Stats phaseStats = getStats(phaseIndex);
+        length += snprintf(buffer + length, size - length, "%-6s %7u %5u %5u %5u %5u\n",
+                           PHASE_NAMES[phaseIndex], static_cast<unsigned>(sample.phaseMicros[phaseIndex]),
+                           static_cast<unsigned>(phaseStats.minUs), static_cast<unsigned>(phaseStats.avgUs),
+                           static_cast<unsigned>(phaseStats.maxUs), static_cast<unsigned>(phaseStats.p99Us));
+    }
+
+    if (length < static_cast<int>(size)) {
+        snprintf(buffer + length, size - length,
+                 "\nDRAW WORK (last frame)\n"
+                 "Text    %5d cmds %6d glyphs\n"
+                 "Images  %5d cmds %6d placeholders\n"
+                 "Lines   %5d cmds\n"
+                 "Pixels  %8llu DRC %9llu TV\n"
+                 "Upload  %8llu KB\n",
+                 stats.textCommands, stats.glyphs,
+                 stats.imageCommands, stats.placeholderCommands,
+                 stats.lineCommands,
+                 static_cast<unsigned long long>(stats.drcPixels),
+                 static_cast<unsigned long long>(stats.tvPixels),
+                 static_cast<unsigned long long>(stats.uploadBytes / 1024));
+    }
+}
+
+void showHud(const char* text) {
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        const hud = document.getElementById('perf-hud');
+        if (hud) {
+            hud.textContent = UTF8ToString($0);
+        }
+    }, text);
+#else
+    fputs(text, stdout);
+#endif
+}
+
+void refreshHud() {
+    if (sFrameCount == 0) {
+        return;
+    }
+    char text[1024];
+    formatHud(text, sizeof(text), sLastSample, sLastStats);
+    showHud(text);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Recording
+// =============================================================================
+
+const char* GetPhaseName(Phase phase) {
+    int phaseIndex = static_cast<int>(phase);
+    return phaseIndex >= 0 && phaseIndex < PHASE_COUNT ? PHASE_NAMES[phaseIndex] : "?";
+}
+
+double NowMicros() {
+    using Clock = std::chrono::steady_clock;
+    return std::chrono::duration<double, std::micro>(Clock::now().time_since_epoch()).count();
+}
+
+void RecordFrame(const FrameSample& sample, const Renderer::FrameStats& stats) {
+    for (int phaseIndex = 0; phaseIndex < PHASE_COUNT; phaseIndex++) {
+        sHistory[phaseIndex][sNextFrame] = sample.phaseMicros[phaseIndex];
+    }
+    sNextFrame = (sNextFrame + 1) % HISTORY_FRAMES;
+    sFrameCount = std::min(sFrameCount + 1, HISTORY_FRAMES);
+    sLastSample = sample;
+    sLastStats = stats;
+
+    if (sEnabled) {
+        refreshHud();
+    }
+}
+
+void SetEnabled(bool enabled) {
+    sEnabled = enabled;
+    if (enabled) {
+        refreshHud();
+    } else {
+        showHud("");
+    }
+}
+
+bool IsEnabled() {
+    return sEnabled;
+}
+
+} // namespace PerfHud
+
+// =============================================================================
+// Exported Functions for JavaScript
+// =============================================================================
+
+extern "C" {
+
+void setPerfHudEnabled(int enabled) {
+    PerfHud::SetEnabled(enabled != 0);
+}
+
+} // extern "C"
@@ -0,0 +1,65 @@
+/**
+ * Performance HUD for the Web Preview
+ *
+ * What a preview frame costs, shown in an optional overlay: how long the
+ * C++ side spent handling input, running the panels and rasterizing, how
+ * long JavaScript took to upload the framebuffers, and how much drawing
+ * the frame did. A rough cost signal for layout work before it reaches
+ * hardware; the browser is much faster than the console, so compare
+ * frames with each other rather than with the frame budget.
+ *
+ * HOW IT WORKS:
+ * -------------
+ * main.cpp times each frame's phases and hands them to RecordFrame(),
+ * together with the canvas renderer's counters for that frame. Frames go
+ * into a ring of FrameTiming::HISTORY_FRAMES, and the overlay shows the
+ * same min/avg/max/p99 table as the on-device debug panel, followed by
+ * the last frame's draw counts. While the HUD is off, frames are still
+ * recorded but nothing is formatted or sent to the page.
+ *
+ * USAGE:
+ * ------
+ *   double start = PerfHud::NowMicros();
+ *   ... handle input, render, upload ...
+ *   PerfHud::RecordFrame(sample, Renderer::GetFrameStats());
+ *
+ *   // From JavaScript (the HUD checkbox)
+ *   Module._setPerfHudEnabled(1);
+ */
+
+#pragma once
+
+#include "stubs/renderer_stub.h"
+
+#include <cstdint>
+
+namespace PerfHud {
+
+enum class Phase {
+    INPUT,      // Menu::HandleInputFrame
+    RENDER,     // The panels' Render() for both screens, recording draw calls
+    RASTER,     // Clearing and drawing the recorded calls into the framebuffers
+    UPLOAD,     // JavaScript copying both framebuffers to their canvases
+    FRAME,      // All of the above
+    COUNT
+};
+
+constexpr int PHASE_COUNT = static_cast<int>(Phase::COUNT);
+
+// One frame's phase times
+struct FrameSample {
+    uint32_t phaseMicros[PHASE_COUNT];
+};
+
+const char* GetPhaseName(Phase phase);
+
+// A monotonic clock for timing phases
+double NowMicros();
+
+// Keep a frame and, with the HUD on, redraw the overlay
+void RecordFrame(const FrameSample& sample, const Renderer::FrameStats& stats);
+
+void SetEnabled(bool enabled);
+bool IsEnabled();
+
+} // namespace PerfHud
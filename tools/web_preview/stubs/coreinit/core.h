@@ -0,0 +1,12 @@
+/**
+ * Stub for <coreinit/core.h>
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// The game's main core
+inline uint32_t OSGetCoreId() {
+    return 1;
+}
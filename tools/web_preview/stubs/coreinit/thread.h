@@ -0,0 +1,15 @@
+/**
+ * Stub for <coreinit/thread.h>
+ */
+
+#pragma once
+
+#include "time.h"
+
+typedef struct OSThread OSThread;
+
+inline void OSSleepTicks(OSTime ticks) {
+    (void)ticks;
+}
+
+inline void OSYieldThread() {}
@@ -16,3 +16,21 @@ inline uint32_t OSTicksToMilliseconds(OSTime ticks) {
     (void)ticks;
     return 10000;  // Return large value to bypass startup grace period
 }
+
+inline OSTime OSGetSystemTime() {
+    return 0;
+}
+
+inline uint32_t OSTicksToMicroseconds(OSTime ticks) {
+    (void)ticks;
+    return 0;
+}
+
+inline uint64_t OSTicksToNanoseconds(OSTime ticks) {
+    (void)ticks;
+    return 0;
+}
+
+inline OSTime OSMicrosecondsToTicks(uint32_t microseconds) {
+    return microseconds;
+}
@@ -46,6 +46,7 @@ bool IsInitialized();
 // Frame Management
 // =============================================================================
 
+void WaitForVsync();
 void BeginFrame(uint32_t clearColor);
 void EndFrame();
 
@@ -8,7 +8,12 @@
 #pragma once
 
 #include <cstdint>
-#include "layout_stub.h"
+#include "render/tv_pacing.h"
+#include "ui/layout.h"
+
+namespace DrawList {
+struct List;
+}
 
 namespace Renderer {
 
@@ -54,6 +59,16 @@ constexpr ImageHandle INVALID_IMAGE = nullptr;
 bool Init();
 void Shutdown();
 bool IsInitialized();
+bool Prewarm(uint32_t maxGlyphs);
+void ReleaseResources();
+
+// The canvas has no framebuffers to keep between opens
+bool ReserveStandby();
+bool RelieveMemoryPressure();
+
+// The browser has no game to draw over
+bool IsOverlayAvailable();
+void SetOverlayFrameCallback(void (*callback)());
 
 // =============================================================================
 // Screen Selection
@@ -66,9 +81,24 @@ void SetTvResolution(int resolution);
 // Frame Management
 // =============================================================================
 
+// The browser paces frames itself
+void WaitForVsync();
 void BeginFrame(uint32_t clearColor);
 void EndFrame();
 
+// =============================================================================
+// TV Pacing
+// =============================================================================
+
+// As on the console (see render/tv_pacing.h)
+void SetTVPacing(TVPacing pacing, int frameDivisor = 2);
+TVPacing GetTVPacing();
+bool IsTVBehind();
+
+// Whether the TV is drawn this frame; asked once a frame, after the DRC
+// is drawn, since ON_CHANGE waits for the DRC to stop changing
+bool ShouldDrawTV();
+
 // =============================================================================
 // Text Rendering
 // =============================================================================
@@ -93,6 +123,33 @@ void DrawPixel(int x, int y, uint32_t color);
 void DrawHLine(int x, int y, int length, uint32_t color);
 void DrawVLine(int x, int y, int length, uint32_t color);
 
+// =============================================================================
+// Draw Commands
+// =============================================================================
+
+const DrawList::List& GetDrawList();
+
+// =============================================================================
+// Frame Statistics (performance HUD)
+// =============================================================================
+
+// What the last frame drew, both screens together unless per screen
+struct FrameStats {
+    int textCommands;
+    int glyphs;
+    int imageCommands;
+    int placeholderCommands;
+    int lineCommands;           // Pixels and lines
+    uint64_t drcPixels;         // Written to the DRC framebuffer, clear included
+    uint64_t tvPixels;          // Written to the TV framebuffer, clear included
+    uint64_t uploadBytes;       // Copied to the canvases
+    uint32_t rasterMicros;      // Clearing and drawing the recorded commands
+    uint32_t uploadMicros;      // The JavaScript upload
+};
+
+// Filled in by EndFrame()
+const FrameStats& GetFrameStats();
+
 // =============================================================================
 // Coordinate Helpers
 // =============================================================================
@@ -10,7 +10,7 @@
 #include <vector>
 #include <cstring>
 #include <algorithm>
-#include "layout_stub.h"
+#include "ui/layout.h"
 
 namespace Settings {
 
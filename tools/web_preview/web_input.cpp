@@ -15,9 +15,17 @@
  *   P -> R button
  *   M -> Plus (settings menu)
  *   N -> Minus
+ *
+ * Also records what the menu reads to a file the browser downloads, and
+ * replays an uploaded recording, one frame per animation frame (see
+ * input/input_recorder.h; recordings from a RECORD=1 console build work
+ * too).
  */
 
 #include "vpad/input.h"
+#include "input/input_recorder.h"
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #ifdef __EMSCRIPTEN__
@@ -59,7 +67,7 @@ uint32_t keyCodeToButton(int keyCode) {
 
         // Menu buttons
         case 77: return VPAD_BUTTON_PLUS;   // M (settings menu)
-        case 78: return VPAD_BUTTON_MINUS;  // N
+        case 78: return VPAD_BUTTON_MINUS;  // N (cycle sort order)
 
         default: return 0;
     }
@@ -86,6 +94,58 @@ void onKeyUp(int keyCode) {
     }
 }
 
+/**
+ * Start recording the menu's input (called from JavaScript)
+ */
+void startInputRecording() {
+    if (InputRecorder::StartRecording()) {
+        printf("Recording input\n");
+    }
+}
+
+/**
+ * Stop recording and offer the recording as a download
+ */
+void stopInputRecording() {
+    if (InputRecorder::GetMode() != InputRecorder::Mode::RECORDING) {
+        return;
+    }
+    InputRecorder::Stop();
+
+    size_t size = InputRecorder::GetEncodedSize();
+    uint8_t* data = static_cast<uint8_t*>(malloc(size));
+    if (!data) {
+        return;
+    }
+    InputRecorder::Encode(data, size);
+    printf("Recorded %u frames (%u bytes)\n", static_cast<unsigned>(InputRecorder::GetFrameCount()),
+           static_cast<unsigned>(size));
+
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        const blob = new Blob([HEAPU8.slice($0, $0 + $1)], { type: 'application/octet-stream' });
+        const link = document.createElement('a');
+        link.href = URL.createObjectURL(blob);
+        link.download = 'input.rec';
+        link.click();
+        URL.revokeObjectURL(link.href);
+    }, data, size);
+#endif
+    free(data);
+}
+
+/**
+ * Replay a recording the page copied into the heap; returns 0 if it isn't one
+ */
+int startInputReplay(const uint8_t* data, int size) {
+    if (size <= 0 || !InputRecorder::StartReplay(data, static_cast<size_t>(size))) {
+        printf("Not an input recording\n");
+        return 0;
+    }
+    printf("Replaying %u frames\n", static_cast<unsigned>(InputRecorder::GetFrameCount()));
+    return 1;
+}
+
 } // extern "C"
 
 /**